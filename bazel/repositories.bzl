@@ -164,6 +164,7 @@ def envoy_dependencies(skip_targets = []):
     _com_google_googletest()
     _com_google_protobuf()
     _com_github_envoyproxy_sqlparser()
+    _com_googlesource_code_re2()
     _com_googlesource_quiche()
 
     # Used for bundling gcovr into a relocatable .par file.
@@ -508,6 +509,17 @@ def _com_google_protobuf():
         actual = "@com_google_protobuf//util/python:python_headers",
     )
 
+def _com_googlesource_code_re2():
+    location = REPOSITORY_LOCATIONS["com_googlesource_code_re2"]
+    http_archive(
+        name = "com_googlesource_code_re2",
+        **location
+    )
+    native.bind(
+        name = "re2",
+        actual = "@com_googlesource_code_re2//:re2",
+    )
+
 def _com_googlesource_quiche():
     location = REPOSITORY_LOCATIONS["com_googlesource_quiche"]
     genrule_repository(
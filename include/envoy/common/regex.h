@@ -0,0 +1,29 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * A compiled regex expression matcher which uses an abstract regex engine.
+ */
+class CompiledMatcher {
+public:
+  virtual ~CompiledMatcher() = default;
+
+  /**
+   * @param value supplies the value to match.
+   * @return whether the entire value matches the compiled regex expression.
+   */
+  virtual bool match(absl::string_view value) const PURE;
+};
+
+typedef std::unique_ptr<const CompiledMatcher> CompiledMatcherPtr;
+
+} // namespace Regex
+} // namespace Envoy
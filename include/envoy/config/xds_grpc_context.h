@@ -32,6 +32,18 @@ public:
    */
   virtual void onDiscoveryResponse(std::unique_ptr<ResponseProto>&& message) PURE;
 
+  /**
+   * For the GrpcStream to ask whether received protos may be parsed into an arena and passed to
+   * onArenaDiscoveryResponse(), rather than onto the heap and passed to onDiscoveryResponse().
+   */
+  virtual bool useResponseArena() PURE;
+
+  /**
+   * For the GrpcStream to pass received protos that are owned by an arena. The arena is freed when
+   * this returns, so nothing may hold on to the proto or any part of it.
+   */
+  virtual void onArenaDiscoveryResponse(ResponseProto& message) PURE;
+
   /**
    * For the GrpcStream to call when its rate limiting logic allows more requests to be sent.
    */
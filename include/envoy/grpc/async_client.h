@@ -142,6 +142,26 @@ public:
    */
   virtual void onReceiveMessageUntyped(ProtobufTypes::MessagePtr&& message) PURE;
 
+  /**
+   * Whether received messages may be parsed into a Protobuf::Arena rather than onto the heap. The
+   * arena, with everything the message allocated, is freed in a single step once the message has
+   * been consumed, which is cheaper for large messages that are not retained. Clients that do not
+   * support arenas ignore this and call onReceiveMessageUntyped().
+   * @return bool whether to call onReceiveArenaMessageUntyped() with received messages.
+   */
+  virtual bool useResponseArena() { return false; }
+
+  /**
+   * Called instead of onReceiveMessageUntyped() when useResponseArena() returns true. By default
+   * the message is copied onto the heap and passed to onReceiveMessageUntyped().
+   * @param message the gRPC message, which is owned by an arena and only valid during the call.
+   */
+  virtual void onReceiveArenaMessageUntyped(Protobuf::Message& message) {
+    ProtobufTypes::MessagePtr copy = createEmptyResponse();
+    copy->CopyFrom(message);
+    onReceiveMessageUntyped(std::move(copy));
+  }
+
   /**
    * Called when trailing metadata is received. This will also be called on non-Ok grpc-status
    * stream termination.
@@ -171,6 +191,14 @@ public:
   void onReceiveMessageUntyped(ProtobufTypes::MessagePtr&& message) override {
     onReceiveMessage(std::unique_ptr<ResponseType>(dynamic_cast<ResponseType*>(message.release())));
   }
+
+  virtual void onReceiveArenaMessage(ResponseType& message) {
+    onReceiveMessage(std::make_unique<ResponseType>(message));
+  }
+
+  void onReceiveArenaMessageUntyped(Protobuf::Message& message) override {
+    onReceiveArenaMessage(dynamic_cast<ResponseType&>(message));
+  }
 };
 
 /**
@@ -12,6 +12,7 @@
 
 #include "envoy/common/pure.h"
 
+#include "common/common/ascii_utility.h"
 #include "common/common/assert.h"
 #include "common/common/hash.h"
 
@@ -23,12 +24,7 @@ namespace Http {
 // Used by ASSERTs to validate internal consistency. E.g. valid HTTP header keys/values should
 // never contain embedded NULLs.
 static inline bool validHeaderString(absl::string_view s) {
-  for (const char c : {'\0', '\r', '\n'}) {
-    if (s.find(c) != absl::string_view::npos) {
-      return false;
-    }
-  }
-  return true;
+  return AsciiUtility::findFirstOf(s, '\0', '\r', '\n') == absl::string_view::npos;
 }
 
 /**
@@ -50,7 +46,7 @@ public:
   bool operator<(const LowerCaseString& rhs) const { return string_.compare(rhs.string_) < 0; }
 
 private:
-  void lower() { std::transform(string_.begin(), string_.end(), string_.begin(), tolower); }
+  void lower() { AsciiUtility::toLowerCase(&string_[0], string_.size()); }
   bool valid() const { return validHeaderString(string_); }
 
   std::string string_;
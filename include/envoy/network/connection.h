@@ -299,6 +299,23 @@ public:
    *         occurred an empty string is returned.
    */
   virtual absl::string_view transportFailureReason() const PURE;
+
+  /**
+   * @return IoHandle* the handle of the underlying socket if bytes may be moved between it and
+   *         another socket directly, bypassing the transport socket and the filter chain, or
+   *         nullptr otherwise. This requires a pass through transport socket, at most one read
+   *         filter, no write filters and no buffered data. Reads on the connection must stay
+   *         disabled for as long as the caller moves bytes itself.
+   */
+  virtual IoHandle* spliceIoHandle() PURE;
+
+  /**
+   * Account for bytes that were moved on the socket returned by spliceIoHandle(). This updates
+   * the connection stats and runs the bytes sent callbacks.
+   * @param bytes_read supplies the number of bytes read from the socket.
+   * @param bytes_written supplies the number of bytes written to the socket.
+   */
+  virtual void onSpliced(uint64_t bytes_read, uint64_t bytes_written) PURE;
 };
 
 typedef std::unique_ptr<Connection> ConnectionPtr;
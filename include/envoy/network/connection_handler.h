@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <list>
 #include <memory>
 
 #include "envoy/network/connection.h"
@@ -57,6 +59,26 @@ public:
    */
   virtual void stopListeners() PURE;
 
+  /**
+   * Close all connections that were created from the given filter chains of the listeners with
+   * the given listener tag, and reject any new connection that matches them. Connections of the
+   * other filter chains are left alone. This is used for filter chain level listener updates.
+   * @param listener_tag supplies the tag passed to addListener().
+   * @param filter_chains supplies the filter chains to remove.
+   */
+  virtual void removeFilterChains(uint64_t listener_tag,
+                                  const std::list<const FilterChain*>& filter_chains) PURE;
+
+  /**
+   * Remove listeners using the listener tag as a key once they no longer own any connections.
+   * The listeners are expected to be stopped already.
+   * @param listener_tag supplies the tag passed to addListener().
+   * @param completion supplies the callback invoked once the listeners have been removed. It may be
+   *        invoked inline if the listeners are already idle.
+   */
+  virtual void removeListenersWhenIdle(uint64_t listener_tag,
+                                       std::function<void()> completion) PURE;
+
   /**
    * Disable all listeners. This will not close any connections and is used to temporarily
    * stop accepting connections on all listeners.
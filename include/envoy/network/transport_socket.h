@@ -145,6 +145,13 @@ public:
    * @return the const SSL connection data if this is an SSL connection, or nullptr if it is not.
    */
   virtual const Ssl::ConnectionInfo* ssl() const PURE;
+
+  /**
+   * @return bool whether the transport socket reads and writes bytes on the underlying socket
+   *         unmodified, so that they may be moved to and from it without going through
+   *         doRead() and doWrite().
+   */
+  virtual bool passesThrough() const PURE;
 };
 
 typedef std::unique_ptr<TransportSocket> TransportSocketPtr;
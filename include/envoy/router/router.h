@@ -10,10 +10,12 @@
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/v2/core/base.pb.h"
+#include "envoy/common/regex.h"
 #include "envoy/config/typed_metadata.h"
 #include "envoy/http/codec.h"
 #include "envoy/http/codes.h"
 #include "envoy/http/header_map.h"
+#include "envoy/runtime/runtime.h"
 #include "envoy/tracing/http_tracer.h"
 #include "envoy/upstream/resource_manager.h"
 #include "envoy/upstream/retry.h"
@@ -101,9 +103,9 @@ public:
   virtual const std::list<std::string>& allowOrigins() const PURE;
 
   /*
-   * @return std::list<std::regex>& regexes that match allowed origins.
+   * @return std::vector<Regex::CompiledMatcherPtr>& regexes that match allowed origins.
    */
-  virtual const std::list<std::regex>& allowOriginRegexes() const PURE;
+  virtual const std::vector<Regex::CompiledMatcherPtr>& allowOriginRegexes() const PURE;
 
   /**
    * @return std::string access-control-allow-methods value.
@@ -316,6 +318,12 @@ public:
    */
   virtual const std::string& runtimeKey() const PURE;
 
+  /**
+   * @return the runtime key of runtimeKey(), resolved ahead of time so that it can be looked up
+   *         for each request without hashing its name.
+   */
+  virtual const Runtime::Key& resolvedRuntimeKey() const PURE;
+
   /**
    * @return the default fraction of traffic the should be shadowed, if the runtime key is not
    *         present.
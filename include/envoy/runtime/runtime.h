@@ -39,6 +39,30 @@ public:
 
 typedef std::unique_ptr<RandomGenerator> RandomGeneratorPtr;
 
+/**
+ * A runtime key resolved ahead of time to an index, which snapshots can use to look up the key's
+ * value without hashing its name. Keys are resolved once, typically at configuration time, and can
+ * then be used with any snapshot.
+ */
+class Key {
+public:
+  Key(const std::string& name, uint32_t index) : name_(&name), index_(index) {}
+
+  /**
+   * @return const std::string& the name of the key.
+   */
+  const std::string& name() const { return *name_; }
+
+  /**
+   * @return uint32_t the index of the key, which is unique to its name within the process.
+   */
+  uint32_t index() const { return index_; }
+
+private:
+  const std::string* name_;
+  uint32_t index_;
+};
+
 /**
  * A snapshot of runtime data.
  */
@@ -189,6 +213,34 @@ public:
    */
   virtual uint64_t getInteger(const std::string& key, uint64_t default_value) const PURE;
 
+  /**
+   * The following variants of featureEnabled() and getInteger() take a pre-resolved key, and behave
+   * as their counterparts that take the key's name. Implementations that can look up values by the
+   * key's index should override them; by default they look up the key by name.
+   */
+  virtual bool featureEnabled(const Key& key, uint64_t default_value) const {
+    return featureEnabled(key.name(), default_value);
+  }
+  virtual bool featureEnabled(const Key& key, uint64_t default_value,
+                              uint64_t random_value) const {
+    return featureEnabled(key.name(), default_value, random_value);
+  }
+  virtual bool featureEnabled(const Key& key, uint64_t default_value, uint64_t random_value,
+                              uint64_t num_buckets) const {
+    return featureEnabled(key.name(), default_value, random_value, num_buckets);
+  }
+  virtual bool featureEnabled(const Key& key,
+                              const envoy::type::FractionalPercent& default_value) const {
+    return featureEnabled(key.name(), default_value);
+  }
+  virtual bool featureEnabled(const Key& key, const envoy::type::FractionalPercent& default_value,
+                              uint64_t random_value) const {
+    return featureEnabled(key.name(), default_value, random_value);
+  }
+  virtual uint64_t getInteger(const Key& key, uint64_t default_value) const {
+    return getInteger(key.name(), default_value);
+  }
+
   /**
    * Fetch the OverrideLayers that provide values in this snapshot. Layers are ordered from bottom
    * to top; for instance, the second layer's entries override the first layer's entries, and so on.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
 
 #include "envoy/buffer/buffer.h"
@@ -17,6 +18,24 @@
 namespace Envoy {
 namespace Server {
 
+/**
+ * A response body that is produced incrementally, so that a large admin response need not be held
+ * in memory in full.
+ */
+class ChunkedResponse {
+public:
+  virtual ~ChunkedResponse() {}
+
+  /**
+   * Appends the next chunk of the response body.
+   * @param response supplies the buffer to append the chunk to.
+   * @return bool true if there is more of the response to come.
+   */
+  virtual bool nextChunk(Buffer::Instance& response) PURE;
+};
+
+typedef std::unique_ptr<ChunkedResponse> ChunkedResponsePtr;
+
 class AdminStream {
 public:
   virtual ~AdminStream() {}
@@ -49,6 +68,14 @@ public:
    * request.
    */
   virtual const Http::HeaderMap& getRequestHeaders() const PURE;
+
+  /**
+   * Sets the source of the remainder of the response body. It is drained after the handler's
+   * response buffer has been sent, pausing while the downstream connection is above its write
+   * buffer high watermark.
+   * @param response supplies the chunked response.
+   */
+  virtual void setChunkedResponse(ChunkedResponsePtr&& response) PURE;
 };
 
 /**
@@ -335,7 +335,9 @@ public:
 
   /**
    * @return RouteSpecificFilterConfigConstSharedPtr allow the filter to pre-process per route
-   * config. Returned object will be stored in the loaded route configuration.
+   * config. Returned object will be stored in the loaded route configuration. It may be shared with
+   * other route configurations that are built with the same FactoryContext and contain the same
+   * virtual host, so it must not depend on anything else of the route configuration.
    */
   virtual Router::RouteSpecificFilterConfigConstSharedPtr
   createRouteSpecificFilterConfig(const Protobuf::Message&, FactoryContext&) {
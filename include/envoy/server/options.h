@@ -184,6 +184,12 @@ public:
    */
   virtual bool cpusetThreadsEnabled() const PURE;
 
+  /**
+   * @return const std::string& the directory in which parsed bootstrap configs are cached as binary
+   *         protos, or empty if the cache is disabled.
+   */
+  virtual const std::string& bootstrapCachePath() const PURE;
+
   /**
    * Converts the Options in to CommandLineOptions proto message defined in server_info.proto.
    * @return CommandLineOptionsPtr the protobuf representation of the options.
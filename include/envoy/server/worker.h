@@ -1,7 +1,9 @@
 #pragma once
 
 #include <functional>
+#include <list>
 
+#include "envoy/network/filter.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/overload_manager.h"
 
@@ -65,6 +67,24 @@ public:
   virtual void removeListener(Network::ListenerConfig& listener,
                               std::function<void()> completion) PURE;
 
+  /**
+   * Remove a stopped listener from the worker once all of its connections are gone.
+   * @param listener supplies the listener to remove.
+   * @param completion supplies the completion to be called when the listener has been removed.
+   *        This completion is called on the worker thread. No locking is performed by the worker.
+   */
+  virtual void removeListenerWhenIdle(Network::ListenerConfig& listener,
+                                      std::function<void()> completion) PURE;
+
+  /**
+   * Close the connections of a listener that use any of the given filter chains. This is used
+   * for filter chain level listener updates.
+   * @param listener supplies the listener that owns the filter chains.
+   * @param filter_chains supplies the filter chains to remove.
+   */
+  virtual void removeFilterChains(Network::ListenerConfig& listener,
+                                  const std::list<const Network::FilterChain*>& filter_chains) PURE;
+
   /**
    * Stop a listener from accepting new connections. This is used for server draining.
    * @param listener supplies the listener to stop.
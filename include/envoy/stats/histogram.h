@@ -119,5 +119,24 @@ public:
 
 typedef std::shared_ptr<ParentHistogram> ParentHistogramSharedPtr;
 
+/**
+ * Selects how a store records and merges the samples of its histograms.
+ */
+struct HistogramSettings {
+  enum class Backend {
+    // Sparse circllhist histograms, with about two significant decimal digits of precision.
+    Circllhist,
+    // Fixed-layout log-linear buckets that are merged as arrays of counts.
+    LogLinear,
+  };
+
+  static constexpr uint32_t DefaultPrecisionBits = 5;
+
+  Backend backend_{Backend::Circllhist};
+  // Significant bits kept for each value by the log-linear backend. Quantiles are accurate to
+  // within a relative error of 2^-precision_bits_.
+  uint32_t precision_bits_{DefaultPrecisionBits};
+};
+
 } // namespace Stats
 } // namespace Envoy
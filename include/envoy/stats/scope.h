@@ -37,6 +37,16 @@ public:
    */
   virtual ScopePtr createScope(const std::string& name) PURE;
 
+  /**
+   * Allocate a new scope whose stats may be evicted once they have been idle for a number of stats
+   * flushes, if the store is configured to do so (see StoreRoot::evictIdleStats()). An evicted stat
+   * is created again, starting from zero, the next time it is looked up. Callers must therefore
+   * look the stats of such a scope up each time they use them rather than keeping references,
+   * which makes it suited to stats with dynamic names, such as those named after xDS resources.
+   * @param name supplies the scope's namespace prefix.
+   */
+  virtual ScopePtr createEvictableScope(const std::string& name) PURE;
+
   /**
    * Deliver an individual histogram value to all registered sinks.
    */
@@ -31,6 +31,13 @@ public:
    * @param value the value of the sample.
    */
   virtual void onHistogramComplete(const Histogram& histogram, uint64_t value) PURE;
+
+  /**
+   * @return true if flush() may be called on the dedicated stats flush thread, with a Source that
+   *         is a snapshot of the store, rather than on the main thread. Such sinks may only use
+   *         thread local state and objects that are safe to use from any thread.
+   */
+  virtual bool supportsFlushThread() const PURE;
 };
 
 typedef std::unique_ptr<Sink> SinkPtr;
@@ -24,26 +24,12 @@ public:
    * Returns the full name of the Metric. This is intended for most uses, such
    * as streaming out the name to a stats sink or admin request, or comparing
    * against it in a test. Independent of the evolution of the data
-   * representation for the name, this method will be available. For storing the
-   * name as a map key, however, nameCStr() is a better choice, albeit one that
-   * might change in the future to return a symbolized representation of the
-   * elaborated string.
+   * representation for the name, this method will be available. Stores do not
+   * key their maps by this string; they use the symbolized StatName the stat
+   * was created from (see source/common/stats/symbol_table_impl.h).
    */
   virtual std::string name() const PURE;
 
-  /**
-   * Returns the full name of the Metric as a nul-terminated string. The
-   * intention is use this as a hash-map key, so that the stat name storage
-   * is not duplicated in every map. You cannot use name() above for this,
-   * as it returns a std::string by value, as not all stat implementations
-   * contain the name as a std::string.
-   *
-   * Note that in the future, the plan is to replace this method with one that
-   * returns a reference to a symbolized representation of the elaborated string
-   * (see source/common/stats/symbol_table_impl.h).
-   */
-  virtual const char* nameCStr() const PURE;
-
   /**
    * Returns a vector of configurable tags to identify this Metric.
    */
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "envoy/common/pure.h"
+#include "envoy/stats/histogram.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_matcher.h"
 #include "envoy/stats/tag_producer.h"
@@ -24,6 +27,23 @@ namespace Stats {
 class Sink;
 class Source;
 
+/**
+ * The stats held by one scope of a store, and an estimate of the memory they use.
+ */
+struct ScopeMemoryStats {
+  // The scope's prefix, including its trailing '.', or empty for the root scope.
+  std::string prefix_;
+  uint64_t counters_{};
+  uint64_t gauges_{};
+  uint64_t histograms_{};
+  // Approximate bytes used by the stats, their names and the entries of the caches that hold them,
+  // including the per-thread caches.
+  uint64_t bytes_{};
+  bool evictable_{};
+  // The number of stats evicted from the scope since it was created.
+  uint64_t evicted_{};
+};
+
 /**
  * A store for all known counters, gauges, and timers.
  */
@@ -43,6 +63,12 @@ public:
    * @return a list of all known histograms.
    */
   virtual std::vector<ParentHistogramSharedPtr> histograms() const PURE;
+
+  /**
+   * @return the stats held by each scope of the store. Stats that are shared by overlapping scopes
+   *         are counted in each of them.
+   */
+  virtual std::vector<ScopeMemoryStats> scopeMemoryStats() const PURE;
 };
 
 typedef std::unique_ptr<Store> StorePtr;
@@ -74,6 +100,13 @@ public:
    */
   virtual void setStatsMatcher(StatsMatcherPtr&& stats_matcher) PURE;
 
+  /**
+   * Select how histograms record and merge their samples. Only histograms created after this call
+   * are affected, so it should be called before any histograms are created.
+   * @param settings the histogram backend and its precision.
+   */
+  virtual void setHistogramSettings(const HistogramSettings& settings) PURE;
+
   /**
    * Initialize the store for threading. This will be called once after all worker threads have
    * been initialized. At this point the store can initialize itself for multi-threaded operation.
@@ -96,6 +129,15 @@ public:
    */
   virtual void mergeHistograms(PostMergeCb merge_complete_cb) PURE;
 
+  /**
+   * Called on the main thread after each flush to the sinks. Counters, histograms and zero-valued
+   * gauges of evictable scopes that have not changed for the given number of consecutive flushes
+   * are removed from the store. Counters have been flushed with their final value by then, and
+   * gauges with a non-zero value are kept, so sinks do not lose updates.
+   * @param idle_flushes the number of flushes a stat must be unchanged for to be evicted.
+   */
+  virtual void evictIdleStats(uint32_t idle_flushes) PURE;
+
   /**
    * Returns the Source to provide cached metrics.
    * @return Source& the source.
@@ -6,6 +6,7 @@
 
 #include "envoy/common/pure.h"
 
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
@@ -20,6 +21,12 @@ namespace Stats {
  */
 class StatName;
 
+/**
+ * A short list of StatNames, typically the components of a name to be joined. Stored inline so
+ * that joining names on a hot path does not allocate.
+ */
+using StatNameVec = absl::InlinedVector<StatName, 8>;
+
 class StatNameList;
 
 /**
@@ -105,7 +112,7 @@ public:
    * @param stat_names the names to join.
    * @return Storage allocated for the joined name.
    */
-  virtual StoragePtr join(const std::vector<StatName>& stat_names) const PURE;
+  virtual StoragePtr join(const StatNameVec& stat_names) const PURE;
 
   /**
    * Populates a StatNameList from a list of encodings. This is not done at
@@ -5,6 +5,7 @@
 #include "common/api/os_sys_calls_impl_linux.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <sched.h>
 
 namespace Envoy {
@@ -16,5 +17,16 @@ SysCallIntResult LinuxOsSysCallsImpl::sched_getaffinity(pid_t pid, size_t cpuset
   return {rc, errno};
 }
 
+SysCallIntResult LinuxOsSysCallsImpl::pipe2(int pipefd[2], int flags) {
+  const int rc = ::pipe2(pipefd, flags);
+  return {rc, errno};
+}
+
+SysCallSizeResult LinuxOsSysCallsImpl::splice(int fd_in, loff_t* off_in, int fd_out,
+                                              loff_t* off_out, size_t len, unsigned int flags) {
+  const ssize_t rc = ::splice(fd_in, off_in, fd_out, off_out, len, flags);
+  return {rc, errno};
+}
+
 } // namespace Api
 } // namespace Envoy
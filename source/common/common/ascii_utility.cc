@@ -0,0 +1,161 @@
+#include "common/common/ascii_utility.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Envoy {
+
+namespace {
+
+inline char toLowerChar(char c) { return (c >= 'A' && c <= 'Z') ? (c | 0x20) : c; }
+
+template <class Word> inline Word loadWord(const char* buffer) {
+  Word word;
+  memcpy(&word, buffer, sizeof(word));
+  return word;
+}
+
+template <class Word> inline void storeWord(char* buffer, Word word) {
+  memcpy(buffer, &word, sizeof(word));
+}
+
+// Lowercases the bytes of a word at once. The high bit of each byte is set in ge_a when its low
+// 7 bits are at least 'A', and in gt_z when they are above 'Z', without carries between bytes.
+// Bytes with the high bit set are not ASCII and are left unchanged.
+template <class Word> inline Word toLowerWord(Word word) {
+  constexpr Word ones = static_cast<Word>(0x0101010101010101);
+  const Word heptets = word & (0x7f * ones);
+  const Word ge_a = heptets + (0x80 - 'A') * ones;
+  const Word gt_z = heptets + (0x80 - 'Z' - 1) * ones;
+  const Word upper = ge_a & ~gt_z & ~word & (0x80 * ones);
+  return word | (upper >> 2);
+}
+
+// Lowercases a string of at least sizeof(Word) bytes a word at a time. The last word may overlap
+// the previous one, which is harmless as lowercasing is idempotent. It is loaded before anything is
+// stored, so that the load is not held up by the overlapping store.
+template <class Word> inline void toLowerWords(char* buffer, size_t size) {
+  const Word last = loadWord<Word>(buffer + size - sizeof(Word));
+  for (size_t i = 0; i + sizeof(Word) < size; i += sizeof(Word)) {
+    storeWord(buffer + i, toLowerWord(loadWord<Word>(buffer + i)));
+  }
+  storeWord(buffer + size - sizeof(Word), toLowerWord(last));
+}
+
+#if defined(__SSE2__)
+// Bytes outside of ASCII compare as negative, so they are never in ['A', 'Z'].
+inline __m128i toLowerVector(__m128i chars) {
+  const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('A' - 1)),
+                                      _mm_cmplt_epi8(chars, _mm_set1_epi8('Z' + 1)));
+  return _mm_or_si128(chars, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+inline __m128i loadVector(const char* buffer) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer));
+}
+
+inline void storeVector(char* buffer, __m128i chars) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), chars);
+}
+
+// Matches any of three characters in each byte of a vector.
+inline __m128i matchVector(const char* buffer, __m128i c1, __m128i c2, __m128i c3) {
+  const __m128i chars = loadVector(buffer);
+  return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, c1), _mm_cmpeq_epi8(chars, c2)),
+                      _mm_cmpeq_epi8(chars, c3));
+}
+#endif
+
+#if defined(__AVX2__)
+inline __m256i toLowerVector(__m256i chars) {
+  const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('A' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), chars));
+  return _mm256_or_si256(chars, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+#endif
+
+} // namespace
+
+void AsciiUtility::toLowerCase(char* buffer, size_t size) {
+  // As for words, the last vector may overlap the previous one and is loaded first.
+#if defined(__AVX2__)
+  if (size >= 32) {
+    const __m256i last = _mm256_loadu_si256(reinterpret_cast<__m256i*>(buffer + size - 32));
+    for (size_t i = 0; i + 32 < size; i += 32) {
+      __m256i* p = reinterpret_cast<__m256i*>(buffer + i);
+      _mm256_storeu_si256(p, toLowerVector(_mm256_loadu_si256(p)));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(buffer + size - 32), toLowerVector(last));
+    return;
+  }
+#endif
+#if defined(__SSE2__)
+  if (size >= 16) {
+    const __m128i last = loadVector(buffer + size - 16);
+    for (size_t i = 0; i + 16 < size; i += 16) {
+      storeVector(buffer + i, toLowerVector(loadVector(buffer + i)));
+    }
+    storeVector(buffer + size - 16, toLowerVector(last));
+    return;
+  }
+#endif
+  // Most header names are shorter than a vector, so they are converted a word at a time.
+  if (size >= 8) {
+    toLowerWords<uint64_t>(buffer, size);
+  } else if (size >= 4) {
+    toLowerWords<uint32_t>(buffer, size);
+  } else {
+    for (size_t i = 0; i < size; ++i) {
+      buffer[i] = toLowerChar(buffer[i]);
+    }
+  }
+}
+
+size_t AsciiUtility::findFirstOf(absl::string_view s, char c1, char c2, char c3) {
+  const char* data = s.data();
+  const size_t size = s.size();
+  size_t i = 0;
+#if defined(__SSE2__)
+  if (size >= 16) {
+    const __m128i v1 = _mm_set1_epi8(c1);
+    const __m128i v2 = _mm_set1_epi8(c2);
+    const __m128i v3 = _mm_set1_epi8(c3);
+    // Long strings are searched 64 bytes at a time, with a single test for a match in any of them.
+    for (; i + 64 <= size; i += 64) {
+      const __m128i any = _mm_or_si128(
+          _mm_or_si128(matchVector(data + i, v1, v2, v3), matchVector(data + i + 16, v1, v2, v3)),
+          _mm_or_si128(matchVector(data + i + 32, v1, v2, v3),
+                       matchVector(data + i + 48, v1, v2, v3)));
+      if (_mm_movemask_epi8(any) != 0) {
+        break;
+      }
+    }
+    for (; i + 16 <= size; i += 16) {
+      const uint32_t mask = _mm_movemask_epi8(matchVector(data + i, v1, v2, v3));
+      if (mask != 0) {
+        return i + __builtin_ctz(mask);
+      }
+    }
+    if (i == size) {
+      return absl::string_view::npos;
+    }
+    // The bytes before i have no match, so the last vector may overlap them.
+    const uint32_t mask = _mm_movemask_epi8(matchVector(data + size - 16, v1, v2, v3));
+    return mask != 0 ? size - 16 + __builtin_ctz(mask) : absl::string_view::npos;
+  }
+#endif
+  for (; i < size; ++i) {
+    if (data[i] == c1 || data[i] == c2 || data[i] == c3) {
+      return i;
+    }
+  }
+  return absl::string_view::npos;
+}
+
+} // namespace Envoy
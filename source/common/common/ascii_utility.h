@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+
+/**
+ * ASCII routines on the header processing path. They work on 16 bytes at a time with SSE2, or 32
+ * with AVX2 when built for it, and fall back to scalar code for the remaining bytes and on other
+ * architectures.
+ */
+class AsciiUtility final {
+public:
+  /**
+   * Convert the ASCII upper case letters of a string to lower case in place. Other bytes, including
+   * those outside of ASCII, are left unchanged.
+   * @param buffer supplies the start of the string.
+   * @param size supplies the size of the string.
+   */
+  static void toLowerCase(char* buffer, size_t size);
+
+  /**
+   * Find the first occurrence of any of three characters in a string.
+   * @param s supplies the string to search.
+   * @param c1, c2, c3 supply the characters to search for.
+   * @return size_t the position of the first match, or absl::string_view::npos if there is none.
+   */
+  static size_t findFirstOf(absl::string_view s, char c1, char c2, char c3);
+};
+
+} // namespace Envoy
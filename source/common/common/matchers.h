@@ -3,11 +3,13 @@
 #include <string>
 
 #include "envoy/api/v2/core/base.pb.h"
+#include "envoy/common/regex.h"
 #include "envoy/type/matcher/metadata.pb.h"
 #include "envoy/type/matcher/number.pb.h"
 #include "envoy/type/matcher/string.pb.h"
 #include "envoy/type/matcher/value.pb.h"
 
+#include "common/common/regex.h"
 #include "common/common/utility.h"
 #include "common/protobuf/protobuf.h"
 
@@ -74,7 +76,9 @@ class StringMatcher : public ValueMatcher {
 public:
   StringMatcher(const envoy::type::matcher::StringMatcher& matcher) : matcher_(matcher) {
     if (matcher.match_pattern_case() == envoy::type::matcher::StringMatcher::kRegex) {
-      regex_ = RegexUtil::parseRegex(matcher_.regex());
+      regex_ = Regex::Utility::parseStdRegexAsCompiledMatcher(matcher_.regex());
+    } else if (matcher.match_pattern_case() == envoy::type::matcher::StringMatcher::kSafeRegex) {
+      regex_ = Regex::Utility::parseRegex(matcher_.safe_regex());
     }
   }
 
@@ -84,7 +88,8 @@ public:
 
 private:
   const envoy::type::matcher::StringMatcher matcher_;
-  std::regex regex_;
+  // Shared so that string matchers stay copyable, the compiled regex is immutable.
+  std::shared_ptr<const Regex::CompiledMatcher> regex_;
 };
 
 class LowerCaseStringMatcher : public ValueMatcher {
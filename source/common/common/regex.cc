@@ -0,0 +1,69 @@
+#include "common/common/regex.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/utility.h"
+
+#include "re2/re2.h"
+
+namespace Envoy {
+namespace Regex {
+namespace {
+
+class CompiledStdMatcher : public CompiledMatcher {
+public:
+  CompiledStdMatcher(std::regex&& regex) : regex_(std::move(regex)) {}
+
+  // CompiledMatcher
+  bool match(absl::string_view value) const override {
+    return std::regex_match(value.begin(), value.end(), regex_);
+  }
+
+private:
+  const std::regex regex_;
+};
+
+class CompiledGoogleReMatcher : public CompiledMatcher {
+public:
+  CompiledGoogleReMatcher(const envoy::type::matcher::RegexMatcher& config)
+      : regex_(config.regex(), re2::RE2::Quiet) {
+    if (!regex_.ok()) {
+      throw EnvoyException(fmt::format("Invalid regex '{}': {}", config.regex(), regex_.error()));
+    }
+
+    const uint32_t max_program_size = config.google_re2().has_max_program_size()
+                                          ? config.google_re2().max_program_size().value()
+                                          : DefaultMaxProgramSize;
+    const uint32_t program_size = regex_.ProgramSize();
+    if (program_size > max_program_size) {
+      throw EnvoyException(fmt::format("regex '{}' RE2 program size of {} > max program size of {}",
+                                       config.regex(), program_size, max_program_size));
+    }
+  }
+
+  // CompiledMatcher
+  bool match(absl::string_view value) const override {
+    return re2::RE2::FullMatch(re2::StringPiece(value.data(), value.size()), regex_);
+  }
+
+private:
+  const re2::RE2 regex_;
+};
+
+} // namespace
+
+CompiledMatcherPtr Utility::parseStdRegexAsCompiledMatcher(const std::string& regex,
+                                                           std::regex::flag_type flags) {
+  return std::make_unique<const CompiledStdMatcher>(RegexUtil::parseRegex(regex, flags));
+}
+
+CompiledMatcherPtr Utility::parseRegex(const envoy::type::matcher::RegexMatcher& matcher) {
+  // Google Re is the only currently supported engine.
+  ASSERT(matcher.has_google_re2());
+  return std::make_unique<const CompiledGoogleReMatcher>(matcher);
+}
+
+} // namespace Regex
+} // namespace Envoy
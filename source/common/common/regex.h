@@ -0,0 +1,45 @@
+#pragma once
+
+#include <regex>
+#include <string>
+
+#include "envoy/common/regex.h"
+#include "envoy/type/matcher/regex.pb.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * Default maximum RE2 program size, used when a GoogleRE2 matcher does not configure one.
+ */
+constexpr uint32_t DefaultMaxProgramSize = 100;
+
+/**
+ * Utilities for constructing regular expressions.
+ */
+class Utility {
+public:
+  /**
+   * Constructs a CompiledMatcher backed by std::regex, for call sites configured with a plain
+   * regex string.
+   * @param regex supplies the ECMAScript regex string.
+   * @param flags supplies the std::regex parser flags.
+   * @return the compiled matcher.
+   * @throw EnvoyException if the regex string is invalid.
+   */
+  static CompiledMatcherPtr
+  parseStdRegexAsCompiledMatcher(const std::string& regex,
+                                 std::regex::flag_type flags = std::regex::optimize);
+
+  /**
+   * Constructs a CompiledMatcher using the engine configured in a RegexMatcher.
+   * @param matcher supplies the regex matcher configuration.
+   * @return the compiled matcher.
+   * @throw EnvoyException if the regex string is invalid or exceeds the configured limits of the
+   *        engine.
+   */
+  static CompiledMatcherPtr parseRegex(const envoy::type::matcher::RegexMatcher& matcher);
+};
+
+} // namespace Regex
+} // namespace Envoy
@@ -1,17 +1,15 @@
 #pragma once
 
-#include <array>
+#include <cstdint>
 #include <string>
 
 namespace Envoy {
 /**
- * Convenience class for converting ASCII strings to lower case using a lookup table for maximum
- * speed.
+ * Convenience class for converting ASCII strings to lower case. The conversion is vectorized by
+ * AsciiUtility where the platform supports it.
  */
 class ToLowerTable {
 public:
-  ToLowerTable();
-
   /**
    * Convert a string to lower case.
    * @param buffer supplies the start of the string.
@@ -24,8 +22,5 @@ public:
    * @param supplies the string to convert.
    */
   void toLowerCase(std::string& string) const { toLowerCase(&string[0], string.size()); }
-
-private:
-  std::array<uint8_t, 256> table_;
 };
 } // namespace Envoy
@@ -25,6 +25,12 @@ ZlibCompressorImpl::ZlibCompressorImpl(uint64_t chunk_size)
   zstream_ptr_->next_out = chunk_char_ptr_.get();
 }
 
+ZlibCompressorImpl::~ZlibCompressorImpl() {
+  if (pool_ != nullptr) {
+    pool_->release(pool_key_, std::move(zstream_ptr_));
+  }
+}
+
 void ZlibCompressorImpl::init(CompressionLevel comp_level, CompressionStrategy comp_strategy,
                               int64_t window_bits, uint64_t memory_level = 8) {
   ASSERT(initialized_ == false);
@@ -34,6 +40,20 @@ void ZlibCompressorImpl::init(CompressionLevel comp_level, CompressionStrategy c
   initialized_ = true;
 }
 
+void ZlibCompressorImpl::init(CompressionLevel comp_level, CompressionStrategy comp_strategy,
+                              int64_t window_bits, uint64_t memory_level,
+                              const ZlibDeflateStatePoolSharedPtr& pool) {
+  ASSERT(initialized_ == false);
+  pool_key_ = ZlibDeflateStatePool::Key{static_cast<int64_t>(comp_level),
+                                        static_cast<uint64_t>(comp_strategy), window_bits,
+                                        memory_level};
+  zstream_ptr_ = pool->acquire(pool_key_);
+  zstream_ptr_->avail_out = chunk_size_;
+  zstream_ptr_->next_out = chunk_char_ptr_.get();
+  pool_ = pool;
+  initialized_ = true;
+}
+
 uint64_t ZlibCompressorImpl::checksum() { return zstream_ptr_->adler; }
 
 void ZlibCompressorImpl::compress(Buffer::Instance& buffer, State state) {
@@ -91,10 +111,47 @@ void ZlibCompressorImpl::updateOutput(Buffer::Instance& output_buffer) {
   if (n_output > 0) {
     output_buffer.add(static_cast<void*>(chunk_char_ptr_.get()), n_output);
   }
-  chunk_char_ptr_ = std::make_unique<unsigned char[]>(chunk_size_);
+  // The output was copied into the buffer, so the chunk can be reused as is.
   zstream_ptr_->avail_out = chunk_size_;
   zstream_ptr_->next_out = chunk_char_ptr_.get();
 }
 
+ZlibDeflateStatePool::DeflateStatePtr ZlibDeflateStatePool::acquire(const Key& key) {
+  auto it = idle_states_.find(key);
+  if (it != idle_states_.end() && !it->second.empty()) {
+    DeflateStatePtr state = std::move(it->second.back());
+    it->second.pop_back();
+    return state;
+  }
+
+  DeflateStatePtr state(new z_stream(), [](z_stream* z) {
+    deflateEnd(z);
+    delete z;
+  });
+  state->zalloc = Z_NULL;
+  state->zfree = Z_NULL;
+  state->opaque = Z_NULL;
+  const int result = deflateInit2(state.get(), std::get<0>(key), Z_DEFLATED, std::get<2>(key),
+                                  std::get<3>(key), std::get<1>(key));
+  RELEASE_ASSERT(result >= 0, "");
+  return state;
+}
+
+void ZlibDeflateStatePool::release(const Key& key, DeflateStatePtr&& state) {
+  std::vector<DeflateStatePtr>& idle_states = idle_states_[key];
+  // deflateReset() keeps the parameters and the allocated memory of the state.
+  if (idle_states.size() < max_idle_states_ && deflateReset(state.get()) == Z_OK) {
+    idle_states.push_back(std::move(state));
+  }
+}
+
+uint64_t ZlibDeflateStatePool::idleStates() const {
+  uint64_t idle_states = 0;
+  for (const auto& states : idle_states_) {
+    idle_states += states.second.size();
+  }
+  return idle_states;
+}
+
 } // namespace Compressor
 } // namespace Envoy
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
 #include "envoy/compressor/compressor.h"
 
 #include "zlib.h"
@@ -7,6 +13,9 @@
 namespace Envoy {
 namespace Compressor {
 
+class ZlibDeflateStatePool;
+typedef std::shared_ptr<ZlibDeflateStatePool> ZlibDeflateStatePoolSharedPtr;
+
 /**
  * Implementation of compressor's interface.
  */
@@ -24,6 +33,8 @@ public:
    */
   ZlibCompressorImpl(uint64_t chunk_size);
 
+  ~ZlibCompressorImpl();
+
   /**
    * Enum values used to set compression level during initialization.
    * best: gives best compression.
@@ -64,6 +75,15 @@ public:
   void init(CompressionLevel level, CompressionStrategy strategy, int64_t window_bits,
             uint64_t memory_level);
 
+  /**
+   * Same as init(), except that the deflate state is taken from an idle state with the same
+   * parameters in pool if there is one, and is handed back to pool when the compressor is
+   * destroyed. The pool must only be used from the thread that owns it.
+   * @param pool supplies the pool of deflate states.
+   */
+  void init(CompressionLevel level, CompressionStrategy strategy, int64_t window_bits,
+            uint64_t memory_level, const ZlibDeflateStatePoolSharedPtr& pool);
+
   /**
    * It returns the checksum of all output produced so far. Compressor's checksum at the end of the
    * stream has to match decompressor's checksum produced at the end of the decompression.
@@ -85,6 +105,49 @@ private:
 
   std::unique_ptr<unsigned char[]> chunk_char_ptr_;
   std::unique_ptr<z_stream, std::function<void(z_stream*)>> zstream_ptr_;
+  ZlibDeflateStatePoolSharedPtr pool_;
+  std::tuple<int64_t, uint64_t, int64_t, uint64_t> pool_key_;
+};
+
+/**
+ * Pool of initialized deflate states. deflateInit2() allocates the sliding window and hash
+ * tables of a deflate state, which take (1 << (windowBits + 2)) + (1 << (memLevel + 9)) bytes,
+ * i.e. 256KB with the defaults of zlib, and those allocations dominate the cost of compressing
+ * small responses. Resetting an idle state instead
+ * keeps them. The pool is not thread safe: each thread that compresses data should own one.
+ */
+class ZlibDeflateStatePool {
+public:
+  typedef std::unique_ptr<z_stream, std::function<void(z_stream*)>> DeflateStatePtr;
+  // Compression level, strategy, window bits and memory level of a deflate state.
+  typedef std::tuple<int64_t, uint64_t, int64_t, uint64_t> Key;
+
+  /**
+   * @param max_idle_states supplies the maximum number of idle states kept per set of
+   *        parameters. States released while the pool is full are freed.
+   */
+  explicit ZlibDeflateStatePool(uint64_t max_idle_states) : max_idle_states_(max_idle_states) {}
+
+  /**
+   * @return an initialized deflate state with the parameters of key.
+   */
+  DeflateStatePtr acquire(const Key& key);
+
+  /**
+   * Reset a deflate state and keep it for reuse.
+   * @param key supplies the parameters the state was acquired with.
+   * @param state supplies the state.
+   */
+  void release(const Key& key, DeflateStatePtr&& state);
+
+  /**
+   * @return the total number of idle states in the pool.
+   */
+  uint64_t idleStates() const;
+
+private:
+  const uint64_t max_idle_states_;
+  std::map<Key, std::vector<DeflateStatePtr>> idle_states_;
 };
 
 } // namespace Compressor
@@ -171,6 +171,12 @@ public:
     kickOffDiscoveryRequestWithAck(ack);
   }
 
+  // Delta responses are not parsed into arenas yet.
+  bool useResponseArena() override { return false; }
+  void onArenaDiscoveryResponse(envoy::api::v2::DeltaDiscoveryResponse&) override {
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+
   void onWriteable() override { trySendDiscoveryRequests(); }
 
 private:
@@ -12,11 +12,10 @@ GrpcMuxImpl::GrpcMuxImpl(const LocalInfo::LocalInfo& local_info, Grpc::AsyncClie
                          Event::Dispatcher& dispatcher,
                          const Protobuf::MethodDescriptor& service_method,
                          Runtime::RandomGenerator& random, Stats::Scope& scope,
-                         const RateLimitSettings& rate_limit_settings)
+                         const RateLimitSettings& rate_limit_settings, bool use_response_arena)
     : grpc_stream_(this, std::move(async_client), service_method, random, dispatcher, scope,
                    rate_limit_settings),
-
-      local_info_(local_info) {
+      local_info_(local_info), use_response_arena_(use_response_arena) {
   Config::Utility::checkLocalInfo("ads", local_info);
 }
 
@@ -116,8 +115,16 @@ void GrpcMuxImpl::resume(const std::string& type_url) {
 
 void GrpcMuxImpl::onDiscoveryResponse(
     std::unique_ptr<envoy::api::v2::DiscoveryResponse>&& message) {
-  const std::string& type_url = message->type_url();
-  ENVOY_LOG(debug, "Received gRPC message for {} at version {}", type_url, message->version_info());
+  handleDiscoveryResponse(*message);
+}
+
+void GrpcMuxImpl::onArenaDiscoveryResponse(envoy::api::v2::DiscoveryResponse& message) {
+  handleDiscoveryResponse(message);
+}
+
+void GrpcMuxImpl::handleDiscoveryResponse(const envoy::api::v2::DiscoveryResponse& message) {
+  const std::string& type_url = message.type_url();
+  ENVOY_LOG(debug, "Received gRPC message for {} at version {}", type_url, message.version_info());
   if (api_state_.count(type_url) == 0) {
     ENVOY_LOG(warn, "Ignoring the message for type URL {} as it has no current subscribers.",
               type_url);
@@ -127,14 +134,14 @@ void GrpcMuxImpl::onDiscoveryResponse(
   }
   if (api_state_[type_url].watches_.empty()) {
     // update the nonce as we are processing this response.
-    api_state_[type_url].request_.set_response_nonce(message->nonce());
-    if (message->resources().empty()) {
+    api_state_[type_url].request_.set_response_nonce(message.nonce());
+    if (message.resources().empty()) {
       // No watches and no resources. This can happen when envoy unregisters from a
       // resource that's removed from the server as well. For example, a deleted cluster
       // triggers un-watching the ClusterLoadAssignment watch, and at the same time the
       // xDS server sends an empty list of ClusterLoadAssignment resources. we'll accept
       // this update. no need to send a discovery request, as we don't watch for anything.
-      api_state_[type_url].request_.set_version_info(message->version_info());
+      api_state_[type_url].request_.set_version_info(message.version_info());
     } else {
       // No watches and we have resources - this should not happen. send a NACK (by not
       // updating the version).
@@ -150,10 +157,10 @@ void GrpcMuxImpl::onDiscoveryResponse(
     // ensure we deliver empty config updates when a resource is dropped.
     std::unordered_map<std::string, ProtobufWkt::Any> resources;
     GrpcMuxCallbacks& callbacks = api_state_[type_url].watches_.front()->callbacks_;
-    for (const auto& resource : message->resources()) {
+    for (const auto& resource : message.resources()) {
       if (type_url != resource.type_url()) {
         throw EnvoyException(fmt::format("{} does not match {} type URL in DiscoveryResponse {}",
-                                         resource.type_url(), type_url, message->DebugString()));
+                                         resource.type_url(), type_url, message.DebugString()));
       }
       const std::string resource_name = callbacks.resourceName(resource);
       resources.emplace(resource_name, resource);
@@ -163,7 +170,7 @@ void GrpcMuxImpl::onDiscoveryResponse(
       // Listener) even if the message does not have resources so that update_empty stat
       // is properly incremented and state-of-the-world semantics are maintained.
       if (watch->resources_.empty()) {
-        watch->callbacks_.onConfigUpdate(message->resources(), message->version_info());
+        watch->callbacks_.onConfigUpdate(message.resources(), message.version_info());
         continue;
       }
       Protobuf::RepeatedPtrField<ProtobufWkt::Any> found_resources;
@@ -176,12 +183,12 @@ void GrpcMuxImpl::onDiscoveryResponse(
       // onConfigUpdate should be called only on watches(clusters/routes) that have
       // updates in the message for EDS/RDS.
       if (!found_resources.empty()) {
-        watch->callbacks_.onConfigUpdate(found_resources, message->version_info());
+        watch->callbacks_.onConfigUpdate(found_resources, message.version_info());
       }
     }
     // TODO(mattklein123): In the future if we start tracking per-resource versions, we
     // would do that tracking here.
-    api_state_[type_url].request_.set_version_info(message->version_info());
+    api_state_[type_url].request_.set_version_info(message.version_info());
   } catch (const EnvoyException& e) {
     for (auto watch : api_state_[type_url].watches_) {
       watch->callbacks_.onConfigUpdateFailed(&e);
@@ -190,7 +197,7 @@ void GrpcMuxImpl::onDiscoveryResponse(
     error_detail->set_code(Grpc::Status::GrpcStatus::Internal);
     error_detail->set_message(e.what());
   }
-  api_state_[type_url].request_.set_response_nonce(message->nonce());
+  api_state_[type_url].request_.set_response_nonce(message.nonce());
   queueDiscoveryRequest(type_url);
 }
 
@@ -27,7 +27,7 @@ public:
   GrpcMuxImpl(const LocalInfo::LocalInfo& local_info, Grpc::AsyncClientPtr async_client,
               Event::Dispatcher& dispatcher, const Protobuf::MethodDescriptor& service_method,
               Runtime::RandomGenerator& random, Stats::Scope& scope,
-              const RateLimitSettings& rate_limit_settings);
+              const RateLimitSettings& rate_limit_settings, bool use_response_arena);
   ~GrpcMuxImpl();
 
   void start() override;
@@ -42,6 +42,8 @@ public:
   void onStreamEstablished() override;
   void onEstablishmentFailure() override;
   void onDiscoveryResponse(std::unique_ptr<envoy::api::v2::DiscoveryResponse>&& message) override;
+  bool useResponseArena() override { return use_response_arena_; }
+  void onArenaDiscoveryResponse(envoy::api::v2::DiscoveryResponse& message) override;
   void onWriteable() override;
 
   GrpcStream<envoy::api::v2::DiscoveryRequest, envoy::api::v2::DiscoveryResponse>&
@@ -51,6 +53,7 @@ public:
 
 private:
   void setRetryTimer();
+  void handleDiscoveryResponse(const envoy::api::v2::DiscoveryResponse& message);
 
   struct GrpcMuxWatchImpl : public GrpcMuxWatch {
     GrpcMuxWatchImpl(const std::set<std::string>& resources, GrpcMuxCallbacks& callbacks,
@@ -97,6 +100,7 @@ private:
 
   GrpcStream<envoy::api::v2::DiscoveryRequest, envoy::api::v2::DiscoveryResponse> grpc_stream_;
   const LocalInfo::LocalInfo& local_info_;
+  const bool use_response_arena_;
   std::unordered_map<std::string, ApiState> api_state_;
   // Envoy's dependency ordering.
   std::list<std::string> subscriptions_;
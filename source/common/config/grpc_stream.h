@@ -69,15 +69,17 @@ public:
   }
 
   void onReceiveMessage(std::unique_ptr<ResponseProto>&& message) override {
-    // Reset here so that it starts with fresh backoff interval on next disconnect.
-    backoff_strategy_->reset();
-    // Sometimes during hot restarts this stat's value becomes inconsistent and will continue to
-    // have 0 until it is reconnected. Setting here ensures that it is consistent with the state of
-    // management server connection.
-    control_plane_stats_.connected_state_.set(1);
+    onMessageReceived();
     callbacks_->onDiscoveryResponse(std::move(message));
   }
 
+  bool useResponseArena() override { return callbacks_->useResponseArena(); }
+
+  void onReceiveArenaMessage(ResponseProto& message) override {
+    onMessageReceived();
+    callbacks_->onArenaDiscoveryResponse(message);
+  }
+
   void onReceiveTrailingMetadata(Http::HeaderMapPtr&& metadata) override {
     UNREFERENCED_PARAMETER(metadata);
   }
@@ -115,6 +117,15 @@ public:
   }
 
 private:
+  void onMessageReceived() {
+    // Reset here so that it starts with fresh backoff interval on next disconnect.
+    backoff_strategy_->reset();
+    // Sometimes during hot restarts this stat's value becomes inconsistent and will continue to
+    // have 0 until it is reconnected. Setting here ensures that it is consistent with the state of
+    // management server connection.
+    control_plane_stats_.connected_state_.set(1);
+  }
+
   void setRetryTimer() {
     retry_timer_->enableTimer(std::chrono::milliseconds(backoff_strategy_->nextBackOffMs()));
   }
@@ -18,10 +18,10 @@ public:
                        Event::Dispatcher& dispatcher, Runtime::RandomGenerator& random,
                        const Protobuf::MethodDescriptor& service_method, absl::string_view type_url,
                        SubscriptionStats stats, Stats::Scope& scope,
-                       const RateLimitSettings& rate_limit_settings,
+                       const RateLimitSettings& rate_limit_settings, bool use_response_arena,
                        std::chrono::milliseconds init_fetch_timeout)
       : grpc_mux_(local_info, std::move(async_client), dispatcher, service_method, random, scope,
-                  rate_limit_settings),
+                  rate_limit_settings, use_response_arena),
         grpc_mux_subscription_(grpc_mux_, stats, type_url, dispatcher, init_fetch_timeout) {}
 
   // Config::Subscription
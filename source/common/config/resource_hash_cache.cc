@@ -0,0 +1,50 @@
+#include "common/config/resource_hash_cache.h"
+
+#include "common/common/hash.h"
+
+namespace Envoy {
+namespace Config {
+
+uint64_t ResourceHashCache::hash(const ProtobufWkt::Any& resource) {
+  // The type URL is the same for all resources of a subscription, so only the value is hashed.
+  return HashUtil::xxHash64(resource.value());
+}
+
+const std::string* ResourceHashCache::find(uint64_t hash) const {
+  const auto it = names_.find(hash);
+  return it == names_.end() ? nullptr : &it->second;
+}
+
+bool ResourceHashCache::contains(const std::string& name, uint64_t hash) const {
+  const auto it = hashes_.find(name);
+  return it != hashes_.end() && it->second == hash;
+}
+
+void ResourceHashCache::insert(const std::string& name, uint64_t hash) {
+  auto it = hashes_.find(name);
+  if (it != hashes_.end()) {
+    eraseName(name, it->second);
+    it->second = hash;
+  } else {
+    hashes_.emplace(name, hash);
+  }
+  names_[hash] = name;
+}
+
+void ResourceHashCache::erase(const std::string& name) {
+  const auto it = hashes_.find(name);
+  if (it != hashes_.end()) {
+    eraseName(name, it->second);
+    hashes_.erase(it);
+  }
+}
+
+void ResourceHashCache::eraseName(const std::string& name, uint64_t hash) {
+  const auto it = names_.find(hash);
+  if (it != names_.end() && it->second == name) {
+    names_.erase(it);
+  }
+}
+
+} // namespace Config
+} // namespace Envoy
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * Remembers a hash of the serialized form of each resource last applied from a subscription, by
+ * resource name. An xDS API can then skip a resource that arrives again with the same bytes before
+ * converting it from its Any, validating it and handing it to its manager, which would find it
+ * unchanged and skip it anyway. Like the config hashes the cluster and listener managers compare, a
+ * 64 bit hash is trusted to tell changed resources apart.
+ */
+class ResourceHashCache {
+public:
+  /**
+   * @param resource supplies a serialized resource.
+   * @return uint64_t the hash of its serialized bytes.
+   */
+  static uint64_t hash(const ProtobufWkt::Any& resource);
+
+  /**
+   * @param hash supplies the hash of a serialized resource.
+   * @return const std::string* the name of the resource last applied with that hash, or nullptr if
+   *         there is none.
+   */
+  const std::string* find(uint64_t hash) const;
+
+  /**
+   * @param name supplies a resource name.
+   * @param hash supplies the hash of a serialized resource.
+   * @return bool whether the named resource was last applied with that hash.
+   */
+  bool contains(const std::string& name, uint64_t hash) const;
+
+  /**
+   * Records that the named resource has been applied with the given hash.
+   */
+  void insert(const std::string& name, uint64_t hash);
+
+  /**
+   * Forgets the named resource, e.g. because it has been removed.
+   */
+  void erase(const std::string& name);
+
+  size_t size() const { return hashes_.size(); }
+
+private:
+  void eraseName(const std::string& name, uint64_t hash);
+
+  std::unordered_map<std::string, uint64_t> hashes_;
+  std::unordered_map<uint64_t, std::string> names_;
+};
+
+} // namespace Config
+} // namespace Envoy
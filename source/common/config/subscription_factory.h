@@ -77,6 +77,7 @@ public:
             dispatcher, random,
             *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(grpc_method), type_url,
             stats, scope, Utility::parseRateLimitSettings(api_config_source),
+            api_config_source.use_response_arena(),
             Utility::configSourceInitialFetchTimeout(config));
         break;
       case envoy::api::v2::core::ApiConfigSource::DELTA_GRPC: {
@@ -242,6 +242,18 @@ Utility::createStatsMatcher(const envoy::config::bootstrap::v2::Bootstrap& boots
   return std::make_unique<Stats::StatsMatcherImpl>(bootstrap.stats_config());
 }
 
+Stats::HistogramSettings
+Utility::createHistogramSettings(const envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+  const auto& config = bootstrap.stats_config().histogram_settings();
+  Stats::HistogramSettings settings;
+  if (config.backend() == envoy::config::metrics::v2::HistogramSettings::LOG_LINEAR) {
+    settings.backend_ = Stats::HistogramSettings::Backend::LogLinear;
+  }
+  settings.precision_bits_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, precision_bits, Stats::HistogramSettings::DefaultPrecisionBits);
+  return settings;
+}
+
 void Utility::checkObjNameLength(const std::string& error_prefix, const std::string& name,
                                  const Stats::StatsOptions& stats_options) {
   if (name.length() > stats_options.maxNameLength()) {
@@ -10,6 +10,7 @@
 #include "envoy/local_info/local_info.h"
 #include "envoy/registry/registry.h"
 #include "envoy/server/filter_config.h"
+#include "envoy/stats/histogram.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_matcher.h"
 #include "envoy/stats/stats_options.h"
@@ -289,6 +290,12 @@ public:
   static Stats::StatsMatcherPtr
   createStatsMatcher(const envoy::config::bootstrap::v2::Bootstrap& bootstrap);
 
+  /**
+   * Create HistogramSettings from the bootstrap stats config.
+   */
+  static Stats::HistogramSettings
+  createHistogramSettings(const envoy::config::bootstrap::v2::Bootstrap& bootstrap);
+
   /**
    * Check user supplied name in RDS/CDS/LDS for sanity.
    * It should be within the configured length limit. Throws on error.
@@ -129,17 +129,26 @@ void AsyncStreamImpl::onData(Buffer::Instance& data, bool end_stream) {
   }
 
   for (auto& frame : decoded_frames_) {
-    ProtobufTypes::MessagePtr response = callbacks_.createEmptyResponse();
-    // TODO(htuch): Need to add support for compressed responses as well here.
-    if (frame.length_ > 0) {
-      Buffer::ZeroCopyInputStreamImpl stream(std::move(frame.data_));
-
-      if (frame.flags_ != GRPC_FH_DEFAULT || !response->ParseFromZeroCopyStream(&stream)) {
+    if (callbacks_.useResponseArena()) {
+      if (response_prototype_ == nullptr) {
+        response_prototype_ = callbacks_.createEmptyResponse();
+      }
+      // Everything the response allocates is freed with the arena once the callbacks return.
+      Protobuf::Arena arena(Common::arenaOptions(frame.length_));
+      Protobuf::Message* response = response_prototype_->New(&arena);
+      if (!parseFrame(frame, *response)) {
+        streamError(Status::GrpcStatus::Internal);
+        return;
+      }
+      callbacks_.onReceiveArenaMessageUntyped(*response);
+    } else {
+      ProtobufTypes::MessagePtr response = callbacks_.createEmptyResponse();
+      if (!parseFrame(frame, *response)) {
         streamError(Status::GrpcStatus::Internal);
         return;
       }
+      callbacks_.onReceiveMessageUntyped(std::move(response));
     }
-    callbacks_.onReceiveMessageUntyped(std::move(response));
   }
 
   if (end_stream) {
@@ -148,6 +157,18 @@ void AsyncStreamImpl::onData(Buffer::Instance& data, bool end_stream) {
   }
 }
 
+bool AsyncStreamImpl::parseFrame(Frame& frame, Protobuf::Message& response) {
+  if (frame.length_ == 0) {
+    return true;
+  }
+  // TODO(htuch): Need to add support for compressed responses as well here.
+  if (frame.flags_ != GRPC_FH_DEFAULT) {
+    return false;
+  }
+  Buffer::ZeroCopyInputStreamImpl stream(std::move(frame.data_));
+  return response.ParseFromZeroCopyStream(&stream);
+}
+
 // TODO(htuch): match Google gRPC base64 encoding behavior for *-bin headers, see
 // https://github.com/envoyproxy/envoy/pull/2444#discussion_r163914459.
 void AsyncStreamImpl::onTrailers(Http::HeaderMapPtr&& trailers) {
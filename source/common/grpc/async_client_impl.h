@@ -66,6 +66,7 @@ private:
   void streamError(Status::GrpcStatus grpc_status) { streamError(grpc_status, EMPTY_STRING); }
 
   void cleanup();
+  static bool parseFrame(Frame& frame, Protobuf::Message& response);
   void trailerResponse(absl::optional<Status::GrpcStatus> grpc_status,
                        const std::string& grpc_message);
 
@@ -80,6 +81,8 @@ private:
   Decoder decoder_;
   // This is a member to avoid reallocation on every onData().
   std::vector<Frame> decoded_frames_;
+  // Only used to create responses on arenas, when the callbacks ask for that.
+  ProtobufTypes::MessagePtr response_prototype_;
 
   friend class AsyncClientImpl;
 };
@@ -2,6 +2,7 @@
 
 #include <arpa/inet.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <string>
@@ -201,6 +202,16 @@ void Common::toGrpcTimeout(const std::chrono::milliseconds& timeout, Http::Heade
   value.append(unit, 1);
 }
 
+Protobuf::ArenaOptions Common::arenaOptions(uint64_t length) {
+  Protobuf::ArenaOptions options;
+  // A parsed message takes somewhat more memory than its encoding, mostly for the strings and
+  // submessage objects it is made of. Blocks after the first are grown to at least its size,
+  // rather than protobuf's small default maximum, for messages that outgrow it.
+  options.start_block_size = std::max<size_t>(2 * length, options.start_block_size);
+  options.max_block_size = std::max(options.start_block_size, options.max_block_size);
+  return options;
+}
+
 Http::MessagePtr Common::prepareHeaders(const std::string& upstream_cluster,
                                         const std::string& service_full_name,
                                         const std::string& method_name,
@@ -123,6 +123,14 @@ public:
    */
   static Buffer::InstancePtr serializeBody(const Protobuf::Message& message);
 
+  /**
+   * Options for an arena to parse a message into. The first block is sized after the encoded
+   * message, so that most messages take a single allocation.
+   * @param length supplies the length of the encoded message.
+   * @return Protobuf::ArenaOptions the arena options.
+   */
+  static Protobuf::ArenaOptions arenaOptions(uint64_t length);
+
   /**
    * Prepare headers for protobuf service.
    */
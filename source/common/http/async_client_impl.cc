@@ -13,7 +13,7 @@ namespace Envoy {
 namespace Http {
 
 const std::list<std::string> AsyncStreamImpl::NullCorsPolicy::allow_origin_;
-const std::list<std::regex> AsyncStreamImpl::NullCorsPolicy::allow_origin_regex_;
+const std::vector<Regex::CompiledMatcherPtr> AsyncStreamImpl::NullCorsPolicy::allow_origin_regex_;
 const absl::optional<bool> AsyncStreamImpl::NullCorsPolicy::allow_credentials_;
 const std::vector<std::reference_wrapper<const Router::RateLimitPolicyEntry>>
     AsyncStreamImpl::NullRateLimitPolicy::rate_limit_policy_entry_;
@@ -40,7 +40,9 @@ AsyncClientImpl::AsyncClientImpl(Upstream::ClusterInfoConstSharedPtr cluster,
                                  Router::ShadowWriterPtr&& shadow_writer,
                                  Http::Context& http_context)
     : cluster_(cluster),
-      config_("http.async-client.", local_info, stats_store, cm, runtime, random,
+      // The routes of the async client have no virtual clusters, so no stats are kept in the
+      // virtual cluster scope.
+      config_("http.async-client.", local_info, stats_store, stats_store, cm, runtime, random,
               std::move(shadow_writer), true, false, false, dispatcher.timeSource(), http_context),
       dispatcher_(dispatcher) {}
 
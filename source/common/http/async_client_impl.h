@@ -55,6 +55,11 @@ public:
 
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
 
+  /**
+   * @return whether any request or stream started on this client has not completed yet.
+   */
+  bool hasActiveStreams() const { return !active_streams_.empty(); }
+
 private:
   Upstream::ClusterInfoConstSharedPtr cluster_;
   Router::FilterConfig config_;
@@ -93,7 +98,7 @@ private:
   struct NullCorsPolicy : public Router::CorsPolicy {
     // Router::CorsPolicy
     const std::list<std::string>& allowOrigins() const override { return allow_origin_; };
-    const std::list<std::regex>& allowOriginRegexes() const override {
+    const std::vector<Regex::CompiledMatcherPtr>& allowOriginRegexes() const override {
       return allow_origin_regex_;
     };
     const std::string& allowMethods() const override { return EMPTY_STRING; };
@@ -105,7 +110,7 @@ private:
     bool shadowEnabled() const override { return false; };
 
     static const std::list<std::string> allow_origin_;
-    static const std::list<std::regex> allow_origin_regex_;
+    static const std::vector<Regex::CompiledMatcherPtr> allow_origin_regex_;
     static const absl::optional<bool> allow_credentials_;
   };
 
@@ -160,6 +165,8 @@ private:
     // Router::ShadowPolicy
     const std::string& cluster() const override { return EMPTY_STRING; }
     const std::string& runtimeKey() const override { return EMPTY_STRING; }
+    // The cluster is empty, so requests are never shadowed and the key is never looked up.
+    const Runtime::Key& resolvedRuntimeKey() const override { NOT_REACHED_GCOVR_EXCL_LINE; }
     const envoy::type::FractionalPercent& defaultValue() const override { return default_value_; }
 
   private:
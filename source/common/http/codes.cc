@@ -13,135 +13,184 @@
 
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
-#include "absl/strings/str_join.h"
 
 namespace Envoy {
 namespace Http {
 
+CodeStatsImpl::CodeStatsImpl(Stats::SymbolTable& symbol_table)
+    : symbol_table_(symbol_table), canary_(makeStatName("canary")),
+      external_(makeStatName("external")), internal_(makeStatName("internal")),
+      upstream_rq_2xx_(makeStatName("upstream_rq_2xx")),
+      upstream_rq_3xx_(makeStatName("upstream_rq_3xx")),
+      upstream_rq_4xx_(makeStatName("upstream_rq_4xx")),
+      upstream_rq_5xx_(makeStatName("upstream_rq_5xx")),
+      upstream_rq_unknown_(makeStatName("upstream_rq_")),
+      upstream_rq_completed_(makeStatName("upstream_rq_completed")),
+      upstream_rq_time_(makeStatName("upstream_rq_time")), vcluster_(makeStatName("vcluster")),
+      vhost_(makeStatName("vhost")), zone_(makeStatName("zone")) {
+  for (uint32_t i = 0; i < NumHttpCodes; ++i) {
+    upstream_rq_codes_[i] = makeStatName(absl::StrCat("upstream_rq_", i + HttpCodeOffset));
+  }
+}
+
+CodeStatsImpl::~CodeStatsImpl() {
+  for (Stats::StatNameStorage& stat_name_storage : storage_) {
+    stat_name_storage.free(symbol_table_);
+  }
+}
+
+Stats::StatName CodeStatsImpl::makeStatName(absl::string_view name) {
+  storage_.push_back(Stats::StatNameStorage(name, symbol_table_));
+  return storage_.back().statName();
+}
+
+void CodeStatsImpl::incCounter(Stats::Scope& scope, const Stats::StatNameVec& names) const {
+  const Stats::SymbolTable::StoragePtr stat_name_storage = symbol_table_.join(names);
+  scope.counterFromStatName(Stats::StatName(stat_name_storage.get())).inc();
+}
+
+void CodeStatsImpl::recordHistogram(Stats::Scope& scope, const Stats::StatNameVec& names,
+                                    uint64_t value) const {
+  const Stats::SymbolTable::StoragePtr stat_name_storage = symbol_table_.join(names);
+  scope.histogramFromStatName(Stats::StatName(stat_name_storage.get())).recordValue(value);
+}
+
 void CodeStatsImpl::chargeBasicResponseStat(Stats::Scope& scope, const std::string& prefix,
                                             Code response_code) const {
+  Stats::StatNameTempStorage prefix_storage(stripTrailingDot(prefix), symbol_table_);
+  chargeBasicResponseStat(scope, prefix_storage.statName(), response_code);
+}
+
+void CodeStatsImpl::chargeBasicResponseStat(Stats::Scope& scope, Stats::StatName prefix,
+                                            Code response_code) const {
   // Build a dynamic stat for the response code and increment it.
-  scope.counter(absl::StrCat(prefix, upstream_rq_completed_)).inc();
-  scope
-      .counter(absl::StrCat(prefix, upstream_rq_,
-                            CodeUtility::groupStringForResponseCode(response_code)))
-      .inc();
-  scope.counter(absl::StrCat(prefix, upstream_rq_, enumToInt(response_code))).inc();
+  incCounter(scope, {prefix, upstream_rq_completed_});
+  incCounter(scope, {prefix, upstreamRqGroup(response_code)});
+  absl::optional<Stats::StatNameTempStorage> rq_code_storage;
+  incCounter(scope, {prefix, upstreamRqCode(response_code, rq_code_storage)});
 }
 
 void CodeStatsImpl::chargeResponseStat(const ResponseStatInfo& info) const {
-  const uint64_t response_code = info.response_status_code_;
-  chargeBasicResponseStat(info.cluster_scope_, info.prefix_, static_cast<Code>(response_code));
+  const Code code = static_cast<Code>(info.response_status_code_);
+
+  // The prefix, virtual host, virtual cluster and zones arrive as strings, so they are encoded
+  // once here and joined to the predeclared tokens for each stat.
+  Stats::StatNameTempStorage prefix_storage(stripTrailingDot(info.prefix_), symbol_table_);
+  const Stats::StatName prefix = prefix_storage.statName();
+  chargeBasicResponseStat(info.cluster_scope_, prefix, code);
 
-  std::string group_string =
-      CodeUtility::groupStringForResponseCode(static_cast<Code>(response_code));
+  const Stats::StatName rq_group = upstreamRqGroup(code);
+  absl::optional<Stats::StatNameTempStorage> rq_code_storage;
+  const Stats::StatName rq_code = upstreamRqCode(code, rq_code_storage);
 
   // If the response is from a canary, also create canary stats.
   if (info.upstream_canary_) {
-    info.cluster_scope_.counter(absl::StrCat(info.prefix_, canary_upstream_rq_completed_)).inc();
-    info.cluster_scope_.counter(absl::StrCat(info.prefix_, canary_upstream_rq_, group_string))
-        .inc();
-    info.cluster_scope_.counter(absl::StrCat(info.prefix_, canary_upstream_rq_, response_code))
-        .inc();
+    incCounter(info.cluster_scope_, {prefix, canary_, upstream_rq_completed_});
+    incCounter(info.cluster_scope_, {prefix, canary_, rq_group});
+    incCounter(info.cluster_scope_, {prefix, canary_, rq_code});
   }
 
   // Split stats into external vs. internal.
   if (info.internal_request_) {
-    info.cluster_scope_.counter(absl::StrCat(info.prefix_, internal_upstream_rq_completed_)).inc();
-    info.cluster_scope_.counter(absl::StrCat(info.prefix_, internal_upstream_rq_, group_string))
-        .inc();
-    info.cluster_scope_.counter(absl::StrCat(info.prefix_, internal_upstream_rq_, response_code))
-        .inc();
+    incCounter(info.cluster_scope_, {prefix, internal_, upstream_rq_completed_});
+    incCounter(info.cluster_scope_, {prefix, internal_, rq_group});
+    incCounter(info.cluster_scope_, {prefix, internal_, rq_code});
   } else {
-    info.cluster_scope_.counter(absl::StrCat(info.prefix_, external_upstream_rq_completed_)).inc();
-    info.cluster_scope_.counter(absl::StrCat(info.prefix_, external_upstream_rq_, group_string))
-        .inc();
-    info.cluster_scope_.counter(absl::StrCat(info.prefix_, external_upstream_rq_, response_code))
-        .inc();
+    incCounter(info.cluster_scope_, {prefix, external_, upstream_rq_completed_});
+    incCounter(info.cluster_scope_, {prefix, external_, rq_group});
+    incCounter(info.cluster_scope_, {prefix, external_, rq_code});
   }
 
   // Handle request virtual cluster.
   if (!info.request_vcluster_name_.empty()) {
-    info.global_scope_
-        .counter(join({vhost_, info.request_vhost_name_, vcluster_, info.request_vcluster_name_,
-                       upstream_rq_completed_}))
-        .inc();
-    info.global_scope_
-        .counter(join({vhost_, info.request_vhost_name_, vcluster_, info.request_vcluster_name_,
-                       absl::StrCat(upstream_rq_, group_string)}))
-        .inc();
-    info.global_scope_
-        .counter(join({vhost_, info.request_vhost_name_, vcluster_, info.request_vcluster_name_,
-                       absl::StrCat(upstream_rq_, response_code)}))
-        .inc();
+    Stats::StatNameTempStorage vhost_name(info.request_vhost_name_, symbol_table_);
+    Stats::StatNameTempStorage vcluster_name(info.request_vcluster_name_, symbol_table_);
+    incCounter(info.global_scope_, {vhost_, vhost_name.statName(), vcluster_,
+                                    vcluster_name.statName(), upstream_rq_completed_});
+    incCounter(info.global_scope_,
+               {vhost_, vhost_name.statName(), vcluster_, vcluster_name.statName(), rq_group});
+    incCounter(info.global_scope_,
+               {vhost_, vhost_name.statName(), vcluster_, vcluster_name.statName(), rq_code});
   }
 
   // Handle per zone stats.
   if (!info.from_zone_.empty() && !info.to_zone_.empty()) {
-    absl::string_view prefix_without_trailing_dot = stripTrailingDot(info.prefix_);
-    info.cluster_scope_
-        .counter(join({prefix_without_trailing_dot, zone_, info.from_zone_, info.to_zone_,
-                       upstream_rq_completed_}))
-        .inc();
-    info.cluster_scope_
-        .counter(join({prefix_without_trailing_dot, zone_, info.from_zone_, info.to_zone_,
-                       absl::StrCat(upstream_rq_, group_string)}))
-        .inc();
-    info.cluster_scope_
-        .counter(join({prefix_without_trailing_dot, zone_, info.from_zone_, info.to_zone_,
-                       absl::StrCat(upstream_rq_, response_code)}))
-        .inc();
+    Stats::StatNameTempStorage from_zone(info.from_zone_, symbol_table_);
+    Stats::StatNameTempStorage to_zone(info.to_zone_, symbol_table_);
+    incCounter(info.cluster_scope_, {prefix, zone_, from_zone.statName(), to_zone.statName(),
+                                     upstream_rq_completed_});
+    incCounter(info.cluster_scope_,
+               {prefix, zone_, from_zone.statName(), to_zone.statName(), rq_group});
+    incCounter(info.cluster_scope_,
+               {prefix, zone_, from_zone.statName(), to_zone.statName(), rq_code});
   }
 }
 
 void CodeStatsImpl::chargeResponseTiming(const ResponseTimingInfo& info) const {
-  info.cluster_scope_.histogram(absl::StrCat(info.prefix_, upstream_rq_time_))
-      .recordValue(info.response_time_.count());
+  const uint64_t count = info.response_time_.count();
+  Stats::StatNameTempStorage prefix_storage(stripTrailingDot(info.prefix_), symbol_table_);
+  const Stats::StatName prefix = prefix_storage.statName();
+
+  recordHistogram(info.cluster_scope_, {prefix, upstream_rq_time_}, count);
   if (info.upstream_canary_) {
-    info.cluster_scope_.histogram(absl::StrCat(info.prefix_, canary_upstream_rq_time_))
-        .recordValue(info.response_time_.count());
+    recordHistogram(info.cluster_scope_, {prefix, canary_, upstream_rq_time_}, count);
   }
 
   if (info.internal_request_) {
-    info.cluster_scope_.histogram(absl::StrCat(info.prefix_, internal_upstream_rq_time_))
-        .recordValue(info.response_time_.count());
+    recordHistogram(info.cluster_scope_, {prefix, internal_, upstream_rq_time_}, count);
   } else {
-    info.cluster_scope_.histogram(absl::StrCat(info.prefix_, external_upstream_rq_time_))
-        .recordValue(info.response_time_.count());
+    recordHistogram(info.cluster_scope_, {prefix, external_, upstream_rq_time_}, count);
   }
 
   if (!info.request_vcluster_name_.empty()) {
-    info.global_scope_
-        .histogram(join({vhost_, info.request_vhost_name_, vcluster_, info.request_vcluster_name_,
-                         upstream_rq_time_}))
-        .recordValue(info.response_time_.count());
+    Stats::StatNameTempStorage vhost_name(info.request_vhost_name_, symbol_table_);
+    Stats::StatNameTempStorage vcluster_name(info.request_vcluster_name_, symbol_table_);
+    recordHistogram(info.global_scope_,
+                    {vhost_, vhost_name.statName(), vcluster_, vcluster_name.statName(),
+                     upstream_rq_time_},
+                    count);
   }
 
   // Handle per zone stats.
   if (!info.from_zone_.empty() && !info.to_zone_.empty()) {
-    info.cluster_scope_
-        .histogram(join({stripTrailingDot(info.prefix_), zone_, info.from_zone_, info.to_zone_,
-                         upstream_rq_time_}))
-        .recordValue(info.response_time_.count());
+    Stats::StatNameTempStorage from_zone(info.from_zone_, symbol_table_);
+    Stats::StatNameTempStorage to_zone(info.to_zone_, symbol_table_);
+    recordHistogram(info.cluster_scope_,
+                    {prefix, zone_, from_zone.statName(), to_zone.statName(), upstream_rq_time_},
+                    count);
   }
 }
 
-absl::string_view CodeStatsImpl::stripTrailingDot(absl::string_view str) {
-  if (absl::EndsWith(str, ".")) {
-    str.remove_suffix(1);
+Stats::StatName CodeStatsImpl::upstreamRqGroup(Code response_code) const {
+  switch (enumToInt(response_code) / 100) {
+  case 2:
+    return upstream_rq_2xx_;
+  case 3:
+    return upstream_rq_3xx_;
+  case 4:
+    return upstream_rq_4xx_;
+  case 5:
+    return upstream_rq_5xx_;
   }
-  return str;
+  return upstream_rq_unknown_;
 }
 
-std::string CodeStatsImpl::join(const std::vector<absl::string_view>& v) {
-  if (v.empty()) {
-    return "";
+Stats::StatName
+CodeStatsImpl::upstreamRqCode(Code response_code,
+                              absl::optional<Stats::StatNameTempStorage>& storage) const {
+  const uint64_t code = enumToInt(response_code);
+  if (code >= HttpCodeOffset && code < HttpCodeOffset + NumHttpCodes) {
+    return upstream_rq_codes_[code - HttpCodeOffset];
   }
-  auto iter = v.begin();
-  if (iter->empty()) {
-    ++iter; // Skip any initial empty prefix.
+  storage.emplace(absl::StrCat("upstream_rq_", code), symbol_table_);
+  return storage->statName();
+}
+
+absl::string_view CodeStatsImpl::stripTrailingDot(absl::string_view str) {
+  if (absl::EndsWith(str, ".")) {
+    str.remove_suffix(1);
   }
-  return absl::StrJoin(iter, v.end(), ".");
+  return str;
 }
 
 std::string CodeUtility::groupStringForResponseCode(Code response_code) {
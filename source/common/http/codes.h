@@ -3,17 +3,27 @@
 #include <chrono>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/http/codes.h"
 #include "envoy/http/header_map.h"
 #include "envoy/stats/scope.h"
 
+#include "common/stats/symbol_table_impl.h"
+
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Http {
 
 class CodeStatsImpl : public CodeStats {
 public:
-  ~CodeStatsImpl() override = default;
+  /**
+   * @param symbol_table the symbol table of the stores the stats are charged to, against which
+   *     the fixed tokens of the stat names are encoded once, up front.
+   */
+  explicit CodeStatsImpl(Stats::SymbolTable& symbol_table);
+  ~CodeStatsImpl() override;
 
   // CodeStats
   void chargeBasicResponseStat(Stats::Scope& scope, const std::string& prefix,
@@ -36,34 +46,55 @@ private:
   static absl::string_view stripTrailingDot(absl::string_view prefix);
 
   /**
-   * Joins a string-view vector with "." between each token. If there's an
-   * initial blank token it is skipped. Leading blank tokens occur due to empty
-   * prefixes, which are fairly common.
-   *
-   * Note: this layer probably should be called something other than join(),
-   * like joinSkippingLeadingEmptyToken but I thought the decrease in
-   * readability at all the call-sites would not be worth it.
+   * Joins the names with "." between each one, skipping empty names, and increments the
+   * resulting counter or records a value in the resulting histogram of the scope.
    */
-  static std::string join(const std::vector<absl::string_view>& v);
+  void incCounter(Stats::Scope& scope, const Stats::StatNameVec& names) const;
+  void recordHistogram(Stats::Scope& scope, const Stats::StatNameVec& names, uint64_t value) const;
+
+  void chargeBasicResponseStat(Stats::Scope& scope, Stats::StatName prefix,
+                               Code response_code) const;
+
+  Stats::StatName makeStatName(absl::string_view name);
+
+  /**
+   * @return the "upstream_rq_<group>" token for the response code, e.g. "upstream_rq_2xx".
+   */
+  Stats::StatName upstreamRqGroup(Code response_code) const;
+
+  /**
+   * @return the "upstream_rq_<code>" token for the response code. The token of a code outside of
+   *     the predeclared range is encoded into storage.
+   */
+  Stats::StatName upstreamRqCode(Code response_code,
+                                 absl::optional<Stats::StatNameTempStorage>& storage) const;
+
+  static constexpr uint32_t NumHttpCodes = 500;
+  static constexpr uint32_t HttpCodeOffset = 100; // code 100 is at index 0.
+
+  Stats::SymbolTable& symbol_table_;
+
+  // Owns the storage of all the predeclared tokens below.
+  std::vector<Stats::StatNameStorage> storage_;
 
   // Predeclared tokens used for combining with join().
-  const absl::string_view canary_upstream_rq_completed_{"canary.upstream_rq_completed"};
-  const absl::string_view canary_upstream_rq_time_{"canary.upstream_rq_time"};
-  const absl::string_view canary_upstream_rq_{"canary.upstream_rq_"};
-  const absl::string_view external_rq_time_{"external.upstream_rq_time"};
-  const absl::string_view external_upstream_rq_completed_{"external.upstream_rq_completed"};
-  const absl::string_view external_upstream_rq_time_{"external.upstream_rq_time"};
-  const absl::string_view external_upstream_rq_{"external.upstream_rq_"};
-  const absl::string_view internal_rq_time_{"internal.upstream_rq_time"};
-  const absl::string_view internal_upstream_rq_completed_{"internal.upstream_rq_completed"};
-  const absl::string_view internal_upstream_rq_time_{"internal.upstream_rq_time"};
-  const absl::string_view internal_upstream_rq_{"internal.upstream_rq_"};
-  const absl::string_view upstream_rq_completed_{"upstream_rq_completed"};
-  const absl::string_view upstream_rq_time_{"upstream_rq_time"};
-  const absl::string_view upstream_rq_{"upstream_rq_"};
-  const absl::string_view vcluster_{"vcluster"};
-  const absl::string_view vhost_{"vhost"};
-  const absl::string_view zone_{"zone"};
+  const Stats::StatName canary_;
+  const Stats::StatName external_;
+  const Stats::StatName internal_;
+  const Stats::StatName upstream_rq_2xx_;
+  const Stats::StatName upstream_rq_3xx_;
+  const Stats::StatName upstream_rq_4xx_;
+  const Stats::StatName upstream_rq_5xx_;
+  const Stats::StatName upstream_rq_unknown_;
+  const Stats::StatName upstream_rq_completed_;
+  const Stats::StatName upstream_rq_time_;
+  const Stats::StatName vcluster_;
+  const Stats::StatName vhost_;
+  const Stats::StatName zone_;
+
+  // The "upstream_rq_<code>" token of each response code from 100 to 599. Other codes are
+  // encoded when they are charged.
+  Stats::StatName upstream_rq_codes_[NumHttpCodes];
 };
 
 /**
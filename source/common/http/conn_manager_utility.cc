@@ -13,7 +13,9 @@
 #include "common/http/path_utility.h"
 #include "common/http/utility.h"
 #include "common/network/utility.h"
+#include "common/runtime/key_registry.h"
 #include "common/runtime/uuid_util.h"
+#include "common/singleton/const_singleton.h"
 #include "common/tracing/http_tracer_impl.h"
 
 #include "absl/strings/str_join.h"
@@ -21,6 +23,22 @@
 namespace Envoy {
 namespace Http {
 
+namespace {
+
+// Runtime keys that are looked up for every traced request.
+struct TracingRuntimeKeyValues {
+  const Runtime::Key ClientEnabled{
+      Runtime::KeyRegistrySingleton::get().resolve("tracing.client_enabled")};
+  const Runtime::Key RandomSampling{
+      Runtime::KeyRegistrySingleton::get().resolve("tracing.random_sampling")};
+  const Runtime::Key GlobalEnabled{
+      Runtime::KeyRegistrySingleton::get().resolve("tracing.global_enabled")};
+};
+
+using TracingRuntimeKeys = ConstSingleton<TracingRuntimeKeyValues>;
+
+} // namespace
+
 std::string ConnectionManagerUtility::determineNextProtocol(Network::Connection& connection,
                                                             const Buffer::Instance& data) {
   if (!connection.nextProtocol().empty()) {
@@ -234,19 +252,19 @@ void ConnectionManagerUtility::mutateTracingRequestHeader(HeaderMap& request_hea
   // Do not apply tracing transformations if we are currently tracing.
   if (UuidTraceStatus::NoTrace == UuidUtils::isTraceableUuid(x_request_id)) {
     if (request_headers.ClientTraceId() &&
-        runtime.snapshot().featureEnabled("tracing.client_enabled",
+        runtime.snapshot().featureEnabled(TracingRuntimeKeys::get().ClientEnabled,
                                           config.tracingConfig()->client_sampling_)) {
       UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::Client);
     } else if (request_headers.EnvoyForceTrace()) {
       UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::Forced);
-    } else if (runtime.snapshot().featureEnabled("tracing.random_sampling",
+    } else if (runtime.snapshot().featureEnabled(TracingRuntimeKeys::get().RandomSampling,
                                                  config.tracingConfig()->random_sampling_, result,
                                                  10000)) {
       UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::Sampled);
     }
   }
 
-  if (!runtime.snapshot().featureEnabled("tracing.global_enabled",
+  if (!runtime.snapshot().featureEnabled(TracingRuntimeKeys::get().GlobalEnabled,
                                          config.tracingConfig()->overall_sampling_, result)) {
     UuidUtils::setTraceableUuid(x_request_id, UuidTraceStatus::NoTrace);
   }
@@ -3,7 +3,8 @@
 namespace Envoy {
 namespace Http {
 
-ContextImpl::ContextImpl() : tracer_(&null_tracer_) {}
+ContextImpl::ContextImpl(Stats::SymbolTable& symbol_table)
+    : tracer_(&null_tracer_), code_stats_(symbol_table) {}
 
 } // namespace Http
 } // namespace Envoy
@@ -1,5 +1,6 @@
 #include "common/http/header_utility.h"
 
+#include "common/common/regex.h"
 #include "common/common/utility.h"
 #include "common/config/rds_json.h"
 #include "common/http/header_map_impl.h"
@@ -11,12 +12,13 @@ namespace Envoy {
 namespace Http {
 
 // HeaderMatcher will consist of:
-//   header_match_specifier which can be any one of exact_match, regex_match, range_match,
-//   present_match, prefix_match or suffix_match.
+//   header_match_specifier which can be any one of exact_match, regex_match, safe_regex_match,
+//   range_match, present_match, prefix_match or suffix_match.
 //   Each of these also can be inverted with the invert_match option.
 //   Absence of these options implies empty header value match based on header presence.
 //   a.exact_match: value will be used for exact string matching.
 //   b.regex_match: Match will succeed if header value matches the value specified here.
+//   b.safe_regex_match: Match will succeed if header value matches the regex specified here.
 //   c.range_match: Match will succeed if header value lies within the range specified
 //     here, using half open interval semantics [start,end).
 //   d.present_match: Match will succeed if the header is present.
@@ -31,7 +33,11 @@ HeaderUtility::HeaderData::HeaderData(const envoy::api::v2::route::HeaderMatcher
     break;
   case envoy::api::v2::route::HeaderMatcher::kRegexMatch:
     header_match_type_ = HeaderMatchType::Regex;
-    regex_pattern_ = RegexUtil::parseRegex(config.regex_match());
+    regex_ = Regex::Utility::parseStdRegexAsCompiledMatcher(config.regex_match());
+    break;
+  case envoy::api::v2::route::HeaderMatcher::kSafeRegexMatch:
+    header_match_type_ = HeaderMatchType::Regex;
+    regex_ = Regex::Utility::parseRegex(config.safe_regex_match());
     break;
   case envoy::api::v2::route::HeaderMatcher::kRangeMatch:
     header_match_type_ = HeaderMatchType::Range;
@@ -93,7 +99,7 @@ bool HeaderUtility::matchHeaders(const Http::HeaderMap& request_headers,
     match = header_data.value_.empty() || header_view == header_data.value_;
     break;
   case HeaderMatchType::Regex:
-    match = std::regex_match(header_view.begin(), header_view.end(), header_data.regex_pattern_);
+    match = header_data.regex_->match(header_view);
     break;
   case HeaderMatchType::Range: {
     int64_t header_value = 0;
@@ -0,0 +1,216 @@
+#include "common/json/json_document.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+// Do not let RapidJson leak outside of this file.
+#include "rapidjson/document.h"
+#include "rapidjson/error/en.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace Envoy {
+namespace Json {
+
+namespace {
+
+const char* typeAsString(Value::Type type) {
+  switch (type) {
+  case Value::Type::Array:
+    return "Array";
+  case Value::Type::Boolean:
+    return "Boolean";
+  case Value::Type::Double:
+    return "Double";
+  case Value::Type::Integer:
+    return "Integer";
+  case Value::Type::Null:
+    return "Null";
+  case Value::Type::Object:
+    return "Object";
+  case Value::Type::String:
+    return "String";
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+const rapidjson::Value& asRapidJson(const void* value) {
+  return *static_cast<const rapidjson::Value*>(value);
+}
+
+absl::string_view stringView(const rapidjson::Value& value) {
+  return {value.GetString(), value.GetStringLength()};
+}
+
+// The first chunk of a document's arena is sized after its text, which the DOM of the text is
+// rarely much larger than, rather than rapidjson's 64KiB default that would dwarf small bodies.
+constexpr size_t MinChunkCapacity = 1024;
+
+} // namespace
+
+Value::Type Value::type() const {
+  const rapidjson::Value& value = asRapidJson(value_);
+  switch (value.GetType()) {
+  case rapidjson::kNullType:
+    return Type::Null;
+  case rapidjson::kFalseType:
+  case rapidjson::kTrueType:
+    return Type::Boolean;
+  case rapidjson::kObjectType:
+    return Type::Object;
+  case rapidjson::kArrayType:
+    return Type::Array;
+  case rapidjson::kStringType:
+    return Type::String;
+  case rapidjson::kNumberType:
+    return value.IsDouble() ? Type::Double : Type::Integer;
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void Value::checkType(Type type) const {
+  const Type actual_type = this->type();
+  if (actual_type != type) {
+    throw Exception(
+        fmt::format("JSON value accessed with type '{}' does not match actual type '{}'.",
+                    typeAsString(type), typeAsString(actual_type)));
+  }
+}
+
+bool Value::asBoolean() const {
+  checkType(Type::Boolean);
+  return asRapidJson(value_).GetBool();
+}
+
+int64_t Value::asInteger() const {
+  checkType(Type::Integer);
+  const rapidjson::Value& value = asRapidJson(value_);
+  if (!value.IsInt64()) {
+    throw Exception(
+        fmt::format("JSON value {} is larger than int64_t (not supported)", value.GetUint64()));
+  }
+  return value.GetInt64();
+}
+
+double Value::asDouble() const {
+  checkType(Type::Double);
+  return asRapidJson(value_).GetDouble();
+}
+
+absl::string_view Value::asString() const {
+  checkType(Type::String);
+  return stringView(asRapidJson(value_));
+}
+
+size_t Value::size() const {
+  const rapidjson::Value& value = asRapidJson(value_);
+  if (value.IsArray()) {
+    return value.Size();
+  } else if (value.IsObject()) {
+    return value.MemberCount();
+  }
+  throw Exception("Json does not support size() on types other than array and object");
+}
+
+Value Value::at(size_t index) const {
+  checkType(Type::Array);
+  const rapidjson::Value& value = asRapidJson(value_);
+  if (index >= value.Size()) {
+    throw Exception(fmt::format("JSON array index {} out of range (size {})", index, value.Size()));
+  }
+  return Value(&value[index]);
+}
+
+absl::optional<Value> Value::find(absl::string_view name) const {
+  checkType(Type::Object);
+  const rapidjson::Value& value = asRapidJson(value_);
+  for (auto it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+    if (stringView(it->name) == name) {
+      return Value(&it->value);
+    }
+  }
+  return absl::nullopt;
+}
+
+Value Value::get(absl::string_view name) const {
+  const absl::optional<Value> member = find(name);
+  if (!member.has_value()) {
+    throw Exception(fmt::format("key '{}' missing", name));
+  }
+  return member.value();
+}
+
+bool Value::getBoolean(absl::string_view name, bool default_value) const {
+  const absl::optional<Value> member = find(name);
+  return member.has_value() ? member->asBoolean() : default_value;
+}
+
+int64_t Value::getInteger(absl::string_view name, int64_t default_value) const {
+  const absl::optional<Value> member = find(name);
+  return member.has_value() ? member->asInteger() : default_value;
+}
+
+double Value::getDouble(absl::string_view name, double default_value) const {
+  const absl::optional<Value> member = find(name);
+  return member.has_value() ? member->asDouble() : default_value;
+}
+
+absl::string_view Value::getString(absl::string_view name,
+                                   absl::string_view default_value) const {
+  const absl::optional<Value> member = find(name);
+  return member.has_value() ? member->asString() : default_value;
+}
+
+void Value::iterate(const std::function<bool(absl::string_view, const Value&)>& callback) const {
+  checkType(Type::Object);
+  const rapidjson::Value& value = asRapidJson(value_);
+  for (auto it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+    if (!callback(stringView(it->name), Value(&it->value))) {
+      break;
+    }
+  }
+}
+
+std::string Value::asJsonString() const {
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  asRapidJson(value_).Accept(writer);
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+struct Document::Impl {
+  explicit Impl(std::string&& json)
+      : json_(std::move(json)), allocator_(std::max(json_.size(), MinChunkCapacity)),
+        document_(&allocator_) {}
+
+  // The text must outlive the DOM, whose strings point into it.
+  std::string json_;
+  rapidjson::MemoryPoolAllocator<> allocator_;
+  rapidjson::Document document_;
+};
+
+Document::Document(std::string json) : impl_(std::make_unique<Impl>(std::move(json))) {
+  // Strings are decoded in place, so the DOM needs no copies of them. std::string keeps its
+  // contents null terminated, as rapidjson requires.
+  rapidjson::Document& document = impl_->document_;
+  document.ParseInsitu(&impl_->json_[0]);
+  if (document.HasParseError()) {
+    const std::string& json = impl_->json_;
+    const size_t offset = std::min(document.GetErrorOffset(), json.size());
+    throw Exception(fmt::format("JSON supplied is not valid. Error(offset {}, line {}): {}\n",
+                                document.GetErrorOffset(),
+                                1 + std::count(json.begin(), json.begin() + offset, '\n'),
+                                GetParseError_En(document.GetParseError())));
+  }
+}
+
+Document::~Document() = default;
+
+Value Document::root() const {
+  return Value(static_cast<const rapidjson::Value*>(&impl_->document_));
+}
+
+} // namespace Json
+} // namespace Envoy
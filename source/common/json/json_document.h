@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "envoy/json/json_object.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Json {
+
+/**
+ * A read-only view of a value in a Document. Views are cheap to copy and only valid while their
+ * Document is alive. Accessors throw Json::Exception when the value does not have the type asked
+ * for, like those of Json::Object.
+ */
+class Value {
+public:
+  enum class Type {
+    Array,
+    Boolean,
+    Double,
+    Integer,
+    Null,
+    Object,
+    String,
+  };
+
+  /**
+   * @return Type the type of the value. Numbers with a fraction or an exponent are doubles, and
+   *         others are integers.
+   */
+  Type type() const;
+  bool isNull() const { return type() == Type::Null; }
+  bool isObject() const { return type() == Type::Object; }
+  bool isArray() const { return type() == Type::Array; }
+
+  bool asBoolean() const;
+  int64_t asInteger() const;
+  double asDouble() const;
+
+  /**
+   * @return absl::string_view the value of a string. It points into the Document, so no copy is
+   *         made.
+   */
+  absl::string_view asString() const;
+
+  /**
+   * @return size_t the number of elements of an array or members of an object.
+   */
+  size_t size() const;
+  bool empty() const { return size() == 0; }
+
+  /**
+   * @param index supplies the index of an element of an array.
+   * @return Value the element.
+   */
+  Value at(size_t index) const;
+
+  /**
+   * Look up a member of an object. This is a linear search, which is faster than hashing for the
+   * small objects JSON is mostly made of. If a name is repeated, the first member is found.
+   * @param name supplies the member name.
+   * @return absl::optional<Value> the member, or absl::nullopt if the object has no such member.
+   */
+  absl::optional<Value> find(absl::string_view name) const;
+
+  /**
+   * @param name supplies the member name.
+   * @return Value the member of an object, which must exist.
+   */
+  Value get(absl::string_view name) const;
+
+  bool hasMember(absl::string_view name) const { return find(name).has_value(); }
+
+  /**
+   * Typed accessors for members of an object, which throw if the member is missing or has
+   * another type, or return the default value if it is missing.
+   */
+  bool getBoolean(absl::string_view name) const { return get(name).asBoolean(); }
+  bool getBoolean(absl::string_view name, bool default_value) const;
+  int64_t getInteger(absl::string_view name) const { return get(name).asInteger(); }
+  int64_t getInteger(absl::string_view name, int64_t default_value) const;
+  double getDouble(absl::string_view name) const { return get(name).asDouble(); }
+  double getDouble(absl::string_view name, double default_value) const;
+  absl::string_view getString(absl::string_view name) const { return get(name).asString(); }
+  absl::string_view getString(absl::string_view name, absl::string_view default_value) const;
+
+  /**
+   * Iterate over the members of an object in document order.
+   * @param callback supplies the callback to invoke with each member. Iteration stops when it
+   *        returns false.
+   */
+  void iterate(const std::function<bool(absl::string_view, const Value&)>& callback) const;
+
+  /**
+   * @return std::string the JSON text of the value.
+   */
+  std::string asJsonString() const;
+
+private:
+  friend class Document;
+
+  explicit Value(const void* value) : value_(value) {}
+
+  void checkType(Type type) const;
+
+  // The underlying parser's value, which is kept out of this header.
+  const void* value_;
+};
+
+/**
+ * A JSON document parsed into a DOM that is allocated from an arena owned by the document, and
+ * whose strings point into the document's copy of the JSON text. Unlike Json::Factory, this does
+ * not build a tree of reference counted Objects, and it is meant for hot paths that only read a
+ * few values, such as filters parsing bodies. YAML and schema validation are not supported.
+ */
+class Document {
+public:
+  /**
+   * Parse JSON text. The text is moved into the document and strings are decoded in place, so
+   * pass an rvalue to avoid a copy.
+   * @param json supplies the JSON text.
+   * @throw Json::Exception if the text is not valid JSON.
+   */
+  explicit Document(std::string json);
+  ~Document();
+
+  /**
+   * @return Value the root value, which lives as long as the document.
+   */
+  Value root() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+typedef std::unique_ptr<Document> DocumentPtr;
+
+} // namespace Json
+} // namespace Envoy
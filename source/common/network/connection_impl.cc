@@ -603,6 +603,33 @@ void ConnectionImpl::setConnectionStats(const ConnectionStats& stats) {
   connection_stats_ = std::make_unique<ConnectionStats>(stats);
 }
 
+IoHandle* ConnectionImpl::spliceIoHandle() {
+  if (state() != State::Open || connecting_ || !transport_socket_->passesThrough() ||
+      !filter_manager_.hasSingleReadFilter() || read_buffer_.length() > 0 ||
+      write_buffer_->length() > 0 || read_end_stream_ || write_end_stream_) {
+    return nullptr;
+  }
+  return &ioHandle();
+}
+
+void ConnectionImpl::onSpliced(uint64_t bytes_read, uint64_t bytes_written) {
+  if (connection_stats_) {
+    connection_stats_->read_total_.add(bytes_read);
+    connection_stats_->write_total_.add(bytes_written);
+  }
+
+  if (bytes_written > 0) {
+    for (BytesSentCb& cb : bytes_sent_callbacks_) {
+      cb(bytes_written);
+
+      // If a callback closes the socket, stop iterating.
+      if (!ioHandle().isOpen()) {
+        return;
+      }
+    }
+  }
+}
+
 void ConnectionImpl::updateReadBufferStats(uint64_t num_read, uint64_t new_size) {
   if (!connection_stats_) {
     return;
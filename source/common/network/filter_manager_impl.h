@@ -45,6 +45,15 @@ public:
   void addFilter(FilterSharedPtr filter);
   void addReadFilter(ReadFilterSharedPtr filter);
   bool initializeReadFilters();
+
+  /**
+   * @return bool whether there is at most one read filter and no write filter, so that all the
+   *         bytes of the connection are seen by that filter alone.
+   */
+  bool hasSingleReadFilter() const {
+    return upstream_filters_.size() <= 1 && downstream_filters_.empty();
+  }
+
   void onRead();
   FilterStatus onWrite();
 
@@ -21,6 +21,7 @@ public:
   IoResult doRead(Buffer::Instance& buffer) override;
   IoResult doWrite(Buffer::Instance& buffer, bool end_stream) override;
   const Ssl::ConnectionInfo* ssl() const override { return nullptr; }
+  bool passesThrough() const override { return true; }
 
 private:
   TransportSocketCallbacks* callbacks_{};
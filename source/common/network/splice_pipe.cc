@@ -0,0 +1,106 @@
+#include "common/network/splice_pipe.h"
+
+#include <cerrno>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+
+#if defined(__linux__)
+// The most bytes requested from a single read. The pipe capacity, 64KiB by default, caps what is
+// actually moved.
+constexpr size_t MaxSpliceBytes = 1024 * 1024;
+constexpr unsigned int SpliceFlags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+#endif
+
+} // namespace
+
+SplicePipePtr SplicePipe::create() {
+#if defined(__linux__)
+  int fds[2];
+  const Api::SysCallIntResult result =
+      Api::LinuxOsSysCallsSingleton::get().pipe2(fds, O_NONBLOCK | O_CLOEXEC);
+  if (result.rc_ != 0) {
+    return nullptr;
+  }
+  return SplicePipePtr{new SplicePipe(fds[0], fds[1])};
+#else
+  return nullptr;
+#endif
+}
+
+SplicePipe::~SplicePipe() {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  os_sys_calls.close(read_fd_);
+  os_sys_calls.close(write_fd_);
+}
+
+SplicePipe::TransferResult SplicePipe::transfer(IoHandle& source, IoHandle& destination,
+                                                uint64_t read_limit) {
+  TransferResult result{};
+#if defined(__linux__)
+  Api::LinuxOsSysCalls& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  while (true) {
+    // The pipe is emptied before reading again, so that a read which would block means that the
+    // source has no more bytes rather than that the pipe is full.
+    while (buffered_bytes_ > 0) {
+      const Api::SysCallSizeResult written = os_sys_calls.splice(
+          read_fd_, nullptr, destination.fd(), nullptr, buffered_bytes_, SpliceFlags);
+      if (written.rc_ < 0) {
+        if (written.errno_ == EAGAIN) {
+          result.write_blocked_ = true;
+        } else {
+          result.errno_ = written.errno_;
+        }
+        return result;
+      }
+      ASSERT(written.rc_ > 0);
+      buffered_bytes_ -= written.rc_;
+      result.bytes_written_ += written.rc_;
+    }
+
+    if (end_stream_read_) {
+      return result;
+    }
+    if (read_limit > 0 && result.bytes_read_ >= read_limit) {
+      result.read_limit_reached_ = true;
+      return result;
+    }
+
+    const Api::SysCallSizeResult read =
+        os_sys_calls.splice(source.fd(), nullptr, write_fd_, nullptr, MaxSpliceBytes, SpliceFlags);
+    if (read.rc_ < 0) {
+      if (read.errno_ != EAGAIN) {
+        result.errno_ = read.errno_;
+      }
+      return result;
+    }
+    if (read.rc_ == 0) {
+      end_stream_read_ = true;
+      return result;
+    }
+    buffered_bytes_ += read.rc_;
+    result.bytes_read_ += read.rc_;
+  }
+#else
+  UNREFERENCED_PARAMETER(source);
+  UNREFERENCED_PARAMETER(destination);
+  UNREFERENCED_PARAMETER(read_limit);
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+#endif
+  return result;
+}
+
+} // namespace Network
+} // namespace Envoy
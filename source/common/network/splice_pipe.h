@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/network/io_handle.h"
+
+namespace Envoy {
+namespace Network {
+
+class SplicePipe;
+typedef std::unique_ptr<SplicePipe> SplicePipePtr;
+
+/**
+ * Moves bytes from one socket to another within the kernel with splice(2), through a pipe, so
+ * that they are never copied to user space. The pipe holds the bytes that were read but could not
+ * be written yet. No more bytes are read until it is empty, so its capacity bounds what is
+ * buffered for a destination that is not writable, and the source is left unread in the meantime.
+ */
+class SplicePipe {
+public:
+  /**
+   * @return SplicePipePtr a new pipe, or nullptr if splicing is not supported on this platform or
+   *         the pipe could not be created.
+   */
+  static SplicePipePtr create();
+
+  ~SplicePipe();
+
+  struct TransferResult {
+    // The number of bytes read from the source.
+    uint64_t bytes_read_;
+    // The number of bytes written to the destination.
+    uint64_t bytes_written_;
+    // Whether bytes are left in the pipe because the destination is not writable.
+    bool write_blocked_;
+    // Whether reading stopped because the read limit was reached, while the source may have more.
+    bool read_limit_reached_;
+    // The errno of a failed read or write, or 0.
+    int errno_;
+  };
+
+  /**
+   * Move bytes from the source to the destination until the source has no more, the destination
+   * is not writable or an error occurs. Both sockets must be non-blocking.
+   * @param source supplies the socket to read from.
+   * @param destination supplies the socket to write to.
+   * @param read_limit supplies the number of bytes after which to stop reading so that other
+   *        connections get a chance to run, or 0 for no limit.
+   * @return TransferResult the outcome of the transfer.
+   */
+  TransferResult transfer(IoHandle& source, IoHandle& destination, uint64_t read_limit);
+
+  /**
+   * @return uint64_t the number of bytes held in the pipe.
+   */
+  uint64_t bufferedBytes() const { return buffered_bytes_; }
+
+  /**
+   * @return bool whether the end of stream has been read from the source.
+   */
+  bool endStreamRead() const { return end_stream_read_; }
+
+private:
+  SplicePipe(int read_fd, int write_fd) : read_fd_(read_fd), write_fd_(write_fd) {}
+
+  const int read_fd_;
+  const int write_fd_;
+  uint64_t buffered_bytes_{};
+  bool end_stream_read_{};
+};
+
+} // namespace Network
+} // namespace Envoy
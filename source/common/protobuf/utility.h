@@ -169,9 +169,13 @@ public:
 
   typedef ConstSingleton<FileExtensionValues> FileExtensions;
 
-  static std::size_t hash(const Protobuf::Message& message) {
-    // Use Protobuf::io::CodedOutputStream to force deterministic serialization, so that the same
-    // message doesn't hash to different values.
+  /**
+   * Serialize a message deterministically, so that equal messages serialize to the same bytes.
+   * @param message supplies the message to serialize.
+   * @return std::string the serialized message.
+   */
+  static std::string deterministicSerialize(const Protobuf::Message& message) {
+    // Use Protobuf::io::CodedOutputStream to force deterministic serialization.
     ProtobufTypes::String text;
     {
       // For memory safety, the StringOutputStream needs to be destroyed before
@@ -181,7 +185,12 @@ public:
       coded_stream.SetSerializationDeterministic(true);
       message.SerializeToCodedStream(&coded_stream);
     }
-    return HashUtil::xxHash64(text);
+    return text;
+  }
+
+  static std::size_t hash(const Protobuf::Message& message) {
+    // Serialize deterministically, so that the same message doesn't hash to different values.
+    return HashUtil::xxHash64(deterministicSerialize(message));
   }
 
   static ProtoUnknownFieldsMode proto_unknown_fields;
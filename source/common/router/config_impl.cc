@@ -5,7 +5,6 @@
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <regex>
 #include <string>
 #include <vector>
 
@@ -20,6 +19,7 @@
 #include "common/common/fmt.h"
 #include "common/common/hash.h"
 #include "common/common/logger.h"
+#include "common/common/regex.h"
 #include "common/common/utility.h"
 #include "common/config/metadata.h"
 #include "common/config/rds_json.h"
@@ -51,6 +51,27 @@ convertInternalRedirectAction(const envoy::api::v2::route::RouteAction& route) {
   }
 }
 
+template <class ProtoType> bool hasPerFilterConfig(const ProtoType& config) {
+  return !config.per_filter_config().empty() || !config.typed_per_filter_config().empty();
+}
+
+bool hasPerFilterConfigs(const envoy::api::v2::route::VirtualHost& virtual_host) {
+  if (hasPerFilterConfig(virtual_host)) {
+    return true;
+  }
+  for (const auto& route : virtual_host.routes()) {
+    if (hasPerFilterConfig(route)) {
+      return true;
+    }
+    for (const auto& cluster : route.route().weighted_clusters().clusters()) {
+      if (hasPerFilterConfig(cluster)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 } // namespace
 
 std::string SslRedirector::newPath(const Http::HeaderMap& headers) const {
@@ -149,7 +170,10 @@ CorsPolicyImpl::CorsPolicyImpl(const envoy::api::v2::route::CorsPolicy& config,
     allow_origin_.push_back(origin);
   }
   for (const auto& regex : config.allow_origin_regex()) {
-    allow_origin_regex_.push_back(RegexUtil::parseRegex(regex));
+    allow_origin_regex_.push_back(Regex::Utility::parseStdRegexAsCompiledMatcher(regex));
+  }
+  for (const auto& regex : config.allow_origin_safe_regex()) {
+    allow_origin_regex_.push_back(Regex::Utility::parseRegex(regex));
   }
   allow_methods_ = config.allow_methods();
   allow_headers_ = config.allow_headers();
@@ -159,9 +183,21 @@ CorsPolicyImpl::CorsPolicyImpl(const envoy::api::v2::route::CorsPolicy& config,
     allow_credentials_ = PROTOBUF_GET_WRAPPED_REQUIRED(config, allow_credentials);
   }
   legacy_enabled_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, enabled, true);
+  if (config.has_filter_enabled()) {
+    filter_enabled_runtime_key_ =
+        Runtime::KeyRegistrySingleton::get().resolve(config.filter_enabled().runtime_key());
+  }
+  if (config.has_shadow_enabled()) {
+    shadow_enabled_runtime_key_ =
+        Runtime::KeyRegistrySingleton::get().resolve(config.shadow_enabled().runtime_key());
+  }
 }
 
-ShadowPolicyImpl::ShadowPolicyImpl(const envoy::api::v2::route::RouteAction& config) {
+ShadowPolicyImpl::ShadowPolicyImpl(const envoy::api::v2::route::RouteAction& config)
+    : runtime_key_(Runtime::KeyRegistrySingleton::get().resolve(
+          config.request_mirror_policy().has_runtime_fraction()
+              ? config.request_mirror_policy().runtime_fraction().runtime_key()
+              : config.request_mirror_policy().runtime_key())) {
   if (!config.has_request_mirror_policy()) {
     return;
   }
@@ -169,10 +205,8 @@ ShadowPolicyImpl::ShadowPolicyImpl(const envoy::api::v2::route::RouteAction& con
   cluster_ = config.request_mirror_policy().cluster();
 
   if (config.request_mirror_policy().has_runtime_fraction()) {
-    runtime_key_ = config.request_mirror_policy().runtime_fraction().runtime_key();
     default_value_ = config.request_mirror_policy().runtime_fraction().default_value();
   } else {
-    runtime_key_ = config.request_mirror_policy().runtime_key();
     default_value_.set_numerator(0);
   }
 }
@@ -497,11 +531,10 @@ void RouteEntryImplBase::finalizeResponseHeaders(Http::HeaderMap& headers,
 absl::optional<RouteEntryImplBase::RuntimeData>
 RouteEntryImplBase::loadRuntimeData(const envoy::api::v2::route::RouteMatch& route_match) {
   absl::optional<RuntimeData> runtime;
-  RuntimeData runtime_data;
 
   if (route_match.has_runtime_fraction()) {
+    RuntimeData runtime_data(route_match.runtime_fraction().runtime_key());
     runtime_data.fractional_runtime_default_ = route_match.runtime_fraction().default_value();
-    runtime_data.fractional_runtime_key_ = route_match.runtime_fraction().runtime_key();
     return runtime_data;
   }
 
@@ -738,6 +771,10 @@ void RouteEntryImplBase::validateClusters(Upstream::ClusterManager& cm) const {
   }
 }
 
+std::vector<RouteConstSharedPtr> RouteEntryImplBase::weightedClusters() const {
+  return {weighted_clusters_.begin(), weighted_clusters_.end()};
+}
+
 const RouteSpecificFilterConfig*
 RouteEntryImplBase::perFilterConfig(const std::string& name) const {
   return per_filter_configs_.get(name);
@@ -747,7 +784,8 @@ RouteEntryImplBase::WeightedClusterEntry::WeightedClusterEntry(
     const RouteEntryImplBase* parent, const std::string runtime_key,
     Server::Configuration::FactoryContext& factory_context,
     const envoy::api::v2::route::WeightedCluster_ClusterWeight& cluster)
-    : DynamicRouteEntry(parent, cluster.name()), runtime_key_(runtime_key),
+    : DynamicRouteEntry(parent, cluster.name()),
+      runtime_key_(Runtime::KeyRegistrySingleton::get().resolve(runtime_key)),
       loader_(factory_context.runtime()),
       cluster_weight_(PROTOBUF_GET_WRAPPED_REQUIRED(cluster, weight)),
       request_headers_parser_(HeaderParser::configure(cluster.request_headers_to_add(),
@@ -841,7 +879,12 @@ RegexRouteEntryImpl::RegexRouteEntryImpl(const VirtualHostImpl& vhost,
                                          const envoy::api::v2::route::Route& route,
                                          Server::Configuration::FactoryContext& factory_context)
     : RouteEntryImplBase(vhost, route, factory_context),
-      regex_(RegexUtil::parseRegex(route.match().regex())), regex_str_(route.match().regex()) {}
+      regex_(route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex
+                 ? Regex::Utility::parseStdRegexAsCompiledMatcher(route.match().regex())
+                 : Regex::Utility::parseRegex(route.match().safe_regex())),
+      regex_str_(route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex
+                     ? route.match().regex()
+                     : route.match().safe_regex().regex()) {}
 
 void RegexRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
                                             bool insert_envoy_original_path) const {
@@ -851,9 +894,9 @@ void RegexRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
   // TODO(yuval-k): This ASSERT can happen if the path was changed by a filter without clearing the
   // route cache. We should consider if ASSERT-ing is the desired behavior in this case.
 
-  const absl::string_view path_view = path.getStringView();
-  ASSERT(std::regex_match(path_view.begin(), path_view.begin() + path_string_length, regex_));
-  const std::string matched_path(path_view.begin(), path_view.begin() + path_string_length);
+  const absl::string_view path_view = path.getStringView().substr(0, path_string_length);
+  ASSERT(regex_->match(path_view));
+  const std::string matched_path(path_view);
 
   finalizePathHeader(headers, matched_path, insert_envoy_original_path);
 }
@@ -863,21 +906,31 @@ RouteConstSharedPtr RegexRouteEntryImpl::matches(const Http::HeaderMap& headers,
   if (RouteEntryImplBase::matchRoute(headers, random_value)) {
     const Http::HeaderString& path = headers.Path()->value();
     const absl::string_view query_string = Http::Utility::findQueryStringStart(path);
-    if (std::regex_match(path.getStringView().begin(),
-                         path.getStringView().begin() + (path.size() - query_string.length()),
-                         regex_)) {
+    if (regex_->match(path.getStringView().substr(0, path.size() - query_string.length()))) {
       return clusterEntry(headers, random_value);
     }
   }
   return nullptr;
 }
 
+CommonConfigImpl::CommonConfigImpl(const envoy::api::v2::RouteConfiguration& config)
+    : request_headers_parser_(HeaderParser::configure(config.request_headers_to_add(),
+                                                      config.request_headers_to_remove())),
+      response_headers_parser_(HeaderParser::configure(config.response_headers_to_add(),
+                                                       config.response_headers_to_remove())) {
+  envoy::api::v2::RouteConfiguration common_config;
+  *common_config.mutable_request_headers_to_add() = config.request_headers_to_add();
+  *common_config.mutable_request_headers_to_remove() = config.request_headers_to_remove();
+  *common_config.mutable_response_headers_to_add() = config.response_headers_to_add();
+  *common_config.mutable_response_headers_to_remove() = config.response_headers_to_remove();
+  key_ = MessageUtil::deterministicSerialize(common_config);
+}
+
 VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtual_host,
-                                 const ConfigImpl& global_route_config,
-                                 Server::Configuration::FactoryContext& factory_context,
-                                 bool validate_clusters)
+                                 CommonConfigConstSharedPtr global_route_config,
+                                 Server::Configuration::FactoryContext& factory_context)
     : name_(virtual_host.name()), rate_limit_policy_(virtual_host.rate_limits()),
-      global_route_config_(global_route_config),
+      global_route_config_(std::move(global_route_config)),
       request_headers_parser_(HeaderParser::configure(virtual_host.request_headers_to_add(),
                                                       virtual_host.request_headers_to_remove())),
       response_headers_parser_(HeaderParser::configure(virtual_host.response_headers_to_add(),
@@ -913,7 +966,8 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
     const bool has_path =
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kPath;
     const bool has_regex =
-        route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex;
+        route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex ||
+        route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kSafeRegex;
     if (has_prefix) {
       routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, factory_context));
     } else if (has_path) {
@@ -922,16 +976,6 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
       ASSERT(has_regex);
       routes_.emplace_back(new RegexRouteEntryImpl(*this, route, factory_context));
     }
-
-    if (validate_clusters) {
-      routes_.back()->validateClusters(factory_context.clusterManager());
-      if (!routes_.back()->shadowPolicy().cluster().empty()) {
-        if (!factory_context.clusterManager().get(routes_.back()->shadowPolicy().cluster())) {
-          throw EnvoyException(fmt::format("route: unknown shadow cluster '{}'",
-                                           routes_.back()->shadowPolicy().cluster()));
-        }
-      }
-    }
   }
 
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
@@ -949,18 +993,55 @@ VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
     method_ = envoy::api::v2::core::RequestMethod_Name(virtual_cluster.method());
   }
 
-  const std::string pattern = virtual_cluster.pattern();
-  pattern_ = RegexUtil::parseRegex(pattern);
+  pattern_ = Regex::Utility::parseStdRegexAsCompiledMatcher(virtual_cluster.pattern());
   name_ = virtual_cluster.name();
 }
 
-const Config& VirtualHostImpl::routeConfig() const { return global_route_config_; }
+void VirtualHostImpl::validateClusters(Upstream::ClusterManager& cm) const {
+  for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
+    route->validateClusters(cm);
+    if (!route->shadowPolicy().cluster().empty()) {
+      if (!cm.get(route->shadowPolicy().cluster())) {
+        throw EnvoyException(
+            fmt::format("route: unknown shadow cluster '{}'", route->shadowPolicy().cluster()));
+      }
+    }
+  }
+}
 
 const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::string& name) const {
   return per_filter_configs_.get(name);
 }
 
-const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
+ConfigVirtualHostImpl::ConfigVirtualHostImpl(VirtualHostConstSharedPtr virtual_host,
+                                             const Config& route_config)
+    : virtual_host_(std::move(virtual_host)), route_config_(route_config) {
+  for (const RouteEntryImplBaseConstSharedPtr& route : virtual_host_->routes()) {
+    if (route->routeEntry() == nullptr) {
+      continue;
+    }
+    routes_.emplace(route.get(), std::make_shared<const ConfigRouteEntry>(route, *this));
+    for (const RouteConstSharedPtr& cluster : route->weightedClusters()) {
+      routes_.emplace(cluster.get(), std::make_shared<const ConfigRouteEntry>(cluster, *this));
+    }
+  }
+}
+
+RouteConstSharedPtr ConfigVirtualHostImpl::getRouteFromEntries(const Http::HeaderMap& headers,
+                                                               uint64_t random_value) const {
+  RouteConstSharedPtr route = virtual_host_->getRouteFromEntries(headers, random_value);
+  // Direct responses and SSL redirects do not refer to their virtual host.
+  if (route == nullptr || route->routeEntry() == nullptr) {
+    return route;
+  }
+  const auto it = routes_.find(route.get());
+  if (it != routes_.end()) {
+    return it->second;
+  }
+  return std::make_shared<const ConfigRouteEntry>(std::move(route), *this);
+}
+
+const ConfigVirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
     const std::string& host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
     RouteMatcher::SubstringFunction substring_function) const {
   // We do a longest wildcard match against the host that's passed in
@@ -976,19 +1057,117 @@ const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
     }
     const auto& match = wildcard_map.find(substring_function(host, wildcard_length));
     if (match != wildcard_map.end()) {
-      return match->second.get();
+      return match->second;
     }
   }
   return nullptr;
 }
 
-RouteMatcher::RouteMatcher(const envoy::api::v2::RouteConfiguration& route_config,
-                           const ConfigImpl& global_route_config,
+VirtualHostCache::CacheStats::CacheStats(Stats::Scope& scope)
+    : scope_(scope.createScope("virtual_host_cache.")),
+      stats_({ALL_VIRTUAL_HOST_CACHE_STATS(POOL_COUNTER(*scope_), POOL_GAUGE(*scope_))}) {}
+
+VirtualHostCache::CompiledVirtualHost::CompiledVirtualHost(
+    const envoy::api::v2::route::VirtualHost& virtual_host,
+    CommonConfigConstSharedPtr global_route_config,
+    Server::Configuration::FactoryContext& factory_context, CacheStatsSharedPtr stats)
+    : virtual_host_(virtual_host, std::move(global_route_config), factory_context),
+      stats_(std::move(stats)) {
+  stats_->stats_.active_.inc();
+}
+
+VirtualHostCache::CompiledVirtualHost::~CompiledVirtualHost() { stats_->stats_.active_.dec(); }
+
+VirtualHostCache::Use::Use(CompiledVirtualHostSharedPtr compiled) : compiled_(std::move(compiled)) {
+  // Every use but the first saves compiling the virtual host.
+  if (compiled_->uses_++ > 0) {
+    compiled_->stats_->stats_.shared_.inc();
+    compiled_->stats_->stats_.bytes_saved_.add(compiled_->bytes_);
+  }
+}
+
+VirtualHostCache::Use::~Use() {
+  if (--compiled_->uses_ > 0) {
+    compiled_->stats_->stats_.shared_.dec();
+    compiled_->stats_->stats_.bytes_saved_.sub(compiled_->bytes_);
+  }
+}
+
+VirtualHostCache::VirtualHostCache(Stats::Scope& scope)
+    : stats_(std::make_shared<CacheStats>(scope)) {}
+
+VirtualHostConstSharedPtr
+VirtualHostCache::getOrCreate(const envoy::api::v2::route::VirtualHost& virtual_host,
+                              const CommonConfigConstSharedPtr& global_route_config,
+                              Server::Configuration::FactoryContext& factory_context,
+                              uint64_t context_id) {
+  ASSERT(context_id != 0);
+  // The key is the exact configuration rather than a hash of it, so that a collision can never
+  // hand out the wrong virtual host. The common part is length prefixed to keep the two apart.
+  // Per filter configs may refer to the factory context they were created with, so a virtual host
+  // that has them is only shared by route configurations built with the same context. Ids are
+  // never 0, which keys the virtual hosts that can be shared by any route configuration.
+  const std::string& common_key = global_route_config->key();
+  const std::string serialized = MessageUtil::deterministicSerialize(virtual_host);
+  std::string key = fmt::format("{}:{}:{}{}", hasPerFilterConfigs(virtual_host) ? context_id : 0,
+                                common_key.size(), common_key, serialized);
+
+  auto it = virtual_hosts_.find(key);
+  CompiledVirtualHostSharedPtr compiled = it != virtual_hosts_.end() ? it->second.lock() : nullptr;
+  if (compiled != nullptr) {
+    stats_->stats_.hit_.inc();
+  } else {
+    stats_->stats_.miss_.inc();
+    compiled = std::make_shared<CompiledVirtualHost>(virtual_host, global_route_config,
+                                                     factory_context, stats_);
+    compiled->bytes_ = serialized.size();
+
+    if (it != virtual_hosts_.end()) {
+      // The virtual host of this entry was freed.
+      it->second = compiled;
+    } else {
+      virtual_hosts_.emplace(std::move(key), compiled);
+      if (virtual_hosts_.size() > next_sweep_size_) {
+        removeExpired();
+        next_sweep_size_ = 2 * virtual_hosts_.size();
+      }
+    }
+  }
+
+  // The returned pointer owns the use, which owns the compiled virtual host.
+  auto use = std::make_shared<const Use>(std::move(compiled));
+  return VirtualHostConstSharedPtr(use, &use->compiled_->virtual_host_);
+}
+
+void VirtualHostCache::removeExpired() {
+  for (auto it = virtual_hosts_.begin(); it != virtual_hosts_.end();) {
+    if (it->second.expired()) {
+      it = virtual_hosts_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+RouteMatcher::RouteMatcher(const envoy::api::v2::RouteConfiguration& config,
+                           const Config& route_config,
+                           const CommonConfigConstSharedPtr& global_route_config,
                            Server::Configuration::FactoryContext& factory_context,
-                           bool validate_clusters) {
-  for (const auto& virtual_host_config : route_config.virtual_hosts()) {
-    VirtualHostSharedPtr virtual_host(new VirtualHostImpl(virtual_host_config, global_route_config,
-                                                          factory_context, validate_clusters));
+                           bool validate_clusters, VirtualHostCache* virtual_host_cache,
+                           uint64_t context_id) {
+  for (const auto& virtual_host_config : config.virtual_hosts()) {
+    VirtualHostConstSharedPtr shared_virtual_host =
+        virtual_host_cache != nullptr
+            ? virtual_host_cache->getOrCreate(virtual_host_config, global_route_config,
+                                              factory_context, context_id)
+            : std::make_shared<const VirtualHostImpl>(virtual_host_config, global_route_config,
+                                                      factory_context);
+    if (validate_clusters) {
+      shared_virtual_host->validateClusters(factory_context.clusterManager());
+    }
+    owned_virtual_hosts_.push_back(std::make_unique<const ConfigVirtualHostImpl>(
+        std::move(shared_virtual_host), route_config));
+    const ConfigVirtualHostImpl* virtual_host = owned_virtual_hosts_.back().get();
     for (const std::string& domain_name : virtual_host_config.domains()) {
       const std::string domain = Http::LowerCaseString(domain_name).get();
       bool duplicate_found = false;
@@ -1044,11 +1223,11 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::HeaderMap&
   return nullptr;
 }
 
-const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::HeaderMap& headers) const {
+const ConfigVirtualHostImpl* RouteMatcher::findVirtualHost(const Http::HeaderMap& headers) const {
   // Fast path the case where we only have a default virtual host.
   if (virtual_hosts_.empty() && wildcard_virtual_host_suffixes_.empty() &&
       wildcard_virtual_host_prefixes_.empty()) {
-    return default_virtual_host_.get();
+    return default_virtual_host_;
   }
 
   // TODO (@rshriram) Match Origin header in WebSocket
@@ -1057,10 +1236,10 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::HeaderMap& head
       Http::LowerCaseString(std::string(headers.Host()->value().getStringView())).get();
   const auto& iter = virtual_hosts_.find(host);
   if (iter != virtual_hosts_.end()) {
-    return iter->second.get();
+    return iter->second;
   }
   if (!wildcard_virtual_host_suffixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
+    const ConfigVirtualHostImpl* vhost = findWildcardVirtualHost(
         host, wildcard_virtual_host_suffixes_,
         [](const std::string& h, int l) -> std::string { return h.substr(h.size() - l); });
     if (vhost != nullptr) {
@@ -1068,19 +1247,19 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::HeaderMap& head
     }
   }
   if (!wildcard_virtual_host_prefixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
+    const ConfigVirtualHostImpl* vhost = findWildcardVirtualHost(
         host, wildcard_virtual_host_prefixes_,
         [](const std::string& h, int l) -> std::string { return h.substr(0, l); });
     if (vhost != nullptr) {
       return vhost;
     }
   }
-  return default_virtual_host_.get();
+  return default_virtual_host_;
 }
 
 RouteConstSharedPtr RouteMatcher::route(const Http::HeaderMap& headers,
                                         uint64_t random_value) const {
-  const VirtualHostImpl* virtual_host = findVirtualHost(headers);
+  const ConfigVirtualHostImpl* virtual_host = findVirtualHost(headers);
   if (virtual_host) {
     return virtual_host->getRouteFromEntries(headers, random_value);
   } else {
@@ -1099,8 +1278,7 @@ VirtualHostImpl::virtualClusterFromEntries(const Http::HeaderMap& headers) const
     bool method_matches =
         !entry.method_ || headers.Method()->value().getStringView() == entry.method_.value();
 
-    absl::string_view path_view = headers.Path()->value().getStringView();
-    if (method_matches && std::regex_match(path_view.begin(), path_view.end(), entry.pattern_)) {
+    if (method_matches && entry.pattern_->match(headers.Path()->value().getStringView())) {
       return &entry;
     }
   }
@@ -1114,20 +1292,17 @@ VirtualHostImpl::virtualClusterFromEntries(const Http::HeaderMap& headers) const
 
 ConfigImpl::ConfigImpl(const envoy::api::v2::RouteConfiguration& config,
                        Server::Configuration::FactoryContext& factory_context,
-                       bool validate_clusters_default)
-    : name_(config.name()) {
+                       bool validate_clusters_default, VirtualHostCache* virtual_host_cache,
+                       uint64_t context_id)
+    : common_config_(std::make_shared<const CommonConfigImpl>(config)), name_(config.name()) {
   route_matcher_ = std::make_unique<RouteMatcher>(
-      config, *this, factory_context,
-      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default));
+      config, *this, common_config_, factory_context,
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default),
+      virtual_host_cache, context_id);
 
   for (const std::string& header : config.internal_only_headers()) {
     internal_only_headers_.push_back(Http::LowerCaseString(header));
   }
-
-  request_headers_parser_ =
-      HeaderParser::configure(config.request_headers_to_add(), config.request_headers_to_remove());
-  response_headers_parser_ = HeaderParser::configure(config.response_headers_to_add(),
-                                                     config.response_headers_to_remove());
 }
 
 namespace {
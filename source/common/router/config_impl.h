@@ -1,11 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
-#include <regex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -15,8 +15,11 @@
 #include "envoy/router/router.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/server/filter_config.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/common/assert.h"
 #include "common/config/metadata.h"
 #include "common/http/header_utility.h"
 #include "common/router/config_utility.h"
@@ -24,6 +27,7 @@
 #include "common/router/header_parser.h"
 #include "common/router/metadatamatchcriteria_impl.h"
 #include "common/router/router_ratelimit.h"
+#include "common/runtime/key_registry.h"
 
 #include "absl/types/optional.h"
 
@@ -99,7 +103,9 @@ public:
 
   // Router::CorsPolicy
   const std::list<std::string>& allowOrigins() const override { return allow_origin_; };
-  const std::list<std::regex>& allowOriginRegexes() const override { return allow_origin_regex_; }
+  const std::vector<Regex::CompiledMatcherPtr>& allowOriginRegexes() const override {
+    return allow_origin_regex_;
+  }
   const std::string& allowMethods() const override { return allow_methods_; };
   const std::string& allowHeaders() const override { return allow_headers_; };
   const std::string& exposeHeaders() const override { return expose_headers_; };
@@ -107,17 +113,15 @@ public:
   const absl::optional<bool>& allowCredentials() const override { return allow_credentials_; };
   bool enabled() const override {
     if (config_.has_filter_enabled()) {
-      const auto& filter_enabled = config_.filter_enabled();
-      return loader_.snapshot().featureEnabled(filter_enabled.runtime_key(),
-                                               filter_enabled.default_value());
+      return loader_.snapshot().featureEnabled(*filter_enabled_runtime_key_,
+                                               config_.filter_enabled().default_value());
     }
     return legacy_enabled_;
   };
   bool shadowEnabled() const override {
     if (config_.has_shadow_enabled()) {
-      const auto& shadow_enabled = config_.shadow_enabled();
-      return loader_.snapshot().featureEnabled(shadow_enabled.runtime_key(),
-                                               shadow_enabled.default_value());
+      return loader_.snapshot().featureEnabled(*shadow_enabled_runtime_key_,
+                                               config_.shadow_enabled().default_value());
     }
     return false;
   };
@@ -126,39 +130,75 @@ private:
   const envoy::api::v2::route::CorsPolicy config_;
   Runtime::Loader& loader_;
   std::list<std::string> allow_origin_;
-  std::list<std::regex> allow_origin_regex_;
+  std::vector<Regex::CompiledMatcherPtr> allow_origin_regex_;
   std::string allow_methods_;
   std::string allow_headers_;
   std::string expose_headers_;
   std::string max_age_{};
   absl::optional<bool> allow_credentials_{};
   bool legacy_enabled_;
+  absl::optional<Runtime::Key> filter_enabled_runtime_key_;
+  absl::optional<Runtime::Key> shadow_enabled_runtime_key_;
 };
 
-class ConfigImpl;
 /**
- * Holds all routing configuration for an entire virtual host.
+ * The parts of a route configuration that its virtual hosts use at request time. Virtual hosts
+ * share ownership of them rather than referring to the route configuration, so that a virtual host
+ * can be used by every route configuration with the same parts (@see VirtualHostCache).
+ */
+class CommonConfigImpl {
+public:
+  CommonConfigImpl(const envoy::api::v2::RouteConfiguration& config);
+
+  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
+  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
+
+  /**
+   * @return const std::string& the deterministically serialized configuration of these parts,
+   *         which is equal for route configurations whose parts are equal.
+   */
+  const std::string& key() const { return key_; }
+
+private:
+  HeaderParserPtr request_headers_parser_;
+  HeaderParserPtr response_headers_parser_;
+  std::string key_;
+};
+
+typedef std::shared_ptr<const CommonConfigImpl> CommonConfigConstSharedPtr;
+
+/**
+ * Holds all routing configuration for an entire virtual host. It does not refer to the route
+ * configuration that built it, so that it can be shared by route configurations with the same
+ * virtual host (@see VirtualHostCache). Each route configuration exposes it through a
+ * ConfigVirtualHostImpl.
  */
-class VirtualHostImpl : public VirtualHost {
+class VirtualHostImpl {
 public:
   VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtual_host,
-                  const ConfigImpl& global_route_config,
-                  Server::Configuration::FactoryContext& factory_context, bool validate_clusters);
+                  CommonConfigConstSharedPtr global_route_config,
+                  Server::Configuration::FactoryContext& factory_context);
+
+  /**
+   * Check that the clusters and shadow clusters of all routes exist.
+   * @param cm supplies the cluster manager to look the clusters up in.
+   * @throw EnvoyException if a cluster does not exist.
+   */
+  void validateClusters(Upstream::ClusterManager& cm) const;
 
   RouteConstSharedPtr getRouteFromEntries(const Http::HeaderMap& headers,
                                           uint64_t random_value) const;
   const VirtualCluster* virtualClusterFromEntries(const Http::HeaderMap& headers) const;
-  const ConfigImpl& globalRouteConfig() const { return global_route_config_; }
+  const CommonConfigImpl& globalRouteConfig() const { return *global_route_config_; }
   const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
   const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
 
-  // Router::VirtualHost
-  const CorsPolicy* corsPolicy() const override { return cors_policy_.get(); }
-  const std::string& name() const override { return name_; }
-  const RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
-  const Config& routeConfig() const override;
-  const RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override;
-  bool includeAttemptCount() const override { return include_attempt_count_; }
+  const std::vector<RouteEntryImplBaseConstSharedPtr>& routes() const { return routes_; }
+  const CorsPolicy* corsPolicy() const { return cors_policy_.get(); }
+  const std::string& name() const { return name_; }
+  const RateLimitPolicy& rateLimitPolicy() const { return rate_limit_policy_; }
+  const RouteSpecificFilterConfig* perFilterConfig(const std::string& name) const;
+  bool includeAttemptCount() const { return include_attempt_count_; }
   const absl::optional<envoy::api::v2::route::RetryPolicy>& retryPolicy() const {
     return retry_policy_;
   }
@@ -175,7 +215,7 @@ private:
     // Router::VirtualCluster
     const std::string& name() const override { return name_; }
 
-    std::regex pattern_;
+    Regex::CompiledMatcherPtr pattern_;
     absl::optional<std::string> method_;
     std::string name_;
   };
@@ -196,8 +236,7 @@ private:
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
   std::unique_ptr<const CorsPolicyImpl> cors_policy_;
-  const ConfigImpl& global_route_config_; // See note in RouteEntryImplBase::clusterEntry() on why
-                                          // raw ref to the top level config is currently safe.
+  const CommonConfigConstSharedPtr global_route_config_;
   HeaderParserPtr request_headers_parser_;
   HeaderParserPtr response_headers_parser_;
   PerFilterConfigs per_filter_configs_;
@@ -206,7 +245,121 @@ private:
   absl::optional<envoy::api::v2::route::HedgePolicy> hedge_policy_;
 };
 
-typedef std::shared_ptr<VirtualHostImpl> VirtualHostSharedPtr;
+typedef std::shared_ptr<const VirtualHostImpl> VirtualHostConstSharedPtr;
+
+/**
+ * The virtual host of one route configuration. The routes and policies are those of a
+ * VirtualHostImpl that may be shared with other route configurations; the routes are handed out
+ * wrapped so that their virtualHost() is this object, which knows its route configuration.
+ */
+class ConfigVirtualHostImpl : public VirtualHost {
+public:
+  ConfigVirtualHostImpl(VirtualHostConstSharedPtr virtual_host, const Config& route_config);
+
+  RouteConstSharedPtr getRouteFromEntries(const Http::HeaderMap& headers,
+                                          uint64_t random_value) const;
+
+  // Router::VirtualHost
+  const CorsPolicy* corsPolicy() const override { return virtual_host_->corsPolicy(); }
+  const std::string& name() const override { return virtual_host_->name(); }
+  const RateLimitPolicy& rateLimitPolicy() const override {
+    return virtual_host_->rateLimitPolicy();
+  }
+  const Config& routeConfig() const override { return route_config_; }
+  const RouteSpecificFilterConfig* perFilterConfig(const std::string& name) const override {
+    return virtual_host_->perFilterConfig(name);
+  }
+  bool includeAttemptCount() const override { return virtual_host_->includeAttemptCount(); }
+
+private:
+  /**
+   * Forwards everything to a route entry of the shared virtual host, except virtualHost().
+   */
+  class ConfigRouteEntry : public RouteEntry, public Route {
+  public:
+    ConfigRouteEntry(RouteConstSharedPtr route, const ConfigVirtualHostImpl& vhost)
+        : route_(std::move(route)), entry_(*route_->routeEntry()), vhost_(vhost) {}
+
+    // Router::RouteEntry
+    const std::string& clusterName() const override { return entry_.clusterName(); }
+    Http::Code clusterNotFoundResponseCode() const override {
+      return entry_.clusterNotFoundResponseCode();
+    }
+    const CorsPolicy* corsPolicy() const override { return entry_.corsPolicy(); }
+    void finalizeRequestHeaders(Http::HeaderMap& headers, const StreamInfo::StreamInfo& stream_info,
+                                bool insert_envoy_original_path) const override {
+      entry_.finalizeRequestHeaders(headers, stream_info, insert_envoy_original_path);
+    }
+    void finalizeResponseHeaders(Http::HeaderMap& headers,
+                                 const StreamInfo::StreamInfo& stream_info) const override {
+      entry_.finalizeResponseHeaders(headers, stream_info);
+    }
+    const HashPolicy* hashPolicy() const override { return entry_.hashPolicy(); }
+    const HedgePolicy& hedgePolicy() const override { return entry_.hedgePolicy(); }
+    Upstream::ResourcePriority priority() const override { return entry_.priority(); }
+    const RateLimitPolicy& rateLimitPolicy() const override { return entry_.rateLimitPolicy(); }
+    const RetryPolicy& retryPolicy() const override { return entry_.retryPolicy(); }
+    const ShadowPolicy& shadowPolicy() const override { return entry_.shadowPolicy(); }
+    std::chrono::milliseconds timeout() const override { return entry_.timeout(); }
+    absl::optional<std::chrono::milliseconds> idleTimeout() const override {
+      return entry_.idleTimeout();
+    }
+    absl::optional<std::chrono::milliseconds> maxGrpcTimeout() const override {
+      return entry_.maxGrpcTimeout();
+    }
+    absl::optional<std::chrono::milliseconds> grpcTimeoutOffset() const override {
+      return entry_.grpcTimeoutOffset();
+    }
+    const VirtualCluster* virtualCluster(const Http::HeaderMap& headers) const override {
+      return entry_.virtualCluster(headers);
+    }
+    const VirtualHost& virtualHost() const override { return vhost_; }
+    bool autoHostRewrite() const override { return entry_.autoHostRewrite(); }
+    const MetadataMatchCriteria* metadataMatchCriteria() const override {
+      return entry_.metadataMatchCriteria();
+    }
+    const std::multimap<std::string, std::string>& opaqueConfig() const override {
+      return entry_.opaqueConfig();
+    }
+    bool includeVirtualHostRateLimits() const override {
+      return entry_.includeVirtualHostRateLimits();
+    }
+    const Envoy::Config::TypedMetadata& typedMetadata() const override {
+      return entry_.typedMetadata();
+    }
+    const envoy::api::v2::core::Metadata& metadata() const override { return entry_.metadata(); }
+    const PathMatchCriterion& pathMatchCriterion() const override {
+      return entry_.pathMatchCriterion();
+    }
+    bool includeAttemptCount() const override { return entry_.includeAttemptCount(); }
+    const UpgradeMap& upgradeMap() const override { return entry_.upgradeMap(); }
+    InternalRedirectAction internalRedirectAction() const override {
+      return entry_.internalRedirectAction();
+    }
+
+    // Router::Route
+    const DirectResponseEntry* directResponseEntry() const override { return nullptr; }
+    const RouteEntry* routeEntry() const override { return this; }
+    const Decorator* decorator() const override { return route_->decorator(); }
+    const RouteSpecificFilterConfig* perFilterConfig(const std::string& name) const override {
+      return route_->perFilterConfig(name);
+    }
+
+  private:
+    const RouteConstSharedPtr route_;
+    const RouteEntry& entry_;
+    const ConfigVirtualHostImpl& vhost_;
+  };
+
+  const VirtualHostConstSharedPtr virtual_host_;
+  const Config& route_config_;
+  // The wrappers of the route entries that the shared virtual host hands out, which are built
+  // once. Routes to the cluster named by a request header are created for each request, and are
+  // wrapped for each request as well.
+  std::unordered_map<const Route*, RouteConstSharedPtr> routes_;
+};
+
+typedef std::unique_ptr<const ConfigVirtualHostImpl> ConfigVirtualHostConstPtr;
 
 /**
  * Implementation of RetryPolicy that reads from the proto route or virtual host config.
@@ -256,12 +409,13 @@ public:
 
   // Router::ShadowPolicy
   const std::string& cluster() const override { return cluster_; }
-  const std::string& runtimeKey() const override { return runtime_key_; }
+  const std::string& runtimeKey() const override { return runtime_key_.name(); }
+  const Runtime::Key& resolvedRuntimeKey() const override { return runtime_key_; }
   const envoy::type::FractionalPercent& defaultValue() const override { return default_value_; }
 
 private:
   std::string cluster_;
-  std::string runtime_key_;
+  const Runtime::Key runtime_key_;
   envoy::type::FractionalPercent default_value_;
 };
 
@@ -364,6 +518,11 @@ public:
   bool matchRoute(const Http::HeaderMap& headers, uint64_t random_value) const;
   void validateClusters(Upstream::ClusterManager& cm) const;
 
+  /**
+   * @return the route entries of the weighted clusters of this route, if any.
+   */
+  std::vector<RouteConstSharedPtr> weightedClusters() const;
+
   // Router::RouteEntry
   const std::string& clusterName() const override;
   Http::Code clusterNotFoundResponseCode() const override {
@@ -396,7 +555,10 @@ public:
   absl::optional<std::chrono::milliseconds> grpcTimeoutOffset() const override {
     return grpc_timeout_offset_;
   }
-  const VirtualHost& virtualHost() const override { return vhost_; }
+  const VirtualHost& virtualHost() const override {
+    // Routes are only handed out wrapped by the ConfigVirtualHostImpl of a route configuration.
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
   bool autoHostRewrite() const override { return auto_host_rewrite_; }
   const std::multimap<std::string, std::string>& opaqueConfig() const override {
     return opaque_config_;
@@ -446,7 +608,11 @@ protected:
 
 private:
   struct RuntimeData {
-    std::string fractional_runtime_key_{};
+    RuntimeData(const std::string& fractional_runtime_key)
+        : fractional_runtime_key_(
+              Runtime::KeyRegistrySingleton::get().resolve(fractional_runtime_key)) {}
+
+    Runtime::Key fractional_runtime_key_;
     envoy::type::FractionalPercent fractional_runtime_default_{};
   };
 
@@ -569,7 +735,7 @@ private:
     const RouteSpecificFilterConfig* perFilterConfig(const std::string& name) const override;
 
   private:
-    const std::string runtime_key_;
+    const Runtime::Key runtime_key_;
     Runtime::Loader& loader_;
     const uint64_t cluster_weight_;
     MetadataMatchCriteriaConstPtr cluster_metadata_match_criteria_;
@@ -713,37 +879,159 @@ public:
   void rewritePathHeader(Http::HeaderMap& headers, bool insert_envoy_original_path) const override;
 
 private:
-  const std::regex regex_;
+  const Regex::CompiledMatcherPtr regex_;
   const std::string regex_str_;
 };
 
+/**
+ * All virtual host cache stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_VIRTUAL_HOST_CACHE_STATS(COUNTER, GAUGE)                                               \
+  COUNTER(hit)                                                                                     \
+  COUNTER(miss)                                                                                    \
+  GAUGE(active)                                                                                    \
+  GAUGE(shared)                                                                                    \
+  GAUGE(bytes_saved)
+// clang-format on
+
+/**
+ * Struct definition for all virtual host cache stats. @see stats_macros.h
+ */
+struct VirtualHostCacheStats {
+  ALL_VIRTUAL_HOST_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Interns compiled virtual hosts, along with their routes, by the content of their configuration,
+ * so that route configurations with identical virtual hosts share one immutable VirtualHostImpl
+ * instead of each compiling a copy. This happens when the same virtual hosts are served in several
+ * route configurations, and when a new version of a route configuration is built while the
+ * previous one is still in use. Only weak references are held, so a virtual host is freed along
+ * with the last route configuration that uses it.
+ *
+ * A compiled virtual host depends on its configuration and on the CommonConfigImpl of its route
+ * configuration, which are the key. Compiling it otherwise only uses server wide objects of the
+ * factory context, so it is shared by route configurations of any listener. Per filter configs are
+ * the exception, since they may keep references into the factory context they are created with.
+ * Virtual hosts that have them are additionally keyed on the id of that context, see
+ * newContextId(), and only shared by route configurations built with it. Cluster validation
+ * depends on the route configuration and is done by RouteMatcher for each use of a virtual host.
+ *
+ * The gauges are updated as virtual hosts are used and released, which may happen on any thread.
+ * Entries of freed virtual hosts are dropped when their key is looked up again, or by a sweep
+ * whenever the number of entries has doubled since the last one, so that building a route
+ * configuration does not walk the whole cache. The cache itself must only be used on the main
+ * thread.
+ */
+class VirtualHostCache {
+public:
+  VirtualHostCache(Stats::Scope& scope);
+
+  /**
+   * @return uint64_t a new id for a factory context that route configurations are built with.
+   *         Ids are never reused, so a virtual host can not be shared with a route configuration
+   *         built with a later context that happens to live at the address of a freed one.
+   */
+  uint64_t newContextId() { return ++last_context_id_; }
+
+  /**
+   * @param virtual_host supplies the virtual host configuration.
+   * @param global_route_config supplies the common parts of the route configuration.
+   * @param factory_context supplies the context to compile the virtual host with.
+   * @param context_id supplies the id of factory_context, as returned by newContextId(). Virtual
+   *        hosts with per filter configs are only shared by calls with the same id.
+   * @return VirtualHostConstSharedPtr the cached virtual host for the configuration, or a newly
+   *         compiled one that is added to the cache. Each call returns a new reference, which is
+   *         counted as one use of the virtual host until it is released.
+   */
+  VirtualHostConstSharedPtr getOrCreate(const envoy::api::v2::route::VirtualHost& virtual_host,
+                                        const CommonConfigConstSharedPtr& global_route_config,
+                                        Server::Configuration::FactoryContext& factory_context,
+                                        uint64_t context_id);
+
+private:
+  /**
+   * The cache stats, which are shared with the virtual hosts since they may outlive the cache.
+   */
+  struct CacheStats {
+    CacheStats(Stats::Scope& scope);
+
+    Stats::ScopePtr scope_;
+    VirtualHostCacheStats stats_;
+  };
+
+  typedef std::shared_ptr<CacheStats> CacheStatsSharedPtr;
+
+  /**
+   * A compiled virtual host and the number of its uses.
+   */
+  struct CompiledVirtualHost {
+    CompiledVirtualHost(const envoy::api::v2::route::VirtualHost& virtual_host,
+                        CommonConfigConstSharedPtr global_route_config,
+                        Server::Configuration::FactoryContext& factory_context,
+                        CacheStatsSharedPtr stats);
+    ~CompiledVirtualHost();
+
+    const VirtualHostImpl virtual_host_;
+    const CacheStatsSharedPtr stats_;
+    // The serialized size of the configuration, which stands in for the size of the compiled
+    // virtual host that each use beyond the first saves. Measuring the heap instead would count
+    // the allocations of other threads.
+    uint64_t bytes_{};
+    std::atomic<uint64_t> uses_{};
+  };
+
+  typedef std::shared_ptr<CompiledVirtualHost> CompiledVirtualHostSharedPtr;
+
+  /**
+   * One use of a compiled virtual host, which is held by the returned VirtualHostConstSharedPtr.
+   */
+  struct Use {
+    Use(CompiledVirtualHostSharedPtr compiled);
+    ~Use();
+
+    const CompiledVirtualHostSharedPtr compiled_;
+  };
+
+  void removeExpired();
+
+  const CacheStatsSharedPtr stats_;
+  std::unordered_map<std::string, std::weak_ptr<CompiledVirtualHost>> virtual_hosts_;
+  size_t next_sweep_size_{};
+  uint64_t last_context_id_{};
+};
+
 /**
  * Wraps the route configuration which matches an incoming request headers to a backend cluster.
  * This is split out mainly to help with unit testing.
  */
 class RouteMatcher {
 public:
-  RouteMatcher(const envoy::api::v2::RouteConfiguration& config,
-               const ConfigImpl& global_http_config,
-               Server::Configuration::FactoryContext& factory_context, bool validate_clusters);
+  RouteMatcher(const envoy::api::v2::RouteConfiguration& config, const Config& route_config,
+               const CommonConfigConstSharedPtr& global_route_config,
+               Server::Configuration::FactoryContext& factory_context, bool validate_clusters,
+               VirtualHostCache* virtual_host_cache, uint64_t context_id);
 
   RouteConstSharedPtr route(const Http::HeaderMap& headers, uint64_t random_value) const;
 
 private:
-  const VirtualHostImpl* findVirtualHost(const Http::HeaderMap& headers) const;
+  const ConfigVirtualHostImpl* findVirtualHost(const Http::HeaderMap& headers) const;
 
-  typedef std::map<int64_t, std::unordered_map<std::string, VirtualHostSharedPtr>,
+  typedef std::map<int64_t, std::unordered_map<std::string, const ConfigVirtualHostImpl*>,
                    std::greater<int64_t>>
       WildcardVirtualHosts;
   typedef std::function<std::string(const std::string&, int)> SubstringFunction;
-  const VirtualHostImpl* findWildcardVirtualHost(const std::string& host,
-                                                 const WildcardVirtualHosts& wildcard_virtual_hosts,
-                                                 SubstringFunction substring_function) const;
+  const ConfigVirtualHostImpl*
+  findWildcardVirtualHost(const std::string& host,
+                          const WildcardVirtualHosts& wildcard_virtual_hosts,
+                          SubstringFunction substring_function) const;
 
-  std::unordered_map<std::string, VirtualHostSharedPtr> virtual_hosts_;
+  std::vector<ConfigVirtualHostConstPtr> owned_virtual_hosts_;
+  std::unordered_map<std::string, const ConfigVirtualHostImpl*> virtual_hosts_;
   // std::greater as a minor optimization to iterate from more to less specific
   //
-  // A note on using an unordered_map versus a vector of (string, VirtualHostSharedPtr) pairs:
+  // A note on using an unordered_map versus a vector of (string, ConfigVirtualHostImpl*) pairs:
   //
   // Based on local benchmarks, each vector entry costs around 20ns for recall and (string)
   // comparison with a fixed cost of about 25ns. For unordered_map, the empty map costs about 65ns
@@ -753,7 +1041,7 @@ private:
   WildcardVirtualHosts wildcard_virtual_host_suffixes_;
   WildcardVirtualHosts wildcard_virtual_host_prefixes_;
 
-  VirtualHostSharedPtr default_virtual_host_;
+  const ConfigVirtualHostImpl* default_virtual_host_{};
 };
 
 /**
@@ -761,12 +1049,22 @@ private:
  */
 class ConfigImpl : public Config {
 public:
+  /**
+   * @param virtual_host_cache supplies the cache to share virtual hosts with other route
+   *        configurations through, or nullptr to compile them all.
+   * @param context_id supplies the id of factory_context in virtual_host_cache, see
+   *        VirtualHostCache::newContextId().
+   */
   ConfigImpl(const envoy::api::v2::RouteConfiguration& config,
-             Server::Configuration::FactoryContext& factory_context,
-             bool validate_clusters_default);
+             Server::Configuration::FactoryContext& factory_context, bool validate_clusters_default,
+             VirtualHostCache* virtual_host_cache = nullptr, uint64_t context_id = 0);
 
-  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
-  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
+  const HeaderParser& requestHeaderParser() const {
+    return common_config_->requestHeaderParser();
+  };
+  const HeaderParser& responseHeaderParser() const {
+    return common_config_->responseHeaderParser();
+  };
 
   // Router::Config
   RouteConstSharedPtr route(const Http::HeaderMap& headers, uint64_t random_value) const override {
@@ -780,10 +1078,9 @@ public:
   const std::string& name() const override { return name_; }
 
 private:
+  const CommonConfigConstSharedPtr common_config_;
   std::unique_ptr<RouteMatcher> route_matcher_;
   std::list<Http::LowerCaseString> internal_only_headers_;
-  HeaderParserPtr request_headers_parser_;
-  HeaderParserPtr response_headers_parser_;
   const std::string name_;
 };
 
@@ -1,6 +1,5 @@
 #include "common/router/config_utility.h"
 
-#include <regex>
 #include <string>
 #include <vector>
 
@@ -15,7 +14,7 @@ bool ConfigUtility::QueryParameterMatcher::matches(
   if (query_param == request_query_params.end()) {
     return false;
   } else if (is_regex_) {
-    return std::regex_match(query_param->second, regex_pattern_);
+    return regex_pattern_->match(query_param->second);
   } else if (value_.length() == 0) {
     return true;
   } else {
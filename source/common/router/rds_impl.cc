@@ -42,7 +42,10 @@ StaticRouteConfigProviderImpl::StaticRouteConfigProviderImpl(
     const envoy::api::v2::RouteConfiguration& config,
     Server::Configuration::FactoryContext& factory_context,
     RouteConfigProviderManagerImpl& route_config_provider_manager)
-    : config_(new ConfigImpl(config, factory_context, true)), route_config_proto_{config},
+    : config_(new ConfigImpl(config, factory_context, true,
+                             &route_config_provider_manager.virtual_host_cache_,
+                             route_config_provider_manager.virtual_host_cache_.newContextId())),
+      route_config_proto_{config},
       last_updated_(factory_context.timeSource().systemTime()),
       route_config_provider_manager_(route_config_provider_manager) {
   route_config_provider_manager_.static_route_config_providers_.insert(this);
@@ -73,7 +76,10 @@ RdsRouteConfigSubscription::RdsRouteConfigSubscription(
       rds.config_source(), factory_context.localInfo(), factory_context.dispatcher(),
       factory_context.clusterManager(), factory_context.random(), *scope_,
       "envoy.api.v2.RouteDiscoveryService.FetchRoutes",
-      "envoy.api.v2.RouteDiscoveryService.StreamRoutes",
+      rds.config_source().api_config_source().api_type() ==
+              envoy::api::v2::core::ApiConfigSource::DELTA_GRPC
+          ? "envoy.api.v2.RouteDiscoveryService.DeltaRoutes"
+          : "envoy.api.v2.RouteDiscoveryService.StreamRoutes",
       Grpc::Common::typeUrl(envoy::api::v2::RouteConfiguration().GetDescriptor()->full_name()),
       factory_context.api());
 }
@@ -126,6 +132,23 @@ void RdsRouteConfigSubscription::onConfigUpdate(
   init_target_.ready();
 }
 
+void RdsRouteConfigSubscription::onConfigUpdate(
+    const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
+    const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+    const std::string& system_version_info) {
+  // There is only the one route configuration, so a delta update either replaces it or leaves it in
+  // place. A removed route configuration is kept, as when a state-of-the-world update lacks it.
+  if (!removed_resources.empty()) {
+    ENVOY_LOG(debug, "rds: ignoring removal of RouteConfiguration {}", route_config_name_);
+  }
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> resources;
+  for (const auto& resource : added_resources) {
+    *resources.Add() = resource.resource();
+  }
+  onConfigUpdate(resources, added_resources.size() == 1 ? added_resources[0].version()
+                                                        : system_version_info);
+}
+
 void RdsRouteConfigSubscription::onConfigUpdateFailed(const EnvoyException*) {
   // We need to allow server startup to continue, even if we have a bad
   // config.
@@ -136,11 +159,13 @@ RdsRouteConfigProviderImpl::RdsRouteConfigProviderImpl(
     RdsRouteConfigSubscriptionSharedPtr&& subscription,
     Server::Configuration::FactoryContext& factory_context)
     : subscription_(std::move(subscription)), factory_context_(factory_context),
+      context_id_(subscription_->route_config_provider_manager_.virtual_host_cache_.newContextId()),
       tls_(factory_context.threadLocal().allocateSlot()) {
   ConfigConstSharedPtr initial_config;
   if (subscription_->config_info_.has_value()) {
-    initial_config =
-        std::make_shared<ConfigImpl>(subscription_->route_config_proto_, factory_context_, false);
+    initial_config = std::make_shared<ConfigImpl>(
+        subscription_->route_config_proto_, factory_context_, false,
+        &subscription_->route_config_provider_manager_.virtual_host_cache_, context_id_);
   } else {
     initial_config = std::make_shared<NullConfigImpl>();
   }
@@ -169,12 +194,16 @@ absl::optional<RouteConfigProvider::ConfigInfo> RdsRouteConfigProviderImpl::conf
 
 void RdsRouteConfigProviderImpl::onConfigUpdate() {
   ConfigConstSharedPtr new_config(
-      new ConfigImpl(subscription_->route_config_proto_, factory_context_, false));
+      new ConfigImpl(subscription_->route_config_proto_, factory_context_, false,
+                     &subscription_->route_config_provider_manager_.virtual_host_cache_,
+                     context_id_));
   tls_->runOnAllThreads(
       [this, new_config]() -> void { tls_->getTyped<ThreadLocalConfig>().config_ = new_config; });
 }
 
-RouteConfigProviderManagerImpl::RouteConfigProviderManagerImpl(Server::Admin& admin) {
+RouteConfigProviderManagerImpl::RouteConfigProviderManagerImpl(Server::Admin& admin,
+                                                               Stats::Scope& scope)
+    : virtual_host_cache_(scope) {
   config_tracker_entry_ =
       admin.getConfigTracker().add("routes", [this] { return dumpRouteConfigs(); });
   // ConfigTracker keys must be unique. We are asserting that no one has stolen the "routes" key
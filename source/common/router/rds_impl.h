@@ -24,6 +24,7 @@
 #include "common/common/logger.h"
 #include "common/init/target_impl.h"
 #include "common/protobuf/utility.h"
+#include "common/router/config_impl.h"
 
 namespace Envoy {
 namespace Router {
@@ -102,10 +103,9 @@ public:
   // TODO(fredlas) deduplicate
   void onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
                       const std::string& version_info) override;
-  void onConfigUpdate(const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>&,
-                      const Protobuf::RepeatedPtrField<std::string>&, const std::string&) override {
-    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
-  }
+  void onConfigUpdate(const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
+                      const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                      const std::string& system_version_info) override;
   void onConfigUpdateFailed(const EnvoyException* e) override;
   std::string resourceName(const ProtobufWkt::Any& resource) override {
     return MessageUtil::anyConvert<envoy::api::v2::RouteConfiguration>(resource).name();
@@ -171,6 +171,9 @@ private:
 
   RdsRouteConfigSubscriptionSharedPtr subscription_;
   Server::Configuration::FactoryContext& factory_context_;
+  // The id of factory_context_ in the virtual host cache, which lets the versions of the route
+  // configuration share virtual hosts with per filter configs.
+  const uint64_t context_id_;
   ThreadLocal::SlotPtr tls_;
 
   friend class RouteConfigProviderManagerImpl;
@@ -179,7 +182,7 @@ private:
 class RouteConfigProviderManagerImpl : public RouteConfigProviderManager,
                                        public Singleton::Instance {
 public:
-  RouteConfigProviderManagerImpl(Server::Admin& admin);
+  RouteConfigProviderManagerImpl(Server::Admin& admin, Stats::Scope& scope);
 
   std::unique_ptr<envoy::admin::v2alpha::RoutesConfigDump> dumpRouteConfigs() const;
 
@@ -201,8 +204,11 @@ private:
       route_config_subscriptions_;
   std::unordered_set<RouteConfigProvider*> static_route_config_providers_;
   Server::ConfigTracker::EntryOwnerPtr config_tracker_entry_;
+  // Shared by all the route configurations of the providers.
+  VirtualHostCache virtual_host_cache_;
 
   friend class RdsRouteConfigSubscription;
+  friend class RdsRouteConfigProviderImpl;
   friend class StaticRouteConfigProviderImpl;
 };
 
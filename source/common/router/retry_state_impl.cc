@@ -11,10 +11,25 @@
 #include "common/http/codes.h"
 #include "common/http/headers.h"
 #include "common/http/utility.h"
+#include "common/runtime/key_registry.h"
+#include "common/singleton/const_singleton.h"
 
 namespace Envoy {
 namespace Router {
 
+namespace {
+
+// Runtime keys that are looked up for every request with a retry policy.
+struct RuntimeKeyValues {
+  const Runtime::Key UseRetry{Runtime::KeyRegistrySingleton::get().resolve("upstream.use_retry")};
+  const Runtime::Key BaseRetryBackoffMs{
+      Runtime::KeyRegistrySingleton::get().resolve("upstream.base_retry_backoff_ms")};
+};
+
+using RuntimeKeys = ConstSingleton<RuntimeKeyValues>;
+
+} // namespace
+
 // These are defined in envoy/router/router.h, however during certain cases the compiler is
 // refusing to use the header version so allocate space here.
 const uint32_t RetryPolicy::RETRY_ON_5XX;
@@ -61,7 +76,7 @@ RetryStateImpl::RetryStateImpl(const RetryPolicy& route_policy, Http::HeaderMap&
   retries_remaining_ = std::max(retries_remaining_, route_policy.numRetries());
 
   std::chrono::milliseconds base_interval(
-      runtime_.snapshot().getInteger("upstream.base_retry_backoff_ms", 25));
+      runtime_.snapshot().getInteger(RuntimeKeys::get().BaseRetryBackoffMs, 25));
   if (route_policy.baseInterval()) {
     base_interval = *route_policy.baseInterval();
   }
@@ -187,7 +202,7 @@ RetryStatus RetryStateImpl::shouldRetry(bool would_retry, DoRetryCallback callba
     return RetryStatus::NoOverflow;
   }
 
-  if (!runtime_.snapshot().featureEnabled("upstream.use_retry", 100)) {
+  if (!runtime_.snapshot().featureEnabled(RuntimeKeys::get().UseRetry, 100)) {
     return RetryStatus::No;
   }
 
@@ -10,6 +10,7 @@
 #include "envoy/grpc/status.h"
 #include "envoy/http/conn_pool.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/singleton/manager.h"
 #include "envoy/upstream/cluster_manager.h"
 #include "envoy/upstream/upstream.h"
 
@@ -29,6 +30,18 @@
 
 namespace Envoy {
 namespace Router {
+
+// Singleton registration via macro defined in envoy/singleton/manager.h
+SINGLETON_MANAGER_REGISTRATION(router_vcluster_stats_scope);
+
+VirtualClusterStatsScopeSharedPtr
+VirtualClusterStatsScope::get(Server::Configuration::FactoryContext& context) {
+  return context.singletonManager().getTyped<VirtualClusterStatsScope>(
+      SINGLETON_MANAGER_REGISTERED_NAME(router_vcluster_stats_scope), [&context] {
+        return std::make_shared<VirtualClusterStatsScope>(context.scope());
+      });
+}
+
 namespace {
 uint32_t getLength(const Buffer::Instance* instance) { return instance ? instance->length() : 0; }
 
@@ -101,12 +114,13 @@ bool FilterUtility::shouldShadow(const ShadowPolicy& policy, Runtime::Loader& ru
   }
 
   if (policy.defaultValue().numerator() > 0) {
-    return runtime.snapshot().featureEnabled(policy.runtimeKey(), policy.defaultValue(),
+    return runtime.snapshot().featureEnabled(policy.resolvedRuntimeKey(), policy.defaultValue(),
                                              stable_random);
   }
 
   if (!policy.runtimeKey().empty() &&
-      !runtime.snapshot().featureEnabled(policy.runtimeKey(), 0, stable_random, 10000UL)) {
+      !runtime.snapshot().featureEnabled(policy.resolvedRuntimeKey(), 0, stable_random,
+                                         10000UL)) {
     return false;
   }
 
@@ -224,7 +238,7 @@ void Filter::chargeUpstreamCode(uint64_t response_status_code,
     const std::string zone_name = config_.local_info_.zoneName();
     const std::string upstream_zone = upstreamZone(upstream_host);
 
-    Http::CodeStats::ResponseStatInfo info{config_.scope_,
+    Http::CodeStats::ResponseStatInfo info{config_.vclusterScope(),
                                            cluster_->statsScope(),
                                            EMPTY_STRING,
                                            response_status_code,
@@ -877,7 +891,7 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
     const std::string zone_name = config_.local_info_.zoneName();
 
     Http::CodeStats& code_stats = httpContext().codeStats();
-    Http::CodeStats::ResponseTimingInfo info{config_.scope_,
+    Http::CodeStats::ResponseTimingInfo info{config_.vclusterScope(),
                                              cluster_->statsScope(),
                                              EMPTY_STRING,
                                              response_time,
@@ -13,6 +13,7 @@
 #include "envoy/router/shadow_writer.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/server/filter_config.h"
+#include "envoy/singleton/instance.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/cluster_manager.h"
@@ -91,37 +92,56 @@ public:
                                   bool insert_envoy_expected_request_timeout_ms, bool grpc_request);
 };
 
+/**
+ * The evictable scope of the virtual host and virtual cluster stats, whose names come from route
+ * configuration, which may be replaced at runtime. It is shared by all the router filters of a
+ * server, so that a stat used by several of them has one object, which is the one reported.
+ */
+class VirtualClusterStatsScope : public Singleton::Instance {
+public:
+  VirtualClusterStatsScope(Stats::Scope& scope) : scope_(scope.createEvictableScope("")) {}
+
+  /**
+   * @return the scope of the server of the context, which is created on first use.
+   */
+  static std::shared_ptr<VirtualClusterStatsScope>
+  get(Server::Configuration::FactoryContext& context);
+
+  const Stats::ScopePtr scope_;
+};
+
+typedef std::shared_ptr<VirtualClusterStatsScope> VirtualClusterStatsScopeSharedPtr;
+
 /**
  * Configuration for the router filter.
  */
 class FilterConfig {
 public:
+  /**
+   * @param vcluster_scope supplies the scope of the virtual host and virtual cluster stats, which
+   *        must outlive the configuration.
+   */
   FilterConfig(const std::string& stat_prefix, const LocalInfo::LocalInfo& local_info,
-               Stats::Scope& scope, Upstream::ClusterManager& cm, Runtime::Loader& runtime,
-               Runtime::RandomGenerator& random, ShadowWriterPtr&& shadow_writer,
-               bool emit_dynamic_stats, bool start_child_span, bool suppress_envoy_headers,
-               TimeSource& time_source, Http::Context& http_context)
+               Stats::Scope& scope, Stats::Scope& vcluster_scope, Upstream::ClusterManager& cm,
+               Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+               ShadowWriterPtr&& shadow_writer, bool emit_dynamic_stats, bool start_child_span,
+               bool suppress_envoy_headers, TimeSource& time_source, Http::Context& http_context)
       : scope_(scope), local_info_(local_info), cm_(cm), runtime_(runtime),
         random_(random), stats_{ALL_ROUTER_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix))},
         emit_dynamic_stats_(emit_dynamic_stats), start_child_span_(start_child_span),
         suppress_envoy_headers_(suppress_envoy_headers), http_context_(http_context),
-        shadow_writer_(std::move(shadow_writer)), time_source_(time_source) {}
+        shadow_writer_(std::move(shadow_writer)), time_source_(time_source),
+        vcluster_scope_(vcluster_scope) {}
 
   FilterConfig(const std::string& stat_prefix, Server::Configuration::FactoryContext& context,
                ShadowWriterPtr&& shadow_writer,
                const envoy::config::filter::http::router::v2::Router& config)
-      : FilterConfig(stat_prefix, context.localInfo(), context.scope(), context.clusterManager(),
-                     context.runtime(), context.random(), std::move(shadow_writer),
-                     PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, dynamic_stats, true),
-                     config.start_child_span(), config.suppress_envoy_headers(),
-                     context.api().timeSource(), context.httpContext()) {
-    for (const auto& upstream_log : config.upstream_log()) {
-      upstream_logs_.push_back(AccessLog::AccessLogFactory::fromProto(upstream_log, context));
-    }
-  }
+      : FilterConfig(stat_prefix, context, std::move(shadow_writer), config,
+                     VirtualClusterStatsScope::get(context)) {}
 
   ShadowWriter& shadowWriter() { return *shadow_writer_; }
   TimeSource& timeSource() { return time_source_; }
+  Stats::Scope& vclusterScope() { return vcluster_scope_; }
 
   Stats::Scope& scope_;
   const LocalInfo::LocalInfo& local_info_;
@@ -136,8 +156,26 @@ public:
   Http::Context& http_context_;
 
 private:
+  FilterConfig(const std::string& stat_prefix, Server::Configuration::FactoryContext& context,
+               ShadowWriterPtr&& shadow_writer,
+               const envoy::config::filter::http::router::v2::Router& config,
+               VirtualClusterStatsScopeSharedPtr vcluster_stats_scope)
+      : FilterConfig(stat_prefix, context.localInfo(), context.scope(),
+                     *vcluster_stats_scope->scope_, context.clusterManager(), context.runtime(),
+                     context.random(), std::move(shadow_writer),
+                     PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, dynamic_stats, true),
+                     config.start_child_span(), config.suppress_envoy_headers(),
+                     context.api().timeSource(), context.httpContext()) {
+    vcluster_stats_scope_ = std::move(vcluster_stats_scope);
+    for (const auto& upstream_log : config.upstream_log()) {
+      upstream_logs_.push_back(AccessLog::AccessLogFactory::fromProto(upstream_log, context));
+    }
+  }
+
   ShadowWriterPtr shadow_writer_;
   TimeSource& time_source_;
+  Stats::Scope& vcluster_scope_;
+  VirtualClusterStatsScopeSharedPtr vcluster_stats_scope_;
 };
 
 typedef std::shared_ptr<FilterConfig> FilterConfigSharedPtr;
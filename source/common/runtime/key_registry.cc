@@ -0,0 +1,29 @@
+#include "common/runtime/key_registry.h"
+
+namespace Envoy {
+namespace Runtime {
+
+Key KeyRegistry::resolve(const std::string& name) {
+  absl::MutexLock lock(&mutex_);
+  auto it = indices_.find(name);
+  if (it != indices_.end()) {
+    return Key(names_[it->second], it->second);
+  }
+  const uint32_t index = names_.size();
+  names_.push_back(name);
+  indices_.emplace(name, index);
+  return Key(names_.back(), index);
+}
+
+std::vector<Key> KeyRegistry::keys() const {
+  absl::MutexLock lock(&mutex_);
+  std::vector<Key> keys;
+  keys.reserve(names_.size());
+  for (uint32_t i = 0; i < names_.size(); ++i) {
+    keys.emplace_back(names_[i], i);
+  }
+  return keys;
+}
+
+} // namespace Runtime
+} // namespace Envoy
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "envoy/runtime/runtime.h"
+
+#include "common/singleton/threadsafe_singleton.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Runtime {
+
+/**
+ * Process-wide registry that resolves runtime key names to dense indices. Snapshots index their
+ * values by these, so that hot paths can look up a value by Key without hashing its name. Names
+ * are never removed; they are bounded by the distinct runtime keys used by the configuration.
+ */
+class KeyRegistry {
+public:
+  /**
+   * Resolve a key name, registering it if this is its first use. This is thread safe, but is
+   * expected to be called at configuration time rather than per request.
+   * @param name supplies the name of the key.
+   * @return Key the key, which remains valid for the lifetime of the process.
+   */
+  Key resolve(const std::string& name);
+
+  /**
+   * @return std::vector<Key> all keys registered so far, ordered by index.
+   */
+  std::vector<Key> keys() const;
+
+private:
+  mutable absl::Mutex mutex_;
+  // A deque so that the names referenced by keys are never moved.
+  std::deque<std::string> names_ GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, uint32_t> indices_ GUARDED_BY(mutex_);
+};
+
+using KeyRegistrySingleton = ThreadSafeSingleton<KeyRegistry>;
+
+} // namespace Runtime
+} // namespace Envoy
@@ -25,6 +25,7 @@ namespace Runtime {
 constexpr const char* runtime_features[] = {
     // Enabled
     "envoy.reloadable_features.test_feature_true",
+    "envoy.reloadable_features.listener_in_place_filter_chain_update",
 };
 
 // This is a list of configuration fields which are disallowed by default in Envoy
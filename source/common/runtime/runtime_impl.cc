@@ -14,6 +14,7 @@
 #include "common/common/utility.h"
 #include "common/filesystem/directory.h"
 #include "common/protobuf/utility.h"
+#include "common/runtime/key_registry.h"
 #include "common/runtime/runtime_features.h"
 
 #include "absl/strings/match.h"
@@ -187,24 +188,16 @@ bool SnapshotImpl::runtimeFeatureEnabled(absl::string_view key) const {
 
 bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value,
                                   uint64_t random_value, uint64_t num_buckets) const {
-  return random_value % num_buckets < std::min(getInteger(key, default_value), num_buckets);
+  return featureEnabled(find(key), default_value, random_value, num_buckets);
 }
 
 bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value) const {
-  // Avoid PRNG if we know we don't need it.
-  uint64_t cutoff = std::min(getInteger(key, default_value), static_cast<uint64_t>(100));
-  if (cutoff == 0) {
-    return false;
-  } else if (cutoff == 100) {
-    return true;
-  } else {
-    return generator_.random() % 100 < cutoff;
-  }
+  return featureEnabled(find(key), default_value);
 }
 
 bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value,
                                   uint64_t random_value) const {
-  return featureEnabled(key, default_value, random_value, 100);
+  return featureEnabled(find(key), default_value, random_value, 100);
 }
 
 const std::string& SnapshotImpl::get(const std::string& key) const {
@@ -218,28 +211,96 @@ const std::string& SnapshotImpl::get(const std::string& key) const {
 
 bool SnapshotImpl::featureEnabled(const std::string& key,
                                   const envoy::type::FractionalPercent& default_value) const {
-  return featureEnabled(key, default_value, generator_.random());
+  return featureEnabled(find(key), default_value, generator_.random());
 }
 
 bool SnapshotImpl::featureEnabled(const std::string& key,
                                   const envoy::type::FractionalPercent& default_value,
                                   uint64_t random_value) const {
-  const auto& entry = values_.find(key);
+  return featureEnabled(find(key), default_value, random_value);
+}
+
+uint64_t SnapshotImpl::getInteger(const std::string& key, uint64_t default_value) const {
+  return getInteger(find(key), default_value);
+}
+
+bool SnapshotImpl::featureEnabled(const Key& key, uint64_t default_value) const {
+  return featureEnabled(find(key), default_value);
+}
+
+bool SnapshotImpl::featureEnabled(const Key& key, uint64_t default_value,
+                                  uint64_t random_value) const {
+  return featureEnabled(find(key), default_value, random_value, 100);
+}
+
+bool SnapshotImpl::featureEnabled(const Key& key, uint64_t default_value, uint64_t random_value,
+                                  uint64_t num_buckets) const {
+  return featureEnabled(find(key), default_value, random_value, num_buckets);
+}
+
+bool SnapshotImpl::featureEnabled(const Key& key,
+                                  const envoy::type::FractionalPercent& default_value) const {
+  return featureEnabled(find(key), default_value, generator_.random());
+}
+
+bool SnapshotImpl::featureEnabled(const Key& key,
+                                  const envoy::type::FractionalPercent& default_value,
+                                  uint64_t random_value) const {
+  return featureEnabled(find(key), default_value, random_value);
+}
+
+uint64_t SnapshotImpl::getInteger(const Key& key, uint64_t default_value) const {
+  return getInteger(find(key), default_value);
+}
+
+const Snapshot::Entry* SnapshotImpl::find(const std::string& key) const {
+  auto entry = values_.find(key);
+  return entry == values_.end() ? nullptr : &entry->second;
+}
+
+const Snapshot::Entry* SnapshotImpl::find(const Key& key) const {
+  if (key.index() < indexed_values_.size()) {
+    return indexed_values_[key.index()];
+  }
+  // The key was registered after this snapshot was created.
+  return find(key.name());
+}
+
+bool SnapshotImpl::featureEnabled(const Entry* entry, uint64_t default_value) const {
+  // Avoid PRNG if we know we don't need it.
+  uint64_t cutoff = std::min(getInteger(entry, default_value), static_cast<uint64_t>(100));
+  if (cutoff == 0) {
+    return false;
+  } else if (cutoff == 100) {
+    return true;
+  } else {
+    return generator_.random() % 100 < cutoff;
+  }
+}
+
+bool SnapshotImpl::featureEnabled(const Entry* entry, uint64_t default_value,
+                                  uint64_t random_value, uint64_t num_buckets) const {
+  return random_value % num_buckets < std::min(getInteger(entry, default_value), num_buckets);
+}
+
+bool SnapshotImpl::featureEnabled(const Entry* entry,
+                                  const envoy::type::FractionalPercent& default_value,
+                                  uint64_t random_value) const {
   envoy::type::FractionalPercent percent;
-  if (entry != values_.end() && entry->second.fractional_percent_value_.has_value()) {
-    percent = entry->second.fractional_percent_value_.value();
-  } else if (entry != values_.end() && entry->second.uint_value_.has_value()) {
+  if (entry != nullptr && entry->fractional_percent_value_.has_value()) {
+    percent = entry->fractional_percent_value_.value();
+  } else if (entry != nullptr && entry->uint_value_.has_value()) {
     // Check for > 100 because the runtime value is assumed to be specified as
     // an integer, and it also ensures that truncating the uint64_t runtime
     // value into a uint32_t percent numerator later is safe
-    if (entry->second.uint_value_.value() > 100) {
+    if (entry->uint_value_.value() > 100) {
       return true;
     }
 
     // The runtime value was specified as an integer rather than a fractional
     // percent proto. To preserve legacy semantics, we treat it as a percentage
     // (i.e. denominator of 100).
-    percent.set_numerator(entry->second.uint_value_.value());
+    percent.set_numerator(entry->uint_value_.value());
     percent.set_denominator(envoy::type::FractionalPercent::HUNDRED);
   } else {
     percent = default_value;
@@ -248,12 +309,11 @@ bool SnapshotImpl::featureEnabled(const std::string& key,
   return ProtobufPercentHelper::evaluateFractionalPercent(percent, random_value);
 }
 
-uint64_t SnapshotImpl::getInteger(const std::string& key, uint64_t default_value) const {
-  auto entry = values_.find(key);
-  if (entry == values_.end() || !entry->second.uint_value_) {
+uint64_t SnapshotImpl::getInteger(const Entry* entry, uint64_t default_value) {
+  if (entry == nullptr || !entry->uint_value_) {
     return default_value;
   } else {
-    return entry->second.uint_value_.value();
+    return entry->uint_value_.value();
   }
 }
 
@@ -280,6 +340,12 @@ SnapshotImpl::SnapshotImpl(RandomGenerator& generator, RuntimeStats& stats,
     }
   }
   stats.num_keys_.set(values_.size());
+
+  const std::vector<Key> keys = KeyRegistrySingleton::get().keys();
+  indexed_values_.reserve(keys.size());
+  for (const Key& key : keys) {
+    indexed_values_.push_back(find(key.name()));
+  }
 }
 
 SnapshotImpl::Entry SnapshotImpl::createEntry(const std::string& value) {
@@ -86,6 +86,16 @@ public:
                       uint64_t random_value) const override;
   const std::string& get(const std::string& key) const override;
   uint64_t getInteger(const std::string& key, uint64_t default_value) const override;
+  bool featureEnabled(const Key& key, uint64_t default_value) const override;
+  bool featureEnabled(const Key& key, uint64_t default_value,
+                      uint64_t random_value) const override;
+  bool featureEnabled(const Key& key, uint64_t default_value, uint64_t random_value,
+                      uint64_t num_buckets) const override;
+  bool featureEnabled(const Key& key,
+                      const envoy::type::FractionalPercent& default_value) const override;
+  bool featureEnabled(const Key& key, const envoy::type::FractionalPercent& default_value,
+                      uint64_t random_value) const override;
+  uint64_t getInteger(const Key& key, uint64_t default_value) const override;
   const std::vector<OverrideLayerConstPtr>& getLayers() const override;
 
   static Entry createEntry(const std::string& value);
@@ -105,12 +115,25 @@ private:
     parseEntryFractionalPercentValue(entry);
   }
 
+  const Entry* find(const std::string& key) const;
+  const Entry* find(const Key& key) const;
+  bool featureEnabled(const Entry* entry, uint64_t default_value) const;
+  bool featureEnabled(const Entry* entry, uint64_t default_value, uint64_t random_value,
+                      uint64_t num_buckets) const;
+  bool featureEnabled(const Entry* entry, const envoy::type::FractionalPercent& default_value,
+                      uint64_t random_value) const;
+  static uint64_t getInteger(const Entry* entry, uint64_t default_value);
+
   static bool parseEntryBooleanValue(Entry& entry);
   static bool parseEntryUintValue(Entry& entry);
   static void parseEntryFractionalPercentValue(Entry& entry);
 
   const std::vector<OverrideLayerConstPtr> layers_;
   EntryMap values_;
+  // The entries of the keys registered when the snapshot was created, indexed by Key::index(), or
+  // nullptr for keys without a value. values_ is not modified after construction, so the entries
+  // are stable.
+  std::vector<const Entry*> indexed_values_;
   RandomGenerator& generator_;
   RuntimeStats& stats_;
 };
@@ -19,7 +19,6 @@
 #include "common/common/utility.h"
 #include "common/stats/symbol_table_impl.h"
 
-#include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 
 namespace Envoy {
@@ -106,15 +105,30 @@ public:
   void free(const StatName&) override {}
   void incRefCount(const StatName&) override {}
   StoragePtr encode(absl::string_view name) override { return encodeHelper(name); }
-  SymbolTable::StoragePtr join(const std::vector<StatName>& names) const override {
-    std::vector<absl::string_view> strings;
+  SymbolTable::StoragePtr join(const StatNameVec& names) const override {
+    // Stores join scope prefixes to stat names on every lookup, so the joined
+    // name is written straight into its storage rather than via a std::string.
+    uint64_t num_bytes = 0;
     for (StatName name : names) {
-      absl::string_view str = toStringView(name);
-      if (!str.empty()) {
-        strings.push_back(str);
+      const uint64_t size = name.dataSize();
+      if (size != 0) {
+        num_bytes += (num_bytes == 0 ? 0 : 1) + size;
       }
     }
-    return encodeHelper(absl::StrJoin(strings, "."));
+    auto bytes = std::make_unique<Storage>(num_bytes + StatNameSizeEncodingBytes);
+    uint8_t* p = SymbolTableImpl::writeLengthReturningNext(num_bytes, bytes.get());
+    const uint8_t* const start = p;
+    for (StatName name : names) {
+      const uint64_t size = name.dataSize();
+      if (size != 0) {
+        if (p != start) {
+          *p++ = '.';
+        }
+        memcpy(p, name.data(), size);
+        p += size;
+      }
+    }
+    return bytes;
   }
 
 #ifndef ENVOY_CONFIG_COVERAGE
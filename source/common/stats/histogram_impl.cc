@@ -58,6 +58,32 @@ std::string HistogramStatisticsImpl::bucketSummary() const {
   return absl::StrJoin(bucket_summary, ", ");
 }
 
+std::string parentHistogramQuantileSummary(const HistogramStatistics& interval_statistics,
+                                           const HistogramStatistics& cumulative_statistics) {
+  std::vector<std::string> summary;
+  const std::vector<double>& supported_quantiles_ref = interval_statistics.supportedQuantiles();
+  summary.reserve(supported_quantiles_ref.size());
+  for (size_t i = 0; i < supported_quantiles_ref.size(); ++i) {
+    summary.push_back(fmt::format("P{}({},{})", 100 * supported_quantiles_ref[i],
+                                  interval_statistics.computedQuantiles()[i],
+                                  cumulative_statistics.computedQuantiles()[i]));
+  }
+  return absl::StrJoin(summary, " ");
+}
+
+std::string parentHistogramBucketSummary(const HistogramStatistics& interval_statistics,
+                                         const HistogramStatistics& cumulative_statistics) {
+  std::vector<std::string> bucket_summary;
+  const std::vector<double>& supported_buckets = interval_statistics.supportedBuckets();
+  bucket_summary.reserve(supported_buckets.size());
+  for (size_t i = 0; i < supported_buckets.size(); ++i) {
+    bucket_summary.push_back(fmt::format("B{}({},{})", supported_buckets[i],
+                                         interval_statistics.computedBuckets()[i],
+                                         cumulative_statistics.computedBuckets()[i]));
+  }
+  return absl::StrJoin(bucket_summary, " ");
+}
+
 /**
  * Clears the old computed values and refreshes it with values computed from passed histogram.
  */
@@ -79,5 +105,20 @@ void HistogramStatisticsImpl::refresh(const histogram_t* new_histogram_ptr) {
   }
 }
 
+void HistogramStatisticsImpl::refresh(const LogLinearHistogram& histogram) {
+  ASSERT(supportedQuantiles().size() == computed_quantiles_.size());
+  histogram.quantiles(supportedQuantiles(), computed_quantiles_);
+
+  sample_count_ = histogram.sampleCount();
+  sample_sum_ = histogram.sampleSum();
+
+  computed_buckets_.clear();
+  const std::vector<double>& supported_buckets = supportedBuckets();
+  computed_buckets_.reserve(supported_buckets.size());
+  for (const auto bucket : supported_buckets) {
+    computed_buckets_.emplace_back(histogram.countBelow(bucket));
+  }
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -8,6 +8,7 @@
 #include "envoy/stats/store.h"
 
 #include "common/common/non_copyable.h"
+#include "common/stats/log_linear_histogram.h"
 #include "common/stats/metric_impl.h"
 
 #include "circllhist.h"
@@ -16,11 +17,13 @@ namespace Envoy {
 namespace Stats {
 
 /**
- * Implementation of HistogramStatistics for circllhist.
+ * Implementation of HistogramStatistics for circllhist and LogLinearHistogram.
  */
 class HistogramStatisticsImpl : public HistogramStatistics, NonCopyable {
 public:
-  HistogramStatisticsImpl() : computed_quantiles_(supportedQuantiles().size(), 0.0) {}
+  HistogramStatisticsImpl()
+      : computed_quantiles_(supportedQuantiles().size(), 0.0),
+        computed_buckets_(supportedBuckets().size(), 0), sample_count_(0), sample_sum_(0) {}
   /**
    * HistogramStatisticsImpl object is constructed using the passed in histogram.
    * @param histogram_ptr pointer to the histogram for which stats will be calculated. This pointer
@@ -28,7 +31,18 @@ public:
    */
   HistogramStatisticsImpl(const histogram_t* histogram_ptr);
 
+  /**
+   * HistogramStatisticsImpl object is constructed as a copy of the computed values of the passed
+   * in statistics, which must have the same supported quantiles and buckets.
+   * @param statistics the statistics to copy.
+   */
+  explicit HistogramStatisticsImpl(const HistogramStatistics& statistics)
+      : computed_quantiles_(statistics.computedQuantiles()),
+        computed_buckets_(statistics.computedBuckets()), sample_count_(statistics.sampleCount()),
+        sample_sum_(statistics.sampleSum()) {}
+
   void refresh(const histogram_t* new_histogram_ptr);
+  void refresh(const LogLinearHistogram& histogram);
 
   // HistogramStatistics
   std::string quantileSummary() const override;
@@ -47,6 +61,20 @@ private:
   double sample_sum_;
 };
 
+/**
+ * @return the quantile summary of a parent histogram, with the interval and cumulative value of
+ *         each quantile.
+ */
+std::string parentHistogramQuantileSummary(const HistogramStatistics& interval_statistics,
+                                           const HistogramStatistics& cumulative_statistics);
+
+/**
+ * @return the bucket summary of a parent histogram, with the interval and cumulative count of
+ *         each bucket.
+ */
+std::string parentHistogramBucketSummary(const HistogramStatistics& interval_statistics,
+                                         const HistogramStatistics& cumulative_statistics);
+
 /**
  * Histogram implementation for the heap.
  */
@@ -58,7 +86,6 @@ public:
 
   // Stats:;Metric
   std::string name() const override { return name_; }
-  const char* nameCStr() const override { return name_.c_str(); }
 
   // Stats::Histogram
   void recordValue(uint64_t value) override { parent_.deliverHistogramToSinks(*this, value); }
@@ -81,7 +108,6 @@ public:
   NullHistogramImpl() {}
   ~NullHistogramImpl() {}
   std::string name() const override { return ""; }
-  const char* nameCStr() const override { return ""; }
   const std::string& tagExtractedName() const override { CONSTRUCT_ON_FIRST_USE(std::string, ""); }
   const std::vector<Tag>& tags() const override { CONSTRUCT_ON_FIRST_USE(std::vector<Tag>, {}); }
   void recordValue(uint64_t) override {}
@@ -24,23 +24,42 @@ IsolatedStoreImpl::IsolatedStoreImpl(std::unique_ptr<SymbolTable>&& symbol_table
 
 IsolatedStoreImpl::IsolatedStoreImpl(SymbolTable& symbol_table)
     : StoreImpl(symbol_table), alloc_(symbol_table),
-      counters_([this](const std::string& name) -> CounterSharedPtr {
-        std::string tag_extracted_name = name;
-        std::vector<Tag> tags;
-        return alloc_.makeCounter(name, std::move(tag_extracted_name), std::move(tags));
-      }),
-      gauges_([this](const std::string& name) -> GaugeSharedPtr {
-        std::string tag_extracted_name = name;
-        std::vector<Tag> tags;
-        return alloc_.makeGauge(name, std::move(tag_extracted_name), std::move(tags));
-      }),
-      histograms_([this](const std::string& name) -> HistogramSharedPtr {
-        return std::make_shared<HistogramImpl>(name, *this, std::string(name), std::vector<Tag>());
-      }) {}
+      counters_(
+          [this](StatName stat_name) -> CounterSharedPtr {
+            std::string name = symbolTable().toString(stat_name);
+            std::string tag_extracted_name = name;
+            std::vector<Tag> tags;
+            return alloc_.makeCounter(name, std::move(tag_extracted_name), std::move(tags));
+          },
+          symbol_table),
+      gauges_(
+          [this](StatName stat_name) -> GaugeSharedPtr {
+            std::string name = symbolTable().toString(stat_name);
+            std::string tag_extracted_name = name;
+            std::vector<Tag> tags;
+            return alloc_.makeGauge(name, std::move(tag_extracted_name), std::move(tags));
+          },
+          symbol_table),
+      histograms_(
+          [this](StatName stat_name) -> HistogramSharedPtr {
+            std::string name = symbolTable().toString(stat_name);
+            return std::make_shared<HistogramImpl>(name, *this, std::string(name),
+                                                   std::vector<Tag>());
+          },
+          symbol_table) {}
 
 ScopePtr IsolatedStoreImpl::createScope(const std::string& name) {
   return std::make_unique<ScopePrefixer>(name, *this);
 }
 
+std::vector<ScopeMemoryStats> IsolatedStoreImpl::scopeMemoryStats() const {
+  // The scopes of an isolated store only add a prefix, so all the stats are held by the store. The
+  // memory they use is not tracked.
+  ScopeMemoryStats stats;
+  stats.counters_ = counters_.size();
+  stats.gauges_ = gauges_.size();
+  return {stats};
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -16,31 +16,35 @@
 #include "common/stats/symbol_table_impl.h"
 #include "common/stats/utility.h"
 
-#include "absl/container/flat_hash_map.h"
-
 namespace Envoy {
 namespace Stats {
 
 /**
- * A stats cache template that is used by the isolated store.
+ * A stats cache template that is used by the isolated store. Stats are keyed by their symbolized
+ * names, which the cache owns.
  */
 template <class Base> class IsolatedStatsCache {
 public:
-  using Allocator = std::function<std::shared_ptr<Base>(const std::string& name)>;
+  using Allocator = std::function<std::shared_ptr<Base>(StatName name)>;
 
-  IsolatedStatsCache(Allocator alloc) : alloc_(alloc) {}
+  IsolatedStatsCache(Allocator alloc, SymbolTable& symbol_table)
+      : alloc_(alloc), symbol_table_(symbol_table) {}
+  ~IsolatedStatsCache() { names_.free(symbol_table_); }
 
-  Base& get(const std::string& name) {
+  Base& get(StatName name) {
     auto stat = stats_.find(name);
     if (stat != stats_.end()) {
       return *stat->second;
     }
 
     std::shared_ptr<Base> new_stat = alloc_(name);
-    stats_.emplace(name, new_stat);
+    stats_.emplace(names_.insert(StatNameStorage(name, symbol_table_)).first->statName(),
+                   new_stat);
     return *new_stat;
   }
 
+  size_t size() const { return stats_.size(); }
+
   std::vector<std::shared_ptr<Base>> toVector() const {
     std::vector<std::shared_ptr<Base>> vec;
     vec.reserve(stats_.size());
@@ -52,8 +56,10 @@ public:
   }
 
 private:
-  absl::flat_hash_map<std::string, std::shared_ptr<Base>> stats_;
+  StatNameHashMap<std::shared_ptr<Base>> stats_;
+  StatNameStorageSet names_;
   Allocator alloc_;
+  SymbolTable& symbol_table_;
 };
 
 class IsolatedStoreImpl : public StoreImpl {
@@ -62,12 +68,26 @@ public:
   explicit IsolatedStoreImpl(SymbolTable& symbol_table);
 
   // Stats::Scope
-  Counter& counter(const std::string& name) override { return counters_.get(name); }
+  Counter& counterFromStatName(StatName name) override { return counters_.get(name); }
+  Counter& counter(const std::string& name) override {
+    StatNameTempStorage storage(name, symbolTable());
+    return counterFromStatName(storage.statName());
+  }
   ScopePtr createScope(const std::string& name) override;
+  // Stats are never evicted from an isolated store.
+  ScopePtr createEvictableScope(const std::string& name) override { return createScope(name); }
   void deliverHistogramToSinks(const Histogram&, uint64_t) override {}
-  Gauge& gauge(const std::string& name) override { return gauges_.get(name); }
+  Gauge& gaugeFromStatName(StatName name) override { return gauges_.get(name); }
+  Gauge& gauge(const std::string& name) override {
+    StatNameTempStorage storage(name, symbolTable());
+    return gaugeFromStatName(storage.statName());
+  }
   NullGaugeImpl& nullGauge(const std::string&) override { return null_gauge_; }
-  Histogram& histogram(const std::string& name) override { return histograms_.get(name); }
+  Histogram& histogramFromStatName(StatName name) override { return histograms_.get(name); }
+  Histogram& histogram(const std::string& name) override {
+    StatNameTempStorage storage(name, symbolTable());
+    return histogramFromStatName(storage.statName());
+  }
   const Stats::StatsOptions& statsOptions() const override { return stats_options_; }
 
   // Stats::Store
@@ -76,6 +96,7 @@ public:
   std::vector<ParentHistogramSharedPtr> histograms() const override {
     return std::vector<ParentHistogramSharedPtr>{};
   }
+  std::vector<ScopeMemoryStats> scopeMemoryStats() const override;
 
 private:
   IsolatedStoreImpl(std::unique_ptr<SymbolTable>&& symbol_table);
@@ -0,0 +1,128 @@
+#include "common/stats/log_linear_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Stats {
+
+LogLinearHistogram::LogLinearHistogram(uint32_t precision_bits)
+    : precision_bits_(precision_bits), sub_bucket_count_(uint64_t(1) << precision_bits),
+      chunks_(65 - precision_bits) {
+  ASSERT(precision_bits >= MinPrecisionBits && precision_bits <= MaxPrecisionBits);
+}
+
+uint64_t* LogLinearHistogram::allocateChunk(uint32_t chunk) {
+  chunks_[chunk] = std::make_unique<uint64_t[]>(sub_bucket_count_);
+  return chunks_[chunk].get();
+}
+
+void LogLinearHistogram::merge(const LogLinearHistogram& other) {
+  ASSERT(other.precision_bits_ == precision_bits_);
+  for (uint64_t mask = other.in_use_; mask != 0; mask &= mask - 1) {
+    const uint32_t chunk = __builtin_ctzll(mask);
+    const uint64_t* __restrict source = other.chunks_[chunk].get();
+    uint64_t* __restrict target = chunks_[chunk].get();
+    if (target == nullptr) {
+      target = allocateChunk(chunk);
+    }
+    // Chunks hold a multiple of four counts, and adding them four at a time lets the compiler use
+    // vector instructions even where it does not vectorize loops of unknown length.
+    for (uint64_t i = 0; i < sub_bucket_count_; i += 4) {
+      target[i] += source[i];
+      target[i + 1] += source[i + 1];
+      target[i + 2] += source[i + 2];
+      target[i + 3] += source[i + 3];
+    }
+  }
+  in_use_ |= other.in_use_;
+  sample_count_ += other.sample_count_;
+  sample_sum_ += other.sample_sum_;
+}
+
+void LogLinearHistogram::clear() {
+  for (uint64_t mask = in_use_; mask != 0; mask &= mask - 1) {
+    const uint32_t chunk = __builtin_ctzll(mask);
+    memset(chunks_[chunk].get(), 0, sub_bucket_count_ * sizeof(uint64_t));
+  }
+  in_use_ = 0;
+  sample_count_ = 0;
+  sample_sum_ = 0;
+}
+
+double LogLinearHistogram::quantile(double q) const {
+  std::vector<double> out;
+  quantiles({q}, out);
+  return out[0];
+}
+
+void LogLinearHistogram::quantiles(const std::vector<double>& quantiles,
+                                   std::vector<double>& out) const {
+  out.assign(quantiles.size(), std::numeric_limits<double>::quiet_NaN());
+  if (sample_count_ == 0) {
+    return;
+  }
+
+  size_t next = 0;
+  uint64_t cumulative = 0;
+  double highest = 0;
+  for (uint64_t mask = in_use_; mask != 0 && next < quantiles.size(); mask &= mask - 1) {
+    const uint32_t chunk = __builtin_ctzll(mask);
+    const uint64_t* counts = chunks_[chunk].get();
+    const uint64_t width = bucketWidth(chunk);
+    for (uint64_t offset = 0; offset < sub_bucket_count_ && next < quantiles.size(); ++offset) {
+      const uint64_t count = counts[offset];
+      if (count == 0) {
+        continue;
+      }
+      // The samples in a bucket are spread evenly over the integers it covers, so a bucket holding
+      // a single integer reports it exactly.
+      const double lower = bucketLowerBound(chunk, offset);
+      highest = lower + (width - 1);
+      while (next < quantiles.size() &&
+             quantiles[next] * sample_count_ <= static_cast<double>(cumulative + count)) {
+        const double fraction =
+            std::max(0.0, quantiles[next] * sample_count_ - cumulative) / count;
+        out[next++] = lower + (width - 1) * fraction;
+      }
+      cumulative += count;
+    }
+  }
+  // Only reachable for fractions above 1.
+  for (; next < quantiles.size(); ++next) {
+    out[next] = highest;
+  }
+}
+
+uint64_t LogLinearHistogram::countBelow(double threshold) const {
+  uint64_t below = 0;
+  for (uint64_t mask = in_use_; mask != 0; mask &= mask - 1) {
+    const uint32_t chunk = __builtin_ctzll(mask);
+    const uint64_t* counts = chunks_[chunk].get();
+    const uint64_t width = bucketWidth(chunk);
+    for (uint64_t offset = 0; offset < sub_bucket_count_; ++offset) {
+      const uint64_t count = counts[offset];
+      if (count == 0) {
+        continue;
+      }
+      const double lower = bucketLowerBound(chunk, offset);
+      if (lower >= threshold) {
+        return below;
+      }
+      const double integers_below = std::ceil(threshold) - lower;
+      if (integers_below >= width) {
+        below += count;
+      } else {
+        return below + static_cast<uint64_t>(count * integers_below / width);
+      }
+    }
+  }
+  return below;
+}
+
+} // namespace Stats
+} // namespace Envoy
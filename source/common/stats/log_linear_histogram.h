@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * A histogram of unsigned integer samples with a fixed log-linear bucket layout, in the style of
+ * HdrHistogram. Values below 2^(precision_bits+1) get a bucket each; above that, every power of
+ * two is split into 2^precision_bits equal-width buckets. The relative error of any reported
+ * quantile is therefore bounded by 2^-precision_bits.
+ *
+ * Buckets are grouped into one contiguous array of counts per power of two, allocated the first
+ * time a value in that range is recorded, so that a histogram only pays for the magnitudes it has
+ * seen. Because the layout depends only on the precision, merging two histograms is an
+ * element-wise add over the arrays that are in use, which compilers turn into vector instructions.
+ *
+ * The class is not thread safe. Histograms that are written on one thread and merged on another
+ * need the same double buffering that ThreadLocalHistogramImpl uses for circllhist.
+ */
+class LogLinearHistogram : NonCopyable {
+public:
+  static constexpr uint32_t MinPrecisionBits = 2;
+  static constexpr uint32_t MaxPrecisionBits = 10;
+
+  /**
+   * @param precision_bits number of significant bits kept for each value, which must be within
+   *        [MinPrecisionBits, MaxPrecisionBits].
+   */
+  explicit LogLinearHistogram(uint32_t precision_bits);
+
+  void recordValue(uint64_t value) {
+    uint32_t chunk;
+    uint64_t offset;
+    if (value < sub_bucket_count_) {
+      chunk = 0;
+      offset = value;
+    } else {
+      // The top precision_bits_ + 1 bits of the value select the bucket within the chunk for its
+      // power of two, dropping the leading one.
+      const uint32_t shift = 63 - __builtin_clzll(value) - precision_bits_;
+      chunk = shift + 1;
+      offset = (value >> shift) - sub_bucket_count_;
+    }
+    uint64_t* counts = chunks_[chunk].get();
+    if (counts == nullptr) {
+      counts = allocateChunk(chunk);
+    }
+    ++counts[offset];
+    in_use_ |= uint64_t(1) << chunk;
+    ++sample_count_;
+    sample_sum_ += value;
+  }
+
+  /**
+   * Adds all the samples of another histogram with the same precision to this one.
+   */
+  void merge(const LogLinearHistogram& other);
+
+  /**
+   * Resets all counts to zero. The bucket arrays are kept to be reused by the next interval.
+   */
+  void clear();
+
+  /**
+   * @return the value below which the given fraction of the samples fall, interpolated linearly
+   *         within the bucket that holds it, or NaN if there are no samples.
+   */
+  double quantile(double q) const;
+
+  /**
+   * Computes several quantiles in a single pass over the buckets.
+   * @param quantiles the fractions to compute, in ascending order.
+   * @param out receives one value per fraction, as computed by quantile().
+   */
+  void quantiles(const std::vector<double>& quantiles, std::vector<double>& out) const;
+
+  /**
+   * @return the approximate number of samples less than the given threshold. A bucket that
+   *         straddles the threshold contributes in proportion to the integers it covers below it.
+   */
+  uint64_t countBelow(double threshold) const;
+
+  uint64_t sampleCount() const { return sample_count_; }
+  uint64_t sampleSum() const { return sample_sum_; }
+  uint32_t precisionBits() const { return precision_bits_; }
+
+  /**
+   * @return the upper bound on the relative error of quantiles for the given precision.
+   */
+  static double maxRelativeError(uint32_t precision_bits) { return 1.0 / (1 << precision_bits); }
+
+private:
+  uint64_t* allocateChunk(uint32_t chunk);
+
+  // Chunk 0 holds [0, 2^p) and chunk 1 holds [2^p, 2^(p+1)), one value per bucket. Chunk c > 1
+  // holds [2^(p+c-1), 2^(p+c)) in buckets 2^(c-1) wide.
+  uint64_t bucketWidth(uint32_t chunk) const { return chunk == 0 ? 1 : uint64_t(1) << (chunk - 1); }
+  uint64_t bucketLowerBound(uint32_t chunk, uint64_t offset) const {
+    return chunk == 0 ? offset : (sub_bucket_count_ + offset) << (chunk - 1);
+  }
+
+  const uint32_t precision_bits_;
+  const uint64_t sub_bucket_count_;
+  // One bit per chunk that may hold non-zero counts.
+  uint64_t in_use_{};
+  uint64_t sample_count_{};
+  uint64_t sample_sum_{};
+  std::vector<std::unique_ptr<uint64_t[]>> chunks_;
+};
+
+} // namespace Stats
+} // namespace Envoy
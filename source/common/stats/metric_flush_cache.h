@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/stats/stats.h"
+
+#include "common/common/non_copyable.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Per-metric state that a sink keeps from one flush to the next, e.g. text formatted from the
+ * metric's name and tags, or what was last sent for it. Entries are keyed by metric address; a
+ * weak pointer detects a metric that was freed and whose address was reused. Entries of metrics
+ * that were not seen during a flush are dropped at its end.
+ *
+ * Usage for each flush: beginFlush(), get() for every metric flushed, then endFlush(). Not thread
+ * safe.
+ */
+template <class Value> class MetricFlushCache : NonCopyable {
+public:
+  void beginFlush() {
+    ++flush_count_;
+    seen_this_flush_ = 0;
+  }
+
+  /**
+   * @param metric supplies the metric being flushed.
+   * @param is_new set to true if there was no entry for the metric, in which case the returned
+   *        value is default constructed and is expected to be filled in by the caller.
+   * @return Value& the entry for the metric, valid until the next endFlush() or clear().
+   */
+  Value& get(const std::shared_ptr<const Metric>& metric, bool& is_new) {
+    Entry& entry = entries_[metric.get()];
+    // The weak pointer has expired if the entry was left by a deleted metric at the same address.
+    is_new = entry.metric_.expired();
+    if (is_new) {
+      entry.metric_ = metric;
+      entry.value_ = Value();
+    }
+    if (entry.last_flush_ != flush_count_) {
+      entry.last_flush_ = flush_count_;
+      ++seen_this_flush_;
+    }
+    return entry.value_;
+  }
+
+  /**
+   * Drops the entries of metrics that were deleted or not seen since beginFlush(). After most
+   * flushes there are none, and the map is not walked.
+   */
+  void endFlush() {
+    if (entries_.size() == seen_this_flush_) {
+      return;
+    }
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (it->second.last_flush_ != flush_count_) {
+        entries_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  void clear() { entries_.clear(); }
+  size_t size() const { return entries_.size(); }
+
+private:
+  struct Entry {
+    std::weak_ptr<const Metric> metric_;
+    uint64_t last_flush_{};
+    Value value_{};
+  };
+
+  absl::flat_hash_map<const Metric*, Entry> entries_;
+  uint64_t flush_count_{};
+  uint64_t seen_this_flush_{};
+};
+
+} // namespace Stats
+} // namespace Envoy
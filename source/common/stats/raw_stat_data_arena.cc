@@ -0,0 +1,277 @@
+#include "common/stats/raw_stat_data_arena.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Stats {
+
+namespace {
+
+uint64_t roundUpMultipleNaturalAlignment(uint64_t val) {
+  const uint64_t multiple = alignof(RawStatData);
+  return (val + multiple - 1) & ~(multiple - 1);
+}
+
+uint64_t makeLocation(uint32_t segment, uint64_t offset) {
+  return (static_cast<uint64_t>(segment) << 32) | offset;
+}
+
+} // namespace
+
+RawStatDataArena::RawStatDataArena(uint64_t segment_size, bool init, SegmentMapper segment_mapper)
+    : segment_size_(segment_size), segment_mapper_(segment_mapper), scan_offset_(firstOffset(0)) {
+  if (segment_size_ % alignof(RawStatData) != 0 || segment_size_ < 2 * firstOffset(0) ||
+      segment_size_ > UINT32_MAX) {
+    throw EnvoyException(fmt::format("RawStatDataArena: invalid segment size {}", segment_size_));
+  }
+  uint8_t* segment = segment_mapper_(0, segment_size_, init);
+  if (segment == nullptr) {
+    throw EnvoyException("RawStatDataArena: unable to map the first segment");
+  }
+  segments_.push_back(segment);
+  Control& control = this->control();
+  if (init) {
+    control.segment_size_ = segment_size_;
+    control.num_segments_ = 1;
+    control.end_ = firstOffset(0);
+    control.generation_ = 0;
+    for (uint64_t& free_list : control.free_lists_) {
+      free_list = NoRecord;
+    }
+  } else if (control.segment_size_ != segment_size_) {
+    throw EnvoyException("RawStatDataArena: Incompatible memory block");
+  }
+  if (!sync()) {
+    throw EnvoyException("RawStatDataArena: unable to map all segments");
+  }
+}
+
+uint64_t RawStatDataArena::firstOffset(uint32_t segment) const {
+  return segment == 0 ? roundUpMultipleNaturalAlignment(sizeof(Control)) : 0;
+}
+
+uint64_t RawStatDataArena::maxRecordSize() const {
+  // Records that do not fit at the end of a segment are put in a new one, where they start at
+  // offset 0.
+  return segment_size_;
+}
+
+uint64_t RawStatDataArena::recordSize(uint64_t name_size) {
+  return sizeof(RecordHeader) + RawStatData::structSize(name_size);
+}
+
+uint32_t RawStatDataArena::freeList(uint64_t record_size) {
+  return std::min<uint64_t>(record_size / alignof(RawStatData), NumFreeLists - 1);
+}
+
+RawStatData& RawStatDataArena::dataOf(RecordHeader& header) {
+  return *reinterpret_cast<RawStatData*>(reinterpret_cast<uint8_t*>(&header) +
+                                         sizeof(RecordHeader));
+}
+
+RawStatDataArena::RecordHeader& RawStatDataArena::headerOf(RawStatData& data) {
+  return *reinterpret_cast<RecordHeader*>(reinterpret_cast<uint8_t*>(&data) -
+                                          sizeof(RecordHeader));
+}
+
+RawStatDataArena::RecordHeader& RawStatDataArena::recordAt(uint64_t location) const {
+  return *reinterpret_cast<RecordHeader*>(segments_[location >> 32] + (location & UINT32_MAX));
+}
+
+bool RawStatDataArena::sync() {
+  const Control& control = this->control();
+  while (segments_.size() < control.num_segments_) {
+    uint8_t* segment = segment_mapper_(segments_.size(), segment_size_, false);
+    if (segment == nullptr) {
+      return false;
+    }
+    segments_.push_back(segment);
+  }
+  if (generation_ != control.generation_) {
+    // A freed record has been reused by another process, and may hold a stat that is not indexed
+    // yet under a different name; start over.
+    index_.clear();
+    scan_segment_ = 0;
+    scan_offset_ = firstOffset(0);
+    generation_ = control.generation_;
+  }
+  indexNewRecords();
+  return true;
+}
+
+void RawStatDataArena::indexNewRecords() {
+  const Control& control = this->control();
+  while (true) {
+    const bool last = scan_segment_ + 1 == segments_.size();
+    const uint64_t end = last ? control.end_ : segment_size_;
+    while (scan_offset_ + sizeof(RecordHeader) <= end) {
+      RecordHeader& header = recordAt(makeLocation(scan_segment_, scan_offset_));
+      if (header.size_ == 0) {
+        break;
+      }
+      RawStatData& data = dataOf(header);
+      if (data.initialized()) {
+        index_.emplace(RawStatData::hash(data.key()), &data);
+      }
+      scan_offset_ += header.size_;
+    }
+    if (last) {
+      return;
+    }
+    ++scan_segment_;
+    scan_offset_ = firstOffset(scan_segment_);
+  }
+}
+
+RawStatDataArena::StatCreatedPair RawStatDataArena::insert(absl::string_view name) {
+  if (!sync()) {
+    ENVOY_LOG(warn, "unable to map all segments of the stats arena");
+    return {nullptr, false};
+  }
+
+  const uint64_t max_name_size =
+      maxRecordSize() - sizeof(RecordHeader) - sizeof(RawStatData) - alignof(RawStatData);
+  if (name.size() > max_name_size) {
+    ENVOY_LOG(warn,
+              "Statistic '{}' is too long with {} characters, it will be truncated to {} "
+              "characters",
+              name, name.size(), max_name_size);
+    name = name.substr(0, max_name_size);
+  }
+
+  const uint64_t hash = RawStatData::hash(name);
+  auto range = index_.equal_range(hash);
+  for (auto it = range.first; it != range.second;) {
+    RawStatData* data = it->second;
+    if (!data->initialized()) {
+      // Freed by another process.
+      it = index_.erase(it);
+    } else if (data->key() == name) {
+      return {data, false};
+    } else {
+      ++it;
+    }
+  }
+
+  const uint64_t size = recordSize(name.size());
+  RecordHeader* header = reuseRecord(size);
+  if (header == nullptr) {
+    header = appendRecord(size);
+    if (header == nullptr) {
+      return {nullptr, false};
+    }
+  }
+  RawStatData& data = dataOf(*header);
+  ASSERT(!data.initialized());
+  data.ref_count_ = 1;
+  memcpy(data.name_, name.data(), name.size());
+  data.name_[name.size()] = '\0';
+  index_.emplace(hash, &data);
+  return {&data, true};
+}
+
+RawStatDataArena::RecordHeader* RawStatDataArena::reuseRecord(uint64_t size) {
+  Control& control = this->control();
+  const uint32_t list = freeList(size);
+  // Records in the exact size lists all fit; the last list holds records of any larger size, and is
+  // searched for the first that fits.
+  uint64_t* prev = &control.free_lists_[list];
+  while (*prev != NoRecord) {
+    RecordHeader& header = recordAt(*prev);
+    if (header.size_ >= size) {
+      *prev = header.next_free_;
+      header.next_free_ = NoRecord;
+      // Other processes may have indexed this record under its previous name.
+      generation_ = ++control.generation_;
+      return &header;
+    }
+    prev = &header.next_free_;
+  }
+  return nullptr;
+}
+
+RawStatDataArena::RecordHeader* RawStatDataArena::appendRecord(uint64_t size) {
+  Control& control = this->control();
+  if (control.end_ + size > segment_size_) {
+    const uint32_t index = segments_.size();
+    uint8_t* segment = segment_mapper_(index, segment_size_, true);
+    if (segment == nullptr) {
+      ENVOY_LOG(warn, "unable to grow the stats arena to {} segments", index + 1);
+      return nullptr;
+    }
+    segments_.push_back(segment);
+    control.num_segments_ = segments_.size();
+    control.end_ = firstOffset(index);
+  }
+  const uint32_t segment = segments_.size() - 1;
+  RecordHeader& header = recordAt(makeLocation(segment, control.end_));
+  header.size_ = size;
+  header.segment_ = segment;
+  header.next_free_ = NoRecord;
+  control.end_ += size;
+  // The new record is indexed by insert(), so the scan skips it.
+  scan_segment_ = segment;
+  scan_offset_ = control.end_;
+  return &header;
+}
+
+void RawStatDataArena::remove(RawStatData& data) {
+  ASSERT(data.ref_count_ == 0);
+  auto range = index_.equal_range(RawStatData::hash(data.key()));
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == &data) {
+      index_.erase(it);
+      break;
+    }
+  }
+
+  RecordHeader& header = headerOf(data);
+  memset(static_cast<void*>(&data), 0, header.size_ - sizeof(RecordHeader));
+  Control& control = this->control();
+  const uint32_t list = freeList(header.size_);
+  header.next_free_ = control.free_lists_[list];
+  const uint64_t offset = reinterpret_cast<uint8_t*>(&header) - segments_[header.segment_];
+  control.free_lists_[list] = makeLocation(header.segment_, offset);
+}
+
+uint32_t RawStatDataArena::numSegments() const { return control().num_segments_; }
+
+std::string RawStatDataArena::version(uint64_t segment_size) {
+  return fmt::format("arena segment_size={} control={} record={}", segment_size, sizeof(Control),
+                     recordSize(0));
+}
+
+RawStatData* RawStatDataArenaAllocator::alloc(absl::string_view name) {
+  Thread::LockGuard lock(mutex_);
+  auto value_created = arena_.insert(name);
+  RawStatData* data = value_created.first;
+  if (data == nullptr) {
+    return nullptr;
+  }
+  if (!value_created.second) {
+    ++data->ref_count_;
+  }
+  return data;
+}
+
+void RawStatDataArenaAllocator::free(RawStatData& data) {
+  // As for RawStatDataAllocator, the decrement can race with an alloc() of the same name.
+  Thread::LockGuard lock(mutex_);
+  ASSERT(data.ref_count_ > 0);
+  if (--data.ref_count_ > 0) {
+    return;
+  }
+  arena_.remove(data);
+}
+
+} // namespace Stats
+} // namespace Envoy
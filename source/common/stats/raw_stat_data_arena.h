@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/stats/raw_stat_data.h"
+#include "common/stats/stat_data_allocator_impl.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * A growable arena of RawStatData with variable length names, suitable for shared memory. The
+ * arena is made of equally sized segments that are mapped by the caller and never move, so stats
+ * stay in place as the arena grows. The first segment starts with a control block recording the
+ * number of segments, so that a process attaching to the arena, e.g. after a hot restart, can map
+ * all of them.
+ *
+ * Stats are appended to the last segment, and freed stats are kept on free lists by size to be
+ * reused. Each process keeps a local index from names to stats, which it brings up to date with
+ * the stats added by other processes on each insert.
+ *
+ * Note that no locking of any kind is done by this class; as for BlockMemoryHashSet, this must be
+ * done at the call-site to support concurrent access.
+ */
+class RawStatDataArena : Logger::Loggable<Logger::Id::stats> {
+public:
+  /**
+   * Maps a segment of the arena.
+   * @param index supplies the index of the segment.
+   * @param size supplies the size of the segment in bytes.
+   * @param create true if the segment is new and should be created, false if it already exists.
+   * @return uint8_t* the memory of the segment, which must be aligned for RawStatData and
+   *         zero-filled when created, or nullptr if the segment could not be mapped.
+   */
+  using SegmentMapper = std::function<uint8_t*(uint32_t index, uint64_t size, bool create)>;
+
+  /** Type used by insert() to indicate the stat for a name, and whether it was created. */
+  using StatCreatedPair = std::pair<RawStatData*, bool>;
+
+  /**
+   * @param segment_size supplies the size of each segment in bytes.
+   * @param init true if the arena should be initialized, or false to attach to an existing arena.
+   *             An EnvoyException is thrown if the existing arena is incompatible.
+   * @param segment_mapper supplies the function that maps segments.
+   */
+  RawStatDataArena(uint64_t segment_size, bool init, SegmentMapper segment_mapper);
+
+  /**
+   * Find the stat for a name, or create one with a reference count of 1 if there is none. Names
+   * that would not fit in a segment are truncated.
+   * @param name supplies the name of the stat.
+   * @return StatCreatedPair the stat and whether it was created. The stat is nullptr if the arena
+   *         could not grow.
+   */
+  StatCreatedPair insert(absl::string_view name);
+
+  /**
+   * Remove a stat whose reference count has dropped to zero, so that its memory can be reused.
+   * @param data supplies the stat returned by insert().
+   */
+  void remove(RawStatData& data);
+
+  /**
+   * @return uint32_t the number of segments in the arena.
+   */
+  uint32_t numSegments() const;
+
+  /**
+   * @param segment_size supplies the size of each segment in bytes.
+   * @return std::string a string describing the layout of the arena, for hot restart versioning.
+   */
+  static std::string version(uint64_t segment_size);
+
+private:
+  static const uint32_t NumFreeLists = 64;
+  static const uint64_t NoRecord = UINT64_MAX;
+
+  struct Control {
+    uint64_t segment_size_;
+    uint32_t num_segments_;
+    uint32_t unused_;
+    // End of the records in the last segment.
+    uint64_t end_;
+    // Incremented whenever a freed record is reused, which invalidates the local indices.
+    uint64_t generation_;
+    // Freed records by size in units of alignof(RawStatData); the last list holds all larger ones.
+    uint64_t free_lists_[NumFreeLists];
+  };
+
+  // Precedes each RawStatData. A record of size 0 marks the end of the records in a segment, which
+  // relies on segments being zero-filled.
+  struct RecordHeader {
+    uint32_t size_;
+    uint32_t segment_;
+    uint64_t next_free_;
+  };
+
+  Control& control() const { return *reinterpret_cast<Control*>(segments_[0]); }
+  uint64_t firstOffset(uint32_t segment) const;
+  uint64_t maxRecordSize() const;
+  static uint64_t recordSize(uint64_t name_size);
+  static uint32_t freeList(uint64_t record_size);
+  static RawStatData& dataOf(RecordHeader& header);
+  static RecordHeader& headerOf(RawStatData& data);
+  // Locations are the segment index in the upper 32 bits and the offset in the lower ones.
+  RecordHeader& recordAt(uint64_t location) const;
+
+  // Maps the segments added and indexes the stats created by other processes. Returns false if a
+  // segment could not be mapped.
+  bool sync();
+  void indexNewRecords();
+  RecordHeader* reuseRecord(uint64_t size);
+  RecordHeader* appendRecord(uint64_t size);
+
+  const uint64_t segment_size_;
+  const SegmentMapper segment_mapper_;
+  std::vector<uint8_t*> segments_;
+  uint64_t generation_{};
+  uint32_t scan_segment_{};
+  uint64_t scan_offset_{};
+  // Stats by the hash of their names. Entries for stats freed by other processes are removed when
+  // they are found.
+  std::unordered_multimap<uint64_t, RawStatData*> index_;
+};
+
+/**
+ * Allocates RawStatData from a RawStatDataArena. Unlike RawStatDataAllocator, the number of stats
+ * and the length of their names are not bounded up front.
+ */
+class RawStatDataArenaAllocator : public StatDataAllocatorImpl<RawStatData> {
+public:
+  RawStatDataArenaAllocator(Thread::BasicLockable& mutex, RawStatDataArena& arena,
+                            SymbolTable& symbol_table)
+      : StatDataAllocatorImpl(symbol_table), mutex_(mutex), arena_(arena) {}
+
+  // StatDataAllocator
+  bool requiresBoundedStatNameSize() const override { return false; }
+  RawStatData* alloc(absl::string_view name) override;
+  void free(RawStatData& data) override;
+
+private:
+  Thread::BasicLockable& mutex_;
+  RawStatDataArena& arena_ GUARDED_BY(mutex_);
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -15,6 +15,10 @@ ScopePtr ScopePrefixer::createScope(const std::string& name) {
   return std::make_unique<ScopePrefixer>(prefix_ + name, scope_);
 }
 
+ScopePtr ScopePrefixer::createEvictableScope(const std::string& name) {
+  return scope_.createEvictableScope(prefix_ + name);
+}
+
 Counter& ScopePrefixer::counterFromStatName(StatName name) {
   return counter(symbolTable().toString(name));
 }
@@ -13,6 +13,7 @@ public:
 
   // Scope
   ScopePtr createScope(const std::string& name) override;
+  ScopePtr createEvictableScope(const std::string& name) override;
   Counter& counter(const std::string& name) override { return scope_.counter(prefix_ + name); }
   Gauge& gauge(const std::string& name) override { return scope_.gauge(prefix_ + name); }
   Histogram& histogram(const std::string& name) override {
@@ -1,5 +1,7 @@
 #include "common/stats/source_impl.h"
 
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace Envoy {
@@ -30,5 +32,43 @@ void SourceImpl::clearCache() {
   histograms_.reset();
 }
 
+CounterSnapshotImpl::CounterSnapshotImpl(CounterSharedPtr counter)
+    : counter_(std::move(counter)), used_(counter_->used()), delta_(counter_->latch()),
+      value_(counter_->value()) {}
+
+const std::string ParentHistogramSnapshotImpl::quantileSummary() const {
+  if (used()) {
+    return parentHistogramQuantileSummary(interval_statistics_, cumulative_statistics_);
+  } else {
+    return std::string("No recorded values");
+  }
+}
+
+const std::string ParentHistogramSnapshotImpl::bucketSummary() const {
+  if (used()) {
+    return parentHistogramBucketSummary(interval_statistics_, cumulative_statistics_);
+  } else {
+    return std::string("No recorded values");
+  }
+}
+
+SourceSnapshotImpl::SourceSnapshotImpl(Store& store) {
+  std::vector<CounterSharedPtr> counters = store.counters();
+  counters_.reserve(counters.size());
+  for (CounterSharedPtr& counter : counters) {
+    counters_.push_back(std::make_shared<CounterSnapshotImpl>(std::move(counter)));
+  }
+  std::vector<GaugeSharedPtr> gauges = store.gauges();
+  gauges_.reserve(gauges.size());
+  for (GaugeSharedPtr& gauge : gauges) {
+    gauges_.push_back(std::make_shared<GaugeSnapshotImpl>(std::move(gauge)));
+  }
+  std::vector<ParentHistogramSharedPtr> histograms = store.histograms();
+  histograms_.reserve(histograms.size());
+  for (ParentHistogramSharedPtr& histogram : histograms) {
+    histograms_.push_back(std::make_shared<ParentHistogramSnapshotImpl>(std::move(histogram)));
+  }
+}
+
 } // namespace Stats
 } // namespace Envoy
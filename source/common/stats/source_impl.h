@@ -1,9 +1,16 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
+#include "envoy/stats/histogram.h"
 #include "envoy/stats/source.h"
 #include "envoy/stats/stats.h"
 #include "envoy/stats/store.h"
 
+#include "common/common/assert.h"
+#include "common/stats/histogram_impl.h"
+
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -26,5 +33,122 @@ private:
   absl::optional<std::vector<ParentHistogramSharedPtr>> histograms_;
 };
 
+/**
+ * A read only copy of a counter, which keeps the value and the delta latched from the counter
+ * when it was constructed. Each call to latch() returns the same delta.
+ */
+class CounterSnapshotImpl : public Counter {
+public:
+  CounterSnapshotImpl(CounterSharedPtr counter);
+
+  // Stats::Metric
+  std::string name() const override { return counter_->name(); }
+  const std::vector<Tag>& tags() const override { return counter_->tags(); }
+  const std::string& tagExtractedName() const override { return counter_->tagExtractedName(); }
+  bool used() const override { return used_; }
+
+  // Stats::Counter
+  void add(uint64_t) override { NOT_REACHED_GCOVR_EXCL_LINE; }
+  void inc() override { NOT_REACHED_GCOVR_EXCL_LINE; }
+  uint64_t latch() override { return delta_; }
+  void reset() override { NOT_REACHED_GCOVR_EXCL_LINE; }
+  uint64_t value() const override { return value_; }
+
+private:
+  const CounterSharedPtr counter_;
+  const bool used_;
+  const uint64_t delta_;
+  const uint64_t value_;
+};
+
+/**
+ * A read only copy of a gauge, which keeps the value of the gauge when it was constructed.
+ */
+class GaugeSnapshotImpl : public Gauge {
+public:
+  GaugeSnapshotImpl(GaugeSharedPtr gauge)
+      : gauge_(std::move(gauge)), used_(gauge_->used()), value_(gauge_->value()) {}
+
+  // Stats::Metric
+  std::string name() const override { return gauge_->name(); }
+  const std::vector<Tag>& tags() const override { return gauge_->tags(); }
+  const std::string& tagExtractedName() const override { return gauge_->tagExtractedName(); }
+  bool used() const override { return used_; }
+
+  // Stats::Gauge
+  void add(uint64_t) override { NOT_REACHED_GCOVR_EXCL_LINE; }
+  void dec() override { NOT_REACHED_GCOVR_EXCL_LINE; }
+  void inc() override { NOT_REACHED_GCOVR_EXCL_LINE; }
+  void set(uint64_t) override { NOT_REACHED_GCOVR_EXCL_LINE; }
+  void sub(uint64_t) override { NOT_REACHED_GCOVR_EXCL_LINE; }
+  uint64_t value() const override { return value_; }
+
+private:
+  const GaugeSharedPtr gauge_;
+  const bool used_;
+  const uint64_t value_;
+};
+
+/**
+ * A read only copy of a parent histogram, which keeps the interval and cumulative statistics of
+ * the histogram when it was constructed, so that the histogram can be merged again while the copy
+ * is read.
+ */
+class ParentHistogramSnapshotImpl : public ParentHistogram {
+public:
+  ParentHistogramSnapshotImpl(ParentHistogramSharedPtr histogram)
+      : histogram_(std::move(histogram)), used_(histogram_->used()),
+        interval_statistics_(histogram_->intervalStatistics()),
+        cumulative_statistics_(histogram_->cumulativeStatistics()) {}
+
+  // Stats::Metric
+  std::string name() const override { return histogram_->name(); }
+  const std::vector<Tag>& tags() const override { return histogram_->tags(); }
+  const std::string& tagExtractedName() const override { return histogram_->tagExtractedName(); }
+  bool used() const override { return used_; }
+
+  // Stats::Histogram
+  void recordValue(uint64_t) override { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+  // Stats::ParentHistogram
+  void merge() override { NOT_REACHED_GCOVR_EXCL_LINE; }
+  const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
+  const HistogramStatistics& cumulativeStatistics() const override {
+    return cumulative_statistics_;
+  }
+  const std::string quantileSummary() const override;
+  const std::string bucketSummary() const override;
+
+private:
+  const ParentHistogramSharedPtr histogram_;
+  const bool used_;
+  const HistogramStatisticsImpl interval_statistics_;
+  const HistogramStatisticsImpl cumulative_statistics_;
+};
+
+/**
+ * A Source that captures the store's metrics and their values when it is constructed. Counters
+ * are latched once, so every sink that reads the snapshot sees the same deltas. It can be read on
+ * another thread while stats are updated, added to and removed from the store, and keeps the
+ * captured metrics alive until it is destroyed.
+ */
+class SourceSnapshotImpl : public Source {
+public:
+  SourceSnapshotImpl(Store& store);
+
+  // Stats::Source
+  std::vector<CounterSharedPtr>& cachedCounters() override { return counters_; }
+  std::vector<GaugeSharedPtr>& cachedGauges() override { return gauges_; }
+  std::vector<ParentHistogramSharedPtr>& cachedHistograms() override { return histograms_; }
+  void clearCache() override {}
+
+private:
+  std::vector<CounterSharedPtr> counters_;
+  std::vector<GaugeSharedPtr> gauges_;
+  std::vector<ParentHistogramSharedPtr> histograms_;
+};
+
+typedef std::shared_ptr<SourceSnapshotImpl> SourceSnapshotSharedPtr;
+
 } // namespace Stats
 } // namespace Envoy
@@ -77,7 +77,6 @@ public:
 
   // Stats::Metric
   std::string name() const override { return std::string(data_.name()); }
-  const char* nameCStr() const override { return data_.name(); }
 
   // Stats::Counter
   void add(uint64_t amount) override {
@@ -106,7 +105,6 @@ public:
   NullCounterImpl() {}
   ~NullCounterImpl() {}
   std::string name() const override { return ""; }
-  const char* nameCStr() const override { return ""; }
   const std::string& tagExtractedName() const override { CONSTRUCT_ON_FIRST_USE(std::string, ""); }
   const std::vector<Tag>& tags() const override { CONSTRUCT_ON_FIRST_USE(std::vector<Tag>, {}); }
   void add(uint64_t) override {}
@@ -129,7 +127,6 @@ public:
 
   // Stats::Metric
   std::string name() const override { return std::string(data_.name()); }
-  const char* nameCStr() const override { return data_.name(); }
 
   // Stats::Gauge
   virtual void add(uint64_t amount) override {
@@ -164,7 +161,6 @@ public:
   NullGaugeImpl() {}
   ~NullGaugeImpl() {}
   std::string name() const override { return ""; }
-  const char* nameCStr() const override { return ""; }
   const std::string& tagExtractedName() const override { CONSTRUCT_ON_FIRST_USE(std::string, ""); }
   const std::vector<Tag>& tags() const override { CONSTRUCT_ON_FIRST_USE(std::vector<Tag>, {}); }
   void add(uint64_t) override {}
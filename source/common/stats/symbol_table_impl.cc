@@ -347,7 +347,15 @@ void StatNameStorageSet::free(SymbolTable& symbol_table) {
   }
 }
 
-SymbolTable::StoragePtr SymbolTableImpl::join(const std::vector<StatName>& stat_names) const {
+void StatNameStorageSet::erase(StatName stat_name, SymbolTable& symbol_table) {
+  auto iter = hash_set_.find(stat_name);
+  if (iter != hash_set_.end()) {
+    auto storage = hash_set_.extract(iter);
+    storage.value().free(symbol_table);
+  }
+}
+
+SymbolTable::StoragePtr SymbolTableImpl::join(const StatNameVec& stat_names) const {
   uint64_t num_bytes = 0;
   for (StatName stat_name : stat_names) {
     num_bytes += stat_name.dataSize();
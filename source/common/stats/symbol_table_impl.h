@@ -132,7 +132,7 @@ public:
   bool lessThan(const StatName& a, const StatName& b) const override;
   void free(const StatName& stat_name) override;
   void incRefCount(const StatName& stat_name) override;
-  StoragePtr join(const std::vector<StatName>& stat_names) const override;
+  StoragePtr join(const StatNameVec& stat_names) const override;
   void populateList(const absl::string_view* names, uint32_t num_names,
                     StatNameList& list) override;
   StoragePtr encode(absl::string_view name) override;
@@ -537,6 +537,14 @@ public:
    */
   iterator find(StatName stat_name) { return hash_set_.find(stat_name); }
 
+  /**
+   * Removes a stat_name from the set, releasing its symbols. Nothing is done if it is not in the set.
+   *
+   * @param stat_name The stat_name to remove.
+   * @param symbol_table The symbol table that owns the symbols.
+   */
+  void erase(StatName stat_name, SymbolTable& symbol_table);
+
   /**
    * @return the end-marker.
    */
@@ -1,5 +1,6 @@
 #include "common/stats/tag_producer_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -7,10 +8,58 @@
 #include "common/common/utility.h"
 #include "common/stats/tag_extractor_impl.h"
 
+#include "absl/strings/match.h"
+
 namespace Envoy {
 namespace Stats {
 
-TagProducerImpl::TagProducerImpl(const envoy::config::metrics::v2::StatsConfig& config) {
+namespace {
+
+// The default tag regexes use the lookahead (?=\.), which RE2 doesn't support. Removing it
+// yields a regex that matches a superset of the names the original matches, which is all the
+// screening set needs: the extractor's own regex still decides whether and where the tag is.
+std::string regexForSet(const std::string& regex) {
+  constexpr absl::string_view lookahead = "(?=\\.)";
+  std::string result;
+  result.reserve(regex.size());
+  bool escaped = false;
+  bool in_class = false;
+  for (size_t i = 0; i < regex.size(); ++i) {
+    if (!escaped && !in_class && absl::StartsWith(absl::string_view(regex).substr(i), lookahead)) {
+      i += lookahead.size() - 1;
+      continue;
+    }
+    const char c = regex[i];
+    if (!escaped && c == '[') {
+      in_class = true;
+    } else if (!escaped && c == ']') {
+      in_class = false;
+    }
+    escaped = !escaped && c == '\\';
+    result.push_back(c);
+  }
+  return result;
+}
+
+re2::RE2::Options regexSetOptions() {
+  re2::RE2::Options options;
+  // Stat names are matched byte by byte, as std::regex does.
+  options.set_encoding(re2::RE2::Options::EncodingLatin1);
+  options.set_log_errors(false);
+  // The default 8MiB is shared by the program and the DFA of all the regexes of the set, which
+  // the DFA can exhaust on long stat names. Matching then fails, see produceTags().
+  options.set_max_mem(64 << 20);
+  return options;
+}
+
+} // namespace
+
+TagProducerImpl::TagProducerImpl(const envoy::config::metrics::v2::StatsConfig& config)
+    : regex_set_(std::make_unique<re2::RE2::Set>(regexSetOptions(), re2::RE2::UNANCHORED)) {
+  // The empty pattern matches every stat name, so that a failed match can be told apart from a
+  // stat name that no regex matches.
+  regex_set_->Add("", nullptr);
+
   // To check name conflict.
   reserveResources(config);
   std::unordered_set<std::string> names = addDefaultExtractors(config);
@@ -32,13 +81,15 @@ TagProducerImpl::TagProducerImpl(const envoy::config::metrics::v2::StatsConfig&
               "No regex specified for tag specifier and no default regex for name: '{}'", name));
         }
       } else {
-        addExtractor(Stats::TagExtractorImpl::createTagExtractor(name, tag_specifier.regex()));
+        addExtractor(Stats::TagExtractorImpl::createTagExtractor(name, tag_specifier.regex()),
+                     tag_specifier.regex());
       }
     } else if (tag_specifier.tag_value_case() ==
                envoy::config::metrics::v2::TagSpecifier::kFixedValue) {
       default_tags_.emplace_back(Stats::Tag{name, tag_specifier.fixed_value()});
     }
   }
+  compileRegexSet();
 }
 
 int TagProducerImpl::addExtractorsMatching(absl::string_view name) {
@@ -46,14 +97,21 @@ int TagProducerImpl::addExtractorsMatching(absl::string_view name) {
   for (const auto& desc : Config::TagNames::get().descriptorVec()) {
     if (desc.name_ == name) {
       addExtractor(
-          Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_));
+          Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_),
+          desc.regex_);
       ++num_found;
     }
   }
   return num_found;
 }
 
-void TagProducerImpl::addExtractor(TagExtractorPtr extractor) {
+void TagProducerImpl::addExtractor(TagExtractorPtr extractor, const std::string& regex) {
+  if (regex_set_ != nullptr) {
+    const int index = regex_set_->Add(regexForSet(regex), nullptr);
+    if (index >= 0) {
+      regex_set_index_[extractor.get()] = index;
+    }
+  }
   const absl::string_view prefix = extractor->prefixToken();
   if (prefix.empty()) {
     tag_extractors_without_prefix_.emplace_back(std::move(extractor));
@@ -62,6 +120,13 @@ void TagProducerImpl::addExtractor(TagExtractorPtr extractor) {
   }
 }
 
+void TagProducerImpl::compileRegexSet() {
+  if (regex_set_index_.empty() || !regex_set_->Compile()) {
+    regex_set_.reset();
+    regex_set_index_.clear();
+  }
+}
+
 void TagProducerImpl::forEachExtractorMatching(
     const std::string& stat_name, std::function<void(const TagExtractorPtr&)> f) const {
   IntervalSetImpl<size_t> remove_characters;
@@ -83,11 +148,20 @@ void TagProducerImpl::forEachExtractorMatching(
 std::string TagProducerImpl::produceTags(const std::string& metric_name,
                                          std::vector<Tag>& tags) const {
   tags.insert(tags.end(), default_tags_.begin(), default_tags_.end());
+  std::vector<int> matched;
+  // Match() only returns false if RE2 gave up, such as when the DFA ran out of memory, since the
+  // empty pattern always matches. The extractors then all run, as if there were no set.
+  const bool screen = regex_set_ != nullptr && regex_set_->Match(metric_name, &matched);
   IntervalSetImpl<size_t> remove_characters;
-  forEachExtractorMatching(
-      metric_name, [&remove_characters, &tags, &metric_name](const TagExtractorPtr& tag_extractor) {
-        tag_extractor->extractTag(metric_name, tags, remove_characters);
-      });
+  forEachExtractorMatching(metric_name, [this, screen, &matched, &remove_characters, &tags,
+                                         &metric_name](const TagExtractorPtr& tag_extractor) {
+    const auto index = regex_set_index_.find(tag_extractor.get());
+    if (screen && index != regex_set_index_.end() &&
+        std::find(matched.begin(), matched.end(), index->second) == matched.end()) {
+      return;
+    }
+    tag_extractor->extractTag(metric_name, tags, remove_characters);
+  });
   return StringUtil::removeCharacters(metric_name, remove_characters);
 }
 
@@ -102,7 +176,8 @@ TagProducerImpl::addDefaultExtractors(const envoy::config::metrics::v2::StatsCon
     for (const auto& desc : Config::TagNames::get().descriptorVec()) {
       names.emplace(desc.name_);
       addExtractor(
-          Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_));
+          Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_),
+          desc.regex_);
     }
   }
   return names;
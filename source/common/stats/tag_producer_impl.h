@@ -18,13 +18,16 @@
 #include "common/protobuf/protobuf.h"
 
 #include "absl/strings/string_view.h"
+#include "re2/set.h"
 
 namespace Envoy {
 namespace Stats {
 
 /**
  * Organizes a collection of TagExtractors so that stat-names can be processed without
- * iterating through all extractors.
+ * iterating through all extractors. The regexes of all extractors are also compiled into a
+ * single RE2::Set, which screens each stat name in one pass so that only the extractors whose
+ * regex can match the name run their own regex to extract the tag.
  */
 class TagProducerImpl : public TagProducer {
 public:
@@ -46,8 +49,15 @@ private:
    * Adds a TagExtractor to the collection of tags, tracking prefixes to help make
    * produceTags run efficiently by trying only extractors that have a chance to match.
    * @param extractor TagExtractorPtr the extractor to add.
+   * @param regex const std::string& the regex of the extractor, added to the screening set.
    */
-  void addExtractor(TagExtractorPtr extractor);
+  void addExtractor(TagExtractorPtr extractor, const std::string& regex);
+
+  /**
+   * Compiles the screening set once all extractors have been added. If the set can't be
+   * compiled, stat names aren't screened and every possibly-matching extractor runs.
+   */
+  void compileRegexSet();
 
   /**
    * Adds all default extractors matching the specified tag name. In this model,
@@ -100,6 +110,12 @@ private:
   std::unordered_map<absl::string_view, std::vector<TagExtractorPtr>, StringViewHash>
       tag_extractor_prefix_map_;
   std::vector<Tag> default_tags_;
+
+  // Matches the regexes of the extractors in a single pass over a stat name. Extractors whose
+  // regex RE2 can't compile, even with the lookaheads removed, are absent from the set and
+  // from regex_set_index_, and always run.
+  std::unique_ptr<re2::RE2::Set> regex_set_;
+  std::unordered_map<const TagExtractor*, int> regex_set_index_;
 };
 
 } // namespace Stats
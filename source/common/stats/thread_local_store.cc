@@ -5,6 +5,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <tuple>
 
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/sink.h"
@@ -16,7 +17,9 @@
 #include "common/stats/stats_matcher_impl.h"
 #include "common/stats/tag_producer_impl.h"
 
-#include "absl/strings/str_join.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
 
 namespace Envoy {
 namespace Stats {
@@ -44,21 +47,21 @@ void ThreadLocalStoreImpl::setStatsMatcher(StatsMatcherPtr&& stats_matcher) {
   // be no copies in TLS caches.
   Thread::LockGuard lock(lock_);
   for (ScopeImpl* scope : scopes_) {
-    removeRejectedStats(scope->central_cache_.counters_, deleted_counters_);
-    removeRejectedStats(scope->central_cache_.gauges_, deleted_gauges_);
-    removeRejectedStats(scope->central_cache_.histograms_, deleted_histograms_);
+    removeRejectedStats(scope->central_cache_->counters_, deleted_counters_);
+    removeRejectedStats(scope->central_cache_->gauges_, deleted_gauges_);
+    removeRejectedStats(scope->central_cache_->histograms_, deleted_histograms_);
   }
 }
 
 template <class StatMapClass, class StatListClass>
 void ThreadLocalStoreImpl::removeRejectedStats(StatMapClass& map, StatListClass& list) {
-  std::vector<const char*> remove_list;
+  std::vector<StatName> remove_list;
   for (auto& stat : map) {
-    if (rejects(stat.first)) {
+    if (rejects(symbolTable().toString(stat.first))) {
       remove_list.push_back(stat.first);
     }
   }
-  for (const char* stat_name : remove_list) {
+  for (StatName stat_name : remove_list) {
     auto iter = map.find(stat_name);
     ASSERT(iter != map.end());
     list.push_back(iter->second); // Save SharedPtr to the list to avoid invalidating refs to stat.
@@ -76,10 +79,10 @@ bool ThreadLocalStoreImpl::rejects(const std::string& name) const {
 std::vector<CounterSharedPtr> ThreadLocalStoreImpl::counters() const {
   // Handle de-dup due to overlapping scopes.
   std::vector<CounterSharedPtr> ret;
-  ConstCharStarHashSet names;
+  StatNameHashSet names;
   Thread::LockGuard lock(lock_);
   for (ScopeImpl* scope : scopes_) {
-    for (auto& counter : scope->central_cache_.counters_) {
+    for (auto& counter : scope->central_cache_->counters_) {
       if (names.insert(counter.first).second) {
         ret.push_back(counter.second);
       }
@@ -89,8 +92,8 @@ std::vector<CounterSharedPtr> ThreadLocalStoreImpl::counters() const {
   return ret;
 }
 
-ScopePtr ThreadLocalStoreImpl::createScope(const std::string& name) {
-  std::unique_ptr<ScopeImpl> new_scope(new ScopeImpl(*this, name));
+ScopePtr ThreadLocalStoreImpl::createScope(const std::string& name, bool evictable) {
+  std::unique_ptr<ScopeImpl> new_scope(new ScopeImpl(*this, name, evictable));
   Thread::LockGuard lock(lock_);
   scopes_.emplace(new_scope.get());
   return std::move(new_scope);
@@ -99,10 +102,10 @@ ScopePtr ThreadLocalStoreImpl::createScope(const std::string& name) {
 std::vector<GaugeSharedPtr> ThreadLocalStoreImpl::gauges() const {
   // Handle de-dup due to overlapping scopes.
   std::vector<GaugeSharedPtr> ret;
-  ConstCharStarHashSet names;
+  StatNameHashSet names;
   Thread::LockGuard lock(lock_);
   for (ScopeImpl* scope : scopes_) {
-    for (auto& gauge : scope->central_cache_.gauges_) {
+    for (auto& gauge : scope->central_cache_->gauges_) {
       if (names.insert(gauge.first).second) {
         ret.push_back(gauge.second);
       }
@@ -121,7 +124,7 @@ std::vector<ParentHistogramSharedPtr> ThreadLocalStoreImpl::histograms() const {
   // in histograms with duplicate names, but until shared storage is implemented it's ultimately
   // less confusing for users who have such configs.
   for (ScopeImpl* scope : scopes_) {
-    for (const auto& name_histogram_pair : scope->central_cache_.histograms_) {
+    for (const auto& name_histogram_pair : scope->central_cache_->histograms_) {
       const ParentHistogramSharedPtr& parent_hist = name_histogram_pair.second;
       ret.push_back(parent_hist);
     }
@@ -130,6 +133,25 @@ std::vector<ParentHistogramSharedPtr> ThreadLocalStoreImpl::histograms() const {
   return ret;
 }
 
+std::vector<ScopeMemoryStats> ThreadLocalStoreImpl::scopeMemoryStats() const {
+  std::vector<ScopeMemoryStats> ret;
+  Thread::LockGuard lock(lock_);
+  ret.reserve(scopes_.size());
+  for (ScopeImpl* scope : scopes_) {
+    const CentralCacheEntry& central_cache = *scope->central_cache_;
+    ScopeMemoryStats stats;
+    stats.prefix_ = scope->prefixString();
+    stats.counters_ = central_cache.counters_.size();
+    stats.gauges_ = central_cache.gauges_.size();
+    stats.histograms_ = central_cache.histograms_.size();
+    stats.bytes_ = central_cache.memoryBytes();
+    stats.evictable_ = scope->evictable_;
+    stats.evicted_ = central_cache.evicted_;
+    ret.push_back(std::move(stats));
+  }
+  return ret;
+}
+
 void ThreadLocalStoreImpl::initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                                                ThreadLocal::Instance& tls) {
   main_thread_dispatcher_ = &main_thread_dispatcher;
@@ -175,16 +197,161 @@ void ThreadLocalStoreImpl::mergeInternal(PostMergeCb merge_complete_cb) {
   }
 }
 
+void ThreadLocalStoreImpl::evictIdleStats(uint32_t idle_flushes) {
+  ASSERT(idle_flushes > 0);
+  if (shutting_down_) {
+    return;
+  }
+
+  std::vector<std::tuple<uint64_t, CentralCacheEntrySharedPtr, EvictedStatsSharedPtr>> evictions;
+  {
+    Thread::LockGuard lock(lock_);
+    for (ScopeImpl* scope : scopes_) {
+      if (!scope->evictable_) {
+        continue;
+      }
+      CentralCacheEntry& central_cache = *scope->central_cache_;
+      auto evicted = std::make_shared<EvictedStats>();
+      evictIdle(central_cache.counters_, central_cache.idle_counters_, idle_flushes, false,
+                evicted->counters_);
+      // A gauge keeps its value until it is changed, so only zero-valued gauges are evicted.
+      evictIdle(central_cache.gauges_, central_cache.idle_gauges_, idle_flushes, true,
+                evicted->gauges_);
+      evictIdleHistograms(central_cache, idle_flushes, evicted->histograms_);
+      if (!evicted->empty()) {
+        central_cache.evicted_ +=
+            evicted->counters_.size() + evicted->gauges_.size() + evicted->histograms_.size();
+        evictions.emplace_back(scope->scope_id_, scope->central_cache_, std::move(evicted));
+      }
+    }
+  }
+
+  for (auto& eviction : evictions) {
+    clearEvictedFromCaches(std::get<0>(eviction), std::move(std::get<1>(eviction)),
+                           std::move(std::get<2>(eviction)));
+  }
+}
+
+template <class StatType>
+void ThreadLocalStoreImpl::evictIdle(StatMap<std::shared_ptr<StatType>>& stats,
+                                     StatMap<IdleState>& idle_states, uint32_t idle_flushes,
+                                     bool keep_non_zero,
+                                     std::vector<EvictedStat<StatType>>& evicted) {
+  for (auto iter = stats.begin(); iter != stats.end();) {
+    const uint64_t value = iter->second->value();
+    auto idle = idle_states.try_emplace(iter->first, IdleState{value, 0});
+    IdleState& state = idle.first->second;
+    if (idle.second || value != state.value_ || (keep_non_zero && value != 0)) {
+      state.value_ = value;
+      state.idle_flushes_ = 0;
+      ++iter;
+    } else if (++state.idle_flushes_ < idle_flushes) {
+      ++iter;
+    } else {
+      // The name stays owned by the central cache until the TLS caches have dropped the stat.
+      idle_states.erase(idle.first);
+      evicted.push_back({iter->first, std::move(iter->second), value});
+      stats.erase(iter++);
+    }
+  }
+}
+
+void ThreadLocalStoreImpl::evictIdleHistograms(
+    CentralCacheEntry& central_cache, uint32_t idle_flushes,
+    std::vector<EvictedStat<ParentHistogramImpl>>& evicted) {
+  // Histograms are merged before the sinks are flushed, so the interval statistics hold the
+  // samples of the last flush interval.
+  auto& histograms = central_cache.histograms_;
+  for (auto iter = histograms.begin(); iter != histograms.end();) {
+    const uint64_t samples = iter->second->intervalStatistics().sampleCount();
+    auto idle = central_cache.idle_histograms_.try_emplace(iter->first, IdleState{samples, 0});
+    IdleState& state = idle.first->second;
+    if (samples > 0) {
+      state.idle_flushes_ = 0;
+      ++iter;
+    } else if (++state.idle_flushes_ < idle_flushes) {
+      ++iter;
+    } else {
+      // The histogram owns its name, which keys the idle state, so the state goes first.
+      central_cache.idle_histograms_.erase(idle.first);
+      evicted.push_back({iter->first, std::move(iter->second), 0});
+      histograms.erase(iter++);
+    }
+  }
+}
+
+void ThreadLocalStoreImpl::clearEvictedFromCaches(uint64_t scope_id,
+                                                  CentralCacheEntrySharedPtr central_cache,
+                                                  EvictedStatsSharedPtr evicted) {
+  if (tls_ == nullptr) {
+    completeEviction(*central_cache, *evicted);
+    return;
+  }
+
+  // As when a scope is released, the stats are first removed from the central cache and then from
+  // the TLS caches, so that no thread can put them back in its TLS cache afterwards.
+  tls_->runOnAllThreads(
+      [this, scope_id, central_cache, evicted]() -> void {
+        auto& scope_cache = tls_->getTyped<TlsCache>().scope_cache_;
+        auto iter = scope_cache.find(scope_id);
+        if (iter == scope_cache.end()) {
+          return;
+        }
+        TlsCacheEntry& entry = iter->second;
+        uint64_t erased = 0;
+        for (const EvictedStat<Counter>& counter : evicted->counters_) {
+          erased += entry.counters_.erase(counter.name_);
+        }
+        for (const EvictedStat<Gauge>& gauge : evicted->gauges_) {
+          erased += entry.gauges_.erase(gauge.name_);
+        }
+        for (const EvictedStat<ParentHistogramImpl>& histogram : evicted->histograms_) {
+          erased += entry.parent_histograms_.erase(histogram.name_);
+          erased += entry.histograms_.erase(histogram.name_);
+        }
+        central_cache->tls_entries_ -= erased;
+      },
+      [this, central_cache, evicted]() -> void { completeEviction(*central_cache, *evicted); });
+}
+
+void ThreadLocalStoreImpl::completeEviction(CentralCacheEntry& central_cache,
+                                            EvictedStats& evicted) {
+  Thread::LockGuard lock(lock_);
+  // A counter or gauge changed by a thread between the eviction pass and the removal from its TLS
+  // cache is put back, so that the change is flushed, unless it was looked up again meanwhile.
+  for (const EvictedStat<Counter>& counter : evicted.counters_) {
+    if (counter.stat_->value() != counter.value_ &&
+        central_cache.counters_.try_emplace(counter.name_, counter.stat_).second) {
+      --central_cache.evicted_;
+    }
+  }
+  for (const EvictedStat<Gauge>& gauge : evicted.gauges_) {
+    if (gauge.stat_->value() != gauge.value_ &&
+        central_cache.gauges_.try_emplace(gauge.name_, gauge.stat_).second) {
+      --central_cache.evicted_;
+    }
+  }
+  for (const EvictedStat<Counter>& counter : evicted.counters_) {
+    central_cache.releaseStatNameIfUnused(counter.name_);
+  }
+  for (const EvictedStat<Gauge>& gauge : evicted.gauges_) {
+    central_cache.releaseStatNameIfUnused(gauge.name_);
+  }
+}
+
 void ThreadLocalStoreImpl::releaseScopeCrossThread(ScopeImpl* scope) {
   Thread::LockGuard lock(lock_);
   ASSERT(scopes_.count(scope) == 1);
   scopes_.erase(scope);
 
   // This can happen from any thread. We post() back to the main thread which will initiate the
-  // cache flush operation.
+  // cache flush operation. The central cache goes along, as it owns the names that key the TLS
+  // caches.
   if (!shutting_down_ && main_thread_dispatcher_) {
     main_thread_dispatcher_->post(
-        [this, scope_id = scope->scope_id_]() -> void { clearScopeFromCaches(scope_id); });
+        [this, scope_id = scope->scope_id_, central_cache = scope->central_cache_]() -> void {
+          clearScopeFromCaches(scope_id, central_cache);
+        });
   }
 }
 
@@ -193,13 +360,16 @@ std::string ThreadLocalStoreImpl::getTagsForName(const std::string& name,
   return tag_producer_->produceTags(name, tags);
 }
 
-void ThreadLocalStoreImpl::clearScopeFromCaches(uint64_t scope_id) {
+void ThreadLocalStoreImpl::clearScopeFromCaches(uint64_t scope_id,
+                                                CentralCacheEntrySharedPtr central_cache) {
   // If we are shutting down we no longer perform cache flushes as workers may be shutting down
   // at the same time.
   if (!shutting_down_) {
-    // Perform a cache flush on all threads.
+    // Perform a cache flush on all threads, releasing the central cache only once no TLS cache
+    // references its names any more.
     tls_->runOnAllThreads(
-        [this, scope_id]() -> void { tls_->getTyped<TlsCache>().scope_cache_.erase(scope_id); });
+        [this, scope_id]() -> void { tls_->getTyped<TlsCache>().scope_cache_.erase(scope_id); },
+        [central_cache]() -> void { /* Holds onto central_cache until all done. */ });
   }
 }
 
@@ -214,61 +384,138 @@ absl::string_view ThreadLocalStoreImpl::truncateStatNameIfNeeded(absl::string_vi
   return name;
 }
 
+ThreadLocalStoreImpl::CentralCacheEntry::~CentralCacheEntry() {
+  stat_names_.free(symbol_table_);
+  rejected_stats_.free(symbol_table_);
+}
+
+StatName ThreadLocalStoreImpl::CentralCacheEntry::ownedStatName(StatName name) {
+  auto iter = stat_names_.find(name);
+  if (iter == stat_names_.end()) {
+    iter = stat_names_.insert(StatNameStorage(name, symbol_table_)).first;
+  }
+  return iter->statName();
+}
+
+void ThreadLocalStoreImpl::CentralCacheEntry::releaseStatNameIfUnused(StatName name) {
+  if (counters_.find(name) == counters_.end() && gauges_.find(name) == gauges_.end()) {
+    stat_names_.erase(name, symbol_table_);
+  }
+}
+
+namespace {
+
+// Approximates the heap memory used by the tag-extracted name and the tags of a stat.
+uint64_t tagBytes(const Metric& metric) {
+  uint64_t bytes = metric.tagExtractedName().size();
+  for (const Tag& tag : metric.tags()) {
+    bytes += sizeof(Tag) + tag.name_.size() + tag.value_.size();
+  }
+  return bytes;
+}
+
+} // namespace
+
+uint64_t ThreadLocalStoreImpl::CentralCacheEntry::memoryBytes() const {
+  // The entries of the maps and the TLS caches are counted at their slot size, and each stat at the
+  // size of its symbolized name plus that of its implementation. Counters and gauges are assumed to
+  // be heap allocated, with their data holding their full name as a string.
+  uint64_t bytes = 0;
+  for (const auto& counter : counters_) {
+    bytes += sizeof(decltype(counters_)::value_type) + counter.first.size() +
+             sizeof(CounterImpl<HeapStatData>) + sizeof(HeapStatData) +
+             counter.second->name().size() + 1 + tagBytes(*counter.second);
+  }
+  for (const auto& gauge : gauges_) {
+    bytes += sizeof(decltype(gauges_)::value_type) + gauge.first.size() +
+             sizeof(GaugeImpl<HeapStatData>) + sizeof(HeapStatData) + gauge.second->name().size() +
+             1 + tagBytes(*gauge.second);
+  }
+  for (const auto& histogram : histograms_) {
+    bytes += sizeof(decltype(histograms_)::value_type) + histogram.first.size() +
+             sizeof(ParentHistogramImpl) + tagBytes(*histogram.second);
+  }
+  bytes += stat_names_.size() * sizeof(StatNameStorage);
+  bytes += tls_entries_ * sizeof(StatMap<CounterSharedPtr>::value_type);
+  return bytes;
+}
+
 std::atomic<uint64_t> ThreadLocalStoreImpl::ScopeImpl::next_scope_id_;
 
-ThreadLocalStoreImpl::ScopeImpl::~ScopeImpl() { parent_.releaseScopeCrossThread(this); }
+ThreadLocalStoreImpl::ScopeImpl::ScopeImpl(ThreadLocalStoreImpl& parent, const std::string& prefix,
+                                           bool evictable)
+    : scope_id_(next_scope_id_++), parent_(parent), evictable_(evictable),
+      prefix_(absl::StripSuffix(Utility::sanitizeStatsName(prefix), "."), parent.symbolTable()),
+      prefix_joins_with_dot_(prefix.empty() || absl::EndsWith(prefix, ".")),
+      central_cache_(std::make_shared<CentralCacheEntry>(parent.symbolTable())) {}
+
+ThreadLocalStoreImpl::ScopeImpl::~ScopeImpl() {
+  parent_.releaseScopeCrossThread(this);
+  prefix_.free(symbolTable());
+}
+
+ScopePtr ThreadLocalStoreImpl::ScopeImpl::createScope(const std::string& name, bool evictable) {
+  return parent_.createScope(prefixString() + name, evictable);
+}
+
+std::string ThreadLocalStoreImpl::ScopeImpl::prefixString() const {
+  if (prefix_.statName().dataSize() == 0) {
+    return "";
+  }
+  return absl::StrCat(symbolTable().toString(prefix_.statName()),
+                      prefix_joins_with_dot_ ? "." : "");
+}
+
+StatName ThreadLocalStoreImpl::ScopeImpl::prefixName(StatName name, PrefixedNameStorage& storage) {
+  if (prefix_.statName().dataSize() == 0) {
+    return name;
+  }
+  if (prefix_joins_with_dot_) {
+    storage.joined_ = symbolTable().join({prefix_.statName(), name});
+    return StatName(storage.joined_.get());
+  }
+  // The prefix runs into the first token of the name, which takes a new symbol. This is the slow
+  // path, for the few scopes created without a trailing ".".
+  storage.concatenated_ = std::make_unique<StatNameTempStorage>(
+      absl::StrCat(symbolTable().toString(prefix_.statName()), symbolTable().toString(name)),
+      symbolTable());
+  return storage.concatenated_->statName();
+}
 
-bool ThreadLocalStoreImpl::checkAndRememberRejection(const std::string& name,
-                                                     SharedStringSet& central_rejected_stats,
-                                                     SharedStringSet* tls_rejected_stats) {
+bool ThreadLocalStoreImpl::checkAndRememberRejection(StatName name,
+                                                     StatNameStorageSet& central_rejected_stats,
+                                                     StatNameHashSet* tls_rejected_stats) {
   if (stats_matcher_->acceptsAll()) {
     return false;
   }
 
   auto iter = central_rejected_stats.find(name);
-  SharedString rejected_name;
-  if (iter != central_rejected_stats.end()) {
-    rejected_name = *iter;
-  } else {
-    if (rejects(name)) {
-      rejected_name = std::make_shared<std::string>(name);
-      central_rejected_stats.insert(rejected_name);
+  if (iter == central_rejected_stats.end()) {
+    if (!rejects(symbolTable().toString(name))) {
+      return false;
     }
+    iter = central_rejected_stats.insert(StatNameStorage(name, symbolTable())).first;
   }
-  if (rejected_name != nullptr) {
-    if (tls_rejected_stats != nullptr) {
-      tls_rejected_stats->insert(rejected_name);
-    }
-    return true;
+  if (tls_rejected_stats != nullptr) {
+    tls_rejected_stats->insert(iter->statName());
   }
-  return false;
+  return true;
 }
 
 template <class StatType>
 StatType& ThreadLocalStoreImpl::ScopeImpl::safeMakeStat(
-    const std::string& name, StatMap<std::shared_ptr<StatType>>& central_cache_map,
-    SharedStringSet& central_rejected_stats, MakeStatFn<StatType> make_stat,
-    StatMap<std::shared_ptr<StatType>>* tls_cache, SharedStringSet* tls_rejected_stats,
-    StatType& null_stat) {
+    StatName name, StatMap<std::shared_ptr<StatType>>& central_cache_map,
+    MakeStatFn<StatType> make_stat, StatMap<std::shared_ptr<StatType>>* tls_cache,
+    StatNameHashSet* tls_rejected_stats, StatType& null_stat) {
 
-  const char* stat_key = name.c_str();
-
-  // We do name-rejections on the full name, prior to truncation.
   if (tls_rejected_stats != nullptr &&
-      tls_rejected_stats->find(stat_key) != tls_rejected_stats->end()) {
+      tls_rejected_stats->find(name) != tls_rejected_stats->end()) {
     return null_stat;
   }
 
-  std::unique_ptr<std::string> truncation_buffer;
-  absl::string_view truncated_name = parent_.truncateStatNameIfNeeded(name);
-  if (truncated_name.size() < name.size()) {
-    truncation_buffer = std::make_unique<std::string>(std::string(truncated_name));
-    stat_key = truncation_buffer->c_str(); // must be nul-terminated.
-  }
-
   // If we have a valid cache entry, return it.
   if (tls_cache) {
-    auto pos = tls_cache->find(stat_key);
+    auto pos = tls_cache->find(name);
     if (pos != tls_cache->end()) {
       return *pos->second;
     }
@@ -277,27 +524,33 @@ StatType& ThreadLocalStoreImpl::ScopeImpl::safeMakeStat(
   // We must now look in the central store so we must be locked. We grab a reference to the
   // central store location. It might contain nothing. In this case, we allocate a new stat.
   Thread::LockGuard lock(parent_.lock_);
-  auto iter = central_cache_map.find(stat_key);
+  auto iter = central_cache_map.find(name);
   std::shared_ptr<StatType>* central_ref = nullptr;
+  StatName central_name;
   if (iter != central_cache_map.end()) {
     central_ref = &(iter->second);
-  } else if (parent_.checkAndRememberRejection(name, central_rejected_stats, tls_rejected_stats)) {
-    // Note that again we do the name-rejection lookup on the untruncated name.
+    central_name = iter->first;
+  } else if (parent_.checkAndRememberRejection(name, central_cache_->rejected_stats_,
+                                               tls_rejected_stats)) {
+    // We do name-rejections on the full name, prior to truncation.
     return null_stat;
   } else {
-    // If we had to truncate, warn now that we've missed all caches.
-    if (truncation_buffer != nullptr) {
+    // Only a stat that misses all caches needs its name elaborated as a string, for tag
+    // extraction and for the allocator.
+    const std::string name_str = symbolTable().toString(name);
+    const absl::string_view truncated_name = parent_.truncateStatNameIfNeeded(name_str);
+    if (truncated_name.size() < name_str.size()) {
       ENVOY_LOG_MISC(
           warn,
           "Statistic '{}' is too long with {} characters, it will be truncated to {} characters",
-          name, name.size(), truncation_buffer->size());
+          name_str, name_str.size(), truncated_name.size());
     }
 
     std::vector<Tag> tags;
 
     // Tag extraction occurs on the original, untruncated name so the extraction
     // can complete properly, even if the tag values are partially truncated.
-    std::string tag_extracted_name = parent_.getTagsForName(name, tags);
+    std::string tag_extracted_name = parent_.getTagsForName(name_str, tags);
     std::shared_ptr<StatType> stat =
         make_stat(parent_.alloc_, truncated_name, std::move(tag_extracted_name), std::move(tags));
     if (stat == nullptr) {
@@ -310,39 +563,35 @@ StatType& ThreadLocalStoreImpl::ScopeImpl::safeMakeStat(
                        std::move(tags));              // NOLINT(bugprone-use-after-move)
       ASSERT(stat != nullptr);
     }
-    central_ref = &central_cache_map[stat->nameCStr()];
+    central_name = central_cache_->ownedStatName(name);
+    central_ref = &central_cache_map[central_name];
     *central_ref = stat;
   }
 
-  // If we have a TLS cache, insert the stat.
+  // If we have a TLS cache, insert the stat, keyed by the name owned by the central cache.
   if (tls_cache) {
-    tls_cache->insert(std::make_pair((*central_ref)->nameCStr(), *central_ref));
+    tls_cache->insert(std::make_pair(central_name, *central_ref));
+    ++central_cache_->tls_entries_;
   }
 
   // Finally we return the reference.
   return **central_ref;
 }
 
-Counter& ThreadLocalStoreImpl::ScopeImpl::counter(const std::string& name) {
+Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatName(StatName name) {
   if (parent_.rejectsAll()) {
     return null_counter_;
   }
 
-  // Determine the final name based on the prefix and the passed name.
-  //
-  // Note that we can do map.find(final_name.c_str()), but we cannot do
-  // map[final_name.c_str()] as the char*-keyed maps would then save the pointer
-  // to a temporary, and address sanitization errors would follow. Instead we
-  // must do a find() first, using the value if it succeeds. If it fails, then
-  // after we construct the stat we can insert it into the required maps. This
-  // strategy costs an extra hash lookup for each miss, but saves time
-  // re-copying the string and significant memory overhead.
-  std::string final_name = prefix_ + name;
+  // Determine the final name based on the prefix and the passed name. This joins the symbolized
+  // names, so no string is built for a stat that is already cached.
+  PrefixedNameStorage final_name_storage;
+  const StatName final_name = prefixName(name, final_name_storage);
 
   // We now find the TLS cache. This might remain null if we don't have TLS
   // initialized currently.
   StatMap<CounterSharedPtr>* tls_cache = nullptr;
-  SharedStringSet* tls_rejected_stats = nullptr;
+  StatNameHashSet* tls_rejected_stats = nullptr;
   if (!parent_.shutting_down_ && parent_.tls_) {
     TlsCacheEntry& entry = parent_.tls_->getTyped<TlsCache>().scope_cache_[this->scope_id_];
     tls_cache = &entry.counters_;
@@ -350,7 +599,7 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counter(const std::string& name) {
   }
 
   return safeMakeStat<Counter>(
-      final_name, central_cache_.counters_, central_cache_.rejected_stats_,
+      final_name, central_cache_->counters_,
       [](StatDataAllocator& allocator, absl::string_view name, std::string&& tag_extracted_name,
          std::vector<Tag>&& tags) -> CounterSharedPtr {
         return allocator.makeCounter(name, std::move(tag_extracted_name), std::move(tags));
@@ -374,23 +623,18 @@ void ThreadLocalStoreImpl::ScopeImpl::deliverHistogramToSinks(const Histogram& h
   }
 }
 
-Gauge& ThreadLocalStoreImpl::ScopeImpl::gauge(const std::string& name) {
+Gauge& ThreadLocalStoreImpl::ScopeImpl::gaugeFromStatName(StatName name) {
   if (parent_.rejectsAll()) {
     return null_gauge_;
   }
 
-  // See comments in counter(). There is no super clean way (via templates or otherwise) to
-  // share this code so I'm leaving it largely duplicated for now.
-  //
-  // Note that we can do map.find(final_name.c_str()), but we cannot do
-  // map[final_name.c_str()] as the char*-keyed maps would then save the pointer to
-  // a temporary, and address sanitization errors would follow. Instead we must
-  // do a find() first, using that if it succeeds. If it fails, then after we
-  // construct the stat we can insert it into the required maps.
-  std::string final_name = prefix_ + name;
+  // See comments in counterFromStatName(). There is no super clean way (via templates or
+  // otherwise) to share this code so I'm leaving it largely duplicated for now.
+  PrefixedNameStorage final_name_storage;
+  const StatName final_name = prefixName(name, final_name_storage);
 
   StatMap<GaugeSharedPtr>* tls_cache = nullptr;
-  SharedStringSet* tls_rejected_stats = nullptr;
+  StatNameHashSet* tls_rejected_stats = nullptr;
   if (!parent_.shutting_down_ && parent_.tls_) {
     TlsCacheEntry& entry = parent_.tls_->getTyped<TlsCache>().scope_cache_[this->scope_id_];
     tls_cache = &entry.gauges_;
@@ -398,7 +642,7 @@ Gauge& ThreadLocalStoreImpl::ScopeImpl::gauge(const std::string& name) {
   }
 
   return safeMakeStat<Gauge>(
-      final_name, central_cache_.gauges_, central_cache_.rejected_stats_,
+      final_name, central_cache_->gauges_,
       [](StatDataAllocator& allocator, absl::string_view name, std::string&& tag_extracted_name,
          std::vector<Tag>&& tags) -> GaugeSharedPtr {
         return allocator.makeGauge(name, std::move(tag_extracted_name), std::move(tags));
@@ -406,105 +650,121 @@ Gauge& ThreadLocalStoreImpl::ScopeImpl::gauge(const std::string& name) {
       tls_cache, tls_rejected_stats, null_gauge_);
 }
 
-Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
+Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatName(StatName name) {
   if (parent_.rejectsAll()) {
     return null_histogram_;
   }
 
-  // See comments in counter(). There is no super clean way (via templates or otherwise) to
-  // share this code so I'm leaving it largely duplicated for now.
-  //
-  // Note that we can do map.find(final_name.c_str()), but we cannot do
-  // map[final_name.c_str()] as the char*-keyed maps would then save the pointer to
-  // a temporary, and address sanitization errors would follow. Instead we must
-  // do a find() first, using that if it succeeds. If it fails, then after we
-  // construct the stat we can insert it into the required maps.
-  std::string final_name = prefix_ + name;
+  // See comments in counterFromStatName(). There is no super clean way (via templates or
+  // otherwise) to share this code so I'm leaving it largely duplicated for now.
+  PrefixedNameStorage final_name_storage;
+  const StatName final_name = prefixName(name, final_name_storage);
 
   StatMap<ParentHistogramSharedPtr>* tls_cache = nullptr;
-  SharedStringSet* tls_rejected_stats = nullptr;
+  StatNameHashSet* tls_rejected_stats = nullptr;
   if (!parent_.shutting_down_ && parent_.tls_) {
     TlsCacheEntry& entry = parent_.tls_->getTyped<TlsCache>().scope_cache_[this->scope_id_];
     tls_cache = &entry.parent_histograms_;
-    auto iter = tls_cache->find(final_name.c_str());
+    auto iter = tls_cache->find(final_name);
     if (iter != tls_cache->end()) {
       return *iter->second;
     }
     tls_rejected_stats = &entry.rejected_stats_;
-    if (tls_rejected_stats->find(final_name.c_str()) != tls_rejected_stats->end()) {
+    if (tls_rejected_stats->find(final_name) != tls_rejected_stats->end()) {
       return null_histogram_;
     }
   }
 
   Thread::LockGuard lock(parent_.lock_);
-  auto iter = central_cache_.histograms_.find(final_name.c_str());
+  auto iter = central_cache_->histograms_.find(final_name);
   ParentHistogramImplSharedPtr* central_ref = nullptr;
-  if (iter != central_cache_.histograms_.end()) {
+  if (iter != central_cache_->histograms_.end()) {
     central_ref = &iter->second;
-  } else if (parent_.checkAndRememberRejection(final_name, central_cache_.rejected_stats_,
+  } else if (parent_.checkAndRememberRejection(final_name, central_cache_->rejected_stats_,
                                                tls_rejected_stats)) {
     return null_histogram_;
   } else {
     std::vector<Tag> tags;
-    std::string tag_extracted_name = parent_.getTagsForName(final_name, tags);
-    auto stat = std::make_shared<ParentHistogramImpl>(
-        final_name, parent_, *this, std::move(tag_extracted_name), std::move(tags));
-    central_ref = &central_cache_.histograms_[stat->nameCStr()];
+    std::string tag_extracted_name =
+        parent_.getTagsForName(symbolTable().toString(final_name), tags);
+    auto stat = std::make_shared<ParentHistogramImpl>(final_name, parent_, *this,
+                                                      std::move(tag_extracted_name),
+                                                      std::move(tags), parent_.histogram_settings_);
+    central_ref = &central_cache_->histograms_[stat->statName()];
     *central_ref = stat;
   }
 
   if (tls_cache != nullptr) {
-    tls_cache->insert(std::make_pair((*central_ref)->nameCStr(), *central_ref));
+    tls_cache->insert(std::make_pair((*central_ref)->statName(), *central_ref));
+    ++central_cache_->tls_entries_;
   }
   return **central_ref;
 }
 
-Histogram& ThreadLocalStoreImpl::ScopeImpl::tlsHistogram(const std::string& name,
+Histogram& ThreadLocalStoreImpl::ScopeImpl::tlsHistogram(StatName name,
                                                          ParentHistogramImpl& parent) {
   // tlsHistogram() is generally not called for a histogram that is rejected by
   // the matcher, so no further rejection-checking is needed at this level.
   // TlsHistogram inherits its reject/accept status from ParentHistogram.
 
-  // See comments in counter() which explains the logic here.
+  // See comments in counterFromStatName() which explains the logic here.
   StatMap<TlsHistogramSharedPtr>* tls_cache = nullptr;
   if (!parent_.shutting_down_ && parent_.tls_) {
     tls_cache = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this->scope_id_].histograms_;
-    auto iter = tls_cache->find(name.c_str());
+    auto iter = tls_cache->find(name);
     if (iter != tls_cache->end()) {
       return *iter->second;
     }
   }
 
-  std::vector<Tag> tags;
-  std::string tag_extracted_name = parent_.getTagsForName(name, tags);
-  TlsHistogramSharedPtr hist_tls_ptr = std::make_shared<ThreadLocalHistogramImpl>(
-      name, std::move(tag_extracted_name), std::move(tags));
+  // The TLS histogram has the same name as its parent, so it takes a copy of the parent's tags
+  // rather than extracting them again.
+  std::string tag_extracted_name = parent.tagExtractedName();
+  std::vector<Tag> tags = parent.tags();
+  TlsHistogramSharedPtr hist_tls_ptr =
+      std::make_shared<ThreadLocalHistogramImpl>(name, symbolTable(), std::move(tag_extracted_name),
+                                                 std::move(tags), parent.histogramSettings());
 
   parent.addTlsHistogram(hist_tls_ptr);
 
   if (tls_cache) {
-    tls_cache->insert(std::make_pair(hist_tls_ptr->nameCStr(), hist_tls_ptr));
+    tls_cache->insert(std::make_pair(hist_tls_ptr->statName(), hist_tls_ptr));
+    ++central_cache_->tls_entries_;
   }
   return *hist_tls_ptr;
 }
 
-ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(const std::string& name,
+ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, SymbolTable& symbol_table,
                                                    std::string&& tag_extracted_name,
-                                                   std::vector<Tag>&& tags)
-    : MetricImpl(std::move(tag_extracted_name), std::move(tags)), current_active_(0), flags_(0),
-      created_thread_id_(std::this_thread::get_id()), name_(name) {
-  histograms_[0] = hist_alloc();
-  histograms_[1] = hist_alloc();
+                                                   std::vector<Tag>&& tags,
+                                                   const HistogramSettings& settings)
+    : MetricImpl(std::move(tag_extracted_name), std::move(tags)), current_active_(0),
+      histograms_{nullptr, nullptr}, flags_(0), created_thread_id_(std::this_thread::get_id()),
+      name_(name, symbol_table), symbol_table_(symbol_table) {
+  if (settings.backend_ == HistogramSettings::Backend::LogLinear) {
+    log_linear_histograms_[0] = std::make_unique<LogLinearHistogram>(settings.precision_bits_);
+    log_linear_histograms_[1] = std::make_unique<LogLinearHistogram>(settings.precision_bits_);
+  } else {
+    histograms_[0] = hist_alloc();
+    histograms_[1] = hist_alloc();
+  }
 }
 
 ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
-  hist_free(histograms_[0]);
-  hist_free(histograms_[1]);
+  if (histograms_[0] != nullptr) {
+    hist_free(histograms_[0]);
+    hist_free(histograms_[1]);
+  }
+  name_.free(symbol_table_);
 }
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  if (log_linear_histograms_[0] != nullptr) {
+    log_linear_histograms_[current_active_]->recordValue(value);
+  } else {
+    hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  }
   flags_ |= Flags::Used;
 }
 
@@ -514,21 +774,42 @@ void ThreadLocalHistogramImpl::merge(histogram_t* target) {
   hist_clear(*other_histogram);
 }
 
-ParentHistogramImpl::ParentHistogramImpl(const std::string& name, Store& parent,
+void ThreadLocalHistogramImpl::merge(LogLinearHistogram& target) {
+  LogLinearHistogram& other_histogram = *log_linear_histograms_[otherHistogramIndex()];
+  target.merge(other_histogram);
+  other_histogram.clear();
+}
+
+ParentHistogramImpl::ParentHistogramImpl(StatName name, Store& parent,
                                          TlsScope& tls_scope, std::string&& tag_extracted_name,
-                                         std::vector<Tag>&& tags)
+                                         std::vector<Tag>&& tags,
+                                         const HistogramSettings& settings)
     : MetricImpl(std::move(tag_extracted_name), std::move(tags)), parent_(parent),
-      tls_scope_(tls_scope), interval_histogram_(hist_alloc()), cumulative_histogram_(hist_alloc()),
-      interval_statistics_(interval_histogram_), cumulative_statistics_(cumulative_histogram_),
-      merged_(false), name_(name) {}
+      tls_scope_(tls_scope), interval_histogram_(nullptr), cumulative_histogram_(nullptr),
+      settings_(settings), merged_(false), name_(name, parent.symbolTable()) {
+  if (settings.backend_ == HistogramSettings::Backend::LogLinear) {
+    interval_log_linear_ = std::make_unique<LogLinearHistogram>(settings.precision_bits_);
+    cumulative_log_linear_ = std::make_unique<LogLinearHistogram>(settings.precision_bits_);
+    interval_statistics_.refresh(*interval_log_linear_);
+    cumulative_statistics_.refresh(*cumulative_log_linear_);
+  } else {
+    interval_histogram_ = hist_alloc();
+    cumulative_histogram_ = hist_alloc();
+    interval_statistics_.refresh(interval_histogram_);
+    cumulative_statistics_.refresh(cumulative_histogram_);
+  }
+}
 
 ParentHistogramImpl::~ParentHistogramImpl() {
-  hist_free(interval_histogram_);
-  hist_free(cumulative_histogram_);
+  if (interval_histogram_ != nullptr) {
+    hist_free(interval_histogram_);
+    hist_free(cumulative_histogram_);
+  }
+  name_.free(parent_.symbolTable());
 }
 
 void ParentHistogramImpl::recordValue(uint64_t value) {
-  Histogram& tls_histogram = tls_scope_.tlsHistogram(name(), *this);
+  Histogram& tls_histogram = tls_scope_.tlsHistogram(name_.statName(), *this);
   tls_histogram.recordValue(value);
   parent_.deliverHistogramToSinks(*this, value);
 }
@@ -541,34 +822,39 @@ bool ParentHistogramImpl::used() const {
 void ParentHistogramImpl::merge() {
   Thread::ReleasableLockGuard lock(merge_lock_);
   if (merged_ || usedLockHeld()) {
-    hist_clear(interval_histogram_);
     // Here we could copy all the pointers to TLS histograms in the tls_histogram_ list,
     // then release the lock before we do the actual merge. However it is not a big deal
     // because the tls_histogram merge is not that expensive as it is a single histogram
     // merge and adding TLS histograms is rare.
-    for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
-      tls_histogram->merge(interval_histogram_);
+    if (interval_log_linear_ != nullptr) {
+      interval_log_linear_->clear();
+      for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
+        tls_histogram->merge(*interval_log_linear_);
+      }
+    } else {
+      hist_clear(interval_histogram_);
+      for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
+        tls_histogram->merge(interval_histogram_);
+      }
     }
     // Since TLS merge is done, we can release the lock here.
     lock.release();
-    hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
-    cumulative_statistics_.refresh(cumulative_histogram_);
-    interval_statistics_.refresh(interval_histogram_);
+    if (interval_log_linear_ != nullptr) {
+      cumulative_log_linear_->merge(*interval_log_linear_);
+      cumulative_statistics_.refresh(*cumulative_log_linear_);
+      interval_statistics_.refresh(*interval_log_linear_);
+    } else {
+      hist_accumulate(cumulative_histogram_, &interval_histogram_, 1);
+      cumulative_statistics_.refresh(cumulative_histogram_);
+      interval_statistics_.refresh(interval_histogram_);
+    }
     merged_ = true;
   }
 }
 
 const std::string ParentHistogramImpl::quantileSummary() const {
   if (used()) {
-    std::vector<std::string> summary;
-    const std::vector<double>& supported_quantiles_ref = interval_statistics_.supportedQuantiles();
-    summary.reserve(supported_quantiles_ref.size());
-    for (size_t i = 0; i < supported_quantiles_ref.size(); ++i) {
-      summary.push_back(fmt::format("P{}({},{})", 100 * supported_quantiles_ref[i],
-                                    interval_statistics_.computedQuantiles()[i],
-                                    cumulative_statistics_.computedQuantiles()[i]));
-    }
-    return absl::StrJoin(summary, " ");
+    return parentHistogramQuantileSummary(interval_statistics_, cumulative_statistics_);
   } else {
     return std::string("No recorded values");
   }
@@ -576,15 +862,7 @@ const std::string ParentHistogramImpl::quantileSummary() const {
 
 const std::string ParentHistogramImpl::bucketSummary() const {
   if (used()) {
-    std::vector<std::string> bucket_summary;
-    const std::vector<double>& supported_buckets = interval_statistics_.supportedBuckets();
-    bucket_summary.reserve(supported_buckets.size());
-    for (size_t i = 0; i < supported_buckets.size(); ++i) {
-      bucket_summary.push_back(fmt::format("B{}({},{})", supported_buckets[i],
-                                           interval_statistics_.computedBuckets()[i],
-                                           cumulative_statistics_.computedBuckets()[i]));
-    }
-    return absl::StrJoin(bucket_summary, " ");
+    return parentHistogramBucketSummary(interval_statistics_, cumulative_statistics_);
   } else {
     return std::string("No recorded values");
   }
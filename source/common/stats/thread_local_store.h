@@ -11,6 +11,7 @@
 #include "common/common/hash.h"
 #include "common/stats/heap_stat_data.h"
 #include "common/stats/histogram_impl.h"
+#include "common/stats/log_linear_histogram.h"
 #include "common/stats/source_impl.h"
 #include "common/stats/symbol_table_impl.h"
 #include "common/stats/utility.h"
@@ -25,15 +26,18 @@ namespace Stats {
 /**
  * A histogram that is stored in TLS and used to record values per thread. This holds two
  * histograms, one to collect the values and other as backup that is used for merge process. The
- * swap happens during the merge process.
+ * swap happens during the merge process. Depending on the store's HistogramSettings the pair is
+ * either circllhist or LogLinearHistogram.
  */
 class ThreadLocalHistogramImpl : public Histogram, public MetricImpl {
 public:
-  ThreadLocalHistogramImpl(const std::string& name, std::string&& tag_extracted_name,
-                           std::vector<Tag>&& tags);
+  ThreadLocalHistogramImpl(StatName name, SymbolTable& symbol_table,
+                           std::string&& tag_extracted_name, std::vector<Tag>&& tags,
+                           const HistogramSettings& settings);
   ~ThreadLocalHistogramImpl();
 
   void merge(histogram_t* target);
+  void merge(LogLinearHistogram& target);
 
   /**
    * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
@@ -50,16 +54,20 @@ public:
   bool used() const override { return flags_ & Flags::Used; }
 
   // Stats::Metric
-  std::string name() const override { return name_; }
-  const char* nameCStr() const override { return name_.c_str(); }
+  std::string name() const override { return symbol_table_.toString(name_.statName()); }
+
+  StatName statName() const { return name_.statName(); }
 
 private:
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_;
+  // Only one of these pairs is allocated.
   histogram_t* histograms_[2];
+  std::unique_ptr<LogLinearHistogram> log_linear_histograms_[2];
   std::atomic<uint16_t> flags_;
   std::thread::id created_thread_id_;
-  const std::string name_;
+  StatNameStorage name_;
+  SymbolTable& symbol_table_;
 };
 
 typedef std::shared_ptr<ThreadLocalHistogramImpl> TlsHistogramSharedPtr;
@@ -71,8 +79,9 @@ class TlsScope;
  */
 class ParentHistogramImpl : public ParentHistogram, public MetricImpl {
 public:
-  ParentHistogramImpl(const std::string& name, Store& parent, TlsScope& tlsScope,
-                      std::string&& tag_extracted_name, std::vector<Tag>&& tags);
+  ParentHistogramImpl(StatName name, Store& parent, TlsScope& tlsScope,
+                      std::string&& tag_extracted_name, std::vector<Tag>&& tags,
+                      const HistogramSettings& settings);
   ~ParentHistogramImpl();
 
   void addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr);
@@ -94,23 +103,34 @@ public:
   const std::string quantileSummary() const override;
   const std::string bucketSummary() const override;
 
+  /**
+   * @return the settings this histogram was created with, which its TLS histograms share.
+   */
+  const HistogramSettings& histogramSettings() const { return settings_; }
+
   // Stats::Metric
-  std::string name() const override { return name_; }
-  const char* nameCStr() const override { return name_.c_str(); }
+  std::string name() const override { return parent_.symbolTable().toString(name_.statName()); }
+
+  StatName statName() const { return name_.statName(); }
 
 private:
   bool usedLockHeld() const EXCLUSIVE_LOCKS_REQUIRED(merge_lock_);
 
   Store& parent_;
   TlsScope& tls_scope_;
+  // Set for the circllhist backend.
   histogram_t* interval_histogram_;
   histogram_t* cumulative_histogram_;
+  // Set for the log-linear backend.
+  std::unique_ptr<LogLinearHistogram> interval_log_linear_;
+  std::unique_ptr<LogLinearHistogram> cumulative_log_linear_;
   HistogramStatisticsImpl interval_statistics_;
   HistogramStatisticsImpl cumulative_statistics_;
+  const HistogramSettings settings_;
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ GUARDED_BY(merge_lock_);
   bool merged_;
-  const std::string name_;
+  StatNameStorage name_;
 };
 
 typedef std::shared_ptr<ParentHistogramImpl> ParentHistogramImplSharedPtr;
@@ -127,7 +147,7 @@ public:
    * @return a ThreadLocalHistogram within the scope's namespace.
    * @param name name of the histogram with scope prefix attached.
    */
-  virtual Histogram& tlsHistogram(const std::string& name, ParentHistogramImpl& parent) PURE;
+  virtual Histogram& tlsHistogram(StatName name, ParentHistogramImpl& parent) PURE;
 };
 
 /**
@@ -144,7 +164,10 @@ public:
     return default_scope_->counterFromStatName(name);
   }
   Counter& counter(const std::string& name) override { return default_scope_->counter(name); }
-  ScopePtr createScope(const std::string& name) override;
+  ScopePtr createScope(const std::string& name) override { return createScope(name, false); }
+  ScopePtr createEvictableScope(const std::string& name) override {
+    return createScope(name, true);
+  }
   void deliverHistogramToSinks(const Histogram& histogram, uint64_t value) override {
     return default_scope_->deliverHistogramToSinks(histogram, value);
   }
@@ -164,6 +187,7 @@ public:
   std::vector<CounterSharedPtr> counters() const override;
   std::vector<GaugeSharedPtr> gauges() const override;
   std::vector<ParentHistogramSharedPtr> histograms() const override;
+  std::vector<ScopeMemoryStats> scopeMemoryStats() const override;
 
   // Stats::StoreRoot
   void addSink(Sink& sink) override { timer_sinks_.push_back(sink); }
@@ -171,18 +195,25 @@ public:
     tag_producer_ = std::move(tag_producer);
   }
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override;
+  void setHistogramSettings(const HistogramSettings& settings) override {
+    histogram_settings_ = settings;
+  }
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
 
   void mergeHistograms(PostMergeCb mergeCb) override;
+  void evictIdleStats(uint32_t idle_flushes) override;
 
   Source& source() override { return source_; }
 
   const Stats::StatsOptions& statsOptions() const override { return stats_options_; }
 
 private:
-  template <class Stat> using StatMap = ConstCharStarHashMap<Stat>;
+  // Stats are keyed by their full, symbolized name. Lookups join the scope prefix to a StatName
+  // without ever elaborating the name as a string; only stat creation, tag extraction and the
+  // stats matcher need the string form.
+  template <class Stat> using StatMap = StatNameHashMap<Stat>;
 
   struct TlsCacheEntry {
     StatMap<CounterSharedPtr> counters_;
@@ -191,39 +222,107 @@ private:
     StatMap<ParentHistogramSharedPtr> parent_histograms_;
 
     // We keep a TLS cache of rejected stat names. This costs memory, but
-    // reduces runtime overhead running the matcher. Moreover, once symbol
-    // tables are integrated, rejection will need the fully elaborated string,
-    // and it we need to take a global symbol-table lock to run. We keep
-    // this char* map here in the TLS cache to avoid taking a lock to compute
-    // rejection.
-    SharedStringSet rejected_stats_;
+    // reduces runtime overhead running the matcher. Moreover, rejection needs
+    // the fully elaborated string, which may need a global symbol-table lock
+    // to compute. The names are owned by the central cache's rejected_stats_.
+    StatNameHashSet rejected_stats_;
+  };
+
+  // How long a stat of an evictable scope has gone unchanged, as of the last eviction pass.
+  struct IdleState {
+    uint64_t value_{};
+    uint32_t idle_flushes_{};
   };
 
   struct CentralCacheEntry {
+    explicit CentralCacheEntry(SymbolTable& symbol_table) : symbol_table_(symbol_table) {}
+    ~CentralCacheEntry();
+
+    /**
+     * @param name a stat name, possibly backed by temporary storage.
+     * @return a copy of name backed by storage owned by this entry.
+     */
+    StatName ownedStatName(StatName name);
+
+    /**
+     * Drops the storage of a counter or gauge name that no stat of this entry uses any more. Must
+     * only be called once no TLS cache is keyed by the name.
+     */
+    void releaseStatNameIfUnused(StatName name);
+
+    /**
+     * @return the approximate bytes used by the stats of this entry and their cache entries.
+     */
+    uint64_t memoryBytes() const;
+
     StatMap<CounterSharedPtr> counters_;
     StatMap<GaugeSharedPtr> gauges_;
     StatMap<ParentHistogramImplSharedPtr> histograms_;
-    SharedStringSet rejected_stats_;
+
+    // Backs the counter and gauge keys above, and the keys of the TLS caches. Histograms own their
+    // names. The entry is kept alive until every thread has dropped its TLS cache for the scope.
+    StatNameStorageSet stat_names_;
+    StatNameStorageSet rejected_stats_;
+    SymbolTable& symbol_table_;
+
+    // Only used by evictable scopes, keyed by the same names as the stat maps.
+    StatMap<IdleState> idle_counters_;
+    StatMap<IdleState> idle_gauges_;
+    StatMap<IdleState> idle_histograms_;
+    uint64_t evicted_{};
+
+    // The number of stats held in the TLS caches of all threads for this entry.
+    std::atomic<uint64_t> tls_entries_{};
+  };
+  typedef std::shared_ptr<CentralCacheEntry> CentralCacheEntrySharedPtr;
+
+  // A stat removed from the central cache by an eviction pass, which is released once every
+  // thread has dropped it from its TLS cache.
+  template <class StatType> struct EvictedStat {
+    StatName name_;
+    std::shared_ptr<StatType> stat_;
+    uint64_t value_;
   };
 
+  struct EvictedStats {
+    bool empty() const { return counters_.empty() && gauges_.empty() && histograms_.empty(); }
+
+    std::vector<EvictedStat<Counter>> counters_;
+    std::vector<EvictedStat<Gauge>> gauges_;
+    std::vector<EvictedStat<ParentHistogramImpl>> histograms_;
+  };
+  typedef std::shared_ptr<EvictedStats> EvictedStatsSharedPtr;
+
   struct ScopeImpl : public TlsScope {
-    ScopeImpl(ThreadLocalStoreImpl& parent, const std::string& prefix)
-        : scope_id_(next_scope_id_++), parent_(parent),
-          prefix_(Utility::sanitizeStatsName(prefix)) {}
+    ScopeImpl(ThreadLocalStoreImpl& parent, const std::string& prefix, bool evictable);
     ~ScopeImpl();
 
     // Stats::Scope
-    Counter& counter(const std::string& name) override;
-    ScopePtr createScope(const std::string& name) override {
-      return parent_.createScope(prefix_ + name);
+    Counter& counterFromStatName(StatName name) override;
+    Counter& counter(const std::string& name) override {
+      StatNameTempStorage storage(name, symbolTable());
+      return counterFromStatName(storage.statName());
+    }
+    ScopePtr createScope(const std::string& name) override { return createScope(name, false); }
+    ScopePtr createEvictableScope(const std::string& name) override {
+      return createScope(name, true);
     }
+    ScopePtr createScope(const std::string& name, bool evictable);
     const SymbolTable& symbolTable() const override { return parent_.symbolTable(); }
     SymbolTable& symbolTable() override { return parent_.symbolTable(); }
     void deliverHistogramToSinks(const Histogram& histogram, uint64_t value) override;
-    Gauge& gauge(const std::string& name) override;
+    Gauge& gaugeFromStatName(StatName name) override;
+    Gauge& gauge(const std::string& name) override {
+      StatNameTempStorage storage(name, symbolTable());
+      return gaugeFromStatName(storage.statName());
+    }
     NullGaugeImpl& nullGauge(const std::string&) override { return null_gauge_; }
-    Histogram& histogram(const std::string& name) override;
-    Histogram& tlsHistogram(const std::string& name, ParentHistogramImpl& parent) override;
+    Histogram& histogramFromStatName(StatName name) override;
+    Histogram& histogram(const std::string& name) override {
+      StatNameTempStorage storage(name, symbolTable());
+      return histogramFromStatName(storage.statName());
+    }
+    Histogram& tlsHistogram(StatName name, ParentHistogramImpl& parent) override;
     const Stats::StatsOptions& statsOptions() const override { return parent_.statsOptions(); }
 
     template <class StatType>
@@ -237,35 +336,48 @@ private:
      * generating it from the parent allocator, or as a last
      * result, creating it with the heap allocator.
      *
-     * @param name the full name of the stat (not tag extracted).
+     * @param name the full name of the stat (not tag extracted), including the scope prefix.
      * @param central_cache_map a map from name to the desired object in the central cache.
      * @param make_stat a function to generate the stat object, called if it's not in cache.
      * @param tls_ref possibly null reference to a cache entry for this stat, which will be
      *     used if non-empty, or filled in if empty (and non-null).
      */
     template <class StatType>
-    StatType& safeMakeStat(const std::string& name,
-                           StatMap<std::shared_ptr<StatType>>& central_cache_map,
-                           SharedStringSet& central_rejected_stats_, MakeStatFn<StatType> make_stat,
+    StatType& safeMakeStat(StatName name, StatMap<std::shared_ptr<StatType>>& central_cache_map,
+                           MakeStatFn<StatType> make_stat,
                            StatMap<std::shared_ptr<StatType>>* tls_cache,
-                           SharedStringSet* tls_rejected_stats, StatType& null_stat);
+                           StatNameHashSet* tls_rejected_stats, StatType& null_stat);
 
-    Counter& counterFromStatName(StatName name) override {
-      return counter(symbolTable().toString(name));
-    }
+    // Storage for the full name of a stat, @see prefixName().
+    struct PrefixedNameStorage {
+      SymbolTable::StoragePtr joined_;
+      std::unique_ptr<StatNameTempStorage> concatenated_;
+    };
 
-    Gauge& gaugeFromStatName(StatName name) override { return gauge(symbolTable().toString(name)); }
+    /**
+     * @param name a stat name relative to this scope.
+     * @param storage receives the full name of the stat if it has to be built.
+     * @return StatName the full name of the stat, which is name if the scope has no prefix.
+     */
+    StatName prefixName(StatName name, PrefixedNameStorage& storage);
 
-    Histogram& histogramFromStatName(StatName name) override {
-      return histogram(symbolTable().toString(name));
-    }
+    /**
+     * @return std::string the prefix of the scope as it was created, after sanitization.
+     */
+    std::string prefixString() const;
 
     static std::atomic<uint64_t> next_scope_id_;
 
     const uint64_t scope_id_;
     ThreadLocalStoreImpl& parent_;
-    const std::string prefix_;
-    CentralCacheEntry central_cache_;
+    const bool evictable_;
+
+    // The sanitized prefix, without its trailing ".", which is supplied by the join with the
+    // names of the stats created in the scope. A prefix without a trailing "." is instead
+    // concatenated to the names, as strings.
+    StatNameStorage prefix_;
+    const bool prefix_joins_with_dot_;
+    CentralCacheEntrySharedPtr central_cache_;
 
     NullCounterImpl null_counter_;
     NullGaugeImpl null_gauge_;
@@ -283,8 +395,18 @@ private:
     absl::flat_hash_map<uint64_t, TlsCacheEntry> scope_cache_;
   };
 
+  ScopePtr createScope(const std::string& name, bool evictable);
   std::string getTagsForName(const std::string& name, std::vector<Tag>& tags) const;
-  void clearScopeFromCaches(uint64_t scope_id);
+  void clearScopeFromCaches(uint64_t scope_id, CentralCacheEntrySharedPtr central_cache);
+  template <class StatType>
+  void evictIdle(StatMap<std::shared_ptr<StatType>>& stats, StatMap<IdleState>& idle_states,
+                 uint32_t idle_flushes, bool keep_non_zero,
+                 std::vector<EvictedStat<StatType>>& evicted);
+  void evictIdleHistograms(CentralCacheEntry& central_cache, uint32_t idle_flushes,
+                           std::vector<EvictedStat<ParentHistogramImpl>>& evicted);
+  void clearEvictedFromCaches(uint64_t scope_id, CentralCacheEntrySharedPtr central_cache,
+                              EvictedStatsSharedPtr evicted);
+  void completeEviction(CentralCacheEntry& central_cache, EvictedStats& evicted);
   void releaseScopeCrossThread(ScopeImpl* scope);
   void mergeInternal(PostMergeCb mergeCb);
   absl::string_view truncateStatNameIfNeeded(absl::string_view name);
@@ -292,8 +414,8 @@ private:
   bool rejectsAll() const { return stats_matcher_->rejectsAll(); }
   template <class StatMapClass, class StatListClass>
   void removeRejectedStats(StatMapClass& map, StatListClass& list);
-  bool checkAndRememberRejection(const std::string& name, SharedStringSet& central_rejected_stats,
-                                 SharedStringSet* tls_rejected_stats);
+  bool checkAndRememberRejection(StatName name, StatNameStorageSet& central_rejected_stats,
+                                 StatNameHashSet* tls_rejected_stats);
 
   const Stats::StatsOptions& stats_options_;
   StatDataAllocator& alloc_;
@@ -305,6 +427,7 @@ private:
   std::list<std::reference_wrapper<Sink>> timer_sinks_;
   TagProducerPtr tag_producer_;
   StatsMatcherPtr stats_matcher_;
+  HistogramSettings histogram_settings_;
   std::atomic<bool> shutting_down_{};
   std::atomic<bool> merge_in_progress_{};
   Counter& num_last_resort_stats_;
@@ -12,6 +12,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/access_log/access_log_impl.h"
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
@@ -66,6 +67,7 @@ Config::SharedConfig::SharedConfig(
 Config::Config(const envoy::config::filter::network::tcp_proxy::v2::TcpProxy& config,
                Server::Configuration::FactoryContext& context)
     : max_connect_attempts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_connect_attempts, 1)),
+      use_splice_(config.use_splice()),
       upstream_drain_manager_slot_(context.threadLocal().allocateSlot()),
       shared_config_(std::make_shared<SharedConfig>(config, context)),
       random_generator_(context.random()) {
@@ -465,6 +467,11 @@ Network::FilterStatus Filter::onData(Buffer::Instance& data, bool end_stream) {
 }
 
 void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::RemoteClose ||
+      event == Network::ConnectionEvent::LocalClose) {
+    splicer_.reset();
+  }
+
   if (upstream_conn_data_) {
     if (event == Network::ConnectionEvent::RemoteClose) {
       upstream_conn_data_->connection().close(Network::ConnectionCloseType::FlushWrite);
@@ -513,6 +520,7 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    splicer_.reset();
     upstream_conn_data_.reset();
     disableIdleTimer();
 
@@ -531,8 +539,11 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
     }
   } else if (event == Network::ConnectionEvent::Connected) {
     // Re-enable downstream reads now that the upstream connection is established
-    // so we have a place to send downstream data to.
-    read_callbacks_->connection().readDisable(false);
+    // so we have a place to send downstream data to. Spliced data is not read by the
+    // connections, so their reads stay disabled.
+    if (!config_->useSplice() || !startSplice()) {
+      read_callbacks_->connection().readDisable(false);
+    }
 
     read_callbacks_->upstreamHost()->outlierDetector().putResult(
         Upstream::Outlier::Result::SUCCESS);
@@ -560,11 +571,139 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 void Filter::onIdleTimeout() {
   ENVOY_CONN_LOG(debug, "Session timed out", read_callbacks_->connection());
   config_->stats().idle_timeout_.inc();
+  splicer_.reset();
 
   // This results in also closing the upstream connection.
   read_callbacks_->connection().close(Network::ConnectionCloseType::NoFlush);
 }
 
+bool Filter::startSplice() {
+  Network::IoHandle* downstream_handle = read_callbacks_->connection().spliceIoHandle();
+  Network::IoHandle* upstream_handle = upstream_conn_data_->connection().spliceIoHandle();
+  if (downstream_handle == nullptr || upstream_handle == nullptr) {
+    return false;
+  }
+
+  Network::SplicePipePtr downstream_pipe = Network::SplicePipe::create();
+  Network::SplicePipePtr upstream_pipe = Network::SplicePipe::create();
+  if (downstream_pipe == nullptr || upstream_pipe == nullptr) {
+    return false;
+  }
+
+  ENVOY_CONN_LOG(debug, "splicing data with upstream", read_callbacks_->connection());
+  upstream_conn_data_->connection().readDisable(true);
+  splicer_ = std::make_unique<Splicer>(*this, *downstream_handle, *upstream_handle,
+                                       std::move(downstream_pipe), std::move(upstream_pipe));
+  config_->stats().downstream_cx_splice_total_.inc();
+  return true;
+}
+
+Filter::Splicer::Splicer(Filter& parent, Network::IoHandle& downstream_handle,
+                         Network::IoHandle& upstream_handle,
+                         Network::SplicePipePtr&& downstream_pipe,
+                         Network::SplicePipePtr&& upstream_pipe)
+    : parent_(parent),
+      downstream_{parent.read_callbacks_->connection(), downstream_handle,
+                  parent.upstream_conn_data_->connection(), upstream_handle,
+                  std::move(downstream_pipe)},
+      upstream_{parent.upstream_conn_data_->connection(), upstream_handle,
+                parent.read_callbacks_->connection(), downstream_handle, std::move(upstream_pipe)} {
+  Event::Dispatcher& dispatcher = parent_.read_callbacks_->connection().dispatcher();
+  downstream_.event_ = dispatcher.createFileEvent(
+      downstream_handle.fd(),
+      [this](uint32_t events) -> void { onFileEvent(downstream_, upstream_, events); },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  upstream_.event_ = dispatcher.createFileEvent(
+      upstream_handle.fd(),
+      [this](uint32_t events) -> void { onFileEvent(upstream_, downstream_, events); },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
+
+  // Data may have arrived while reads were disabled, before there were events to report it.
+  downstream_.event_->activate(Event::FileReadyType::Read);
+  upstream_.event_->activate(Event::FileReadyType::Read);
+}
+
+void Filter::Splicer::onFileEvent(Direction& read_direction, Direction& write_direction,
+                                  uint32_t events) {
+  if ((events & Event::FileReadyType::Read) && !transfer(read_direction)) {
+    return;
+  }
+  // Bytes held for a destination that was not writable can now be written.
+  if ((events & Event::FileReadyType::Write) && write_direction.write_blocked_) {
+    transfer(write_direction);
+  }
+}
+
+bool Filter::Splicer::transfer(Direction& direction) {
+  // As with a connection read buffer, reading stops at the buffer limit to let other connections
+  // run, and resumes on the next iteration of the event loop.
+  const Network::SplicePipe::TransferResult result = direction.pipe_->transfer(
+      direction.source_handle_, direction.destination_handle_, direction.source_.bufferLimit());
+
+  if (result.bytes_read_ > 0) {
+    if (&direction == &downstream_) {
+      parent_.getStreamInfo().addBytesReceived(result.bytes_read_);
+    } else {
+      parent_.getStreamInfo().addBytesSent(result.bytes_read_);
+    }
+    direction.source_.onSpliced(result.bytes_read_, 0);
+    parent_.resetIdleTimer();
+  }
+  if (result.bytes_written_ > 0) {
+    direction.destination_.onSpliced(0, result.bytes_written_);
+  }
+
+  if (result.errno_ != 0) {
+    ENVOY_CONN_LOG(debug, "splice error: {}", parent_.read_callbacks_->connection(),
+                   result.errno_);
+    // This results in also closing the upstream connection, and destroys this.
+    parent_.read_callbacks_->connection().close(Network::ConnectionCloseType::NoFlush);
+    return false;
+  }
+
+  if (result.write_blocked_ != direction.write_blocked_) {
+    onWriteBlocked(direction, result.write_blocked_);
+  }
+  if (result.read_limit_reached_) {
+    direction.event_->activate(Event::FileReadyType::Read);
+  }
+
+  if (direction.pipe_->endStreamRead() && direction.pipe_->bufferedBytes() == 0 &&
+      !direction.end_stream_written_) {
+    direction.end_stream_written_ = true;
+    Buffer::OwnedImpl empty;
+    direction.destination_.write(empty, true);
+
+    if (downstream_.end_stream_written_ && upstream_.end_stream_written_) {
+      ENVOY_CONN_LOG(debug, "splice complete", parent_.read_callbacks_->connection());
+      // This results in also closing the upstream connection, and destroys this.
+      parent_.read_callbacks_->connection().close(Network::ConnectionCloseType::FlushWrite);
+      return false;
+    }
+  }
+  return true;
+}
+
+void Filter::Splicer::onWriteBlocked(Direction& direction, bool blocked) {
+  // The source is not read while the pipe holds bytes for the destination, which is accounted as
+  // the connection watermarks do when they disable reads.
+  direction.write_blocked_ = blocked;
+  if (&direction == &downstream_) {
+    if (blocked) {
+      parent_.config_->stats().downstream_flow_control_paused_reading_total_.inc();
+    } else {
+      parent_.config_->stats().downstream_flow_control_resumed_reading_total_.inc();
+    }
+  } else {
+    Upstream::ClusterStats& stats = parent_.read_callbacks_->upstreamHost()->cluster().stats();
+    if (blocked) {
+      stats.upstream_flow_control_paused_reading_total_.inc();
+    } else {
+      stats.upstream_flow_control_resumed_reading_total_.inc();
+    }
+  }
+}
+
 void Filter::resetIdleTimer() {
   if (idle_timer_ != nullptr) {
     ASSERT(config_->idleTimeout());
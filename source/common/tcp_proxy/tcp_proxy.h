@@ -8,6 +8,7 @@
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/config/filter/network/tcp_proxy/v2/tcp_proxy.pb.h"
+#include "envoy/event/file_event.h"
 #include "envoy/event/timer.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/filter.h"
@@ -24,6 +25,7 @@
 #include "common/common/logger.h"
 #include "common/network/cidr_range.h"
 #include "common/network/filter_impl.h"
+#include "common/network/splice_pipe.h"
 #include "common/network/utility.h"
 #include "common/stream_info/stream_info_impl.h"
 #include "common/upstream/load_balancer_impl.h"
@@ -42,6 +44,7 @@ namespace TcpProxy {
   GAUGE  (downstream_cx_tx_bytes_buffered)                                                         \
   COUNTER(downstream_cx_total)                                                                     \
   COUNTER(downstream_cx_no_route)                                                                  \
+  COUNTER(downstream_cx_splice_total)                                                              \
   COUNTER(downstream_flow_control_paused_reading_total)                                            \
   COUNTER(downstream_flow_control_resumed_reading_total)                                           \
   COUNTER(idle_timeout)                                                                            \
@@ -107,6 +110,7 @@ public:
   const TcpProxyStats& stats() { return shared_config_->stats(); }
   const std::vector<AccessLog::InstanceSharedPtr>& accessLogs() { return access_logs_; }
   uint32_t maxConnectAttempts() const { return max_connect_attempts_; }
+  bool useSplice() const { return use_splice_; }
   const absl::optional<std::chrono::milliseconds>& idleTimeout() {
     return shared_config_->idleTimeout();
   }
@@ -147,6 +151,7 @@ private:
   uint64_t total_cluster_weight_;
   std::vector<AccessLog::InstanceSharedPtr> access_logs_;
   const uint32_t max_connect_attempts_;
+  const bool use_splice_;
   ThreadLocal::SlotPtr upstream_drain_manager_slot_;
   SharedConfigSharedPtr shared_config_;
   std::unique_ptr<const Router::MetadataMatchCriteria> cluster_metadata_match_criteria_;
@@ -246,6 +251,41 @@ protected:
     bool on_high_watermark_called_{false};
   };
 
+  /**
+   * Moves data between the downstream and upstream sockets with splice(2), in place of onData()
+   * and onUpstreamData(). Reads on both connections stay disabled, and each socket is watched by
+   * a file event of its own.
+   */
+  class Splicer {
+  public:
+    Splicer(Filter& parent, Network::IoHandle& downstream_handle,
+            Network::IoHandle& upstream_handle, Network::SplicePipePtr&& downstream_pipe,
+            Network::SplicePipePtr&& upstream_pipe);
+
+  private:
+    // The data read from one connection and written to the other.
+    struct Direction {
+      Network::Connection& source_;
+      Network::IoHandle& source_handle_;
+      Network::Connection& destination_;
+      Network::IoHandle& destination_handle_;
+      Network::SplicePipePtr pipe_;
+      // Watches the source socket, which is also the destination of the opposite direction.
+      Event::FileEventPtr event_;
+      bool write_blocked_{};
+      bool end_stream_written_{};
+    };
+
+    void onFileEvent(Direction& read_direction, Direction& write_direction, uint32_t events);
+    // Returns false if the connections were closed, in which case this has been destroyed.
+    bool transfer(Direction& direction);
+    void onWriteBlocked(Direction& direction, bool blocked);
+
+    Filter& parent_;
+    Direction downstream_;
+    Direction upstream_;
+  };
+
   enum class UpstreamFailureReason {
     CONNECT_FAILED,
     NO_HEALTHY_UPSTREAM,
@@ -267,6 +307,7 @@ protected:
   void initialize(Network::ReadFilterCallbacks& callbacks, bool set_connection_stats);
   Network::FilterStatus initializeUpstreamConnection();
   void onConnectTimeout();
+  bool startSplice();
   void onDownstreamEvent(Network::ConnectionEvent event);
   void onUpstreamData(Buffer::Instance& data, bool end_stream);
   void onUpstreamEvent(Network::ConnectionEvent event);
@@ -284,6 +325,7 @@ protected:
   std::shared_ptr<UpstreamCallbacks> upstream_callbacks_; // shared_ptr required for passing as a
                                                           // read filter.
   StreamInfo::StreamInfoImpl stream_info_;
+  std::unique_ptr<Splicer> splicer_;
   uint32_t connect_attempts_{};
   bool connecting_{};
 };
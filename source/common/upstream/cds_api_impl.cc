@@ -13,6 +13,8 @@
 #include "common/config/utility.h"
 #include "common/protobuf/utility.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -43,44 +45,91 @@ CdsApiImpl::CdsApiImpl(const envoy::api::v2::core::ConfigSource& cds_config, Clu
 void CdsApiImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
                                 const std::string& version_info) {
   ClusterManager::ClusterInfoMap clusters_to_remove = cm_.clusters();
-  std::vector<envoy::api::v2::Cluster> clusters;
+  std::vector<ClusterUpdate> clusters;
+  std::vector<std::string> unchanged_clusters;
+  clusters.reserve(resources.size());
   for (const auto& cluster_blob : resources) {
-    clusters.push_back(MessageUtil::anyConvert<envoy::api::v2::Cluster>(cluster_blob));
-    clusters_to_remove.erase(clusters.back().name());
-  }
-  Protobuf::RepeatedPtrField<std::string> to_remove_repeated;
-  for (const auto& cluster : clusters_to_remove) {
-    *to_remove_repeated.Add() = cluster.first;
+    const uint64_t hash = Config::ResourceHashCache::hash(cluster_blob);
+    const std::string* unchanged_name = resource_hashes_.find(hash);
+    if (unchanged_name != nullptr && clusters_to_remove.count(*unchanged_name) > 0) {
+      unchanged_clusters.push_back(*unchanged_name);
+      continue;
+    }
+    clusters.push_back(
+        {MessageUtil::anyConvert<envoy::api::v2::Cluster>(cluster_blob), version_info, hash});
   }
-  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> to_add_repeated;
   for (const auto& cluster : clusters) {
-    envoy::api::v2::Resource* to_add = to_add_repeated.Add();
-    to_add->set_name(cluster.name());
-    to_add->set_version(version_info);
-    to_add->mutable_resource()->PackFrom(cluster);
+    clusters_to_remove.erase(cluster.cluster_.name());
+  }
+  for (const std::string& cluster_name : unchanged_clusters) {
+    clusters_to_remove.erase(cluster_name);
   }
-  onConfigUpdate(to_add_repeated, to_remove_repeated, version_info);
+  std::vector<std::string> removed_clusters;
+  removed_clusters.reserve(clusters_to_remove.size());
+  for (const auto& cluster : clusters_to_remove) {
+    removed_clusters.push_back(cluster.first);
+  }
+  applyUpdate(clusters, unchanged_clusters, removed_clusters, {}, version_info);
 }
 
 void CdsApiImpl::onConfigUpdate(
     const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
     const Protobuf::RepeatedPtrField<std::string>& removed_resources,
     const std::string& system_version_info) {
+  // The current clusters are only looked up if a cluster arrives unchanged.
+  absl::optional<ClusterManager::ClusterInfoMap> current_clusters;
+  std::vector<std::string> exception_msgs;
+  std::vector<ClusterUpdate> clusters;
+  std::vector<std::string> unchanged_clusters;
+  clusters.reserve(added_resources.size());
+  for (const auto& resource : added_resources) {
+    const uint64_t hash = Config::ResourceHashCache::hash(resource.resource());
+    if (resource_hashes_.contains(resource.name(), hash)) {
+      if (!current_clusters.has_value()) {
+        current_clusters = cm_.clusters();
+      }
+      if (current_clusters->count(resource.name()) > 0) {
+        unchanged_clusters.push_back(resource.name());
+        continue;
+      }
+    }
+    try {
+      clusters.push_back({MessageUtil::anyConvert<envoy::api::v2::Cluster>(resource.resource()),
+                          resource.version(), hash});
+    } catch (const EnvoyException& e) {
+      exception_msgs.push_back(fmt::format("{}: {}", resource.name(), e.what()));
+    }
+  }
+  applyUpdate(clusters, unchanged_clusters, {removed_resources.begin(), removed_resources.end()},
+              std::move(exception_msgs), system_version_info);
+}
+
+void CdsApiImpl::applyUpdate(const std::vector<ClusterUpdate>& clusters,
+                             const std::vector<std::string>& unchanged_clusters,
+                             const std::vector<std::string>& removed_clusters,
+                             std::vector<std::string>&& exception_msgs,
+                             const std::string& system_version_info) {
   cm_.adsMux().pause(Config::TypeUrl::get().ClusterLoadAssignment);
   Cleanup eds_resume([this] { cm_.adsMux().resume(Config::TypeUrl::get().ClusterLoadAssignment); });
 
-  std::vector<std::string> exception_msgs;
   std::unordered_set<std::string> cluster_names;
-  for (const auto& resource : added_resources) {
-    envoy::api::v2::Cluster cluster;
+  for (const std::string& cluster_name : unchanged_clusters) {
+    if (!cluster_names.insert(cluster_name).second) {
+      exception_msgs.push_back(
+          fmt::format("{}: duplicate cluster {} found", cluster_name, cluster_name));
+    }
+  }
+  ENVOY_LOG(debug, "cds: {} of {} cluster(s) unchanged", unchanged_clusters.size(),
+            unchanged_clusters.size() + clusters.size());
+  for (const auto& update : clusters) {
+    const envoy::api::v2::Cluster& cluster = update.cluster_;
     try {
-      cluster = MessageUtil::anyConvert<envoy::api::v2::Cluster>(resource.resource());
       MessageUtil::validate(cluster);
       if (!cluster_names.insert(cluster.name()).second) {
         throw EnvoyException(fmt::format("duplicate cluster {} found", cluster.name()));
       }
       if (cm_.addOrUpdateCluster(
-              cluster, resource.version(),
+              cluster, update.version_,
               [this](const std::string&, ClusterManager::ClusterWarmingState state) {
                 // Following if/else block implements a control flow mechanism that can be used
                 // by an ADS implementation to properly sequence CDS and RDS update. It is not
@@ -109,13 +158,15 @@ void CdsApiImpl::onConfigUpdate(
               })) {
         ENVOY_LOG(debug, "cds: add/update cluster '{}'", cluster.name());
       }
+      resource_hashes_.insert(cluster.name(), update.hash_);
     } catch (const EnvoyException& e) {
       exception_msgs.push_back(fmt::format("{}: {}", cluster.name(), e.what()));
     }
   }
-  for (auto resource_name : removed_resources) {
-    if (cm_.removeCluster(resource_name)) {
-      ENVOY_LOG(debug, "cds: remove cluster '{}'", resource_name);
+  for (const std::string& cluster_name : removed_clusters) {
+    resource_hashes_.erase(cluster_name);
+    if (cm_.removeCluster(cluster_name)) {
+      ENVOY_LOG(debug, "cds: remove cluster '{}'", cluster_name);
     }
   }
 
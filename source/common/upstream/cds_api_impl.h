@@ -1,6 +1,8 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <vector>
 
 #include "envoy/api/api.h"
 #include "envoy/api/v2/cds.pb.h"
@@ -11,6 +13,7 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/logger.h"
+#include "common/config/resource_hash_cache.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -46,9 +49,23 @@ public:
   }
 
 private:
+  struct ClusterUpdate {
+    envoy::api::v2::Cluster cluster_;
+    std::string version_;
+    uint64_t hash_;
+  };
+
   CdsApiImpl(const envoy::api::v2::core::ConfigSource& cds_config, ClusterManager& cm,
              Event::Dispatcher& dispatcher, Runtime::RandomGenerator& random,
              const LocalInfo::LocalInfo& local_info, Stats::Scope& scope, Api::Api& api);
+  // Adds or updates the given clusters and removes the named ones. Both kinds of update end up
+  // here, so that each resource is only converted from its Any once. Clusters that arrived with
+  // the same serialized config as when they were last applied are only named, and not converted.
+  void applyUpdate(const std::vector<ClusterUpdate>& clusters,
+                   const std::vector<std::string>& unchanged_clusters,
+                   const std::vector<std::string>& removed_clusters,
+                   std::vector<std::string>&& exception_msgs,
+                   const std::string& system_version_info);
   void runInitializeCallbackIfAny();
 
   ClusterManager& cm_;
@@ -56,6 +73,7 @@ private:
   std::string system_version_info_;
   std::function<void()> initialize_callback_;
   Stats::ScopePtr scope_;
+  Config::ResourceHashCache resource_hashes_;
 };
 
 } // namespace Upstream
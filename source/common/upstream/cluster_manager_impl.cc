@@ -181,7 +181,10 @@ ClusterManagerImpl::ClusterManagerImpl(
       config_tracker_entry_(
           admin.getConfigTracker().add("clusters", [this] { return dumpClusterConfigs(); })),
       time_source_(main_thread_dispatcher.timeSource()), dispatcher_(main_thread_dispatcher),
-      http_context_(http_context) {
+      http_context_(http_context),
+      lazy_clusters_enabled_(bootstrap.cluster_manager().has_lazy_clusters()),
+      lazy_cluster_idle_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(
+          bootstrap.cluster_manager().lazy_clusters(), idle_timeout, 0)) {
   async_client_manager_ =
       std::make_unique<Grpc::AsyncClientManagerImpl>(*this, tls, time_source_, api);
   const auto& cm_config = bootstrap.cluster_manager();
@@ -216,7 +219,8 @@ ClusterManagerImpl::ClusterManagerImpl(
         *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
             "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
         random_, stats_,
-        Envoy::Config::Utility::parseRateLimitSettings(bootstrap.dynamic_resources().ads_config()));
+        Envoy::Config::Utility::parseRateLimitSettings(bootstrap.dynamic_resources().ads_config()),
+        bootstrap.dynamic_resources().ads_config().use_response_arena());
   } else {
     ads_mux_ = std::make_unique<Config::NullGrpcMuxImpl>();
   }
@@ -511,7 +515,19 @@ void ClusterManagerImpl::createOrUpdateThreadLocalCluster(ClusterData& cluster)
     ThreadLocalClusterManagerImpl& cluster_manager =
         tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-    if (cluster_manager.thread_local_clusters_.count(new_cluster->name()) > 0) {
+    const bool exists = cluster_manager.thread_local_clusters_.count(new_cluster->name()) > 0;
+    if (lazy_clusters_enabled_) {
+      // An existing entry is replaced right away, as for eager clusters. Otherwise the entry is
+      // only created on first use.
+      cluster_manager.lazy_clusters_[new_cluster->name()] = {new_cluster, thread_aware_lb_factory,
+                                                             {}};
+      if (!exists && !cluster_manager.createEagerly(*new_cluster)) {
+        ENVOY_LOG(debug, "adding lazy TLS cluster {}", new_cluster->name());
+        return;
+      }
+    }
+
+    if (exists) {
       ENVOY_LOG(debug, "updating TLS cluster {}", new_cluster->name());
     } else {
       ENVOY_LOG(debug, "adding TLS cluster {}", new_cluster->name());
@@ -519,6 +535,7 @@ void ClusterManagerImpl::createOrUpdateThreadLocalCluster(ClusterData& cluster)
 
     auto thread_local_cluster = new ThreadLocalClusterManagerImpl::ClusterEntry(
         cluster_manager, new_cluster, thread_aware_lb_factory);
+    thread_local_cluster->pinned_ = lazy_clusters_enabled_ && cluster_manager.pinned(*new_cluster);
     cluster_manager.thread_local_clusters_[new_cluster->name()].reset(thread_local_cluster);
     for (auto& cb : cluster_manager.update_callbacks_) {
       cb->onClusterAddOrUpdate(*thread_local_cluster);
@@ -540,9 +557,11 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
       ThreadLocalClusterManagerImpl& cluster_manager =
           tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-      ASSERT(cluster_manager.thread_local_clusters_.count(cluster_name) == 1);
+      ASSERT(cluster_manager.thread_local_clusters_.count(cluster_name) == 1 ||
+             cluster_manager.lazy_clusters_.count(cluster_name) == 1);
       ENVOY_LOG(debug, "removing TLS cluster {}", cluster_name);
       cluster_manager.thread_local_clusters_.erase(cluster_name);
+      cluster_manager.lazy_clusters_.erase(cluster_name);
       for (auto& cb : cluster_manager.update_callbacks_) {
         cb->onClusterRemoval(cluster_name);
       }
@@ -627,13 +646,7 @@ void ClusterManagerImpl::updateGauges() {
 
 ThreadLocalCluster* ClusterManagerImpl::get(const std::string& cluster) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
-
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry != cluster_manager.thread_local_clusters_.end()) {
-    return entry->second.get();
-  } else {
-    return nullptr;
-  }
+  return cluster_manager.getClusterEntry(cluster);
 }
 
 Http::ConnectionPool::Instance*
@@ -641,13 +654,13 @@ ClusterManagerImpl::httpConnPoolForCluster(const std::string& cluster, ResourceP
                                            Http::Protocol protocol, LoadBalancerContext* context) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry == cluster_manager.thread_local_clusters_.end()) {
+  auto entry = cluster_manager.getClusterEntry(cluster);
+  if (entry == nullptr) {
     return nullptr;
   }
 
   // Select a host and create a connection pool for it if it does not already exist.
-  return entry->second->connPool(priority, protocol, context);
+  return entry->connPool(priority, protocol, context);
 }
 
 Tcp::ConnectionPool::Instance* ClusterManagerImpl::tcpConnPoolForCluster(
@@ -655,13 +668,13 @@ Tcp::ConnectionPool::Instance* ClusterManagerImpl::tcpConnPoolForCluster(
     Network::TransportSocketOptionsSharedPtr transport_socket_options) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry == cluster_manager.thread_local_clusters_.end()) {
+  auto entry = cluster_manager.getClusterEntry(cluster);
+  if (entry == nullptr) {
     return nullptr;
   }
 
   // Select a host and create a connection pool for it if it does not already exist.
-  return entry->second->tcpConnPool(priority, context, transport_socket_options);
+  return entry->tcpConnPool(priority, context, transport_socket_options);
 }
 
 void ClusterManagerImpl::postThreadLocalHostRemoval(const Cluster& cluster,
@@ -712,16 +725,16 @@ Host::CreateConnectionData ClusterManagerImpl::tcpConnForCluster(
     Network::TransportSocketOptionsSharedPtr transport_socket_options) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry == cluster_manager.thread_local_clusters_.end()) {
+  auto entry = cluster_manager.getClusterEntry(cluster);
+  if (entry == nullptr) {
     throw EnvoyException(fmt::format("unknown cluster '{}'", cluster));
   }
 
-  HostConstSharedPtr logical_host = entry->second->lb_->chooseHost(context);
+  HostConstSharedPtr logical_host = entry->lb_->chooseHost(context);
   if (logical_host) {
     auto conn_info = logical_host->createConnection(cluster_manager.thread_local_dispatcher_,
                                                     nullptr, transport_socket_options);
-    if ((entry->second->cluster_info_->features() &
+    if ((entry->cluster_info_->features() &
          ClusterInfo::Features::CLOSE_CONNECTIONS_ON_HOST_HEALTH_FAILURE) &&
         conn_info.connection_ != nullptr) {
       auto& conn_map = cluster_manager.host_tcp_conn_map_[logical_host];
@@ -731,16 +744,16 @@ Host::CreateConnectionData ClusterManagerImpl::tcpConnForCluster(
     }
     return conn_info;
   } else {
-    entry->second->cluster_info_->stats().upstream_cx_none_healthy_.inc();
+    entry->cluster_info_->stats().upstream_cx_none_healthy_.inc();
     return {nullptr, nullptr};
   }
 }
 
 Http::AsyncClient& ClusterManagerImpl::httpAsyncClientForCluster(const std::string& cluster) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry != cluster_manager.thread_local_clusters_.end()) {
-    return entry->second->http_async_client_;
+  auto entry = cluster_manager.getClusterEntry(cluster);
+  if (entry != nullptr) {
+    return entry->http_async_client_;
   } else {
     throw EnvoyException(fmt::format("unknown cluster '{}'", cluster));
   }
@@ -804,6 +817,7 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl
     auto& local_cluster = parent.active_clusters_.at(local_cluster_name.value());
     thread_local_clusters_[local_cluster_name.value()] = std::make_unique<ClusterEntry>(
         *this, local_cluster->cluster_->info(), local_cluster->loadBalancerFactory());
+    thread_local_clusters_[local_cluster_name.value()]->pinned_ = true;
   }
 
   local_priority_set_ = local_cluster_name
@@ -816,10 +830,27 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl
       continue;
     }
 
+    if (parent.lazy_clusters_enabled_) {
+      lazy_clusters_[cluster.first] = {cluster.second->cluster_->info(),
+                                       cluster.second->loadBalancerFactory(),
+                                       {}};
+      if (!createEagerly(*cluster.second->cluster_->info())) {
+        ENVOY_LOG(debug, "adding lazy TLS initial cluster {}", cluster.first);
+        continue;
+      }
+    }
+
     ENVOY_LOG(debug, "adding TLS initial cluster {}", cluster.first);
     ASSERT(thread_local_clusters_.count(cluster.first) == 0);
     thread_local_clusters_[cluster.first] = std::make_unique<ClusterEntry>(
         *this, cluster.second->cluster_->info(), cluster.second->loadBalancerFactory());
+    thread_local_clusters_[cluster.first]->pinned_ =
+        parent.lazy_clusters_enabled_ && pinned(*cluster.second->cluster_->info());
+  }
+
+  if (parent.lazy_clusters_enabled_ && parent.lazy_cluster_idle_timeout_.count() > 0) {
+    idle_timer_ = dispatcher.createTimer([this]() -> void { onIdleTimer(); });
+    idle_timer_->enableTimer(parent.lazy_cluster_idle_timeout_);
   }
 }
 
@@ -830,6 +861,7 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::~ThreadLocalClusterManagerImp
   // member update callback registered with the local cluster.
   ENVOY_LOG(debug, "shutting down thread local cluster manager");
   destroying_ = true;
+  idle_timer_.reset();
   host_http_conn_pool_map_.clear();
   host_tcp_conn_pool_map_.clear();
   ASSERT(host_tcp_conn_map_.empty());
@@ -956,14 +988,15 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::removeHosts(const std::s
                                                                     ThreadLocal::Slot& tls) {
   ThreadLocalClusterManagerImpl& config = tls.getTyped<ThreadLocalClusterManagerImpl>();
 
-  ASSERT(config.thread_local_clusters_.find(name) != config.thread_local_clusters_.end());
-  const auto& cluster_entry = config.thread_local_clusters_[name];
+  // A lazy cluster may have no entry, but pools of an expired entry may still be draining.
+  ASSERT(config.thread_local_clusters_.find(name) != config.thread_local_clusters_.end() ||
+         config.lazy_clusters_.find(name) != config.lazy_clusters_.end());
   ENVOY_LOG(debug, "removing hosts for TLS cluster {} removed {}", name, hosts_removed.size());
 
   // We need to go through and purge any connection pools for hosts that got deleted.
   // Even if two hosts actually point to the same address this will be safe, since if a
   // host is readded it will be a different physical HostSharedPtr.
-  cluster_entry->parent_.drainConnPools(hosts_removed);
+  config.drainConnPools(hosts_removed);
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
@@ -974,8 +1007,20 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
 
   ThreadLocalClusterManagerImpl& config = tls.getTyped<ThreadLocalClusterManagerImpl>();
 
-  ASSERT(config.thread_local_clusters_.find(name) != config.thread_local_clusters_.end());
-  const auto& cluster_entry = config.thread_local_clusters_[name];
+  // Keep the membership of lazy clusters to create their entries from. The update is copied, as
+  // the shared host vectors are, since it is also applied to the entry if there is one.
+  auto lazy_cluster = config.lazy_clusters_.find(name);
+  if (lazy_cluster != config.lazy_clusters_.end()) {
+    lazy_cluster->second.priority_updates_[priority] = {update_hosts_params, locality_weights,
+                                                        overprovisioning_factor};
+  }
+
+  auto entry = config.thread_local_clusters_.find(name);
+  if (entry == config.thread_local_clusters_.end()) {
+    ASSERT(lazy_cluster != config.lazy_clusters_.end());
+    return;
+  }
+  const auto& cluster_entry = entry->second;
   ENVOY_LOG(debug, "membership update for TLS cluster {} added {} removed {}", name,
             hosts_added.size(), hosts_removed.size());
   cluster_entry->priority_set_.updateHosts(priority, std::move(update_hosts_params),
@@ -1052,6 +1097,78 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::getHttpConnPoolsContainer(
   return &container_iter->second;
 }
 
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::getClusterEntry(const std::string& name) {
+  auto entry = thread_local_clusters_.find(name);
+  if (entry != thread_local_clusters_.end()) {
+    entry->second->used_ = true;
+    return entry->second.get();
+  }
+
+  auto lazy_cluster = lazy_clusters_.find(name);
+  if (lazy_cluster == lazy_clusters_.end()) {
+    return nullptr;
+  }
+  ENVOY_LOG(debug, "creating lazy TLS cluster {}", name);
+  parent_.cm_stats_.lazy_cluster_created_.inc();
+  return &createClusterEntry(name, lazy_cluster->second);
+}
+
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry&
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::createClusterEntry(
+    const std::string& name, const LazyClusterEntry& lazy_cluster) {
+  ClusterEntryPtr& entry = thread_local_clusters_[name];
+  entry =
+      std::make_unique<ClusterEntry>(*this, lazy_cluster.cluster_info_, lazy_cluster.lb_factory_);
+
+  // Bring the new entry up to date as a sequence of membership updates would, with every host of
+  // each priority added.
+  for (const auto& update : lazy_cluster.priority_updates_) {
+    PrioritySet::UpdateHostsParams update_hosts_params = update.second.update_hosts_params_;
+    const HostVector hosts_added = *update_hosts_params.hosts;
+    entry->priority_set_.updateHosts(update.first, std::move(update_hosts_params),
+                                     update.second.locality_weights_, hosts_added, {},
+                                     update.second.overprovisioning_factor_);
+  }
+  if (!lazy_cluster.priority_updates_.empty() && entry->lb_factory_ != nullptr) {
+    entry->lb_ = entry->lb_factory_->create();
+  }
+  return *entry;
+}
+
+bool ClusterManagerImpl::ThreadLocalClusterManagerImpl::pinned(const ClusterInfo& cluster) const {
+  // The original destination LB refers to the main thread's cluster, which can only be looked up
+  // safely while the cluster is being added.
+  return cluster.name() == parent_.local_cluster_name_ ||
+         cluster.lbType() == LoadBalancerType::OriginalDst;
+}
+
+bool ClusterManagerImpl::ThreadLocalClusterManagerImpl::createEagerly(
+    const ClusterInfo& cluster) const {
+  // Update callbacks expect to hear about every cluster as it is added.
+  return pinned(cluster) || !update_callbacks_.empty();
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::onIdleTimer() {
+  // Entries unused since the last sweep are expired. Entries that update callbacks may hold on to,
+  // or with async client requests in flight, are kept.
+  if (update_callbacks_.empty()) {
+    for (auto it = thread_local_clusters_.begin(); it != thread_local_clusters_.end();) {
+      ClusterEntry& entry = *it->second;
+      if (entry.pinned_ || entry.used_ || entry.http_async_client_.hasActiveStreams()) {
+        entry.used_ = false;
+        ++it;
+        continue;
+      }
+      ENVOY_LOG(debug, "expiring idle lazy TLS cluster {}", it->first);
+      parent_.cm_stats_.lazy_cluster_expired_.inc();
+      // Destroying the entry drains the connection pools of its hosts.
+      it = thread_local_clusters_.erase(it);
+    }
+  }
+  idle_timer_->enableTimer(parent_.lazy_cluster_idle_timeout_);
+}
+
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
     ThreadLocalClusterManagerImpl& parent, ClusterInfoConstSharedPtr cluster,
     const LoadBalancerFactorySharedPtr& lb_factory)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -145,6 +146,8 @@ private:
   COUNTER(cluster_removed)                                                                         \
   COUNTER(cluster_updated)                                                                         \
   COUNTER(cluster_updated_via_merge)                                                               \
+  COUNTER(lazy_cluster_created)                                                                    \
+  COUNTER(lazy_cluster_expired)                                                                    \
   COUNTER(update_merge_cancelled)                                                                  \
   COUNTER(update_out_of_merge_window)                                                              \
   GAUGE  (active_clusters)                                                                         \
@@ -311,10 +314,31 @@ private:
       LoadBalancerPtr lb_;
       ClusterInfoConstSharedPtr cluster_info_;
       Http::AsyncClientImpl http_async_client_;
+      // Whether the entry has been used since the last idle sweep, for lazy clusters.
+      bool used_{true};
+      // Whether the entry must not be expired when idle, for lazy clusters.
+      bool pinned_{};
     };
 
     typedef std::unique_ptr<ClusterEntry> ClusterEntryPtr;
 
+    // What a lazy cluster's entry is created from: the cluster and the latest membership of each
+    // of its priorities. The host vectors are the copies posted to all threads, so they are shared
+    // with the other workers.
+    struct LazyClusterEntry {
+      struct PriorityUpdate {
+        PrioritySet::UpdateHostsParams update_hosts_params_;
+        LocalityWeightsConstSharedPtr locality_weights_;
+        uint64_t overprovisioning_factor_;
+      };
+
+      ClusterInfoConstSharedPtr cluster_info_;
+      LoadBalancerFactorySharedPtr lb_factory_;
+      // Keyed and applied in priority order. Each priority only keeps its latest membership, so
+      // the order in which the updates were posted does not matter.
+      std::map<uint32_t, PriorityUpdate> priority_updates_;
+    };
+
     ThreadLocalClusterManagerImpl(ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
                                   const absl::optional<std::string>& local_cluster_name);
     ~ThreadLocalClusterManagerImpl();
@@ -336,9 +360,22 @@ private:
     ConnPoolsContainer* getHttpConnPoolsContainer(const HostConstSharedPtr& host,
                                                   bool allocate = false);
 
+    // Returns the entry of a cluster, creating it first if the cluster is lazy, or nullptr if the
+    // cluster does not exist.
+    ClusterEntry* getClusterEntry(const std::string& name);
+    ClusterEntry& createClusterEntry(const std::string& name, const LazyClusterEntry& lazy_cluster);
+    // Whether a lazy cluster's entry must never be expired.
+    bool pinned(const ClusterInfo& cluster) const;
+    // Whether a lazy cluster's entry must be created as soon as the cluster is added.
+    bool createEagerly(const ClusterInfo& cluster) const;
+    void onIdleTimer();
+
     ClusterManagerImpl& parent_;
     Event::Dispatcher& thread_local_dispatcher_;
     std::unordered_map<std::string, ClusterEntryPtr> thread_local_clusters_;
+    // All clusters, whether or not they have an entry yet, if lazy clusters are enabled.
+    std::unordered_map<std::string, LazyClusterEntry> lazy_clusters_;
+    Event::TimerPtr idle_timer_;
 
     // These maps are owned by the ThreadLocalClusterManagerImpl instead of the ClusterEntry
     // to prevent lifetime/ownership issues when a cluster is dynamically removed.
@@ -465,6 +502,9 @@ private:
   ClusterUpdatesMap updates_map_;
   Event::Dispatcher& dispatcher_;
   Http::Context& http_context_;
+  const bool lazy_clusters_enabled_;
+  // Zero if lazy cluster entries are never expired.
+  const std::chrono::milliseconds lazy_cluster_idle_timeout_;
 };
 
 } // namespace Upstream
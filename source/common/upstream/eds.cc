@@ -27,7 +27,10 @@ EdsClusterImpl::EdsClusterImpl(
   subscription_ = Config::SubscriptionFactory::subscriptionFromConfigSource(
       eds_config, local_info_, dispatcher, cm, random, info_->statsScope(),
       "envoy.api.v2.EndpointDiscoveryService.FetchEndpoints",
-      "envoy.api.v2.EndpointDiscoveryService.StreamEndpoints",
+      eds_config.api_config_source().api_type() ==
+              envoy::api::v2::core::ApiConfigSource::DELTA_GRPC
+          ? "envoy.api.v2.EndpointDiscoveryService.DeltaEndpoints"
+          : "envoy.api.v2.EndpointDiscoveryService.StreamEndpoints",
       Grpc::Common::typeUrl(envoy::api::v2::ClusterLoadAssignment().GetDescriptor()->full_name()),
       factory_context.api());
 }
@@ -136,6 +139,23 @@ void EdsClusterImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt
   priority_set_.batchHostUpdate(helper);
 }
 
+void EdsClusterImpl::onConfigUpdate(
+    const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
+    const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+    const std::string& system_version_info) {
+  // The subscription is for this cluster's assignment alone, which the batch update then diffs
+  // against the current hosts. A removed assignment leaves the hosts in place, as when a
+  // state-of-the-world update lacks it.
+  if (!removed_resources.empty()) {
+    ENVOY_LOG(debug, "eds: ignoring removal of ClusterLoadAssignment for {}", cluster_name_);
+  }
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> resources;
+  for (const auto& resource : added_resources) {
+    *resources.Add() = resource.resource();
+  }
+  onConfigUpdate(resources, system_version_info);
+}
+
 void EdsClusterImpl::onAssignmentTimeout() {
   // We can no longer use the assignments, remove them.
   // TODO(vishalpowar) This is not going to work for incremental updates, and we
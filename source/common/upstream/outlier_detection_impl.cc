@@ -16,11 +16,27 @@
 #include "common/common/utility.h"
 #include "common/http/codes.h"
 #include "common/protobuf/utility.h"
+#include "common/runtime/key_registry.h"
+#include "common/singleton/const_singleton.h"
 
 namespace Envoy {
 namespace Upstream {
 namespace Outlier {
 
+namespace {
+
+// Runtime keys that are looked up for every response.
+struct RuntimeKeyValues {
+  const Runtime::Key ConsecutiveGatewayFailure{Runtime::KeyRegistrySingleton::get().resolve(
+      "outlier_detection.consecutive_gateway_failure")};
+  const Runtime::Key Consecutive5xx{
+      Runtime::KeyRegistrySingleton::get().resolve("outlier_detection.consecutive_5xx")};
+};
+
+using RuntimeKeys = ConstSingleton<RuntimeKeyValues>;
+
+} // namespace
+
 DetectorSharedPtr DetectorImplFactory::createForCluster(
     Cluster& cluster, const envoy::api::v2::Cluster& cluster_config, Event::Dispatcher& dispatcher,
     Runtime::Loader& runtime, EventLoggerSharedPtr event_logger) {
@@ -58,7 +74,7 @@ void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
     }
     if (Http::CodeUtility::isGatewayError(response_code)) {
       if (++consecutive_gateway_failure_ == detector->runtime().snapshot().getInteger(
-                                                "outlier_detection.consecutive_gateway_failure",
+                                                RuntimeKeys::get().ConsecutiveGatewayFailure,
                                                 detector->config().consecutiveGatewayFailure())) {
         detector->onConsecutiveGatewayFailure(host_.lock());
       }
@@ -67,7 +83,7 @@ void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
     }
 
     if (++consecutive_5xx_ ==
-        detector->runtime().snapshot().getInteger("outlier_detection.consecutive_5xx",
+        detector->runtime().snapshot().getInteger(RuntimeKeys::get().Consecutive5xx,
                                                   detector->config().consecutive5xx())) {
       detector->onConsecutive5xx(host_.lock());
     }
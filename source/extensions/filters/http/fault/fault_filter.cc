@@ -38,8 +38,8 @@ FaultSettings::FaultSettings(const envoy::config::filter::http::fault::v2::HTTPF
         std::make_unique<Filters::Common::Fault::FaultDelayConfig>(fault.delay());
   }
 
-  for (const Http::HeaderUtility::HeaderData& header_map : fault.headers()) {
-    fault_filter_headers_.push_back(header_map);
+  for (const envoy::api::v2::route::HeaderMatcher& header_map : fault.headers()) {
+    fault_filter_headers_.emplace_back(header_map);
   }
 
   upstream_cluster_ = fault.upstream_cluster();
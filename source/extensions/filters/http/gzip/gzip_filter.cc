@@ -26,6 +26,13 @@ const uint64_t MinimumContentLength = 30;
 // When summed to window bits, this sets a gzip header and trailer around the compressed data.
 const uint64_t GzipHeaderValue = 16;
 
+// Maximum number of idle deflate states that each worker keeps for a filter config. Every config has
+// its own pool per worker, and all its states share one set of parameters. A state takes
+// (1 << (window_bits + 2)) + (1 << (memory_level + 9)) bytes plus about 6KB, which is about 38KB
+// with the defaults of this filter and about 390KB with the largest window bits and memory level,
+// so the idle states of a config take up to about 6MB per worker.
+const uint64_t MaxIdleDeflateStates = 16;
+
 // Used for verifying accept-encoding values.
 const char ZeroQvalueString[] = "q=0";
 
@@ -41,7 +48,7 @@ const std::vector<std::string>& defaultContentEncoding() {
 
 GzipFilterConfig::GzipFilterConfig(const envoy::config::filter::http::gzip::v2::Gzip& gzip,
                                    const std::string& stats_prefix, Stats::Scope& scope,
-                                   Runtime::Loader& runtime)
+                                   Runtime::Loader& runtime, ThreadLocal::SlotAllocator& tls)
     : compression_level_(compressionLevelEnum(gzip.compression_level())),
       compression_strategy_(compressionStrategyEnum(gzip.compression_strategy())),
       content_length_(contentLengthUint(gzip.content_length().value())),
@@ -50,7 +57,12 @@ GzipFilterConfig::GzipFilterConfig(const envoy::config::filter::http::gzip::v2::
       content_type_values_(contentTypeSet(gzip.content_type())),
       disable_on_etag_header_(gzip.disable_on_etag_header()),
       remove_accept_encoding_header_(gzip.remove_accept_encoding_header()),
-      stats_(generateStats(stats_prefix + "gzip.", scope)), runtime_(runtime) {}
+      stats_(generateStats(stats_prefix + "gzip.", scope)), runtime_(runtime),
+      tls_(tls.allocateSlot()) {
+  tls_->set([](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ThreadLocalDeflateStatePool>(MaxIdleDeflateStates);
+  });
+}
 
 Compressor::ZlibCompressorImpl::CompressionLevel GzipFilterConfig::compressionLevelEnum(
     envoy::config::filter::http::gzip::v2::Gzip_CompressionLevel_Enum compression_level) {
@@ -128,7 +140,7 @@ Http::FilterHeadersStatus GzipFilter::encodeHeaders(Http::HeaderMap& headers, bo
     headers.removeContentLength();
     headers.insertContentEncoding().value(Http::Headers::get().ContentEncodingValues.Gzip);
     compressor_.init(config_->compressionLevel(), config_->compressionStrategy(),
-                     config_->windowBits(), config_->memoryLevel());
+                     config_->windowBits(), config_->memoryLevel(), config_->deflateStatePool());
     config_->stats().compressed_.inc();
   } else if (!skip_compression_) {
     skip_compression_ = true;
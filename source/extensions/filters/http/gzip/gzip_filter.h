@@ -7,6 +7,7 @@
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/compressor/zlib_compressor_impl.h"
@@ -59,8 +60,8 @@ class GzipFilterConfig {
 
 public:
   GzipFilterConfig(const envoy::config::filter::http::gzip::v2::Gzip& gzip,
-                   const std::string& stats_prefix,
-                   Stats::Scope& scope, Runtime::Loader& runtime);
+                   const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+                   ThreadLocal::SlotAllocator& tls);
 
   Compressor::ZlibCompressorImpl::CompressionLevel compressionLevel() const {
     return compression_level_;
@@ -78,7 +79,21 @@ public:
   uint64_t minimumLength() const { return content_length_; }
   uint64_t windowBits() const { return window_bits_; }
 
+  /**
+   * @return the deflate state pool of the calling thread.
+   */
+  const Compressor::ZlibDeflateStatePoolSharedPtr& deflateStatePool() const {
+    return tls_->getTyped<ThreadLocalDeflateStatePool>().pool_;
+  }
+
 private:
+  struct ThreadLocalDeflateStatePool : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalDeflateStatePool(uint64_t max_idle_states)
+        : pool_(std::make_shared<Compressor::ZlibDeflateStatePool>(max_idle_states)) {}
+
+    const Compressor::ZlibDeflateStatePoolSharedPtr pool_;
+  };
+
   static Compressor::ZlibCompressorImpl::CompressionLevel compressionLevelEnum(
       envoy::config::filter::http::gzip::v2::Gzip_CompressionLevel_Enum compression_level);
   static Compressor::ZlibCompressorImpl::CompressionStrategy compressionStrategyEnum(
@@ -106,6 +121,7 @@ private:
   bool remove_accept_encoding_header_;
   GzipStats stats_;
   Runtime::Loader& runtime_;
+  ThreadLocal::SlotPtr tls_;
 };
 typedef std::shared_ptr<GzipFilterConfig> GzipFilterConfigSharedPtr;
 
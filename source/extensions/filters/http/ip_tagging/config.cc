@@ -2,6 +2,7 @@
 
 #include "envoy/config/filter/http/ip_tagging/v2/ip_tagging.pb.validate.h"
 #include "envoy/registry/registry.h"
+#include "envoy/singleton/manager.h"
 
 #include "common/protobuf/utility.h"
 
@@ -12,12 +13,25 @@ namespace Extensions {
 namespace HttpFilters {
 namespace IpTagging {
 
+// Singleton registration via macro defined in envoy/singleton/manager.h
+SINGLETON_MANAGER_REGISTRATION(ip_tags_file_registry);
+
 Http::FilterFactoryCb IpTaggingFilterFactory::createFilterFactoryFromProtoTyped(
     const envoy::config::filter::http::ip_tagging::v2::IPTagging& proto_config,
     const std::string& stat_prefix, Server::Configuration::FactoryContext& context) {
 
-  IpTaggingFilterConfigSharedPtr config(
-      new IpTaggingFilterConfig(proto_config, stat_prefix, context.scope(), context.runtime()));
+  IpTagsFileProviderSharedPtr tags_file;
+  if (!proto_config.ip_tags_path().empty()) {
+    tags_file = context.singletonManager()
+                    .getTyped<IpTagsFileRegistry>(
+                        SINGLETON_MANAGER_REGISTERED_NAME(ip_tags_file_registry),
+                        [] { return std::make_shared<IpTagsFileRegistry>(); })
+                    ->getProvider(proto_config.ip_tags_path(), context.dispatcher(),
+                                  context.threadLocal());
+  }
+
+  IpTaggingFilterConfigSharedPtr config(new IpTaggingFilterConfig(
+      proto_config, stat_prefix, context.scope(), context.runtime(), std::move(tags_file)));
 
   return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamDecoderFilter(std::make_shared<IpTaggingFilter>(config));
@@ -11,9 +11,12 @@
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/scope.h"
 
+#include "common/common/assert.h"
 #include "common/network/cidr_range.h"
 #include "common/network/lc_trie.h"
 
+#include "extensions/filters/http/ip_tagging/ip_tags_file.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -29,19 +32,23 @@ enum class FilterRequestType { INTERNAL, EXTERNAL, BOTH };
  */
 class IpTaggingFilterConfig {
 public:
+  /**
+   * @param tags_file supplies the provider of the IP tags file, which must be set if and only if
+   *                  config.ip_tags_path() is set.
+   */
   IpTaggingFilterConfig(const envoy::config::filter::http::ip_tagging::v2::IPTagging& config,
                         const std::string& stat_prefix, Stats::Scope& scope,
-                        Runtime::Loader& runtime)
+                        Runtime::Loader& runtime, IpTagsFileProviderSharedPtr tags_file = nullptr)
       : request_type_(requestTypeEnum(config.request_type())), scope_(scope), runtime_(runtime),
-        stats_prefix_(stat_prefix + "ip_tagging.") {
-
-    // Once loading IP tags from a file system is supported, the restriction on the size
-    // of the set should be removed and observability into what tags are loaded needs
-    // to be implemented.
-    // TODO(ccaraman): Remove size check once file system support is implemented.
-    // Work is tracked by issue https://github.com/envoyproxy/envoy/issues/2695.
-    if (config.ip_tags().empty()) {
-      throw EnvoyException("HTTP IP Tagging Filter requires ip_tags to be specified.");
+        stats_prefix_(stat_prefix + "ip_tagging."), tags_file_(std::move(tags_file)) {
+
+    if (config.ip_tags().empty() == config.ip_tags_path().empty()) {
+      throw EnvoyException("HTTP IP Tagging Filter requires exactly one of ip_tags or ip_tags_path "
+                           "to be specified.");
+    }
+    if (!config.ip_tags_path().empty()) {
+      ASSERT(tags_file_ != nullptr);
+      return;
     }
 
     // TODO(ccaraman): Reduce the amount of copies operations performed to build the
@@ -73,7 +80,9 @@ public:
   Runtime::Loader& runtime() { return runtime_; }
   Stats::Scope& scope() { return scope_; }
   FilterRequestType requestType() const { return request_type_; }
-  const Network::LcTrie::LcTrie<std::string>& trie() const { return *trie_; }
+  std::vector<std::string> getTags(const Network::Address::InstanceConstSharedPtr& address) const {
+    return tags_file_ != nullptr ? tags_file_->tags().getTags(address) : trie_->getData(address);
+  }
   const std::string& statsPrefix() const { return stats_prefix_; }
 
 private:
@@ -95,7 +104,10 @@ private:
   Stats::Scope& scope_;
   Runtime::Loader& runtime_;
   const std::string stats_prefix_;
+  // Exactly one of the two is set, depending on whether the tags are configured inline or loaded
+  // from a file.
   std::unique_ptr<Network::LcTrie::LcTrie<std::string>> trie_;
+  const IpTagsFileProviderSharedPtr tags_file_;
 };
 
 typedef std::shared_ptr<IpTaggingFilterConfig> IpTaggingFilterConfigSharedPtr;
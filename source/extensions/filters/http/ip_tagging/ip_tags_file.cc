@@ -0,0 +1,237 @@
+#include "extensions/filters/http/ip_tagging/ip_tags_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/network/address_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace IpTagging {
+
+namespace {
+
+constexpr char Magic[] = "ENVOYIPT";
+constexpr size_t MagicSize = sizeof(Magic) - 1;
+constexpr uint32_t FormatVersion = 1;
+constexpr size_t HeaderSize = 24;
+constexpr size_t TagEntrySize = 8;
+constexpr size_t RangeEntrySize = 24;
+
+void appendUint32(std::string& output, uint32_t value) {
+  for (size_t i = 0; i < sizeof(value); i++) {
+    output.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+} // namespace
+
+IpTagsFile::IpTagsFile(const std::string& path, const uint8_t* data, size_t size)
+    : path_(path), data_(data), size_(size) {}
+
+IpTagsFile::~IpTagsFile() { munmap(const_cast<uint8_t*>(data_), size_); }
+
+std::shared_ptr<const IpTagsFile> IpTagsFile::load(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw EnvoyException(
+        fmt::format("unable to open IP tags file '{}': {}", path, strerror(errno)));
+  }
+  struct stat info;
+  if (::fstat(fd, &info) == -1) {
+    const int error = errno;
+    ::close(fd);
+    throw EnvoyException(
+        fmt::format("unable to stat IP tags file '{}': {}", path, strerror(error)));
+  }
+  const size_t size = info.st_size;
+  if (size < HeaderSize) {
+    ::close(fd);
+    throw EnvoyException(fmt::format("IP tags file '{}' is truncated", path));
+  }
+  // The mapping stays valid after the file is replaced, because replacing a file by moving a new
+  // one into its place leaves the mapped inode unmodified.
+  void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  const int error = errno;
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    throw EnvoyException(fmt::format("unable to map IP tags file '{}': {}", path, strerror(error)));
+  }
+
+  std::shared_ptr<IpTagsFile> file(new IpTagsFile(path, static_cast<const uint8_t*>(data), size));
+  file->parse();
+  return file;
+}
+
+uint32_t IpTagsFile::readUint32(size_t offset) const {
+  ASSERT(offset + sizeof(uint32_t) <= size_);
+  const uint8_t* bytes = data_ + offset;
+  return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+         static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+void IpTagsFile::parse() {
+  if (memcmp(data_, Magic, MagicSize) != 0) {
+    throw EnvoyException(fmt::format("'{}' is not an IP tags file", path_));
+  }
+  if (readUint32(8) != FormatVersion) {
+    throw EnvoyException(fmt::format("IP tags file '{}' has unsupported version {}", path_,
+                                     readUint32(8)));
+  }
+  const uint32_t num_tags = readUint32(12);
+  const uint32_t num_ranges = readUint32(16);
+  const uint64_t ranges_offset = HeaderSize + uint64_t(TagEntrySize) * num_tags;
+  if (readUint32(20) != 0 || ranges_offset + uint64_t(RangeEntrySize) * num_ranges > size_) {
+    throw EnvoyException(fmt::format("IP tags file '{}' is truncated", path_));
+  }
+
+  tag_names_.reserve(num_tags);
+  for (uint32_t i = 0; i < num_tags; i++) {
+    const uint64_t name_offset = readUint32(HeaderSize + TagEntrySize * i);
+    const uint64_t name_length = readUint32(HeaderSize + TagEntrySize * i + 4);
+    if (name_offset + name_length > size_) {
+      throw EnvoyException(
+          fmt::format("IP tags file '{}' has an out of bounds name for tag {}", path_, i));
+    }
+    tag_names_.emplace_back(reinterpret_cast<const char*>(data_ + name_offset), name_length);
+  }
+
+  std::vector<std::pair<uint32_t, std::vector<Network::Address::CidrRange>>> tag_data(num_tags);
+  for (uint32_t i = 0; i < num_tags; i++) {
+    tag_data[i].first = i;
+  }
+  for (uint32_t i = 0; i < num_ranges; i++) {
+    const size_t offset = ranges_offset + RangeEntrySize * i;
+    const uint32_t tag = readUint32(offset);
+    const uint8_t version = data_[offset + 4];
+    const uint8_t length = data_[offset + 5];
+    const uint8_t* address_bytes = data_ + offset + 8;
+    if (tag >= num_tags) {
+      throw EnvoyException(
+          fmt::format("IP tags file '{}' has an invalid tag index in range {}", path_, i));
+    }
+
+    Network::Address::InstanceConstSharedPtr address;
+    if (version == 4 && length <= 32) {
+      sockaddr_in sin;
+      memset(&sin, 0, sizeof(sin));
+      sin.sin_family = AF_INET;
+      memcpy(&sin.sin_addr, address_bytes, sizeof(sin.sin_addr));
+      address = std::make_shared<Network::Address::Ipv4Instance>(&sin);
+    } else if (version == 6 && length <= 128) {
+      sockaddr_in6 sin6;
+      memset(&sin6, 0, sizeof(sin6));
+      sin6.sin6_family = AF_INET6;
+      memcpy(&sin6.sin6_addr, address_bytes, sizeof(sin6.sin6_addr));
+      address = std::make_shared<Network::Address::Ipv6Instance>(sin6);
+    } else {
+      throw EnvoyException(fmt::format("IP tags file '{}' has an invalid CIDR range {}", path_, i));
+    }
+    tag_data[tag].second.push_back(Network::Address::CidrRange::create(address, length));
+  }
+
+  trie_ = std::make_unique<Network::LcTrie::LcTrie<uint32_t>>(tag_data);
+}
+
+std::string IpTagsFile::encode(
+    const std::vector<std::pair<std::string, std::vector<Network::Address::CidrRange>>>&
+        tag_data) {
+  uint32_t num_ranges = 0;
+  for (const auto& tag : tag_data) {
+    num_ranges += tag.second.size();
+  }
+
+  std::string output(Magic, MagicSize);
+  appendUint32(output, FormatVersion);
+  appendUint32(output, tag_data.size());
+  appendUint32(output, num_ranges);
+  appendUint32(output, 0);
+
+  uint32_t name_offset = HeaderSize + TagEntrySize * tag_data.size() + RangeEntrySize * num_ranges;
+  for (const auto& tag : tag_data) {
+    appendUint32(output, name_offset);
+    appendUint32(output, tag.first.size());
+    name_offset += tag.first.size();
+  }
+
+  for (uint32_t i = 0; i < tag_data.size(); i++) {
+    for (const Network::Address::CidrRange& range : tag_data[i].second) {
+      appendUint32(output, i);
+      char address_bytes[16] = {};
+      if (range.ip()->version() == Network::Address::IpVersion::v4) {
+        output.push_back(4);
+        const uint32_t address = range.ip()->ipv4()->address();
+        memcpy(address_bytes, &address, sizeof(address));
+      } else {
+        output.push_back(6);
+        const absl::uint128 address = range.ip()->ipv6()->address();
+        memcpy(address_bytes, &address, sizeof(address));
+      }
+      output.push_back(static_cast<char>(range.length()));
+      output.append(2, '\0');
+      output.append(address_bytes, sizeof(address_bytes));
+    }
+  }
+
+  for (const auto& tag : tag_data) {
+    output.append(tag.first);
+  }
+  return output;
+}
+
+std::vector<std::string>
+IpTagsFile::getTags(const Network::Address::InstanceConstSharedPtr& address) const {
+  std::vector<std::string> tags;
+  for (const uint32_t tag : trie_->getData(address)) {
+    tags.emplace_back(tag_names_[tag]);
+  }
+  return tags;
+}
+
+IpTagsFileProvider::IpTagsFileProvider(const std::string& path, Event::Dispatcher& dispatcher,
+                                       ThreadLocal::SlotAllocator& tls,
+                                       IpTagsFileRegistrySharedPtr registry)
+    : path_(path), tls_(tls.allocateSlot()), watcher_(dispatcher.createFilesystemWatcher()),
+      registry_(std::move(registry)) {
+  setTags(IpTagsFile::load(path_));
+  watcher_->addWatch(path_, Filesystem::Watcher::Events::MovedTo, [this](uint32_t) {
+    try {
+      setTags(IpTagsFile::load(path_));
+      ENVOY_LOG(info, "reloaded IP tags file '{}'", path_);
+    } catch (const EnvoyException& e) {
+      ENVOY_LOG(warn, "failed to reload IP tags file, keeping the previous tags: {}", e.what());
+    }
+  });
+}
+
+void IpTagsFileProvider::setTags(IpTagsFileConstSharedPtr tags) {
+  tls_->set(
+      [tags = std::move(tags)](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+        return std::make_shared<ThreadLocalTags>(tags);
+      });
+}
+
+IpTagsFileProviderSharedPtr IpTagsFileRegistry::getProvider(const std::string& path,
+                                                            Event::Dispatcher& dispatcher,
+                                                            ThreadLocal::SlotAllocator& tls) {
+  IpTagsFileProviderSharedPtr provider = providers_[path].lock();
+  if (provider == nullptr) {
+    provider = std::make_shared<IpTagsFileProvider>(path, dispatcher, tls, shared_from_this());
+    providers_[path] = provider;
+  }
+  return provider;
+}
+
+} // namespace IpTagging
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
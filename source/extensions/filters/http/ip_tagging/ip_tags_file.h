@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/filesystem/watcher.h"
+#include "envoy/network/address.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/logger.h"
+#include "common/network/cidr_range.h"
+#include "common/network/lc_trie.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace IpTagging {
+
+/**
+ * IP tags loaded from a memory-mapped binary file. The file is mapped read-only and tag names are
+ * referenced in place, so only the LC trie is allocated on the heap.
+ *
+ * File layout, in which all integers are little-endian:
+ *   offset   size    field
+ *   0        8       magic "ENVOYIPT"
+ *   8        4       format version, currently 1
+ *   12       4       number of tags (N)
+ *   16       4       number of CIDR ranges (M)
+ *   20       4       reserved, must be 0
+ *   24       8 * N   tags: offset of the name from the start of the file (4 bytes), length of the
+ *                    name (4 bytes)
+ *   24 + 8N  24 * M  CIDR ranges: index of the tag (4 bytes), IP version, 4 or 6 (1 byte),
+ *                    prefix length (1 byte), reserved (2 bytes), address in network byte order
+ *                    (16 bytes, of which IPv4 addresses use the first 4)
+ *   ...              tag names
+ */
+class IpTagsFile {
+public:
+  ~IpTagsFile();
+
+  /**
+   * Map and parse an IP tags file.
+   * @param path supplies the path of the file.
+   * @return the parsed file.
+   * @throw EnvoyException if the file can't be mapped or is malformed.
+   */
+  static std::shared_ptr<const IpTagsFile> load(const std::string& path);
+
+  /**
+   * Serialize IP tags into the file format.
+   * @param tag_data supplies the tag names and their CIDR ranges.
+   * @return the contents of the file.
+   */
+  static std::string
+  encode(const std::vector<std::pair<std::string, std::vector<Network::Address::CidrRange>>>&
+             tag_data);
+
+  /**
+   * @param address supplies the IP address to look up.
+   * @return the names of the tags with a CIDR range containing the address.
+   */
+  std::vector<std::string> getTags(const Network::Address::InstanceConstSharedPtr& address) const;
+
+  /**
+   * @return the number of tags in the file.
+   */
+  size_t numTags() const { return tag_names_.size(); }
+
+private:
+  IpTagsFile(const std::string& path, const uint8_t* data, size_t size);
+
+  void parse();
+  uint32_t readUint32(size_t offset) const;
+
+  const std::string path_;
+  const uint8_t* const data_;
+  const size_t size_;
+  std::vector<absl::string_view> tag_names_;
+  std::unique_ptr<Network::LcTrie::LcTrie<uint32_t>> trie_;
+};
+
+typedef std::shared_ptr<const IpTagsFile> IpTagsFileConstSharedPtr;
+
+class IpTagsFileRegistry;
+typedef std::shared_ptr<IpTagsFileRegistry> IpTagsFileRegistrySharedPtr;
+
+/**
+ * Keeps the IP tags of a file current on all threads. The file is reloaded whenever a new file is
+ * moved into its place, after which each worker switches over to the new tags at once. A file
+ * that fails to load on reload is logged and ignored, and the previous tags stay in use.
+ */
+class IpTagsFileProvider : Logger::Loggable<Logger::Id::filter> {
+public:
+  /**
+   * @throw EnvoyException if the initial load of the file fails.
+   */
+  IpTagsFileProvider(const std::string& path, Event::Dispatcher& dispatcher,
+                     ThreadLocal::SlotAllocator& tls, IpTagsFileRegistrySharedPtr registry);
+
+  /**
+   * @return the current tags on the calling thread. The reference is valid until the calling
+   *         thread returns to its event loop.
+   */
+  const IpTagsFile& tags() const { return *tls_->getTyped<ThreadLocalTags>().tags_; }
+
+private:
+  struct ThreadLocalTags : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalTags(IpTagsFileConstSharedPtr tags) : tags_(std::move(tags)) {}
+
+    const IpTagsFileConstSharedPtr tags_;
+  };
+
+  void setTags(IpTagsFileConstSharedPtr tags);
+
+  const std::string path_;
+  ThreadLocal::SlotPtr tls_;
+  Filesystem::WatcherPtr watcher_;
+  // Keeps the registry alive for as long as one of its providers is in use.
+  const IpTagsFileRegistrySharedPtr registry_;
+};
+
+typedef std::shared_ptr<IpTagsFileProvider> IpTagsFileProviderSharedPtr;
+
+/**
+ * Server wide registry of IP tags files, so that all the filters referencing the same file share
+ * one copy of its tags.
+ */
+class IpTagsFileRegistry : public Singleton::Instance,
+                           public std::enable_shared_from_this<IpTagsFileRegistry> {
+public:
+  /**
+   * @return the provider for the file at path, creating it if there isn't one yet.
+   * @throw EnvoyException if a new provider fails to load the file.
+   */
+  IpTagsFileProviderSharedPtr getProvider(const std::string& path, Event::Dispatcher& dispatcher,
+                                          ThreadLocal::SlotAllocator& tls);
+
+private:
+  std::unordered_map<std::string, std::weak_ptr<IpTagsFileProvider>> providers_;
+};
+
+} // namespace IpTagging
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1,6 +1,7 @@
 #include "extensions/filters/http/jwt_authn/matcher.h"
 
 #include "common/common/logger.h"
+#include "common/common/regex.h"
 #include "common/router/config_impl.h"
 
 #include "absl/strings/match.h"
@@ -108,13 +109,13 @@ private:
 };
 
 /**
- * Perform a match against any path with a regex rule.
+ * Perform a match against any path with a regex or safe_regex rule.
  */
 class RegexMatcherImpl : public BaseMatcherImpl {
 public:
-  RegexMatcherImpl(const RequirementRule& rule)
-      : BaseMatcherImpl(rule), regex_(RegexUtil::parseRegex(rule.match().regex())),
-        regex_str_(rule.match().regex()) {}
+  RegexMatcherImpl(const RequirementRule& rule, Regex::CompiledMatcherPtr&& regex,
+                   const std::string& regex_str)
+      : BaseMatcherImpl(rule), regex_(std::move(regex)), regex_str_(regex_str) {}
 
   bool matches(const Http::HeaderMap& headers) const override {
     if (BaseMatcherImpl::matchRoute(headers)) {
@@ -122,7 +123,7 @@ public:
       const absl::string_view query_string = Http::Utility::findQueryStringStart(path);
       absl::string_view path_view = path.getStringView();
       path_view.remove_suffix(query_string.length());
-      if (std::regex_match(path_view.begin(), path_view.end(), regex_)) {
+      if (regex_->match(path_view)) {
         ENVOY_LOG(debug, "Regex requirement '{}' matched.", regex_str_);
         return true;
       }
@@ -132,7 +133,7 @@ public:
 
 private:
   // regex object
-  const std::regex regex_;
+  const Regex::CompiledMatcherPtr regex_;
   // raw regex string, for logging.
   const std::string regex_str_;
 };
@@ -146,7 +147,13 @@ MatcherConstPtr Matcher::create(const RequirementRule& rule) {
   case RouteMatch::PathSpecifierCase::kPath:
     return std::make_unique<PathMatcherImpl>(rule);
   case RouteMatch::PathSpecifierCase::kRegex:
-    return std::make_unique<RegexMatcherImpl>(rule);
+    return std::make_unique<RegexMatcherImpl>(
+        rule, Regex::Utility::parseStdRegexAsCompiledMatcher(rule.match().regex()),
+        rule.match().regex());
+  case RouteMatch::PathSpecifierCase::kSafeRegex:
+    return std::make_unique<RegexMatcherImpl>(
+        rule, Regex::Utility::parseRegex(rule.match().safe_regex()),
+        rule.match().safe_regex().regex());
   // path specifier is required.
   case RouteMatch::PathSpecifierCase::PATH_SPECIFIER_NOT_SET:
   default:
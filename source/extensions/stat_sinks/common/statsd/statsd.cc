@@ -1,5 +1,8 @@
 #include "extensions/stat_sinks/common/statsd/statsd.h"
 
+#include <sys/socket.h>
+
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <string>
@@ -14,6 +17,8 @@
 #include "common/common/utility.h"
 #include "common/config/utility.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace StatSinks {
@@ -38,32 +43,65 @@ void Writer::write(const std::string& message) {
   ::send(io_handle_->fd(), message.c_str(), message.size(), MSG_DONTWAIT);
 }
 
+void Writer::writeBatch(const std::vector<absl::string_view>& packets) {
+#if defined(__linux__)
+  std::vector<iovec> iovecs(packets.size());
+  std::vector<mmsghdr> messages(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    iovecs[i].iov_base = const_cast<char*>(packets[i].data());
+    iovecs[i].iov_len = packets[i].size();
+    messages[i] = {};
+    messages[i].msg_hdr.msg_iov = &iovecs[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+  // sendmmsg() stops at the first datagram that fails. As with write(), datagrams that cannot be
+  // sent right away are dropped, but the rest of the batch is still attempted.
+  size_t sent = 0;
+  while (sent < messages.size()) {
+    const int rc =
+        ::sendmmsg(io_handle_->fd(), &messages[sent], messages.size() - sent, MSG_DONTWAIT);
+    sent += rc > 0 ? rc : 1;
+  }
+#else
+  for (absl::string_view packet : packets) {
+    ::send(io_handle_->fd(), packet.data(), packet.size(), MSG_DONTWAIT);
+  }
+#endif
+}
+
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag,
-                             const std::string& prefix)
+                             const std::string& prefix,
+                             absl::optional<uint64_t> max_bytes_per_datagram)
     : tls_(tls.allocateSlot()), server_address_(std::move(address)), use_tag_(use_tag),
-      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix) {
+      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
+      max_bytes_per_datagram_(max_bytes_per_datagram) {
   tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::make_shared<Writer>(this->server_address_);
   });
 }
 
 void UdpStatsdSink::flush(Stats::Source& source) {
-  Writer& writer = tls_->getTyped<Writer>();
+  formatted_metrics_.beginFlush();
+  DatagramBatch batch(tls_->getTyped<Writer>(), max_bytes_per_datagram_);
   for (const Stats::CounterSharedPtr& counter : source.cachedCounters()) {
     if (counter->used()) {
-      uint64_t delta = counter->latch();
-      writer.write(fmt::format("{}.{}:{}|c{}", prefix_, getName(*counter), delta,
-                               buildTagStr(counter->tags())));
+      const FormattedMetric& formatted = formatMetric(counter, 'c');
+      // Counters that have not changed since the last flush are skipped.
+      const uint64_t delta = counter->latch();
+      if (delta > 0) {
+        batch.add(formatted, delta);
+      }
     }
   }
 
   for (const Stats::GaugeSharedPtr& gauge : source.cachedGauges()) {
     if (gauge->used()) {
-      writer.write(fmt::format("{}.{}:{}|g{}", prefix_, getName(*gauge), gauge->value(),
-                               buildTagStr(gauge->tags())));
+      batch.add(formatMetric(gauge, 'g'), gauge->value());
     }
   }
+  batch.send();
+  formatted_metrics_.endFlush();
 }
 
 void UdpStatsdSink::onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) {
@@ -95,6 +133,64 @@ const std::string UdpStatsdSink::buildTagStr(const std::vector<Stats::Tag>& tags
   return "|#" + StringUtil::join(tag_strings, ",");
 }
 
+const UdpStatsdSink::FormattedMetric&
+UdpStatsdSink::formatMetric(const std::shared_ptr<const Stats::Metric>& metric, char stat_type) {
+  bool is_new;
+  FormattedMetric& formatted = formatted_metrics_.get(metric, is_new);
+  if (is_new) {
+    formatted.text_ = absl::StrCat(prefix_, ".", getName(*metric), ":");
+    formatted.value_offset_ = formatted.text_.size();
+    absl::StrAppend(&formatted.text_, "|", absl::string_view(&stat_type, 1),
+                    buildTagStr(metric->tags()));
+  }
+  return formatted;
+}
+
+UdpStatsdSink::DatagramBatch::DatagramBatch(Writer& writer,
+                                            absl::optional<uint64_t> max_bytes_per_datagram)
+    : writer_(writer), max_bytes_per_datagram_(max_bytes_per_datagram) {
+  datagram_starts_.reserve(DATAGRAMS_PER_BATCH);
+}
+
+void UdpStatsdSink::DatagramBatch::add(const FormattedMetric& formatted, uint64_t value) {
+  char value_str[32];
+  const size_t value_size = StringUtil::itoa(value_str, sizeof(value_str), value);
+  const size_t line_size = formatted.text_.size() + value_size;
+
+  // Lines within a datagram are separated by a newline. Start a new datagram if this line would
+  // not fit in the current one.
+  const bool new_datagram =
+      datagram_starts_.empty() || !max_bytes_per_datagram_.has_value() ||
+      buffer_.size() - datagram_starts_.back() + 1 + line_size > max_bytes_per_datagram_.value();
+  if (new_datagram) {
+    if (datagram_starts_.size() == DATAGRAMS_PER_BATCH) {
+      send();
+    }
+    datagram_starts_.push_back(buffer_.size());
+  } else {
+    buffer_.push_back('\n');
+  }
+  const absl::string_view text(formatted.text_);
+  buffer_.append(text.data(), formatted.value_offset_);
+  buffer_.append(value_str, value_size);
+  buffer_.append(text.data() + formatted.value_offset_, text.size() - formatted.value_offset_);
+}
+
+void UdpStatsdSink::DatagramBatch::send() {
+  if (datagram_starts_.empty()) {
+    return;
+  }
+  std::vector<absl::string_view> datagrams;
+  datagrams.reserve(datagram_starts_.size());
+  for (size_t i = 0; i < datagram_starts_.size(); ++i) {
+    const size_t end = i + 1 < datagram_starts_.size() ? datagram_starts_[i + 1] : buffer_.size();
+    datagrams.emplace_back(buffer_.data() + datagram_starts_[i], end - datagram_starts_[i]);
+  }
+  writer_.writeBatch(datagrams);
+  buffer_.clear();
+  datagram_starts_.clear();
+}
+
 TcpStatsdSink::TcpStatsdSink(const LocalInfo::LocalInfo& local_info,
                              const std::string& cluster_name, ThreadLocal::SlotAllocator& tls,
                              Upstream::ClusterManager& cluster_manager, Stats::Scope& scope,
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "envoy/local_info/local_info.h"
 #include "envoy/network/connection.h"
 #include "envoy/stats/histogram.h"
@@ -14,6 +18,10 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/common/macros.h"
 #include "common/network/io_socket_handle_impl.h"
+#include "common/stats/metric_flush_cache.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -34,6 +42,11 @@ public:
   virtual ~Writer();
 
   virtual void write(const std::string& message);
+  /**
+   * Sends each packet as a datagram of its own. On Linux the packets are handed to the kernel
+   * with a single sendmmsg() call where possible.
+   */
+  virtual void writeBatch(const std::vector<absl::string_view>& packets);
   // Called in unit test to validate address.
   int getFdForTests() const { return io_handle_->fd(); }
 
@@ -42,17 +55,22 @@ private:
 };
 
 /**
- * Implementation of Sink that writes to a UDP statsd address.
+ * Implementation of Sink that writes to a UDP statsd address. Counters and gauges are formatted
+ * straight into a packet buffer, optionally several to a datagram, and the datagrams are handed
+ * to the writer in batches.
  */
 class UdpStatsdSink : public Stats::Sink {
 public:
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix());
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                absl::optional<uint64_t> max_bytes_per_datagram = {});
   // For testing.
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, const std::shared_ptr<Writer>& writer,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix())
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                absl::optional<uint64_t> max_bytes_per_datagram = {})
       : tls_(tls.allocateSlot()), use_tag_(use_tag),
-        prefix_(prefix.empty() ? getDefaultPrefix() : prefix) {
+        prefix_(prefix.empty() ? getDefaultPrefix() : prefix),
+        max_bytes_per_datagram_(max_bytes_per_datagram) {
     tls_->set(
         [writer](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr { return writer; });
   }
@@ -60,21 +78,62 @@ public:
   // Stats::Sink
   void flush(Stats::Source& source) override;
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override;
+  // Each thread writes through its own socket.
+  bool supportsFlushThread() const override { return true; }
 
   // Called in unit test to validate writer construction and address.
   int getFdForTests() { return tls_->getTyped<Writer>().getFdForTests(); }
   bool getUseTagForTest() { return use_tag_; }
   const std::string& getPrefix() { return prefix_; }
+  absl::optional<uint64_t> getMaxBytesPerDatagramForTest() { return max_bytes_per_datagram_; }
 
 private:
+  /**
+   * The text of a metric's statsd line around its value, e.g. "envoy.name:" and "|c|#tag:value".
+   * Building it requires the metric's name and tags, so it is kept across flushes for as long as
+   * the metric is.
+   */
+  struct FormattedMetric {
+    std::string text_;
+    // Offset in text_ at which the value goes.
+    uint32_t value_offset_{};
+  };
+
+  /**
+   * Accumulates statsd lines into datagrams and passes them to the writer in batches.
+   */
+  class DatagramBatch {
+  public:
+    DatagramBatch(Writer& writer, absl::optional<uint64_t> max_bytes_per_datagram);
+
+    void add(const FormattedMetric& formatted, uint64_t value);
+    // Passes the datagrams built so far to the writer.
+    void send();
+
+  private:
+    Writer& writer_;
+    const absl::optional<uint64_t> max_bytes_per_datagram_;
+    std::string buffer_;
+    // Offset in buffer_ of the start of each datagram.
+    std::vector<size_t> datagram_starts_;
+  };
+
+  // Datagrams passed to each Writer::writeBatch() call.
+  static constexpr size_t DATAGRAMS_PER_BATCH = 64;
+
   const std::string getName(const Stats::Metric& metric);
   const std::string buildTagStr(const std::vector<Stats::Tag>& tags);
+  const FormattedMetric& formatMetric(const std::shared_ptr<const Stats::Metric>& metric,
+                                      char stat_type);
 
   ThreadLocal::SlotPtr tls_;
   Network::Address::InstanceConstSharedPtr server_address_;
   const bool use_tag_;
   // Prefix for all flushed stats.
   const std::string prefix_;
+  const absl::optional<uint64_t> max_bytes_per_datagram_;
+  // Only accessed by flush(), which is never called concurrently.
+  Stats::MetricFlushCache<FormattedMetric> formatted_metrics_;
 };
 
 /**
@@ -93,6 +152,8 @@ public:
     tls_->getTyped<TlsSink>().onTimespanComplete(histogram.name(),
                                                  std::chrono::milliseconds(value));
   }
+  // Each thread has its own connection and buffer.
+  bool supportsFlushThread() const override { return true; }
 
   const std::string& getPrefix() { return prefix_; }
 
@@ -23,8 +23,13 @@ Stats::SinkPtr DogStatsdSinkFactory::createStatsSink(const Protobuf::Message& co
   Network::Address::InstanceConstSharedPtr address =
       Network::Address::resolveProtoAddress(sink_config.address());
   ENVOY_LOG(debug, "dog_statsd UDP ip address: {}", address->asString());
+  absl::optional<uint64_t> max_bytes_per_datagram;
+  if (sink_config.has_max_bytes_per_datagram()) {
+    max_bytes_per_datagram = sink_config.max_bytes_per_datagram().value();
+  }
   return std::make_unique<Common::Statsd::UdpStatsdSink>(server.threadLocal(), std::move(address),
-                                                         true, sink_config.prefix());
+                                                         true, sink_config.prefix(),
+                                                         max_bytes_per_datagram);
 }
 
 ProtobufTypes::MessagePtr DogStatsdSinkFactory::createEmptyConfigProto() {
@@ -51,6 +51,8 @@ public:
                                        Buffer::Instance&, Server::AdminStream& admin_stream);
   void flush(Stats::Source& source) override;
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override{};
+  // The rolling windows are read by the admin handler on the main thread.
+  bool supportsFlushThread() const override { return false; }
 
   /**
    * Register a new connection.
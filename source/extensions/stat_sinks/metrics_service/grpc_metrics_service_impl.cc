@@ -34,8 +34,9 @@ void GrpcMetricsStreamerImpl::send(envoy::service::metrics::v2::StreamMetricsMes
 }
 
 MetricsServiceSink::MetricsServiceSink(const GrpcMetricsStreamerSharedPtr& grpc_metrics_streamer,
-                                       TimeSource& time_source)
-    : grpc_metrics_streamer_(grpc_metrics_streamer), time_source_(time_source) {}
+                                       TimeSource& time_source, bool incremental_updates)
+    : grpc_metrics_streamer_(grpc_metrics_streamer), time_source_(time_source),
+      incremental_updates_(incremental_updates) {}
 
 void MetricsServiceSink::flushCounter(const Stats::Counter& counter) {
   io::prometheus::client::MetricFamily* metrics_family = message_.add_envoy_metrics();
@@ -78,6 +79,14 @@ void MetricsServiceSink::flushHistogram(const Stats::ParentHistogram& histogram)
 }
 
 void MetricsServiceSink::flush(Stats::Source& source) {
+  if (incremental_updates_) {
+    flushIncremental(source);
+  } else {
+    flushFull(source);
+  }
+}
+
+void MetricsServiceSink::flushFull(Stats::Source& source) {
   message_.clear_envoy_metrics();
   const std::vector<Stats::CounterSharedPtr>& counters = source.cachedCounters();
   const std::vector<Stats::GaugeSharedPtr>& gauges = source.cachedGauges();
@@ -111,6 +120,98 @@ void MetricsServiceSink::flush(Stats::Source& source) {
   }
 }
 
+void MetricsServiceSink::flushIncremental(Stats::Source& source) {
+  // Ids are only known to the receiver on the stream that defined them, so everything is sent
+  // again on a new stream.
+  if (!grpc_metrics_streamer_->streamActive()) {
+    sent_metrics_.clear();
+    next_id_ = 0;
+  }
+  sent_metrics_.beginFlush();
+  // Cleared repeated fields keep their elements allocated, so after the first flush the message is
+  // rebuilt without allocating unless new metrics are defined.
+  message_.clear_metric_definitions();
+  message_.clear_metric_updates();
+  message_.set_timestamp_ms(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                time_source_.systemTime().time_since_epoch())
+                                .count());
+  bool is_new;
+
+  for (const Stats::CounterSharedPtr& counter : source.cachedCounters()) {
+    if (counter->used()) {
+      SentMetric& sent = sentMetric(counter, MetricDefinition::COUNTER, is_new);
+      const uint64_t value = counter->value();
+      if (is_new || value != sent.value_) {
+        sent.value_ = value;
+        addUpdate(sent, value);
+      }
+    }
+  }
+
+  for (const Stats::GaugeSharedPtr& gauge : source.cachedGauges()) {
+    if (gauge->used()) {
+      SentMetric& sent = sentMetric(gauge, MetricDefinition::GAUGE, is_new);
+      const uint64_t value = gauge->value();
+      if (is_new || value != sent.value_) {
+        sent.value_ = value;
+        addUpdate(sent, value);
+      }
+    }
+  }
+
+  for (const Stats::ParentHistogramSharedPtr& histogram : source.cachedHistograms()) {
+    if (histogram->used()) {
+      const Stats::HistogramStatistics& hist_stats = histogram->intervalStatistics();
+      SentMetric& sent = sentMetric(histogram, MetricDefinition::SUMMARY, is_new);
+      if (is_new) {
+        auto* definition =
+            message_.mutable_metric_definitions(message_.metric_definitions_size() - 1);
+        for (double quantile : hist_stats.supportedQuantiles()) {
+          definition->add_quantiles(quantile);
+        }
+      }
+      // Summaries are only sent for intervals with samples.
+      if (is_new || hist_stats.sampleCount() > 0) {
+        auto& update = addUpdate(sent, hist_stats.sampleCount());
+        for (double value : hist_stats.computedQuantiles()) {
+          update.add_quantile_values(value);
+        }
+      }
+    }
+  }
+
+  sent_metrics_.endFlush();
+
+  if (message_.metric_updates_size() > 0) {
+    grpc_metrics_streamer_->send(message_);
+    if (message_.has_identifier()) {
+      message_.clear_identifier();
+    }
+  }
+}
+
+MetricsServiceSink::SentMetric&
+MetricsServiceSink::sentMetric(const std::shared_ptr<const Stats::Metric>& metric,
+                               MetricDefinition::Type type, bool& is_new) {
+  SentMetric& sent = sent_metrics_.get(metric, is_new);
+  if (is_new) {
+    sent.id_ = next_id_++;
+    auto* definition = message_.add_metric_definitions();
+    definition->set_id(sent.id_);
+    definition->set_name(metric->name());
+    definition->set_type(type);
+  }
+  return sent;
+}
+
+MetricsServiceSink::MetricUpdate& MetricsServiceSink::addUpdate(const SentMetric& sent,
+                                                                uint64_t value) {
+  auto* update = message_.add_metric_updates();
+  update->set_id(sent.id_);
+  update->set_value(value);
+  return *update;
+}
+
 } // namespace MetricsService
 } // namespace StatSinks
 } // namespace Extensions
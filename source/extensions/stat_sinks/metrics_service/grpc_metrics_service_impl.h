@@ -13,6 +13,7 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/stats/metric_flush_cache.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -33,6 +34,12 @@ public:
    */
   virtual void send(envoy::service::metrics::v2::StreamMetricsMessage& message) PURE;
 
+  /**
+   * @return bool whether a stream is open. If not, the next send() starts a new stream, on which
+   *         nothing sent earlier is known.
+   */
+  virtual bool streamActive() const PURE;
+
   // Grpc::TypedAsyncStreamCallbacks
   void onCreateInitialMetadata(Http::HeaderMap&) override {}
   void onReceiveInitialMetadata(Http::HeaderMapPtr&&) override {}
@@ -55,6 +62,7 @@ public:
 
   // GrpcMetricsStreamer
   void send(envoy::service::metrics::v2::StreamMetricsMessage& message) override;
+  bool streamActive() const override { return stream_ != nullptr; }
 
   // Grpc::TypedAsyncStreamCallbacks
   void onRemoteClose(Grpc::Status::GrpcStatus, const std::string&) override { stream_ = nullptr; }
@@ -72,18 +80,43 @@ class MetricsServiceSink : public Stats::Sink {
 public:
   // MetricsService::Sink
   MetricsServiceSink(const GrpcMetricsStreamerSharedPtr& grpc_metrics_streamer,
-                     TimeSource& time_system);
+                     TimeSource& time_system, bool incremental_updates = false);
   void flush(Stats::Source& source) override;
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
+  // The gRPC stream belongs to the main thread's dispatcher.
+  bool supportsFlushThread() const override { return false; }
 
   void flushCounter(const Stats::Counter& counter);
   void flushGauge(const Stats::Gauge& gauge);
   void flushHistogram(const Stats::ParentHistogram& histogram);
 
 private:
+  using MetricDefinition = envoy::service::metrics::v2::StreamMetricsMessage::MetricDefinition;
+  using MetricUpdate = envoy::service::metrics::v2::StreamMetricsMessage::MetricUpdate;
+
+  /**
+   * What was last sent for a metric on the current stream in incremental mode.
+   */
+  struct SentMetric {
+    uint64_t id_{};
+    uint64_t value_{};
+  };
+
+  void flushFull(Stats::Source& source);
+  void flushIncremental(Stats::Source& source);
+  // Returns the entry for the metric, defining it in the message if it has not been sent on the
+  // current stream. Sets is_new if so.
+  SentMetric& sentMetric(const std::shared_ptr<const Stats::Metric>& metric,
+                         MetricDefinition::Type type, bool& is_new);
+  MetricUpdate& addUpdate(const SentMetric& sent, uint64_t value);
+
   GrpcMetricsStreamerSharedPtr grpc_metrics_streamer_;
   envoy::service::metrics::v2::StreamMetricsMessage message_;
   TimeSource& time_source_;
+  const bool incremental_updates_;
+  // Ids of metrics that are dropped from the cache are not reused.
+  Stats::MetricFlushCache<SentMetric> sent_metrics_;
+  uint64_t next_id_{};
 };
 
 } // namespace MetricsService
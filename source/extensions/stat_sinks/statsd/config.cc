@@ -26,8 +26,13 @@ Stats::SinkPtr StatsdSinkFactory::createStatsSink(const Protobuf::Message& confi
     Network::Address::InstanceConstSharedPtr address =
         Network::Address::resolveProtoAddress(statsd_sink.address());
     ENVOY_LOG(debug, "statsd UDP ip address: {}", address->asString());
+    absl::optional<uint64_t> max_bytes_per_datagram;
+    if (statsd_sink.has_max_bytes_per_datagram()) {
+      max_bytes_per_datagram = statsd_sink.max_bytes_per_datagram().value();
+    }
     return std::make_unique<Common::Statsd::UdpStatsdSink>(server.threadLocal(), std::move(address),
-                                                           false, statsd_sink.prefix());
+                                                           false, statsd_sink.prefix(),
+                                                           max_bytes_per_datagram);
   }
   case envoy::config::metrics::v2::StatsdSink::kTcpClusterName:
     ENVOY_LOG(debug, "statsd TCP cluster: {}", statsd_sink.tcp_cluster_name());
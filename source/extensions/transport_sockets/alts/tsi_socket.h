@@ -60,6 +60,7 @@ public:
   absl::string_view failureReason() const override;
   bool canFlushClose() override { return handshake_complete_; }
   const Envoy::Ssl::ConnectionInfo* ssl() const override { return nullptr; }
+  bool passesThrough() const override { return false; }
   Network::IoResult doWrite(Buffer::Instance& buffer, bool end_stream) override;
   void closeSocket(Network::ConnectionEvent event) override;
   Network::IoResult doRead(Buffer::Instance& buffer) override;
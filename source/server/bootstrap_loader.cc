@@ -0,0 +1,325 @@
+#include "server/bootstrap_loader.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/v2/cds.pb.validate.h"
+#include "envoy/api/v2/lds.pb.validate.h"
+#include "envoy/common/exception.h"
+#include "envoy/config/bootstrap/v2/bootstrap.pb.validate.h"
+#include "envoy/runtime/runtime.h"
+
+#include "common/common/fmt.h"
+#include "common/common/hash.h"
+#include "common/common/version.h"
+#include "common/json/json_loader.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Server {
+
+namespace {
+
+// Keys are written out as they were parsed, which only needs escaping for characters that are not
+// valid in proto field names anyway.
+bool needsEscaping(const std::string& key) {
+  for (const char c : key) {
+    if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Appends the JSON of a StaticResources object without its listeners and clusters, which are
+// added to the given vectors instead. Returns false if a key would need escaping.
+bool appendStaticResources(const Json::Object& object, std::string& json,
+                           std::vector<Json::ObjectSharedPtr>& listeners,
+                           std::vector<Json::ObjectSharedPtr>& clusters) {
+  bool ok = true;
+  bool first = true;
+  json += '{';
+  object.iterate([&](const std::string& key, const Json::Object& value) {
+    if (needsEscaping(key)) {
+      ok = false;
+      return false;
+    }
+    if (key == "listeners" && value.isArray()) {
+      const std::vector<Json::ObjectSharedPtr> array = value.asObjectArray();
+      listeners.insert(listeners.end(), array.begin(), array.end());
+      return true;
+    }
+    if (key == "clusters" && value.isArray()) {
+      const std::vector<Json::ObjectSharedPtr> array = value.asObjectArray();
+      clusters.insert(clusters.end(), array.begin(), array.end());
+      return true;
+    }
+    if (!first) {
+      json += ',';
+    }
+    first = false;
+    absl::StrAppend(&json, "\"", key, "\":", value.asJsonString());
+    return true;
+  });
+  json += '}';
+  return ok;
+}
+
+} // namespace
+
+BootstrapLoader::BootstrapLoader(Api::Api& api, uint32_t concurrency,
+                                 const std::string& cache_path)
+    : api_(api), concurrency_(std::max<uint32_t>(concurrency, 1)), cache_path_(cache_path) {}
+
+void BootstrapLoader::load(const std::string& config_path, const std::string& config_yaml,
+                           envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+  std::string contents;
+  if (!config_path.empty()) {
+    contents = api_.fileSystem().fileReadToEnd(config_path);
+  }
+
+  // Binary protos are not worth caching.
+  std::string cache_file;
+  if (!cache_path_.empty() && !absl::EndsWith(config_path, FileExtensions::get().ProtoBinary)) {
+    cache_file = cacheFilePath(contents, config_yaml);
+    if (readCache(cache_file, bootstrap)) {
+      validate(bootstrap);
+      return;
+    }
+  }
+
+  if (!config_path.empty()) {
+    loadFromFile(config_path, contents, bootstrap);
+  }
+  if (!config_yaml.empty()) {
+    envoy::config::bootstrap::v2::Bootstrap bootstrap_override;
+    MessageUtil::loadFromYaml(config_yaml, bootstrap_override);
+    bootstrap.MergeFrom(bootstrap_override);
+  }
+  validate(bootstrap);
+
+  if (!cache_file.empty()) {
+    writeCache(cache_file, bootstrap);
+  }
+}
+
+void BootstrapLoader::loadFromFile(const std::string& path, const std::string& contents,
+                                   envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+  if (absl::EndsWith(path, FileExtensions::get().Yaml)) {
+    loadFromString(contents, true, bootstrap);
+  } else if (absl::EndsWith(path, FileExtensions::get().ProtoBinary) ||
+             absl::EndsWith(path, FileExtensions::get().ProtoText)) {
+    MessageUtil::loadFromFile(path, bootstrap, api_);
+  } else {
+    loadFromString(contents, false, bootstrap);
+  }
+}
+
+void BootstrapLoader::loadFromString(const std::string& contents, bool yaml,
+                                     envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+  Json::ObjectSharedPtr root;
+  if (yaml) {
+    root = Json::Factory::loadFromYamlString(contents);
+  } else {
+    try {
+      root = Json::Factory::loadFromString(contents);
+    } catch (const Json::Exception&) {
+      // Let the proto JSON parser report the error, as for other configs.
+      MessageUtil::loadFromJson(contents, bootstrap);
+      return;
+    }
+  }
+  if (!root->isObject()) {
+    if (yaml) {
+      MessageUtil::loadFromYaml(contents, bootstrap);
+    } else {
+      MessageUtil::loadFromJson(contents, bootstrap);
+    }
+    return;
+  }
+
+  // Split the static listeners and clusters from the rest of the bootstrap.
+  std::vector<Json::ObjectSharedPtr> listeners;
+  std::vector<Json::ObjectSharedPtr> clusters;
+  std::string json = "{";
+  bool split = true;
+  root->iterate([&](const std::string& key, const Json::Object& value) {
+    if (needsEscaping(key)) {
+      split = false;
+      return false;
+    }
+    if (json.size() > 1) {
+      json += ',';
+    }
+    absl::StrAppend(&json, "\"", key, "\":");
+    if ((key == "static_resources" || key == "staticResources") && value.isObject()) {
+      split = appendStaticResources(value, json, listeners, clusters);
+      return split;
+    }
+    json += value.asJsonString();
+    return true;
+  });
+  json += '}';
+  if (!split) {
+    MessageUtil::loadFromJson(root->asJsonString(), bootstrap);
+    return;
+  }
+
+  MessageUtil::loadFromJson(json, bootstrap);
+  if (listeners.empty() && clusters.empty()) {
+    return;
+  }
+  auto& static_resources = *bootstrap.mutable_static_resources();
+  for (size_t i = 0; i < listeners.size(); i++) {
+    static_resources.add_listeners();
+  }
+  for (size_t i = 0; i < clusters.size(); i++) {
+    static_resources.add_clusters();
+  }
+  runInParallel(listeners.size() + clusters.size(), [&](size_t i) {
+    if (i < listeners.size()) {
+      MessageUtil::loadFromJson(listeners[i]->asJsonString(),
+                                *static_resources.mutable_listeners(i));
+    } else {
+      i -= listeners.size();
+      MessageUtil::loadFromJson(clusters[i]->asJsonString(), *static_resources.mutable_clusters(i));
+    }
+  });
+}
+
+void BootstrapLoader::validate(envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+  // The deprecation checks consult the runtime snapshot, which is thread local, so they are only
+  // run in parallel when there is no runtime yet, as at startup.
+  Runtime::Loader* runtime = Runtime::LoaderSingleton::getExisting();
+  if (runtime != nullptr) {
+    MessageUtil::checkForDeprecation(bootstrap, runtime);
+  }
+  const auto validateMessage = [runtime](const auto& message) {
+    if (runtime == nullptr) {
+      MessageUtil::checkForDeprecation(message, nullptr);
+    }
+    std::string err;
+    if (!Validate(message, &err)) {
+      throw ProtoValidationException(err, message);
+    }
+  };
+  if (!bootstrap.has_static_resources()) {
+    validateMessage(bootstrap);
+    return;
+  }
+
+  // Validate the rest of the bootstrap without the static listeners and clusters, which are swapped
+  // back in even if it is invalid.
+  Protobuf::RepeatedPtrField<envoy::api::v2::Listener> listeners;
+  Protobuf::RepeatedPtrField<envoy::api::v2::Cluster> clusters;
+  auto& static_resources = *bootstrap.mutable_static_resources();
+  listeners.Swap(static_resources.mutable_listeners());
+  clusters.Swap(static_resources.mutable_clusters());
+  try {
+    validateMessage(bootstrap);
+  } catch (const EnvoyException&) {
+    listeners.Swap(static_resources.mutable_listeners());
+    clusters.Swap(static_resources.mutable_clusters());
+    throw;
+  }
+  listeners.Swap(static_resources.mutable_listeners());
+  clusters.Swap(static_resources.mutable_clusters());
+
+  const int num_listeners = static_resources.listeners_size();
+  runInParallel(num_listeners + static_resources.clusters_size(), [&](size_t i) {
+    if (i < static_cast<size_t>(num_listeners)) {
+      validateMessage(static_resources.listeners(i));
+    } else {
+      validateMessage(static_resources.clusters(i - num_listeners));
+    }
+  });
+}
+
+void BootstrapLoader::runInParallel(size_t count, const std::function<void(size_t)>& fn) {
+  const size_t num_threads = std::min<size_t>(concurrency_, count);
+  std::vector<std::exception_ptr> errors(count);
+  const auto run = [&](size_t first) {
+    for (size_t i = first; i < count; i += num_threads) {
+      try {
+        fn(i);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (size_t t = 1; t < num_threads; t++) {
+    threads.push_back(api_.threadFactory().createThread([&run, t]() { run(t); }));
+  }
+  run(0);
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  for (const std::exception_ptr& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+std::string BootstrapLoader::cacheFilePath(const std::string& config_contents,
+                                           const std::string& config_yaml) const {
+  // Unknown fields are dropped when they are allowed, so a bootstrap parsed then must not be used
+  // when they are not.
+  uint64_t hash = HashUtil::xxHash64(VersionInfo::revision());
+  hash = HashUtil::xxHash64(config_contents, hash);
+  hash = HashUtil::xxHash64(config_yaml, hash);
+  hash = HashUtil::xxHash64(
+      MessageUtil::proto_unknown_fields == ProtoUnknownFieldsMode::Strict ? "strict" : "allow",
+      hash);
+  return fmt::format("{}/bootstrap_{:016x}.pb", cache_path_, hash);
+}
+
+bool BootstrapLoader::readCache(const std::string& path,
+                                envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+  if (!api_.fileSystem().fileExists(path)) {
+    ENVOY_LOG(debug, "bootstrap cache miss: {}", path);
+    return false;
+  }
+  try {
+    if (bootstrap.ParseFromString(api_.fileSystem().fileReadToEnd(path))) {
+      ENVOY_LOG(info, "loaded bootstrap from cache {}", path);
+      return true;
+    }
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "unable to read bootstrap cache {}: {}", path, e.what());
+  }
+  ENVOY_LOG(warn, "ignoring invalid bootstrap cache {}", path);
+  bootstrap.Clear();
+  return false;
+}
+
+void BootstrapLoader::writeCache(const std::string& path,
+                                 const envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+  // Write to a file of our own and rename it, so that a concurrent start never reads a partially
+  // written cache.
+  const std::string tmp_path = fmt::format("{}.{}.tmp", path, ::getpid());
+  bool written;
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    written = file.is_open() && bootstrap.SerializeToOstream(&file);
+  }
+  if (!written || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    ENVOY_LOG(warn, "unable to write bootstrap cache {}", path);
+    std::remove(tmp_path.c_str());
+  }
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "envoy/api/api.h"
+#include "envoy/config/bootstrap/v2/bootstrap.pb.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Loads and validates the bootstrap config. Static listeners and clusters are independent of each
+ * other and of the rest of the bootstrap, so the YAML or JSON of each is converted to a proto and
+ * validated on a short-lived set of threads. Optionally, parsed bootstraps are cached as binary
+ * protos in a directory, keyed by a hash of the config and of the Envoy build, so that a restart
+ * with the same config skips YAML and JSON parsing.
+ */
+class BootstrapLoader : Logger::Loggable<Logger::Id::config> {
+public:
+  /**
+   * @param api supplies the API used to read files and create threads.
+   * @param concurrency supplies the maximum number of threads to load resources on, including the
+   *        calling thread.
+   * @param cache_path supplies the directory to cache parsed bootstraps in, or empty for none.
+   */
+  BootstrapLoader(Api::Api& api, uint32_t concurrency, const std::string& cache_path);
+
+  /**
+   * Load and validate a bootstrap, as given by --config-path and --config-yaml.
+   * @param config_path supplies the path of the config file, or empty for none.
+   * @param config_yaml supplies inline YAML merged into the config file, or empty for none.
+   * @param bootstrap supplies the bootstrap to fill.
+   * @throw EnvoyException if the config can't be parsed or is invalid.
+   */
+  void load(const std::string& config_path, const std::string& config_yaml,
+            envoy::config::bootstrap::v2::Bootstrap& bootstrap);
+
+  /**
+   * Parse a YAML or JSON bootstrap, converting static listeners and clusters in parallel.
+   * @param contents supplies the YAML or JSON.
+   * @param yaml supplies whether contents is YAML, as opposed to JSON.
+   * @param bootstrap supplies the bootstrap to fill.
+   */
+  void loadFromString(const std::string& contents, bool yaml,
+                      envoy::config::bootstrap::v2::Bootstrap& bootstrap);
+
+  /**
+   * Validate protoc-gen-validate constraints on a bootstrap, and check it for deprecated fields,
+   * validating static listeners and clusters in parallel. The bootstrap is only modified while this
+   * runs.
+   * @param bootstrap supplies the bootstrap to validate.
+   * @throw ProtoValidationException if the bootstrap is invalid.
+   */
+  void validate(envoy::config::bootstrap::v2::Bootstrap& bootstrap);
+
+  /**
+   * @return std::string the path a bootstrap loaded from a config file and inline YAML is cached at.
+   *         Exposed for testing.
+   */
+  std::string cacheFilePath(const std::string& config_contents,
+                            const std::string& config_yaml) const;
+
+private:
+  void loadFromFile(const std::string& path, const std::string& contents,
+                    envoy::config::bootstrap::v2::Bootstrap& bootstrap);
+  bool readCache(const std::string& path, envoy::config::bootstrap::v2::Bootstrap& bootstrap);
+  void writeCache(const std::string& path,
+                  const envoy::config::bootstrap::v2::Bootstrap& bootstrap);
+  // Calls fn with each index in [0, count) across up to concurrency_ threads, and rethrows the
+  // exception of the lowest index that threw, if any, once all are done.
+  void runInParallel(size_t count, const std::function<void(size_t)>& fn);
+
+  Api::Api& api_;
+  const uint32_t concurrency_;
+  const std::string cache_path_;
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -48,7 +48,7 @@ ValidationInstance::ValidationInstance(const Options& options, Event::TimeSystem
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory().currentThreadId())),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
                           store),
-      mutex_tracer_(nullptr), time_system_(time_system) {
+      mutex_tracer_(nullptr), http_context_(store.symbolTable()), time_system_(time_system) {
   try {
     initialize(options, local_address, component_factory);
   } catch (const EnvoyException& e) {
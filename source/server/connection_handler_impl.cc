@@ -1,5 +1,7 @@
 #include "server/connection_handler_impl.h"
 
+#include <vector>
+
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
 #include "envoy/network/filter.h"
@@ -49,6 +51,59 @@ void ConnectionHandlerImpl::stopListeners() {
   }
 }
 
+void ConnectionHandlerImpl::removeFilterChains(
+    uint64_t listener_tag, const std::list<const Network::FilterChain*>& filter_chains) {
+  for (auto& listener : listeners_) {
+    if (listener.second->listener_tag_ != listener_tag) {
+      continue;
+    }
+
+    ActiveListener& active_listener = *listener.second;
+    active_listener.removed_filter_chains_.insert(filter_chains.begin(), filter_chains.end());
+    // Closing a connection unlinks it from the connection list, so collect the connections first.
+    std::vector<ActiveConnection*> connections;
+    for (const auto& connection : active_listener.connections_) {
+      if (active_listener.removed_filter_chains_.count(connection->filter_chain_) > 0) {
+        connections.push_back(connection.get());
+      }
+    }
+    for (ActiveConnection* connection : connections) {
+      connection->connection_->close(Network::ConnectionCloseType::NoFlush);
+    }
+  }
+}
+
+void ConnectionHandlerImpl::removeListenersWhenIdle(uint64_t listener_tag,
+                                                    std::function<void()> completion) {
+  bool found = false;
+  for (auto& listener : listeners_) {
+    if (listener.second->listener_tag_ == listener_tag) {
+      found = true;
+      listener.second->idle_completion_ = completion;
+      listener.second->checkIdle();
+    }
+  }
+
+  // The listener may never have been added to this handler, e.g. if it failed to listen.
+  if (!found) {
+    completion();
+  }
+}
+
+void ConnectionHandlerImpl::removeIdleListeners(uint64_t listener_tag) {
+  for (auto listener = listeners_.begin(); listener != listeners_.end();) {
+    ActiveListener& active_listener = *listener->second;
+    if (active_listener.listener_tag_ == listener_tag && active_listener.idle_completion_ &&
+        active_listener.sockets_.empty() && active_listener.connections_.empty()) {
+      std::function<void()> completion = std::move(active_listener.idle_completion_);
+      listener = listeners_.erase(listener);
+      completion();
+    } else {
+      ++listener;
+    }
+  }
+}
+
 void ConnectionHandlerImpl::disableListeners() {
   disable_listeners_ = true;
   for (auto& listener : listeners_) {
@@ -70,6 +125,18 @@ void ConnectionHandlerImpl::ActiveListener::removeConnection(ActiveConnection& c
   parent_.dispatcher_.deferredDelete(std::move(removed));
   ASSERT(parent_.num_connections_ > 0);
   parent_.num_connections_--;
+  checkIdle();
+}
+
+void ConnectionHandlerImpl::ActiveListener::checkIdle() {
+  if (idle_completion_ && sockets_.empty() && connections_.empty()) {
+    // This may be called from within the callbacks of a socket or a connection of the listener,
+    // so the listener is removed from a later dispatcher iteration.
+    ConnectionHandlerImpl& parent = parent_;
+    const uint64_t listener_tag = listener_tag_;
+    parent_.dispatcher_.post(
+        [&parent, listener_tag]() -> void { parent.removeIdleListeners(listener_tag); });
+  }
 }
 
 ConnectionHandlerImpl::ActiveListener::ActiveListener(ConnectionHandlerImpl& parent,
@@ -89,6 +156,9 @@ ConnectionHandlerImpl::ActiveListener::ActiveListener(ConnectionHandlerImpl& par
       listener_tag_(config.listenerTag()), config_(config) {}
 
 ConnectionHandlerImpl::ActiveListener::~ActiveListener() {
+  // Closing the remaining connections below must not schedule another removal.
+  idle_completion_ = nullptr;
+
   // Purge sockets that have not progressed to connections. This should only happen when
   // a listener filter stops iteration and never resumes.
   while (!sockets_.empty()) {
@@ -157,6 +227,7 @@ void ConnectionHandlerImpl::ActiveSocket::unlink() {
     removed->timer_->disableTimer();
   }
   listener_.parent_.dispatcher_.deferredDelete(std::move(removed));
+  listener_.checkIdle();
 }
 
 void ConnectionHandlerImpl::ActiveSocket::continueFilterChain(bool success) {
@@ -234,6 +305,12 @@ void ConnectionHandlerImpl::ActiveListener::newConnection(Network::ConnectionSoc
     socket->close();
     return;
   }
+  if (!removed_filter_chains_.empty() && removed_filter_chains_.count(filter_chain) > 0) {
+    ENVOY_LOG_TO_LOGGER(parent_.logger_, debug,
+                        "closing connection: matching filter chain has been removed");
+    socket->close();
+    return;
+  }
 
   auto transport_socket = filter_chain->transportSocketFactory().createTransportSocket(nullptr);
   Network::ConnectionPtr new_connection =
@@ -249,26 +326,31 @@ void ConnectionHandlerImpl::ActiveListener::newConnection(Network::ConnectionSoc
     return;
   }
 
-  onNewConnection(std::move(new_connection));
+  addConnection(std::move(new_connection), filter_chain);
 }
 
 void ConnectionHandlerImpl::ActiveListener::onNewConnection(
     Network::ConnectionPtr&& new_connection) {
+  addConnection(std::move(new_connection), nullptr);
+}
+
+void ConnectionHandlerImpl::ActiveListener::addConnection(
+    Network::ConnectionPtr&& new_connection, const Network::FilterChain* filter_chain) {
   ENVOY_CONN_LOG_TO_LOGGER(parent_.logger_, debug, "new connection", *new_connection);
 
   // If the connection is already closed, we can just let this connection immediately die.
   if (new_connection->state() != Network::Connection::State::Closed) {
-    ActiveConnectionPtr active_connection(
-        new ActiveConnection(*this, std::move(new_connection), parent_.dispatcher_.timeSource()));
+    ActiveConnectionPtr active_connection(new ActiveConnection(
+        *this, std::move(new_connection), filter_chain, parent_.dispatcher_.timeSource()));
     active_connection->moveIntoList(std::move(active_connection), connections_);
     parent_.num_connections_++;
   }
 }
 
-ConnectionHandlerImpl::ActiveConnection::ActiveConnection(ActiveListener& listener,
-                                                          Network::ConnectionPtr&& new_connection,
-                                                          TimeSource& time_source)
-    : listener_(listener), connection_(std::move(new_connection)),
+ConnectionHandlerImpl::ActiveConnection::ActiveConnection(
+    ActiveListener& listener, Network::ConnectionPtr&& new_connection,
+    const Network::FilterChain* filter_chain, TimeSource& time_source)
+    : listener_(listener), connection_(std::move(new_connection)), filter_chain_(filter_chain),
       conn_length_(new Stats::Timespan(listener_.stats_.downstream_cx_length_ms_, time_source)) {
   // We just universally set no delay on connections. Theoretically we might at some point want
   // to make this configurable.
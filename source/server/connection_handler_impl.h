@@ -2,8 +2,10 @@
 
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <list>
 #include <memory>
+#include <unordered_set>
 
 #include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
@@ -56,6 +58,9 @@ public:
   void removeListeners(uint64_t listener_tag) override;
   void stopListeners(uint64_t listener_tag) override;
   void stopListeners() override;
+  void removeFilterChains(uint64_t listener_tag,
+                          const std::list<const Network::FilterChain*>& filter_chains) override;
+  void removeListenersWhenIdle(uint64_t listener_tag, std::function<void()> completion) override;
   void disableListeners() override;
   void enableListeners() override;
 
@@ -64,6 +69,7 @@ public:
 private:
   struct ActiveListener;
   ActiveListener* findActiveListenerByAddress(const Network::Address::Instance& address);
+  void removeIdleListeners(uint64_t listener_tag);
 
   struct ActiveConnection;
   typedef std::unique_ptr<ActiveConnection> ActiveConnectionPtr;
@@ -97,6 +103,20 @@ private:
      */
     void newConnection(Network::ConnectionSocketPtr&& socket);
 
+    /**
+     * Take ownership of a new connection.
+     * @param new_connection supplies the connection.
+     * @param filter_chain supplies the filter chain the connection was created from, if any.
+     */
+    void addConnection(Network::ConnectionPtr&& new_connection,
+                       const Network::FilterChain* filter_chain);
+
+    /**
+     * Schedule the removal of the listener if it is waiting to become idle and it no longer owns
+     * any sockets or connections.
+     */
+    void checkIdle();
+
     ConnectionHandlerImpl& parent_;
     Network::ListenerPtr listener_;
     ListenerStats stats_;
@@ -105,6 +125,11 @@ private:
     const std::chrono::milliseconds listener_filters_timeout_;
     const uint64_t listener_tag_;
     Network::ListenerConfig& config_;
+    // Filter chains that have been removed by a filter chain level listener update. Sockets that
+    // still match them are closed.
+    std::unordered_set<const Network::FilterChain*> removed_filter_chains_;
+    // Set once the listener should be removed as soon as it becomes idle.
+    std::function<void()> idle_completion_;
   };
 
   typedef std::unique_ptr<ActiveListener> ActiveListenerPtr;
@@ -116,7 +141,7 @@ private:
                             public Event::DeferredDeletable,
                             public Network::ConnectionCallbacks {
     ActiveConnection(ActiveListener& listener, Network::ConnectionPtr&& new_connection,
-                     TimeSource& time_system);
+                     const Network::FilterChain* filter_chain, TimeSource& time_system);
     ~ActiveConnection();
 
     // Network::ConnectionCallbacks
@@ -132,6 +157,7 @@ private:
 
     ActiveListener& listener_;
     Network::ConnectionPtr connection_;
+    const Network::FilterChain* const filter_chain_;
     Stats::TimespanPtr conn_length_;
   };
 
@@ -0,0 +1,548 @@
+#include "server/filter_chain_manager_impl.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/empty_string.h"
+#include "common/common/fmt.h"
+#include "common/network/address_impl.h"
+#include "common/network/cidr_range.h"
+#include "common/network/utility.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Server {
+
+namespace {
+
+// Appends a (length prefixed) name and the identity of the compiled child node it maps to. Two
+// nodes with the same key have identical contents.
+void appendNodeKey(std::string& key, const std::string& name, const void* child) {
+  absl::StrAppend(&key, name.size(), ":", name, "=", reinterpret_cast<uintptr_t>(child), ";");
+}
+
+// Returns the live node with the given key, or builds (and records) a new one.
+template <class NodeType, class BuildCb>
+std::shared_ptr<const NodeType>
+internNode(std::unordered_map<std::string, std::weak_ptr<const NodeType>>& table,
+           const std::string& key, BuildCb build) {
+  std::weak_ptr<const NodeType>& entry = table[key];
+  std::shared_ptr<const NodeType> node = entry.lock();
+  if (node == nullptr) {
+    node = build();
+    entry = node;
+  }
+  return node;
+}
+
+template <class NodeType, class Children>
+std::shared_ptr<NodeType> buildProtocolsNode(Children& children) {
+  auto node = std::make_shared<NodeType>();
+  for (auto& child : children) {
+    if (child.first->empty()) {
+      node->any_protocol_ = std::move(child.second);
+    } else {
+      node->protocols_.emplace_back(*child.first, std::move(child.second));
+    }
+  }
+  return node;
+}
+
+template <class NodeType>
+void removeExpiredNodes(std::unordered_map<std::string, std::weak_ptr<const NodeType>>& table) {
+  for (auto it = table.begin(); it != table.end();) {
+    if (it->second.expired()) {
+      it = table.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+template <class NodeType>
+size_t
+countLiveNodes(const std::unordered_map<std::string, std::weak_ptr<const NodeType>>& table) {
+  size_t count = 0;
+  for (const auto& entry : table) {
+    if (!entry.second.expired()) {
+      count++;
+    }
+  }
+  return count;
+}
+
+} // namespace
+
+const Network::FilterChain*
+FilterChainMatchTree::findFilterChain(const Network::ConnectionSocket& socket) const {
+  const auto& address = socket.localAddress();
+
+  // Match on destination port (only for IP addresses).
+  if (address->type() == Network::Address::Type::Ip) {
+    const auto port_match = destination_ports_.find(address->ip()->port());
+    if (port_match != destination_ports_.end()) {
+      return findFilterChainForDestinationIP(port_match->second, socket);
+    }
+  }
+
+  // Match on catch-all port 0.
+  const auto port_match = destination_ports_.find(0);
+  if (port_match != destination_ports_.end()) {
+    return findFilterChainForDestinationIP(port_match->second, socket);
+  }
+
+  return nullptr;
+}
+
+const Network::FilterChain*
+FilterChainMatchTree::findFilterChainForDestinationIP(const DestinationPort& port,
+                                                      const Network::ConnectionSocket& socket) {
+  // Use invalid IP address (matching only filter chains without IP requirements) for UDS.
+  static const auto& fake_address = Network::Utility::parseInternetAddress("255.255.255.255");
+
+  const auto& local_address = socket.localAddress();
+  const auto& address =
+      local_address->type() == Network::Address::Type::Ip ? local_address : fake_address;
+
+  // Match on both: exact IP and wider CIDR ranges using LcTrie.
+  const auto& data = port.destination_ips_trie_->getData(address);
+  if (!data.empty()) {
+    ASSERT(data.size() == 1);
+    return findFilterChainForServerName(*port.server_names_[data.back()], socket);
+  }
+
+  return nullptr;
+}
+
+const Network::FilterChain*
+FilterChainMatchTree::findFilterChainForServerName(const FilterChainServerNamesNode& server_names,
+                                                   const Network::ConnectionSocket& socket) {
+  const absl::string_view server_name = socket.requestedServerName();
+
+  // Match on exact server name, i.e. "www.example.com" for "www.example.com".
+  const auto server_name_exact_match = server_names.server_names_.find(server_name);
+  if (server_name_exact_match != server_names.server_names_.end()) {
+    return findFilterChainForTransportProtocol(*server_name_exact_match->second, socket);
+  }
+
+  // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com". The
+  // lookups are done on views into the server name, so no strings are built here.
+  size_t pos = server_name.find('.', 1);
+  while (pos < server_name.size() - 1 && pos != absl::string_view::npos) {
+    const auto server_name_wildcard_match =
+        server_names.server_names_.find(server_name.substr(pos));
+    if (server_name_wildcard_match != server_names.server_names_.end()) {
+      return findFilterChainForTransportProtocol(*server_name_wildcard_match->second, socket);
+    }
+    pos = server_name.find('.', pos + 1);
+  }
+
+  // Match on a filter chain without server name requirements.
+  if (server_names.any_server_name_ != nullptr) {
+    return findFilterChainForTransportProtocol(*server_names.any_server_name_, socket);
+  }
+
+  return nullptr;
+}
+
+const Network::FilterChain* FilterChainMatchTree::findFilterChainForTransportProtocol(
+    const FilterChainTransportProtocolsNode& transport_protocols,
+    const Network::ConnectionSocket& socket) {
+  const absl::string_view transport_protocol = socket.detectedTransportProtocol();
+
+  // Match on exact transport protocol, e.g. "tls".
+  for (const auto& transport_protocol_match : transport_protocols.protocols_) {
+    if (transport_protocol_match.first == transport_protocol) {
+      return findFilterChainForApplicationProtocols(*transport_protocol_match.second, socket);
+    }
+  }
+
+  // Match on a filter chain without transport protocol requirements.
+  if (transport_protocols.any_protocol_ != nullptr) {
+    return findFilterChainForApplicationProtocols(*transport_protocols.any_protocol_, socket);
+  }
+
+  return nullptr;
+}
+
+const Network::FilterChain* FilterChainMatchTree::findFilterChainForApplicationProtocols(
+    const FilterChainApplicationProtocolsNode& application_protocols,
+    const Network::ConnectionSocket& socket) {
+  // Match on exact application protocol, e.g. "h2" or "http/1.1".
+  for (const auto& application_protocol : socket.requestedApplicationProtocols()) {
+    for (const auto& application_protocol_match : application_protocols.protocols_) {
+      if (application_protocol_match.first == application_protocol) {
+        return findFilterChainForSourceTypes(*application_protocol_match.second, socket);
+      }
+    }
+  }
+
+  // Match on a filter chain without application protocol requirements.
+  if (application_protocols.any_protocol_ != nullptr) {
+    return findFilterChainForSourceTypes(*application_protocols.any_protocol_, socket);
+  }
+
+  return nullptr;
+}
+
+const Network::FilterChain*
+FilterChainMatchTree::findFilterChainForSourceTypes(const FilterChainSourceTypesNode& source_types,
+                                                    const Network::ConnectionSocket& socket) {
+  const auto& filter_chain_local =
+      source_types.filter_chains_[envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType::
+                                      FilterChainMatch_ConnectionSourceType_LOCAL];
+
+  const auto& filter_chain_external =
+      source_types.filter_chains_[envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType::
+                                      FilterChainMatch_ConnectionSourceType_EXTERNAL];
+
+  // isLocalConnection can be expensive. Call it only if LOCAL or EXTERNAL are defined.
+  const bool is_local_connection = (filter_chain_local || filter_chain_external)
+                                       ? Network::Utility::isLocalConnection(socket)
+                                       : false;
+
+  if (is_local_connection) {
+    if (filter_chain_local) {
+      return filter_chain_local.get();
+    }
+  } else {
+    if (filter_chain_external) {
+      return filter_chain_external.get();
+    }
+  }
+
+  return source_types
+      .filter_chains_[envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType::
+                          FilterChainMatch_ConnectionSourceType_ANY]
+      .get();
+}
+
+FilterChainManagerImpl::FilterChainManagerImpl(
+    const Network::Address::InstanceConstSharedPtr& address)
+    : address_(address), match_tree_(std::make_shared<FilterChainMatchTree>()) {}
+
+bool FilterChainManagerImpl::isWildcardServerName(const std::string& name) {
+  return absl::StartsWith(name, "*.");
+}
+
+std::vector<FilterChainManagerImpl::MatchKey> FilterChainManagerImpl::expandMatch(
+    const envoy::api::v2::listener::FilterChainMatch& filter_chain_match) const {
+  // Validate IP addresses.
+  std::vector<std::string> destination_ips;
+  for (const auto& destination_ip : filter_chain_match.prefix_ranges()) {
+    const auto& cidr_range = Network::Address::CidrRange::create(destination_ip);
+    destination_ips.push_back(cidr_range.asString());
+  }
+  if (destination_ips.empty()) {
+    destination_ips.push_back(EMPTY_STRING);
+  }
+
+  std::vector<std::string> server_names;
+  for (const auto& server_name : filter_chain_match.server_names()) {
+    if (isWildcardServerName(server_name)) {
+      // Add mapping for the wildcard domain, i.e. ".example.com" for "*.example.com".
+      server_names.push_back(server_name.substr(1));
+    } else if (server_name.find('*') != std::string::npos) {
+      // Reject partial wildcards, we don't match on them.
+      throw EnvoyException(
+          fmt::format("error adding listener '{}': partial wildcards are not supported in "
+                      "\"server_names\"",
+                      address_->asString()));
+    } else {
+      server_names.push_back(server_name);
+    }
+  }
+  if (server_names.empty()) {
+    server_names.push_back(EMPTY_STRING);
+  }
+
+  std::vector<std::string> application_protocols(
+      filter_chain_match.application_protocols().begin(),
+      filter_chain_match.application_protocols().end());
+  if (application_protocols.empty()) {
+    application_protocols.push_back(EMPTY_STRING);
+  }
+
+  const uint16_t destination_port =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(filter_chain_match, destination_port, 0);
+  std::vector<MatchKey> keys;
+  keys.reserve(destination_ips.size() * server_names.size() * application_protocols.size());
+  for (const auto& destination_ip : destination_ips) {
+    for (const auto& server_name : server_names) {
+      for (const auto& application_protocol : application_protocols) {
+        keys.push_back({destination_port, destination_ip, server_name,
+                        filter_chain_match.transport_protocol(), application_protocol,
+                        filter_chain_match.source_type()});
+      }
+    }
+  }
+  return keys;
+}
+
+bool FilterChainManagerImpl::insertMatchKey(const MatchKey& key,
+                                            const Network::FilterChainSharedPtr& filter_chain) {
+  DestinationPortState& state = destination_ports_[key.destination_port_];
+  if (state.destination_ips_.find(key.destination_ip_) == state.destination_ips_.end()) {
+    state.destination_ips_changed_ = true;
+  }
+  state.dirty_destination_ips_.insert(key.destination_ip_);
+
+  SourceTypesArray& source_types =
+      state.destination_ips_[key.destination_ip_][key.server_name_][key.transport_protocol_]
+                            [key.application_protocol_];
+  if (source_types[key.source_type_] != nullptr) {
+    return false;
+  }
+  source_types[key.source_type_] = filter_chain;
+  return true;
+}
+
+void FilterChainManagerImpl::removeMatchKey(const MatchKey& key,
+                                            const Network::FilterChainSharedPtr& filter_chain) {
+  const auto state_it = destination_ports_.find(key.destination_port_);
+  if (state_it == destination_ports_.end()) {
+    return;
+  }
+  DestinationPortState& state = state_it->second;
+  const auto destination_ip_it = state.destination_ips_.find(key.destination_ip_);
+  if (destination_ip_it == state.destination_ips_.end()) {
+    return;
+  }
+  ServerNamesMap& server_names = destination_ip_it->second;
+  const auto server_name_it = server_names.find(key.server_name_);
+  if (server_name_it == server_names.end()) {
+    return;
+  }
+  TransportProtocolsMap& transport_protocols = server_name_it->second;
+  const auto transport_protocol_it = transport_protocols.find(key.transport_protocol_);
+  if (transport_protocol_it == transport_protocols.end()) {
+    return;
+  }
+  ApplicationProtocolsMap& application_protocols = transport_protocol_it->second;
+  const auto application_protocol_it = application_protocols.find(key.application_protocol_);
+  if (application_protocol_it == application_protocols.end()) {
+    return;
+  }
+
+  SourceTypesArray& source_types = application_protocol_it->second;
+  if (source_types[key.source_type_] == filter_chain) {
+    source_types[key.source_type_] = nullptr;
+  }
+  state.dirty_destination_ips_.insert(key.destination_ip_);
+
+  // Prune the branches that no longer lead to any filter chain.
+  if (std::all_of(source_types.begin(), source_types.end(),
+                  [](const Network::FilterChainSharedPtr& entry) { return entry == nullptr; })) {
+    application_protocols.erase(application_protocol_it);
+  }
+  if (application_protocols.empty()) {
+    transport_protocols.erase(transport_protocol_it);
+  }
+  if (transport_protocols.empty()) {
+    server_names.erase(server_name_it);
+  }
+  if (server_names.empty()) {
+    state.destination_ips_.erase(destination_ip_it);
+    state.destination_ips_changed_ = true;
+  }
+}
+
+void FilterChainManagerImpl::addFilterChain(
+    const envoy::api::v2::listener::FilterChainMatch& filter_chain_match,
+    const Network::FilterChainSharedPtr& filter_chain) {
+  if (filter_chains_.find(filter_chain_match) != filter_chains_.end()) {
+    throw EnvoyException(fmt::format("error adding listener '{}': multiple filter chains with "
+                                     "the same matching rules are defined",
+                                     address_->asString()));
+  }
+
+  const std::vector<MatchKey> keys = expandMatch(filter_chain_match);
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (!insertMatchKey(keys[i], filter_chain)) {
+      for (size_t j = 0; j < i; j++) {
+        removeMatchKey(keys[j], filter_chain);
+      }
+      // We should never get here once all fields in FilterChainMatch are implemented. At this
+      // point, this can become an ASSERT. In principle, we could verify the various missing fields
+      // earlier, but best to have defense-in-depth here, since any mistake leads to potential
+      // heap-use-after-free when filter chains are unexpectedly destructed.
+      throw EnvoyException(fmt::format("error adding listener '{}': multiple filter chains with "
+                                       "effectively equivalent matching rules are defined",
+                                       address_->asString()));
+    }
+  }
+  filter_chains_.emplace(filter_chain_match, filter_chain);
+}
+
+Network::FilterChainSharedPtr FilterChainManagerImpl::removeFilterChain(
+    const envoy::api::v2::listener::FilterChainMatch& filter_chain_match) {
+  const auto filter_chain_it = filter_chains_.find(filter_chain_match);
+  if (filter_chain_it == filter_chains_.end()) {
+    return nullptr;
+  }
+
+  Network::FilterChainSharedPtr filter_chain = filter_chain_it->second;
+  for (const auto& key : expandMatch(filter_chain_match)) {
+    removeMatchKey(key, filter_chain);
+  }
+  filter_chains_.erase(filter_chain_it);
+  return filter_chain;
+}
+
+Network::FilterChainSharedPtr FilterChainManagerImpl::getFilterChain(
+    const envoy::api::v2::listener::FilterChainMatch& filter_chain_match) const {
+  const auto filter_chain_it = filter_chains_.find(filter_chain_match);
+  return filter_chain_it != filter_chains_.end() ? filter_chain_it->second : nullptr;
+}
+
+void FilterChainManagerImpl::compile() {
+  // The new match tree starts as a shallow copy of the current one, so the destination ports
+  // without changes keep sharing their tries and compiled nodes.
+  auto match_tree = std::make_shared<FilterChainMatchTree>(*match_tree_);
+  for (auto it = destination_ports_.begin(); it != destination_ports_.end();) {
+    if (it->second.destination_ips_.empty()) {
+      match_tree->destination_ports_.erase(it->first);
+      it = destination_ports_.erase(it);
+      continue;
+    }
+    if (!it->second.dirty_destination_ips_.empty()) {
+      compileDestinationPort(it->second, match_tree->destination_ports_[it->first]);
+    }
+    ++it;
+  }
+  match_tree_ = std::move(match_tree);
+
+  removeExpiredNodes(server_names_nodes_);
+  removeExpiredNodes(transport_protocols_nodes_);
+  removeExpiredNodes(application_protocols_nodes_);
+  removeExpiredNodes(source_types_nodes_);
+}
+
+size_t FilterChainManagerImpl::numCompiledNodes() const {
+  return countLiveNodes(server_names_nodes_) + countLiveNodes(transport_protocols_nodes_) +
+         countLiveNodes(application_protocols_nodes_) + countLiveNodes(source_types_nodes_);
+}
+
+void FilterChainManagerImpl::compileDestinationPort(DestinationPortState& state,
+                                                    FilterChainMatchTree::DestinationPort& port) {
+  for (const auto& destination_ip : state.dirty_destination_ips_) {
+    const auto destination_ip_it = state.destination_ips_.find(destination_ip);
+    if (destination_ip_it == state.destination_ips_.end()) {
+      state.compiled_destination_ips_.erase(destination_ip);
+    } else {
+      state.compiled_destination_ips_[destination_ip] =
+          compileServerNames(destination_ip_it->second);
+    }
+  }
+
+  if (state.destination_ips_changed_) {
+    // The set of destination IPs changed, rebuild the trie.
+    std::vector<std::pair<uint32_t, std::vector<Network::Address::CidrRange>>> list;
+    port.server_names_.clear();
+    state.destination_ip_indices_.clear();
+    for (const auto& entry : state.compiled_destination_ips_) {
+      const uint32_t index = port.server_names_.size();
+      std::vector<Network::Address::CidrRange> subnets;
+      if (entry.first == EMPTY_STRING) {
+        if (Network::Address::ipFamilySupported(AF_INET)) {
+          subnets.push_back(Network::Address::CidrRange::create("0.0.0.0/0"));
+        }
+        if (Network::Address::ipFamilySupported(AF_INET6)) {
+          subnets.push_back(Network::Address::CidrRange::create("::/0"));
+        }
+      } else {
+        subnets.push_back(Network::Address::CidrRange::create(entry.first));
+      }
+      list.emplace_back(index, std::move(subnets));
+      port.server_names_.push_back(entry.second);
+      state.destination_ip_indices_[entry.first] = index;
+    }
+    port.destination_ips_trie_ =
+        std::make_shared<const Network::LcTrie::LcTrie<uint32_t>>(list, true);
+  } else {
+    // Only the server names behind existing destination IPs changed, the trie can be reused.
+    for (const auto& destination_ip : state.dirty_destination_ips_) {
+      port.server_names_[state.destination_ip_indices_.at(destination_ip)] =
+          state.compiled_destination_ips_.at(destination_ip);
+    }
+  }
+
+  state.dirty_destination_ips_.clear();
+  state.destination_ips_changed_ = false;
+}
+
+FilterChainServerNamesNodeSharedPtr
+FilterChainManagerImpl::compileServerNames(const ServerNamesMap& server_names) {
+  std::vector<std::pair<const std::string*, FilterChainTransportProtocolsNodeSharedPtr>> children;
+  children.reserve(server_names.size());
+  std::string key;
+  for (const auto& entry : server_names) {
+    children.emplace_back(&entry.first, compileTransportProtocols(entry.second));
+    appendNodeKey(key, entry.first, children.back().second.get());
+  }
+
+  return internNode(server_names_nodes_, key, [&children]() {
+    auto node = std::make_shared<FilterChainServerNamesNode>();
+    node->server_names_.reserve(children.size());
+    for (auto& child : children) {
+      if (child.first->empty()) {
+        node->any_server_name_ = std::move(child.second);
+      } else {
+        node->server_names_.emplace(*child.first, std::move(child.second));
+      }
+    }
+    return node;
+  });
+}
+
+FilterChainTransportProtocolsNodeSharedPtr FilterChainManagerImpl::compileTransportProtocols(
+    const TransportProtocolsMap& transport_protocols) {
+  std::vector<std::pair<const std::string*, FilterChainApplicationProtocolsNodeSharedPtr>>
+      children;
+  children.reserve(transport_protocols.size());
+  std::string key;
+  for (const auto& entry : transport_protocols) {
+    children.emplace_back(&entry.first, compileApplicationProtocols(entry.second));
+    appendNodeKey(key, entry.first, children.back().second.get());
+  }
+
+  return internNode(transport_protocols_nodes_, key, [&children]() {
+    return buildProtocolsNode<FilterChainTransportProtocolsNode>(children);
+  });
+}
+
+FilterChainApplicationProtocolsNodeSharedPtr FilterChainManagerImpl::compileApplicationProtocols(
+    const ApplicationProtocolsMap& application_protocols) {
+  std::vector<std::pair<const std::string*, FilterChainSourceTypesNodeSharedPtr>> children;
+  children.reserve(application_protocols.size());
+  std::string key;
+  for (const auto& entry : application_protocols) {
+    children.emplace_back(&entry.first, compileSourceTypes(entry.second));
+    appendNodeKey(key, entry.first, children.back().second.get());
+  }
+
+  return internNode(application_protocols_nodes_, key, [&children]() {
+    return buildProtocolsNode<FilterChainApplicationProtocolsNode>(children);
+  });
+}
+
+FilterChainSourceTypesNodeSharedPtr
+FilterChainManagerImpl::compileSourceTypes(const SourceTypesArray& source_types) {
+  std::string key;
+  for (const auto& filter_chain : source_types) {
+    absl::StrAppend(&key, reinterpret_cast<uintptr_t>(filter_chain.get()), ";");
+  }
+
+  return internNode(source_types_nodes_, key, [&source_types]() {
+    auto node = std::make_shared<FilterChainSourceTypesNode>();
+    node->filter_chains_ = source_types;
+    return node;
+  });
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "envoy/api/v2/listener/listener.pb.h"
+#include "envoy/network/address.h"
+#include "envoy/network/filter.h"
+#include "envoy/network/listen_socket.h"
+
+#include "common/common/logger.h"
+#include "common/network/lc_trie.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Compiled nodes of the filter chain match tree. Nodes are immutable once built and are shared
+ * between all the parents that have identical subtrees, e.g. the protocol matchers behind
+ * thousands of server names that all select the same filter chain exist only once.
+ */
+struct FilterChainSourceTypesNode {
+  std::array<Network::FilterChainSharedPtr, 3> filter_chains_;
+};
+typedef std::shared_ptr<const FilterChainSourceTypesNode> FilterChainSourceTypesNodeSharedPtr;
+
+struct FilterChainApplicationProtocolsNode {
+  // Application protocols are few per filter chain, so a linear scan beats hashing.
+  std::vector<std::pair<std::string, FilterChainSourceTypesNodeSharedPtr>> protocols_;
+  FilterChainSourceTypesNodeSharedPtr any_protocol_;
+};
+typedef std::shared_ptr<const FilterChainApplicationProtocolsNode>
+    FilterChainApplicationProtocolsNodeSharedPtr;
+
+struct FilterChainTransportProtocolsNode {
+  std::vector<std::pair<std::string, FilterChainApplicationProtocolsNodeSharedPtr>> protocols_;
+  FilterChainApplicationProtocolsNodeSharedPtr any_protocol_;
+};
+typedef std::shared_ptr<const FilterChainTransportProtocolsNode>
+    FilterChainTransportProtocolsNodeSharedPtr;
+
+struct FilterChainServerNamesNode {
+  // Both exact server names and wildcard domains are part of the same map, in which wildcard
+  // domains are prefixed with "." (i.e. ".example.com" for "*.example.com") to differentiate
+  // between exact and wildcard entries.
+  absl::flat_hash_map<std::string, FilterChainTransportProtocolsNodeSharedPtr> server_names_;
+  FilterChainTransportProtocolsNodeSharedPtr any_server_name_;
+};
+typedef std::shared_ptr<const FilterChainServerNamesNode> FilterChainServerNamesNodeSharedPtr;
+
+/**
+ * Immutable, compiled form of the filter chain match rules of a listener. A match tree may be
+ * shared across threads.
+ */
+class FilterChainMatchTree : public Network::FilterChainManager {
+public:
+  // Network::FilterChainManager
+  const Network::FilterChain*
+  findFilterChain(const Network::ConnectionSocket& socket) const override;
+
+private:
+  friend class FilterChainManagerImpl;
+
+  struct DestinationPort {
+    // Maps destination IPs to indices into server_names_, so that the trie only needs to be
+    // rebuilt when the set of destination IPs changes.
+    std::shared_ptr<const Network::LcTrie::LcTrie<uint32_t>> destination_ips_trie_;
+    std::vector<FilterChainServerNamesNodeSharedPtr> server_names_;
+  };
+
+  static const Network::FilterChain*
+  findFilterChainForDestinationIP(const DestinationPort& port,
+                                  const Network::ConnectionSocket& socket);
+  static const Network::FilterChain*
+  findFilterChainForServerName(const FilterChainServerNamesNode& server_names,
+                               const Network::ConnectionSocket& socket);
+  static const Network::FilterChain*
+  findFilterChainForTransportProtocol(const FilterChainTransportProtocolsNode& transport_protocols,
+                                      const Network::ConnectionSocket& socket);
+  static const Network::FilterChain* findFilterChainForApplicationProtocols(
+      const FilterChainApplicationProtocolsNode& application_protocols,
+      const Network::ConnectionSocket& socket);
+  static const Network::FilterChain*
+  findFilterChainForSourceTypes(const FilterChainSourceTypesNode& source_types,
+                                const Network::ConnectionSocket& socket);
+
+  std::unordered_map<uint16_t, DestinationPort> destination_ports_;
+};
+
+typedef std::shared_ptr<const FilterChainMatchTree> FilterChainMatchTreeSharedPtr;
+
+/**
+ * Builds the filter chain match tree of a listener. Filter chains are staged with
+ * addFilterChain()/removeFilterChain() and become visible to findFilterChain() once compile() is
+ * called. compile() only rebuilds the (destination port, destination IP) entries touched since
+ * the previous call and reuses every other compiled node, so changing a few filter chains of a
+ * listener with thousands of them is cheap.
+ *
+ * Note that ListenerImpl does not use this across listener updates: every update creates a new
+ * ListenerImpl, which creates all of its filter chains and compiles them into a new manager. The
+ * filter chains cannot be carried over, since their factory contexts, stats scopes and drain state
+ * belong to the listener that created them.
+ */
+class FilterChainManagerImpl : public Network::FilterChainManager,
+                               Logger::Loggable<Logger::Id::config> {
+public:
+  /**
+   * @param address supplies the listener address, used in error messages.
+   */
+  explicit FilterChainManagerImpl(const Network::Address::InstanceConstSharedPtr& address);
+
+  /**
+   * Stage a filter chain.
+   * @param filter_chain_match supplies the match rules of the filter chain.
+   * @param filter_chain supplies the filter chain.
+   * @throw EnvoyException if the match rules are invalid or if they collide with the match rules
+   *        of an already added filter chain. The manager is left unchanged in that case.
+   */
+  void addFilterChain(const envoy::api::v2::listener::FilterChainMatch& filter_chain_match,
+                      const Network::FilterChainSharedPtr& filter_chain);
+
+  /**
+   * Stage the removal of a filter chain.
+   * @param filter_chain_match supplies the match rules the filter chain was added with.
+   * @return the removed filter chain, or nullptr if no filter chain uses these match rules.
+   */
+  Network::FilterChainSharedPtr
+  removeFilterChain(const envoy::api::v2::listener::FilterChainMatch& filter_chain_match);
+
+  /**
+   * @return the filter chain added with the given match rules, or nullptr if there is none.
+   */
+  Network::FilterChainSharedPtr
+  getFilterChain(const envoy::api::v2::listener::FilterChainMatch& filter_chain_match) const;
+
+  /**
+   * Compile the staged changes into a new match tree.
+   */
+  void compile();
+
+  /**
+   * @return the current match tree. Later calls to compile() do not modify it.
+   */
+  const FilterChainMatchTreeSharedPtr& matchTree() const { return match_tree_; }
+
+  /**
+   * @return the number of filter chains added to the manager.
+   */
+  size_t numFilterChains() const { return filter_chains_.size(); }
+
+  /**
+   * @return the number of distinct nodes in the compiled match tree.
+   */
+  size_t numCompiledNodes() const;
+
+  // Network::FilterChainManager
+  const Network::FilterChain*
+  findFilterChain(const Network::ConnectionSocket& socket) const override {
+    return match_tree_->findFilterChain(socket);
+  }
+
+private:
+  // Build time representation of the match rules. Ordered maps keep the keys used to intern
+  // compiled nodes canonical.
+  typedef std::array<Network::FilterChainSharedPtr, 3> SourceTypesArray;
+  typedef std::map<std::string, SourceTypesArray> ApplicationProtocolsMap;
+  typedef std::map<std::string, ApplicationProtocolsMap> TransportProtocolsMap;
+  typedef std::map<std::string, TransportProtocolsMap> ServerNamesMap;
+  typedef std::map<std::string, ServerNamesMap> DestinationIPsMap;
+
+  struct DestinationPortState {
+    DestinationIPsMap destination_ips_;
+    std::map<std::string, FilterChainServerNamesNodeSharedPtr> compiled_destination_ips_;
+    std::unordered_map<std::string, uint32_t> destination_ip_indices_;
+    std::set<std::string> dirty_destination_ips_;
+    bool destination_ips_changed_{};
+  };
+
+  // One fully expanded combination of the match rules of a filter chain.
+  struct MatchKey {
+    uint16_t destination_port_;
+    std::string destination_ip_;
+    std::string server_name_;
+    std::string transport_protocol_;
+    std::string application_protocol_;
+    envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type_;
+  };
+
+  template <class NodeType>
+  using NodeTable = std::unordered_map<std::string, std::weak_ptr<const NodeType>>;
+
+  std::vector<MatchKey>
+  expandMatch(const envoy::api::v2::listener::FilterChainMatch& filter_chain_match) const;
+  bool insertMatchKey(const MatchKey& key, const Network::FilterChainSharedPtr& filter_chain);
+  void removeMatchKey(const MatchKey& key, const Network::FilterChainSharedPtr& filter_chain);
+
+  void compileDestinationPort(DestinationPortState& state,
+                              FilterChainMatchTree::DestinationPort& port);
+  FilterChainServerNamesNodeSharedPtr compileServerNames(const ServerNamesMap& server_names);
+  FilterChainTransportProtocolsNodeSharedPtr
+  compileTransportProtocols(const TransportProtocolsMap& transport_protocols);
+  FilterChainApplicationProtocolsNodeSharedPtr
+  compileApplicationProtocols(const ApplicationProtocolsMap& application_protocols);
+  FilterChainSourceTypesNodeSharedPtr compileSourceTypes(const SourceTypesArray& source_types);
+
+  static bool isWildcardServerName(const std::string& name);
+
+  const Network::Address::InstanceConstSharedPtr address_;
+  std::unordered_map<envoy::api::v2::listener::FilterChainMatch, Network::FilterChainSharedPtr,
+                     MessageUtil, MessageUtil>
+      filter_chains_;
+  std::map<uint16_t, DestinationPortState> destination_ports_;
+  // Weak references to all the live compiled nodes, keyed by their content.
+  NodeTable<FilterChainServerNamesNode> server_names_nodes_;
+  NodeTable<FilterChainTransportProtocolsNode> transport_protocols_nodes_;
+  NodeTable<FilterChainApplicationProtocolsNode> application_protocols_nodes_;
+  NodeTable<FilterChainSourceTypesNode> source_types_nodes_;
+  FilterChainMatchTreeSharedPtr match_tree_;
+};
+
+} // namespace Server
+} // namespace Envoy
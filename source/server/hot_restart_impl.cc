@@ -31,6 +31,8 @@ namespace Server {
 // from working. Operations code can then cope with this and do a full restart.
 const uint64_t SharedMemory::VERSION = 10;
 
+const uint64_t HotRestartImpl::STATS_ARENA_SEGMENT_SIZE = 1024 * 1024;
+
 static BlockMemoryHashSetOptions blockMemHashOptions(uint64_t max_stats) {
   BlockMemoryHashSetOptions hash_set_options;
   hash_set_options.capacity = max_stats;
@@ -125,19 +127,37 @@ std::string SharedMemory::version(uint64_t max_num_stats,
 HotRestartImpl::HotRestartImpl(const Options& options, Stats::SymbolTable& symbol_table)
     : options_(options), stats_set_options_(blockMemHashOptions(options.maxStats())),
       shmem_(SharedMemory::initialize(
-          Stats::RawStatDataSet::numBytes(stats_set_options_, options_.statsOptions()), options_)),
+          options.maxStats() == 0
+              ? 0
+              : Stats::RawStatDataSet::numBytes(stats_set_options_, options_.statsOptions()),
+          options_)),
       log_lock_(shmem_.log_lock_), access_log_lock_(shmem_.access_log_lock_),
       stat_lock_(shmem_.stat_lock_), init_lock_(shmem_.init_lock_) {
   {
     // We must hold the stat lock when attaching to an existing memory segment
     // because it might be actively written to while we sanityCheck it.
     Thread::LockGuard lock(stat_lock_);
-    stats_set_ =
-        std::make_unique<Stats::RawStatDataSet>(stats_set_options_, options.restartEpoch() == 0,
-                                                shmem_.stats_set_data_, options_.statsOptions());
+    if (options.maxStats() == 0) {
+      // The arena lives in its own segments, so that it can grow without remapping the stats
+      // already handed out.
+      stats_arena_ = std::make_unique<Stats::RawStatDataArena>(
+          STATS_ARENA_SEGMENT_SIZE, options.restartEpoch() == 0,
+          [this](uint32_t index, uint64_t size, bool create) -> uint8_t* {
+            return mapStatsArenaSegment(index, size, create);
+          });
+    } else {
+      stats_set_ =
+          std::make_unique<Stats::RawStatDataSet>(stats_set_options_, options.restartEpoch() == 0,
+                                                  shmem_.stats_set_data_, options_.statsOptions());
+    }
+  }
+  if (stats_arena_ != nullptr) {
+    stats_allocator_ =
+        std::make_unique<Stats::RawStatDataArenaAllocator>(stat_lock_, *stats_arena_, symbol_table);
+  } else {
+    stats_allocator_ = std::make_unique<Stats::RawStatDataAllocator>(
+        stat_lock_, *stats_set_, options_.statsOptions(), symbol_table);
   }
-  stats_allocator_ = std::make_unique<Stats::RawStatDataAllocator>(
-      stat_lock_, *stats_set_, options_.statsOptions(), symbol_table);
   my_domain_socket_ = bindDomainSocket(options.restartEpoch());
   child_address_ = createDomainSocketAddress((options.restartEpoch() + 1));
   initDomainSocketAddress(&parent_address_);
@@ -151,6 +171,47 @@ HotRestartImpl::HotRestartImpl(const Options& options, Stats::SymbolTable& symbo
   RELEASE_ASSERT(rc != -1, "");
 }
 
+uint8_t* HotRestartImpl::mapStatsArenaSegment(uint32_t index, uint64_t size, bool create) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const std::string shmem_name = fmt::format("/envoy_stats_arena_{}_{}", options_.baseId(), index);
+
+  int flags = O_RDWR;
+  if (create) {
+    // As for the main segment, a segment left behind by a previous instance is replaced.
+    flags |= O_CREAT | O_EXCL;
+    os_sys_calls.shmUnlink(shmem_name.c_str());
+  }
+
+  const Api::SysCallIntResult result =
+      os_sys_calls.shmOpen(shmem_name.c_str(), flags, S_IRUSR | S_IWUSR);
+  if (result.rc_ == -1) {
+    ENVOY_LOG(warn, "cannot open shared memory region {}. Error: {}", shmem_name,
+              strerror(result.errno_));
+    return nullptr;
+  }
+
+  if (create) {
+    const Api::SysCallIntResult truncate_result = os_sys_calls.ftruncate(result.rc_, size);
+    if (truncate_result.rc_ == -1) {
+      ENVOY_LOG(warn, "cannot size shared memory region {}. Error: {}", shmem_name,
+                strerror(truncate_result.errno_));
+      os_sys_calls.close(result.rc_);
+      return nullptr;
+    }
+  }
+
+  const Api::SysCallPtrResult mmap_result =
+      os_sys_calls.mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, result.rc_, 0);
+  // The mapping stays valid once the descriptor is closed.
+  os_sys_calls.close(result.rc_);
+  if (mmap_result.rc_ == MAP_FAILED) {
+    ENVOY_LOG(warn, "cannot map shared memory region {}. Error: {}", shmem_name,
+              strerror(mmap_result.errno_));
+    return nullptr;
+  }
+  return static_cast<uint8_t*>(mmap_result.rc_);
+}
+
 int HotRestartImpl::bindDomainSocket(uint64_t id) {
   Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
   // This actually creates the socket and binds it. We use the socket in datagram mode so we can
@@ -455,6 +516,9 @@ void HotRestartImpl::shutdown() { socket_event_.reset(); }
 
 std::string HotRestartImpl::version() {
   Thread::LockGuard lock(stat_lock_);
+  if (stats_arena_ != nullptr) {
+    return statsArenaVersion(options_.statsOptions());
+  }
   return versionHelper(shmem_.maxStats(), options_.statsOptions(), *stats_set_);
 }
 
@@ -463,6 +527,9 @@ std::string HotRestartImpl::version() {
 std::string HotRestartImpl::hotRestartVersion(uint64_t max_num_stats, uint64_t max_stat_name_len) {
   Stats::StatsOptionsImpl stats_options;
   stats_options.max_obj_name_length_ = max_stat_name_len - stats_options.maxStatSuffixLength();
+  if (max_num_stats == 0) {
+    return statsArenaVersion(stats_options);
+  }
 
   const BlockMemoryHashSetOptions hash_set_options = blockMemHashOptions(max_num_stats);
   const uint64_t bytes = Stats::RawStatDataSet::numBytes(hash_set_options, stats_options);
@@ -481,5 +548,10 @@ std::string HotRestartImpl::versionHelper(uint64_t max_num_stats,
          stats_set.version(stats_options);
 }
 
+std::string HotRestartImpl::statsArenaVersion(const Stats::StatsOptions& stats_options) {
+  return SharedMemory::version(0, stats_options) + "." +
+         Stats::RawStatDataArena::version(STATS_ARENA_SEGMENT_SIZE);
+}
+
 } // namespace Server
 } // namespace Envoy
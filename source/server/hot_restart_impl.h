@@ -15,6 +15,7 @@
 
 #include "common/common/assert.h"
 #include "common/stats/raw_stat_data.h"
+#include "common/stats/raw_stat_data_arena.h"
 
 namespace Envoy {
 namespace Server {
@@ -127,7 +128,9 @@ public:
   std::string version() override;
   Thread::BasicLockable& logLock() override { return log_lock_; }
   Thread::BasicLockable& accessLogLock() override { return access_log_lock_; }
-  Stats::RawStatDataAllocator& statsAllocator() override { return *stats_allocator_; }
+  Stats::StatDataAllocatorImpl<Stats::RawStatData>& statsAllocator() override {
+    return *stats_allocator_;
+  }
 
   /**
    * envoy --hot_restart_version doesn't initialize Envoy, but computes the version string
@@ -135,6 +138,10 @@ public:
    */
   static std::string hotRestartVersion(uint64_t max_num_stats, uint64_t max_stat_name_len);
 
+  // Size of each shared memory segment of the stats arena, used when max_stats is 0. Made public
+  // for testing.
+  static const uint64_t STATS_ARENA_SEGMENT_SIZE;
+
 private:
   enum class RpcMessageType {
     DrainListenersRequest = 1,
@@ -205,12 +212,16 @@ private:
   void sendMessage(sockaddr_un& address, RpcBase& rpc);
   static std::string versionHelper(uint64_t max_num_stats, const Stats::StatsOptions& stats_options,
                                    Stats::RawStatDataSet& stats_set);
+  static std::string statsArenaVersion(const Stats::StatsOptions& stats_options);
+  uint8_t* mapStatsArenaSegment(uint32_t index, uint64_t size, bool create);
 
   const Options& options_;
   BlockMemoryHashSetOptions stats_set_options_;
   SharedMemory& shmem_;
   std::unique_ptr<Stats::RawStatDataSet> stats_set_ GUARDED_BY(stat_lock_);
-  std::unique_ptr<Stats::RawStatDataAllocator> stats_allocator_;
+  // Replaces stats_set_ when max_stats is 0, growing as stats are added.
+  std::unique_ptr<Stats::RawStatDataArena> stats_arena_ GUARDED_BY(stat_lock_);
+  std::unique_ptr<Stats::StatDataAllocatorImpl<Stats::RawStatData>> stats_allocator_;
   ProcessSharedMutex log_lock_;
   ProcessSharedMutex access_log_lock_;
   ProcessSharedMutex stat_lock_;
@@ -6,7 +6,6 @@
 #include <regex>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -52,6 +51,8 @@
 
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
@@ -137,8 +138,6 @@ const char AdminHtmlEnd[] = R"(
 </body>
 )";
 
-const std::regex PromRegex("[^a-zA-Z0-9_]");
-
 void populateFallbackResponseHeaders(Http::Code code, Http::HeaderMap& header_map) {
   header_map.insertStatus().value(std::to_string(enumToInt(code)));
   const auto& headers = Http::Headers::get();
@@ -220,6 +219,44 @@ void AdminFilter::onDestroy() {
   for (const auto& callback : on_destroy_callbacks_) {
     callback();
   }
+  chunked_response_.reset();
+  resume_timer_.reset();
+  if (watermark_callbacks_added_) {
+    callbacks_->removeDownstreamWatermarkCallbacks(*this);
+    watermark_callbacks_added_ = false;
+  }
+}
+
+void AdminFilter::onAboveWriteBufferHighWatermark() { ++high_watermark_count_; }
+
+void AdminFilter::onBelowWriteBufferLowWatermark() {
+  ASSERT(high_watermark_count_ > 0);
+  if (--high_watermark_count_ > 0 || chunked_response_ == nullptr) {
+    return;
+  }
+  if (resume_timer_ == nullptr) {
+    resume_timer_ = callbacks_->dispatcher().createTimer([this]() -> void { encodeChunks(); });
+  }
+  resume_timer_->enableTimer(std::chrono::milliseconds(0));
+}
+
+void AdminFilter::encodeChunks() {
+  while (chunked_response_ != nullptr && high_watermark_count_ == 0) {
+    Buffer::OwnedImpl chunk;
+    const bool more = chunked_response_->nextChunk(chunk);
+    if (!more) {
+      chunked_response_.reset();
+    }
+    callbacks_->encodeData(chunk, !more && end_stream_on_complete_);
+  }
+}
+
+void AdminFilter::drainChunkedResponse(Buffer::Instance& response) {
+  if (chunked_response_ != nullptr) {
+    while (chunked_response_->nextChunk(response)) {
+    }
+    chunked_response_.reset();
+  }
 }
 
 void AdminFilter::addOnDestroyCallback(std::function<void()> cb) {
@@ -673,22 +710,22 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
           ? absl::optional<std::regex>{std::regex(params.at("filter"))}
           : absl::nullopt;
 
-  std::map<std::string, uint64_t> all_stats;
-  for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
-    if (shouldShowMetric(counter, used_only, regex)) {
-      all_stats.emplace(counter->name(), counter->value());
-    }
-  }
-
-  for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
-    if (shouldShowMetric(gauge, used_only, regex)) {
-      all_stats.emplace(gauge->name(), gauge->value());
-    }
-  }
-
   if (has_format) {
     const std::string format_value = params.at("format");
     if (format_value == "json") {
+      std::map<std::string, uint64_t> all_stats;
+      for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
+        if (shouldShowMetric(counter, used_only, regex)) {
+          all_stats.emplace(counter->name(), counter->value());
+        }
+      }
+
+      for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
+        if (shouldShowMetric(gauge, used_only, regex)) {
+          all_stats.emplace(gauge->name(), gauge->value());
+        }
+      }
+
       response_headers.insertContentType().value().setReference(
           Http::Headers::get().ContentTypeValues.Json);
       response.add(
@@ -701,38 +738,57 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
       rc = Http::Code::NotFound;
     }
   } else { // Display plain stats if format query param is not there.
-    for (auto stat : all_stats) {
-      response.add(fmt::format("{}: {}\n", stat.first, stat.second));
-    }
-    // TODO(ramaraochavali): See the comment in ThreadLocalStoreImpl::histograms() for why we use a
-    // multimap here. This makes sure that duplicate histograms get output. When shared storage is
-    // implemented this can be switched back to a normal map.
-    std::multimap<std::string, std::string> all_histograms;
-    for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
-      if (shouldShowMetric(histogram, used_only, regex)) {
-        all_histograms.emplace(histogram->name(), histogram->quantileSummary());
-      }
-    }
-    for (auto histogram : all_histograms) {
-      response.add(fmt::format("{}: {}\n", histogram.first, histogram.second));
-    }
+    // The stats are rendered a chunk at a time as the client reads them, rather than all at once.
+    admin_stream.setChunkedResponse(std::make_unique<StatsTextRenderer>(
+        server_.stats().counters(), server_.stats().gauges(), server_.stats().histograms(),
+        used_only, regex));
   }
   return rc;
 }
 
 Http::Code AdminImpl::handlerPrometheusStats(absl::string_view path_and_query, Http::HeaderMap&,
-                                             Buffer::Instance& response, AdminStream&) {
+                                             Buffer::Instance&, AdminStream& admin_stream) {
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(path_and_query);
   const bool used_only = params.find("usedonly") != params.end();
-  PrometheusStatsFormatter::statsAsPrometheus(server_.stats().counters(), server_.stats().gauges(),
-                                              server_.stats().histograms(), response, used_only);
+  admin_stream.setChunkedResponse(std::make_unique<PrometheusStatsRenderer>(
+      server_.stats().counters(), server_.stats().gauges(), server_.stats().histograms(),
+      used_only, prometheus_names_));
+  return Http::Code::OK;
+}
+
+Http::Code AdminImpl::handlerStatsMemory(absl::string_view, Http::HeaderMap&,
+                                         Buffer::Instance& response, AdminStream&) {
+  std::vector<Stats::ScopeMemoryStats> scopes = server_.stats().scopeMemoryStats();
+  std::sort(scopes.begin(), scopes.end(),
+            [](const Stats::ScopeMemoryStats& a, const Stats::ScopeMemoryStats& b) -> bool {
+              return a.bytes_ > b.bytes_ || (a.bytes_ == b.bytes_ && a.prefix_ < b.prefix_);
+            });
+  uint64_t total_bytes = 0;
+  for (const Stats::ScopeMemoryStats& scope : scopes) {
+    total_bytes += scope.bytes_;
+  }
+  response.add(fmt::format("total: {} bytes in {} scopes\n", total_bytes, scopes.size()));
+  for (const Stats::ScopeMemoryStats& scope : scopes) {
+    response.add(fmt::format("{}: {} bytes, {} counters, {} gauges, {} histograms",
+                             scope.prefix_.empty() ? "(root)" : scope.prefix_, scope.bytes_,
+                             scope.counters_, scope.gauges_, scope.histograms_));
+    if (scope.evictable_) {
+      response.add(fmt::format(", evictable, {} evicted", scope.evicted_));
+    }
+    response.add("\n");
+  }
   return Http::Code::OK;
 }
 
 std::string PrometheusStatsFormatter::sanitizeName(const std::string& name) {
   // The name must match the regex [a-zA-Z_][a-zA-Z0-9_]* as required by
   // prometheus. Refer to https://prometheus.io/docs/concepts/data_model/.
-  std::string stats_name = std::regex_replace(name, PromRegex, "_");
+  std::string stats_name = name;
+  for (char& c : stats_name) {
+    if (!absl::ascii_isalnum(c) && c != '_') {
+      c = '_';
+    }
+  }
   if (stats_name[0] >= '0' && stats_name[0] <= '9') {
     return fmt::format("_{}", stats_name);
   } else {
@@ -760,71 +816,214 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const std::vector<Stats::GaugeSharedPtr>& gauges,
     const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
     const bool used_only) {
-  std::unordered_set<std::string> metric_type_tracker;
-  for (const auto& counter : counters) {
-    if (!shouldShowMetric(counter, used_only)) {
-      continue;
-    }
+  PrometheusNameCache names;
+  PrometheusStatsRenderer renderer(counters, gauges, histograms, used_only, names);
+  while (renderer.nextChunk(response)) {
+  }
+  return renderer.metricTypeCount();
+}
 
-    const std::string tags = formattedTags(counter->tags());
-    const std::string metric_name = metricName(counter->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} counter\n", metric_name));
+const std::string& PrometheusNameCache::metricName(const std::string& tag_extracted_name) {
+  return lookup(metric_names_, tag_extracted_name, PrometheusStatsFormatter::metricName);
+}
+
+const std::string& PrometheusNameCache::tagName(const std::string& tag_name) {
+  return lookup(tag_names_, tag_name, PrometheusStatsFormatter::sanitizeName);
+}
+
+void PrometheusNameCache::sweep() {
+  sweep(metric_names_);
+  sweep(tag_names_);
+}
+
+const std::string&
+PrometheusNameCache::lookup(EntryMap& entries, const std::string& key,
+                            const std::function<std::string(const std::string&)>& sanitize) {
+  auto it = entries.find(key);
+  if (it == entries.end()) {
+    it = entries.emplace(key, Entry{sanitize(key), true}).first;
+  } else {
+    it->second.used_ = true;
+  }
+  return it->second.name_;
+}
+
+void PrometheusNameCache::sweep(EntryMap& entries) {
+  for (auto it = entries.begin(); it != entries.end();) {
+    if (it->second.used_) {
+      it->second.used_ = false;
+      ++it;
+    } else {
+      it = entries.erase(it);
     }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, counter->value()));
   }
+}
 
-  for (const auto& gauge : gauges) {
-    if (!shouldShowMetric(gauge, used_only)) {
-      continue;
+StatsTextRenderer::StatsTextRenderer(const std::vector<Stats::CounterSharedPtr>& counters,
+                                     const std::vector<Stats::GaugeSharedPtr>& gauges,
+                                     const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
+                                     bool used_only, const absl::optional<std::regex>& regex,
+                                     uint64_t chunk_size)
+    : chunk_size_(chunk_size) {
+  for (const Stats::CounterSharedPtr& counter : counters) {
+    if (AdminImpl::shouldShowMetric(counter, used_only, regex)) {
+      counters_.emplace_back(counter->name(), counter);
     }
+  }
+  for (const Stats::GaugeSharedPtr& gauge : gauges) {
+    if (AdminImpl::shouldShowMetric(gauge, used_only, regex)) {
+      gauges_.emplace_back(gauge->name(), gauge);
+    }
+  }
+  for (const Stats::ParentHistogramSharedPtr& histogram : histograms) {
+    if (AdminImpl::shouldShowMetric(histogram, used_only, regex)) {
+      histograms_.emplace_back(histogram->name(), histogram);
+    }
+  }
 
-    const std::string tags = formattedTags(gauge->tags());
-    const std::string metric_name = metricName(gauge->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} gauge\n", metric_name));
+  const auto by_name = [](const auto& a, const auto& b) -> bool { return a.first < b.first; };
+  std::sort(counters_.begin(), counters_.end(), by_name);
+  std::sort(gauges_.begin(), gauges_.end(), by_name);
+  // TODO(ramaraochavali): See the comment in ThreadLocalStoreImpl::histograms() for why duplicate
+  // histograms are kept here. When shared storage is implemented this can dedup like the others.
+  std::stable_sort(histograms_.begin(), histograms_.end(), by_name);
+}
+
+bool StatsTextRenderer::nextChunk(Buffer::Instance& response) {
+  uint64_t chunk_bytes = 0;
+  while (!done() && chunk_bytes < chunk_size_) {
+    line_.clear();
+    if (counter_index_ < counters_.size() || gauge_index_ < gauges_.size()) {
+      // Counters and gauges are listed together in name order. A gauge with the same name as a
+      // counter is not shown.
+      const bool take_counter =
+          gauge_index_ == gauges_.size() ||
+          (counter_index_ < counters_.size() &&
+           counters_[counter_index_].first <= gauges_[gauge_index_].first);
+      if (take_counter) {
+        const NamedStat<Stats::Counter>& counter = counters_[counter_index_++];
+        if (gauge_index_ < gauges_.size() && gauges_[gauge_index_].first == counter.first) {
+          ++gauge_index_;
+        }
+        absl::StrAppend(&line_, counter.first, ": ", counter.second->value(), "\n");
+      } else {
+        const NamedStat<Stats::Gauge>& gauge = gauges_[gauge_index_++];
+        absl::StrAppend(&line_, gauge.first, ": ", gauge.second->value(), "\n");
+      }
+    } else {
+      const NamedStat<Stats::ParentHistogram>& histogram = histograms_[histogram_index_++];
+      absl::StrAppend(&line_, histogram.first, ": ", histogram.second->quantileSummary(), "\n");
     }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, gauge->value()));
+    response.add(line_);
+    chunk_bytes += line_.size();
   }
+  return !done();
+}
 
-  for (const auto& histogram : histograms) {
-    if (!shouldShowMetric(histogram, used_only)) {
-      continue;
+PrometheusStatsRenderer::PrometheusStatsRenderer(
+    std::vector<Stats::CounterSharedPtr> counters, std::vector<Stats::GaugeSharedPtr> gauges,
+    std::vector<Stats::ParentHistogramSharedPtr> histograms, bool used_only,
+    PrometheusNameCache& names, uint64_t chunk_size)
+    : counters_(std::move(counters)), gauges_(std::move(gauges)),
+      histograms_(std::move(histograms)), used_only_(used_only), names_(names),
+      chunk_size_(chunk_size) {}
+
+bool PrometheusStatsRenderer::nextChunk(Buffer::Instance& response) {
+  uint64_t chunk_bytes = 0;
+  while (!done() && chunk_bytes < chunk_size_) {
+    line_.clear();
+    if (counter_index_ < counters_.size()) {
+      const Stats::Counter& counter = *counters_[counter_index_++];
+      if (!used_only_ || counter.used()) {
+        const std::string& metric_name = names_.metricName(counter.tagExtractedName());
+        appendTypeIfNew(metric_name, "counter");
+        absl::StrAppend(&line_, metric_name, "{");
+        appendTags(counter.tags());
+        absl::StrAppend(&line_, "} ", counter.value(), "\n");
+      }
+    } else if (gauge_index_ < gauges_.size()) {
+      const Stats::Gauge& gauge = *gauges_[gauge_index_++];
+      if (!used_only_ || gauge.used()) {
+        const std::string& metric_name = names_.metricName(gauge.tagExtractedName());
+        appendTypeIfNew(metric_name, "gauge");
+        absl::StrAppend(&line_, metric_name, "{");
+        appendTags(gauge.tags());
+        absl::StrAppend(&line_, "} ", gauge.value(), "\n");
+      }
+    } else {
+      const Stats::ParentHistogram& histogram = *histograms_[histogram_index_++];
+      if (!used_only_ || histogram.used()) {
+        const std::string& metric_name = names_.metricName(histogram.tagExtractedName());
+        appendTypeIfNew(metric_name, "histogram");
+        renderHistogram(metric_name, histogram);
+      }
     }
+    response.add(line_);
+    chunk_bytes += line_.size();
+  }
+  if (done()) {
+    // Every stat has been looked up, so names the cache holds beyond those are of stats that no
+    // longer exist.
+    names_.sweep();
+    return false;
+  }
+  return true;
+}
 
-    const std::string tags = formattedTags(histogram->tags());
-    const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
+void PrometheusStatsRenderer::appendTypeIfNew(const std::string& metric_name,
+                                              absl::string_view type) {
+  if (metric_type_tracker_.insert(metric_name).second) {
+    absl::StrAppend(&line_, "# TYPE ", metric_name, " ", type, "\n");
+  }
+}
 
-    const std::string metric_name = metricName(histogram->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} histogram\n", metric_name));
-    }
+void PrometheusStatsRenderer::appendTags(const std::vector<Stats::Tag>& tags) {
+  bool first = true;
+  for (const Stats::Tag& tag : tags) {
+    absl::StrAppend(&line_, first ? "" : ",", names_.tagName(tag.name_), "=\"", tag.value_, "\"");
+    first = false;
+  }
+}
 
-    const Stats::HistogramStatistics& stats = histogram->cumulativeStatistics();
-    const std::vector<double>& supported_buckets = stats.supportedBuckets();
-    const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
-    for (size_t i = 0; i < supported_buckets.size(); ++i) {
-      double bucket = supported_buckets[i];
-      uint64_t value = computed_buckets[i];
+void PrometheusStatsRenderer::renderHistogram(const std::string& metric_name,
+                                              const Stats::ParentHistogram& histogram) {
+  const size_t tags_start = line_.size();
+  appendTags(histogram.tags());
+  const std::string tags = line_.substr(tags_start);
+  line_.resize(tags_start);
+  const std::string hist_tags = histogram.tags().empty() ? EMPTY_STRING : (tags + ",");
+
+  const Stats::HistogramStatistics& stats = histogram.cumulativeStatistics();
+  const std::vector<std::string>& labels = bucketLabels(stats.supportedBuckets());
+  const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
+  for (size_t i = 0; i < labels.size(); ++i) {
+    absl::StrAppend(&line_, metric_name, "_bucket{", hist_tags, labels[i], "} ",
+                    computed_buckets[i], "\n");
+  }
+
+  absl::StrAppend(&line_, metric_name, "_bucket{", hist_tags, "le=\"+Inf\"} ",
+                  stats.sampleCount(), "\n");
+  absl::StrAppend(&line_, fmt::format("{0}_sum{{{1}}} {2:.32g}\n", metric_name, tags,
+                                      stats.sampleSum()));
+  absl::StrAppend(&line_, metric_name, "_count{", tags, "} ", stats.sampleCount(), "\n");
+}
+
+const std::vector<std::string>&
+PrometheusStatsRenderer::bucketLabels(const std::vector<double>& buckets) {
+  // All histograms currently share the same buckets, so this formats them once per render.
+  if (buckets != bucket_values_) {
+    bucket_values_ = buckets;
+    bucket_labels_.clear();
+    for (double bucket : buckets) {
       // We want to print the bucket in a fixed point (non-scientific) format. The fmt library
       // doesn't have a specific modifier to format as a fixed-point value only so we use the
       // 'g' operator which prints the number in general fixed point format or scientific format
       // with precision 50 to round the number up to 32 significant digits in fixed point format
       // which should cover pretty much all cases
-      response.add(fmt::format("{0}_bucket{{{1}le=\"{2:.32g}\"}} {3}\n", metric_name, hist_tags,
-                               bucket, value));
+      bucket_labels_.push_back(fmt::format("le=\"{0:.32g}\"", bucket));
     }
-
-    response.add(fmt::format("{0}_bucket{{{1}le=\"+Inf\"}} {2}\n", metric_name, hist_tags,
-                             stats.sampleCount()));
-    response.add(fmt::format("{0}_sum{{{1}}} {2:.32g}\n", metric_name, tags, stats.sampleSum()));
-    response.add(fmt::format("{0}_count{{{1}}} {2}\n", metric_name, tags, stats.sampleCount()));
   }
-
-  return metric_type_tracker.size();
+  return bucket_labels_;
 }
 
 std::string
@@ -1072,11 +1271,18 @@ void AdminFilter::onComplete() {
   RELEASE_ASSERT(request_headers_, "");
   Http::Code code = parent_.runCallback(path, *header_map, response, *this);
   populateFallbackResponseHeaders(code, *header_map);
-  callbacks_->encodeHeaders(std::move(header_map),
-                            end_stream_on_complete_ && response.length() == 0);
+  const bool end_stream = end_stream_on_complete_ && chunked_response_ == nullptr;
+  callbacks_->encodeHeaders(std::move(header_map), end_stream && response.length() == 0);
 
   if (response.length() > 0) {
-    callbacks_->encodeData(response, end_stream_on_complete_);
+    callbacks_->encodeData(response, end_stream);
+  }
+
+  if (chunked_response_ != nullptr) {
+    // Adding the callbacks reports any high watermark the connection is already above.
+    callbacks_->addDownstreamWatermarkCallbacks(*this);
+    watermark_callbacks_added_ = true;
+    encodeChunks();
   }
 }
 
@@ -1146,6 +1352,8 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
           {"/stats", "print server stats", MAKE_ADMIN_HANDLER(handlerStats), false, false},
           {"/stats/prometheus", "print server stats in prometheus format",
            MAKE_ADMIN_HANDLER(handlerPrometheusStats), false, false},
+          {"/stats/memory", "print the stats and approximate memory of each stats scope",
+           MAKE_ADMIN_HANDLER(handlerStatsMemory), false, false},
           {"/listeners", "print listener addresses", MAKE_ADMIN_HANDLER(handlerListenerInfo), false,
            false},
           {"/runtime", "print runtime values", MAKE_ADMIN_HANDLER(handlerRuntime), false, false},
@@ -1335,6 +1543,7 @@ Http::Code AdminImpl::request(absl::string_view path_and_query, absl::string_vie
   Buffer::OwnedImpl response;
 
   Http::Code code = runCallback(path_and_query, response_headers, response, filter);
+  filter.drainChunkedResponse(response);
   populateFallbackResponseHeaders(code, response_headers);
   body = response.toString();
   return code;
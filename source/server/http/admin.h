@@ -1,13 +1,16 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
 #include <list>
+#include <regex>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "envoy/admin/v2alpha/clusters.pb.h"
+#include "envoy/event/timer.h"
 #include "envoy/http/filter.h"
 #include "envoy/network/filter.h"
 #include "envoy/network/listen_socket.h"
@@ -31,11 +34,61 @@
 
 #include "server/http/config_tracker_impl.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Server {
 
+/**
+ * Caches the Prometheus forms of tag-extracted stat names and of tag names. These repeat across
+ * the stats of every cluster, listener, etc., so caching them means each is sanitized once rather
+ * than once per stat on every scrape. Names that were not looked up during a scrape are dropped
+ * at its end by sweep(), so the cache only holds the names of stats that still exist. Used on the
+ * main thread only.
+ */
+class PrometheusNameCache {
+public:
+  /**
+   * @return the sanitized metric name, prefixed with "envoy_", for a tag-extracted stat name. The
+   *         reference is valid until the next call to sweep().
+   */
+  const std::string& metricName(const std::string& tag_extracted_name);
+
+  /**
+   * @return the sanitized form of a tag name. The reference is valid until the next call to
+   *         sweep().
+   */
+  const std::string& tagName(const std::string& tag_name);
+
+  /**
+   * Drop the names that were not looked up since the previous call.
+   */
+  void sweep();
+
+  /**
+   * @return uint64_t the number of cached metric and tag names.
+   */
+  uint64_t size() const { return metric_names_.size() + tag_names_.size(); }
+
+private:
+  struct Entry {
+    std::string name_;
+    // Whether the name was looked up since the previous sweep().
+    bool used_;
+  };
+  typedef std::unordered_map<std::string, Entry> EntryMap;
+
+  static const std::string& lookup(EntryMap& entries, const std::string& key,
+                                   const std::function<std::string(const std::string&)>& sanitize);
+  static void sweep(EntryMap& entries);
+
+  // std::unordered_map rather than a flat map, as references to the values are handed out.
+  EntryMap metric_names_;
+  EntryMap tag_names_;
+};
+
 class AdminInternalAddressConfig : public Http::InternalAddressConfig {
   bool isInternalAddress(const Network::Address::Instance&) const override { return false; }
 };
@@ -160,6 +213,7 @@ private:
   };
 
   friend class AdminStatsTest;
+  friend class StatsTextRenderer;
 
   /**
    * Attempt to change the log level of a logger or all loggers
@@ -245,12 +299,19 @@ private:
   Http::Code handlerPrometheusStats(absl::string_view path_and_query,
                                     Http::HeaderMap& response_headers, Buffer::Instance& response,
                                     AdminStream&);
+  Http::Code handlerStatsMemory(absl::string_view path_and_query,
+                                Http::HeaderMap& response_headers, Buffer::Instance& response,
+                                AdminStream&);
   Http::Code handlerRuntime(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                             Buffer::Instance& response, AdminStream&);
   Http::Code handlerRuntimeModify(absl::string_view path_and_query,
                                   Http::HeaderMap& response_headers, Buffer::Instance& response,
                                   AdminStream&);
 
+  // Bounds the write buffer of admin connections, so that chunked responses such as /stats are
+  // produced only as fast as the client reads them.
+  static constexpr uint32_t ConnectionBufferLimitBytes = 1024 * 1024;
+
   class AdminListener : public Network::ListenerConfig {
   public:
     AdminListener(AdminImpl& parent, Stats::ScopePtr&& listener_scope)
@@ -264,7 +325,9 @@ private:
     const Network::Socket& socket() const override { return parent_.mutable_socket(); }
     bool bindToPort() override { return true; }
     bool handOffRestoredDestinationConnections() const override { return false; }
-    uint32_t perConnectionBufferLimitBytes() const override { return 0; }
+    uint32_t perConnectionBufferLimitBytes() const override {
+      return ConnectionBufferLimitBytes;
+    }
     std::chrono::milliseconds listenerFiltersTimeout() const override {
       return std::chrono::milliseconds();
     }
@@ -306,6 +369,7 @@ private:
   Stats::IsolatedStoreImpl no_op_store_;
   Http::ConnectionManagerTracingStats tracing_stats_;
   NullRouteConfigProvider route_config_provider_;
+  PrometheusNameCache prometheus_names_;
   std::list<UrlHandler> handlers_;
   const uint32_t max_request_headers_kb_{Http::DEFAULT_MAX_REQUEST_HEADERS_KB};
   absl::optional<std::chrono::milliseconds> idle_timeout_;
@@ -324,6 +388,7 @@ private:
  * A terminal HTTP filter that implements server admin functionality.
  */
 class AdminFilter : public Http::StreamDecoderFilter,
+                    public Http::DownstreamWatermarkCallbacks,
                     public AdminStream,
                     Logger::Loggable<Logger::Id::admin> {
 public:
@@ -340,12 +405,26 @@ public:
     callbacks_ = &callbacks;
   }
 
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override;
+  void onBelowWriteBufferLowWatermark() override;
+
   // AdminStream
   void setEndStreamOnComplete(bool end_stream) override { end_stream_on_complete_ = end_stream; }
   void addOnDestroyCallback(std::function<void()> cb) override;
   Http::StreamDecoderFilterCallbacks& getDecoderFilterCallbacks() const override;
   const Buffer::Instance* getRequestBody() const override;
   const Http::HeaderMap& getRequestHeaders() const override;
+  void setChunkedResponse(ChunkedResponsePtr&& response) override {
+    chunked_response_ = std::move(response);
+  }
+
+  /**
+   * Appends all of the chunked response set by the handler, if any, to the response. Used when
+   * the response is returned in full rather than streamed to a connection.
+   * @param response supplies the buffer to append to.
+   */
+  void drainChunkedResponse(Buffer::Instance& response);
 
 private:
   /**
@@ -353,6 +432,12 @@ private:
    */
   void onComplete();
 
+  /**
+   * Encodes chunks of the chunked response until it is complete or the downstream connection
+   * goes above its high watermark.
+   */
+  void encodeChunks();
+
   AdminImpl& parent_;
   // Handlers relying on the reference should use addOnDestroyCallback()
   // to add a callback that will notify them when the reference is no
@@ -361,6 +446,12 @@ private:
   Http::HeaderMap* request_headers_{};
   std::list<std::function<void()>> on_destroy_callbacks_;
   bool end_stream_on_complete_ = true;
+  ChunkedResponsePtr chunked_response_;
+  // Resumes encodeChunks() once the downstream connection drains, from a fresh stack rather than
+  // from within the connection's write path.
+  Event::TimerPtr resume_timer_;
+  uint32_t high_watermark_count_{};
+  bool watermark_callbacks_added_{};
 };
 
 /**
@@ -390,6 +481,8 @@ public:
   static std::string metricName(const std::string& extractedName);
 
 private:
+  friend class PrometheusNameCache;
+
   /**
    * Take a string and sanitize it according to Prometheus conventions.
    */
@@ -404,5 +497,93 @@ private:
   }
 };
 
+/**
+ * Renders the counters, gauges and histograms for /stats in the plain text format, a chunk at a
+ * time. The stats to show are chosen and sorted by name on construction; their values are read as
+ * each chunk is rendered.
+ */
+class StatsTextRenderer : public ChunkedResponse {
+public:
+  StatsTextRenderer(const std::vector<Stats::CounterSharedPtr>& counters,
+                    const std::vector<Stats::GaugeSharedPtr>& gauges,
+                    const std::vector<Stats::ParentHistogramSharedPtr>& histograms, bool used_only,
+                    const absl::optional<std::regex>& regex,
+                    uint64_t chunk_size = DefaultChunkSize);
+
+  // Server::ChunkedResponse
+  bool nextChunk(Buffer::Instance& response) override;
+
+  static constexpr uint64_t DefaultChunkSize = 64 * 1024;
+
+private:
+  template <class StatType> using NamedStat = std::pair<std::string, std::shared_ptr<StatType>>;
+
+  bool done() const {
+    return counter_index_ == counters_.size() && gauge_index_ == gauges_.size() &&
+           histogram_index_ == histograms_.size();
+  }
+
+  const uint64_t chunk_size_;
+  std::vector<NamedStat<Stats::Counter>> counters_;
+  std::vector<NamedStat<Stats::Gauge>> gauges_;
+  std::vector<NamedStat<Stats::ParentHistogram>> histograms_;
+  size_t counter_index_{};
+  size_t gauge_index_{};
+  size_t histogram_index_{};
+  // The output for the current stat, which is appended to the response whole.
+  std::string line_;
+};
+
+/**
+ * Renders counters, gauges and histograms in the Prometheus text exposition format, a chunk at a
+ * time. Metric and tag names are taken from a PrometheusNameCache, which is swept once the render
+ * is complete, and the bucket labels of histograms are formatted once per render rather than once
+ * per histogram.
+ */
+class PrometheusStatsRenderer : public ChunkedResponse {
+public:
+  PrometheusStatsRenderer(std::vector<Stats::CounterSharedPtr> counters,
+                          std::vector<Stats::GaugeSharedPtr> gauges,
+                          std::vector<Stats::ParentHistogramSharedPtr> histograms, bool used_only,
+                          PrometheusNameCache& names,
+                          uint64_t chunk_size = StatsTextRenderer::DefaultChunkSize);
+
+  // Server::ChunkedResponse
+  bool nextChunk(Buffer::Instance& response) override;
+
+  /**
+   * @return uint64_t the number of distinct metric types rendered so far.
+   */
+  uint64_t metricTypeCount() const { return metric_type_tracker_.size(); }
+
+private:
+  bool done() const {
+    return counter_index_ == counters_.size() && gauge_index_ == gauges_.size() &&
+           histogram_index_ == histograms_.size();
+  }
+
+  void appendTypeIfNew(const std::string& metric_name, absl::string_view type);
+  void appendTags(const std::vector<Stats::Tag>& tags);
+  void renderHistogram(const std::string& metric_name, const Stats::ParentHistogram& histogram);
+  const std::vector<std::string>& bucketLabels(const std::vector<double>& buckets);
+
+  const std::vector<Stats::CounterSharedPtr> counters_;
+  const std::vector<Stats::GaugeSharedPtr> gauges_;
+  const std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+  const bool used_only_;
+  PrometheusNameCache& names_;
+  const uint64_t chunk_size_;
+  size_t counter_index_{};
+  size_t gauge_index_{};
+  size_t histogram_index_{};
+  // Copies rather than views of the names in names_, since another render can sweep names_
+  // between two chunks of this one.
+  absl::flat_hash_set<std::string> metric_type_tracker_;
+  // The output for the current stat, which is appended to the response whole.
+  std::string line_;
+  std::vector<double> bucket_values_;
+  std::vector<std::string> bucket_labels_;
+};
+
 } // namespace Server
 } // namespace Envoy
@@ -1,6 +1,7 @@
 #include "server/lds_api.h"
 
 #include <unordered_map>
+#include <unordered_set>
 
 #include "envoy/api/v2/lds.pb.validate.h"
 #include "envoy/api/v2/listener/listener.pb.validate.h"
@@ -12,6 +13,8 @@
 #include "common/config/utility.h"
 #include "common/protobuf/utility.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -22,10 +25,14 @@ LdsApiImpl::LdsApiImpl(const envoy::api::v2::core::ConfigSource& lds_config,
                        ListenerManager& lm, Api::Api& api)
     : listener_manager_(lm), scope_(scope.createScope("listener_manager.lds.")), cm_(cm),
       init_target_("LDS", [this]() { subscription_->start({}, *this); }) {
+  const bool is_delta = (lds_config.api_config_source().api_type() ==
+                         envoy::api::v2::core::ApiConfigSource::DELTA_GRPC);
+  const std::string grpc_method = is_delta
+                                      ? "envoy.api.v2.ListenerDiscoveryService.DeltaListeners"
+                                      : "envoy.api.v2.ListenerDiscoveryService.StreamListeners";
   subscription_ = Envoy::Config::SubscriptionFactory::subscriptionFromConfigSource(
       lds_config, local_info, dispatcher, cm, random, *scope_,
-      "envoy.api.v2.ListenerDiscoveryService.FetchListeners",
-      "envoy.api.v2.ListenerDiscoveryService.StreamListeners",
+      "envoy.api.v2.ListenerDiscoveryService.FetchListeners", grpc_method,
       Grpc::Common::typeUrl(envoy::api::v2::Listener().GetDescriptor()->full_name()), api);
   Config::Utility::checkLocalInfo("lds", local_info);
   init_manager.add(init_target_);
@@ -36,45 +43,60 @@ void LdsApiImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::An
   cm_.adsMux().pause(Config::TypeUrl::get().RouteConfiguration);
   Cleanup rds_resume([this] { cm_.adsMux().resume(Config::TypeUrl::get().RouteConfiguration); });
 
-  std::vector<envoy::api::v2::Listener> listeners;
+  // We need to keep track of which listeners we might need to remove.
+  std::unordered_map<std::string, std::reference_wrapper<Network::ListenerConfig>>
+      listeners_to_remove;
+  for (const auto& listener : listener_manager_.listeners()) {
+    listeners_to_remove.emplace(listener.get().name(), listener);
+  }
+
+  // A listener that is still there and arrives with the same serialized config as when it was last
+  // applied is skipped before it is converted from its Any.
+  std::vector<ListenerUpdate> listeners;
+  std::vector<std::string> listener_names;
   for (const auto& listener_blob : resources) {
-    listeners.push_back(MessageUtil::anyConvert<envoy::api::v2::Listener>(listener_blob));
-    MessageUtil::validate(listeners.back());
+    const uint64_t hash = Config::ResourceHashCache::hash(listener_blob);
+    const std::string* unchanged_name = resource_hashes_.find(hash);
+    if (unchanged_name != nullptr && listeners_to_remove.count(*unchanged_name) > 0) {
+      listener_names.push_back(*unchanged_name);
+      continue;
+    }
+    listeners.push_back({MessageUtil::anyConvert<envoy::api::v2::Listener>(listener_blob), hash});
+    MessageUtil::validate(listeners.back().listener_);
+    listener_names.push_back(listeners.back().listener_.name());
   }
   std::vector<std::string> exception_msgs;
-  std::unordered_set<std::string> listener_names;
-  for (const auto& listener : listeners) {
-    if (!listener_names.insert(listener.name()).second) {
-      throw EnvoyException(fmt::format("duplicate listener {} found", listener.name()));
+  std::unordered_set<std::string> unique_listener_names;
+  for (const std::string& listener_name : listener_names) {
+    if (!unique_listener_names.insert(listener_name).second) {
+      throw EnvoyException(fmt::format("duplicate listener {} found", listener_name));
     }
   }
-  // We need to keep track of which listeners we might need to remove.
-  std::unordered_map<std::string, std::reference_wrapper<Network::ListenerConfig>>
-      listeners_to_remove;
+  ENVOY_LOG(debug, "lds: {} of {} listener(s) unchanged", listener_names.size() - listeners.size(),
+            listener_names.size());
 
   // We build the list of listeners to be removed and remove them before
   // adding new listeners. This allows adding a new listener with the same
   // address as a listener that is to be removed. Do not change the order.
-  for (const auto& listener : listener_manager_.listeners()) {
-    listeners_to_remove.emplace(listener.get().name(), listener);
-  }
-  for (const auto& listener : listeners) {
-    listeners_to_remove.erase(listener.name());
+  for (const std::string& listener_name : listener_names) {
+    listeners_to_remove.erase(listener_name);
   }
   for (const auto& listener : listeners_to_remove) {
+    resource_hashes_.erase(listener.first);
     if (listener_manager_.removeListener(listener.first)) {
       ENVOY_LOG(info, "lds: remove listener '{}'", listener.first);
     }
   }
 
-  for (const auto& listener : listeners) {
-    const std::string& listener_name = listener.name();
+  for (const auto& update : listeners) {
+    const std::string& listener_name = update.listener_.name();
     try {
-      if (listener_manager_.addOrUpdateListener(listener, version_info, true)) {
+      if (listener_manager_.addOrUpdateListener(update.listener_, version_info, true)) {
         ENVOY_LOG(info, "lds: add/update listener '{}'", listener_name);
       } else {
         ENVOY_LOG(debug, "lds: add/update listener '{}' skipped", listener_name);
       }
+      resource_hashes_.insert(listener_name, update.hash_);
     } catch (const EnvoyException& e) {
       exception_msgs.push_back(fmt::format("{}: {}", listener_name, e.what()));
     }
@@ -88,6 +110,77 @@ void LdsApiImpl::onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::An
   }
 }
 
+void LdsApiImpl::onConfigUpdate(
+    const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
+    const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+    const std::string& system_version_info) {
+  cm_.adsMux().pause(Config::TypeUrl::get().RouteConfiguration);
+  Cleanup rds_resume([this] { cm_.adsMux().resume(Config::TypeUrl::get().RouteConfiguration); });
+
+  // Only the listeners named in the update are touched. As for a state-of-the-world update,
+  // listeners are removed before others are added, so that an added listener can take the address
+  // of a removed one.
+  for (const std::string& listener_name : removed_resources) {
+    resource_hashes_.erase(listener_name);
+    if (listener_manager_.removeListener(listener_name)) {
+      ENVOY_LOG(info, "lds: remove listener '{}'", listener_name);
+    }
+  }
+
+  // As for a state-of-the-world update, a listener that is still there and arrives with the same
+  // serialized config as when it was last applied is skipped before it is converted. The current
+  // listeners are only looked up if there is such a listener.
+  absl::optional<std::unordered_set<std::string>> current_listeners;
+  const auto unchanged = [this, &current_listeners](const envoy::api::v2::Resource& resource,
+                                                    uint64_t hash) {
+    if (!resource_hashes_.contains(resource.name(), hash)) {
+      return false;
+    }
+    if (!current_listeners.has_value()) {
+      current_listeners.emplace();
+      for (const auto& listener : listener_manager_.listeners()) {
+        current_listeners->insert(listener.get().name());
+      }
+    }
+    return current_listeners->count(resource.name()) > 0;
+  };
+
+  std::vector<std::string> exception_msgs;
+  std::unordered_set<std::string> listener_names;
+  for (const auto& resource : added_resources) {
+    try {
+      const uint64_t hash = Config::ResourceHashCache::hash(resource.resource());
+      if (unchanged(resource, hash)) {
+        if (!listener_names.insert(resource.name()).second) {
+          throw EnvoyException(fmt::format("duplicate listener {} found", resource.name()));
+        }
+        ENVOY_LOG(debug, "lds: listener '{}' unchanged", resource.name());
+        continue;
+      }
+      const auto listener = MessageUtil::anyConvert<envoy::api::v2::Listener>(resource.resource());
+      MessageUtil::validate(listener);
+      if (!listener_names.insert(listener.name()).second) {
+        throw EnvoyException(fmt::format("duplicate listener {} found", listener.name()));
+      }
+      if (listener_manager_.addOrUpdateListener(listener, resource.version(), true)) {
+        ENVOY_LOG(info, "lds: add/update listener '{}'", listener.name());
+      } else {
+        ENVOY_LOG(debug, "lds: add/update listener '{}' skipped", listener.name());
+      }
+      resource_hashes_.insert(listener.name(), hash);
+    } catch (const EnvoyException& e) {
+      exception_msgs.push_back(fmt::format("{}: {}", resource.name(), e.what()));
+    }
+  }
+
+  version_info_ = system_version_info;
+  init_target_.ready();
+  if (!exception_msgs.empty()) {
+    throw EnvoyException(fmt::format("Error adding/updating listener(s) {}",
+                                     StringUtil::join(exception_msgs, ", ")));
+  }
+}
+
 void LdsApiImpl::onConfigUpdateFailed(const EnvoyException*) {
   // We need to allow server startup to continue, even if we have a bad
   // config.
@@ -10,6 +10,7 @@
 #include "envoy/stats/scope.h"
 
 #include "common/common/logger.h"
+#include "common/config/resource_hash_cache.h"
 #include "common/init/target_impl.h"
 
 namespace Envoy {
@@ -34,22 +35,27 @@ public:
   // TODO(fredlas) deduplicate
   void onConfigUpdate(const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
                       const std::string& version_info) override;
-  void onConfigUpdate(const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>&,
-                      const Protobuf::RepeatedPtrField<std::string>&, const std::string&) override {
-    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
-  }
+  void onConfigUpdate(const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
+                      const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                      const std::string& system_version_info) override;
   void onConfigUpdateFailed(const EnvoyException* e) override;
   std::string resourceName(const ProtobufWkt::Any& resource) override {
     return MessageUtil::anyConvert<envoy::api::v2::Listener>(resource).name();
   }
 
 private:
+  struct ListenerUpdate {
+    envoy::api::v2::Listener listener_;
+    uint64_t hash_;
+  };
+
   std::unique_ptr<Config::Subscription> subscription_;
   std::string version_info_;
   ListenerManager& listener_manager_;
   Stats::ScopePtr scope_;
   Upstream::ClusterManager& cm_;
   Init::TargetImpl init_target_;
+  Config::ResourceHashCache resource_hashes_;
 };
 
 } // namespace Server
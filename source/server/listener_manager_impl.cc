@@ -7,7 +7,6 @@
 
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
-#include "common/common/empty_string.h"
 #include "common/common/fmt.h"
 #include "common/config/utility.h"
 #include "common/network/io_socket_handle_impl.h"
@@ -16,6 +15,7 @@
 #include "common/network/socket_option_factory.h"
 #include "common/network/utility.h"
 #include "common/protobuf/utility.h"
+#include "common/runtime/runtime_impl.h"
 
 #include "server/configuration_impl.h"
 #include "server/drain_manager_impl.h"
@@ -25,7 +25,6 @@
 #include "extensions/filters/network/well_known_names.h"
 #include "extensions/transport_sockets/well_known_names.h"
 
-#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 
 namespace Envoy {
@@ -173,7 +172,8 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
       local_drain_manager_(parent.factory_.createDrainManager(config.drain_type())),
       config_(config), version_info_(version_info),
       listener_filters_timeout_(
-          PROTOBUF_GET_MS_OR_DEFAULT(config, listener_filters_timeout, 15000)) {
+          PROTOBUF_GET_MS_OR_DEFAULT(config, listener_filters_timeout, 15000)),
+      filter_chain_manager_(address_) {
   if (config.has_transparent()) {
     addListenSocketOptions(Network::SocketOptionFactory::buildIpTransparentOptions());
   }
@@ -215,17 +215,8 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
   }
 
   bool need_tls_inspector = false;
-  std::unordered_set<envoy::api::v2::listener::FilterChainMatch, MessageUtil, MessageUtil>
-      filter_chains;
-
   for (const auto& filter_chain : config.filter_chains()) {
     const auto& filter_chain_match = filter_chain.filter_chain_match();
-    if (filter_chains.find(filter_chain_match) != filter_chains.end()) {
-      throw EnvoyException(fmt::format("error adding listener '{}': multiple filter chains with "
-                                       "the same matching rules are defined",
-                                       address_->asString()));
-    }
-    filter_chains.insert(filter_chain_match);
 
     // If the cluster doesn't have transport socket configured, then use the default "raw_buffer"
     // transport socket or BoringSSL-based "tls" transport socket if TLS settings are configured.
@@ -246,49 +237,37 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
     ProtobufTypes::MessagePtr message =
         Config::Utility::translateToFactoryConfig(transport_socket, config_factory);
 
-    // Validate IP addresses.
-    std::vector<std::string> destination_ips;
-    for (const auto& destination_ip : filter_chain_match.prefix_ranges()) {
-      const auto& cidr_range = Network::Address::CidrRange::create(destination_ip);
-      destination_ips.push_back(cidr_range.asString());
-    }
-
     std::vector<std::string> server_names(filter_chain_match.server_names().begin(),
                                           filter_chain_match.server_names().end());
 
-    // Reject partial wildcards, we don't match on them.
-    for (const auto& server_name : server_names) {
-      if (server_name.find('*') != std::string::npos && !isWildcardServerName(server_name)) {
-        throw EnvoyException(
-            fmt::format("error adding listener '{}': partial wildcards are not supported in "
-                        "\"server_names\"",
-                        address_->asString()));
-      }
-    }
-
-    std::vector<std::string> application_protocols(
-        filter_chain_match.application_protocols().begin(),
-        filter_chain_match.application_protocols().end());
     Server::Configuration::TransportSocketFactoryContextImpl factory_context(
         parent_.server_.admin(), parent_.server_.sslContextManager(), *listener_scope_,
         parent_.server_.clusterManager(), parent_.server_.localInfo(), parent_.server_.dispatcher(),
         parent_.server_.random(), parent_.server_.stats(), parent_.server_.singletonManager(),
         parent_.server_.threadLocal(), parent_.server_.api());
     factory_context.setInitManager(initManager());
-    addFilterChain(
-        PROTOBUF_GET_WRAPPED_OR_DEFAULT(filter_chain_match, destination_port, 0), destination_ips,
-        server_names, filter_chain_match.transport_protocol(), application_protocols,
-        filter_chain_match.source_type(),
-        config_factory.createTransportSocketFactory(*message, factory_context, server_names),
-        parent_.factory_.createNetworkFilterFactoryList(filter_chain.filters(), *this));
-
-    need_tls_inspector |= filter_chain_match.transport_protocol() == "tls" ||
-                          (filter_chain_match.transport_protocol().empty() &&
-                           (!server_names.empty() || !application_protocols.empty()));
-  }
-
-  // Convert DestinationIPsMap to DestinationIPsTrie for faster lookups.
-  convertDestinationIPsMapToTrie();
+    Network::TransportSocketFactoryPtr transport_socket_factory =
+        config_factory.createTransportSocketFactory(*message, factory_context, server_names);
+    // Each filter chain gets its own factory context so that it can be drained independently.
+    auto filter_chain_factory_context = std::make_unique<FilterChainFactoryContextImpl>(*this);
+    std::vector<Network::FilterFactoryCb> filter_factories =
+        parent_.factory_.createNetworkFilterFactoryList(filter_chain.filters(),
+                                                        *filter_chain_factory_context);
+    // The filter chain manager validates the match rules, including that they are unique.
+    filter_chain_manager_.addFilterChain(
+        filter_chain_match,
+        std::make_shared<FilterChainImpl>(
+            std::move(filter_chain_factory_context), std::move(transport_socket_factory),
+            std::move(filter_factories), MessageUtil::hash(filter_chain)));
+
+    need_tls_inspector |=
+        filter_chain_match.transport_protocol() == "tls" ||
+        (filter_chain_match.transport_protocol().empty() &&
+         (!server_names.empty() || !filter_chain_match.application_protocols().empty()));
+  }
+
+  // Compile the match rules of all filter chains for faster lookups.
+  filter_chain_manager_.compile();
 
   // Automatically inject TLS Inspector if it wasn't configured explicitly and it's needed.
   if (need_tls_inspector) {
@@ -322,287 +301,6 @@ ListenerImpl::~ListenerImpl() {
   // active. This is done here explicitly by resetting the watcher and then clearing the factory
   // vector for clarity.
   init_watcher_.reset();
-  destination_ports_map_.clear();
-}
-
-bool ListenerImpl::isWildcardServerName(const std::string& name) {
-  return absl::StartsWith(name, "*.");
-}
-
-void ListenerImpl::addFilterChain(
-    uint16_t destination_port, const std::vector<std::string>& destination_ips,
-    const std::vector<std::string>& server_names, const std::string& transport_protocol,
-    const std::vector<std::string>& application_protocols,
-    const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-    Network::TransportSocketFactoryPtr&& transport_socket_factory,
-    std::vector<Network::FilterFactoryCb> filters_factory) {
-  const auto filter_chain = std::make_shared<FilterChainImpl>(std::move(transport_socket_factory),
-                                                              std::move(filters_factory));
-  addFilterChainForDestinationPorts(destination_ports_map_, destination_port, destination_ips,
-                                    server_names, transport_protocol, application_protocols,
-                                    source_type, filter_chain);
-}
-
-void ListenerImpl::addFilterChainForDestinationPorts(
-    DestinationPortsMap& destination_ports_map, uint16_t destination_port,
-    const std::vector<std::string>& destination_ips, const std::vector<std::string>& server_names,
-    const std::string& transport_protocol, const std::vector<std::string>& application_protocols,
-    const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-    const Network::FilterChainSharedPtr& filter_chain) {
-  if (destination_ports_map.find(destination_port) == destination_ports_map.end()) {
-    destination_ports_map[destination_port] =
-        std::make_pair<DestinationIPsMap, DestinationIPsTriePtr>(DestinationIPsMap{}, nullptr);
-  }
-  addFilterChainForDestinationIPs(destination_ports_map[destination_port].first, destination_ips,
-                                  server_names, transport_protocol, application_protocols,
-                                  source_type, filter_chain);
-}
-
-void ListenerImpl::addFilterChainForDestinationIPs(
-    DestinationIPsMap& destination_ips_map, const std::vector<std::string>& destination_ips,
-    const std::vector<std::string>& server_names, const std::string& transport_protocol,
-    const std::vector<std::string>& application_protocols,
-    const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-    const Network::FilterChainSharedPtr& filter_chain) {
-  if (destination_ips.empty()) {
-    addFilterChainForServerNames(destination_ips_map[EMPTY_STRING], server_names,
-                                 transport_protocol, application_protocols, source_type,
-                                 filter_chain);
-  } else {
-    for (const auto& destination_ip : destination_ips) {
-      addFilterChainForServerNames(destination_ips_map[destination_ip], server_names,
-                                   transport_protocol, application_protocols, source_type,
-                                   filter_chain);
-    }
-  }
-}
-
-void ListenerImpl::addFilterChainForServerNames(
-    ServerNamesMap& server_names_map, const std::vector<std::string>& server_names,
-    const std::string& transport_protocol, const std::vector<std::string>& application_protocols,
-    const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-    const Network::FilterChainSharedPtr& filter_chain) {
-  if (server_names.empty()) {
-    addFilterChainForApplicationProtocols(server_names_map[EMPTY_STRING][transport_protocol],
-                                          application_protocols, source_type, filter_chain);
-  } else {
-    for (const auto& server_name : server_names) {
-      if (isWildcardServerName(server_name)) {
-        // Add mapping for the wildcard domain, i.e. ".example.com" for "*.example.com".
-        addFilterChainForApplicationProtocols(
-            server_names_map[server_name.substr(1)][transport_protocol], application_protocols,
-            source_type, filter_chain);
-      } else {
-        addFilterChainForApplicationProtocols(server_names_map[server_name][transport_protocol],
-                                              application_protocols, source_type, filter_chain);
-      }
-    }
-  }
-}
-
-void ListenerImpl::addFilterChainForApplicationProtocols(
-    ApplicationProtocolsMap& application_protocols_map,
-    const std::vector<std::string>& application_protocols,
-    const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-    const Network::FilterChainSharedPtr& filter_chain) {
-  if (application_protocols.empty()) {
-    addFilterChainForSourceTypes(application_protocols_map[EMPTY_STRING], source_type,
-                                 filter_chain);
-  } else {
-    for (const auto& application_protocol : application_protocols) {
-      addFilterChainForSourceTypes(application_protocols_map[application_protocol], source_type,
-                                   filter_chain);
-    }
-  }
-}
-
-void ListenerImpl::addFilterChainForSourceTypes(
-    SourceTypesArray& source_types_array,
-    const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-    const Network::FilterChainSharedPtr& filter_chain) {
-  if (source_types_array[source_type] != nullptr) {
-    // We should never get here once all fields in FilterChainMatch are implemented. At this point,
-    // this can become an ASSERT. In principle, we could verify the various missing fields earlier,
-    // but best to have defense-in-depth here, since any mistake leads to potential
-    // heap-use-after-free when filter chains are unexpectedly destructed.
-    throw EnvoyException(fmt::format("error adding listener '{}': multiple filter chains with "
-                                     "effectively equivalent matching rules are defined",
-                                     address_->asString()));
-  }
-  source_types_array[source_type] = filter_chain;
-}
-
-void ListenerImpl::convertDestinationIPsMapToTrie() {
-  for (auto& port : destination_ports_map_) {
-    auto& destination_ips_pair = port.second;
-    auto& destination_ips_map = destination_ips_pair.first;
-    std::vector<std::pair<ServerNamesMapSharedPtr, std::vector<Network::Address::CidrRange>>> list;
-    for (const auto& entry : destination_ips_map) {
-      std::vector<Network::Address::CidrRange> subnets;
-      if (entry.first == EMPTY_STRING) {
-        if (Network::Address::ipFamilySupported(AF_INET)) {
-          subnets.push_back(Network::Address::CidrRange::create("0.0.0.0/0"));
-        }
-        if (Network::Address::ipFamilySupported(AF_INET6)) {
-          subnets.push_back(Network::Address::CidrRange::create("::/0"));
-        }
-      } else {
-        subnets.push_back(Network::Address::CidrRange::create(entry.first));
-      }
-      list.push_back(
-          std::make_pair<ServerNamesMapSharedPtr, std::vector<Network::Address::CidrRange>>(
-              std::make_shared<ServerNamesMap>(entry.second),
-              std::vector<Network::Address::CidrRange>(subnets)));
-    }
-    destination_ips_pair.second = std::make_unique<DestinationIPsTrie>(list, true);
-  }
-}
-
-const Network::FilterChain*
-ListenerImpl::findFilterChain(const Network::ConnectionSocket& socket) const {
-  const auto& address = socket.localAddress();
-
-  // Match on destination port (only for IP addresses).
-  if (address->type() == Network::Address::Type::Ip) {
-    const auto port_match = destination_ports_map_.find(address->ip()->port());
-    if (port_match != destination_ports_map_.end()) {
-      return findFilterChainForDestinationIP(*port_match->second.second, socket);
-    }
-  }
-
-  // Match on catch-all port 0.
-  const auto port_match = destination_ports_map_.find(0);
-  if (port_match != destination_ports_map_.end()) {
-    return findFilterChainForDestinationIP(*port_match->second.second, socket);
-  }
-
-  return nullptr;
-}
-
-const Network::FilterChain*
-ListenerImpl::findFilterChainForDestinationIP(const DestinationIPsTrie& destination_ips_trie,
-                                              const Network::ConnectionSocket& socket) const {
-  // Use invalid IP address (matching only filter chains without IP requirements) for UDS.
-  static const auto& fake_address = Network::Utility::parseInternetAddress("255.255.255.255");
-
-  auto address = socket.localAddress();
-  if (address->type() != Network::Address::Type::Ip) {
-    address = fake_address;
-  }
-
-  // Match on both: exact IP and wider CIDR ranges using LcTrie.
-  const auto& data = destination_ips_trie.getData(address);
-  if (!data.empty()) {
-    ASSERT(data.size() == 1);
-    return findFilterChainForServerName(*data.back(), socket);
-  }
-
-  return nullptr;
-}
-
-const Network::FilterChain*
-ListenerImpl::findFilterChainForServerName(const ServerNamesMap& server_names_map,
-                                           const Network::ConnectionSocket& socket) const {
-  const std::string server_name(socket.requestedServerName());
-
-  // Match on exact server name, i.e. "www.example.com" for "www.example.com".
-  const auto server_name_exact_match = server_names_map.find(server_name);
-  if (server_name_exact_match != server_names_map.end()) {
-    return findFilterChainForTransportProtocol(server_name_exact_match->second, socket);
-  }
-
-  // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com".
-  size_t pos = server_name.find('.', 1);
-  while (pos < server_name.size() - 1 && pos != std::string::npos) {
-    const std::string wildcard = server_name.substr(pos);
-    const auto server_name_wildcard_match = server_names_map.find(wildcard);
-    if (server_name_wildcard_match != server_names_map.end()) {
-      return findFilterChainForTransportProtocol(server_name_wildcard_match->second, socket);
-    }
-    pos = server_name.find('.', pos + 1);
-  }
-
-  // Match on a filter chain without server name requirements.
-  const auto server_name_catchall_match = server_names_map.find(EMPTY_STRING);
-  if (server_name_catchall_match != server_names_map.end()) {
-    return findFilterChainForTransportProtocol(server_name_catchall_match->second, socket);
-  }
-
-  return nullptr;
-}
-
-const Network::FilterChain* ListenerImpl::findFilterChainForTransportProtocol(
-    const TransportProtocolsMap& transport_protocols_map,
-    const Network::ConnectionSocket& socket) const {
-  const std::string transport_protocol(socket.detectedTransportProtocol());
-
-  // Match on exact transport protocol, e.g. "tls".
-  const auto transport_protocol_match = transport_protocols_map.find(transport_protocol);
-  if (transport_protocol_match != transport_protocols_map.end()) {
-    return findFilterChainForApplicationProtocols(transport_protocol_match->second, socket);
-  }
-
-  // Match on a filter chain without transport protocol requirements.
-  const auto any_protocol_match = transport_protocols_map.find(EMPTY_STRING);
-  if (any_protocol_match != transport_protocols_map.end()) {
-    return findFilterChainForApplicationProtocols(any_protocol_match->second, socket);
-  }
-
-  return nullptr;
-}
-
-const Network::FilterChain* ListenerImpl::findFilterChainForApplicationProtocols(
-    const ApplicationProtocolsMap& application_protocols_map,
-    const Network::ConnectionSocket& socket) const {
-  // Match on exact application protocol, e.g. "h2" or "http/1.1".
-  for (const auto& application_protocol : socket.requestedApplicationProtocols()) {
-    const auto application_protocol_match = application_protocols_map.find(application_protocol);
-    if (application_protocol_match != application_protocols_map.end()) {
-      return findFilterChainForSourceTypes(application_protocol_match->second, socket);
-    }
-  }
-
-  // Match on a filter chain without application protocol requirements.
-  const auto any_protocol_match = application_protocols_map.find(EMPTY_STRING);
-  if (any_protocol_match != application_protocols_map.end()) {
-    return findFilterChainForSourceTypes(any_protocol_match->second, socket);
-  }
-
-  return nullptr;
-}
-
-const Network::FilterChain*
-ListenerImpl::findFilterChainForSourceTypes(const SourceTypesArray& source_types,
-                                            const Network::ConnectionSocket& socket) const {
-
-  auto filter_chain_local =
-      source_types[envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType::
-                       FilterChainMatch_ConnectionSourceType_LOCAL];
-
-  auto filter_chain_external =
-      source_types[envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType::
-                       FilterChainMatch_ConnectionSourceType_EXTERNAL];
-
-  // isLocalConnection can be expensive. Call it only if LOCAL or EXTERNAL are defined.
-  const bool is_local_connection = (filter_chain_local || filter_chain_external)
-                                       ? Network::Utility::isLocalConnection(socket)
-                                       : false;
-
-  if (is_local_connection) {
-    if (filter_chain_local) {
-      return filter_chain_local.get();
-    }
-  } else {
-    if (filter_chain_external) {
-      return filter_chain_external.get();
-    }
-  }
-
-  auto filter_chain_any =
-      source_types[envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType::
-                       FilterChainMatch_ConnectionSourceType_ANY];
-
-  return filter_chain_any.get();
 }
 
 bool ListenerImpl::createNetworkFilterChain(
@@ -622,6 +320,38 @@ bool ListenerImpl::drainClose() const {
   return local_drain_manager_->drainClose() || parent_.server_.drainManager().drainClose();
 }
 
+bool ListenerImpl::supportsInPlaceUpdate(const envoy::api::v2::Listener& config) const {
+  envoy::api::v2::Listener lhs = config_;
+  envoy::api::v2::Listener rhs = config;
+  lhs.clear_filter_chains();
+  rhs.clear_filter_chains();
+  return Protobuf::util::MessageDifferencer::Equivalent(lhs, rhs);
+}
+
+std::vector<FilterChainImpl*>
+ListenerImpl::filterChainsToDrain(const ListenerImpl* new_listener) const {
+  std::vector<FilterChainImpl*> filter_chains;
+  for (const auto& filter_chain : config_.filter_chains()) {
+    // Only FilterChainImpl instances are ever added to the filter chain manager.
+    auto* existing = static_cast<FilterChainImpl*>(
+        filter_chain_manager_.getFilterChain(filter_chain.filter_chain_match()).get());
+    ASSERT(existing != nullptr);
+    if (existing->factoryContext().draining()) {
+      continue;
+    }
+    if (new_listener != nullptr) {
+      const auto* updated = static_cast<const FilterChainImpl*>(
+          new_listener->filter_chain_manager_.getFilterChain(filter_chain.filter_chain_match())
+              .get());
+      if (updated != nullptr && updated->hash() == existing->hash()) {
+        continue;
+      }
+    }
+    filter_chains.push_back(existing);
+  }
+  return filter_chains;
+}
+
 void ListenerImpl::debugLog(const std::string& message) {
   UNREFERENCED_PARAMETER(message);
   ENVOY_LOG(debug, "{}: name={}, hash={}, address={}", message, name_, hash_, address_->asString());
@@ -669,6 +399,8 @@ void ListenerImpl::setSocket(const Network::SocketSharedPtr& socket) {
   }
 }
 
+constexpr uint64_t ListenerManagerImpl::MaxRetiringGenerations;
+
 ListenerManagerImpl::ListenerManagerImpl(Instance& server,
                                          ListenerComponentFactory& listener_factory,
                                          WorkerFactory& worker_factory,
@@ -717,6 +449,14 @@ ProtobufTypes::MessagePtr ListenerManagerImpl::dumpListenerConfigs() {
                                           *(dynamic_listener.mutable_last_updated()));
   }
 
+  for (const auto& listener : retiring_listeners_) {
+    auto& dynamic_listener = *config_dump->mutable_dynamic_retiring_listeners()->Add();
+    dynamic_listener.set_version_info(listener.listener_->versionInfo());
+    dynamic_listener.mutable_listener()->MergeFrom(listener.listener_->config());
+    TimestampUtil::systemClockToTimestamp(listener.listener_->last_updated_,
+                                          *(dynamic_listener.mutable_last_updated()));
+  }
+
   return config_dump;
 }
 
@@ -855,6 +595,10 @@ bool ListenerManagerImpl::hasListenerWithAddress(const ListenerList& list,
 }
 
 void ListenerManagerImpl::drainListener(ListenerImplPtr&& listener) {
+  // Older generations of the listener that are still serving connections of their unchanged filter
+  // chains are drained along with it.
+  drainRetiringListeners(listener->name(), nullptr);
+
   // First add the listener to the draining list.
   std::list<DrainingListener>::iterator draining_it = draining_listeners_.emplace(
       draining_listeners_.begin(), std::move(listener), workers_.size());
@@ -894,6 +638,96 @@ void ListenerManagerImpl::drainListener(ListenerImplPtr&& listener) {
   updateWarmingActiveGauges();
 }
 
+void ListenerManagerImpl::updateListenerInPlace(ListenerImplPtr&& listener,
+                                                const ListenerImpl& new_listener) {
+  // Filter chains of older generations of the listener that are not part of the new listener must
+  // be drained as well.
+  drainRetiringListeners(listener->name(), &new_listener);
+
+  std::list<RetiringListener>::iterator retiring_it = retiring_listeners_.emplace(
+      retiring_listeners_.begin(), std::move(listener), workers_.size());
+  stats_.total_listeners_retiring_.set(retiring_listeners_.size());
+  stats_.listener_in_place_updated_.inc();
+
+  // Tell all workers to stop accepting new connections on this listener. Its existing connections
+  // keep running until they either close on their own or their filter chain is drained.
+  retiring_it->listener_->debugLog("retiring listener");
+  for (const auto& worker : workers_) {
+    worker->stopListener(*retiring_it->listener_);
+  }
+
+  drainFilterChains(*retiring_it, &new_listener);
+
+  // Every update keeps the connections of the unchanged filter chains on another generation, so
+  // long lived connections could otherwise keep any number of generations around. Past the limit,
+  // all the filter chains of the oldest generations are drained, which closes their connections
+  // once the drain time is over.
+  uint64_t generations = 0;
+  for (auto& retiring_listener : retiring_listeners_) {
+    if (retiring_listener.listener_->name() == retiring_it->listener_->name() &&
+        !retiring_listener.draining_all_ && ++generations > MaxRetiringGenerations) {
+      drainFilterChains(retiring_listener, nullptr);
+    }
+  }
+
+  for (const auto& worker : workers_) {
+    worker->removeListenerWhenIdle(*retiring_it->listener_, [this, retiring_it]() -> void {
+      // The completion is called on the worker thread. See drainListener() for why we post back to
+      // the main thread.
+      server_.dispatcher().post([this, retiring_it]() -> void {
+        if (--retiring_it->workers_pending_removal_ == 0) {
+          retiring_it->listener_->debugLog("retired listener removal complete");
+          retiring_listeners_.erase(retiring_it);
+          stats_.total_listeners_retiring_.set(retiring_listeners_.size());
+        }
+      });
+    });
+  }
+}
+
+void ListenerManagerImpl::drainFilterChains(RetiringListener& retiring_listener,
+                                            const ListenerImpl* new_listener) {
+  if (new_listener == nullptr) {
+    retiring_listener.draining_all_ = true;
+  }
+  const std::vector<FilterChainImpl*> filter_chains =
+      retiring_listener.listener_->filterChainsToDrain(new_listener);
+  if (filter_chains.empty()) {
+    return;
+  }
+
+  ENVOY_LOG(debug, "draining {} filter chains of listener '{}'", filter_chains.size(),
+            retiring_listener.listener_->name());
+  retiring_listener.filter_chain_drain_managers_.emplace_back(
+      factory_.createDrainManager(retiring_listener.listener_->config().drain_type()));
+  DrainManager& drain_manager = *retiring_listener.filter_chain_drain_managers_.back();
+  std::list<const Network::FilterChain*> removed_filter_chains;
+  for (FilterChainImpl* filter_chain : filter_chains) {
+    filter_chain->factoryContext().startDraining(drain_manager);
+    removed_filter_chains.push_back(filter_chain);
+  }
+
+  // Once the drain time has completed, the workers close the remaining connections of the drained
+  // filter chains. The drain manager is owned by the retiring listener, so the completion never
+  // fires once the listener has been removed.
+  ListenerImpl& listener = *retiring_listener.listener_;
+  drain_manager.startDrainSequence([this, &listener, removed_filter_chains]() -> void {
+    listener.debugLog("removing drained filter chains");
+    for (const auto& worker : workers_) {
+      worker->removeFilterChains(listener, removed_filter_chains);
+    }
+  });
+}
+
+void ListenerManagerImpl::drainRetiringListeners(const std::string& name,
+                                                 const ListenerImpl* new_listener) {
+  for (auto& retiring_listener : retiring_listeners_) {
+    if (retiring_listener.listener_->name() == name) {
+      drainFilterChains(retiring_listener, new_listener);
+    }
+  }
+}
+
 ListenerManagerImpl::ListenerList::iterator
 ListenerManagerImpl::getListenerByName(ListenerList& listeners, const std::string& name) {
   auto ret = listeners.end();
@@ -954,7 +788,14 @@ void ListenerManagerImpl::onListenerWarmed(ListenerImpl& listener) {
   auto existing_warming_listener = getListenerByName(warming_listeners_, listener.name());
   (*existing_warming_listener)->debugLog("warm complete. updating active listener");
   if (existing_active_listener != active_listeners_.end()) {
-    drainListener(std::move(*existing_active_listener));
+    // If only filter chains changed, leave the connections of the unchanged filter chains alone.
+    if (Runtime::runtimeFeatureEnabled(
+            "envoy.reloadable_features.listener_in_place_filter_chain_update") &&
+        (*existing_active_listener)->supportsInPlaceUpdate(listener.config())) {
+      updateListenerInPlace(std::move(*existing_active_listener), listener);
+    } else {
+      drainListener(std::move(*existing_active_listener));
+    }
     *existing_active_listener = std::move(*existing_warming_listener);
   } else {
     active_listeners_.emplace_back(std::move(*existing_warming_listener));
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <list>
 #include <memory>
+#include <vector>
 
 #include "envoy/api/v2/listener/listener.pb.h"
 #include "envoy/network/filter.h"
@@ -13,9 +16,8 @@
 
 #include "common/common/logger.h"
 #include "common/init/manager_impl.h"
-#include "common/network/cidr_range.h"
-#include "common/network/lc_trie.h"
 
+#include "server/filter_chain_manager_impl.h"
 #include "server/lds_api.h"
 
 namespace Envoy {
@@ -75,6 +77,7 @@ private:
 
 class ListenerImpl;
 typedef std::unique_ptr<ListenerImpl> ListenerImplPtr;
+class FilterChainImpl;
 
 /**
  * All listener manager stats. @see stats_macros.h
@@ -86,9 +89,11 @@ typedef std::unique_ptr<ListenerImpl> ListenerImplPtr;
   COUNTER(listener_removed)                                                                        \
   COUNTER(listener_create_success)                                                                 \
   COUNTER(listener_create_failure)                                                                 \
+  COUNTER(listener_in_place_updated)                                                               \
   GAUGE  (total_listeners_warming)                                                                 \
   GAUGE  (total_listeners_active)                                                                  \
-  GAUGE  (total_listeners_draining)
+  GAUGE  (total_listeners_draining)                                                                \
+  GAUGE  (total_listeners_retiring)
 // clang-format on
 
 /**
@@ -123,6 +128,10 @@ public:
   void stopWorkers() override;
   Http::Context& httpContext() { return server_.httpContext(); }
 
+  // The maximum number of retiring generations of a listener whose unchanged filter chains are
+  // left alone. See updateListenerInPlace().
+  static constexpr uint64_t MaxRetiringGenerations = 4;
+
   Instance& server_;
   ListenerComponentFactory& factory_;
 
@@ -137,6 +146,18 @@ private:
     uint64_t workers_pending_removal_;
   };
 
+  struct RetiringListener {
+    RetiringListener(ListenerImplPtr&& listener, uint64_t workers_pending_removal)
+        : listener_(std::move(listener)), workers_pending_removal_(workers_pending_removal) {}
+
+    // Declared first so that the drain managers outlive the filter chains that refer to them.
+    std::list<DrainManagerPtr> filter_chain_drain_managers_;
+    ListenerImplPtr listener_;
+    uint64_t workers_pending_removal_;
+    // Whether all the filter chains of the listener are draining.
+    bool draining_all_{};
+  };
+
   void addListenerToWorker(Worker& worker, ListenerImpl& listener);
   ProtobufTypes::MessagePtr dumpListenerConfigs();
   static ListenerManagerStats generateStats(Stats::Scope& scope);
@@ -156,6 +177,32 @@ private:
    */
   void drainListener(ListenerImplPtr&& listener);
 
+  /**
+   * Replace an active listener with a warmed listener that only differs in its filter chains. The
+   * old listener stops accepting connections, but only the connections of its filter chains that
+   * were changed or removed are drained. The listener is removed once it no longer owns any
+   * connections. Only the MaxRetiringGenerations newest retiring generations of a listener keep
+   * their unchanged filter chains, and all the filter chains of older ones are drained.
+   * @param listener supplies the listener to retire.
+   * @param new_listener supplies the listener that replaces it.
+   */
+  void updateListenerInPlace(ListenerImplPtr&& listener, const ListenerImpl& new_listener);
+
+  /**
+   * Drain the filter chains of a retiring listener that are not part of a new listener.
+   * @param retiring_listener supplies the retiring listener.
+   * @param new_listener supplies the new listener, or nullptr to drain all the filter chains.
+   */
+  void drainFilterChains(RetiringListener& retiring_listener, const ListenerImpl* new_listener);
+
+  /**
+   * Drain the filter chains of all the retiring listeners with the given name that are not part of
+   * a new listener.
+   * @param name supplies the listener name.
+   * @param new_listener supplies the new listener, or nullptr to drain all the filter chains.
+   */
+  void drainRetiringListeners(const std::string& name, const ListenerImpl* new_listener);
+
   /**
    * Get a listener by name. This routine is used because listeners have inherent order in static
    * configuration and especially for tests. Thus, we can't use a map.
@@ -175,6 +222,11 @@ private:
   // connections are drained. Then after that time period the listener is removed from all workers
   // and any remaining connections are closed.
   std::list<DrainingListener> draining_listeners_;
+  // Retiring listeners have been replaced by a listener that only differs in its filter chains.
+  // They no longer accept new connections, but the connections of their unchanged filter chains
+  // are left alone. Only the connections of the changed or removed filter chains are drained and
+  // then closed. The listener is removed from the workers once it owns no more connections.
+  std::list<RetiringListener> retiring_listeners_;
   std::list<WorkerPtr> workers_;
   bool workers_started_{};
   Stats::ScopePtr scope_;
@@ -193,7 +245,6 @@ private:
 class ListenerImpl : public Network::ListenerConfig,
                      public Configuration::ListenerFactoryContext,
                      public Network::DrainDecision,
-                     public Network::FilterChainManager,
                      public Network::FilterChainFactory,
                      Logger::Loggable<Logger::Id::config> {
 public:
@@ -241,8 +292,23 @@ public:
   const Network::Socket::OptionsSharedPtr& listenSocketOptions() { return listen_socket_options_; }
   const std::string& versionInfo() { return version_info_; }
 
+  /**
+   * @return TRUE if the listener can be replaced by a listener with the given config by only
+   *         draining the filter chains that differ, i.e. if the configs only differ in their
+   *         filter chains.
+   */
+  bool supportsInPlaceUpdate(const envoy::api::v2::Listener& config) const;
+
+  /**
+   * @param new_listener supplies the listener that replaces this listener, or nullptr if the
+   *        listener is going away entirely.
+   * @return the filter chains that are not yet draining and that are changed or removed in the new
+   *         listener.
+   */
+  std::vector<FilterChainImpl*> filterChainsToDrain(const ListenerImpl* new_listener) const;
+
   // Network::ListenerConfig
-  Network::FilterChainManager& filterChainManager() override { return *this; }
+  Network::FilterChainManager& filterChainManager() override { return filter_chain_manager_; }
   Network::FilterChainFactory& filterChainFactory() override { return *this; }
   Network::Socket& socket() override { return *socket_; }
   const Network::Socket& socket() const override { return *socket_; }
@@ -306,10 +372,6 @@ public:
   // Network::DrainDecision
   bool drainClose() const override;
 
-  // Network::FilterChainManager
-  const Network::FilterChain*
-  findFilterChain(const Network::ConnectionSocket& socket) const override;
-
   // Network::FilterChainFactory
   bool createNetworkFilterChain(Network::Connection& connection,
                                 const std::vector<Network::FilterFactoryCb>& factories) override;
@@ -318,79 +380,6 @@ public:
   SystemTime last_updated_;
 
 private:
-  typedef std::array<Network::FilterChainSharedPtr, 3> SourceTypesArray;
-  typedef std::unordered_map<std::string, SourceTypesArray> ApplicationProtocolsMap;
-  typedef std::unordered_map<std::string, ApplicationProtocolsMap> TransportProtocolsMap;
-  // Both exact server names and wildcard domains are part of the same map, in which wildcard
-  // domains are prefixed with "." (i.e. ".example.com" for "*.example.com") to differentiate
-  // between exact and wildcard entries.
-  typedef std::unordered_map<std::string, TransportProtocolsMap> ServerNamesMap;
-  typedef std::unordered_map<std::string, ServerNamesMap> DestinationIPsMap;
-  typedef std::shared_ptr<ServerNamesMap> ServerNamesMapSharedPtr;
-  typedef Network::LcTrie::LcTrie<ServerNamesMapSharedPtr> DestinationIPsTrie;
-  typedef std::unique_ptr<DestinationIPsTrie> DestinationIPsTriePtr;
-  typedef std::unordered_map<uint16_t, std::pair<DestinationIPsMap, DestinationIPsTriePtr>>
-      DestinationPortsMap;
-
-  void
-  addFilterChain(uint16_t destination_port, const std::vector<std::string>& destination_ips,
-                 const std::vector<std::string>& server_names,
-                 const std::string& transport_protocol,
-                 const std::vector<std::string>& application_protocols,
-                 const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-                 Network::TransportSocketFactoryPtr&& transport_socket_factory,
-                 std::vector<Network::FilterFactoryCb> filters_factory);
-  void addFilterChainForDestinationPorts(
-      DestinationPortsMap& destination_ports_map, uint16_t destination_port,
-      const std::vector<std::string>& destination_ips, const std::vector<std::string>& server_names,
-      const std::string& transport_protocol, const std::vector<std::string>& application_protocols,
-      const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-      const Network::FilterChainSharedPtr& filter_chain);
-  void addFilterChainForDestinationIPs(
-      DestinationIPsMap& destination_ips_map, const std::vector<std::string>& destination_ips,
-      const std::vector<std::string>& server_names, const std::string& transport_protocol,
-      const std::vector<std::string>& application_protocols,
-      const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-      const Network::FilterChainSharedPtr& filter_chain);
-  void addFilterChainForServerNames(
-      ServerNamesMap& server_names_map, const std::vector<std::string>& server_names,
-      const std::string& transport_protocol, const std::vector<std::string>& application_protocols,
-      const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-      const Network::FilterChainSharedPtr& filter_chain);
-  void addFilterChainForApplicationProtocols(
-      ApplicationProtocolsMap& application_protocol_map,
-      const std::vector<std::string>& application_protocols,
-      const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-      const Network::FilterChainSharedPtr& filter_chain);
-  void addFilterChainForSourceTypes(
-      SourceTypesArray& source_types_array,
-      const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
-      const Network::FilterChainSharedPtr& filter_chain);
-
-  void convertDestinationIPsMapToTrie();
-
-  const Network::FilterChain*
-  findFilterChainForDestinationIP(const DestinationIPsTrie& destination_ips_trie,
-                                  const Network::ConnectionSocket& socket) const;
-  const Network::FilterChain*
-  findFilterChainForServerName(const ServerNamesMap& server_names_map,
-                               const Network::ConnectionSocket& socket) const;
-  const Network::FilterChain*
-  findFilterChainForTransportProtocol(const TransportProtocolsMap& transport_protocols_map,
-                                      const Network::ConnectionSocket& socket) const;
-  const Network::FilterChain*
-  findFilterChainForApplicationProtocols(const ApplicationProtocolsMap& application_protocols_map,
-                                         const Network::ConnectionSocket& socket) const;
-  const Network::FilterChain*
-  findFilterChainForSourceTypes(const SourceTypesArray& source_types,
-                                const Network::ConnectionSocket& socket) const;
-
-  static bool isWildcardServerName(const std::string& name);
-
-  // Mapping of FilterChain's configured destination ports, IPs, server names, transport protocols
-  // and application protocols, using structures defined above.
-  DestinationPortsMap destination_ports_map_;
-
   ListenerManagerImpl& parent_;
   Network::Address::InstanceConstSharedPtr address_;
   Network::Address::SocketType socket_type_;
@@ -420,14 +409,85 @@ private:
   const std::string version_info_;
   Network::Socket::OptionsSharedPtr listen_socket_options_;
   const std::chrono::milliseconds listener_filters_timeout_;
+  // Declared last so that the filter chains are destroyed before the rest of the listener. Built
+  // from scratch for every listener, including on in-place updates.
+  FilterChainManagerImpl filter_chain_manager_;
+};
+
+/**
+ * Factory context used to create the network filters of a single filter chain. Everything is
+ * delegated to the owning listener except for the drain decision, so that the connections of a
+ * filter chain can be drained on their own when a listener update changes or removes it.
+ */
+class FilterChainFactoryContextImpl : public Configuration::FactoryContext,
+                                      public Network::DrainDecision {
+public:
+  explicit FilterChainFactoryContextImpl(ListenerImpl& parent) : parent_(parent) {}
+
+  /**
+   * Start draining the connections of the filter chain.
+   * @param drain_manager supplies the drain manager that controls the drain. It must outlive the
+   *        filter chain.
+   */
+  void startDraining(const DrainManager& drain_manager) { drain_manager_ = &drain_manager; }
+  bool draining() const { return drain_manager_ != nullptr; }
+
+  // Configuration::FactoryContext
+  AccessLog::AccessLogManager& accessLogManager() override { return parent_.accessLogManager(); }
+  Upstream::ClusterManager& clusterManager() override { return parent_.clusterManager(); }
+  Event::Dispatcher& dispatcher() override { return parent_.dispatcher(); }
+  Network::DrainDecision& drainDecision() override { return *this; }
+  bool healthCheckFailed() override { return parent_.healthCheckFailed(); }
+  Tracing::HttpTracer& httpTracer() override { return parent_.httpTracer(); }
+  Http::Context& httpContext() override { return parent_.httpContext(); }
+  Init::Manager& initManager() override { return parent_.initManager(); }
+  const LocalInfo::LocalInfo& localInfo() const override { return parent_.localInfo(); }
+  Envoy::Runtime::RandomGenerator& random() override { return parent_.random(); }
+  Envoy::Runtime::Loader& runtime() override { return parent_.runtime(); }
+  Stats::Scope& scope() override { return parent_.scope(); }
+  Singleton::Manager& singletonManager() override { return parent_.singletonManager(); }
+  OverloadManager& overloadManager() override { return parent_.overloadManager(); }
+  ThreadLocal::Instance& threadLocal() override { return parent_.threadLocal(); }
+  Admin& admin() override { return parent_.admin(); }
+  Stats::Scope& listenerScope() override { return parent_.listenerScope(); }
+  const envoy::api::v2::core::Metadata& listenerMetadata() const override {
+    return parent_.listenerMetadata();
+  }
+  TimeSource& timeSource() override { return parent_.timeSource(); }
+  Api::Api& api() override { return parent_.api(); }
+  ServerLifecycleNotifier& lifecycleNotifier() override { return parent_.lifecycleNotifier(); }
+
+  // Network::DrainDecision
+  bool drainClose() const override {
+    // The filter chain drain is layered on top of the listener and server wide drains.
+    const DrainManager* drain_manager = drain_manager_;
+    return (drain_manager != nullptr && drain_manager->drainClose()) || parent_.drainClose();
+  }
+
+private:
+  ListenerImpl& parent_;
+  // Set on the main thread and read by the filters on the workers.
+  std::atomic<const DrainManager*> drain_manager_{};
 };
 
+typedef std::unique_ptr<FilterChainFactoryContextImpl> FilterChainFactoryContextImplPtr;
+
 class FilterChainImpl : public Network::FilterChain {
 public:
-  FilterChainImpl(Network::TransportSocketFactoryPtr&& transport_socket_factory,
-                  std::vector<Network::FilterFactoryCb> filters_factory)
-      : transport_socket_factory_(std::move(transport_socket_factory)),
-        filters_factory_(std::move(filters_factory)) {}
+  FilterChainImpl(FilterChainFactoryContextImplPtr&& factory_context,
+                  Network::TransportSocketFactoryPtr&& transport_socket_factory,
+                  std::vector<Network::FilterFactoryCb> filters_factory, uint64_t hash)
+      : factory_context_(std::move(factory_context)),
+        transport_socket_factory_(std::move(transport_socket_factory)),
+        filters_factory_(std::move(filters_factory)), hash_(hash) {}
+
+  FilterChainFactoryContextImpl& factoryContext() const { return *factory_context_; }
+
+  /**
+   * @return the hash of the filter chain config, used to find the filter chains that are
+   *         unchanged by a listener update.
+   */
+  uint64_t hash() const { return hash_; }
 
   // Network::FilterChain
   const Network::TransportSocketFactory& transportSocketFactory() const override {
@@ -439,8 +499,11 @@ public:
   }
 
 private:
+  // Declared first so that the factory context outlives the factories created with it.
+  const FilterChainFactoryContextImplPtr factory_context_;
   const Network::TransportSocketFactoryPtr transport_socket_factory_;
   const std::vector<Network::FilterFactoryCb> filters_factory_;
+  const uint64_t hash_;
 };
 
 } // namespace Server
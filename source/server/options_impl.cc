@@ -126,6 +126,11 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
                                             "Use the original libevent buffer implementation",
                                             false, true, "bool", cmd);
 
+  TCLAP::ValueArg<std::string> bootstrap_cache_path(
+      "", "bootstrap-cache-path",
+      "Directory in which to cache the parsed configuration as a binary proto", false, "", "string",
+      cmd);
+
   cmd.setExceptionHandling(false);
   try {
     cmd.parse(argc, argv);
@@ -215,6 +220,7 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
 
   config_path_ = config_path.getValue();
   config_yaml_ = config_yaml.getValue();
+  bootstrap_cache_path_ = bootstrap_cache_path.getValue();
   allow_unknown_fields_ = allow_unknown_fields.getValue();
   if (allow_unknown_fields_) {
     MessageUtil::proto_unknown_fields = ProtoUnknownFieldsMode::Allow;
@@ -317,6 +323,7 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   command_line_options->set_enable_mutex_tracing(mutexTracingEnabled());
   command_line_options->set_cpuset_threads(cpusetThreadsEnabled());
   command_line_options->set_restart_epoch(restartEpoch());
+  command_line_options->set_bootstrap_cache_path(bootstrapCachePath());
   return command_line_options;
 }
 
@@ -75,6 +75,9 @@ public:
     signal_handling_enabled_ = signal_handling_enabled;
   }
   void setCpusetThreads(bool cpuset_threads_enabled) { cpuset_threads_ = cpuset_threads_enabled; }
+  void setBootstrapCachePath(const std::string& bootstrap_cache_path) {
+    bootstrap_cache_path_ = bootstrap_cache_path;
+  }
 
   // Server::Options
   uint64_t baseId() const override { return base_id_; }
@@ -111,6 +114,7 @@ public:
   virtual Server::CommandLineOptionsPtr toCommandLineOptions() const override;
   void parseComponentLogLevels(const std::string& component_log_levels);
   bool cpusetThreadsEnabled() const override { return cpuset_threads_; }
+  const std::string& bootstrapCachePath() const override { return bootstrap_cache_path_; }
   uint32_t count() const;
 
 private:
@@ -143,6 +147,7 @@ private:
   bool mutex_tracing_enabled_;
   bool cpuset_threads_;
   bool libevent_buffer_enabled_;
+  std::string bootstrap_cache_path_;
   uint32_t count_;
 };
 
@@ -39,6 +39,7 @@
 #include "common/stats/thread_local_store.h"
 #include "common/upstream/cluster_manager_impl.h"
 
+#include "server/bootstrap_loader.h"
 #include "server/configuration_impl.h"
 #include "server/connection_handler_impl.h"
 #include "server/guarddog_impl.h"
@@ -70,7 +71,7 @@ InstanceImpl::InstanceImpl(const Options& options, Event::TimeSystem& time_syste
       terminated_(false),
       mutex_tracer_(options.mutexTracingEnabled() ? &Envoy::MutexTracerImpl::getOrCreateTracer()
                                                   : nullptr),
-      main_thread_id_(std::this_thread::get_id()) {
+      http_context_(store.symbolTable()), main_thread_id_(std::this_thread::get_id()) {
   try {
     if (!options.logPath().empty()) {
       try {
@@ -145,9 +146,11 @@ void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks,
 
 void InstanceImpl::flushStats() {
   ENVOY_LOG(debug, "flushing stats");
+  const MonotonicTime flush_start = time_source_.monotonicTime();
   // A shutdown initiated before this callback may prevent this from being called as per
   // the semantics documented in ThreadLocal's runOnAllThreads method.
-  stats_store_.mergeHistograms([this]() -> void {
+  stats_store_.mergeHistograms([this, flush_start]() -> void {
+    const MonotonicTime main_thread_start = time_source_.monotonicTime();
     HotRestart::GetParentStatsInfo info;
     restarter_.getParentStats(info);
     server_stats_->uptime_.set(time(nullptr) - original_start_time_);
@@ -158,14 +161,63 @@ void InstanceImpl::flushStats() {
     server_stats_->total_connections_.set(numConnections() + info.num_connections_);
     server_stats_->days_until_first_cert_expiring_.set(
         sslContextManager().daysUntilFirstCertExpires());
-    InstanceUtil::flushMetricsToSinks(config_.statsSinks(), stats_store_.source());
-    // TODO(ramaraochavali): consider adding different flush interval for histograms.
-    if (stat_flush_timer_ != nullptr) {
-      stat_flush_timer_->enableTimer(config_.statsFlushInterval());
+    flushStatsToSinks(flush_start);
+    // Sinks flushed on the flush thread read a snapshot, which keeps evicted stats alive.
+    const auto& stats_config = bootstrap_.stats_config();
+    if (stats_config.has_evict_idle_stats_after_flushes()) {
+      stats_store_.evictIdleStats(stats_config.evict_idle_stats_after_flushes().value());
     }
+    server_stats_->stats_flush_main_thread_ms_.recordValue(
+        std::chrono::duration_cast<std::chrono::milliseconds>(time_source_.monotonicTime() -
+                                                              main_thread_start)
+            .count());
   });
 }
 
+void InstanceImpl::flushStatsToSinks(MonotonicTime flush_start) {
+  if (stats_flush_thread_ == nullptr) {
+    InstanceUtil::flushMetricsToSinks(config_.statsSinks(), stats_store_.source());
+    onStatsFlushComplete(flush_start);
+    return;
+  }
+
+  // All sinks read one snapshot of the store's values, which latches the counters once. Sinks
+  // that are bound to the main thread are flushed from it here, and the rest on the stats flush
+  // thread, so that only taking the snapshot delays the main thread. The main thread sinks are
+  // thus flushed before the others regardless of their configured order, which does not change
+  // what any sink sees.
+  Stats::SourceSnapshotSharedPtr snapshot =
+      std::make_shared<Stats::SourceSnapshotImpl>(stats_store_);
+  std::vector<Stats::Sink*> thread_sinks;
+  for (const Stats::SinkPtr& sink : config_.statsSinks()) {
+    if (sink->supportsFlushThread()) {
+      thread_sinks.push_back(sink.get());
+    } else {
+      sink->flush(*snapshot);
+    }
+  }
+  if (thread_sinks.empty()) {
+    onStatsFlushComplete(flush_start);
+    return;
+  }
+  stats_flush_thread_->flush(std::move(snapshot), std::move(thread_sinks),
+                             [this, flush_start](std::chrono::milliseconds) -> void {
+                               onStatsFlushComplete(flush_start);
+                             });
+}
+
+void InstanceImpl::onStatsFlushComplete(MonotonicTime flush_start) {
+  server_stats_->stats_flush_ms_.recordValue(
+      std::chrono::duration_cast<std::chrono::milliseconds>(time_source_.monotonicTime() -
+                                                            flush_start)
+          .count());
+  // The next flush is only scheduled once this one is complete, so that flushes never overlap.
+  // TODO(ramaraochavali): consider adding different flush interval for histograms.
+  if (stat_flush_timer_ != nullptr) {
+    stat_flush_timer_->enableTimer(config_.statsFlushInterval());
+  }
+}
+
 void InstanceImpl::getParentStats(HotRestart::GetParentStatsInfo& info) {
   info.memory_allocated_ = Memory::Stats::totalCurrentlyAllocated();
   info.num_connections_ = numConnections();
@@ -186,15 +238,8 @@ InstanceUtil::loadBootstrapConfig(envoy::config::bootstrap::v2::Bootstrap& boots
     throw EnvoyException(message);
   }
 
-  if (!config_path.empty()) {
-    MessageUtil::loadFromFile(config_path, bootstrap, api);
-  }
-  if (!config_yaml.empty()) {
-    envoy::config::bootstrap::v2::Bootstrap bootstrap_override;
-    MessageUtil::loadFromYaml(config_yaml, bootstrap_override);
-    bootstrap.MergeFrom(bootstrap_override);
-  }
-  MessageUtil::validate(bootstrap);
+  BootstrapLoader(api, options.concurrency(), options.bootstrapCachePath())
+      .load(config_path, config_yaml, bootstrap);
   return BootstrapVersion::V2;
 }
 
@@ -241,11 +286,13 @@ void InstanceImpl::initialize(const Options& options,
   // stats.
   stats_store_.setTagProducer(Config::Utility::createTagProducer(bootstrap_));
   stats_store_.setStatsMatcher(Config::Utility::createStatsMatcher(bootstrap_));
+  stats_store_.setHistogramSettings(Config::Utility::createHistogramSettings(bootstrap_));
 
   const std::string server_stats_prefix = "server.";
   server_stats_ = std::make_unique<ServerStats>(
       ServerStats{ALL_SERVER_STATS(POOL_COUNTER_PREFIX(stats_store_, server_stats_prefix),
-                                   POOL_GAUGE_PREFIX(stats_store_, server_stats_prefix))});
+                                   POOL_GAUGE_PREFIX(stats_store_, server_stats_prefix),
+                                   POOL_HISTOGRAM_PREFIX(stats_store_, server_stats_prefix))});
 
   server_stats_->concurrency_.set(options_.concurrency());
   server_stats_->hot_restart_epoch_.set(options_.restartEpoch());
@@ -300,6 +347,13 @@ void InstanceImpl::initialize(const Options& options,
   heap_shrinker_ =
       std::make_unique<Memory::HeapShrinker>(*dispatcher_, *overload_manager_, stats_store_);
 
+  // Like the workers, the stats flush thread must register for thread local updates before any
+  // thread local data is set.
+  if (bootstrap_.enable_stats_flush_thread()) {
+    stats_flush_thread_ = std::make_unique<StatsFlushThread>(thread_local_, *api_, *dispatcher_);
+    stats_flush_thread_->start();
+  }
+
   // Workers get created first so they register for thread local updates.
   listener_manager_ = std::make_unique<ListenerManagerImpl>(
       *this, listener_component_factory_, worker_factory_, bootstrap_.enable_dispatcher_stats());
@@ -513,6 +567,13 @@ void InstanceImpl::terminate() {
     listener_manager_->stopWorkers();
   }
 
+  // Any flush still in progress on the stats flush thread is abandoned, and the final flush below
+  // runs all the sinks on this thread.
+  if (stats_flush_thread_ != nullptr) {
+    stats_flush_thread_->stop();
+    stats_flush_thread_.reset();
+  }
+
   // Only flush if we have not been hot restarted.
   if (stat_flush_timer_) {
     flushStats();
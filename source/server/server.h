@@ -32,6 +32,7 @@
 #include "server/listener_hooks.h"
 #include "server/listener_manager_impl.h"
 #include "server/overload_manager_impl.h"
+#include "server/stats_flush_thread.h"
 #include "server/worker_impl.h"
 
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
@@ -46,7 +47,7 @@ namespace Server {
  * All server wide stats. @see stats_macros.h
  */
 // clang-format off
-#define ALL_SERVER_STATS(COUNTER, GAUGE)                                                           \
+#define ALL_SERVER_STATS(COUNTER, GAUGE, HISTOGRAM)                                                \
   GAUGE(uptime)                                                                                    \
   GAUGE(concurrency)                                                                               \
   GAUGE(memory_allocated)                                                                          \
@@ -57,11 +58,13 @@ namespace Server {
   GAUGE(version)                                                                                   \
   GAUGE(days_until_first_cert_expiring)                                                            \
   GAUGE(hot_restart_epoch)                                                                         \
-  COUNTER(debug_assertion_failures)
+  COUNTER(debug_assertion_failures)                                                                \
+  HISTOGRAM(stats_flush_ms)                                                                        \
+  HISTOGRAM(stats_flush_main_thread_ms)
 // clang-format on
 
 struct ServerStats {
-  ALL_SERVER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_SERVER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
@@ -201,6 +204,8 @@ public:
 private:
   ProtobufTypes::MessagePtr dumpBootstrapConfig();
   void flushStats();
+  void flushStatsToSinks(MonotonicTime flush_start);
+  void onStatsFlushComplete(MonotonicTime flush_start);
   void initialize(const Options& options, Network::Address::InstanceConstSharedPtr local_address,
                   ComponentFactory& component_factory, ListenerHooks& hooks);
   void loadServerFlags(const absl::optional<std::string>& flags_path);
@@ -244,6 +249,7 @@ private:
   Configuration::MainImpl config_;
   Network::DnsResolverSharedPtr dns_resolver_;
   Event::TimerPtr stat_flush_timer_;
+  std::unique_ptr<StatsFlushThread> stats_flush_thread_;
   LocalInfo::LocalInfoPtr local_info_;
   DrainManagerPtr drain_manager_;
   AccessLog::AccessLogManagerImpl access_log_manager_;
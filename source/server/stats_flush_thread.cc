@@ -0,0 +1,55 @@
+#include "server/stats_flush_thread.h"
+
+#include <chrono>
+
+namespace Envoy {
+namespace Server {
+
+StatsFlushThread::StatsFlushThread(ThreadLocal::Instance& tls, Api::Api& api,
+                                   Event::Dispatcher& main_dispatcher)
+    : tls_(tls), api_(api), main_dispatcher_(main_dispatcher),
+      dispatcher_(api.allocateDispatcher()) {
+  tls_.registerThread(*dispatcher_, false);
+}
+
+void StatsFlushThread::start() {
+  ASSERT(!thread_);
+  thread_ = api_.threadFactory().createThread([this]() -> void { threadRoutine(); });
+}
+
+void StatsFlushThread::stop() {
+  if (thread_) {
+    dispatcher_->exit();
+    thread_->join();
+    thread_.reset();
+  }
+}
+
+void StatsFlushThread::flush(Stats::SourceSnapshotSharedPtr snapshot,
+                             std::vector<Stats::Sink*> sinks,
+                             std::function<void(std::chrono::milliseconds)> completion) {
+  dispatcher_->post([this, snapshot, sinks, completion]() mutable -> void {
+    const MonotonicTime start = api_.timeSource().monotonicTime();
+    for (Stats::Sink* sink : sinks) {
+      ASSERT(sink->supportsFlushThread());
+      sink->flush(*snapshot);
+    }
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        api_.timeSource().monotonicTime() - start);
+    // The snapshot may hold the last references to stats whose scopes have since been deleted, so
+    // it is released on the main thread along with the completion.
+    main_dispatcher_.post([snapshot = std::move(snapshot), completion, duration]() -> void {
+      completion(duration);
+    });
+  });
+}
+
+void StatsFlushThread::threadRoutine() {
+  ENVOY_LOG(debug, "stats flush thread entering dispatch loop");
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  ENVOY_LOG(debug, "stats flush thread exited dispatch loop");
+  tls_.shutdownThread();
+}
+
+} // namespace Server
+} // namespace Envoy
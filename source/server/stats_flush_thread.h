@@ -0,0 +1,60 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/stats/sink.h"
+#include "envoy/thread/thread.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/logger.h"
+#include "common/stats/source_impl.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * A thread with its own event loop on which stats are flushed to the sinks that support it, so that
+ * serializing a large number of stats does not hold up xDS, health checking and other work on the
+ * main thread. Like a worker, it is registered for thread local updates, so sinks can keep
+ * per-thread state such as sockets for it.
+ */
+class StatsFlushThread : Logger::Loggable<Logger::Id::main> {
+public:
+  StatsFlushThread(ThreadLocal::Instance& tls, Api::Api& api, Event::Dispatcher& main_dispatcher);
+
+  /**
+   * Start the thread's event loop. Flushes requested before this are run once it starts.
+   */
+  void start();
+
+  /**
+   * Stop the event loop and wait for the thread to exit. Flushes that have not started yet are
+   * dropped. This must be called after thread local storage has been shut down globally.
+   */
+  void stop();
+
+  /**
+   * Flush a snapshot to sinks on the flush thread.
+   * @param snapshot the metrics to flush. The last reference to it is released on the main thread.
+   * @param sinks the sinks to flush, which must all support the flush thread and outlive it.
+   * @param completion called on the main thread once every sink has been flushed, with the time
+   *        spent flushing them.
+   */
+  void flush(Stats::SourceSnapshotSharedPtr snapshot, std::vector<Stats::Sink*> sinks,
+             std::function<void(std::chrono::milliseconds)> completion);
+
+private:
+  void threadRoutine();
+
+  ThreadLocal::Instance& tls_;
+  Api::Api& api_;
+  Event::Dispatcher& main_dispatcher_;
+  Event::DispatcherPtr dispatcher_;
+  Thread::ThreadPtr thread_;
+};
+
+} // namespace Server
+} // namespace Envoy
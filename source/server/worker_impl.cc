@@ -67,6 +67,27 @@ void WorkerImpl::removeListener(Network::ListenerConfig& listener,
   });
 }
 
+void WorkerImpl::removeListenerWhenIdle(Network::ListenerConfig& listener,
+                                        std::function<void()> completion) {
+  ASSERT(thread_);
+  const uint64_t listener_tag = listener.listenerTag();
+  dispatcher_->post([this, listener_tag, completion]() -> void {
+    handler_->removeListenersWhenIdle(listener_tag, [this, completion]() -> void {
+      completion();
+      hooks_.onWorkerListenerRemoved();
+    });
+  });
+}
+
+void WorkerImpl::removeFilterChains(Network::ListenerConfig& listener,
+                                    const std::list<const Network::FilterChain*>& filter_chains) {
+  ASSERT(thread_);
+  const uint64_t listener_tag = listener.listenerTag();
+  dispatcher_->post([this, listener_tag, filter_chains]() -> void {
+    handler_->removeFilterChains(listener_tag, filter_chains);
+  });
+}
+
 void WorkerImpl::start(GuardDog& guard_dog) {
   ASSERT(!thread_);
   thread_ =
@@ -44,6 +44,10 @@ public:
   void addListener(Network::ListenerConfig& listener, AddListenerCompletion completion) override;
   uint64_t numConnections() override;
   void removeListener(Network::ListenerConfig& listener, std::function<void()> completion) override;
+  void removeListenerWhenIdle(Network::ListenerConfig& listener,
+                              std::function<void()> completion) override;
+  void removeFilterChains(Network::ListenerConfig& listener,
+                          const std::list<const Network::FilterChain*>& filter_chains) override;
   void start(GuardDog& guard_dog) override;
   void initializeStats(Stats::Scope& scope, const std::string& prefix) override;
   void stop() override;
@@ -0,0 +1,60 @@
+#include <string>
+
+#include "common/common/ascii_utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+
+// Covers the vector loops and the scalar tail for every length up to a few vectors. Inputs are
+// windows of all byte values starting at 'A' and wrapping around, and each input starts at one of
+// the uppercase letters, so every non-empty input has at least one byte to convert.
+TEST(AsciiUtilityTest, ToLowerCase) {
+  std::string all_bytes;
+  for (int i = 0; i < 2 * 256; i++) {
+    all_bytes.push_back(static_cast<char>('A' + i));
+  }
+  for (size_t size = 0; size <= 256; size++) {
+    for (size_t offset = 0; offset < 26; offset++) {
+      std::string input = all_bytes.substr(offset, size);
+      std::string expected = input;
+      for (char& c : expected) {
+        if (c >= 'A' && c <= 'Z') {
+          c += 'a' - 'A';
+        }
+      }
+      if (size > 0) {
+        EXPECT_NE(expected, input) << "size " << size << " offset " << offset;
+      }
+      AsciiUtility::toLowerCase(&input[0], input.size());
+      EXPECT_EQ(expected, input) << "size " << size << " offset " << offset;
+    }
+  }
+
+  std::string input("X-Forwarded-For: \x90HELLO\x90 ACCESS-CONTROL-ALLOW-CREDENTIALS");
+  AsciiUtility::toLowerCase(&input[0], input.size());
+  EXPECT_EQ("x-forwarded-for: \x90hello\x90 access-control-allow-credentials", input);
+}
+
+TEST(AsciiUtilityTest, FindFirstOf) {
+  EXPECT_EQ(absl::string_view::npos, AsciiUtility::findFirstOf("", '\0', '\r', '\n'));
+  EXPECT_EQ(absl::string_view::npos,
+            AsciiUtility::findFirstOf(std::string(100, 'a'), '\0', '\r', '\n'));
+
+  for (size_t size = 1; size <= 100; size++) {
+    for (size_t pos = 0; pos < size; pos++) {
+      std::string input(size, 'a');
+      input[pos] = '\r';
+      if (pos + 1 < size) {
+        input[pos + 1] = '\n';
+      }
+      EXPECT_EQ(pos, AsciiUtility::findFirstOf(input, '\0', '\r', '\n')) << size << " " << pos;
+      input[pos] = '\0';
+      EXPECT_EQ(pos, AsciiUtility::findFirstOf(input, '\0', '\r', '\n')) << size << " " << pos;
+    }
+  }
+
+  EXPECT_EQ(3, AsciiUtility::findFirstOf("abcdef", 'f', 'd', 'e'));
+}
+
+} // namespace Envoy
@@ -0,0 +1,83 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+#include "common/common/regex.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+
+typedef std::vector<std::pair<std::string, std::vector<std::string>>> RegexesAndPaths;
+
+// Regexes in the style of route and virtual cluster matches, with a matching and a non-matching
+// path for each.
+static const RegexesAndPaths& routes() {
+  CONSTRUCT_ON_FIRST_USE(
+      RegexesAndPaths,
+      {{"/api/v[0-9]+/users/[0-9]+", {"/api/v1/users/1234", "/api/v1/users"}},
+       {"/static/.*\\.(css|js|png)", {"/static/css/site.css", "/static/a.svg"}},
+       {"/[a-z]{2}-[a-z]{2}/products/[a-z0-9-]+/reviews",
+        {"/en-us/products/widget-3000/reviews", "/en-us/products/widget-3000"}},
+       {"/v1/projects/[^/]+/locations/[^/]+/jobs(/[^/]+)?",
+        {"/v1/projects/p-1/locations/us-east1/jobs/job-123",
+         "/v1/projects/p-1/locations/us-east1/queues/q"}}});
+}
+
+static Regex::CompiledMatcherPtr compileRe2(const std::string& regex) {
+  envoy::type::matcher::RegexMatcher matcher;
+  matcher.mutable_google_re2()->mutable_max_program_size()->set_value(1000);
+  matcher.set_regex(regex);
+  return Regex::Utility::parseRegex(matcher);
+}
+
+// Arguments: 0 for std::regex, 1 for RE2.
+static void BM_RouteRegexMatch(benchmark::State& state) {
+  std::vector<Regex::CompiledMatcherPtr> matchers;
+  for (const auto& route : routes()) {
+    matchers.push_back(state.range(0) == 0
+                           ? Regex::Utility::parseStdRegexAsCompiledMatcher(route.first)
+                           : compileRe2(route.first));
+  }
+
+  size_t matches = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < matchers.size(); i++) {
+      for (const std::string& path : routes()[i].second) {
+        matches += matchers[i]->match(path);
+      }
+    }
+  }
+  RELEASE_ASSERT(matches == state.iterations() * matchers.size(), "");
+}
+BENCHMARK(BM_RouteRegexMatch)->Arg(0)->Arg(1);
+
+// A regex which backtracks exponentially in std::regex on a non-matching value. Arguments: the
+// engine as above, and the length of the value.
+static void BM_PathologicalRegexMatch(benchmark::State& state) {
+  const std::string regex = "(a+)+b";
+  const Regex::CompiledMatcherPtr matcher =
+      state.range(0) == 0 ? Regex::Utility::parseStdRegexAsCompiledMatcher(regex)
+                          : compileRe2(regex);
+  const std::string value(state.range(1), 'a');
+
+  for (auto _ : state) {
+    RELEASE_ASSERT(!matcher->match(value), "");
+  }
+}
+BENCHMARK(BM_PathologicalRegexMatch)->Args({0, 8})->Args({0, 16})->Args({1, 8})->Args({1, 16});
+
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
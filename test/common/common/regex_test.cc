@@ -0,0 +1,65 @@
+#include "envoy/common/exception.h"
+
+#include "common/common/regex.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Regex {
+namespace {
+
+envoy::type::matcher::RegexMatcher googleRe2(const std::string& regex) {
+  envoy::type::matcher::RegexMatcher matcher;
+  matcher.mutable_google_re2();
+  matcher.set_regex(regex);
+  return matcher;
+}
+
+TEST(Utility, ParseStdRegex) {
+  const CompiledMatcherPtr matcher = Utility::parseStdRegexAsCompiledMatcher("/b[io]t");
+  EXPECT_TRUE(matcher->match("/bit"));
+  EXPECT_TRUE(matcher->match("/bot"));
+  EXPECT_FALSE(matcher->match("/bite"));
+  EXPECT_FALSE(matcher->match("/bit/bot"));
+
+  const CompiledMatcherPtr icase =
+      Utility::parseStdRegexAsCompiledMatcher("/b[io]t", std::regex::icase);
+  EXPECT_TRUE(icase->match("/BIT"));
+
+  EXPECT_THROW_WITH_REGEX(Utility::parseStdRegexAsCompiledMatcher("(+invalid)"), EnvoyException,
+                          "Invalid regex '\\(\\+invalid\\)': .+");
+}
+
+TEST(Utility, ParseGoogleRe2) {
+  const CompiledMatcherPtr matcher = Utility::parseRegex(googleRe2("/b[io]t"));
+  EXPECT_TRUE(matcher->match("/bit"));
+  EXPECT_TRUE(matcher->match("/bot"));
+  EXPECT_FALSE(matcher->match("/bite"));
+  EXPECT_FALSE(matcher->match("/bit/bot"));
+
+  // Values are not required to be null terminated.
+  const std::string value = "/bot/bit";
+  EXPECT_TRUE(matcher->match(absl::string_view(value.data(), 4)));
+
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex(googleRe2("(+invalid)")), EnvoyException,
+                          "Invalid regex '\\(\\+invalid\\)': .+");
+  // Backreferences can't be evaluated in linear time and are rejected.
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex(googleRe2("(a)\\1")), EnvoyException,
+                          "Invalid regex");
+}
+
+TEST(Utility, GoogleRe2ProgramSize) {
+  const std::string regex = "/api/v[0-9]+/(users|groups|projects)/[a-z0-9-]{1,64}/.*";
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex(googleRe2(regex)), EnvoyException,
+                          "RE2 program size of [0-9]+ > max program size of 100");
+
+  envoy::type::matcher::RegexMatcher matcher = googleRe2(regex);
+  matcher.mutable_google_re2()->mutable_max_program_size()->set_value(1000);
+  EXPECT_TRUE(Utility::parseRegex(matcher)->match("/api/v2/users/john-doe/settings"));
+}
+
+} // namespace
+} // namespace Regex
+} // namespace Envoy
@@ -204,6 +204,55 @@ TEST_F(ZlibCompressorImplTest, CompressWithNotCommonParams) {
   expectValidFinishedBuffer(accumulation_buffer, input_size);
 }
 
+// Compressors using a pooled deflate state produce the same output as one with a fresh state, and
+// hand their state back to the pool when they are destroyed, even in the middle of a stream.
+TEST_F(ZlibCompressorImplTest, PooledDeflateState) {
+  auto pool = std::make_shared<ZlibDeflateStatePool>(1);
+  Buffer::OwnedImpl input;
+  TestUtility::feedBufferWithRandomCharacters(input, default_input_size);
+
+  const auto compress = [&](const ZlibDeflateStatePoolSharedPtr& pool) {
+    ZlibCompressorImplTester compressor;
+    if (pool != nullptr) {
+      compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                      ZlibCompressorImpl::CompressionStrategy::Standard, gzip_window_bits,
+                      memory_level, pool);
+    } else {
+      compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                      ZlibCompressorImpl::CompressionStrategy::Standard, gzip_window_bits,
+                      memory_level);
+    }
+    Buffer::OwnedImpl buffer;
+    buffer.add(input);
+    compressor.finish(buffer);
+    return buffer.toString();
+  };
+
+  const std::string expected = compress(nullptr);
+  EXPECT_EQ(expected, compress(pool));
+  EXPECT_EQ(1U, pool->idleStates());
+  EXPECT_EQ(expected, compress(pool));
+  EXPECT_EQ(1U, pool->idleStates());
+
+  {
+    ZlibCompressorImplTester first;
+    ZlibCompressorImplTester second;
+    first.init(ZlibCompressorImpl::CompressionLevel::Standard,
+               ZlibCompressorImpl::CompressionStrategy::Standard, gzip_window_bits, memory_level,
+               pool);
+    second.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                ZlibCompressorImpl::CompressionStrategy::Standard, gzip_window_bits, memory_level,
+                pool);
+    EXPECT_EQ(0U, pool->idleStates());
+    Buffer::OwnedImpl buffer;
+    buffer.add(input);
+    first.compressThenFlush(buffer);
+  }
+  // The pool keeps at most one idle state per set of parameters.
+  EXPECT_EQ(1U, pool->idleStates());
+  EXPECT_EQ(expected, compress(pool));
+}
+
 } // namespace
 } // namespace Compressor
 } // namespace Envoy
\ No newline at end of file
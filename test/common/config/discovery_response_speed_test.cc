@@ -0,0 +1,120 @@
+// Benchmarks for parsing and freeing a large DiscoveryResponse, on the heap and on an arena as
+// the Envoy gRPC client does for xDS streams that set use_response_arena.
+//
+// Note: this should be run with --compilation_mode=opt.
+
+#include <string>
+
+#include "envoy/api/v2/cds.pb.h"
+#include "envoy/api/v2/discovery.pb.h"
+
+#include "common/common/fmt.h"
+#include "common/config/resources.h"
+#include "common/grpc/common.h"
+#include "common/protobuf/protobuf.h"
+
+#include "benchmark/benchmark.h"
+
+#ifdef TCMALLOC
+#include "gperftools/malloc_hook.h"
+#endif
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+// Counts the heap allocations made while it is alive. Counting relies on tcmalloc's hooks, so
+// without tcmalloc no allocations are reported.
+class AllocationCounter {
+public:
+  AllocationCounter() {
+    count_ = 0;
+#ifdef TCMALLOC
+    MallocHook::AddNewHook(&onNew);
+#endif
+  }
+
+  ~AllocationCounter() {
+#ifdef TCMALLOC
+    MallocHook::RemoveNewHook(&onNew);
+#endif
+  }
+
+  uint64_t count() const { return count_; }
+
+private:
+  static void onNew(const void*, size_t) { ++count_; }
+
+  static uint64_t count_;
+};
+
+uint64_t AllocationCounter::count_;
+
+std::string makeResponse(uint32_t num_clusters) {
+  envoy::api::v2::DiscoveryResponse response;
+  response.set_version_info("1");
+  response.set_type_url(TypeUrl::get().Cluster);
+  response.set_nonce("nonce");
+  for (uint32_t i = 0; i < num_clusters; ++i) {
+    envoy::api::v2::Cluster cluster;
+    cluster.set_name(fmt::format("cluster_{}", i));
+    cluster.set_type(envoy::api::v2::Cluster::EDS);
+    cluster.mutable_eds_cluster_config()->mutable_eds_config()->mutable_ads();
+    cluster.mutable_connect_timeout()->set_seconds(1);
+    cluster.set_lb_policy(envoy::api::v2::Cluster::LEAST_REQUEST);
+    cluster.mutable_http2_protocol_options();
+    response.add_resources()->PackFrom(cluster);
+  }
+  return response.SerializeAsString();
+}
+
+// Reads what GrpcMuxImpl reads of a response, so that the parse is not optimized away.
+size_t consume(const envoy::api::v2::DiscoveryResponse& response) {
+  size_t total = response.version_info().size() + response.nonce().size();
+  for (const auto& resource : response.resources()) {
+    total += resource.type_url().size() + resource.value().size();
+  }
+  return total;
+}
+
+static void HeapParse(benchmark::State& state) {
+  const std::string encoded = makeResponse(state.range(0));
+  AllocationCounter counter;
+  for (auto _ : state) {
+    envoy::api::v2::DiscoveryResponse response;
+    response.ParseFromString(encoded);
+    benchmark::DoNotOptimize(consume(response));
+  }
+  state.counters["allocations_per_parse"] =
+      static_cast<double>(counter.count()) / state.iterations();
+  state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+BENCHMARK(HeapParse)->Arg(10)->Arg(1000)->Arg(10000);
+
+static void ArenaParse(benchmark::State& state) {
+  const std::string encoded = makeResponse(state.range(0));
+  AllocationCounter counter;
+  for (auto _ : state) {
+    Protobuf::Arena arena(Grpc::Common::arenaOptions(encoded.size()));
+    auto* response = Protobuf::Arena::CreateMessage<envoy::api::v2::DiscoveryResponse>(&arena);
+    response->ParseFromString(encoded);
+    benchmark::DoNotOptimize(consume(*response));
+  }
+  state.counters["allocations_per_parse"] =
+      static_cast<double>(counter.count()) / state.iterations();
+  state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+BENCHMARK(ArenaParse)->Arg(10)->Arg(1000)->Arg(10000);
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
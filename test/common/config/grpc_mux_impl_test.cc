@@ -47,7 +47,7 @@ public:
         local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
         *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
             "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
-        random_, stats_, rate_limit_settings_);
+        random_, stats_, rate_limit_settings_, use_response_arena_);
   }
 
   void setup(const RateLimitSettings& custom_rate_limit_settings) {
@@ -55,7 +55,7 @@ public:
         local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
         *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
             "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
-        random_, stats_, custom_rate_limit_settings);
+        random_, stats_, custom_rate_limit_settings, use_response_arena_);
   }
 
   void expectSendMessage(const std::string& type_url,
@@ -90,6 +90,7 @@ public:
   NiceMock<LocalInfo::MockLocalInfo> local_info_;
   Stats::IsolatedStoreImpl stats_;
   Envoy::Config::RateLimitSettings rate_limit_settings_;
+  bool use_response_arena_{};
 };
 
 class GrpcMuxImplTest : public GrpcMuxImplTestBase {
@@ -247,6 +248,42 @@ TEST_F(GrpcMuxImplTest, WildcardWatch) {
   }
 }
 
+// Validate that responses parsed into an arena are handled like heap allocated ones.
+TEST_F(GrpcMuxImplTest, ArenaResponse) {
+  use_response_arena_ = true;
+  setup();
+  InSequence s;
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  auto sub = grpc_mux_->subscribe(type_url, {"x"}, callbacks_);
+  EXPECT_CALL(*async_client_, start(_, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x"}, "");
+  grpc_mux_->start();
+  EXPECT_TRUE(grpc_mux_->grpcStreamForTest().useResponseArena());
+
+  Protobuf::Arena arena;
+  auto* response = Protobuf::Arena::CreateMessage<envoy::api::v2::DiscoveryResponse>(&arena);
+  response->set_type_url(type_url);
+  response->set_version_info("1");
+  response->set_nonce("foo");
+  envoy::api::v2::ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("x");
+  response->add_resources()->PackFrom(load_assignment);
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1"))
+      .WillOnce(
+          Invoke([&load_assignment](const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources,
+                                    const std::string&) {
+            EXPECT_EQ(1, resources.size());
+            envoy::api::v2::ClusterLoadAssignment expected_assignment;
+            resources[0].UnpackTo(&expected_assignment);
+            EXPECT_TRUE(TestUtility::protoEqual(expected_assignment, load_assignment));
+          }));
+  expectSendMessage(type_url, {"x"}, "1", "foo");
+  grpc_mux_->grpcStreamForTest().onReceiveArenaMessage(*response);
+  EXPECT_EQ(&arena, response->GetArena());
+
+  expectSendMessage(type_url, {}, "1", "foo");
+}
+
 // Validate behavior when watches specify resources (potentially overlapping).
 TEST_F(GrpcMuxImplTest, WatchDemux) {
   setup();
@@ -614,7 +651,7 @@ TEST_F(GrpcMuxImplTest, BadLocalInfoEmptyClusterName) {
           local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
           *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
               "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
-          random_, stats_, rate_limit_settings_),
+          random_, stats_, rate_limit_settings_, use_response_arena_),
       EnvoyException,
       "ads: node 'id' and 'cluster' are required. Set it either in 'node' config or via "
       "--service-node and --service-cluster options.");
@@ -627,7 +664,7 @@ TEST_F(GrpcMuxImplTest, BadLocalInfoEmptyNodeName) {
           local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
           *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
               "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
-          random_, stats_, rate_limit_settings_),
+          random_, stats_, rate_limit_settings_, use_response_arena_),
       EnvoyException,
       "ads: node 'id' and 'cluster' are required. Set it either in 'node' config or via "
       "--service-node and --service-cluster options.");
@@ -45,7 +45,7 @@ public:
     subscription_ = std::make_unique<GrpcSubscriptionImpl>(
         local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_, random_,
         *method_descriptor_, Config::TypeUrl::get().ClusterLoadAssignment, stats_, stats_store_,
-        rate_limit_settings_, init_fetch_timeout);
+        rate_limit_settings_, false, init_fetch_timeout);
   }
 
   ~GrpcSubscriptionTestHarness() override { EXPECT_CALL(async_stream_, sendMessage(_, false)); }
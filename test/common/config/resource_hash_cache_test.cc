@@ -0,0 +1,65 @@
+#include "envoy/api/v2/cds.pb.h"
+
+#include "common/config/resource_hash_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+ProtobufWkt::Any clusterResource(const std::string& name, uint32_t connect_timeout_seconds) {
+  envoy::api::v2::Cluster cluster;
+  cluster.set_name(name);
+  cluster.mutable_connect_timeout()->set_seconds(connect_timeout_seconds);
+  ProtobufWkt::Any resource;
+  resource.PackFrom(cluster);
+  return resource;
+}
+
+TEST(ResourceHashCacheTest, Hash) {
+  EXPECT_EQ(ResourceHashCache::hash(clusterResource("foo", 1)),
+            ResourceHashCache::hash(clusterResource("foo", 1)));
+  EXPECT_NE(ResourceHashCache::hash(clusterResource("foo", 1)),
+            ResourceHashCache::hash(clusterResource("foo", 2)));
+  EXPECT_NE(ResourceHashCache::hash(clusterResource("foo", 1)),
+            ResourceHashCache::hash(clusterResource("bar", 1)));
+}
+
+TEST(ResourceHashCacheTest, InsertAndErase) {
+  const uint64_t foo1 = ResourceHashCache::hash(clusterResource("foo", 1));
+  const uint64_t foo2 = ResourceHashCache::hash(clusterResource("foo", 2));
+  const uint64_t bar1 = ResourceHashCache::hash(clusterResource("bar", 1));
+
+  ResourceHashCache cache;
+  EXPECT_EQ(nullptr, cache.find(foo1));
+  EXPECT_FALSE(cache.contains("foo", foo1));
+
+  cache.insert("foo", foo1);
+  cache.insert("bar", bar1);
+  EXPECT_EQ(2, cache.size());
+  ASSERT_NE(nullptr, cache.find(foo1));
+  EXPECT_EQ("foo", *cache.find(foo1));
+  EXPECT_TRUE(cache.contains("foo", foo1));
+  EXPECT_FALSE(cache.contains("foo", foo2));
+  EXPECT_FALSE(cache.contains("bar", foo1));
+
+  // A new version of foo replaces the old one.
+  cache.insert("foo", foo2);
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(nullptr, cache.find(foo1));
+  EXPECT_EQ("foo", *cache.find(foo2));
+  EXPECT_FALSE(cache.contains("foo", foo1));
+  EXPECT_TRUE(cache.contains("foo", foo2));
+
+  cache.erase("foo");
+  cache.erase("baz");
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(nullptr, cache.find(foo2));
+  EXPECT_FALSE(cache.contains("foo", foo2));
+  EXPECT_EQ("bar", *cache.find(bar1));
+}
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
@@ -129,6 +129,20 @@ TEST(UtilityTest, createTagProducer) {
   ASSERT_EQ(tags.size(), 1);
 }
 
+TEST(UtilityTest, createHistogramSettings) {
+  envoy::config::bootstrap::v2::Bootstrap bootstrap;
+  Stats::HistogramSettings settings = Utility::createHistogramSettings(bootstrap);
+  EXPECT_EQ(Stats::HistogramSettings::Backend::Circllhist, settings.backend_);
+  EXPECT_EQ(Stats::HistogramSettings::DefaultPrecisionBits, settings.precision_bits_);
+
+  auto* histogram_settings = bootstrap.mutable_stats_config()->mutable_histogram_settings();
+  histogram_settings->set_backend(envoy::config::metrics::v2::HistogramSettings::LOG_LINEAR);
+  histogram_settings->mutable_precision_bits()->set_value(7);
+  settings = Utility::createHistogramSettings(bootstrap);
+  EXPECT_EQ(Stats::HistogramSettings::Backend::LogLinear, settings.backend_);
+  EXPECT_EQ(7, settings.precision_bits_);
+}
+
 TEST(UtilityTest, ObjNameLength) {
   Stats::StatsOptionsImpl stats_options;
   std::string name = "listenerwithareallyreallyreallyreallyreallyreallyreallyreallyreallyreallyreal"
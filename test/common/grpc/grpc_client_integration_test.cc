@@ -27,6 +27,20 @@ TEST_P(GrpcClientIntegrationTest, BasicStream) {
   dispatcher_helper_.runDispatcher();
 }
 
+// Validate that a stream can have its replies parsed into an arena.
+TEST_P(GrpcClientIntegrationTest, StreamResponseArena) {
+  initialize();
+  auto stream = createStream(empty_metadata_);
+  stream->use_response_arena_ = true;
+  stream->sendRequest();
+  stream->sendServerInitialMetadata(empty_metadata_);
+  stream->sendReply();
+  stream->sendServerTrailers(Status::GrpcStatus::Ok, "", empty_metadata_);
+  dispatcher_helper_.runDispatcher();
+  // The Google gRPC client does not support arenas and delivers replies as usual.
+  EXPECT_EQ(clientType() == ClientType::EnvoyGrpc ? 1U : 0U, stream->arena_messages_);
+}
+
 // Validate that a client destruction with open streams cleans up appropriately.
 TEST_P(GrpcClientIntegrationTest, ClientDestruct) {
   initialize();
@@ -93,6 +93,13 @@ class HelloworldStream : public MockAsyncStreamCallbacks<helloworld::HelloReply>
 public:
   HelloworldStream(DispatcherHelper& dispatcher_helper) : dispatcher_helper_(dispatcher_helper) {}
 
+  bool useResponseArena() override { return use_response_arena_; }
+
+  void onReceiveArenaMessage(helloworld::HelloReply& message) override {
+    ++arena_messages_;
+    onReceiveMessage_(message);
+  }
+
   void sendRequest(bool end_stream = false) {
     helloworld::HelloRequest request_msg;
     request_msg.set_name(HELLO_REQUEST);
@@ -191,6 +198,8 @@ public:
   FakeStream* fake_stream_{};
   AsyncStream* grpc_stream_{};
   const TestMetadata empty_metadata_;
+  bool use_response_arena_{};
+  uint32_t arena_messages_{};
 };
 
 // Request related test utilities.
@@ -442,7 +451,7 @@ public:
   NiceMock<Runtime::MockRandomGenerator> random_;
   Http::AsyncClientPtr http_async_client_;
   Http::ConnectionPool::InstancePtr http_conn_pool_;
-  Http::ContextImpl http_context_;
+  Http::ContextImpl http_context_{stats_store_->symbolTable()};
   envoy::api::v2::core::Locality host_locality_;
   Upstream::MockHost* mock_host_ = new NiceMock<Upstream::MockHost>();
   Upstream::MockHostDescription* mock_host_description_ =
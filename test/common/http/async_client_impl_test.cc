@@ -73,7 +73,7 @@ public:
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
   NiceMock<LocalInfo::MockLocalInfo> local_info_;
-  Http::ContextImpl http_context_;
+  Http::ContextImpl http_context_{stats_store_.symbolTable()};
   AsyncClientImpl client_;
 };
 
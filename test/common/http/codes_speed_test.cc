@@ -20,7 +20,8 @@ namespace Http {
 
 class CodeUtilitySpeedTest {
 public:
-  CodeUtilitySpeedTest() : global_store_(symbol_table_), cluster_scope_(symbol_table_) {}
+  CodeUtilitySpeedTest()
+      : global_store_(symbol_table_), cluster_scope_(symbol_table_), code_stats_(symbol_table_) {}
 
   void addResponse(uint64_t code, bool canary, bool internal_request,
                    const std::string& request_vhost_name = EMPTY_STRING,
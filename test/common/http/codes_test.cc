@@ -38,7 +38,7 @@ public:
 
   Stats::IsolatedStoreImpl global_store_;
   Stats::IsolatedStoreImpl cluster_scope_;
-  Http::CodeStatsImpl code_stats_;
+  Http::CodeStatsImpl code_stats_{global_store_.symbolTable()};
 };
 
 TEST_F(CodeUtilityTest, GroupStrings) {
@@ -231,7 +231,7 @@ TEST(CodeUtilityResponseTimingTest, All) {
   EXPECT_CALL(cluster_scope,
               deliverHistogramToSinks(
                   Property(&Stats::Metric::name, "prefix.zone.from_az.to_az.upstream_rq_time"), 5));
-  Http::CodeStatsImpl code_stats;
+  Http::CodeStatsImpl code_stats(global_store.symbolTable());
   code_stats.chargeResponseTiming(info);
 }
 
@@ -241,9 +241,8 @@ protected:
     return CodeStatsImpl::stripTrailingDot(prefix);
   }
 
-  std::string join(const std::vector<absl::string_view>& v) { return CodeStatsImpl::join(v); }
-
-  CodeStatsImpl code_stats_;
+  Stats::IsolatedStoreImpl store_;
+  CodeStatsImpl code_stats_{store_.symbolTable()};
 };
 
 TEST_F(CodeStatsTest, StripTrailingDot) {
@@ -253,12 +252,31 @@ TEST_F(CodeStatsTest, StripTrailingDot) {
   EXPECT_EQ("foo.", stripTrailingDot("foo..")); // only one dot gets stripped.
 }
 
-TEST_F(CodeStatsTest, Join) {
-  EXPECT_EQ("hello.world", join({"hello", "world"}));
-  EXPECT_EQ("hello.world", join({"", "hello", "world"})); // leading empty token ignored.
-  EXPECT_EQ("hello.", join({"hello", ""}));               // trailing empty token not ignored.
-  EXPECT_EQ("hello", join({"hello"}));
-  EXPECT_EQ("", join({""}));
+TEST_F(CodeStatsTest, BasicResponseStatPrefixes) {
+  code_stats_.chargeBasicResponseStat(store_, "", Code::OK);
+  code_stats_.chargeBasicResponseStat(store_, "retry.", Code::OK);
+  code_stats_.chargeBasicResponseStat(store_, "retry", Code::ServiceUnavailable);
+
+  EXPECT_EQ(1U, store_.counter("upstream_rq_completed").value());
+  EXPECT_EQ(1U, store_.counter("upstream_rq_2xx").value());
+  EXPECT_EQ(1U, store_.counter("upstream_rq_200").value());
+  EXPECT_EQ(2U, store_.counter("retry.upstream_rq_completed").value());
+  EXPECT_EQ(1U, store_.counter("retry.upstream_rq_2xx").value());
+  EXPECT_EQ(1U, store_.counter("retry.upstream_rq_200").value());
+  EXPECT_EQ(1U, store_.counter("retry.upstream_rq_5xx").value());
+  EXPECT_EQ(1U, store_.counter("retry.upstream_rq_503").value());
+}
+
+TEST_F(CodeStatsTest, CodesOutsidePredeclaredRange) {
+  code_stats_.chargeBasicResponseStat(store_, "", static_cast<Code>(99));
+  code_stats_.chargeBasicResponseStat(store_, "", static_cast<Code>(600));
+  code_stats_.chargeBasicResponseStat(store_, "", static_cast<Code>(100));
+
+  EXPECT_EQ(3U, store_.counter("upstream_rq_completed").value());
+  EXPECT_EQ(3U, store_.counter("upstream_rq_").value());
+  EXPECT_EQ(1U, store_.counter("upstream_rq_99").value());
+  EXPECT_EQ(1U, store_.counter("upstream_rq_600").value());
+  EXPECT_EQ(1U, store_.counter("upstream_rq_100").value());
 }
 
 } // namespace Http
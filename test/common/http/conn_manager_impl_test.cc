@@ -281,7 +281,7 @@ public:
   RouteConfigProvider route_config_provider_;
   NiceMock<Tracing::MockHttpTracer> tracer_;
   Stats::IsolatedStoreImpl fake_stats_;
-  Http::ContextImpl http_context_;
+  Http::ContextImpl http_context_{fake_stats_.symbolTable()};
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Envoy::AccessLog::MockAccessLogManager> log_manager_;
   std::string access_log_path_;
@@ -0,0 +1,70 @@
+// Benchmarks for parsing a JSON body and reading a few values from each of its items, with
+// Json::Factory and with Json::Document.
+//
+// Note: this should be run with --compilation_mode=opt.
+
+#include <string>
+
+#include "common/common/fmt.h"
+#include "common/json/json_document.h"
+#include "common/json/json_loader.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Json {
+namespace {
+
+std::string makeJson(uint32_t num_items) {
+  std::string json = "{\"items\": [";
+  for (uint32_t i = 0; i < num_items; ++i) {
+    json += fmt::format("{}{{\"name\": \"item_{}\", \"id\": {}, \"weight\": 0.5, \"enabled\": "
+                        "true, \"tags\": [\"a\", \"b\"], \"metadata\": {{\"owner\": \"team\"}}}}",
+                        i == 0 ? "" : ", ", i, i);
+  }
+  return json + "]}";
+}
+
+static void FactoryLoadFromString(benchmark::State& state) {
+  const std::string json = makeJson(state.range(0));
+  for (auto _ : state) {
+    ObjectSharedPtr root = Factory::loadFromString(json);
+    size_t total = 0;
+    for (const ObjectSharedPtr& item : root->getObjectArray("items")) {
+      total += item->getString("name").size() + item->getInteger("id");
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(FactoryLoadFromString)->Arg(1)->Arg(100)->Arg(10000);
+
+static void DocumentParse(benchmark::State& state) {
+  const std::string json = makeJson(state.range(0));
+  for (auto _ : state) {
+    // The copy stands in for a body that has to be linearized from a buffer anyway.
+    Document document(json);
+    const Value items = document.root().get("items");
+    size_t total = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+      const Value item = items.at(i);
+      total += item.getString("name").size() + item.getInteger("id");
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(DocumentParse)->Arg(1)->Arg(100)->Arg(10000);
+
+} // namespace
+} // namespace Json
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,113 @@
+#include <string>
+#include <vector>
+
+#include "common/json/json_document.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Json {
+namespace {
+
+TEST(JsonDocumentTest, Basic) {
+  Document document(R"EOF({
+  "string": "hello",
+  "escaped": "a\"b\\cé",
+  "integer": -12,
+  "double": 1.5,
+  "boolean": true,
+  "null": null,
+  "array": [1, "two", {"three": 3}],
+  "object": {"inner": "value"},
+  "empty": {}
+})EOF");
+  const Value root = document.root();
+
+  EXPECT_EQ(Value::Type::Object, root.type());
+  EXPECT_TRUE(root.isObject());
+  EXPECT_EQ(9U, root.size());
+  EXPECT_EQ("hello", root.getString("string"));
+  EXPECT_EQ("a\"b\\c\xc3\xa9", root.getString("escaped"));
+  EXPECT_EQ(-12, root.getInteger("integer"));
+  EXPECT_EQ(1.5, root.getDouble("double"));
+  EXPECT_TRUE(root.getBoolean("boolean"));
+  EXPECT_TRUE(root.get("null").isNull());
+
+  const Value array = root.get("array");
+  EXPECT_TRUE(array.isArray());
+  EXPECT_EQ(3U, array.size());
+  EXPECT_EQ(1, array.at(0).asInteger());
+  EXPECT_EQ("two", array.at(1).asString());
+  EXPECT_EQ(3, array.at(2).getInteger("three"));
+  EXPECT_THROW_WITH_MESSAGE(array.at(3), Exception, "JSON array index 3 out of range (size 3)");
+
+  EXPECT_EQ("value", root.get("object").getString("inner"));
+  EXPECT_TRUE(root.get("empty").empty());
+  EXPECT_TRUE(root.hasMember("empty"));
+  EXPECT_FALSE(root.hasMember("missing"));
+  EXPECT_FALSE(root.find("missing").has_value());
+  EXPECT_EQ(R"EOF({"inner":"value"})EOF", root.get("object").asJsonString());
+}
+
+TEST(JsonDocumentTest, Defaults) {
+  Document document(R"EOF({"integer": 1})EOF");
+  const Value root = document.root();
+
+  EXPECT_EQ(1, root.getInteger("integer", 2));
+  EXPECT_EQ(2, root.getInteger("missing", 2));
+  EXPECT_FALSE(root.getBoolean("missing", false));
+  EXPECT_EQ(0.5, root.getDouble("missing", 0.5));
+  EXPECT_EQ("default", root.getString("missing", "default"));
+  EXPECT_THROW_WITH_MESSAGE(root.getString("integer", "default"), Exception,
+                            "JSON value accessed with type 'String' does not match actual type "
+                            "'Integer'.");
+}
+
+TEST(JsonDocumentTest, TypeErrors) {
+  Document document(R"EOF({"integer": 1, "double": 1.0, "big": 18446744073709551615})EOF");
+  const Value root = document.root();
+
+  EXPECT_THROW_WITH_MESSAGE(root.getString("missing"), Exception, "key 'missing' missing");
+  EXPECT_THROW(root.getDouble("integer"), Exception);
+  EXPECT_THROW(root.getInteger("double"), Exception);
+  EXPECT_THROW(root.getBoolean("integer"), Exception);
+  EXPECT_THROW(root.at(0), Exception);
+  EXPECT_THROW(root.get("integer").size(), Exception);
+  EXPECT_THROW(root.get("integer").find("a"), Exception);
+  EXPECT_THROW_WITH_MESSAGE(root.getInteger("big"), Exception,
+                            "JSON value 18446744073709551615 is larger than int64_t (not "
+                            "supported)");
+}
+
+TEST(JsonDocumentTest, Iterate) {
+  Document document(R"EOF({"a": 1, "b": 2, "c": 3, "a": 4})EOF");
+  std::vector<std::string> names;
+  document.root().iterate([&names](absl::string_view name, const Value& value) {
+    names.push_back(fmt::format("{}={}", name, value.asInteger()));
+    return name != "c";
+  });
+  EXPECT_EQ((std::vector<std::string>{"a=1", "b=2", "c=3"}), names);
+
+  // The first of repeated names is found.
+  EXPECT_EQ(1, document.root().getInteger("a"));
+}
+
+TEST(JsonDocumentTest, NonObjectRoot) {
+  EXPECT_EQ(2U, Document("[1, 2]").root().size());
+  EXPECT_EQ("x", Document(R"EOF("x")EOF").root().asString());
+  EXPECT_TRUE(Document("null").root().isNull());
+}
+
+TEST(JsonDocumentTest, ParseError) {
+  EXPECT_THROW_WITH_MESSAGE(Document(""), Exception,
+                            "JSON supplied is not valid. Error(offset 0, line 1): The document "
+                            "is empty.\n");
+  EXPECT_THROW_WITH_REGEX(Document("{\n\"a\": 1,\n}"), Exception, "offset 10, line 3");
+  EXPECT_THROW(Document("{} {}"), Exception);
+}
+
+} // namespace
+} // namespace Json
+} // namespace Envoy
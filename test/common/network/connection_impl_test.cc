@@ -486,6 +486,33 @@ TEST_P(ConnectionImplTest, ConnectionStats) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// Test when a connection can be spliced, and that spliced bytes are accounted.
+TEST_P(ConnectionImplTest, Splice) {
+  setUpBasicConnection();
+  connect();
+
+  // The server connection has a single read filter and the client connection has none.
+  ASSERT_NE(nullptr, server_connection_->spliceIoHandle());
+  EXPECT_NE(nullptr, client_connection_->spliceIoHandle());
+  client_connection_->addWriteFilter(std::make_shared<NiceMock<MockWriteFilter>>());
+  EXPECT_EQ(nullptr, client_connection_->spliceIoHandle());
+
+  MockConnectionStats server_connection_stats;
+  server_connection_->setConnectionStats(server_connection_stats.toBufferStats());
+  uint64_t bytes_sent = 0;
+  server_connection_->addBytesSentCallback([&](uint64_t bytes) -> void { bytes_sent += bytes; });
+  EXPECT_CALL(server_connection_stats.rx_total_, add(3));
+  EXPECT_CALL(server_connection_stats.tx_total_, add(5));
+  server_connection_->onSpliced(3, 5);
+  EXPECT_EQ(5, bytes_sent);
+
+  // A second read filter would not see the spliced bytes.
+  server_connection_->addReadFilter(std::make_shared<NiceMock<MockReadFilter>>());
+  EXPECT_EQ(nullptr, server_connection_->spliceIoHandle());
+
+  disconnect(true);
+}
+
 // Ensure the new counter logic in ReadDisable avoids tripping asserts in ReadDisable guarding
 // against actual enabling twice in a row.
 TEST_P(ConnectionImplTest, ReadDisable) {
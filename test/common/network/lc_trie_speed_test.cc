@@ -21,6 +21,16 @@ std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_nested_pref
 
 std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_minimal;
 
+// Addresses spread over the whole IPv4 address space and a trie with 2^17 /24 prefixes, which is
+// representative of large ip_tagging configurations.
+std::vector<Envoy::Network::Address::InstanceConstSharedPtr> addresses_large;
+
+std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_large;
+
+std::vector<Envoy::Network::Address::InstanceConstSharedPtr> addresses_ipv6;
+
+std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_ipv6;
+
 } // namespace
 
 namespace Envoy {
@@ -95,6 +105,60 @@ static void BM_LcTrieLookupMinimal(benchmark::State& state) {
 
 BENCHMARK(BM_LcTrieLookupMinimal);
 
+static void BM_LcTrieLookupLarge(benchmark::State& state) {
+  static size_t i = 0;
+  size_t output_tags = 0;
+  for (auto _ : state) {
+    i++;
+    i %= addresses_large.size();
+    output_tags += lc_trie_large->getData(addresses_large[i]).size();
+  }
+  benchmark::DoNotOptimize(output_tags);
+}
+
+BENCHMARK(BM_LcTrieLookupLarge);
+
+// Classifies all of addresses_large per iteration with a single batch lookup. Compare the per
+// item time with BM_LcTrieLookupLarge.
+static void BM_LcTrieBatchLookupLarge(benchmark::State& state) {
+  size_t output_tags = 0;
+  for (auto _ : state) {
+    for (const auto& data : lc_trie_large->getData(addresses_large)) {
+      output_tags += data.size();
+    }
+  }
+  benchmark::DoNotOptimize(output_tags);
+  state.SetItemsProcessed(state.iterations() * addresses_large.size());
+}
+
+BENCHMARK(BM_LcTrieBatchLookupLarge);
+
+static void BM_LcTrieLookupIPv6(benchmark::State& state) {
+  static size_t i = 0;
+  size_t output_tags = 0;
+  for (auto _ : state) {
+    i++;
+    i %= addresses_ipv6.size();
+    output_tags += lc_trie_ipv6->getData(addresses_ipv6[i]).size();
+  }
+  benchmark::DoNotOptimize(output_tags);
+}
+
+BENCHMARK(BM_LcTrieLookupIPv6);
+
+static void BM_LcTrieBatchLookupIPv6(benchmark::State& state) {
+  size_t output_tags = 0;
+  for (auto _ : state) {
+    for (const auto& data : lc_trie_ipv6->getData(addresses_ipv6)) {
+      output_tags += data.size();
+    }
+  }
+  benchmark::DoNotOptimize(output_tags);
+  state.SetItemsProcessed(state.iterations() * addresses_ipv6.size());
+}
+
+BENCHMARK(BM_LcTrieBatchLookupIPv6);
+
 } // namespace Envoy
 
 // Boilerplate main(), which discovers benchmarks in the same file and runs them.
@@ -132,6 +196,44 @@ int main(int argc, char** argv) {
       std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_nested_prefixes);
   lc_trie_minimal = std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_minimal);
 
+  // Multiplying by an odd constant permutes the 24 bit network numbers, which spreads the /24
+  // prefixes and the looked up addresses over the whole address space without duplicates.
+  std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>>
+      tag_data_large(1);
+  tag_data_large[0].first = "tag_1";
+  for (uint32_t i = 0; i < (1 << 17); i++) {
+    const uint32_t network = (i * 2654435761U) & 0xffffff;
+    tag_data_large[0].second.push_back(Envoy::Network::Address::CidrRange::create(
+        fmt::format("{}.{}.{}.0/24", network >> 16, (network >> 8) & 0xff, network & 0xff)));
+  }
+  lc_trie_large = std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_large);
+  for (uint32_t i = 0; i < 1024; i++) {
+    const uint32_t address = i * 2246822519U;
+    addresses_large.push_back(Envoy::Network::Utility::parseInternetAddress(
+        fmt::format("{}.{}.{}.{}", address >> 24, (address >> 16) & 0xff, (address >> 8) & 0xff,
+                    address & 0xff)));
+  }
+
+  // 4,096 /48 prefixes from the RFC 3849 documentation netblock, half of which are nested in
+  // /40 prefixes.
+  std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>>
+      tag_data_ipv6(2);
+  tag_data_ipv6[0].first = "tag_0";
+  tag_data_ipv6[1].first = "tag_1";
+  for (uint32_t i = 0; i < 4096; i++) {
+    tag_data_ipv6[1].second.push_back(
+        Envoy::Network::Address::CidrRange::create(fmt::format("2001:db8:{:x}::/48", i * 13)));
+  }
+  for (uint32_t i = 0; i < 128; i++) {
+    tag_data_ipv6[0].second.push_back(
+        Envoy::Network::Address::CidrRange::create(fmt::format("2001:db8:{:x}00::/40", i * 2)));
+  }
+  lc_trie_ipv6 = std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(tag_data_ipv6);
+  for (uint32_t i = 0; i < 1024; i++) {
+    addresses_ipv6.push_back(Envoy::Network::Utility::parseInternetAddress(
+        fmt::format("2001:db8:{:x}:{:x}::1", (i * 53) & 0xffff, i)));
+  }
+
   benchmark::Initialize(&argc, argv);
   if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
     return 1;
@@ -44,6 +44,21 @@ public:
       std::sort(actual.begin(), actual.end());
       EXPECT_EQ(expected, actual);
     }
+
+    // The batch lookup must agree with the individual lookups.
+    std::vector<Address::InstanceConstSharedPtr> addresses;
+    for (const auto& kv : test_output) {
+      addresses.push_back(Utility::parseInternetAddress(kv.first));
+    }
+    const std::vector<std::vector<std::string>> batch_output = trie_->getData(addresses);
+    ASSERT_EQ(test_output.size(), batch_output.size());
+    for (size_t i = 0; i < test_output.size(); i++) {
+      std::vector<std::string> expected(test_output[i].second);
+      std::sort(expected.begin(), expected.end());
+      std::vector<std::string> actual(batch_output[i]);
+      std::sort(actual.begin(), actual.end());
+      EXPECT_EQ(expected, actual) << test_output[i].first;
+    }
   }
 
   std::unique_ptr<LcTrie<std::string>> trie_;
@@ -325,6 +340,36 @@ TEST_F(LcTrieTest, ExclusiveNestedPrefixesWithCatchAll) {
   expectIPAndTags(test_case);
 }
 
+// Large enough for lookups to start from the direct lookup table rather than from the root of
+// the trie, with more addresses than fit in a single lookup batch.
+TEST_F(LcTrieTest, ManyPrefixes) {
+  std::vector<std::vector<std::string>> cidr_range_strings(3);
+  for (size_t i = 0; i < 64; i++) {
+    for (size_t j = 0; j < 64; j++) {
+      cidr_range_strings[0].push_back(fmt::format("10.{}.{}.0/24", i, j));
+      cidr_range_strings[1].push_back(fmt::format("2001:db8:{:x}:{:x}::/64", i, j));
+    }
+  }
+  cidr_range_strings[2] = {"10.0.0.0/8", "10.1.1.128/25", "2001:db8::/32"};
+  setup(cidr_range_strings);
+
+  std::vector<std::pair<std::string, std::vector<std::string>>> test_case = {
+      {"10.0.0.1", {"tag_0", "tag_2"}},
+      {"10.1.1.1", {"tag_0", "tag_2"}},
+      {"10.1.1.129", {"tag_0", "tag_2"}},
+      {"10.63.63.255", {"tag_0", "tag_2"}},
+      {"10.64.0.1", {"tag_2"}},
+      {"10.255.255.255", {"tag_2"}},
+      {"11.0.0.0", {}},
+      {"9.255.255.255", {}},
+      {"2001:db8:0:0::1", {"tag_1", "tag_2"}},
+      {"2001:db8:3f:3f:ffff::", {"tag_1", "tag_2"}},
+      {"2001:db8:40::1", {"tag_2"}},
+      {"2001:db9::1", {}},
+  };
+  expectIPAndTags(test_case);
+}
+
 // Ensure the trie will reject inputs that would cause it to exceed the maximum 2^20 nodes
 // when using the default fill factor.
 TEST_F(LcTrieTest, MaximumEntriesExceptionDefault) {
@@ -0,0 +1,174 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/splice_pipe.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+
+// Two loopback TCP connections, with a thread that keeps sending on the first and one that keeps
+// receiving on the second. The benchmarks move the data from the first to the second, as the TCP
+// proxy does from its downstream to its upstream connection.
+class LoopbackProxy {
+public:
+  LoopbackProxy() {
+    int proxy_in_fd;
+    int proxy_out_fd;
+    connectPair(client_fd_, proxy_in_fd);
+    connectPair(proxy_out_fd, server_fd_);
+    proxy_in_ = nonBlockingHandle(proxy_in_fd);
+    proxy_out_ = nonBlockingHandle(proxy_out_fd);
+    writer_ = std::thread([this]() -> void {
+      const std::string chunk(65536, 'a');
+      while (::send(client_fd_, chunk.data(), chunk.size(), MSG_NOSIGNAL) > 0) {
+      }
+    });
+    reader_ = std::thread([this]() -> void {
+      char buffer[65536];
+      while (::recv(server_fd_, buffer, sizeof(buffer), 0) > 0) {
+      }
+    });
+  }
+
+  ~LoopbackProxy() {
+    ::shutdown(client_fd_, SHUT_RDWR);
+    ::shutdown(server_fd_, SHUT_RDWR);
+    writer_.join();
+    reader_.join();
+    ::close(client_fd_);
+    ::close(server_fd_);
+  }
+
+  // Copies bytes through a buffer in user space, as a raw_buffer transport socket would.
+  void copy(uint64_t bytes) {
+    Buffer::OwnedImpl buffer;
+    uint64_t moved = 0;
+    while (moved < bytes) {
+      if (buffer.length() == 0) {
+        const Api::IoCallUint64Result result = buffer.read(*proxy_in_, 16384);
+        if (!result.ok() || result.rc_ == 0) {
+          wait(*proxy_in_, POLLIN);
+          continue;
+        }
+      }
+      const Api::IoCallUint64Result result = buffer.write(*proxy_out_);
+      if (!result.ok() || result.rc_ == 0) {
+        wait(*proxy_out_, POLLOUT);
+        continue;
+      }
+      moved += result.rc_;
+    }
+    // Whatever is left over is written as part of the next iteration.
+    while (buffer.length() > 0) {
+      if (buffer.write(*proxy_out_).rc_ == 0) {
+        wait(*proxy_out_, POLLOUT);
+      }
+    }
+  }
+
+  // Splices bytes through a pipe, without copying them to user space.
+  void splice(SplicePipe& pipe, uint64_t bytes) {
+    uint64_t moved = 0;
+    while (moved < bytes) {
+      const SplicePipe::TransferResult result = pipe.transfer(*proxy_in_, *proxy_out_, 0);
+      RELEASE_ASSERT(result.errno_ == 0, "");
+      moved += result.bytes_written_;
+      if (result.write_blocked_) {
+        wait(*proxy_out_, POLLOUT);
+      } else if (result.bytes_read_ == 0) {
+        wait(*proxy_in_, POLLIN);
+      }
+    }
+  }
+
+private:
+  static void wait(IoHandle& handle, short events) {
+    pollfd fd{handle.fd(), events, 0};
+    ::poll(&fd, 1, -1);
+  }
+
+  static void connectPair(int& client_fd, int& accepted_fd) {
+    const int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    RELEASE_ASSERT(::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), address_length) == 0,
+                   "");
+    RELEASE_ASSERT(::listen(listen_fd, 1) == 0, "");
+    RELEASE_ASSERT(
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_length) == 0, "");
+    client_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    RELEASE_ASSERT(::connect(client_fd, reinterpret_cast<sockaddr*>(&address), address_length) == 0,
+                   "");
+    accepted_fd = ::accept(listen_fd, nullptr, nullptr);
+    ::close(listen_fd);
+  }
+
+  static std::unique_ptr<IoSocketHandleImpl> nonBlockingHandle(int fd) {
+    RELEASE_ASSERT(::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) == 0, "");
+    return std::make_unique<IoSocketHandleImpl>(fd);
+  }
+
+  int client_fd_;
+  int server_fd_;
+  std::unique_ptr<IoSocketHandleImpl> proxy_in_;
+  std::unique_ptr<IoSocketHandleImpl> proxy_out_;
+  std::thread writer_;
+  std::thread reader_;
+};
+
+} // namespace Network
+} // namespace Envoy
+
+using Envoy::Network::LoopbackProxy;
+using Envoy::Network::SplicePipe;
+using Envoy::Network::SplicePipePtr;
+
+// Moves 16MiB per iteration by copying through a buffer in user space.
+static void BM_LoopbackCopy(benchmark::State& state) {
+  LoopbackProxy proxy;
+  for (auto _ : state) {
+    proxy.copy(16 << 20);
+  }
+  state.SetBytesProcessed(state.iterations() * (16 << 20));
+}
+BENCHMARK(BM_LoopbackCopy)->Unit(benchmark::kMillisecond);
+
+// Moves 16MiB per iteration with splice(2).
+static void BM_LoopbackSplice(benchmark::State& state) {
+  SplicePipePtr pipe = SplicePipe::create();
+  if (pipe == nullptr) {
+    state.SkipWithError("splice is not supported");
+    return;
+  }
+  LoopbackProxy proxy;
+  for (auto _ : state) {
+    proxy.splice(*pipe, 16 << 20);
+  }
+  state.SetBytesProcessed(state.iterations() * (16 << 20));
+}
+BENCHMARK(BM_LoopbackSplice)->Unit(benchmark::kMillisecond);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,169 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/splice_pipe.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+#if defined(__linux__)
+// Splices from the source socket pair to the destination socket pair, as a proxy would between its
+// downstream and upstream connections.
+class SplicePipeTest : public testing::Test {
+public:
+  SplicePipeTest() {
+    socketPair(source_peer_, source_);
+    socketPair(destination_, destination_peer_);
+    pipe_ = SplicePipe::create();
+  }
+
+  static void socketPair(std::unique_ptr<IoSocketHandleImpl>& first,
+                         std::unique_ptr<IoSocketHandleImpl>& second) {
+    int fds[2];
+    RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0, "");
+    first = std::make_unique<IoSocketHandleImpl>(fds[0]);
+    second = std::make_unique<IoSocketHandleImpl>(fds[1]);
+  }
+
+  void sendToSource(const std::string& data) {
+    ASSERT_EQ(static_cast<ssize_t>(data.size()),
+              ::write(source_peer_->fd(), data.data(), data.size()));
+  }
+
+  std::string receiveFromDestination() {
+    std::string data;
+    char buffer[4096];
+    ssize_t rc;
+    while ((rc = ::read(destination_peer_->fd(), buffer, sizeof(buffer))) > 0) {
+      data.append(buffer, rc);
+    }
+    return data;
+  }
+
+  std::unique_ptr<IoSocketHandleImpl> source_peer_;
+  std::unique_ptr<IoSocketHandleImpl> source_;
+  std::unique_ptr<IoSocketHandleImpl> destination_;
+  std::unique_ptr<IoSocketHandleImpl> destination_peer_;
+  SplicePipePtr pipe_;
+};
+
+TEST_F(SplicePipeTest, MovesBytes) {
+  ASSERT_NE(nullptr, pipe_);
+  sendToSource("hello");
+
+  SplicePipe::TransferResult result = pipe_->transfer(*source_, *destination_, 0);
+  EXPECT_EQ(5, result.bytes_read_);
+  EXPECT_EQ(5, result.bytes_written_);
+  EXPECT_FALSE(result.write_blocked_);
+  EXPECT_EQ(0, result.errno_);
+  EXPECT_EQ(0, pipe_->bufferedBytes());
+  EXPECT_FALSE(pipe_->endStreamRead());
+  EXPECT_EQ("hello", receiveFromDestination());
+
+  // Nothing more to read.
+  result = pipe_->transfer(*source_, *destination_, 0);
+  EXPECT_EQ(0, result.bytes_read_);
+  EXPECT_EQ(0, result.bytes_written_);
+  EXPECT_EQ(0, result.errno_);
+}
+
+TEST_F(SplicePipeTest, EndStream) {
+  ASSERT_NE(nullptr, pipe_);
+  sendToSource("bye");
+  ::shutdown(source_peer_->fd(), SHUT_WR);
+
+  SplicePipe::TransferResult result = pipe_->transfer(*source_, *destination_, 0);
+  EXPECT_EQ(3, result.bytes_read_);
+  EXPECT_EQ(3, result.bytes_written_);
+  EXPECT_TRUE(pipe_->endStreamRead());
+  EXPECT_EQ("bye", receiveFromDestination());
+}
+
+// Bytes that the destination cannot take are held in the pipe, and the source is not read again
+// until they have been written.
+TEST_F(SplicePipeTest, WriteBlocked) {
+  ASSERT_NE(nullptr, pipe_);
+  const std::string chunk(4096, 'a');
+  uint64_t sent = 0;
+  uint64_t received = 0;
+  bool blocked = false;
+  while (!blocked) {
+    sendToSource(chunk);
+    sent += chunk.size();
+    const SplicePipe::TransferResult result = pipe_->transfer(*source_, *destination_, 0);
+    ASSERT_EQ(0, result.errno_);
+    blocked = result.write_blocked_;
+  }
+  EXPECT_GT(pipe_->bufferedBytes(), 0);
+
+  // The source is not read while the destination is blocked.
+  sendToSource(chunk);
+  sent += chunk.size();
+  SplicePipe::TransferResult result = pipe_->transfer(*source_, *destination_, 0);
+  EXPECT_EQ(0, result.bytes_read_);
+  EXPECT_TRUE(result.write_blocked_);
+
+  while (received < sent) {
+    received += receiveFromDestination().size();
+    result = pipe_->transfer(*source_, *destination_, 0);
+    ASSERT_EQ(0, result.errno_);
+  }
+  EXPECT_EQ(sent, received);
+  EXPECT_EQ(0, pipe_->bufferedBytes());
+  EXPECT_FALSE(result.write_blocked_);
+}
+
+TEST_F(SplicePipeTest, ReadLimit) {
+  ASSERT_NE(nullptr, pipe_);
+  sendToSource(std::string(1000, 'a'));
+
+  SplicePipe::TransferResult result = pipe_->transfer(*source_, *destination_, 1);
+  EXPECT_EQ(1000, result.bytes_read_);
+  EXPECT_EQ(1000, result.bytes_written_);
+  EXPECT_TRUE(result.read_limit_reached_);
+
+  result = pipe_->transfer(*source_, *destination_, 1);
+  EXPECT_EQ(0, result.bytes_read_);
+  EXPECT_FALSE(result.read_limit_reached_);
+  EXPECT_EQ(1000, receiveFromDestination().size());
+}
+
+TEST_F(SplicePipeTest, Error) {
+  ASSERT_NE(nullptr, pipe_);
+  Api::MockLinuxOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> injector(&os_sys_calls);
+
+  EXPECT_CALL(os_sys_calls, splice(source_->fd(), _, _, _, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, ECONNRESET}));
+  const SplicePipe::TransferResult result = pipe_->transfer(*source_, *destination_, 0);
+  EXPECT_EQ(0, result.bytes_read_);
+  EXPECT_EQ(ECONNRESET, result.errno_);
+}
+
+TEST(SplicePipeCreateTest, PipeFailure) {
+  Api::MockLinuxOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> injector(&os_sys_calls);
+
+  EXPECT_CALL(os_sys_calls, pipe2(_, _)).WillOnce(Return(Api::SysCallIntResult{-1, EMFILE}));
+  EXPECT_EQ(nullptr, SplicePipe::create());
+}
+#else
+TEST(SplicePipeCreateTest, NotSupported) { EXPECT_EQ(nullptr, SplicePipe::create()); }
+#endif
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -602,6 +602,64 @@ virtual_hosts:
                           EnvoyException, "Invalid regex '\\^/\\(\\+invalid\\)':");
 }
 
+TEST_F(RouteMatcherTest, TestRoutesWithSafeRegex) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: regex
+    domains: ["*"]
+    routes:
+      - match:
+          safe_regex:
+            google_re2: {}
+            regex: "/t[io]c"
+        route: { cluster: "clock" }
+      - match:
+          safe_regex:
+            google_re2: {}
+            regex: ".*/\\d{3}"
+        route: { cluster: "three_numbers" }
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+
+  EXPECT_EQ("clock",
+            config.route(genHeaders("bat.com", "/tic", "GET"), 0)->routeEntry()->clusterName());
+  EXPECT_EQ("clock", config.route(genHeaders("bat.com", "/toc?tac=true", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  EXPECT_EQ("default",
+            config.route(genHeaders("bat.com", "/tick", "GET"), 0)->routeEntry()->clusterName());
+  EXPECT_EQ("three_numbers",
+            config.route(genHeaders("bat.com", "/foo/123", "GET"), 0)->routeEntry()->clusterName());
+  EXPECT_EQ(
+      "default",
+      config.route(genHeaders("bat.com", "/foo/1234", "GET"), 0)->routeEntry()->clusterName());
+
+  const auto route = config.route(genHeaders("bat.com", "/tic", "GET"), 0);
+  EXPECT_EQ("/t[io]c", route->routeEntry()->pathMatchCriterion().matcher());
+  EXPECT_EQ(PathMatchType::Regex, route->routeEntry()->pathMatchCriterion().matchType());
+}
+
+TEST_F(RouteMatcherTest, TestRoutesWithSafeRegexOverProgramSize) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: regex
+    domains: ["*"]
+    routes:
+      - match:
+          safe_regex:
+            google_re2: { max_program_size: 5 }
+            regex: "/api/v[0-9]+/users"
+        route: { cluster: "users" }
+  )EOF";
+
+  EXPECT_THROW_WITH_REGEX(
+      TestConfigImpl(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true),
+      EnvoyException, "RE2 program size of [0-9]+ > max program size of 5");
+}
+
 // Validates behavior of request_headers_to_add at router, vhost, and route levels.
 TEST_F(RouteMatcherTest, TestAddRemoveRequestHeaders) {
   const std::string yaml = R"EOF(
@@ -2029,6 +2087,164 @@ virtual_hosts:
   TestConfigImpl(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
 }
 
+TEST_F(RouteMatcherTest, VirtualHostCacheSharesVirtualHosts) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: www2
+  domains:
+  - www.lyft.com
+  routes:
+  - match:
+      prefix: "/foo"
+    route:
+      cluster: www2
+- name: {}
+  domains:
+  - api.lyft.com
+  routes:
+  - match:
+      prefix: "/"
+    route:
+      cluster: api
+  )EOF";
+
+  VirtualHostCache cache(factory_context_.scope_);
+  const uint64_t context_id = cache.newContextId();
+  ConfigImpl config1(parseRouteConfigurationFromV2Yaml(fmt::format(yaml, "api")), factory_context_,
+                     true, &cache, context_id);
+  ConfigImpl config2(parseRouteConfigurationFromV2Yaml(fmt::format(yaml, "api2")),
+                     factory_context_, true, &cache, context_id);
+
+  // The www2 virtual host and its routes are shared, and api is not. Each route configuration
+  // still has its own virtual host around the shared one.
+  const RouteEntry* www1 =
+      config1.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)->routeEntry();
+  const RouteEntry* www2 =
+      config2.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)->routeEntry();
+  EXPECT_EQ(&www1->retryPolicy(), &www2->retryPolicy());
+  EXPECT_EQ(&www1->virtualHost().rateLimitPolicy(), &www2->virtualHost().rateLimitPolicy());
+  EXPECT_EQ(&config1, &www1->virtualHost().routeConfig());
+  EXPECT_EQ(&config2, &www2->virtualHost().routeConfig());
+  EXPECT_NE(&config1.route(genHeaders("api.lyft.com", "/", "GET"), 0)->routeEntry()->retryPolicy(),
+            &config2.route(genHeaders("api.lyft.com", "/", "GET"), 0)->routeEntry()->retryPolicy());
+  EXPECT_EQ(1UL, factory_context_.scope_.counter("virtual_host_cache.hit").value());
+  EXPECT_EQ(3UL, factory_context_.scope_.counter("virtual_host_cache.miss").value());
+  EXPECT_EQ(3UL, factory_context_.scope_.gauge("virtual_host_cache.active").value());
+  EXPECT_EQ(1UL, factory_context_.scope_.gauge("virtual_host_cache.shared").value());
+  EXPECT_EQ(MessageUtil::deterministicSerialize(
+                parseRouteConfigurationFromV2Yaml(fmt::format(yaml, "api")).virtual_hosts(0))
+                .size(),
+            factory_context_.scope_.gauge("virtual_host_cache.bytes_saved").value());
+
+  // Virtual hosts are forgotten once no route configuration uses them.
+  {
+    ConfigImpl config3(parseRouteConfigurationFromV2Yaml(fmt::format(yaml, "api3")),
+                       factory_context_, true, &cache, context_id);
+    EXPECT_EQ(4UL, factory_context_.scope_.gauge("virtual_host_cache.active").value());
+    EXPECT_EQ(2UL, factory_context_.scope_.gauge("virtual_host_cache.shared").value());
+  }
+  EXPECT_EQ(3UL, factory_context_.scope_.gauge("virtual_host_cache.active").value());
+  EXPECT_EQ(1UL, factory_context_.scope_.gauge("virtual_host_cache.shared").value());
+  ConfigImpl config4(parseRouteConfigurationFromV2Yaml(fmt::format(yaml, "api")), factory_context_,
+                     true, &cache, context_id);
+  EXPECT_EQ(3UL, factory_context_.scope_.gauge("virtual_host_cache.active").value());
+  EXPECT_EQ(3UL, factory_context_.scope_.gauge("virtual_host_cache.shared").value());
+}
+
+TEST_F(RouteMatcherTest, VirtualHostCacheRecompilesFreedVirtualHosts) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: www2
+  domains:
+  - www.lyft.com
+  routes:
+  - match:
+      prefix: "/foo"
+    route:
+      cluster: www2
+  )EOF";
+
+  VirtualHostCache cache(factory_context_.scope_);
+  const uint64_t context_id = cache.newContextId();
+  {
+    ConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true, &cache,
+                      context_id);
+  }
+  EXPECT_EQ(0UL, factory_context_.scope_.gauge("virtual_host_cache.active").value());
+
+  ConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true, &cache,
+                    context_id);
+  EXPECT_EQ(0UL, factory_context_.scope_.counter("virtual_host_cache.hit").value());
+  EXPECT_EQ(2UL, factory_context_.scope_.counter("virtual_host_cache.miss").value());
+  EXPECT_EQ(1UL, factory_context_.scope_.gauge("virtual_host_cache.active").value());
+  EXPECT_EQ(0UL, factory_context_.scope_.gauge("virtual_host_cache.shared").value());
+  EXPECT_NE(nullptr, config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0));
+}
+
+TEST_F(RouteMatcherTest, VirtualHostCacheKeyIncludesGlobalHeaders) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: www2
+  domains:
+  - www.lyft.com
+  routes:
+  - match:
+      prefix: "/foo"
+    route:
+      cluster: www2
+response_headers_to_add:
+- header:
+    key: x-global
+    value: {}
+  )EOF";
+
+  VirtualHostCache cache(factory_context_.scope_);
+  const uint64_t context_id = cache.newContextId();
+  ConfigImpl config1(parseRouteConfigurationFromV2Yaml(fmt::format(yaml, "one")), factory_context_,
+                     true, &cache, context_id);
+  ConfigImpl config2(parseRouteConfigurationFromV2Yaml(fmt::format(yaml, "two")), factory_context_,
+                     true, &cache, context_id);
+
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  Http::TestHeaderMapImpl headers1;
+  config1.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)
+      ->routeEntry()
+      ->finalizeResponseHeaders(headers1, stream_info);
+  EXPECT_EQ("one", headers1.get_("x-global"));
+  Http::TestHeaderMapImpl headers2;
+  config2.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)
+      ->routeEntry()
+      ->finalizeResponseHeaders(headers2, stream_info);
+  EXPECT_EQ("two", headers2.get_("x-global"));
+  EXPECT_EQ(0UL, factory_context_.scope_.counter("virtual_host_cache.hit").value());
+}
+
+TEST_F(RouteMatcherTest, VirtualHostCacheValidatesClustersOnHit) {
+  const std::string yaml = R"EOF(
+validate_clusters: {}
+virtual_hosts:
+- name: www2
+  domains:
+  - www.lyft.com
+  routes:
+  - match:
+      prefix: "/foo"
+    route:
+      cluster: www2
+  )EOF";
+
+  EXPECT_CALL(factory_context_.cluster_manager_, get("www2")).WillRepeatedly(Return(nullptr));
+
+  VirtualHostCache cache(factory_context_.scope_);
+  const uint64_t context_id = cache.newContextId();
+  ConfigImpl config(parseRouteConfigurationFromV2Yaml(fmt::format(yaml, "false")),
+                    factory_context_, true, &cache, context_id);
+  EXPECT_THROW(ConfigImpl(parseRouteConfigurationFromV2Yaml(fmt::format(yaml, "true")),
+                          factory_context_, true, &cache, context_id),
+               EnvoyException);
+  EXPECT_EQ(1UL, factory_context_.scope_.counter("virtual_host_cache.hit").value());
+}
+
 TEST_F(RouteMatcherTest, AttemptCountHeader) {
   const std::string yaml = R"EOF(
 virtual_hosts:
@@ -2201,6 +2417,11 @@ virtual_hosts:
                               ->routeEntry()
                               ->shadowPolicy()
                               .runtimeKey());
+  EXPECT_EQ("mirror_key", config.route(genHeaders("mirror.lyft.com", "/foo", "GET"), 0)
+                              ->routeEntry()
+                              ->shadowPolicy()
+                              .resolvedRuntimeKey()
+                              .name());
 
   const auto& default_value = config.route(genHeaders("mirror.lyft.com", "/foo", "GET"), 0)
                                   ->routeEntry()
@@ -4099,6 +4320,10 @@ virtual_hosts:
     domains: ["*"]
     cors:
       allow_origin: ["test-origin"]
+      allow_origin_regex: [".*\\.lyft\\.com"]
+      allow_origin_safe_regex:
+        - google_re2: {}
+          regex: ".*\\.envoyproxy\\.io"
       allow_methods: "test-methods"
       allow_headers: "test-headers"
       expose_headers: "test-expose-headers"
@@ -4141,6 +4366,11 @@ virtual_hosts:
   EXPECT_EQ(cors_policy->enabled(), false);
   EXPECT_EQ(cors_policy->shadowEnabled(), true);
   EXPECT_THAT(cors_policy->allowOrigins(), ElementsAreArray({"test-origin"}));
+  ASSERT_EQ(2, cors_policy->allowOriginRegexes().size());
+  EXPECT_TRUE(cors_policy->allowOriginRegexes()[0]->match("www.lyft.com"));
+  EXPECT_FALSE(cors_policy->allowOriginRegexes()[0]->match("www.envoyproxy.io"));
+  EXPECT_TRUE(cors_policy->allowOriginRegexes()[1]->match("www.envoyproxy.io"));
+  EXPECT_FALSE(cors_policy->allowOriginRegexes()[1]->match("www.lyft.com"));
   EXPECT_EQ(cors_policy->allowMethods(), "test-methods");
   EXPECT_EQ(cors_policy->allowHeaders(), "test-headers");
   EXPECT_EQ(cors_policy->exposeHeaders(), "test-expose-headers");
@@ -5334,6 +5564,7 @@ public:
 
   struct DerivedFilterConfig : public RouteSpecificFilterConfig {
     ProtobufWkt::Timestamp config_;
+    Server::Configuration::FactoryContext* context_{};
   };
   class TestFilterConfig : public Extensions::HttpFilters::Common::EmptyHttpFilterConfig {
   public:
@@ -5348,9 +5579,10 @@ public:
     }
     Router::RouteSpecificFilterConfigConstSharedPtr
     createRouteSpecificFilterConfig(const Protobuf::Message& message,
-                                    Server::Configuration::FactoryContext&) override {
+                                    Server::Configuration::FactoryContext& context) override {
       auto obj = std::make_shared<DerivedFilterConfig>();
       obj->config_.MergeFrom(message);
+      obj->context_ = &context;
       return obj;
     }
   };
@@ -5607,6 +5839,66 @@ virtual_hosts:
   checkEach(yaml, 1213, 1213, 1415);
 }
 
+// Virtual hosts with per filter configs are not shared by route configurations built with
+// different factory contexts, since the configs may refer to the context they were created with.
+// Other virtual hosts are.
+TEST_F(PerFilterConfigsTest, VirtualHostCacheKeyIncludesFactoryContext) {
+  const std::string yaml = R"EOF(
+name: foo
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: baz }
+        per_filter_config: { test.filter: { seconds: 123 } }
+    per_filter_config: { test.filter: { seconds: 456 } }
+  - name: qux
+    domains: ["www.qux.com"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: baz }
+)EOF";
+
+  NiceMock<Server::Configuration::MockFactoryContext> other_context;
+  ON_CALL(other_context, api()).WillByDefault(ReturnRef(*api_));
+  VirtualHostCache cache(factory_context_.scope_);
+  const uint64_t context_id = cache.newContextId();
+  const uint64_t other_context_id = cache.newContextId();
+  EXPECT_NE(context_id, other_context_id);
+  const ConfigImpl config1(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true, &cache,
+                           context_id);
+  const ConfigImpl config2(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true, &cache,
+                           context_id);
+  const ConfigImpl config3(parseRouteConfigurationFromV2Yaml(yaml), other_context, true, &cache,
+                           other_context_id);
+
+  const auto route_config_context = [this](const ConfigImpl& config) {
+    const auto route = config.route(genHeaders("www.foo.com", "/", "GET"), 0);
+    return route->perFilterConfigTyped<DerivedFilterConfig>(factory_.name())->context_;
+  };
+  const auto vhost_config_context = [this](const ConfigImpl& config) {
+    const auto route = config.route(genHeaders("www.foo.com", "/", "GET"), 0);
+    return route->routeEntry()
+        ->virtualHost()
+        .perFilterConfigTyped<DerivedFilterConfig>(factory_.name())
+        ->context_;
+  };
+  EXPECT_EQ(&factory_context_, route_config_context(config1));
+  EXPECT_EQ(&factory_context_, route_config_context(config2));
+  EXPECT_EQ(&other_context, route_config_context(config3));
+  EXPECT_EQ(&factory_context_, vhost_config_context(config2));
+  EXPECT_EQ(&other_context, vhost_config_context(config3));
+
+  // The qux virtual host is shared by all three route configurations.
+  const auto qux_retry_policy = [](const ConfigImpl& config) {
+    return &config.route(genHeaders("www.qux.com", "/", "GET"), 0)->routeEntry()->retryPolicy();
+  };
+  EXPECT_EQ(qux_retry_policy(config1), qux_retry_policy(config3));
+  EXPECT_EQ(3UL, factory_context_.scope_.counter("virtual_host_cache.hit").value());
+  EXPECT_EQ(3UL, factory_context_.scope_.counter("virtual_host_cache.miss").value());
+}
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
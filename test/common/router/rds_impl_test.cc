@@ -92,7 +92,8 @@ public:
   RdsImplTest() {
     EXPECT_CALL(factory_context_.admin_.config_tracker_, add_("routes", _));
     route_config_provider_manager_ =
-        std::make_unique<RouteConfigProviderManagerImpl>(factory_context_.admin_);
+        std::make_unique<RouteConfigProviderManagerImpl>(factory_context_.admin_,
+                                                         factory_context_.scope_);
   }
   ~RdsImplTest() { factory_context_.thread_local_.shutdownThread(); }
 
@@ -406,7 +407,8 @@ public:
   RouteConfigProviderManagerImplTest() {
     EXPECT_CALL(factory_context_.admin_.config_tracker_, add_("routes", _));
     route_config_provider_manager_ =
-        std::make_unique<RouteConfigProviderManagerImpl>(factory_context_.admin_);
+        std::make_unique<RouteConfigProviderManagerImpl>(factory_context_.admin_,
+                                                         factory_context_.scope_);
   }
 
   ~RouteConfigProviderManagerImplTest() { factory_context_.thread_local_.shutdownThread(); }
@@ -614,6 +616,44 @@ virtual_hosts:
             route_config_provider_manager_->dumpRouteConfigs()->dynamic_route_configs().size());
 }
 
+// Route configurations of all providers share identical virtual hosts.
+TEST_F(RouteConfigProviderManagerImplTest, SharedVirtualHosts) {
+  const std::string config_yaml = R"EOF(
+name: {}
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: {{ prefix: "/" }}
+        route: {{ cluster: baz }}
+)EOF";
+
+  RouteConfigProviderPtr static_config =
+      route_config_provider_manager_->createStaticRouteConfigProvider(
+          parseRouteConfigurationFromV2Yaml(fmt::format(config_yaml, "foo")), factory_context_);
+
+  setup();
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> route_configs;
+  route_configs.Add()->PackFrom(
+      parseRouteConfigurationFromV2Yaml(fmt::format(config_yaml, "foo_route_config")));
+  dynamic_cast<RdsRouteConfigProviderImpl&>(*provider_)
+      .subscription()
+      .onConfigUpdate(route_configs, "1");
+
+  Http::TestHeaderMapImpl headers{{":authority", "foo"},
+                                  {":path", "/"},
+                                  {":method", "GET"},
+                                  {"x-forwarded-proto", "http"}};
+  const RouteEntry* static_entry = static_config->config()->route(headers, 0)->routeEntry();
+  const RouteEntry* dynamic_entry = provider_->config()->route(headers, 0)->routeEntry();
+  EXPECT_EQ(&static_entry->retryPolicy(), &dynamic_entry->retryPolicy());
+  EXPECT_EQ("foo", static_entry->virtualHost().routeConfig().name());
+  EXPECT_EQ("foo_route_config", dynamic_entry->virtualHost().routeConfig().name());
+  EXPECT_EQ(1UL, factory_context_.scope_.counter("virtual_host_cache.hit").value());
+  EXPECT_EQ(1UL, factory_context_.scope_.gauge("virtual_host_cache.active").value());
+  EXPECT_EQ(1UL, factory_context_.scope_.gauge("virtual_host_cache.shared").value());
+}
+
 // Negative test for protoc-gen-validate constraints.
 TEST_F(RouteConfigProviderManagerImplTest, ValidateFail) {
   setup();
@@ -649,6 +689,95 @@ TEST_F(RouteConfigProviderManagerImplTest, onConfigUpdateWrongSize) {
                             EnvoyException, "Unexpected RDS resource length: 2");
 }
 
+envoy::api::v2::Resource routeConfigResource(const std::string& name, const std::string& version) {
+  const std::string yaml = fmt::format(R"EOF(
+name: {}
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: {{ prefix: "/" }}
+        route: {{ cluster: baz }}
+)EOF",
+                                       name);
+  envoy::api::v2::Resource resource;
+  resource.set_name(name);
+  resource.set_version(version);
+  resource.mutable_resource()->PackFrom(parseRouteConfigurationFromV2Yaml(yaml));
+  return resource;
+}
+
+// A delta update carrying the route configuration loads it with the resource's own version.
+TEST_F(RouteConfigProviderManagerImplTest, DeltaConfigUpdateAdd) {
+  setup();
+  factory_context_.init_manager_.initialize(init_watcher_);
+  auto& provider_impl = dynamic_cast<RdsRouteConfigProviderImpl&>(*provider_.get());
+  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> added_resources;
+  *added_resources.Add() = routeConfigResource("foo_route_config", "1");
+
+  EXPECT_CALL(init_watcher_, ready());
+  provider_impl.subscription().onConfigUpdate(added_resources, {}, "system1");
+
+  EXPECT_EQ("1", provider_->configInfo().value().version_);
+  Http::TestHeaderMapImpl headers{{":authority", "foo"}, {":path", "/"}, {":method", "GET"}};
+  EXPECT_EQ("baz", provider_->config()->route(headers, 0)->routeEntry()->clusterName());
+  EXPECT_EQ(1UL, factory_context_.scope_.counter("foo_prefix.rds.foo_route_config.config_reload")
+                     .value());
+}
+
+// Removing the watched route configuration, or any other, keeps the loaded configuration.
+TEST_F(RouteConfigProviderManagerImplTest, DeltaConfigUpdateRemove) {
+  setup();
+  factory_context_.init_manager_.initialize(init_watcher_);
+  auto& provider_impl = dynamic_cast<RdsRouteConfigProviderImpl&>(*provider_.get());
+  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> added_resources;
+  *added_resources.Add() = routeConfigResource("foo_route_config", "1");
+  EXPECT_CALL(init_watcher_, ready());
+  provider_impl.subscription().onConfigUpdate(added_resources, {}, "system1");
+
+  Protobuf::RepeatedPtrField<std::string> removed_resources;
+  *removed_resources.Add() = "other_route_config";
+  provider_impl.subscription().onConfigUpdate({}, removed_resources, "system2");
+  *removed_resources.Add() = "foo_route_config";
+  provider_impl.subscription().onConfigUpdate({}, removed_resources, "system3");
+
+  EXPECT_EQ("1", provider_->configInfo().value().version_);
+  Http::TestHeaderMapImpl headers{{":authority", "foo"}, {":path", "/"}, {":method", "GET"}};
+  EXPECT_EQ("baz", provider_->config()->route(headers, 0)->routeEntry()->clusterName());
+  EXPECT_EQ(1UL, factory_context_.scope_.counter("foo_prefix.rds.foo_route_config.config_reload")
+                     .value());
+  EXPECT_EQ(
+      2UL, factory_context_.scope_.counter("foo_prefix.rds.foo_route_config.update_empty").value());
+}
+
+// An invalid resource in a delta update is rejected and the loaded configuration is kept.
+TEST_F(RouteConfigProviderManagerImplTest, DeltaConfigUpdateInvalid) {
+  setup();
+  auto& provider_impl = dynamic_cast<RdsRouteConfigProviderImpl&>(*provider_.get());
+  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> added_resources;
+  *added_resources.Add() = routeConfigResource("foo_route_config", "1");
+  provider_impl.subscription().onConfigUpdate(added_resources, {}, "system1");
+
+  added_resources.Clear();
+  *added_resources.Add() = routeConfigResource("other_route_config", "2");
+  EXPECT_THROW_WITH_MESSAGE(
+      provider_impl.subscription().onConfigUpdate(added_resources, {}, "system2"), EnvoyException,
+      "Unexpected RDS configuration (expecting foo_route_config): other_route_config");
+
+  added_resources.Clear();
+  envoy::api::v2::RouteConfiguration route_config;
+  route_config.set_name("foo_route_config");
+  route_config.mutable_virtual_hosts()->Add();
+  auto* resource = added_resources.Add();
+  resource->set_name("foo_route_config");
+  resource->set_version("3");
+  resource->mutable_resource()->PackFrom(route_config);
+  EXPECT_THROW(provider_impl.subscription().onConfigUpdate(added_resources, {}, "system3"),
+               ProtoValidationException);
+
+  EXPECT_EQ("1", provider_->configInfo().value().version_);
+}
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
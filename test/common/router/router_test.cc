@@ -10,6 +10,7 @@
 #include "common/network/utility.h"
 #include "common/router/config_impl.h"
 #include "common/router/router.h"
+#include "common/stats/scope_prefixer.h"
 #include "common/tracing/http_tracer_impl.h"
 #include "common/upstream/upstream_impl.h"
 
@@ -19,7 +20,9 @@
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/router/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/server/mocks.h"
 #include "test/mocks/ssl/mocks.h"
+#include "test/mocks/stats/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/environment.h"
@@ -78,7 +81,7 @@ class RouterTestBase : public testing::Test {
 public:
   RouterTestBase(bool start_child_span, bool suppress_envoy_headers)
       : shadow_writer_(new MockShadowWriter()),
-        config_("test.", local_info_, stats_store_, cm_, runtime_, random_,
+        config_("test.", local_info_, stats_store_, stats_store_, cm_, runtime_, random_,
                 ShadowWriterPtr{shadow_writer_}, true, start_child_span, suppress_envoy_headers,
                 test_time_.timeSystem(), http_context_),
         router_(config_) {
@@ -217,7 +220,7 @@ public:
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
   Http::ConnectionPool::MockCancellable cancellable_;
-  Http::ContextImpl http_context_;
+  Http::ContextImpl http_context_{stats_store_.symbolTable()};
   NiceMock<Http::MockStreamDecoderFilterCallbacks> callbacks_;
   MockShadowWriter* shadow_writer_;
   NiceMock<LocalInfo::MockLocalInfo> local_info_;
@@ -2237,6 +2240,28 @@ TEST_F(RouterTest, AltStatName) {
                     .value());
 }
 
+// The router filters of a server share one evictable scope for their virtual cluster stats, so that
+// a stat incremented by several of them has one object, which reports their total.
+TEST_F(RouterTest, VirtualClusterStatsScopeIsShared) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  NiceMock<Stats::MockStore> store;
+  NiceMock<Stats::MockIsolatedStatsStore> vcluster_store;
+  ON_CALL(context, scope()).WillByDefault(ReturnRef(store));
+  EXPECT_CALL(store, createScope_(""))
+      .WillOnce(Invoke([&](const std::string& name) -> Stats::Scope* {
+        return new Stats::ScopePrefixer(name, vcluster_store);
+      }));
+  envoy::config::filter::http::router::v2::Router proto_config;
+  FilterConfig config1("test1.", context, ShadowWriterPtr{new MockShadowWriter()}, proto_config);
+  FilterConfig config2("test2.", context, ShadowWriterPtr{new MockShadowWriter()}, proto_config);
+  EXPECT_EQ(&config1.vclusterScope(), &config2.vclusterScope());
+
+  const std::string name = "vhost.fake_vhost.vcluster.fake_virtual_cluster.upstream_rq_200";
+  config1.vclusterScope().counter(name).inc();
+  config2.vclusterScope().counter(name).inc();
+  EXPECT_EQ(2U, TestUtility::findCounter(vcluster_store, name)->value());
+}
+
 TEST_F(RouterTest, Redirect) {
   MockDirectResponseEntry direct_response;
   EXPECT_CALL(direct_response, newPath(_)).WillOnce(Return("hello"));
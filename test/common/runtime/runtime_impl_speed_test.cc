@@ -0,0 +1,96 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "common/common/fmt.h"
+#include "common/runtime/key_registry.h"
+#include "common/runtime/runtime_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Runtime {
+
+// A snapshot with 1000 values, and 24 keys looked up per request as the router, connection manager
+// and outlier detection would. Most runtime keys are usually unset, so only one in four of the
+// looked up keys has a value.
+class SnapshotPerf {
+public:
+  SnapshotPerf()
+      : stats_{ALL_RUNTIME_STATS(POOL_COUNTER_PREFIX(store_, "runtime."),
+                                 POOL_GAUGE_PREFIX(store_, "runtime."))},
+        admin_layer_(stats_) {
+    std::unordered_map<std::string, std::string> values;
+    for (uint32_t i = 0; i < 1000; ++i) {
+      values.emplace(fmt::format("perf.feature_{}.value", i * 4), "50");
+    }
+    admin_layer_.mergeValues(values);
+    for (uint32_t i = 0; i < 24; ++i) {
+      names_.push_back(fmt::format("perf.feature_{}.value", i));
+      keys_.push_back(KeyRegistrySingleton::get().resolve(names_.back()));
+    }
+    std::vector<Snapshot::OverrideLayerConstPtr> layers;
+    layers.push_back(std::make_unique<const AdminLayer>(admin_layer_));
+    snapshot_ = std::make_unique<SnapshotImpl>(generator_, stats_, std::move(layers));
+  }
+
+  // Looks up every key by name, as a request would, and returns the sum of the results.
+  uint64_t lookUpByName(uint64_t random_value) const {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < names_.size(); i += 2) {
+      sum += snapshot_->getInteger(names_[i], 10);
+      sum += snapshot_->featureEnabled(names_[i + 1], 10, random_value);
+    }
+    return sum;
+  }
+
+  uint64_t lookUpByKey(uint64_t random_value) const {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < keys_.size(); i += 2) {
+      sum += snapshot_->getInteger(keys_[i], 10);
+      sum += snapshot_->featureEnabled(keys_[i + 1], 10, random_value);
+    }
+    return sum;
+  }
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  RuntimeStats stats_;
+  RandomGeneratorImpl generator_;
+  AdminLayer admin_layer_;
+  std::vector<std::string> names_;
+  std::vector<Key> keys_;
+  std::unique_ptr<SnapshotImpl> snapshot_;
+};
+
+} // namespace Runtime
+} // namespace Envoy
+
+static void BM_LookUpByName(benchmark::State& state) {
+  Envoy::Runtime::SnapshotPerf context;
+  uint64_t random_value = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(context.lookUpByName(random_value++));
+  }
+  state.SetItemsProcessed(state.iterations() * 24);
+}
+BENCHMARK(BM_LookUpByName);
+
+static void BM_LookUpByKey(benchmark::State& state) {
+  Envoy::Runtime::SnapshotPerf context;
+  uint64_t random_value = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(context.lookUpByKey(random_value++));
+  }
+  state.SetItemsProcessed(state.iterations() * 24);
+}
+BENCHMARK(BM_LookUpByKey);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
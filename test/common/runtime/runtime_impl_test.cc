@@ -1,6 +1,7 @@
 #include <memory>
 #include <string>
 
+#include "common/runtime/key_registry.h"
 #include "common/runtime/runtime_impl.h"
 #include "common/stats/isolated_store_impl.h"
 
@@ -326,6 +327,57 @@ TEST(LoaderImplTest, All) {
   testNewOverrides(loader, store);
 }
 
+TEST(KeyRegistryTest, Resolve) {
+  KeyRegistry registry;
+  const Key foo = registry.resolve("foo");
+  const Key bar = registry.resolve("bar");
+  EXPECT_EQ("foo", foo.name());
+  EXPECT_EQ(0, foo.index());
+  EXPECT_EQ(1, bar.index());
+  EXPECT_EQ(0, registry.resolve("foo").index());
+  ASSERT_EQ(2, registry.keys().size());
+  EXPECT_EQ("bar", registry.keys()[1].name());
+}
+
+// Values looked up by key match those looked up by name, whether the key was registered before or
+// after the snapshot was created.
+TEST(LoaderImplTest, Keys) {
+  MockRandomGenerator generator;
+  NiceMock<ThreadLocal::MockInstance> tls;
+  Stats::IsolatedStoreImpl store;
+  LoaderImpl loader(generator, store, tls);
+
+  const Key integer = KeyRegistrySingleton::get().resolve("keys_test.integer");
+  const Key percent = KeyRegistrySingleton::get().resolve("keys_test.percent");
+  const Key missing = KeyRegistrySingleton::get().resolve("keys_test.missing");
+  loader.mergeValues(
+      {{"keys_test.integer", "20"}, {"keys_test.percent", "5"}, {"keys_test.late", "30"}});
+  const Key late = KeyRegistrySingleton::get().resolve("keys_test.late");
+
+  Snapshot& snapshot = loader.snapshot();
+  EXPECT_EQ(20, snapshot.getInteger(integer, 1));
+  EXPECT_EQ(30, snapshot.getInteger(late, 1));
+  EXPECT_EQ(1, snapshot.getInteger(missing, 1));
+
+  EXPECT_TRUE(snapshot.featureEnabled(integer, 0, 19));
+  EXPECT_FALSE(snapshot.featureEnabled(integer, 0, 20));
+  EXPECT_TRUE(snapshot.featureEnabled(late, 0, 29, 1000));
+  EXPECT_FALSE(snapshot.featureEnabled(late, 0, 30, 1000));
+  EXPECT_TRUE(snapshot.featureEnabled(missing, 100));
+  EXPECT_CALL(generator, random()).WillOnce(Return(19)).WillOnce(Return(20));
+  EXPECT_TRUE(snapshot.featureEnabled(integer, 0));
+  EXPECT_FALSE(snapshot.featureEnabled(integer, 0));
+
+  envoy::type::FractionalPercent default_value;
+  default_value.set_numerator(50);
+  EXPECT_TRUE(snapshot.featureEnabled(percent, default_value, 4));
+  EXPECT_FALSE(snapshot.featureEnabled(percent, default_value, 5));
+  EXPECT_TRUE(snapshot.featureEnabled(missing, default_value, 49));
+  EXPECT_FALSE(snapshot.featureEnabled(missing, default_value, 50));
+  EXPECT_CALL(generator, random()).WillOnce(Return(4));
+  EXPECT_TRUE(snapshot.featureEnabled(percent, default_value));
+}
+
 class DiskLayerTest : public testing::Test {
 protected:
   DiskLayerTest() : api_(Api::createApiForTest()) {}
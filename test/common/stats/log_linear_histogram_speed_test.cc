@@ -0,0 +1,111 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// NOLINT(namespace-envoy)
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common/stats/log_linear_histogram.h"
+
+#include "benchmark/benchmark.h"
+#include "circllhist.h"
+
+namespace {
+
+// Latency-like samples, spread evenly over the orders of magnitude between 1 and 10^5.
+std::vector<uint64_t> sampleValues() {
+  std::mt19937_64 random(1);
+  std::uniform_real_distribution<double> exponent(0, 5);
+  std::vector<uint64_t> values(1024);
+  for (uint64_t& value : values) {
+    value = static_cast<uint64_t>(std::pow(10.0, exponent(random)));
+  }
+  return values;
+}
+
+const uint32_t PrecisionBits = 5;
+
+} // namespace
+
+static void BM_RecordCircllhist(benchmark::State& state) {
+  const std::vector<uint64_t> values = sampleValues();
+  histogram_t* histogram = hist_alloc();
+  size_t i = 0;
+  for (auto _ : state) {
+    hist_insert_intscale(histogram, values[i++ & 1023], 0, 1);
+  }
+  hist_free(histogram);
+}
+BENCHMARK(BM_RecordCircllhist);
+
+static void BM_RecordLogLinear(benchmark::State& state) {
+  const std::vector<uint64_t> values = sampleValues();
+  Envoy::Stats::LogLinearHistogram histogram(PrecisionBits);
+  size_t i = 0;
+  for (auto _ : state) {
+    histogram.recordValue(values[i++ & 1023]);
+  }
+  benchmark::DoNotOptimize(histogram.sampleCount());
+}
+BENCHMARK(BM_RecordLogLinear);
+
+// Merges one histogram per worker into an interval histogram, and that into a cumulative one, as
+// ParentHistogramImpl::merge does at each flush. The worker histograms are not cleared, so that
+// every iteration merges the same data.
+static void BM_MergeCircllhist(benchmark::State& state) {
+  const std::vector<uint64_t> values = sampleValues();
+  std::vector<histogram_t*> workers(state.range(0));
+  for (histogram_t*& worker : workers) {
+    worker = hist_alloc();
+    for (uint64_t value : values) {
+      hist_insert_intscale(worker, value, 0, 1);
+    }
+  }
+  histogram_t* interval = hist_alloc();
+  histogram_t* cumulative = hist_alloc();
+  for (auto _ : state) {
+    hist_clear(interval);
+    hist_accumulate(interval, workers.data(), workers.size());
+    hist_accumulate(cumulative, &interval, 1);
+  }
+  hist_free(interval);
+  hist_free(cumulative);
+  for (histogram_t* worker : workers) {
+    hist_free(worker);
+  }
+}
+BENCHMARK(BM_MergeCircllhist)->Arg(1)->Arg(16)->Arg(64);
+
+static void BM_MergeLogLinear(benchmark::State& state) {
+  const std::vector<uint64_t> values = sampleValues();
+  std::vector<std::unique_ptr<Envoy::Stats::LogLinearHistogram>> workers(state.range(0));
+  for (auto& worker : workers) {
+    worker = std::make_unique<Envoy::Stats::LogLinearHistogram>(PrecisionBits);
+    for (uint64_t value : values) {
+      worker->recordValue(value);
+    }
+  }
+  Envoy::Stats::LogLinearHistogram interval(PrecisionBits);
+  Envoy::Stats::LogLinearHistogram cumulative(PrecisionBits);
+  for (auto _ : state) {
+    interval.clear();
+    for (const auto& worker : workers) {
+      interval.merge(*worker);
+    }
+    cumulative.merge(interval);
+  }
+  benchmark::DoNotOptimize(cumulative.sampleCount());
+}
+BENCHMARK(BM_MergeLogLinear)->Arg(1)->Arg(16)->Arg(64);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
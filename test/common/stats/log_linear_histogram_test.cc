@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "common/stats/histogram_impl.h"
+#include "common/stats/log_linear_histogram.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+
+TEST(LogLinearHistogramTest, Empty) {
+  LogLinearHistogram histogram(5);
+  EXPECT_EQ(0, histogram.sampleCount());
+  EXPECT_EQ(0, histogram.sampleSum());
+  EXPECT_TRUE(std::isnan(histogram.quantile(0.5)));
+  EXPECT_EQ(0, histogram.countBelow(100));
+}
+
+// Values below 2^(precision_bits+1) have a bucket each, so they are reported exactly.
+TEST(LogLinearHistogramTest, SmallValuesAreExact) {
+  LogLinearHistogram histogram(3);
+  for (uint64_t value = 0; value < 16; ++value) {
+    histogram.recordValue(value);
+  }
+  EXPECT_EQ(16, histogram.sampleCount());
+  EXPECT_EQ(120, histogram.sampleSum());
+  EXPECT_EQ(0, histogram.quantile(0));
+  EXPECT_EQ(15, histogram.quantile(1));
+  EXPECT_EQ(7, histogram.quantile(0.5));
+  for (uint64_t value = 0; value <= 16; ++value) {
+    EXPECT_EQ(value, histogram.countBelow(value));
+  }
+  EXPECT_EQ(1, histogram.countBelow(0.5));
+}
+
+TEST(LogLinearHistogramTest, SingleValue) {
+  LogLinearHistogram histogram(5);
+  histogram.recordValue(1000);
+  // 1000 falls in [992, 1007], a bucket 16 wide.
+  EXPECT_EQ(992, histogram.quantile(0));
+  EXPECT_EQ(1007, histogram.quantile(1));
+  EXPECT_EQ(0, histogram.countBelow(992));
+  EXPECT_EQ(1, histogram.countBelow(1008));
+}
+
+TEST(LogLinearHistogramTest, LargestValues) {
+  LogLinearHistogram histogram(2);
+  histogram.recordValue(std::numeric_limits<uint64_t>::max());
+  histogram.recordValue(uint64_t(1) << 63);
+  EXPECT_EQ(2, histogram.sampleCount());
+  EXPECT_DOUBLE_EQ(std::ldexp(1.0, 63), histogram.quantile(0));
+  EXPECT_DOUBLE_EQ(std::ldexp(1.0, 64), histogram.quantile(1));
+}
+
+// The estimate of every quantile lies in the bucket of the sample at that rank, so its relative
+// error is bounded by the precision.
+TEST(LogLinearHistogramTest, RelativeErrorIsBounded) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<double> exponent(0, 40);
+  std::vector<uint64_t> values;
+  for (uint32_t i = 0; i < 10000; ++i) {
+    values.push_back(static_cast<uint64_t>(std::pow(2.0, exponent(random))));
+  }
+  std::vector<uint64_t> sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+
+  const std::vector<double> quantiles = {0, 0.25, 0.5, 0.75, 0.9, 0.95, 0.99, 0.995, 0.999, 1};
+  for (uint32_t precision = LogLinearHistogram::MinPrecisionBits;
+       precision <= LogLinearHistogram::MaxPrecisionBits; ++precision) {
+    LogLinearHistogram histogram(precision);
+    for (uint64_t value : values) {
+      histogram.recordValue(value);
+    }
+    std::vector<double> computed;
+    histogram.quantiles(quantiles, computed);
+    for (size_t i = 0; i < quantiles.size(); ++i) {
+      const double rank = std::ceil(quantiles[i] * sorted.size());
+      const double expected = sorted[std::max(rank, 1.0) - 1];
+      EXPECT_LE(std::abs(computed[i] - expected),
+                expected * LogLinearHistogram::maxRelativeError(precision))
+          << "precision " << precision << " quantile " << quantiles[i];
+      EXPECT_DOUBLE_EQ(computed[i], histogram.quantile(quantiles[i]));
+    }
+  }
+}
+
+TEST(LogLinearHistogramTest, MergeMatchesSingleHistogram) {
+  LogLinearHistogram all(4), first(4), second(4), merged(4);
+  for (uint64_t value = 0; value < 100000; value += 7) {
+    all.recordValue(value);
+    (value % 2 == 0 ? first : second).recordValue(value);
+  }
+  merged.merge(first);
+  merged.merge(second);
+
+  EXPECT_EQ(all.sampleCount(), merged.sampleCount());
+  EXPECT_EQ(all.sampleSum(), merged.sampleSum());
+  for (double q : {0.0, 0.1, 0.5, 0.9, 0.99, 1.0}) {
+    EXPECT_EQ(all.quantile(q), merged.quantile(q));
+  }
+  for (double threshold : {0.5, 10.0, 1000.0, 50000.0, 1e6}) {
+    EXPECT_EQ(all.countBelow(threshold), merged.countBelow(threshold));
+  }
+}
+
+TEST(LogLinearHistogramTest, ClearKeepsHistogramUsable) {
+  LogLinearHistogram histogram(5), target(5);
+  histogram.recordValue(1);
+  histogram.recordValue(1000000);
+  histogram.clear();
+  EXPECT_EQ(0, histogram.sampleCount());
+  EXPECT_EQ(0, histogram.sampleSum());
+  EXPECT_TRUE(std::isnan(histogram.quantile(0)));
+
+  // Cleared ranges are not merged.
+  histogram.recordValue(5);
+  target.merge(histogram);
+  EXPECT_EQ(1, target.sampleCount());
+  EXPECT_EQ(5, target.quantile(0));
+  EXPECT_EQ(5, target.quantile(1));
+  EXPECT_EQ(1, target.countBelow(1e9));
+}
+
+// A bucket straddling the threshold contributes in proportion to the integers below it.
+TEST(LogLinearHistogramTest, CountBelowInterpolates) {
+  LogLinearHistogram histogram(2);
+  // [16, 19] is a single bucket at this precision.
+  for (uint32_t i = 0; i < 4; ++i) {
+    histogram.recordValue(16);
+  }
+  EXPECT_EQ(0, histogram.countBelow(16));
+  EXPECT_EQ(1, histogram.countBelow(17));
+  EXPECT_EQ(2, histogram.countBelow(17.5));
+  EXPECT_EQ(3, histogram.countBelow(19));
+  EXPECT_EQ(4, histogram.countBelow(20));
+}
+
+TEST(LogLinearHistogramTest, Statistics) {
+  LogLinearHistogram histogram(6);
+  for (uint64_t value = 1; value <= 100; ++value) {
+    histogram.recordValue(value);
+  }
+  HistogramStatisticsImpl statistics;
+  statistics.refresh(histogram);
+  EXPECT_EQ(100, statistics.sampleCount());
+  EXPECT_EQ(5050, statistics.sampleSum());
+  EXPECT_EQ(1, statistics.computedQuantiles().front());
+  EXPECT_EQ(100, statistics.computedQuantiles().back());
+  EXPECT_EQ(50, statistics.computedQuantiles()[2]);
+  ASSERT_EQ(statistics.supportedBuckets().size(), statistics.computedBuckets().size());
+  // Buckets 0.5, 1, 5, 10, 25, 50 and 100.
+  const std::vector<uint64_t> expected_buckets = {0, 0, 4, 9, 24, 49, 99};
+  for (size_t i = 0; i < expected_buckets.size(); ++i) {
+    EXPECT_EQ(expected_buckets[i], statistics.computedBuckets()[i]);
+  }
+  EXPECT_EQ(100, statistics.computedBuckets().back());
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,72 @@
+#include <memory>
+#include <string>
+
+#include "common/stats/metric_flush_cache.h"
+
+#include "test/mocks/stats/mocks.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+TEST(MetricFlushCacheTest, KeepsEntriesOfMetricsSeenInEachFlush) {
+  MetricFlushCache<std::string> cache;
+  auto counter1 = std::make_shared<MockCounter>();
+  auto counter2 = std::make_shared<MockCounter>();
+  bool is_new;
+
+  cache.beginFlush();
+  cache.get(counter1, is_new) = "c1";
+  EXPECT_TRUE(is_new);
+  cache.get(counter2, is_new) = "c2";
+  EXPECT_TRUE(is_new);
+  // A metric seen twice in one flush is only counted once.
+  EXPECT_EQ("c1", cache.get(counter1, is_new));
+  EXPECT_FALSE(is_new);
+  cache.endFlush();
+  EXPECT_EQ(2U, cache.size());
+
+  // counter2 is not seen, so its entry is dropped.
+  cache.beginFlush();
+  EXPECT_EQ("c1", cache.get(counter1, is_new));
+  EXPECT_FALSE(is_new);
+  cache.endFlush();
+  EXPECT_EQ(1U, cache.size());
+
+  cache.beginFlush();
+  EXPECT_EQ("", cache.get(counter2, is_new));
+  EXPECT_TRUE(is_new);
+  cache.endFlush();
+  EXPECT_EQ(1U, cache.size());
+
+  cache.clear();
+  EXPECT_EQ(0U, cache.size());
+}
+
+TEST(MetricFlushCacheTest, ResetsEntryOfMetricAtReusedAddress) {
+  MetricFlushCache<std::string> cache;
+  // Two metrics that share an address, as when a metric is freed and another is allocated in its
+  // place.
+  MockCounter storage;
+  auto no_delete = [](const Metric*) {};
+  std::shared_ptr<const Metric> old_metric(&storage, no_delete);
+  bool is_new;
+
+  cache.beginFlush();
+  cache.get(old_metric, is_new) = "old";
+  cache.endFlush();
+  old_metric.reset();
+
+  std::shared_ptr<const Metric> new_metric(&storage, no_delete);
+  cache.beginFlush();
+  EXPECT_EQ("", cache.get(new_metric, is_new));
+  EXPECT_TRUE(is_new);
+  cache.endFlush();
+  EXPECT_EQ(1U, cache.size());
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,170 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common/fmt.h"
+#include "common/common/thread.h"
+#include "common/stats/fake_symbol_table_impl.h"
+#include "common/stats/raw_stat_data_arena.h"
+
+#include "test/test_common/logging.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+const uint64_t SegmentSize = 4096;
+
+// Segments are heap buffers shared by all the arenas of a test, which stand in for the processes
+// attached to the same shared memory.
+class RawStatDataArenaTest : public testing::Test {
+public:
+  std::unique_ptr<RawStatDataArena> makeArena(bool init) {
+    return std::make_unique<RawStatDataArena>(
+        SegmentSize, init, [this](uint32_t index, uint64_t size, bool create) -> uint8_t* {
+          EXPECT_EQ(SegmentSize, size);
+          if (create) {
+            if (index >= max_segments_) {
+              return nullptr;
+            }
+            EXPECT_EQ(index, segments_.size());
+            segments_.emplace_back(new uint64_t[size / sizeof(uint64_t)]());
+          }
+          EXPECT_LT(index, segments_.size());
+          return reinterpret_cast<uint8_t*>(segments_[index].get());
+        });
+  }
+
+  uint32_t max_segments_{100};
+  std::vector<std::unique_ptr<uint64_t[]>> segments_;
+};
+
+TEST_F(RawStatDataArenaTest, InsertAndRemove) {
+  std::unique_ptr<RawStatDataArena> arena = makeArena(true);
+  RawStatDataArena::StatCreatedPair a = arena->insert("a");
+  ASSERT_NE(nullptr, a.first);
+  EXPECT_TRUE(a.second);
+  EXPECT_EQ("a", a.first->key());
+  EXPECT_EQ(1, a.first->ref_count_);
+  EXPECT_EQ(a.first, arena->insert("a").first);
+  EXPECT_FALSE(arena->insert("a").second);
+
+  RawStatData* b = arena->insert("b").first;
+  EXPECT_NE(a.first, b);
+
+  // A freed stat of the same size is reused.
+  a.first->ref_count_ = 0;
+  arena->remove(*a.first);
+  RawStatDataArena::StatCreatedPair c = arena->insert("c");
+  EXPECT_TRUE(c.second);
+  EXPECT_EQ(a.first, c.first);
+  EXPECT_EQ("c", c.first->key());
+  EXPECT_EQ(0, c.first->value_);
+}
+
+TEST_F(RawStatDataArenaTest, Grow) {
+  std::unique_ptr<RawStatDataArena> arena = makeArena(true);
+  std::vector<RawStatData*> stats;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    stats.push_back(arena->insert(fmt::format("cluster.service_{}.upstream_rq_total", i)).first);
+    ASSERT_NE(nullptr, stats.back());
+    stats.back()->value_ = i;
+  }
+  EXPECT_LT(1, arena->numSegments());
+  EXPECT_EQ(arena->numSegments(), segments_.size());
+
+  // Stats do not move as the arena grows.
+  for (uint32_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(stats[i], arena->insert(fmt::format("cluster.service_{}.upstream_rq_total", i)).first);
+    EXPECT_EQ(i, stats[i]->value_);
+  }
+}
+
+TEST_F(RawStatDataArenaTest, GrowFailure) {
+  max_segments_ = 1;
+  std::unique_ptr<RawStatDataArena> arena = makeArena(true);
+  RawStatData* stat{};
+  for (uint32_t i = 0; i < 1000; ++i) {
+    stat = arena->insert(fmt::format("stat_{}", i)).first;
+    if (stat == nullptr) {
+      break;
+    }
+  }
+  EXPECT_EQ(nullptr, stat);
+  EXPECT_EQ(1, arena->numSegments());
+}
+
+TEST_F(RawStatDataArenaTest, Truncate) {
+  std::unique_ptr<RawStatDataArena> arena = makeArena(true);
+  const std::string long_string(SegmentSize, 'A');
+  RawStatData* stat{};
+  EXPECT_LOG_CONTAINS("warning", " is too long ", stat = arena->insert(long_string).first);
+  ASSERT_NE(nullptr, stat);
+  EXPECT_NE(long_string, stat->key());
+  EXPECT_EQ(stat, arena->insert(long_string + " ignored").first);
+}
+
+// A second arena attached to the same segments, as after a hot restart, sees the stats of the
+// first one and those it creates later, including in new segments.
+TEST_F(RawStatDataArenaTest, Attach) {
+  std::unique_ptr<RawStatDataArena> parent = makeArena(true);
+  RawStatData* a = parent->insert("a").first;
+
+  std::unique_ptr<RawStatDataArena> child = makeArena(false);
+  EXPECT_EQ(a, child->insert("a").first);
+
+  std::vector<RawStatData*> stats;
+  for (uint32_t i = 0; i < 500; ++i) {
+    stats.push_back(parent->insert(fmt::format("stat_{}", i)).first);
+  }
+  EXPECT_LT(1, parent->numSegments());
+  for (uint32_t i = 0; i < 500; ++i) {
+    RawStatDataArena::StatCreatedPair stat = child->insert(fmt::format("stat_{}", i));
+    EXPECT_EQ(stats[i], stat.first);
+    EXPECT_FALSE(stat.second);
+  }
+  EXPECT_EQ(parent->numSegments(), child->numSegments());
+
+  // A stat freed by one process and reused under another name by the other is found by both.
+  a->ref_count_ = 0;
+  parent->remove(*a);
+  RawStatData* b = child->insert("b").first;
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(b, parent->insert("b").first);
+  EXPECT_TRUE(parent->insert("a").second);
+  EXPECT_FALSE(child->insert("a").second);
+}
+
+TEST_F(RawStatDataArenaTest, IncompatibleSegmentSize) {
+  makeArena(true);
+  EXPECT_THROW_WITH_MESSAGE(
+      RawStatDataArena(2 * SegmentSize, false,
+                       [this](uint32_t index, uint64_t, bool) -> uint8_t* {
+                         return reinterpret_cast<uint8_t*>(segments_[index].get());
+                       }),
+      EnvoyException, "RawStatDataArena: Incompatible memory block");
+}
+
+TEST_F(RawStatDataArenaTest, Allocator) {
+  std::unique_ptr<RawStatDataArena> arena = makeArena(true);
+  Thread::MutexBasicLockable mutex;
+  FakeSymbolTableImpl symbol_table;
+  RawStatDataArenaAllocator allocator(mutex, *arena, symbol_table);
+  EXPECT_FALSE(allocator.requiresBoundedStatNameSize());
+
+  RawStatData* stat_1 = allocator.alloc("ref_name");
+  RawStatData* stat_2 = allocator.alloc("ref_name");
+  EXPECT_EQ(stat_1, stat_2);
+  EXPECT_EQ(2, stat_1->ref_count_);
+  allocator.free(*stat_1);
+  EXPECT_TRUE(stat_1->initialized());
+  allocator.free(*stat_2);
+  EXPECT_FALSE(stat_1->initialized());
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
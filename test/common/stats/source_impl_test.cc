@@ -7,6 +7,7 @@
 #include "gtest/gtest.h"
 
 using testing::NiceMock;
+using testing::Return;
 using testing::ReturnPointee;
 
 namespace Envoy {
@@ -48,6 +49,85 @@ TEST(SourceImplTest, Caching) {
   EXPECT_EQ(source.cachedHistograms(), stored_histograms);
 }
 
+TEST(SourceSnapshotImplTest, CapturesStore) {
+  NiceMock<MockStore> store;
+  std::vector<CounterSharedPtr> stored_counters{std::make_shared<NiceMock<MockCounter>>()};
+  std::vector<GaugeSharedPtr> stored_gauges{std::make_shared<NiceMock<MockGauge>>()};
+  std::vector<ParentHistogramSharedPtr> stored_histograms{
+      std::make_shared<NiceMock<MockParentHistogram>>()};
+
+  EXPECT_CALL(store, counters()).WillOnce(ReturnPointee(&stored_counters));
+  EXPECT_CALL(store, gauges()).WillOnce(ReturnPointee(&stored_gauges));
+  EXPECT_CALL(store, histograms()).WillOnce(ReturnPointee(&stored_histograms));
+
+  SourceSnapshotImpl snapshot(store);
+  stored_counters.push_back(std::make_shared<MockCounter>());
+  stored_gauges.clear();
+  stored_histograms.clear();
+
+  // Clearing the cache does not refresh a snapshot.
+  snapshot.clearCache();
+  EXPECT_EQ(1, snapshot.cachedCounters().size());
+  EXPECT_EQ(1, snapshot.cachedGauges().size());
+  EXPECT_EQ(1, snapshot.cachedHistograms().size());
+}
+
+TEST(SourceSnapshotImplTest, CapturesValues) {
+  NiceMock<MockStore> store;
+  auto counter = std::make_shared<NiceMock<MockCounter>>();
+  counter->name_ = "counter";
+  counter->used_ = true;
+  counter->value_ = 5;
+  auto gauge = std::make_shared<NiceMock<MockGauge>>();
+  gauge->name_ = "gauge";
+  gauge->used_ = true;
+  gauge->value_ = 7;
+  auto histogram = std::make_shared<NiceMock<MockParentHistogram>>();
+  histogram->name_ = "histogram";
+  histogram->used_ = true;
+  std::vector<CounterSharedPtr> stored_counters{counter};
+  std::vector<GaugeSharedPtr> stored_gauges{gauge};
+  std::vector<ParentHistogramSharedPtr> stored_histograms{histogram};
+  ON_CALL(store, counters()).WillByDefault(ReturnPointee(&stored_counters));
+  ON_CALL(store, gauges()).WillByDefault(ReturnPointee(&stored_gauges));
+  ON_CALL(store, histograms()).WillByDefault(ReturnPointee(&stored_histograms));
+
+  // The counter is latched once, when the snapshot is taken.
+  EXPECT_CALL(*counter, latch()).WillOnce(Return(3));
+  SourceSnapshotImpl snapshot(store);
+  counter->used_ = false;
+  counter->value_ = 6;
+  gauge->used_ = false;
+  gauge->value_ = 8;
+  histogram->used_ = false;
+
+  Counter& snapshot_counter = *snapshot.cachedCounters()[0];
+  EXPECT_EQ("counter", snapshot_counter.name());
+  EXPECT_TRUE(snapshot_counter.used());
+  EXPECT_EQ(5, snapshot_counter.value());
+  EXPECT_EQ(3, snapshot_counter.latch());
+  EXPECT_EQ(3, snapshot_counter.latch());
+
+  const Gauge& snapshot_gauge = *snapshot.cachedGauges()[0];
+  EXPECT_EQ("gauge", snapshot_gauge.name());
+  EXPECT_TRUE(snapshot_gauge.used());
+  EXPECT_EQ(7, snapshot_gauge.value());
+
+  // The statistics are copied, so the histogram can be merged while the snapshot is read.
+  const ParentHistogram& snapshot_histogram = *snapshot.cachedHistograms()[0];
+  EXPECT_EQ("histogram", snapshot_histogram.name());
+  EXPECT_TRUE(snapshot_histogram.used());
+  EXPECT_NE(&histogram->intervalStatistics(), &snapshot_histogram.intervalStatistics());
+  EXPECT_NE(&histogram->cumulativeStatistics(), &snapshot_histogram.cumulativeStatistics());
+  EXPECT_EQ(histogram->intervalStatistics().computedQuantiles(),
+            snapshot_histogram.intervalStatistics().computedQuantiles());
+  EXPECT_EQ(histogram->cumulativeStatistics().computedBuckets(),
+            snapshot_histogram.cumulativeStatistics().computedBuckets());
+  EXPECT_EQ(parentHistogramQuantileSummary(histogram->intervalStatistics(),
+                                           histogram->cumulativeStatistics()),
+            snapshot_histogram.quantileSummary());
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
@@ -0,0 +1,69 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// NOLINT(namespace-envoy)
+
+#include <string>
+#include <vector>
+
+#include "envoy/config/metrics/v2/stats.pb.h"
+
+#include "common/stats/tag_producer_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+// A mix of stat names typical of a proxy with HTTP listeners, gRPC clusters and Mongo and
+// DynamoDB filters. Only some of them carry tags beyond the cluster or listener name.
+const std::vector<std::string> stat_names = {
+    "cluster.service_a.upstream_rq_total",
+    "cluster.service_a.upstream_rq_200",
+    "cluster.service_a.upstream_rq_time",
+    "cluster.service_a.grpc.helloworld.Greeter.SayHello.success",
+    "cluster.service_a.grpc.helloworld.Greeter.SayHello.total",
+    "cluster.service_a.ssl.ciphers.ECDHE-RSA-AES128-GCM-SHA256",
+    "cluster.service_a.outlier_detection.ejections_active",
+    "http.ingress_http.downstream_rq_total",
+    "http.ingress_http.downstream_rq_2xx",
+    "http.ingress_http.user_agent.ios.downstream_cx_total",
+    "http.ingress_http.fault.service_b.aborts_injected",
+    "http.ingress_http.rds.route_config_0.update_success",
+    "http.ingress_http.dynamodb.table.locations.upstream_rq_time_2xx",
+    "http.ingress_http.dynamodb.operation.GetItem.upstream_rq_total",
+    "listener.0.0.0.0_443.ssl.cipher.AES256-SHA",
+    "listener.0.0.0.0_443.http.ingress_http.downstream_rq_2xx",
+    "listener.0.0.0.0_443.downstream_cx_total",
+    "mongo.mongo_filter.collection.test.query.total",
+    "mongo.mongo_filter.cmd.foo_cmd.reply_size",
+    "vhost.vhost_0.vcluster.vcluster_0.upstream_rq_time",
+    "server.uptime",
+    "runtime.load_success",
+};
+
+} // namespace
+
+static void BM_ProduceTags(benchmark::State& state) {
+  Envoy::Stats::TagProducerImpl tag_producer{envoy::config::metrics::v2::StatsConfig()};
+  size_t num_tags = 0;
+  for (auto _ : state) {
+    for (const std::string& stat_name : stat_names) {
+      std::vector<Envoy::Stats::Tag> tags;
+      benchmark::DoNotOptimize(tag_producer.produceTags(stat_name, tags));
+      num_tags += tags.size();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * stat_names.size());
+  state.counters["tags"] =
+      static_cast<double>(num_tags) / (state.iterations() * stat_names.size());
+}
+BENCHMARK(BM_ProduceTags);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -55,5 +55,35 @@ TEST(TagProducerTest, CheckConstructor) {
       "No regex specified for tag specifier and no default regex for name: 'test_extractor'");
 }
 
+// Custom regexes are screened by the regex set, except those RE2 can't compile, like the
+// backreference below, which run on every stat name.
+TEST(TagProducerTest, CustomRegexes) {
+  envoy::config::metrics::v2::StatsConfig stats_config;
+  stats_config.mutable_use_all_default_tags()->set_value(false);
+  auto& screened = *stats_config.mutable_stats_tags()->Add();
+  screened.set_tag_name("screened");
+  screened.set_regex("^foo(?=\\.).*?\\.((\\w+?)\\.)bar$");
+  auto& unscreened = *stats_config.mutable_stats_tags()->Add();
+  unscreened.set_tag_name("unscreened");
+  unscreened.set_regex("((\\w)\\2\\2\\.)");
+  TagProducerImpl producer{stats_config};
+
+  std::vector<Tag> tags;
+  EXPECT_EQ("foo.x.bar", producer.produceTags("foo.x.value.bar", tags));
+  ASSERT_EQ(1, tags.size());
+  EXPECT_EQ("screened", tags[0].name_);
+  EXPECT_EQ("value", tags[0].value_);
+
+  tags.clear();
+  EXPECT_EQ("abc.", producer.produceTags("abc.ddd.", tags));
+  ASSERT_EQ(1, tags.size());
+  EXPECT_EQ("unscreened", tags[0].name_);
+  EXPECT_EQ("d", tags[0].value_);
+
+  tags.clear();
+  EXPECT_EQ("foobar.x.bar", producer.produceTags("foobar.x.bar", tags));
+  EXPECT_TRUE(tags.empty());
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -1,9 +1,11 @@
 // Note: this should be run with --compilation_mode=opt, and would benefit from a
 // quiescent system with disabled cstate power management.
 
+#include "common/common/fmt.h"
 #include "common/common/logger.h"
 #include "common/common/thread.h"
 #include "common/event/dispatcher_impl.h"
+#include "common/memory/stats.h"
 #include "common/stats/fake_symbol_table_impl.h"
 #include "common/stats/heap_stat_data.h"
 #include "common/stats/stats_options_impl.h"
@@ -29,6 +31,9 @@ public:
   }
 
   ~ThreadLocalStorePerf() {
+    for (Stats::StatNameStorage& stat_name_storage : stat_names_) {
+      stat_name_storage.free(symbol_table_);
+    }
     store_.shutdownThreading();
     if (tls_) {
       tls_->shutdownGlobalThreading();
@@ -40,6 +45,42 @@ public:
         1000, [this](absl::string_view name) { store_.counter(std::string(name)); });
   }
 
+  // Encodes the sample names once, so that accessCountersFromStatNames() measures only the
+  // lookups, as for callers that hold pre-encoded names.
+  void encodeStatNames() {
+    Stats::TestUtil::forEachSampleStat(1000, [this](absl::string_view name) {
+      stat_names_.push_back(Stats::StatNameStorage(name, symbol_table_));
+    });
+  }
+
+  void accessCountersFromStatNames() {
+    for (const Stats::StatNameStorage& stat_name_storage : stat_names_) {
+      store_.counterFromStatName(stat_name_storage.statName());
+    }
+  }
+
+  // Increments a counter for each of num_clusters clusters that did not exist in the previous
+  // generation, as when routes are replaced, and then evicts idle stats as a flush would.
+  void churnClusters(Stats::Scope& scope, uint32_t generation, uint32_t num_clusters) {
+    for (uint32_t i = 0; i < num_clusters; ++i) {
+      const std::string name =
+          fmt::format("vhost.service_{}.vcluster.cluster_{}.upstream_rq_200", i, generation);
+      scope.counter(name).inc();
+    }
+    store_.evictIdleStats(1);
+  }
+
+  uint64_t scopeBytes(const std::string& prefix) const {
+    for (const Stats::ScopeMemoryStats& stats : store_.scopeMemoryStats()) {
+      if (stats.prefix_ == prefix) {
+        return stats.bytes_;
+      }
+    }
+    return 0;
+  }
+
+  Stats::ThreadLocalStoreImpl& store() { return store_; }
+
   void initThreading() {
     dispatcher_ = api_->allocateDispatcher();
     tls_ = std::make_unique<ThreadLocal::InstanceImpl>();
@@ -56,6 +97,7 @@ private:
   Event::DispatcherPtr dispatcher_;
   std::unique_ptr<ThreadLocal::InstanceImpl> tls_;
   envoy::config::metrics::v2::StatsConfig stats_config_;
+  std::vector<Stats::StatNameStorage> stat_names_;
 };
 
 } // namespace Envoy
@@ -84,6 +126,38 @@ static void BM_StatsWithTls(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTls);
 
+// Tests the single-threaded performance of the thread-local-store stats caches
+// with tls, looking stats up by pre-encoded StatName rather than by string.
+static void BM_StatsFromStatNameWithTls(benchmark::State& state) {
+  Envoy::ThreadLocalStorePerf context;
+  context.initThreading();
+  context.encodeStatNames();
+
+  for (auto _ : state) {
+    context.accessCountersFromStatNames();
+  }
+}
+BENCHMARK(BM_StatsFromStatNameWithTls);
+
+// Tests the steady-state memory of a scope whose stat names change with every generation of
+// 1000 clusters. Arg 0 uses a regular scope, which keeps every generation's stats, and arg 1 an
+// evictable scope, which keeps only the stats used since the last flush.
+static void BM_StatsClusterChurn(benchmark::State& state) {
+  Envoy::ThreadLocalStorePerf context;
+  Envoy::Stats::ScopePtr scope = state.range(0) == 1
+                                     ? context.store().createEvictableScope("churn.")
+                                     : context.store().createScope("churn.");
+  const size_t start_mem = Envoy::Memory::Stats::totalCurrentlyAllocated();
+
+  uint32_t generation = 0;
+  for (auto _ : state) {
+    context.churnClusters(*scope, generation++, 1000);
+  }
+  state.counters["scope_bytes"] = context.scopeBytes("churn.");
+  state.counters["heap_bytes"] = Envoy::Memory::Stats::totalCurrentlyAllocated() - start_mem;
+}
+BENCHMARK(BM_StatsClusterChurn)->Arg(0)->Arg(1)->Iterations(1000);
+
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
 
@@ -1,4 +1,5 @@
 #include <chrono>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -299,6 +300,29 @@ TEST_F(StatsThreadLocalStoreTest, SanitizePrefix) {
   EXPECT_CALL(*alloc_, free(_)).Times(2);
 }
 
+// A prefix without a trailing "." is concatenated to the names of the scope's stats.
+TEST_F(StatsThreadLocalStoreTest, PrefixWithoutDot) {
+  InSequence s;
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  ScopePtr scope1 = store_->createScope("scope1");
+  EXPECT_CALL(*alloc_, alloc(_));
+  Counter& c1 = scope1->counter("c1.foo");
+  EXPECT_EQ("scope1c1.foo", c1.name());
+  EXPECT_EQ(&c1, &scope1->counter("c1.foo"));
+
+  ScopePtr scope2 = scope1->createScope("scope2");
+  EXPECT_CALL(*alloc_, alloc(_));
+  Counter& c2 = scope2->counter("c2");
+  EXPECT_EQ("scope1scope2c2", c2.name());
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+
+  // Includes overflow stat.
+  EXPECT_CALL(*alloc_, free(_)).Times(3);
+}
+
 TEST_F(StatsThreadLocalStoreTest, ScopeDelete) {
   InSequence s;
   store_->initializeThreading(main_thread_dispatcher_, tls_);
@@ -311,8 +335,9 @@ TEST_F(StatsThreadLocalStoreTest, ScopeDelete) {
   EXPECT_EQ("scope1.c1", c1->name());
   EXPECT_EQ(TestUtility::findByName(store_->source().cachedCounters(), "scope1.c1"), c1);
 
+  // The TLS caches are cleared with runOnAllThreads(cb, all_threads_complete_cb), which the mock
+  // runs inline, so the scope's central cache is released along with the TLS caches.
   EXPECT_CALL(main_thread_dispatcher_, post(_));
-  EXPECT_CALL(tls_, runOnAllThreads(_));
   scope1.reset();
   EXPECT_EQ(1UL, store_->counters().size());
   EXPECT_EQ(2UL, store_->source().cachedCounters().size());
@@ -1000,6 +1025,94 @@ TEST_F(StatsThreadLocalStoreTest, MergeDuringShutDown) {
   EXPECT_CALL(*alloc_, free(_));
 }
 
+TEST_F(HeapStatsThreadLocalStoreTest, ScopeMemoryStats) {
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+  ScopePtr scope1 = store_->createScope("scope1.");
+  ScopePtr scope2 = store_->createEvictableScope("scope2.");
+  scope1->counter("c1");
+  scope1->counter("c2");
+  scope1->gauge("g1");
+  scope2->counter("c1");
+
+  std::map<std::string, ScopeMemoryStats> scopes;
+  for (ScopeMemoryStats& stats : store_->scopeMemoryStats()) {
+    scopes[stats.prefix_] = std::move(stats);
+  }
+  ASSERT_EQ(3, scopes.size());
+  EXPECT_EQ(1, scopes[""].counters_); // "stats.overflow".
+  EXPECT_FALSE(scopes[""].evictable_);
+
+  const ScopeMemoryStats& stats1 = scopes["scope1."];
+  EXPECT_EQ(2, stats1.counters_);
+  EXPECT_EQ(1, stats1.gauges_);
+  EXPECT_EQ(0, stats1.histograms_);
+  EXPECT_FALSE(stats1.evictable_);
+
+  const ScopeMemoryStats& stats2 = scopes["scope2."];
+  EXPECT_EQ(1, stats2.counters_);
+  EXPECT_TRUE(stats2.evictable_);
+  EXPECT_EQ(0, stats2.evicted_);
+  EXPECT_LT(0, stats2.bytes_);
+  EXPECT_LT(stats2.bytes_, stats1.bytes_);
+}
+
+// Stats in evictable scopes are dropped once idle for the given number of flushes, while those in
+// other scopes are kept.
+TEST_F(HeapStatsThreadLocalStoreTest, EvictIdleStats) {
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+  ScopePtr dynamic_scope = store_->createEvictableScope("dynamic.");
+  ScopePtr static_scope = store_->createScope("static.");
+  dynamic_scope->counter("c1").inc();
+  dynamic_scope->gauge("g1").set(0);
+  dynamic_scope->gauge("g2").set(5);
+  Histogram& h1 = dynamic_scope->histogram("h1");
+  static_scope->counter("c1");
+  static_scope->histogram("h1");
+
+  auto flush = [this]() -> void {
+    store_->mergeHistograms([]() -> void {});
+    store_->evictIdleStats(2);
+  };
+
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 1));
+  h1.recordValue(1);
+  flush();
+  flush();
+  EXPECT_NE(nullptr, TestUtility::findCounter(*store_, "dynamic.c1"));
+  EXPECT_NE(nullptr, TestUtility::findGauge(*store_, "dynamic.g1"));
+  EXPECT_EQ(2, store_->histograms().size());
+
+  // A counter that changed restarts its idle count.
+  dynamic_scope->counter("c1").inc();
+  flush();
+  EXPECT_NE(nullptr, TestUtility::findCounter(*store_, "dynamic.c1"));
+  EXPECT_EQ(nullptr, TestUtility::findGauge(*store_, "dynamic.g1"));
+  EXPECT_EQ(1, store_->histograms().size());
+  EXPECT_EQ("static.h1", store_->histograms()[0]->name());
+
+  flush();
+  flush();
+  EXPECT_EQ(nullptr, TestUtility::findCounter(*store_, "dynamic.c1"));
+  EXPECT_NE(nullptr, TestUtility::findCounter(*store_, "static.c1"));
+  // Gauges with a value are never evicted.
+  EXPECT_EQ(5, TestUtility::findGauge(*store_, "dynamic.g2")->value());
+
+  for (const ScopeMemoryStats& stats : store_->scopeMemoryStats()) {
+    if (stats.prefix_ == "dynamic.") {
+      EXPECT_EQ(0, stats.counters_);
+      EXPECT_EQ(1, stats.gauges_);
+      EXPECT_EQ(0, stats.histograms_);
+      EXPECT_EQ(3, stats.evicted_);
+    } else {
+      EXPECT_EQ(0, stats.evicted_);
+    }
+  }
+
+  // Evicted stats are created again on their next use.
+  dynamic_scope->counter("c1").inc();
+  EXPECT_EQ(1, TestUtility::findCounter(*store_, "dynamic.c1")->value());
+}
+
 // Histogram tests
 TEST_F(HistogramTest, BasicSingleHistogramMerge) {
   Histogram& h1 = store_->histogram("h1");
@@ -1169,6 +1282,54 @@ TEST_F(HistogramTest, BasicHistogramUsed) {
   }
 }
 
+TEST_F(HistogramTest, LogLinearHistogramMerge) {
+  HistogramSettings settings;
+  settings.backend_ = HistogramSettings::Backend::LogLinear;
+  settings.precision_bits_ = 4;
+  store_->setHistogramSettings(settings);
+
+  Histogram& h1 = store_->histogram("h1");
+  LogLinearHistogram interval(4);
+  LogLinearHistogram cumulative(4);
+  auto record = [&](uint64_t value) {
+    EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), value));
+    h1.recordValue(value);
+    interval.recordValue(value);
+    cumulative.recordValue(value);
+  };
+  auto validate = [&]() {
+    store_->mergeHistograms([]() -> void {});
+    HistogramStatisticsImpl interval_statistics;
+    HistogramStatisticsImpl cumulative_statistics;
+    interval_statistics.refresh(interval);
+    cumulative_statistics.refresh(cumulative);
+    interval.clear();
+
+    ParentHistogramSharedPtr parent = store_->histograms()[0];
+    EXPECT_EQ(interval_statistics.quantileSummary(),
+              parent->intervalStatistics().quantileSummary());
+    EXPECT_EQ(interval_statistics.bucketSummary(), parent->intervalStatistics().bucketSummary());
+    EXPECT_EQ(interval_statistics.sampleSum(), parent->intervalStatistics().sampleSum());
+    EXPECT_EQ(cumulative_statistics.quantileSummary(),
+              parent->cumulativeStatistics().quantileSummary());
+    EXPECT_EQ(cumulative_statistics.bucketSummary(),
+              parent->cumulativeStatistics().bucketSummary());
+    EXPECT_EQ(cumulative_statistics.sampleCount(), parent->cumulativeStatistics().sampleCount());
+  };
+
+  for (uint64_t value : {0, 43, 41, 415, 2201, 3201, 125, 13}) {
+    record(value);
+  }
+  validate();
+
+  record(1);
+  record(100000);
+  validate();
+
+  // Nothing recorded in the last interval.
+  validate();
+}
+
 class TruncatingAllocTest : public HeapStatsThreadLocalStoreTest {
 protected:
   TruncatingAllocTest()
@@ -1,3 +1,6 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -7,6 +10,7 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/config/filter_json.h"
 #include "common/network/address_impl.h"
+#include "common/network/io_socket_handle_impl.h"
 #include "common/network/transport_socket_options_impl.h"
 #include "common/network/upstream_server_name.h"
 #include "common/router/metadatamatchcriteria_impl.h"
@@ -16,6 +20,7 @@
 #include "extensions/access_loggers/well_known_names.h"
 
 #include "test/common/upstream/utility.h"
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/buffer/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/runtime/mocks.h"
@@ -26,11 +31,13 @@
 #include "test/mocks/upstream/host.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::DoAll;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
 using testing::MatchesRegex;
@@ -452,8 +459,9 @@ public:
 
   void setup(uint32_t connections) { setup(connections, defaultConfig()); }
 
-  void raiseEventUpstreamConnected(uint32_t conn_index) {
-    EXPECT_CALL(filter_callbacks_.connection_, readDisable(false));
+  void raiseEventUpstreamConnected(uint32_t conn_index, bool spliced = false) {
+    // Spliced connections are never read by Envoy.
+    EXPECT_CALL(filter_callbacks_.connection_, readDisable(false)).Times(spliced ? 0 : 1);
     EXPECT_CALL(*upstream_connection_data_.at(conn_index), addUpstreamCallbacks(_))
         .WillOnce(Invoke([=](Tcp::ConnectionPool::UpstreamCallbacks& cb) -> void {
           upstream_callbacks_ = &cb;
@@ -991,6 +999,147 @@ TEST_F(TcpProxyTest, AccessLogBytesRxTxDuration) {
                   "bytesreceived=1 bytessent=2 datetime=[0-9-]+T[0-9:.]+Z nonzeronum=[1-9][0-9]*"));
 }
 
+// Tests that the data is proxied as usual when the connections cannot be spliced.
+TEST_F(TcpProxyTest, SpliceNotPossible) {
+  envoy::config::filter::network::tcp_proxy::v2::TcpProxy config = defaultConfig();
+  config.set_use_splice(true);
+  setup(1, config);
+
+  EXPECT_CALL(filter_callbacks_.connection_, spliceIoHandle()).WillOnce(Return(nullptr));
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, createFileEvent_(_, _, _, _)).Times(0);
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(0, config_->stats().downstream_cx_splice_total_.value());
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+}
+
+#if defined(__linux__)
+class TcpProxySpliceTest : public TcpProxyTest {
+public:
+  // Splices between socket pairs that stand in for the downstream and upstream connections, whose
+  // peers are the downstream client and the upstream server.
+  void setupSplice(const envoy::config::filter::network::tcp_proxy::v2::TcpProxy& config) {
+    setup(1, config);
+
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+    downstream_handle_ = std::make_unique<Network::IoSocketHandleImpl>(fds[0]);
+    client_ = std::make_unique<Network::IoSocketHandleImpl>(fds[1]);
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+    upstream_handle_ = std::make_unique<Network::IoSocketHandleImpl>(fds[0]);
+    server_ = std::make_unique<Network::IoSocketHandleImpl>(fds[1]);
+
+    ON_CALL(filter_callbacks_.connection_, spliceIoHandle())
+        .WillByDefault(Return(downstream_handle_.get()));
+    ON_CALL(*upstream_connections_.at(0), spliceIoHandle())
+        .WillByDefault(Return(upstream_handle_.get()));
+
+    const uint32_t events = Event::FileReadyType::Read | Event::FileReadyType::Write;
+    EXPECT_CALL(filter_callbacks_.connection_.dispatcher_,
+                createFileEvent_(downstream_handle_->fd(), _, Event::FileTriggerType::Edge, events))
+        .WillOnce(DoAll(SaveArg<1>(&downstream_cb_), Return(new NiceMock<Event::MockFileEvent>())));
+    EXPECT_CALL(filter_callbacks_.connection_.dispatcher_,
+                createFileEvent_(upstream_handle_->fd(), _, Event::FileTriggerType::Edge, events))
+        .WillOnce(DoAll(SaveArg<1>(&upstream_cb_), Return(new NiceMock<Event::MockFileEvent>())));
+    EXPECT_CALL(*upstream_connections_.at(0), readDisable(true));
+    raiseEventUpstreamConnected(0, true);
+    EXPECT_EQ(1, config_->stats().downstream_cx_splice_total_.value());
+  }
+
+  static void send(Network::IoSocketHandleImpl& handle, const std::string& data) {
+    ASSERT_EQ(static_cast<ssize_t>(data.size()), ::write(handle.fd(), data.data(), data.size()));
+  }
+
+  static std::string receive(Network::IoSocketHandleImpl& handle) {
+    char buffer[4096];
+    const ssize_t rc = ::read(handle.fd(), buffer, sizeof(buffer));
+    return rc > 0 ? std::string(buffer, rc) : "";
+  }
+
+  std::unique_ptr<Network::IoSocketHandleImpl> downstream_handle_;
+  std::unique_ptr<Network::IoSocketHandleImpl> client_;
+  std::unique_ptr<Network::IoSocketHandleImpl> upstream_handle_;
+  std::unique_ptr<Network::IoSocketHandleImpl> server_;
+  Event::FileReadyCb downstream_cb_;
+  Event::FileReadyCb upstream_cb_;
+};
+
+// Tests that data and half-closes are spliced in both directions, and that the connections are
+// closed once both sides have half-closed.
+TEST_F(TcpProxySpliceTest, Splice) {
+  envoy::config::filter::network::tcp_proxy::v2::TcpProxy config =
+      accessLogConfig("bytesreceived=%BYTES_RECEIVED% bytessent=%BYTES_SENT%");
+  config.set_use_splice(true);
+  setupSplice(config);
+
+  send(*client_, "hello");
+  EXPECT_CALL(filter_callbacks_.connection_, onSpliced(5, 0));
+  EXPECT_CALL(*upstream_connections_.at(0), onSpliced(0, 5));
+  downstream_cb_(Event::FileReadyType::Read);
+  EXPECT_EQ("hello", receive(*server_));
+
+  send(*server_, "hi");
+  EXPECT_CALL(*upstream_connections_.at(0), onSpliced(2, 0));
+  EXPECT_CALL(filter_callbacks_.connection_, onSpliced(0, 2));
+  upstream_cb_(Event::FileReadyType::Read);
+  EXPECT_EQ("hi", receive(*client_));
+
+  ::shutdown(client_->fd(), SHUT_WR);
+  EXPECT_CALL(*upstream_connections_.at(0), write(_, true));
+  EXPECT_CALL(filter_callbacks_.connection_, close(_)).Times(0);
+  downstream_cb_(Event::FileReadyType::Read);
+
+  ::shutdown(server_->fd(), SHUT_WR);
+  EXPECT_CALL(filter_callbacks_.connection_, write(_, true));
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  EXPECT_CALL(*upstream_connections_.at(0), close(Network::ConnectionCloseType::NoFlush));
+  upstream_cb_(Event::FileReadyType::Read);
+
+  filter_.reset();
+  EXPECT_EQ("bytesreceived=5 bytessent=2", access_log_data_);
+}
+
+// Tests that the connections are closed when splicing fails.
+TEST_F(TcpProxySpliceTest, SpliceError) {
+  envoy::config::filter::network::tcp_proxy::v2::TcpProxy config = defaultConfig();
+  config.set_use_splice(true);
+  setupSplice(config);
+
+  Api::MockLinuxOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> injector(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, splice(downstream_handle_->fd(), _, _, _, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, ECONNRESET}));
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*upstream_connections_.at(0), close(Network::ConnectionCloseType::NoFlush));
+  downstream_cb_(Event::FileReadyType::Read);
+}
+
+// Tests that a destination that is not writable pauses reading from the source, until it can be
+// written to again.
+TEST_F(TcpProxySpliceTest, SpliceFlowControl) {
+  envoy::config::filter::network::tcp_proxy::v2::TcpProxy config = defaultConfig();
+  config.set_use_splice(true);
+  setupSplice(config);
+
+  const std::string chunk(4096, 'a');
+  while (config_->stats().downstream_flow_control_paused_reading_total_.value() == 0) {
+    send(*client_, chunk);
+    downstream_cb_(Event::FileReadyType::Read);
+  }
+
+  // The upstream socket stays blocked until the server reads.
+  upstream_cb_(Event::FileReadyType::Write);
+  EXPECT_EQ(0, config_->stats().downstream_flow_control_resumed_reading_total_.value());
+
+  while (!receive(*server_).empty()) {
+  }
+  upstream_cb_(Event::FileReadyType::Write);
+  EXPECT_EQ(1, config_->stats().downstream_flow_control_resumed_reading_total_.value());
+}
+#endif
+
 // Tests that upstream flush works properly with no idle timeout configured.
 TEST_F(TcpProxyTest, UpstreamFlushNoTimeout) {
   setup(1);
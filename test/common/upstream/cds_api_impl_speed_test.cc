@@ -0,0 +1,119 @@
+// Benchmarks for applying a CDS update that changes one cluster, as a state-of-the-world update
+// carrying every cluster and as a delta update carrying only the changed one.
+//
+// Note: this should be run with --compilation_mode=opt.
+
+#include <string>
+
+#include "envoy/api/v2/cds.pb.h"
+
+#include "common/protobuf/utility.h"
+#include "common/stats/isolated_store_impl.h"
+#include "common/upstream/cds_api_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class CdsSpeedTest {
+public:
+  CdsSpeedTest() : api_(Api::createApiForTest(store_)) {
+    envoy::api::v2::core::ConfigSource cds_config;
+    cds_config.mutable_ads();
+    cds_ = CdsApiImpl::create(cds_config, cm_, dispatcher_, random_, local_info_, store_, *api_);
+  }
+
+  static envoy::api::v2::Resource clusterResource(uint32_t i, const std::string& version) {
+    envoy::api::v2::Cluster cluster;
+    cluster.set_name(fmt::format("cluster_{}", i));
+    cluster.mutable_connect_timeout()->set_seconds(1);
+    auto* socket_address = cluster.add_hosts()->mutable_socket_address();
+    socket_address->set_address(fmt::format("10.0.{}.{}", (i / 256) % 256, i % 256));
+    socket_address->set_port_value(10000 + i % 10000);
+
+    envoy::api::v2::Resource resource;
+    resource.set_name(cluster.name());
+    resource.set_version(version);
+    resource.mutable_resource()->PackFrom(cluster);
+    return resource;
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  Api::ApiPtr api_;
+  NiceMock<MockClusterManager> cm_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Runtime::MockRandomGenerator> random_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  CdsApiPtr cds_;
+};
+
+// Each iteration changes one of range(0) clusters. The state-of-the-world update resends and
+// reparses all of them.
+static void CdsStateOfTheWorldUpdate(benchmark::State& state) {
+  const uint32_t num_clusters = state.range(0);
+  CdsSpeedTest test;
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> resources;
+  for (uint32_t i = 0; i < num_clusters; ++i) {
+    *resources.Add() = CdsSpeedTest::clusterResource(i, "0").resource();
+  }
+
+  uint32_t version = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint32_t changed = version % num_clusters;
+    *resources.Mutable(changed) =
+        CdsSpeedTest::clusterResource(changed + num_clusters, "").resource();
+    state.ResumeTiming();
+    test.cds_->onConfigUpdate(resources, std::to_string(++version));
+  }
+}
+BENCHMARK(CdsStateOfTheWorldUpdate)->Arg(100)->Arg(1000)->Arg(10000);
+
+// The same change as a delta update carries only the changed cluster, so its cost does not depend
+// on range(0).
+static void CdsDeltaUpdate(benchmark::State& state) {
+  const uint32_t num_clusters = state.range(0);
+  CdsSpeedTest test;
+  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> added_resources;
+  for (uint32_t i = 0; i < num_clusters; ++i) {
+    *added_resources.Add() = CdsSpeedTest::clusterResource(i, "0");
+  }
+  test.cds_->onConfigUpdate(added_resources, {}, "0");
+
+  uint32_t version = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint32_t changed = version % num_clusters;
+    added_resources.Clear();
+    *added_resources.Add() =
+        CdsSpeedTest::clusterResource(changed + num_clusters, std::to_string(version + 1));
+    state.ResumeTiming();
+    test.cds_->onConfigUpdate(added_resources, {}, std::to_string(++version));
+  }
+}
+BENCHMARK(CdsDeltaUpdate)->Arg(100)->Arg(1000)->Arg(10000);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
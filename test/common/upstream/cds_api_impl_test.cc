@@ -358,8 +358,8 @@ resources:
       path: eds path
 )EOF";
 
+  // cluster1 has the same config as when it was added, so it is skipped before being converted.
   EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterMap({"cluster1", "cluster2"})));
-  cm_.expectAdd("cluster1", "1");
   cm_.expectAdd("cluster3", "1");
   EXPECT_CALL(cm_, removeCluster("cluster2"));
   EXPECT_CALL(*interval_timer_, enableTimer(_));
@@ -275,7 +275,7 @@ public:
   NiceMock<Server::MockAdmin> admin_;
   MockLocalClusterUpdate local_cluster_update_;
   MockLocalHostsRemoved local_hosts_removed_;
-  Http::ContextImpl http_context_;
+  Http::ContextImpl http_context_{factory_.stats_.symbolTable()};
 };
 
 envoy::config::bootstrap::v2::Bootstrap parseBootstrapFromJson(const std::string& json_string) {
@@ -1327,6 +1327,95 @@ TEST_F(ClusterManagerImplTest, HostsPostedToTlsCluster) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
 }
 
+// Verifies that lazy clusters get thread local state on first use, with the hosts posted before,
+// and lose it once unused for an idle interval.
+TEST_F(ClusterManagerImplTest, LazyClusters) {
+  const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STATIC
+      lb_policy: ROUND_ROBIN
+      hosts:
+      - socket_address:
+          address: "127.0.0.1"
+          port_value: 11001
+  cluster_manager:
+    lazy_clusters:
+      idle_timeout: 10s
+  )EOF";
+
+  Event::MockTimer* idle_timer = new NiceMock<Event::MockTimer>(&factory_.tls_.dispatcher_);
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(10000))).Times(4);
+  create(parseBootstrapFromV2Yaml(yaml));
+  EXPECT_EQ(0, factory_.stats_.counter("cluster_manager.lazy_cluster_created").value());
+
+  ThreadLocalCluster* tls_cluster = cluster_manager_->get("cluster_1");
+  ASSERT_NE(nullptr, tls_cluster);
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.lazy_cluster_created").value());
+  EXPECT_EQ(1, tls_cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(1, tls_cluster->prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
+  EXPECT_NE(nullptr, tls_cluster->loadBalancer().chooseHost(nullptr));
+  EXPECT_EQ(nullptr, cluster_manager_->get("cluster_2"));
+
+  // Used since the entry was created, then again before the next sweep.
+  idle_timer->callback_();
+  EXPECT_EQ(tls_cluster, cluster_manager_->get("cluster_1"));
+  idle_timer->callback_();
+  EXPECT_EQ(0, factory_.stats_.counter("cluster_manager.lazy_cluster_expired").value());
+
+  // Unused for a whole interval.
+  idle_timer->callback_();
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.lazy_cluster_expired").value());
+
+  Http::ConnectionPool::MockInstance* cp = new Http::ConnectionPool::MockInstance();
+  EXPECT_CALL(factory_, allocateConnPool_(_)).WillOnce(Return(cp));
+  EXPECT_EQ(cp, cluster_manager_->httpConnPoolForCluster("cluster_1", ResourcePriority::Default,
+                                                         Http::Protocol::Http11, nullptr));
+  EXPECT_EQ(2, factory_.stats_.counter("cluster_manager.lazy_cluster_created").value());
+
+  factory_.tls_.shutdownThread();
+}
+
+// Verifies that lazy clusters can be added and removed without being used, and that they are
+// created as they are added while update callbacks are registered.
+TEST_F(ClusterManagerImplTest, LazyClustersDynamicAddRemove) {
+  const std::string yaml = R"EOF(
+  cluster_manager:
+    lazy_clusters: {}
+  )EOF";
+  create(parseBootstrapFromV2Yaml(yaml));
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _)).WillOnce(Return(cluster1));
+  EXPECT_CALL(*cluster1, initialize(_))
+      .WillOnce(Invoke([](std::function<void()> initialize_callback) { initialize_callback(); }));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("fake_cluster"), "",
+                                                    dummyWarmingCb));
+  EXPECT_TRUE(cluster_manager_->removeCluster("fake_cluster"));
+  EXPECT_EQ(nullptr, cluster_manager_->get("fake_cluster"));
+  EXPECT_EQ(0, factory_.stats_.counter("cluster_manager.lazy_cluster_created").value());
+
+  NiceMock<MockClusterUpdateCallbacks> callbacks;
+  ClusterUpdateCallbacksHandlePtr cb =
+      cluster_manager_->addThreadLocalClusterUpdateCallbacks(callbacks);
+  std::shared_ptr<MockClusterMockPrioritySet> cluster2(new NiceMock<MockClusterMockPrioritySet>());
+  cluster2->info_->name_ = "fake_cluster2";
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _)).WillOnce(Return(cluster2));
+  EXPECT_CALL(*cluster2, initialize(_))
+      .WillOnce(Invoke([](std::function<void()> initialize_callback) { initialize_callback(); }));
+  EXPECT_CALL(callbacks, onClusterAddOrUpdate(_));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("fake_cluster2"), "",
+                                                    dummyWarmingCb));
+  EXPECT_EQ(cluster2->info_, cluster_manager_->get("fake_cluster2")->info());
+  EXPECT_EQ(0, factory_.stats_.counter("cluster_manager.lazy_cluster_created").value());
+
+  EXPECT_CALL(callbacks, onClusterRemoval("fake_cluster2"));
+  EXPECT_TRUE(cluster_manager_->removeCluster("fake_cluster2"));
+  EXPECT_EQ(nullptr, cluster_manager_->get("fake_cluster2"));
+}
+
 // Test that we close all HTTP connection pool connections when there is a host health failure.
 TEST_F(ClusterManagerImplTest, CloseHttpConnectionsOnHealthFailure) {
   const std::string json =
@@ -270,6 +270,79 @@ TEST_F(EdsTest, NoServiceNameOnSuccessConfigUpdate) {
   EXPECT_TRUE(initialized);
 }
 
+envoy::api::v2::Resource loadAssignmentResource(const std::string& cluster_name,
+                                                const std::vector<uint32_t>& ports) {
+  envoy::api::v2::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name(cluster_name);
+  auto* endpoints = cluster_load_assignment.add_endpoints();
+  for (const uint32_t port : ports) {
+    auto* socket_address = endpoints->add_lb_endpoints()
+                               ->mutable_endpoint()
+                               ->mutable_address()
+                               ->mutable_socket_address();
+    socket_address->set_address("1.2.3.4");
+    socket_address->set_port_value(port);
+  }
+  envoy::api::v2::Resource resource;
+  resource.set_name(cluster_name);
+  resource.mutable_resource()->PackFrom(cluster_load_assignment);
+  return resource;
+}
+
+// Validate that a delta onConfigUpdate() carrying the cluster's assignment applies it.
+TEST_F(EdsTest, DeltaOnConfigUpdateAdd) {
+  bool initialized = false;
+  cluster_->initialize([&initialized] { initialized = true; });
+  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> added_resources;
+  *added_resources.Add() = loadAssignmentResource("fare", {80, 81});
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate(added_resources, {}, "1"));
+  EXPECT_TRUE(initialized);
+  EXPECT_EQ(2UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+
+  added_resources.Clear();
+  *added_resources.Add() = loadAssignmentResource("fare", {80});
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate(added_resources, {}, "2"));
+  EXPECT_EQ(1UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+}
+
+// Validate that a delta onConfigUpdate() removing the cluster's assignment, or any other, keeps
+// the current hosts.
+TEST_F(EdsTest, DeltaOnConfigUpdateRemove) {
+  cluster_->initialize([] {});
+  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> added_resources;
+  *added_resources.Add() = loadAssignmentResource("fare", {80, 81});
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate(added_resources, {}, "1"));
+
+  Protobuf::RepeatedPtrField<std::string> removed_resources;
+  *removed_resources.Add() = "other";
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate({}, removed_resources, "2"));
+  *removed_resources.Add() = "fare";
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate({}, removed_resources, "3"));
+
+  EXPECT_EQ(2UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(2UL, stats_.counter("cluster.name.update_empty").value());
+}
+
+// Validate that a delta onConfigUpdate() with an invalid assignment rejects it and keeps the
+// current hosts.
+TEST_F(EdsTest, DeltaOnConfigUpdateInvalid) {
+  cluster_->initialize([] {});
+  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> added_resources;
+  *added_resources.Add() = loadAssignmentResource("fare", {80, 81});
+  VERBOSE_EXPECT_NO_THROW(cluster_->onConfigUpdate(added_resources, {}, "1"));
+
+  added_resources.Clear();
+  *added_resources.Add() = loadAssignmentResource("wrong name", {80});
+  EXPECT_THROW_WITH_MESSAGE(cluster_->onConfigUpdate(added_resources, {}, "2"), EnvoyException,
+                            "Unexpected EDS cluster (expecting fare): wrong name");
+
+  added_resources.Clear();
+  added_resources.Add()->mutable_resource()->PackFrom(envoy::api::v2::ClusterLoadAssignment());
+  EXPECT_THROW(cluster_->onConfigUpdate(added_resources, {}, "3"), ProtoValidationException);
+
+  EXPECT_EQ(2UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+}
+
 // Validate that onConfigUpdate() updates the endpoint metadata.
 TEST_F(EdsTest, EndpointMetadata) {
   envoy::api::v2::ClusterLoadAssignment cluster_load_assignment;
@@ -9,6 +9,7 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -64,7 +65,7 @@ protected:
     Json::ObjectSharedPtr config = Json::Factory::loadFromString(json);
     envoy::config::filter::http::gzip::v2::Gzip gzip;
     MessageUtil::loadFromJson(json, gzip);
-    config_.reset(new GzipFilterConfig(gzip, "test.", stats_, runtime_));
+    config_.reset(new GzipFilterConfig(gzip, "test.", stats_, runtime_, tls_));
     filter_ = std::make_unique<GzipFilter>(config_);
   }
 
@@ -121,6 +122,7 @@ protected:
     EXPECT_EQ(1, stats_.counter("test.gzip.not_compressed").value());
   }
 
+  NiceMock<ThreadLocal::MockInstance> tls_;
   GzipFilterConfigSharedPtr config_;
   std::unique_ptr<GzipFilter> filter_;
   Buffer::OwnedImpl data_;
@@ -163,6 +165,28 @@ TEST_F(GzipFilterTest, AcceptanceGzipEncoding) {
   doResponseCompression({{":method", "get"}, {"content-length", "256"}});
 }
 
+// The deflate state of a finished stream is reused by the next compressed stream.
+TEST_F(GzipFilterTest, DeflateStateReused) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}}, false);
+  doResponseCompression({{":method", "get"}, {"content-length", "256"}});
+  EXPECT_EQ(0U, config_->deflateStatePool()->idleStates());
+
+  filter_ = std::make_unique<GzipFilter>(config_);
+  EXPECT_EQ(1U, config_->deflateStatePool()->idleStates());
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}}, false);
+  Http::TestHeaderMapImpl headers{{":method", "get"}, {"content-length", "256"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_EQ(0U, config_->deflateStatePool()->idleStates());
+
+  Buffer::OwnedImpl data("hello world");
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data, true));
+  Decompressor::ZlibDecompressorImpl decompressor;
+  decompressor.init(31);
+  Buffer::OwnedImpl decompressed_data;
+  decompressor.decompress(data, decompressed_data);
+  EXPECT_EQ("hello world", decompressed_data.toString());
+}
+
 // Verifies isAcceptEncodingAllowed function.
 TEST_F(GzipFilterTest, hasCacheControlNoTransform) {
   {
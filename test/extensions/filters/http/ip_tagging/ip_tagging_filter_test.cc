@@ -8,9 +8,13 @@
 
 #include "extensions/filters/http/ip_tagging/ip_tagging_filter.h"
 
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/filesystem/mocks.h"
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -42,10 +46,10 @@ ip_tags:
 
 )EOF";
 
-  void initializeFilter(const std::string& yaml) {
+  void initializeFilter(const std::string& yaml, IpTagsFileProviderSharedPtr tags_file = nullptr) {
     envoy::config::filter::http::ip_tagging::v2::IPTagging config;
     MessageUtil::loadFromYaml(yaml, config);
-    config_.reset(new IpTaggingFilterConfig(config, "prefix.", stats_, runtime_));
+    config_.reset(new IpTaggingFilterConfig(config, "prefix.", stats_, runtime_, tags_file));
     filter_ = std::make_unique<IpTaggingFilter>(config_);
     filter_->setDecoderFilterCallbacks(filter_callbacks_);
   }
@@ -281,6 +285,51 @@ TEST_F(IpTaggingFilterTest, ClearRouteCache) {
   EXPECT_FALSE(request_headers.has(Http::Headers::get().EnvoyIpTags));
 }
 
+TEST_F(IpTaggingFilterTest, IpTagsFile) {
+  const std::string path = TestEnvironment::writeStringToFileForTest(
+      "ip_tagging_filter_tags",
+      IpTagsFile::encode({{"file_tag", {Network::Address::CidrRange::create("1.2.3.0/24")}}}));
+  NiceMock<Event::MockDispatcher> dispatcher;
+  NiceMock<ThreadLocal::MockInstance> tls;
+  EXPECT_CALL(dispatcher, createFilesystemWatcher_())
+      .WillOnce(Return(new NiceMock<Filesystem::MockWatcher>()));
+  initializeFilter(fmt::format("ip_tags_path: {}", path),
+                   std::make_shared<IpTagsFileRegistry>()->getProvider(path, dispatcher, tls));
+  Http::TestHeaderMapImpl request_headers;
+
+  Network::Address::InstanceConstSharedPtr remote_address =
+      Network::Utility::parseInternetAddress("1.2.3.4");
+  EXPECT_CALL(filter_callbacks_.stream_info_, downstreamRemoteAddress())
+      .WillOnce(ReturnRef(remote_address));
+
+  EXPECT_CALL(stats_, counter("prefix.ip_tagging.file_tag.hit"));
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ("file_tag", request_headers.get_(Http::Headers::get().EnvoyIpTags));
+}
+
+TEST(IpTaggingFilterConfigTest, RequiresExactlyOneTagSource) {
+  NiceMock<Stats::MockStore> stats;
+  NiceMock<Runtime::MockLoader> runtime;
+  envoy::config::filter::http::ip_tagging::v2::IPTagging config;
+  EXPECT_THROW_WITH_MESSAGE(IpTaggingFilterConfig(config, "prefix.", stats, runtime),
+                            EnvoyException,
+                            "HTTP IP Tagging Filter requires exactly one of ip_tags or "
+                            "ip_tags_path to be specified.");
+
+  MessageUtil::loadFromYaml(R"EOF(
+ip_tags_path: /tags
+ip_tags:
+  - ip_tag_name: tag
+    ip_list:
+      - {address_prefix: 1.2.3.5, prefix_len: 32}
+)EOF",
+                            config);
+  EXPECT_THROW_WITH_MESSAGE(IpTaggingFilterConfig(config, "prefix.", stats, runtime),
+                            EnvoyException,
+                            "HTTP IP Tagging Filter requires exactly one of ip_tags or "
+                            "ip_tags_path to be specified.");
+}
+
 } // namespace
 } // namespace IpTagging
 } // namespace HttpFilters
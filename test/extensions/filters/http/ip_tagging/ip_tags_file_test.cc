@@ -0,0 +1,154 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "common/network/cidr_range.h"
+#include "common/network/utility.h"
+
+#include "extensions/filters/http/ip_tagging/ip_tags_file.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/filesystem/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+using testing::SaveArg;
+using testing::UnorderedElementsAre;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace IpTagging {
+namespace {
+
+typedef std::vector<std::pair<std::string, std::vector<Network::Address::CidrRange>>> TagData;
+
+TagData makeTagData(const std::vector<std::pair<std::string, std::vector<std::string>>>& tags) {
+  TagData tag_data;
+  for (const auto& tag : tags) {
+    tag_data.emplace_back(tag.first, std::vector<Network::Address::CidrRange>());
+    for (const auto& range : tag.second) {
+      tag_data.back().second.push_back(Network::Address::CidrRange::create(range));
+    }
+  }
+  return tag_data;
+}
+
+std::vector<std::string> getTags(const IpTagsFile& file, const std::string& address) {
+  return file.getTags(Network::Utility::parseInternetAddress(address));
+}
+
+TEST(IpTagsFileTest, EncodeAndLoad) {
+  const std::string path = TestEnvironment::writeStringToFileForTest(
+      "ip_tags", IpTagsFile::encode(makeTagData({
+                     {"internal", {"10.0.0.0/8", "fd00::/8"}},
+                     {"office", {"10.1.0.0/16"}},
+                     {"", {}},
+                 })));
+  const IpTagsFileConstSharedPtr file = IpTagsFile::load(path);
+
+  EXPECT_EQ(3U, file->numTags());
+  EXPECT_THAT(getTags(*file, "10.1.2.3"), UnorderedElementsAre("internal", "office"));
+  EXPECT_THAT(getTags(*file, "10.2.2.3"), UnorderedElementsAre("internal"));
+  EXPECT_THAT(getTags(*file, "fd12::1"), UnorderedElementsAre("internal"));
+  EXPECT_TRUE(getTags(*file, "11.0.0.1").empty());
+  EXPECT_TRUE(getTags(*file, "2001:db8::1").empty());
+}
+
+TEST(IpTagsFileTest, MissingFile) {
+  EXPECT_THROW_WITH_REGEX(IpTagsFile::load(TestEnvironment::temporaryPath("missing_ip_tags")),
+                          EnvoyException, "unable to open IP tags file");
+}
+
+TEST(IpTagsFileTest, MalformedFiles) {
+  const std::string valid = IpTagsFile::encode(makeTagData({{"tag", {"10.0.0.0/8"}}}));
+  const auto expectMalformed = [](const std::string& contents, const std::string& regex) {
+    EXPECT_THROW_WITH_REGEX(
+        IpTagsFile::load(TestEnvironment::writeStringToFileForTest("malformed_ip_tags", contents)),
+        EnvoyException, regex);
+  };
+
+  expectMalformed("", "is truncated");
+  expectMalformed(valid.substr(0, valid.size() - 1), "out of bounds name for tag 0");
+  expectMalformed(valid.substr(0, 40), "is truncated");
+  expectMalformed("X" + valid.substr(1), "is not an IP tags file");
+
+  std::string bad_version = valid;
+  bad_version[8] = 2;
+  expectMalformed(bad_version, "unsupported version 2");
+
+  // The only range starts right after the header and the single tag entry.
+  std::string bad_tag_index = valid;
+  bad_tag_index[32] = 1;
+  expectMalformed(bad_tag_index, "invalid tag index in range 0");
+
+  std::string bad_prefix_length = valid;
+  bad_prefix_length[37] = 33;
+  expectMalformed(bad_prefix_length, "invalid CIDR range 0");
+}
+
+class IpTagsFileProviderTest : public testing::Test {
+public:
+  IpTagsFileProviderTest()
+      : path_(TestEnvironment::writeStringToFileForTest(
+            "provider_ip_tags",
+            IpTagsFile::encode(makeTagData({{"before", {"10.0.0.0/8"}}})))),
+        registry_(std::make_shared<IpTagsFileRegistry>()) {}
+
+  IpTagsFileProviderSharedPtr createProvider() {
+    auto* watcher = new NiceMock<Filesystem::MockWatcher>();
+    EXPECT_CALL(dispatcher_, createFilesystemWatcher_()).WillOnce(Return(watcher));
+    EXPECT_CALL(*watcher, addWatch(path_, Filesystem::Watcher::Events::MovedTo, _))
+        .WillOnce(SaveArg<2>(&on_changed_cb_));
+    return registry_->getProvider(path_, dispatcher_, tls_);
+  }
+
+  // Replace the file the way it has to be done in production: by moving a new file into place.
+  void replaceFile(const std::string& contents) {
+    const std::string new_path =
+        TestEnvironment::writeStringToFileForTest("provider_ip_tags.new", contents);
+    ASSERT_EQ(0, ::rename(new_path.c_str(), path_.c_str()));
+    on_changed_cb_(Filesystem::Watcher::Events::MovedTo);
+  }
+
+  const std::string path_;
+  IpTagsFileRegistrySharedPtr registry_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Filesystem::Watcher::OnChangedCb on_changed_cb_;
+};
+
+TEST_F(IpTagsFileProviderTest, Reload) {
+  const IpTagsFileProviderSharedPtr provider = createProvider();
+  EXPECT_THAT(getTags(provider->tags(), "10.0.0.1"), UnorderedElementsAre("before"));
+
+  replaceFile(IpTagsFile::encode(makeTagData({{"after", {"10.0.0.0/8"}}})));
+  EXPECT_THAT(getTags(provider->tags(), "10.0.0.1"), UnorderedElementsAre("after"));
+
+  // A malformed file is ignored.
+  replaceFile("malformed");
+  EXPECT_THAT(getTags(provider->tags(), "10.0.0.1"), UnorderedElementsAre("after"));
+}
+
+TEST_F(IpTagsFileProviderTest, SharedByPath) {
+  const IpTagsFileProviderSharedPtr provider = createProvider();
+  EXPECT_EQ(provider, registry_->getProvider(path_, dispatcher_, tls_));
+
+  // The registry stays alive for as long as its providers are in use.
+  std::weak_ptr<IpTagsFileRegistry> registry = registry_;
+  registry_.reset();
+  EXPECT_FALSE(registry.expired());
+}
+
+} // namespace
+} // namespace IpTagging
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
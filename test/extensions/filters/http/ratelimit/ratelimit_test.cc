@@ -91,7 +91,7 @@ public:
   NiceMock<Router::MockRateLimitPolicyEntry> vh_rate_limit_;
   std::vector<RateLimit::Descriptor> descriptor_{{{{"descriptor_key", "descriptor_value"}}}};
   NiceMock<LocalInfo::MockLocalInfo> local_info_;
-  Http::ContextImpl http_context_;
+  Http::ContextImpl http_context_{stats_store_.symbolTable()};
 };
 
 TEST_F(HttpRateLimitFilterTest, NoRoute) {
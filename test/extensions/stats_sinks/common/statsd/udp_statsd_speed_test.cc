@@ -0,0 +1,116 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "common/common/fmt.h"
+#include "common/stats/isolated_store_impl.h"
+#include "common/stats/source_impl.h"
+
+#include "extensions/stat_sinks/common/statsd/statsd.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/network_utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace StatSinks {
+namespace Common {
+namespace Statsd {
+
+// Discards datagrams, so that only formatting and batching are measured.
+class NullWriter : public Writer {
+public:
+  void write(const std::string&) override {}
+  void writeBatch(const std::vector<absl::string_view>& packets) override {
+    datagrams_ += packets.size();
+  }
+
+  uint64_t datagrams_{};
+};
+
+class UdpStatsdSinkPerf {
+public:
+  UdpStatsdSinkPerf(uint32_t num_counters, bool use_socket,
+                    absl::optional<uint64_t> max_bytes_per_datagram) {
+    for (uint32_t i = 0; i < num_counters; ++i) {
+      store_.counter(fmt::format("cluster.service_{}.upstream_rq_total", i)).inc();
+    }
+    std::shared_ptr<Writer> writer;
+    if (use_socket) {
+      // The listener is never read from, so once its receive buffer is full the kernel drops
+      // datagrams, as a busy statsd would.
+      listener_ = Network::Test::bindFreeLoopbackPort(Network::Address::IpVersion::v4,
+                                                      Network::Address::SocketType::Datagram);
+      writer = std::make_shared<Writer>(listener_.first);
+    } else {
+      writer = std::make_shared<NullWriter>();
+    }
+    sink_ = std::make_unique<UdpStatsdSink>(tls_, writer, false, getDefaultPrefix(),
+                                            max_bytes_per_datagram);
+  }
+
+  ~UdpStatsdSinkPerf() { tls_.shutdownThread(); }
+
+  // Gives every counter a delta, so that all of them are flushed.
+  void incrementCounters() {
+    for (const Stats::CounterSharedPtr& counter : store_.counters()) {
+      counter->inc();
+    }
+  }
+
+  void flush() {
+    Stats::SourceSnapshotImpl snapshot(store_);
+    sink_->flush(snapshot);
+  }
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  testing::NiceMock<ThreadLocal::MockInstance> tls_;
+  std::pair<Network::Address::InstanceConstSharedPtr, Network::IoHandlePtr> listener_;
+  std::unique_ptr<UdpStatsdSink> sink_;
+};
+
+} // namespace Statsd
+} // namespace Common
+} // namespace StatSinks
+} // namespace Extensions
+} // namespace Envoy
+
+using Envoy::Extensions::StatSinks::Common::Statsd::UdpStatsdSinkPerf;
+
+// Flushes 100k counters, one per datagram. Arg 0 discards the datagrams and arg 1 sends them to
+// a loopback socket.
+static void BM_FlushCountersDatagramPerMetric(benchmark::State& state) {
+  UdpStatsdSinkPerf context(100000, state.range(0) == 1, absl::nullopt);
+  for (auto _ : state) {
+    state.PauseTiming();
+    context.incrementCounters();
+    state.ResumeTiming();
+    context.flush();
+  }
+  state.SetItemsProcessed(state.iterations() * 100000);
+}
+BENCHMARK(BM_FlushCountersDatagramPerMetric)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Flushes 100k counters packed into datagrams of up to 1432 bytes.
+static void BM_FlushCountersCoalesced(benchmark::State& state) {
+  UdpStatsdSinkPerf context(100000, state.range(0) == 1, 1432);
+  for (auto _ : state) {
+    state.PauseTiming();
+    context.incrementCounters();
+    state.ResumeTiming();
+    context.flush();
+  }
+  state.SetItemsProcessed(state.iterations() * 100000);
+}
+BENCHMARK(BM_FlushCountersCoalesced)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
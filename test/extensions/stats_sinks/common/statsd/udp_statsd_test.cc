@@ -1,5 +1,6 @@
 #include <chrono>
 
+#include "common/common/utility.h"
 #include "common/network/address_impl.h"
 #include "common/network/utility.h"
 
@@ -15,6 +16,8 @@
 #include "gtest/gtest.h"
 #include "spdlog/spdlog.h"
 
+using testing::_;
+using testing::Invoke;
 using testing::NiceMock;
 
 namespace Envoy {
@@ -27,6 +30,13 @@ namespace {
 class MockWriter : public Writer {
 public:
   MOCK_METHOD1(write, void(const std::string& message));
+
+  // Datagrams are checked one at a time through write().
+  void writeBatch(const std::vector<absl::string_view>& packets) override {
+    for (absl::string_view packet : packets) {
+      write(std::string(packet));
+    }
+  }
 };
 
 class UdpStatsdSinkTest : public testing::TestWithParam<Network::Address::IpVersion> {};
@@ -73,6 +83,26 @@ TEST_P(UdpStatsdSinkTest, InitWithIpAddress) {
   tls_.shutdownThread();
 }
 
+// Datagrams written in a batch arrive at the statsd listener intact.
+TEST_P(UdpStatsdSinkTest, WriteBatch) {
+  auto listener =
+      Network::Test::bindFreeLoopbackPort(GetParam(), Network::Address::SocketType::Datagram);
+  Writer writer(listener.first);
+
+  std::vector<std::string> messages;
+  for (uint32_t i = 0; i < 100; ++i) {
+    messages.push_back(fmt::format("envoy.counter_{}:{}|c", i, i));
+  }
+  writer.writeBatch(std::vector<absl::string_view>(messages.begin(), messages.end()));
+
+  char buffer[256];
+  for (const std::string& message : messages) {
+    const ssize_t received = ::recv(listener.second->fd(), buffer, sizeof(buffer), 0);
+    ASSERT_GT(received, 0);
+    EXPECT_EQ(message, std::string(buffer, received));
+  }
+}
+
 class UdpStatsdSinkWithTagsTest : public testing::TestWithParam<Network::Address::IpVersion> {};
 INSTANTIATE_TEST_SUITE_P(IpVersions, UdpStatsdSinkWithTagsTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
@@ -178,6 +208,149 @@ TEST(UdpStatsdSinkTest, CheckActualStatsWithCustomPrefix) {
   tls_.shutdownThread();
 }
 
+TEST(UdpStatsdSinkTest, SkipsUnchangedCounters) {
+  NiceMock<Stats::MockSource> source;
+  auto writer_ptr = std::make_shared<testing::StrictMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false);
+
+  auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+  counter->name_ = "test_counter";
+  counter->used_ = true;
+  counter->latch_ = 0;
+  source.counters_.push_back(counter);
+
+  sink.flush(source);
+
+  counter->latch_ = 2;
+  EXPECT_CALL(*writer_ptr, write("envoy.test_counter:2|c"));
+  sink.flush(source);
+
+  tls_.shutdownThread();
+}
+
+TEST(UdpStatsdSinkTest, CoalescesDatagrams) {
+  NiceMock<Stats::MockSource> source;
+  auto writer_ptr = std::make_shared<testing::StrictMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false, "envoy", 40);
+
+  for (const std::string& name : {"c1", "c2", "a_counter_with_a_very_long_name", "c3"}) {
+    auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+    counter->name_ = name;
+    counter->used_ = true;
+    counter->latch_ = 10;
+    source.counters_.push_back(counter);
+  }
+  auto gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  gauge->name_ = "g";
+  gauge->value_ = 5;
+  gauge->used_ = true;
+  source.gauges_.push_back(gauge);
+
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*writer_ptr, write("envoy.c1:10|c\nenvoy.c2:10|c"));
+    // A line that does not fit in a datagram with any other goes in one of its own.
+    EXPECT_CALL(*writer_ptr, write("envoy.a_counter_with_a_very_long_name:10|c"));
+    EXPECT_CALL(*writer_ptr, write("envoy.c3:10|c\nenvoy.g:5|g"));
+  }
+  sink.flush(source);
+
+  tls_.shutdownThread();
+}
+
+// Checks the batches of datagrams themselves, rather than each datagram through write().
+class MockBatchWriter : public Writer {
+public:
+  MOCK_METHOD1(write, void(const std::string& message));
+  MOCK_METHOD1(writeBatch, void(const std::vector<absl::string_view>& packets));
+};
+
+// Datagrams are sent in batches of a bounded size.
+TEST(UdpStatsdSinkTest, LargeFlush) {
+  NiceMock<Stats::MockSource> source;
+  auto writer_ptr = std::make_shared<NiceMock<MockBatchWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false);
+
+  for (uint32_t i = 0; i < 1000; ++i) {
+    auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+    counter->name_ = fmt::format("counter_{}", i);
+    counter->used_ = true;
+    counter->latch_ = i + 1;
+    source.counters_.push_back(counter);
+  }
+
+  std::vector<std::vector<std::string>> batches;
+  EXPECT_CALL(*writer_ptr, write(_)).Times(0);
+  EXPECT_CALL(*writer_ptr, writeBatch(_))
+      .WillRepeatedly(Invoke([&](const std::vector<absl::string_view>& packets) {
+        batches.emplace_back(packets.begin(), packets.end());
+      }));
+  sink.flush(source);
+
+  // 1000 datagrams of one line each, in 15 full batches of 64 and one of 40.
+  ASSERT_EQ(16U, batches.size());
+  uint32_t i = 0;
+  for (const std::vector<std::string>& batch : batches) {
+    EXPECT_EQ(&batch == &batches.back() ? 40U : 64U, batch.size());
+    for (const std::string& datagram : batch) {
+      EXPECT_EQ(fmt::format("envoy.counter_{}:{}|c", i, i + 1), datagram);
+      ++i;
+    }
+  }
+  EXPECT_EQ(1000U, i);
+
+  tls_.shutdownThread();
+}
+
+// With a datagram size limit, lines are coalesced into datagrams up to the limit, and those are
+// sent in batches of a bounded size.
+TEST(UdpStatsdSinkTest, LargeFlushWithMaxBytesPerDatagram) {
+  NiceMock<Stats::MockSource> source;
+  auto writer_ptr = std::make_shared<NiceMock<MockBatchWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  const uint64_t max_bytes_per_datagram = 512;
+  UdpStatsdSink sink(tls_, writer_ptr, false, "envoy", max_bytes_per_datagram);
+
+  for (uint32_t i = 0; i < 10000; ++i) {
+    auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+    counter->name_ = fmt::format("counter_{}", i);
+    counter->used_ = true;
+    counter->latch_ = i + 1;
+    source.counters_.push_back(counter);
+  }
+
+  std::vector<std::vector<std::string>> batches;
+  EXPECT_CALL(*writer_ptr, write(_)).Times(0);
+  EXPECT_CALL(*writer_ptr, writeBatch(_))
+      .WillRepeatedly(Invoke([&](const std::vector<absl::string_view>& packets) {
+        batches.emplace_back(packets.begin(), packets.end());
+      }));
+  sink.flush(source);
+
+  // Around 20 lines fit in a datagram, so the 10000 lines need several batches.
+  ASSERT_GT(batches.size(), 1U);
+  uint32_t i = 0;
+  for (const std::vector<std::string>& batch : batches) {
+    EXPECT_LE(batch.size(), 64U);
+    if (&batch != &batches.back()) {
+      EXPECT_EQ(64U, batch.size());
+    }
+    for (const std::string& datagram : batch) {
+      EXPECT_LE(datagram.size(), max_bytes_per_datagram);
+      for (absl::string_view line : StringUtil::splitToken(datagram, "\n")) {
+        EXPECT_EQ(fmt::format("envoy.counter_{}:{}|c", i, i + 1), line);
+        ++i;
+      }
+    }
+  }
+  EXPECT_EQ(10000U, i);
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkWithTagsTest, CheckActualStats) {
   NiceMock<Stats::MockSource> source;
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
@@ -1,3 +1,6 @@
+#include "common/stats/histogram_impl.h"
+#include "common/stats/log_linear_histogram.h"
+
 #include "extensions/stat_sinks/metrics_service/grpc_metrics_service_impl.h"
 
 #include "test/mocks/common.h"
@@ -66,6 +69,24 @@ TEST_F(GrpcMetricsStreamerImplTest, BasicFlow) {
       std::make_unique<envoy::service::metrics::v2::StreamMetricsResponse>());
 }
 
+// Test that the stream is reported inactive until started, and after it is closed.
+TEST_F(GrpcMetricsStreamerImplTest, StreamActive) {
+  InSequence s;
+
+  EXPECT_FALSE(streamer_->streamActive());
+  MockMetricsStream stream1;
+  MetricsServiceCallbacks* callbacks1;
+  expectStreamStart(stream1, &callbacks1);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream1, sendMessage(_, false));
+  envoy::service::metrics::v2::StreamMetricsMessage message_metrics1;
+  streamer_->send(message_metrics1);
+  EXPECT_TRUE(streamer_->streamActive());
+
+  callbacks1->onRemoteClose(Grpc::Status::Internal, "bad");
+  EXPECT_FALSE(streamer_->streamActive());
+}
+
 // Test that stream failure is handled correctly.
 TEST_F(GrpcMetricsStreamerImplTest, StreamFailure) {
   InSequence s;
@@ -85,6 +106,7 @@ class MockGrpcMetricsStreamer : public GrpcMetricsStreamer {
 public:
   // GrpcMetricsStreamer
   MOCK_METHOD1(send, void(envoy::service::metrics::v2::StreamMetricsMessage& message));
+  MOCK_CONST_METHOD0(streamActive, bool());
 };
 
 class TestGrpcMetricsStreamer : public GrpcMetricsStreamer {
@@ -93,7 +115,14 @@ public:
   // GrpcMetricsStreamer
   void send(envoy::service::metrics::v2::StreamMetricsMessage& message) {
     metric_count = message.envoy_metrics_size();
+    last_message = message;
+    ++send_count;
   }
+  bool streamActive() const { return stream_active; }
+
+  envoy::service::metrics::v2::StreamMetricsMessage last_message;
+  int send_count{};
+  bool stream_active{true};
 };
 
 class MetricsServiceSinkTest : public testing::Test {};
@@ -154,6 +183,126 @@ TEST(MetricsServiceSinkTest, CheckStatsCount) {
   EXPECT_EQ(1, (*streamer_).metric_count);
 }
 
+// In incremental mode, metrics are defined once per stream and only changes are sent.
+TEST(MetricsServiceSinkTest, IncrementalUpdates) {
+  NiceMock<Stats::MockSource> source;
+  Event::SimulatedTimeSystem time_system;
+  std::shared_ptr<TestGrpcMetricsStreamer> streamer{new TestGrpcMetricsStreamer()};
+  streamer->stream_active = false;
+
+  MetricsServiceSink sink(streamer, time_system, true);
+
+  auto counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+  counter->name_ = "test_counter";
+  counter->value_ = 1;
+  counter->used_ = true;
+  source.counters_.push_back(counter);
+
+  auto gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  gauge->name_ = "test_gauge";
+  gauge->value_ = 5;
+  gauge->used_ = true;
+  source.gauges_.push_back(gauge);
+
+  auto unused = std::make_shared<NiceMock<Stats::MockCounter>>();
+  unused->name_ = "unused_counter";
+  source.counters_.push_back(unused);
+
+  // The first flush on a stream defines and sends every metric in use.
+  sink.flush(source);
+  streamer->stream_active = true;
+  EXPECT_EQ(1, streamer->send_count);
+  const auto& message = streamer->last_message;
+  EXPECT_EQ(0, message.envoy_metrics_size());
+  ASSERT_EQ(2, message.metric_definitions_size());
+  EXPECT_EQ("test_counter", message.metric_definitions(0).name());
+  EXPECT_EQ(envoy::service::metrics::v2::StreamMetricsMessage::MetricDefinition::COUNTER,
+            message.metric_definitions(0).type());
+  EXPECT_EQ("test_gauge", message.metric_definitions(1).name());
+  EXPECT_EQ(envoy::service::metrics::v2::StreamMetricsMessage::MetricDefinition::GAUGE,
+            message.metric_definitions(1).type());
+  ASSERT_EQ(2, message.metric_updates_size());
+  const uint64_t counter_id = message.metric_definitions(0).id();
+  const uint64_t gauge_id = message.metric_definitions(1).id();
+  EXPECT_NE(counter_id, gauge_id);
+  EXPECT_EQ(counter_id, message.metric_updates(0).id());
+  EXPECT_EQ(1, message.metric_updates(0).value());
+  EXPECT_EQ(gauge_id, message.metric_updates(1).id());
+  EXPECT_EQ(5, message.metric_updates(1).value());
+
+  // Nothing is sent when nothing changed.
+  sink.flush(source);
+  EXPECT_EQ(1, streamer->send_count);
+
+  // Only the changed metric is sent, by id.
+  counter->value_ = 3;
+  sink.flush(source);
+  EXPECT_EQ(2, streamer->send_count);
+  EXPECT_EQ(0, message.metric_definitions_size());
+  ASSERT_EQ(1, message.metric_updates_size());
+  EXPECT_EQ(counter_id, message.metric_updates(0).id());
+  EXPECT_EQ(3, message.metric_updates(0).value());
+
+  // A metric used for the first time is defined with a new id.
+  unused->used_ = true;
+  sink.flush(source);
+  EXPECT_EQ(3, streamer->send_count);
+  ASSERT_EQ(1, message.metric_definitions_size());
+  EXPECT_EQ("unused_counter", message.metric_definitions(0).name());
+  EXPECT_NE(counter_id, message.metric_definitions(0).id());
+  EXPECT_NE(gauge_id, message.metric_definitions(0).id());
+  ASSERT_EQ(1, message.metric_updates_size());
+  EXPECT_EQ(message.metric_definitions(0).id(), message.metric_updates(0).id());
+
+  // After the stream is lost, everything is defined and sent again.
+  streamer->stream_active = false;
+  sink.flush(source);
+  EXPECT_EQ(4, streamer->send_count);
+  EXPECT_EQ(3, message.metric_definitions_size());
+  EXPECT_EQ(3, message.metric_updates_size());
+}
+
+// Summaries are defined with their quantiles, and only sent for intervals with samples.
+TEST(MetricsServiceSinkTest, IncrementalHistogramUpdates) {
+  NiceMock<Stats::MockSource> source;
+  Event::SimulatedTimeSystem time_system;
+  std::shared_ptr<TestGrpcMetricsStreamer> streamer{new TestGrpcMetricsStreamer()};
+
+  MetricsServiceSink sink(streamer, time_system, true);
+
+  auto histogram = std::make_shared<NiceMock<Stats::MockParentHistogram>>();
+  histogram->name_ = "test_histogram";
+  histogram->used_ = true;
+  source.histograms_.push_back(histogram);
+  const size_t num_quantiles = histogram->histogram_stats_->supportedQuantiles().size();
+
+  sink.flush(source);
+  EXPECT_EQ(1, streamer->send_count);
+  const auto& message = streamer->last_message;
+  ASSERT_EQ(1, message.metric_definitions_size());
+  EXPECT_EQ(envoy::service::metrics::v2::StreamMetricsMessage::MetricDefinition::SUMMARY,
+            message.metric_definitions(0).type());
+  EXPECT_EQ(num_quantiles, message.metric_definitions(0).quantiles_size());
+  ASSERT_EQ(1, message.metric_updates_size());
+  EXPECT_EQ(0, message.metric_updates(0).value());
+  EXPECT_EQ(num_quantiles, message.metric_updates(0).quantile_values_size());
+
+  // No samples in the interval.
+  sink.flush(source);
+  EXPECT_EQ(1, streamer->send_count);
+
+  Stats::LogLinearHistogram samples(5);
+  samples.recordValue(10);
+  samples.recordValue(20);
+  dynamic_cast<Stats::HistogramStatisticsImpl&>(*histogram->histogram_stats_).refresh(samples);
+  sink.flush(source);
+  EXPECT_EQ(2, streamer->send_count);
+  EXPECT_EQ(0, message.metric_definitions_size());
+  ASSERT_EQ(1, message.metric_updates_size());
+  EXPECT_EQ(2, message.metric_updates(0).value());
+  EXPECT_EQ(num_quantiles, message.metric_updates(0).quantile_values_size());
+}
+
 } // namespace
 } // namespace MetricsService
 } // namespace StatSinks
@@ -114,6 +114,34 @@ TEST_P(StatsConfigParameterizedTest, UdpSinkCustomPrefix) {
   auto udp_sink = dynamic_cast<Common::Statsd::UdpStatsdSink*>(sink.get());
   ASSERT_NE(udp_sink, nullptr);
   EXPECT_EQ(udp_sink->getPrefix(), customPrefix);
+  EXPECT_FALSE(udp_sink->getMaxBytesPerDatagramForTest().has_value());
+}
+
+TEST_P(StatsConfigParameterizedTest, UdpSinkMaxBytesPerDatagram) {
+  const std::string name = StatsSinkNames::get().Statsd;
+
+  envoy::config::metrics::v2::StatsdSink sink_config;
+  envoy::api::v2::core::Address& address = *sink_config.mutable_address();
+  envoy::api::v2::core::SocketAddress& socket_address = *address.mutable_socket_address();
+  socket_address.set_protocol(envoy::api::v2::core::SocketAddress::UDP);
+  auto loopback_flavor = Network::Test::getCanonicalLoopbackAddress(GetParam());
+  socket_address.set_address(loopback_flavor->ip()->addressAsString());
+  socket_address.set_port_value(8125);
+  sink_config.mutable_max_bytes_per_datagram()->set_value(1432);
+
+  Server::Configuration::StatsSinkFactory* factory =
+      Registry::FactoryRegistry<Server::Configuration::StatsSinkFactory>::getFactory(name);
+  ASSERT_NE(factory, nullptr);
+  ProtobufTypes::MessagePtr message = factory->createEmptyConfigProto();
+  MessageUtil::jsonConvert(sink_config, *message);
+
+  NiceMock<Server::MockInstance> server;
+  Stats::SinkPtr sink = factory->createStatsSink(*message, server);
+  ASSERT_NE(sink, nullptr);
+
+  auto udp_sink = dynamic_cast<Common::Statsd::UdpStatsdSink*>(sink.get());
+  ASSERT_NE(udp_sink, nullptr);
+  EXPECT_EQ(1432, udp_sink->getMaxBytesPerDatagramForTest().value());
 }
 
 TEST(StatsConfigTest, TcpSinkDefaultPrefix) {
@@ -70,6 +70,11 @@ public:
     return ScopePtr{new TestScopeWrapper(lock_, wrapped_scope_->createScope(name))};
   }
 
+  ScopePtr createEvictableScope(const std::string& name) override {
+    Thread::LockGuard lock(lock_);
+    return ScopePtr{new TestScopeWrapper(lock_, wrapped_scope_->createEvictableScope(name))};
+  }
+
   void deliverHistogramToSinks(const Histogram& histogram, uint64_t value) override {
     Thread::LockGuard lock(lock_);
     wrapped_scope_->deliverHistogramToSinks(histogram, value);
@@ -136,6 +141,10 @@ public:
     Thread::LockGuard lock(lock_);
     return ScopePtr{new TestScopeWrapper(lock_, store_.createScope(name))};
   }
+  ScopePtr createEvictableScope(const std::string& name) override {
+    Thread::LockGuard lock(lock_);
+    return ScopePtr{new TestScopeWrapper(lock_, store_.createEvictableScope(name))};
+  }
   void deliverHistogramToSinks(const Histogram&, uint64_t) override {}
   Gauge& gaugeFromStatName(StatName name) override {
     Thread::LockGuard lock(lock_);
@@ -173,13 +182,20 @@ public:
     return store_.histograms();
   }
 
+  std::vector<ScopeMemoryStats> scopeMemoryStats() const override {
+    Thread::LockGuard lock(lock_);
+    return store_.scopeMemoryStats();
+  }
+
   // Stats::StoreRoot
   void addSink(Sink&) override {}
   void setTagProducer(TagProducerPtr&&) override {}
   void setStatsMatcher(StatsMatcherPtr&&) override {}
+  void setHistogramSettings(const HistogramSettings&) override {}
   void initializeThreading(Event::Dispatcher&, ThreadLocal::Instance&) override {}
   void shutdownThreading() override {}
   void mergeHistograms(PostMergeCb) override {}
+  void evictIdleStats(uint32_t) override {}
   Source& source() override { return source_; }
 
 private:
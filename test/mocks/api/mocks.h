@@ -87,6 +87,9 @@ class MockLinuxOsSysCalls : public LinuxOsSysCallsImpl {
 public:
   // Api::LinuxOsSysCalls
   MOCK_METHOD3(sched_getaffinity, SysCallIntResult(pid_t pid, size_t cpusetsize, cpu_set_t* mask));
+  MOCK_METHOD2(pipe2, SysCallIntResult(int pipefd[2], int flags));
+  MOCK_METHOD6(splice, SysCallSizeResult(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out,
+                                         size_t len, unsigned int flags));
 };
 #endif
 
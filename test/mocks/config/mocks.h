@@ -88,6 +88,8 @@ public:
   MOCK_METHOD0(onEstablishmentFailure, void());
   MOCK_METHOD1(onDiscoveryResponse,
                void(std::unique_ptr<envoy::api::v2::DiscoveryResponse>&& message));
+  MOCK_METHOD0(useResponseArena, bool());
+  MOCK_METHOD1(onArenaDiscoveryResponse, void(envoy::api::v2::DiscoveryResponse& message));
   MOCK_METHOD0(onWriteable, void());
 };
 
@@ -83,6 +83,8 @@ public:
   MOCK_METHOD1(setDelayedCloseTimeout, void(std::chrono::milliseconds));
   MOCK_CONST_METHOD0(delayedCloseTimeout, std::chrono::milliseconds());
   MOCK_CONST_METHOD0(transportFailureReason, absl::string_view());
+  MOCK_METHOD0(spliceIoHandle, IoHandle*());
+  MOCK_METHOD2(onSpliced, void(uint64_t bytes_read, uint64_t bytes_written));
 };
 
 /**
@@ -129,6 +131,8 @@ public:
   MOCK_METHOD1(setDelayedCloseTimeout, void(std::chrono::milliseconds));
   MOCK_CONST_METHOD0(delayedCloseTimeout, std::chrono::milliseconds());
   MOCK_CONST_METHOD0(transportFailureReason, absl::string_view());
+  MOCK_METHOD0(spliceIoHandle, IoHandle*());
+  MOCK_METHOD2(onSpliced, void(uint64_t bytes_read, uint64_t bytes_written));
 
   // Network::ClientConnection
   MOCK_METHOD0(connect, void());
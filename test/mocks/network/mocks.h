@@ -318,6 +318,10 @@ public:
   MOCK_METHOD1(removeListeners, void(uint64_t listener_tag));
   MOCK_METHOD1(stopListeners, void(uint64_t listener_tag));
   MOCK_METHOD0(stopListeners, void());
+  MOCK_METHOD2(removeFilterChains, void(uint64_t listener_tag,
+                                        const std::list<const FilterChain*>& filter_chains));
+  MOCK_METHOD2(removeListenersWhenIdle,
+               void(uint64_t listener_tag, std::function<void()> completion));
   MOCK_METHOD0(disableListeners, void());
   MOCK_METHOD0(enableListeners, void());
 };
@@ -373,6 +377,7 @@ public:
   MOCK_METHOD2(doWrite, IoResult(Buffer::Instance& buffer, bool end_stream));
   MOCK_METHOD0(onConnected, void());
   MOCK_CONST_METHOD0(ssl, const Ssl::ConnectionInfo*());
+  MOCK_CONST_METHOD0(passesThrough, bool());
 
   TransportSocketCallbacks* callbacks_{};
 };
@@ -21,6 +21,9 @@
 #include "envoy/thread_local/thread_local.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/runtime/key_registry.h"
+
+#include "absl/types/optional.h"
 #include "gmock/gmock.h"
 
 namespace Envoy {
@@ -45,7 +48,9 @@ class TestCorsPolicy : public CorsPolicy {
 public:
   // Router::CorsPolicy
   const std::list<std::string>& allowOrigins() const override { return allow_origin_; };
-  const std::list<std::regex>& allowOriginRegexes() const override { return allow_origin_regex_; };
+  const std::vector<Regex::CompiledMatcherPtr>& allowOriginRegexes() const override {
+    return allow_origin_regex_;
+  };
   const std::string& allowMethods() const override { return allow_methods_; };
   const std::string& allowHeaders() const override { return allow_headers_; };
   const std::string& exposeHeaders() const override { return expose_headers_; };
@@ -55,7 +60,7 @@ public:
   bool shadowEnabled() const override { return shadow_enabled_; };
 
   std::list<std::string> allow_origin_{};
-  std::list<std::regex> allow_origin_regex_{};
+  std::vector<Regex::CompiledMatcherPtr> allow_origin_regex_;
   std::string allow_methods_{};
   std::string allow_headers_{};
   std::string expose_headers_{};
@@ -163,10 +168,15 @@ public:
   // Router::ShadowPolicy
   const std::string& cluster() const override { return cluster_; }
   const std::string& runtimeKey() const override { return runtime_key_; }
+  const Runtime::Key& resolvedRuntimeKey() const override {
+    resolved_runtime_key_ = Runtime::KeyRegistrySingleton::get().resolve(runtime_key_);
+    return *resolved_runtime_key_;
+  }
   const envoy::type::FractionalPercent& defaultValue() const override { return default_value_; }
 
   std::string cluster_;
   std::string runtime_key_;
+  mutable absl::optional<Runtime::Key> resolved_runtime_key_;
   envoy::type::FractionalPercent default_value_;
 };
 
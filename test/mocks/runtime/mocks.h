@@ -39,6 +39,10 @@ public:
     }
   }
 
+  // The variants taking a Runtime::Key forward to the mocked variants taking the key's name.
+  using Snapshot::featureEnabled;
+  using Snapshot::getInteger;
+
   MOCK_CONST_METHOD1(deprecatedFeatureEnabled, bool(const std::string& key));
   MOCK_CONST_METHOD1(runtimeFeatureEnabled, bool(absl::string_view key));
   MOCK_CONST_METHOD2(featureEnabled, bool(const std::string& key, uint64_t default_value));
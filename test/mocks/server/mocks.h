@@ -82,6 +82,7 @@ public:
   MOCK_CONST_METHOD0(mutexTracingEnabled, bool());
   MOCK_CONST_METHOD0(libeventBufferEnabled, bool());
   MOCK_CONST_METHOD0(cpusetThreadsEnabled, bool());
+  MOCK_CONST_METHOD0(bootstrapCachePath, const std::string&());
   MOCK_CONST_METHOD0(toCommandLineOptions, Server::CommandLineOptionsPtr());
 
   std::string config_path_;
@@ -99,6 +100,7 @@ public:
   bool signal_handling_enabled_{true};
   bool mutex_tracing_enabled_{};
   bool cpuset_threads_enabled_{};
+  std::string bootstrap_cache_path_;
 };
 
 class MockConfigTracker : public ConfigTracker {
@@ -152,6 +154,10 @@ public:
   MOCK_CONST_METHOD0(getRequestHeaders, Http::HeaderMap&());
   MOCK_CONST_METHOD0(getDecoderFilterCallbacks,
                      NiceMock<Http::MockStreamDecoderFilterCallbacks>&());
+  void setChunkedResponse(ChunkedResponsePtr&& response) override {
+    setChunkedResponse_(response);
+  }
+  MOCK_METHOD1(setChunkedResponse_, void(ChunkedResponsePtr& response));
 };
 
 class MockDrainManager : public DrainManager {
@@ -301,12 +307,23 @@ public:
     remove_listener_completion_ = nullptr;
   }
 
+  void callIdleRemovalCompletion() {
+    EXPECT_NE(nullptr, remove_listener_when_idle_completion_);
+    remove_listener_when_idle_completion_();
+    remove_listener_when_idle_completion_ = nullptr;
+  }
+
   // Server::Worker
   MOCK_METHOD2(addListener,
                void(Network::ListenerConfig& listener, AddListenerCompletion completion));
   MOCK_METHOD0(numConnections, uint64_t());
   MOCK_METHOD2(removeListener,
                void(Network::ListenerConfig& listener, std::function<void()> completion));
+  MOCK_METHOD2(removeListenerWhenIdle,
+               void(Network::ListenerConfig& listener, std::function<void()> completion));
+  MOCK_METHOD2(removeFilterChains,
+               void(Network::ListenerConfig& listener,
+                    const std::list<const Network::FilterChain*>& filter_chains));
   MOCK_METHOD1(start, void(GuardDog& guard_dog));
   MOCK_METHOD2(initializeStats, void(Stats::Scope& scope, const std::string& prefix));
   MOCK_METHOD0(stop, void());
@@ -315,6 +332,7 @@ public:
 
   AddListenerCompletion add_listener_completion_;
   std::function<void()> remove_listener_completion_;
+  std::function<void()> remove_listener_when_idle_completion_;
 };
 
 class MockOverloadManager : public OverloadManager {
@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "common/stats/fake_symbol_table_impl.h"
+#include "common/stats/scope_prefixer.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -82,6 +83,9 @@ MockStore::MockStore() : StoreImpl(*fake_symbol_table_) {
     return *histogram;
   }));
   ON_CALL(*this, statsOptions()).WillByDefault(ReturnRef(stats_options_));
+  ON_CALL(*this, createScope_(_)).WillByDefault(Invoke([this](const std::string& name) -> Scope* {
+    return new ScopePrefixer(name, *this);
+  }));
 }
 MockStore::~MockStore() {}
 
@@ -35,7 +35,6 @@ public:
   // Note: cannot be mocked because it is accessed as a Property in a gmock EXPECT_CALL. This
   // creates a deadlock in gmock and is an unintended use of mock functions.
   std::string name() const override { return name_; };
-  const char* nameCStr() const override { return name_.c_str(); };
 
   MOCK_METHOD1(add, void(uint64_t amount));
   MOCK_METHOD0(inc, void());
@@ -61,7 +60,6 @@ public:
   // Note: cannot be mocked because it is accessed as a Property in a gmock EXPECT_CALL. This
   // creates a deadlock in gmock and is an unintended use of mock functions.
   std::string name() const override { return name_; };
-  const char* nameCStr() const override { return name_.c_str(); };
 
   MOCK_METHOD1(add, void(uint64_t amount));
   MOCK_METHOD0(dec, void());
@@ -87,7 +85,6 @@ public:
   // Note: cannot be mocked because it is accessed as a Property in a gmock EXPECT_CALL. This
   // creates a deadlock in gmock and is an unintended use of mock functions.
   std::string name() const override { return name_; };
-  const char* nameCStr() const override { return name_.c_str(); };
 
   MOCK_CONST_METHOD0(tagExtractedName, const std::string&());
   MOCK_CONST_METHOD0(tags, const std::vector<Tag>&());
@@ -107,7 +104,6 @@ public:
   // Note: cannot be mocked because it is accessed as a Property in a gmock EXPECT_CALL. This
   // creates a deadlock in gmock and is an unintended use of mock functions.
   std::string name() const override { return name_; };
-  const char* nameCStr() const override { return name_.c_str(); };
   void merge() override {}
   const std::string quantileSummary() const override { return ""; };
   const std::string bucketSummary() const override { return ""; };
@@ -149,6 +145,7 @@ public:
 
   MOCK_METHOD1(flush, void(Source& source));
   MOCK_METHOD2(onHistogramComplete, void(const Histogram& histogram, uint64_t value));
+  MOCK_CONST_METHOD0(supportsFlushThread, bool());
 };
 
 class SymbolTableProvider {
@@ -162,6 +159,9 @@ public:
   ~MockStore();
 
   ScopePtr createScope(const std::string& name) override { return ScopePtr{createScope_(name)}; }
+  ScopePtr createEvictableScope(const std::string& name) override {
+    return ScopePtr{createScope_(name)};
+  }
 
   MOCK_METHOD2(deliverHistogramToSinks, void(const Histogram& histogram, uint64_t value));
   MOCK_METHOD1(counter, Counter&(const std::string&));
@@ -172,6 +172,7 @@ public:
   MOCK_CONST_METHOD0(gauges, std::vector<GaugeSharedPtr>());
   MOCK_METHOD1(histogram, Histogram&(const std::string& name));
   MOCK_CONST_METHOD0(histograms, std::vector<ParentHistogramSharedPtr>());
+  MOCK_CONST_METHOD0(scopeMemoryStats, std::vector<ScopeMemoryStats>());
   MOCK_CONST_METHOD0(statsOptions, const StatsOptions&());
 
   testing::NiceMock<MockCounter> counter_;
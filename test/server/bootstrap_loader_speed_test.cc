@@ -0,0 +1,141 @@
+// Benchmarks for loading a large bootstrap with many static listeners and clusters, serially as
+// MessageUtil would, in parallel, and from the bootstrap cache.
+//
+// Note: this should be run with --compilation_mode=opt.
+
+#include <string>
+
+#include "common/common/fmt.h"
+#include "common/protobuf/utility.h"
+
+#include "server/bootstrap_loader.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+// A bootstrap with a listener for every ten clusters, each with a route to its clusters.
+std::string syntheticBootstrapYaml(size_t num_clusters) {
+  std::string yaml = "static_resources:\n  listeners:\n";
+  for (size_t i = 0; i < num_clusters / 10; i++) {
+    absl::StrAppend(&yaml, fmt::format(R"EOF(
+  - name: listener_{0}
+    address:
+      socket_address: {{ address: 127.0.0.1, port_value: {1} }}
+    filter_chains:
+    - filters:
+      - name: envoy.http_connection_manager
+        config:
+          stat_prefix: listener_{0}
+          http_filters: [{{ name: envoy.router }}]
+          route_config:
+            virtual_hosts:
+            - name: host_{0}
+              domains: ["host{0}.example.com"]
+              routes:
+)EOF",
+                                       i, 10000 + i));
+    for (size_t j = i * 10; j < (i + 1) * 10; j++) {
+      absl::StrAppend(&yaml, fmt::format("              - match: {{ prefix: \"/{0}\" }}\n"
+                                         "                route: {{ cluster: cluster_{0} }}\n",
+                                         j));
+    }
+  }
+  absl::StrAppend(&yaml, "  clusters:\n");
+  for (size_t i = 0; i < num_clusters; i++) {
+    absl::StrAppend(&yaml, fmt::format(R"EOF(
+  - name: cluster_{0}
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    circuit_breakers:
+      thresholds: [{{ max_connections: 1000, max_pending_requests: 1000 }}]
+    health_checks:
+    - timeout: 1s
+      interval: 5s
+      unhealthy_threshold: 3
+      healthy_threshold: 1
+      http_health_check: {{ path: /healthz }}
+    load_assignment:
+      cluster_name: cluster_{0}
+      endpoints:
+      - lb_endpoints:
+        - endpoint:
+            address:
+              socket_address: {{ address: service{0}.example.com, port_value: 443 }}
+)EOF",
+                                       i));
+  }
+  return yaml;
+}
+
+// The serial path bootstraps were loaded with: one YAML to proto conversion and one validation.
+static void BM_LoadBootstrapSerial(benchmark::State& state) {
+  const std::string yaml = syntheticBootstrapYaml(state.range(0));
+  for (auto _ : state) {
+    envoy::config::bootstrap::v2::Bootstrap bootstrap;
+    MessageUtil::loadFromYaml(yaml, bootstrap);
+    MessageUtil::validate(bootstrap);
+  }
+}
+BENCHMARK(BM_LoadBootstrapSerial)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadBootstrapParallel(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  const std::string yaml = syntheticBootstrapYaml(state.range(0));
+  BootstrapLoader loader(*api, state.range(1), "");
+  for (auto _ : state) {
+    envoy::config::bootstrap::v2::Bootstrap bootstrap;
+    loader.loadFromString(yaml, true, bootstrap);
+    loader.validate(bootstrap);
+  }
+}
+BENCHMARK(BM_LoadBootstrapParallel)
+    ->Args({1000, 1})
+    ->Args({1000, 8})
+    ->Args({10000, 1})
+    ->Args({10000, 8})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_LoadBootstrapCached(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  const std::string config_path = TestEnvironment::writeStringToFileForTest(
+      "bootstrap_loader_speed_test.yaml", syntheticBootstrapYaml(state.range(0)));
+  const std::string cache_path = TestEnvironment::temporaryPath("bootstrap_loader_speed_test");
+  TestUtility::createDirectory(cache_path);
+  BootstrapLoader loader(*api, state.range(1), cache_path);
+  {
+    // Fill the cache.
+    envoy::config::bootstrap::v2::Bootstrap bootstrap;
+    loader.load(config_path, "", bootstrap);
+  }
+  for (auto _ : state) {
+    envoy::config::bootstrap::v2::Bootstrap bootstrap;
+    loader.load(config_path, "", bootstrap);
+  }
+}
+BENCHMARK(BM_LoadBootstrapCached)
+    ->Args({1000, 1})
+    ->Args({1000, 8})
+    ->Args({10000, 1})
+    ->Args({10000, 8})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,161 @@
+#include <unistd.h>
+
+#include <string>
+
+#include "common/common/fmt.h"
+#include "common/protobuf/utility.h"
+
+#include "server/bootstrap_loader.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+const std::string& bootstrapYaml() {
+  CONSTRUCT_ON_FIRST_USE(std::string, R"EOF(
+admin:
+  access_log_path: /dev/null
+  address:
+    socket_address: { address: 127.0.0.1, port_value: 0 }
+static_resources:
+  listeners:
+  - name: listener_0
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 10000 }
+  - name: listener_1
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 10001 }
+  clusters:
+  - name: cluster_0
+    connect_timeout: 0.25s
+    hosts: [{ socket_address: { address: 127.0.0.1, port_value: 11000 }}]
+  - name: cluster_1
+    connectTimeout: 1s
+    hosts: [{ socket_address: { address: 127.0.0.1, port_value: 11001 }}]
+  - name: cluster_2
+    connect_timeout: 2s
+    hosts: [{ socket_address: { address: 127.0.0.1, port_value: 11002 }}]
+  secrets:
+  - name: secret_0
+stats_flush_interval: 1s
+)EOF");
+}
+
+class BootstrapLoaderTest : public testing::Test {
+public:
+  BootstrapLoaderTest() : api_(Api::createApiForTest()) {}
+
+  Api::ApiPtr api_;
+};
+
+// Static listeners and clusters parsed in parallel end up as a serial parse would put them.
+TEST_F(BootstrapLoaderTest, LoadFromString) {
+  envoy::config::bootstrap::v2::Bootstrap expected;
+  MessageUtil::loadFromYaml(bootstrapYaml(), expected);
+
+  for (uint32_t concurrency : {1, 2, 8}) {
+    BootstrapLoader loader(*api_, concurrency, "");
+    envoy::config::bootstrap::v2::Bootstrap bootstrap;
+    loader.loadFromString(bootstrapYaml(), true, bootstrap);
+    EXPECT_TRUE(TestUtility::protoEqual(expected, bootstrap)) << bootstrap.DebugString();
+
+    envoy::config::bootstrap::v2::Bootstrap from_json;
+    loader.loadFromString(MessageUtil::getJsonStringFromMessage(expected), false, from_json);
+    EXPECT_TRUE(TestUtility::protoEqual(expected, from_json)) << from_json.DebugString();
+  }
+}
+
+TEST_F(BootstrapLoaderTest, LoadWithoutStaticResources) {
+  BootstrapLoader loader(*api_, 4, "");
+  envoy::config::bootstrap::v2::Bootstrap bootstrap;
+  loader.loadFromString("stats_flush_interval: 2s", true, bootstrap);
+  EXPECT_FALSE(bootstrap.has_static_resources());
+  EXPECT_EQ(2, bootstrap.stats_flush_interval().seconds());
+  loader.validate(bootstrap);
+  EXPECT_FALSE(bootstrap.has_static_resources());
+}
+
+// The error of the first invalid resource is reported, whichever thread finds it.
+TEST_F(BootstrapLoaderTest, ParseError) {
+  BootstrapLoader loader(*api_, 4, "");
+  envoy::config::bootstrap::v2::Bootstrap bootstrap;
+  EXPECT_THROW_WITH_REGEX(loader.loadFromString(R"EOF(
+static_resources:
+  clusters:
+  - name: cluster_0
+  - name: cluster_1
+    bogus_field_1: 1
+  - name: cluster_2
+    bogus_field_2: 2
+)EOF",
+                                                true, bootstrap),
+                          EnvoyException, "bogus_field_1");
+
+  EXPECT_THROW(loader.loadFromString("{ not json", false, bootstrap), EnvoyException);
+}
+
+TEST_F(BootstrapLoaderTest, ValidationError) {
+  BootstrapLoader loader(*api_, 4, "");
+  envoy::config::bootstrap::v2::Bootstrap bootstrap;
+  loader.loadFromString(bootstrapYaml(), true, bootstrap);
+  loader.validate(bootstrap);
+
+  bootstrap.mutable_static_resources()->mutable_clusters(1)->clear_name();
+  EXPECT_THROW_WITH_REGEX(loader.validate(bootstrap), ProtoValidationException,
+                          "ClusterValidationError.Name");
+  // The listeners and clusters are left in place.
+  EXPECT_EQ(2, bootstrap.static_resources().listeners_size());
+  EXPECT_EQ(3, bootstrap.static_resources().clusters_size());
+
+  bootstrap.mutable_static_resources()->mutable_clusters(1)->set_name("cluster_1");
+  bootstrap.mutable_runtime()->set_subdirectory("envoy");
+  EXPECT_THROW_WITH_REGEX(loader.validate(bootstrap), ProtoValidationException,
+                          "BootstrapValidationError.Runtime");
+  EXPECT_EQ(2, bootstrap.static_resources().listeners_size());
+  EXPECT_EQ(3, bootstrap.static_resources().clusters_size());
+}
+
+// A bootstrap parsed once is read back from the cache by later loads of the same config.
+TEST_F(BootstrapLoaderTest, Cache) {
+  const std::string cache_dir = "bootstrap_loader_test_cache";
+  const std::string cache_path = TestEnvironment::temporaryPath(cache_dir);
+  TestUtility::createDirectory(cache_path);
+  const std::string config_path =
+      TestEnvironment::writeStringToFileForTest("bootstrap_loader_test.yaml", bootstrapYaml());
+  const std::string config_yaml = "stats_flush_interval: 3s";
+
+  BootstrapLoader loader(*api_, 2, cache_path);
+  const std::string cache_file = loader.cacheFilePath(bootstrapYaml(), config_yaml);
+  ::unlink(cache_file.c_str());
+  envoy::config::bootstrap::v2::Bootstrap bootstrap;
+  loader.load(config_path, config_yaml, bootstrap);
+  EXPECT_EQ(3, bootstrap.stats_flush_interval().seconds());
+  ASSERT_TRUE(api_->fileSystem().fileExists(cache_file));
+  const std::string cache_file_name = cache_dir + cache_file.substr(cache_file.rfind('/'));
+
+  // Replace the cached bootstrap to tell it apart from a parsed one.
+  envoy::config::bootstrap::v2::Bootstrap cached = bootstrap;
+  cached.mutable_stats_flush_interval()->set_seconds(4);
+  TestEnvironment::writeStringToFileForTest(cache_file_name, cached.SerializeAsString());
+  envoy::config::bootstrap::v2::Bootstrap from_cache;
+  loader.load(config_path, config_yaml, from_cache);
+  EXPECT_TRUE(TestUtility::protoEqual(cached, from_cache));
+
+  // Other inline YAML has its own entry.
+  EXPECT_NE(cache_file, loader.cacheFilePath(bootstrapYaml(), ""));
+
+  // A corrupt cache is ignored.
+  TestEnvironment::writeStringToFileForTest(cache_file_name, "not a proto");
+  envoy::config::bootstrap::v2::Bootstrap reparsed;
+  loader.load(config_path, config_yaml, reparsed);
+  EXPECT_TRUE(TestUtility::protoEqual(bootstrap, reparsed));
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
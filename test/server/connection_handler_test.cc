@@ -21,6 +21,7 @@ using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace Server {
@@ -125,6 +126,98 @@ TEST_F(ConnectionHandlerTest, RemoveListener) {
   handler_->removeListeners(0);
 }
 
+TEST_F(ConnectionHandlerTest, RemoveFilterChains) {
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  // One connection on each of two filter chains.
+  const Network::FilterChainSharedPtr other_filter_chain =
+      Network::Test::createEmptyFilterChainWithRawBufferSockets();
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillRepeatedly(Return(true));
+  EXPECT_CALL(manager_, findFilterChain(_))
+      .WillOnce(Return(filter_chain_.get()))
+      .WillOnce(Return(other_filter_chain.get()));
+  Network::MockConnection* removed_connection = new NiceMock<Network::MockConnection>();
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _))
+      .WillOnce(Return(removed_connection))
+      .WillOnce(Return(connection));
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, true);
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()}, true);
+  EXPECT_EQ(2UL, handler_->numConnections());
+
+  // Only the connection of the removed filter chain is closed.
+  EXPECT_CALL(*removed_connection, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*connection, close(_)).Times(0);
+  handler_->removeFilterChains(1, {filter_chain_.get()});
+  EXPECT_EQ(1UL, handler_->numConnections());
+  testing::Mock::VerifyAndClearExpectations(connection);
+
+  // New sockets that match the removed filter chain are rejected.
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
+  EXPECT_CALL(dispatcher_, createServerConnection_(_, _)).Times(0);
+  Network::MockConnectionSocket* accepted_socket = new NiceMock<Network::MockConnectionSocket>();
+  EXPECT_CALL(*accepted_socket, close());
+  listener_callbacks->onAccept(Network::ConnectionSocketPtr{accepted_socket}, true);
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  EXPECT_CALL(*listener, onDestroy());
+  EXPECT_CALL(*connection, close(Network::ConnectionCloseType::NoFlush));
+}
+
+TEST_F(ConnectionHandlerTest, RemoveListenersWhenIdle) {
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, false))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  EXPECT_CALL(test_listener->socket_, localAddress());
+  handler_->addListener(*test_listener);
+
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection});
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  EXPECT_CALL(*listener, onDestroy());
+  handler_->stopListeners(1);
+
+  // The listener still owns a connection, so it is not removed yet.
+  bool removed = false;
+  handler_->removeListenersWhenIdle(1, [&removed]() -> void { removed = true; });
+  EXPECT_FALSE(removed);
+
+  // The removal is deferred to a later dispatcher iteration once the last connection is gone.
+  Event::PostCb post_cb;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  connection->close(Network::ConnectionCloseType::NoFlush);
+  EXPECT_EQ(0UL, handler_->numConnections());
+  EXPECT_FALSE(removed);
+
+  EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
+  post_cb();
+  EXPECT_TRUE(removed);
+
+  // Unknown listeners are removed right away.
+  removed = false;
+  handler_->removeListenersWhenIdle(2, [&removed]() -> void { removed = true; });
+  EXPECT_TRUE(removed);
+}
+
 TEST_F(ConnectionHandlerTest, DisableListener) {
   InSequence s;
 
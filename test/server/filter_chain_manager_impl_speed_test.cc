@@ -0,0 +1,126 @@
+// Benchmarks for building, incrementally updating and querying the filter chain match tree of a
+// listener with many SNI based filter chains.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common/macros.h"
+#include "common/network/address_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/listen_socket_impl.h"
+
+#include "server/filter_chain_manager_impl.h"
+
+#include "test/mocks/network/mocks.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+struct FilterChainSet {
+  explicit FilterChainSet(size_t num_filter_chains) {
+    for (size_t i = 0; i < num_filter_chains; i++) {
+      envoy::api::v2::listener::FilterChainMatch match;
+      match.add_server_names(fmt::format("server{}.example.com", i));
+      match.add_server_names(fmt::format("*.server{}.example.org", i));
+      match.set_transport_protocol("tls");
+      matches_.push_back(match);
+      filter_chains_.push_back(std::make_shared<testing::NiceMock<Network::MockFilterChain>>());
+    }
+  }
+
+  void addTo(FilterChainManagerImpl& manager) const {
+    for (size_t i = 0; i < matches_.size(); i++) {
+      manager.addFilterChain(matches_[i], filter_chains_[i]);
+    }
+  }
+
+  std::vector<envoy::api::v2::listener::FilterChainMatch> matches_;
+  std::vector<Network::FilterChainSharedPtr> filter_chains_;
+};
+
+const Network::Address::InstanceConstSharedPtr& listenerAddress() {
+  CONSTRUCT_ON_FIRST_USE(Network::Address::InstanceConstSharedPtr,
+                         std::make_shared<Network::Address::Ipv4Instance>(443));
+}
+
+} // namespace
+
+static void BM_FilterChainManagerBuild(benchmark::State& state) {
+  const FilterChainSet filter_chains(state.range(0));
+  for (auto _ : state) {
+    FilterChainManagerImpl manager(listenerAddress());
+    filter_chains.addTo(manager);
+    manager.compile();
+    benchmark::DoNotOptimize(manager.matchTree());
+  }
+}
+BENCHMARK(BM_FilterChainManagerBuild)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+// Replaces a single filter chain of the listener per iteration.
+static void BM_FilterChainManagerIncrementalUpdate(benchmark::State& state) {
+  const FilterChainSet filter_chains(state.range(0));
+  FilterChainManagerImpl manager(listenerAddress());
+  filter_chains.addTo(manager);
+  manager.compile();
+
+  size_t i = 0;
+  for (auto _ : state) {
+    const auto& match = filter_chains.matches_[i++ % filter_chains.matches_.size()];
+    manager.removeFilterChain(match);
+    manager.addFilterChain(match, std::make_shared<testing::NiceMock<Network::MockFilterChain>>());
+    manager.compile();
+  }
+  state.counters["compiled_nodes"] = manager.numCompiledNodes();
+}
+BENCHMARK(BM_FilterChainManagerIncrementalUpdate)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_FilterChainManagerLookup(benchmark::State& state) {
+  const FilterChainSet filter_chains(state.range(0));
+  FilterChainManagerImpl manager(listenerAddress());
+  filter_chains.addTo(manager);
+  manager.compile();
+
+  // Half of the connections use exact server names and half hit wildcard domains.
+  std::vector<std::unique_ptr<Network::ConnectionSocketImpl>> sockets;
+  for (size_t i = 0; i < 1000; i++) {
+    auto socket = std::make_unique<Network::ConnectionSocketImpl>(
+        std::make_unique<Network::IoSocketHandleImpl>(), listenerAddress(), listenerAddress());
+    const size_t index = i % filter_chains.matches_.size();
+    socket->setRequestedServerName(i % 2 == 0 ? fmt::format("server{}.example.com", index)
+                                              : fmt::format("www.server{}.example.org", index));
+    socket->setDetectedTransportProtocol("tls");
+    sockets.push_back(std::move(socket));
+  }
+
+  size_t i = 0;
+  size_t matched = 0;
+  for (auto _ : state) {
+    matched += manager.findFilterChain(*sockets[i++ % sockets.size()]) != nullptr;
+  }
+  benchmark::DoNotOptimize(matched);
+}
+BENCHMARK(BM_FilterChainManagerLookup)->Arg(10)->Arg(1000)->Arg(10000);
+
+} // namespace Server
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
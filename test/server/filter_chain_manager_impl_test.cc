@@ -0,0 +1,160 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/network/address_impl.h"
+
+#include "server/filter_chain_manager_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+class FilterChainManagerImplTest : public testing::Test {
+protected:
+  FilterChainManagerImplTest()
+      : manager_(std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234)) {
+    socket_.local_address_ = std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 443);
+    ON_CALL(socket_, detectedTransportProtocol()).WillByDefault(Return(absl::string_view("tls")));
+    ON_CALL(socket_, requestedApplicationProtocols())
+        .WillByDefault(ReturnRef(application_protocols_));
+  }
+
+  envoy::api::v2::listener::FilterChainMatch parseMatch(const std::string& yaml) {
+    return TestUtility::parseYaml<envoy::api::v2::listener::FilterChainMatch>(yaml);
+  }
+
+  const Network::FilterChain* findFilterChain(const Network::FilterChainManager& manager,
+                                              const std::string& server_name) {
+    ON_CALL(socket_, requestedServerName()).WillByDefault(Return(absl::string_view(server_name)));
+    return manager.findFilterChain(socket_);
+  }
+
+  FilterChainManagerImpl manager_;
+  NiceMock<Network::MockConnectionSocket> socket_;
+  std::vector<std::string> application_protocols_;
+};
+
+TEST_F(FilterChainManagerImplTest, ServerNamesShareCompiledNodes) {
+  envoy::api::v2::listener::FilterChainMatch match;
+  for (int i = 0; i < 100; i++) {
+    match.add_server_names(fmt::format("server{}.example.com", i));
+  }
+  const auto filter_chain = std::make_shared<NiceMock<Network::MockFilterChain>>();
+  manager_.addFilterChain(match, filter_chain);
+  manager_.compile();
+
+  // One node for the server names, and one each for the transport protocols, the application
+  // protocols and the source types, which are shared by all 100 server names.
+  EXPECT_EQ(4U, manager_.numCompiledNodes());
+  EXPECT_EQ(filter_chain.get(), findFilterChain(manager_, "server0.example.com"));
+  EXPECT_EQ(filter_chain.get(), findFilterChain(manager_, "server99.example.com"));
+  EXPECT_EQ(nullptr, findFilterChain(manager_, "server100.example.com"));
+}
+
+TEST_F(FilterChainManagerImplTest, WildcardServerNames) {
+  const auto wildcard = std::make_shared<NiceMock<Network::MockFilterChain>>();
+  const auto exact = std::make_shared<NiceMock<Network::MockFilterChain>>();
+  const auto catch_all = std::make_shared<NiceMock<Network::MockFilterChain>>();
+  manager_.addFilterChain(parseMatch("server_names: ['*.example.com']"), wildcard);
+  manager_.addFilterChain(parseMatch("server_names: ['www.example.com']"), exact);
+  manager_.addFilterChain(parseMatch("{}"), catch_all);
+  manager_.compile();
+
+  EXPECT_EQ(exact.get(), findFilterChain(manager_, "www.example.com"));
+  EXPECT_EQ(wildcard.get(), findFilterChain(manager_, "api.example.com"));
+  EXPECT_EQ(wildcard.get(), findFilterChain(manager_, "a.b.example.com"));
+  EXPECT_EQ(catch_all.get(), findFilterChain(manager_, "example.com"));
+  EXPECT_EQ(catch_all.get(), findFilterChain(manager_, ""));
+}
+
+TEST_F(FilterChainManagerImplTest, IncrementalUpdates) {
+  const auto foo = std::make_shared<NiceMock<Network::MockFilterChain>>();
+  const auto bar = std::make_shared<NiceMock<Network::MockFilterChain>>();
+  manager_.addFilterChain(parseMatch("server_names: ['foo.example.com']"), foo);
+  manager_.compile();
+  EXPECT_EQ(foo.get(), findFilterChain(manager_, "foo.example.com"));
+
+  // Staged changes are only visible once compiled, and never change a previous match tree.
+  {
+    const FilterChainMatchTreeSharedPtr previous_match_tree = manager_.matchTree();
+    manager_.addFilterChain(parseMatch("server_names: ['bar.example.com']"), bar);
+    EXPECT_EQ(nullptr, findFilterChain(manager_, "bar.example.com"));
+    manager_.compile();
+    EXPECT_EQ(bar.get(), findFilterChain(manager_, "bar.example.com"));
+    EXPECT_EQ(foo.get(), findFilterChain(manager_, "foo.example.com"));
+    EXPECT_EQ(nullptr, findFilterChain(*previous_match_tree, "bar.example.com"));
+  }
+  EXPECT_EQ(2U, manager_.numFilterChains());
+
+  EXPECT_EQ(foo, manager_.removeFilterChain(parseMatch("server_names: ['foo.example.com']")));
+  EXPECT_EQ(nullptr, manager_.removeFilterChain(parseMatch("server_names: ['foo.example.com']")));
+  manager_.compile();
+  EXPECT_EQ(nullptr, findFilterChain(manager_, "foo.example.com"));
+  EXPECT_EQ(bar.get(), findFilterChain(manager_, "bar.example.com"));
+  EXPECT_EQ(1U, manager_.numFilterChains());
+
+  EXPECT_EQ(bar, manager_.removeFilterChain(parseMatch("server_names: ['bar.example.com']")));
+  manager_.compile();
+  EXPECT_EQ(nullptr, findFilterChain(manager_, "bar.example.com"));
+  EXPECT_EQ(0U, manager_.numCompiledNodes());
+}
+
+TEST_F(FilterChainManagerImplTest, DestinationIPs) {
+  const auto filter_chain = std::make_shared<NiceMock<Network::MockFilterChain>>();
+  manager_.addFilterChain(
+      parseMatch("prefix_ranges: [{ address_prefix: 127.0.0.0, prefix_len: 8 }]"), filter_chain);
+  manager_.compile();
+  EXPECT_EQ(filter_chain.get(), findFilterChain(manager_, ""));
+
+  socket_.local_address_ = std::make_shared<Network::Address::Ipv4Instance>("10.0.0.1", 443);
+  EXPECT_EQ(nullptr, findFilterChain(manager_, ""));
+}
+
+TEST_F(FilterChainManagerImplTest, DuplicateMatch) {
+  manager_.addFilterChain(parseMatch("server_names: ['foo.example.com']"),
+                          std::make_shared<NiceMock<Network::MockFilterChain>>());
+  EXPECT_THROW_WITH_MESSAGE(
+      manager_.addFilterChain(parseMatch("server_names: ['foo.example.com']"),
+                              std::make_shared<NiceMock<Network::MockFilterChain>>()),
+      EnvoyException,
+      "error adding listener '127.0.0.1:1234': multiple filter chains with the same matching "
+      "rules are defined");
+}
+
+TEST_F(FilterChainManagerImplTest, EquivalentMatchLeavesManagerUnchanged) {
+  manager_.addFilterChain(parseMatch("server_names: ['foo.example.com']"),
+                          std::make_shared<NiceMock<Network::MockFilterChain>>());
+  EXPECT_THROW_WITH_MESSAGE(
+      manager_.addFilterChain(parseMatch("server_names: ['bar.example.com', 'foo.example.com']"),
+                              std::make_shared<NiceMock<Network::MockFilterChain>>()),
+      EnvoyException,
+      "error adding listener '127.0.0.1:1234': multiple filter chains with effectively "
+      "equivalent matching rules are defined");
+  manager_.compile();
+  EXPECT_EQ(nullptr, findFilterChain(manager_, "bar.example.com"));
+  EXPECT_EQ(1U, manager_.numFilterChains());
+}
+
+TEST_F(FilterChainManagerImplTest, PartialWildcard) {
+  EXPECT_THROW_WITH_MESSAGE(
+      manager_.addFilterChain(parseMatch("server_names: ['*w.example.com']"),
+                              std::make_shared<NiceMock<Network::MockFilterChain>>()),
+      EnvoyException,
+      "error adding listener '127.0.0.1:1234': partial wildcards are not supported in "
+      "\"server_names\"");
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
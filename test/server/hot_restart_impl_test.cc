@@ -1,3 +1,4 @@
+#include <map>
 #include <memory>
 
 #include "common/api/os_sys_calls_impl.h"
@@ -153,6 +154,55 @@ TEST_F(HotRestartImplTest, allocFail) {
   EXPECT_EQ(s3, nullptr);
 }
 
+// With max_stats of 0, stats are allocated from an arena of shared memory segments that grows as
+// needed, and which a hot restarted process attaches to.
+TEST_F(HotRestartImplTest, statsArena) {
+  EXPECT_CALL(options_, maxStats()).WillRepeatedly(Return(0));
+  EXPECT_CALL(options_, statsOptions()).WillRepeatedly(ReturnRef(stats_options_));
+
+  // Shared memory regions by name, and the names of the open descriptors.
+  std::map<std::string, std::vector<uint8_t>> regions;
+  std::map<int, std::string> fds;
+  EXPECT_CALL(os_sys_calls_, shmUnlink(_)).WillRepeatedly(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(os_sys_calls_, shmOpen(_, _, _))
+      .WillRepeatedly(WithArg<0>(Invoke([&](const char* name) {
+        const int fd = 100 + fds.size();
+        fds[fd] = name;
+        return Api::SysCallIntResult{fd, 0};
+      })));
+  EXPECT_CALL(os_sys_calls_, ftruncate(_, _)).WillRepeatedly(Invoke([&](int fd, off_t size) {
+    regions[fds[fd]].resize(size);
+    return Api::SysCallIntResult{0, 0};
+  }));
+  EXPECT_CALL(os_sys_calls_, mmap(_, _, _, _, _, _)).WillRepeatedly(WithArg<4>(Invoke([&](int fd) {
+    return Api::SysCallPtrResult{regions[fds[fd]].data(), 0};
+  })));
+  EXPECT_CALL(os_sys_calls_, close(_)).WillRepeatedly(Return(Api::SysCallIntResult{0, 0}));
+  EXPECT_CALL(os_sys_calls_, bind(_, _, _)).Times(2);
+
+  HotRestartImpl hot_restart(options_, symbol_table_);
+  hot_restart.drainParentListeners();
+  EXPECT_FALSE(hot_restart.statsAllocator().requiresBoundedStatNameSize());
+
+  // Enough stats with long names to fill a few segments.
+  const std::string suffix(1000, 'z');
+  std::vector<Stats::RawStatData*> stats;
+  for (uint64_t i = 0; i < 3000; i++) {
+    stats.push_back(hot_restart.statsAllocator().alloc(fmt::format("stat{}.{}", i, suffix)));
+    ASSERT_NE(nullptr, stats.back());
+  }
+  EXPECT_EQ(1, regions.count("/envoy_stats_arena_0_2"));
+
+  EXPECT_CALL(options_, restartEpoch()).WillRepeatedly(Return(1));
+  HotRestartImpl hot_restart2(options_, symbol_table_);
+  for (uint64_t i = 0; i < 3000; i++) {
+    EXPECT_EQ(stats[i], hot_restart2.statsAllocator().alloc(fmt::format("stat{}.{}", i, suffix)));
+  }
+  EXPECT_EQ(hot_restart.version(), hot_restart2.version());
+  EXPECT_EQ(hot_restart.version(),
+            HotRestartImpl::hotRestartVersion(0, stats_options_.maxNameLength()));
+}
+
 // Because the shared memory is managed manually, make sure it meets
 // basic requirements:
 //   - Objects are correctly aligned so that std::atomic works properly
@@ -0,0 +1,116 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "envoy/config/metrics/v2/stats.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/stats/fake_symbol_table_impl.h"
+#include "common/stats/heap_stat_data.h"
+#include "common/stats/tag_producer_impl.h"
+
+#include "server/http/admin.h"
+
+#include "test/common/stats/stat_test_utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+
+// Holds a population of counters named like those of a proxy with many clusters, with their tags
+// extracted by the default tag extractors, for timing scrapes of the admin stats endpoints.
+class StatsScrapePerf {
+public:
+  explicit StatsScrapePerf(uint64_t num_stats)
+      : alloc_(symbol_table_), tag_producer_(envoy::config::metrics::v2::StatsConfig()) {
+    // forEachSampleStat generates the same few dozen stats per cluster, so ask for more clusters
+    // than needed and stop at num_stats.
+    Stats::TestUtil::forEachSampleStat(
+        num_stats / 10 + 1, [this, num_stats](absl::string_view name) {
+          if (counters_.size() < num_stats) {
+            const std::string stat_name(name);
+            std::vector<Stats::Tag> tags;
+            std::string tag_extracted_name = tag_producer_.produceTags(stat_name, tags);
+            counters_.push_back(
+                alloc_.makeCounter(stat_name, std::move(tag_extracted_name), std::move(tags)));
+          }
+        });
+  }
+
+  // Renders a scrape a chunk at a time, draining each chunk as a connection would.
+  uint64_t render(ChunkedResponse& renderer) {
+    Buffer::OwnedImpl chunk;
+    uint64_t bytes = 0;
+    bool more = true;
+    while (more) {
+      more = renderer.nextChunk(chunk);
+      bytes += chunk.length();
+      chunk.drain(chunk.length());
+    }
+    return bytes;
+  }
+
+  Stats::FakeSymbolTableImpl symbol_table_;
+  Stats::HeapStatDataAllocator alloc_;
+  Stats::TagProducerImpl tag_producer_;
+  std::vector<Stats::CounterSharedPtr> counters_;
+  const std::vector<Stats::GaugeSharedPtr> gauges_;
+  const std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+  PrometheusNameCache names_;
+};
+
+} // namespace Server
+} // namespace Envoy
+
+// Renders /stats/prometheus a chunk at a time, with the metric names cached across scrapes as the
+// admin handler does.
+static void BM_PrometheusChunked(benchmark::State& state) {
+  Envoy::Server::StatsScrapePerf context(state.range(0));
+  uint64_t bytes = 0;
+  for (auto _ : state) {
+    Envoy::Server::PrometheusStatsRenderer renderer(context.counters_, context.gauges_,
+                                                    context.histograms_, false, context.names_);
+    bytes += context.render(renderer);
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_PrometheusChunked)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// Renders /stats/prometheus into a single buffer, sanitizing the names on every scrape.
+static void BM_PrometheusWhole(benchmark::State& state) {
+  Envoy::Server::StatsScrapePerf context(state.range(0));
+  uint64_t bytes = 0;
+  for (auto _ : state) {
+    Envoy::Buffer::OwnedImpl response;
+    Envoy::Server::PrometheusStatsFormatter::statsAsPrometheus(
+        context.counters_, context.gauges_, context.histograms_, response, false);
+    bytes += response.length();
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_PrometheusWhole)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// Renders /stats in the text format a chunk at a time.
+static void BM_TextChunked(benchmark::State& state) {
+  Envoy::Server::StatsScrapePerf context(state.range(0));
+  uint64_t bytes = 0;
+  for (auto _ : state) {
+    Envoy::Server::StatsTextRenderer renderer(context.counters_, context.gauges_,
+                                              context.histograms_, false, absl::nullopt);
+    bytes += context.render(renderer);
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_TextChunked)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -29,21 +29,26 @@
 #include "test/test_common/utility.h"
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using testing::_;
 using testing::AllOf;
+using testing::ElementsAre;
+using testing::EndsWith;
 using testing::Ge;
 using testing::HasSubstr;
 using testing::InSequence;
 using testing::Invoke;
+using testing::InvokeWithoutArgs;
 using testing::NiceMock;
 using testing::Property;
 using testing::Ref;
 using testing::Return;
 using testing::ReturnPointee;
 using testing::ReturnRef;
+using testing::StartsWith;
 
 namespace Envoy {
 namespace Server {
@@ -589,6 +594,79 @@ TEST_P(AdminFilterTest, Trailers) {
   EXPECT_EQ(Http::FilterTrailersStatus::StopIteration, filter_.decodeTrailers(request_headers_));
 }
 
+// A chunked response that produces the given chunks in turn.
+class TestChunkedResponse : public ChunkedResponse {
+public:
+  TestChunkedResponse(std::vector<std::string> chunks) : chunks_(std::move(chunks)) {}
+
+  bool nextChunk(Buffer::Instance& response) override {
+    response.add(chunks_[index_++]);
+    return index_ < chunks_.size();
+  }
+
+private:
+  const std::vector<std::string> chunks_;
+  size_t index_{};
+};
+
+TEST_P(AdminFilterTest, ChunkedResponsePausesAboveHighWatermark) {
+  auto callback = [](absl::string_view, Http::HeaderMap&, Buffer::Instance& response,
+                     AdminStream& admin_stream) -> Http::Code {
+    response.add("head");
+    admin_stream.setChunkedResponse(
+        std::make_unique<TestChunkedResponse>(std::vector<std::string>{"a", "b", "c"}));
+    return Http::Code::OK;
+  };
+  EXPECT_TRUE(admin_.addHandler("/chunked", "chunked", callback, false, false));
+  Http::TestHeaderMapImpl request_headers{{":path", "/chunked"}};
+
+  InSequence s;
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  EXPECT_CALL(callbacks_, encodeData(BufferStringEqual("head"), false));
+  EXPECT_CALL(callbacks_, addDownstreamWatermarkCallbacks(Ref(filter_)));
+  EXPECT_CALL(callbacks_, encodeData(BufferStringEqual("a"), false))
+      .WillOnce(
+          InvokeWithoutArgs([this]() -> void { filter_.onAboveWriteBufferHighWatermark(); }));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers, true));
+
+  // Encoding resumes from a timer once the connection drains.
+  Event::MockTimer* resume_timer = new Event::MockTimer(&callbacks_.dispatcher_);
+  EXPECT_CALL(*resume_timer, enableTimer(std::chrono::milliseconds(0)));
+  filter_.onBelowWriteBufferLowWatermark();
+
+  EXPECT_CALL(callbacks_, encodeData(BufferStringEqual("b"), false));
+  EXPECT_CALL(callbacks_, encodeData(BufferStringEqual("c"), true));
+  resume_timer->invokeCallback();
+
+  EXPECT_CALL(callbacks_, removeDownstreamWatermarkCallbacks(Ref(filter_)));
+  filter_.onDestroy();
+}
+
+TEST_P(AdminFilterTest, ChunkedResponseStopsOnDestroy) {
+  auto callback = [](absl::string_view, Http::HeaderMap&, Buffer::Instance&,
+                     AdminStream& admin_stream) -> Http::Code {
+    admin_stream.setChunkedResponse(
+        std::make_unique<TestChunkedResponse>(std::vector<std::string>{"a", "b"}));
+    return Http::Code::OK;
+  };
+  EXPECT_TRUE(admin_.addHandler("/chunked", "chunked", callback, false, false));
+  Http::TestHeaderMapImpl request_headers{{":path", "/chunked"}};
+
+  // The connection is already above its high watermark when the callbacks are added.
+  InSequence s;
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  EXPECT_CALL(callbacks_, addDownstreamWatermarkCallbacks(Ref(filter_)))
+      .WillOnce(
+          InvokeWithoutArgs([this]() -> void { filter_.onAboveWriteBufferHighWatermark(); }));
+  EXPECT_CALL(callbacks_, encodeData(_, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.decodeHeaders(request_headers, true));
+
+  EXPECT_CALL(callbacks_, removeDownstreamWatermarkCallbacks(Ref(filter_)));
+  filter_.onDestroy();
+}
+
 class AdminInstanceTest : public testing::TestWithParam<Network::Address::IpVersion> {
 public:
   AdminInstanceTest()
@@ -897,6 +975,16 @@ TEST_P(AdminInstanceTest, Memory) {
                     Property(&envoy::admin::v2alpha::Memory::total_thread_cache, Ge(0))));
 }
 
+// The isolated store of the mock server reports all of its stats in a single root scope.
+TEST_P(AdminInstanceTest, StatsMemory) {
+  Http::HeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  server_.stats().counter("foo").inc();
+  EXPECT_EQ(Http::Code::OK, getCallback("/stats/memory", header_map, response));
+  EXPECT_THAT(response.toString(), StartsWith("total: 0 bytes in 1 scopes\n(root): 0 bytes, "));
+  EXPECT_THAT(response.toString(), EndsWith(" histograms\n"));
+}
+
 TEST_P(AdminInstanceTest, ContextThatReturnsNullCertDetails) {
   Http::HeaderMapImpl header_map;
   Buffer::OwnedImpl response;
@@ -1230,6 +1318,26 @@ TEST_P(AdminInstanceTest, GetRequestJson) {
               HasSubstr("application/json"));
 }
 
+TEST_P(AdminInstanceTest, GetRequestStatsText) {
+  server_.stats_store_.counter("foo.counter").inc();
+  server_.stats_store_.gauge("foo.gauge").set(3);
+  server_.stats_store_.counter("bar.counter");
+
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::OK, admin_.request("/stats?filter=foo", "GET", response_headers, body));
+  EXPECT_EQ("foo.counter: 1\nfoo.gauge: 3\n", body);
+}
+
+TEST_P(AdminInstanceTest, GetRequestStatsPrometheus) {
+  server_.stats_store_.counter("foo.counter").inc();
+
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::OK, admin_.request("/stats/prometheus", "GET", response_headers, body));
+  EXPECT_THAT(body, HasSubstr("# TYPE envoy_foo_counter counter\nenvoy_foo_counter{} 1\n"));
+}
+
 TEST_P(AdminInstanceTest, PostRequest) {
   Http::HeaderMapImpl response_headers;
   std::string body;
@@ -1607,5 +1715,126 @@ TEST_F(PrometheusStatsFormatterTest, OutputWithUsedOnlyHistogram) {
   }
 }
 
+TEST_F(PrometheusStatsFormatterTest, ChunkedOutputMatchesWholeOutput) {
+  for (int i = 0; i < 10; ++i) {
+    addCounter(absl::StrCat("cluster.test_", i, ".upstream_cx_total"),
+               {{"a.tag-name", absl::StrCat("a.tag-value", i)}});
+    addGauge(absl::StrCat("cluster.test_", i, ".upstream_cx_active"), {});
+  }
+
+  Buffer::OwnedImpl whole;
+  PrometheusStatsFormatter::statsAsPrometheus(counters_, gauges_, histograms_, whole, false);
+
+  // With a one byte chunk size, each chunk holds the output for one stat.
+  PrometheusNameCache names;
+  PrometheusStatsRenderer renderer(counters_, gauges_, histograms_, false, names, 1);
+  std::string chunked;
+  uint32_t num_chunks = 0;
+  bool more = true;
+  while (more) {
+    Buffer::OwnedImpl chunk;
+    more = renderer.nextChunk(chunk);
+    chunked += chunk.toString();
+    ++num_chunks;
+  }
+  EXPECT_EQ(whole.toString(), chunked);
+  EXPECT_EQ(20, num_chunks);
+  EXPECT_EQ(20UL, renderer.metricTypeCount());
+}
+
+TEST_F(PrometheusStatsFormatterTest, NameCache) {
+  PrometheusNameCache names;
+  const std::string& metric_name = names.metricName("cluster.upstream-cx.total");
+  EXPECT_EQ("envoy_cluster_upstream_cx_total", metric_name);
+  EXPECT_EQ(&metric_name, &names.metricName("cluster.upstream-cx.total"));
+  EXPECT_EQ("a_tag_name", names.tagName("a.tag-name"));
+  EXPECT_EQ("_0tag", names.tagName("0tag"));
+}
+
+TEST_F(PrometheusStatsFormatterTest, NameCacheSweep) {
+  PrometheusNameCache names;
+  names.metricName("cluster.upstream_cx_total");
+  names.metricName("cluster.upstream_cx_active");
+  names.tagName("envoy.cluster_name");
+  EXPECT_EQ(3UL, names.size());
+
+  // Names that were looked up since the previous sweep are kept.
+  names.sweep();
+  EXPECT_EQ(3UL, names.size());
+  names.metricName("cluster.upstream_cx_total");
+  names.sweep();
+  EXPECT_EQ(1UL, names.size());
+  names.sweep();
+  EXPECT_EQ(0UL, names.size());
+}
+
+// A complete render drops the names of stats that were deleted since the previous one.
+TEST_F(PrometheusStatsFormatterTest, RenderSweepsNameCache) {
+  addCounter("cluster.test_1.upstream_cx_total", {{"a.tag-name", "a.tag-value"}});
+  addGauge("cluster.test_1.upstream_cx_active", {});
+
+  PrometheusNameCache names;
+  Buffer::OwnedImpl response;
+  PrometheusStatsRenderer(counters_, gauges_, histograms_, false, names).nextChunk(response);
+  EXPECT_EQ(3UL, names.size());
+
+  gauges_.clear();
+  PrometheusStatsRenderer(counters_, gauges_, histograms_, false, names).nextChunk(response);
+  EXPECT_EQ(2UL, names.size());
+}
+
+class StatsTextRendererTest : public PrometheusStatsFormatterTest {
+protected:
+  std::vector<std::string> renderChunks(StatsTextRenderer& renderer) {
+    std::vector<std::string> chunks;
+    bool more = true;
+    while (more) {
+      Buffer::OwnedImpl chunk;
+      more = renderer.nextChunk(chunk);
+      chunks.push_back(chunk.toString());
+    }
+    return chunks;
+  }
+};
+
+TEST_F(StatsTextRendererTest, CountersAndGaugesInNameOrderThenHistograms) {
+  addCounter("cluster.b", {});
+  addCounter("cluster.d", {});
+  addGauge("cluster.a", {});
+  addGauge("cluster.c", {});
+  addGauge("cluster.d", {});
+  counters_[0]->add(2);
+  gauges_[1]->set(3);
+
+  for (const std::string& name : {"h2", "h1"}) {
+    auto histogram = std::make_shared<NiceMock<Stats::MockParentHistogram>>();
+    histogram->name_ = name;
+    addHistogram(histogram);
+  }
+
+  // With a one byte chunk size, each chunk holds one stat. The gauge that shares its name with a
+  // counter is not shown.
+  StatsTextRenderer renderer(counters_, gauges_, histograms_, false, absl::nullopt, 1);
+  EXPECT_THAT(renderChunks(renderer),
+              ElementsAre("cluster.a: 0\n", "cluster.b: 2\n", "cluster.c: 3\n", "cluster.d: 0\n",
+                          "h1: \n", "h2: \n"));
+}
+
+TEST_F(StatsTextRendererTest, UsedOnlyAndFilter) {
+  addCounter("cluster.a", {});
+  addCounter("cluster.b", {});
+  addGauge("server.c", {});
+  counters_[1]->inc();
+  gauges_[0]->set(1);
+
+  StatsTextRenderer renderer(counters_, gauges_, histograms_, true, std::regex("cluster"));
+  EXPECT_THAT(renderChunks(renderer), ElementsAre("cluster.b: 1\n"));
+}
+
+TEST_F(StatsTextRendererTest, Empty) {
+  StatsTextRenderer renderer(counters_, gauges_, histograms_, false, absl::nullopt);
+  EXPECT_THAT(renderChunks(renderer), ElementsAre(""));
+}
+
 } // namespace Server
 } // namespace Envoy
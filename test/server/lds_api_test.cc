@@ -270,6 +270,82 @@ TEST_F(LdsApiTest, ValidateDuplicateListeners) {
   EXPECT_CALL(request_, cancel());
 }
 
+// A delta update removes and adds only the listeners it names, each at its own version.
+TEST_F(LdsApiTest, DeltaUpdate) {
+  InSequence s;
+
+  setup();
+
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> listeners;
+  addListener(listeners, "listener1");
+  addListener(listeners, "listener2");
+  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> added_resources;
+  for (const auto& listener : listeners) {
+    auto* resource = added_resources.Add();
+    resource->set_name(MessageUtil::anyConvert<envoy::api::v2::Listener>(listener).name());
+    resource->set_version("v" + resource->name());
+    *resource->mutable_resource() = listener;
+  }
+  Protobuf::RepeatedPtrField<std::string> removed_resources;
+  *removed_resources.Add() = "listener0";
+
+  EXPECT_CALL(listener_manager_, listeners()).Times(0);
+  EXPECT_CALL(listener_manager_, removeListener("listener0")).WillOnce(Return(true));
+  expectAdd("listener1", "vlistener1", true);
+  EXPECT_CALL(listener_manager_, addOrUpdateListener(_, "vlistener2", true))
+      .WillOnce(Throw(EnvoyException("something is wrong")));
+  EXPECT_CALL(init_watcher_, ready());
+
+  EXPECT_THROW_WITH_MESSAGE(lds_->onConfigUpdate(added_resources, removed_resources, "1"),
+                            EnvoyException,
+                            "Error adding/updating listener(s) listener2: something is wrong");
+  EXPECT_EQ("1", lds_->versionInfo());
+  EXPECT_CALL(request_, cancel());
+}
+
+// A listener that is still there and arrives with the same config is skipped.
+TEST_F(LdsApiTest, DeltaUpdateSkipsUnchangedListeners) {
+  InSequence s;
+
+  setup();
+
+  Protobuf::RepeatedPtrField<ProtobufWkt::Any> listeners;
+  addListener(listeners, "listener1");
+  addListener(listeners, "listener2");
+  const auto make_resources = [&listeners](const std::vector<int>& indices) {
+    Protobuf::RepeatedPtrField<envoy::api::v2::Resource> resources;
+    for (const int i : indices) {
+      auto* resource = resources.Add();
+      resource->set_name(fmt::format("listener{}", i + 1));
+      *resource->mutable_resource() = listeners[i];
+    }
+    return resources;
+  };
+
+  expectAdd("listener1", absl::nullopt, true);
+  EXPECT_CALL(init_watcher_, ready());
+  lds_->onConfigUpdate(make_resources({0}), {}, "1");
+
+  makeListenersAndExpectCall({"listener1"});
+  expectAdd("listener2", absl::nullopt, true);
+  lds_->onConfigUpdate(make_resources({0, 1}), {}, "2");
+
+  // Once listener1 is gone, e.g. because it failed to bind, it is added again.
+  makeListenersAndExpectCall({"listener2"});
+  expectAdd("listener1", absl::nullopt, true);
+  lds_->onConfigUpdate(make_resources({0, 1}), {}, "3");
+
+  // A removed listener is added again even if the listener manager has not removed it yet.
+  Protobuf::RepeatedPtrField<std::string> removed_resources;
+  *removed_resources.Add() = "listener1";
+  EXPECT_CALL(listener_manager_, removeListener("listener1")).WillOnce(Return(true));
+  lds_->onConfigUpdate({}, removed_resources, "4");
+  expectAdd("listener1", absl::nullopt, true);
+  makeListenersAndExpectCall({"listener1", "listener2"});
+  lds_->onConfigUpdate(make_resources({0, 1}), {}, "5");
+  EXPECT_CALL(request_, cancel());
+}
+
 TEST_F(LdsApiTest, BadLocalInfo) {
   interval_timer_ = new Event::MockTimer(&dispatcher_);
   const std::string config_json = R"EOF(
@@ -364,9 +440,9 @@ TEST_F(LdsApiTest, Basic) {
       Http::HeaderMapPtr{new Http::TestHeaderMapImpl{{":status", "200"}}});
   message->body() = std::make_unique<Buffer::OwnedImpl>(response2_json);
 
+  // listener1 has the same config as when it was added, so it is skipped before being converted.
   makeListenersAndExpectCall({"listener1", "listener2"});
   EXPECT_CALL(listener_manager_, removeListener("listener2")).WillOnce(Return(true));
-  expectAdd("listener1", "1", false);
   expectAdd("listener3", "1", true);
   EXPECT_CALL(*interval_timer_, enableTimer(_));
   callbacks_->onSuccess(std::move(message));
@@ -564,9 +640,9 @@ TEST_F(LdsApiTest, ReplacingListenerWithSameAddress) {
       Http::HeaderMapPtr{new Http::TestHeaderMapImpl{{":status", "200"}}});
   message->body() = std::make_unique<Buffer::OwnedImpl>(response2_json);
 
+  // listener1 has the same config as when it was added, so it is skipped before being converted.
   makeListenersAndExpectCall({"listener1", "listener2"});
   EXPECT_CALL(listener_manager_, removeListener("listener2")).WillOnce(Return(true));
-  expectAdd("listener1", "1", false);
   expectAdd("listener3", "1", true);
   EXPECT_CALL(*interval_timer_, enableTimer(_));
   callbacks_->onSuccess(std::move(message));
@@ -38,6 +38,7 @@ using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
+using testing::SaveArg;
 using testing::Throw;
 
 namespace Envoy {
@@ -54,6 +55,8 @@ public:
   Init::ExpectableTargetImpl target_;
   MockDrainManager* drain_manager_ = new MockDrainManager();
   Configuration::FactoryContext* context_{};
+  // The factory contexts of all the filter chains, in config order.
+  std::vector<Configuration::FactoryContext*> filter_chain_contexts_;
 };
 
 class ListenerManagerImplTest : public testing::Test {
@@ -69,25 +72,34 @@ protected:
    * This routing sets up an expectation that does various things:
    * 1) Allows us to track listener destruction via filter factory destruction.
    * 2) Allows us to register for init manager handling much like RDS, etc. would do.
-   * 3) Stores the factory context for later use.
+   * 3) Stores the factory contexts for later use.
    * 4) Creates a mock local drain manager for the listener.
    */
   ListenerHandle* expectListenerCreate(
       bool need_init,
-      envoy::api::v2::Listener::DrainType drain_type = envoy::api::v2::Listener_DrainType_DEFAULT) {
+      envoy::api::v2::Listener::DrainType drain_type = envoy::api::v2::Listener_DrainType_DEFAULT,
+      uint32_t num_filter_chains = 1) {
     ListenerHandle* raw_listener = new ListenerHandle();
     EXPECT_CALL(listener_factory_, createDrainManager_(drain_type))
         .WillOnce(Return(raw_listener->drain_manager_));
+    // The handle is destroyed along with the filter factories of the last filter chain.
+    auto weak_notifier = std::make_shared<std::weak_ptr<ListenerHandle>>();
     EXPECT_CALL(listener_factory_, createNetworkFilterFactoryList(_, _))
-        .WillOnce(Invoke(
-            [raw_listener, need_init](
+        .Times(num_filter_chains)
+        .WillRepeatedly(Invoke(
+            [raw_listener, need_init, weak_notifier](
                 const Protobuf::RepeatedPtrField<envoy::api::v2::listener::Filter>&,
                 Configuration::FactoryContext& context) -> std::vector<Network::FilterFactoryCb> {
-              std::shared_ptr<ListenerHandle> notifier(raw_listener);
-              raw_listener->context_ = &context;
-              if (need_init) {
-                context.initManager().add(notifier->target_);
+              std::shared_ptr<ListenerHandle> notifier = weak_notifier->lock();
+              if (notifier == nullptr) {
+                notifier.reset(raw_listener);
+                *weak_notifier = notifier;
+                raw_listener->context_ = &context;
+                if (need_init) {
+                  context.initManager().add(notifier->target_);
+                }
               }
+              raw_listener->filter_chain_contexts_.push_back(&context);
               return {[notifier](Network::FilterManager&) -> void {}};
             }));
 
@@ -1071,6 +1083,239 @@ TEST_F(ListenerManagerImplTest, ListenerDraining) {
   checkStats(1, 0, 1, 0, 0, 0);
 }
 
+// Updating only the filter chains of a listener drains the changed filter chains and leaves the
+// connections of the unchanged ones alone.
+TEST_F(ListenerManagerImplTest, UpdateFilterChainsInPlace) {
+  InSequence s;
+
+  EXPECT_CALL(*worker_, start(_));
+  manager_->startWorkers(guard_dog_);
+
+  const std::string listener_foo_yaml = R"EOF(
+name: foo
+address:
+  socket_address: { address: 127.0.0.1, port_value: 1234 }
+filter_chains:
+- filter_chain_match: { destination_port: 1000 }
+  filters: [{ name: foo }]
+- filter_chain_match: { destination_port: 2000 }
+  filters: [{ name: bar }]
+  )EOF";
+
+  ListenerHandle* listener_foo =
+      expectListenerCreate(false, envoy::api::v2::Listener_DrainType_DEFAULT, 2);
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, true));
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_yaml), "", true));
+  worker_->callAddCompletion(true);
+  checkStats(1, 0, 0, 0, 1, 0);
+
+  // Change the filters of the second filter chain.
+  const std::string listener_foo_update1_yaml = R"EOF(
+name: foo
+address:
+  socket_address: { address: 127.0.0.1, port_value: 1234 }
+filter_chains:
+- filter_chain_match: { destination_port: 1000 }
+  filters: [{ name: foo }]
+- filter_chain_match: { destination_port: 2000 }
+  filters: [{ name: baz }]
+  )EOF";
+
+  ListenerHandle* listener_foo_update1 =
+      expectListenerCreate(false, envoy::api::v2::Listener_DrainType_DEFAULT, 2);
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_CALL(*worker_, stopListener(_));
+  MockDrainManager* filter_chain_drain_manager = new MockDrainManager();
+  EXPECT_CALL(listener_factory_, createDrainManager_(envoy::api::v2::Listener_DrainType_DEFAULT))
+      .WillOnce(Return(filter_chain_drain_manager));
+  EXPECT_CALL(*filter_chain_drain_manager, startDrainSequence(_));
+  EXPECT_CALL(*worker_, removeListenerWhenIdle(_, _));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_update1_yaml),
+                                            "", true));
+  worker_->callAddCompletion(true);
+  checkStats(1, 1, 0, 0, 1, 0);
+  EXPECT_EQ(1UL,
+            server_.stats_store_.counter("listener_manager.listener_in_place_updated").value());
+  EXPECT_EQ(1UL, server_.stats_store_.gauge("listener_manager.total_listeners_retiring").value());
+
+  // Only the changed filter chain of the old listener drains.
+  EXPECT_CALL(*listener_foo->drain_manager_, drainClose()).WillOnce(Return(false));
+  EXPECT_CALL(server_.drain_manager_, drainClose()).WillOnce(Return(false));
+  EXPECT_FALSE(listener_foo->filter_chain_contexts_[0]->drainDecision().drainClose());
+  EXPECT_CALL(*filter_chain_drain_manager, drainClose()).WillOnce(Return(true));
+  EXPECT_TRUE(listener_foo->filter_chain_contexts_[1]->drainDecision().drainClose());
+
+  // Once the drain time is over, the connections of the drained filter chain are closed.
+  std::list<const Network::FilterChain*> removed_filter_chains;
+  EXPECT_CALL(*worker_, removeFilterChains(_, _)).WillOnce(SaveArg<1>(&removed_filter_chains));
+  filter_chain_drain_manager->drain_sequence_completion_();
+  EXPECT_EQ(1UL, removed_filter_chains.size());
+
+  // Removing the listener drains the remaining filter chain of the old listener as well.
+  MockDrainManager* remaining_drain_manager = new MockDrainManager();
+  EXPECT_CALL(listener_factory_, createDrainManager_(envoy::api::v2::Listener_DrainType_DEFAULT))
+      .WillOnce(Return(remaining_drain_manager));
+  EXPECT_CALL(*remaining_drain_manager, startDrainSequence(_));
+  EXPECT_CALL(*worker_, stopListener(_));
+  EXPECT_CALL(*listener_foo_update1->drain_manager_, startDrainSequence(_));
+  EXPECT_TRUE(manager_->removeListener("foo"));
+  checkStats(1, 1, 1, 0, 0, 1);
+
+  // The old listener is removed once the workers report it idle.
+  EXPECT_CALL(*listener_foo, onDestroy());
+  worker_->callIdleRemovalCompletion();
+  EXPECT_EQ(0UL, server_.stats_store_.gauge("listener_manager.total_listeners_retiring").value());
+
+  EXPECT_CALL(*worker_, removeListener(_, _));
+  listener_foo_update1->drain_manager_->drain_sequence_completion_();
+  EXPECT_CALL(*listener_foo_update1, onDestroy());
+  worker_->callRemovalCompletion();
+  checkStats(1, 1, 1, 0, 0, 0);
+}
+
+// Only the newest generations of a listener that is updated in place keep their unchanged filter
+// chains. All the filter chains of older generations are drained.
+TEST_F(ListenerManagerImplTest, UpdateFilterChainsInPlaceDrainsOldestGenerations) {
+  const std::string listener_foo_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filter_chain_match:
+    destination_port: 1000
+  filters:
+  - name: foo
+- filter_chain_match:
+    destination_port: 2000
+  filters:
+  - name: {}
+  )EOF";
+
+  std::vector<ListenerHandle*> generations;
+  {
+    InSequence s;
+
+    EXPECT_CALL(*worker_, start(_));
+    manager_->startWorkers(guard_dog_);
+
+    generations.push_back(
+        expectListenerCreate(false, envoy::api::v2::Listener_DrainType_DEFAULT, 2));
+    EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, true));
+    EXPECT_CALL(*worker_, addListener(_, _));
+    EXPECT_TRUE(manager_->addOrUpdateListener(
+        parseListenerFromV2Yaml(fmt::format(listener_foo_yaml, "bar0")), "", true));
+    worker_->callAddCompletion(true);
+
+    // Each update only changes the second filter chain, so it is the only one that drains.
+    const auto update = [&](uint64_t i, bool drains_oldest) -> MockDrainManager* {
+      generations.push_back(
+          expectListenerCreate(false, envoy::api::v2::Listener_DrainType_DEFAULT, 2));
+      EXPECT_CALL(*worker_, addListener(_, _));
+      EXPECT_CALL(*worker_, stopListener(_));
+      MockDrainManager* filter_chain_drain_manager = new MockDrainManager();
+      EXPECT_CALL(listener_factory_,
+                  createDrainManager_(envoy::api::v2::Listener_DrainType_DEFAULT))
+          .WillOnce(Return(filter_chain_drain_manager));
+      EXPECT_CALL(*filter_chain_drain_manager, startDrainSequence(_));
+      MockDrainManager* oldest_drain_manager = nullptr;
+      if (drains_oldest) {
+        oldest_drain_manager = new MockDrainManager();
+        EXPECT_CALL(listener_factory_,
+                    createDrainManager_(envoy::api::v2::Listener_DrainType_DEFAULT))
+            .WillOnce(Return(oldest_drain_manager));
+        EXPECT_CALL(*oldest_drain_manager, startDrainSequence(_));
+      }
+      EXPECT_CALL(*worker_, removeListenerWhenIdle(_, _));
+      EXPECT_TRUE(manager_->addOrUpdateListener(
+          parseListenerFromV2Yaml(fmt::format(listener_foo_yaml, fmt::format("bar{}", i))), "",
+          true));
+      worker_->callAddCompletion(true);
+      return oldest_drain_manager;
+    };
+
+    for (uint64_t i = 1; i <= ListenerManagerImpl::MaxRetiringGenerations; i++) {
+      EXPECT_EQ(nullptr, update(i, false));
+    }
+    EXPECT_EQ(ListenerManagerImpl::MaxRetiringGenerations,
+              server_.stats_store_.gauge("listener_manager.total_listeners_retiring").value());
+
+    // One more generation drains the unchanged filter chain of the oldest one.
+    MockDrainManager* oldest_drain_manager =
+        update(ListenerManagerImpl::MaxRetiringGenerations + 1, true);
+    EXPECT_CALL(*oldest_drain_manager, drainClose()).WillOnce(Return(true));
+    EXPECT_TRUE(generations[0]->filter_chain_contexts_[0]->drainDecision().drainClose());
+
+    // The next one drains the following generation, rather than the oldest one again.
+    oldest_drain_manager = update(ListenerManagerImpl::MaxRetiringGenerations + 2, true);
+    EXPECT_CALL(*oldest_drain_manager, drainClose()).WillOnce(Return(true));
+    EXPECT_TRUE(generations[1]->filter_chain_contexts_[0]->drainDecision().drainClose());
+  }
+
+  // Retiring listeners are reported in their own section of the config dump.
+  auto message_ptr = server_.admin_.config_tracker_.config_tracker_callbacks_["listeners"]();
+  const auto& listeners_config_dump =
+      dynamic_cast<const envoy::admin::v2alpha::ListenersConfigDump&>(*message_ptr);
+  EXPECT_EQ(ListenerManagerImpl::MaxRetiringGenerations + 2,
+            listeners_config_dump.dynamic_retiring_listeners_size());
+  EXPECT_EQ(0, listeners_config_dump.dynamic_draining_listeners_size());
+
+  for (ListenerHandle* generation : generations) {
+    EXPECT_CALL(*generation, onDestroy());
+  }
+}
+
+// Updates that change more than the filter chains drain the whole listener.
+TEST_F(ListenerManagerImplTest, UpdateListenerSettingsDrainsListener) {
+  InSequence s;
+
+  EXPECT_CALL(*worker_, start(_));
+  manager_->startWorkers(guard_dog_);
+
+  const std::string listener_foo_yaml = R"EOF(
+name: foo
+address:
+  socket_address: { address: 127.0.0.1, port_value: 1234 }
+filter_chains:
+- filters: [{ name: foo }]
+  )EOF";
+
+  ListenerHandle* listener_foo = expectListenerCreate(false);
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, true));
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_yaml), "", true));
+  worker_->callAddCompletion(true);
+
+  const std::string listener_foo_update1_yaml = R"EOF(
+name: foo
+address:
+  socket_address: { address: 127.0.0.1, port_value: 1234 }
+filter_chains:
+- filters: [{ name: bar }]
+per_connection_buffer_limit_bytes: 10
+  )EOF";
+
+  ListenerHandle* listener_foo_update1 = expectListenerCreate(false);
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_CALL(*worker_, stopListener(_));
+  EXPECT_CALL(*listener_foo->drain_manager_, startDrainSequence(_));
+  EXPECT_CALL(*worker_, removeListenerWhenIdle(_, _)).Times(0);
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_update1_yaml),
+                                            "", true));
+  worker_->callAddCompletion(true);
+  checkStats(1, 1, 0, 0, 1, 1);
+
+  EXPECT_CALL(*worker_, removeListener(_, _));
+  listener_foo->drain_manager_->drain_sequence_completion_();
+  EXPECT_CALL(*listener_foo, onDestroy());
+  worker_->callRemovalCompletion();
+  checkStats(1, 1, 0, 0, 1, 0);
+
+  EXPECT_CALL(*listener_foo_update1, onDestroy());
+}
+
 TEST_F(ListenerManagerImplTest, RemoveListener) {
   InSequence s;
 
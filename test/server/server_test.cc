@@ -251,6 +251,12 @@ TEST_P(ServerInstanceImplTest, Stats) {
 #endif
 }
 
+// The server starts and shuts down cleanly with the stats flush thread enabled.
+TEST_P(ServerInstanceImplTest, StatsFlushThread) {
+  EXPECT_NO_THROW(initialize("test/server/stats_flush_thread_bootstrap.yaml"));
+  server_.reset();
+}
+
 // Validate server localInfo() from bootstrap Node.
 TEST_P(ServerInstanceImplTest, BootstrapNode) {
   initialize("test/server/node_bootstrap.yaml");
@@ -0,0 +1,79 @@
+#include <thread>
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "server/stats_flush_thread.h"
+
+#include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+class StatsFlushThreadTest : public testing::Test {
+public:
+  StatsFlushThreadTest()
+      : api_(Api::createApiForTest()), main_dispatcher_(api_->allocateDispatcher()) {}
+
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr main_dispatcher_;
+  Stats::IsolatedStoreImpl store_;
+};
+
+TEST_F(StatsFlushThreadTest, RegistersForThreadLocalUpdates) {
+  EXPECT_CALL(tls_, registerThread(_, false));
+  StatsFlushThread thread(tls_, *api_, *main_dispatcher_);
+}
+
+// Sinks are flushed on the flush thread from the snapshot, and the completion runs on the main
+// dispatcher.
+TEST_F(StatsFlushThreadTest, FlushesSinksOffMainThread) {
+  store_.counter("c").inc();
+  store_.gauge("g").set(5);
+
+  StatsFlushThread thread(tls_, *api_, *main_dispatcher_);
+  thread.start();
+
+  NiceMock<Stats::MockSink> sink;
+  ON_CALL(sink, supportsFlushThread()).WillByDefault(Return(true));
+  const std::thread::id main_thread_id = std::this_thread::get_id();
+  EXPECT_CALL(sink, flush(_)).WillOnce(Invoke([&](Stats::Source& source) -> void {
+    EXPECT_NE(main_thread_id, std::this_thread::get_id());
+    ASSERT_EQ(1, source.cachedCounters().size());
+    EXPECT_EQ("c", source.cachedCounters()[0]->name());
+    ASSERT_EQ(1, source.cachedGauges().size());
+    EXPECT_EQ(5, source.cachedGauges()[0]->value());
+  }));
+
+  bool completed = false;
+  thread.flush(std::make_shared<Stats::SourceSnapshotImpl>(store_), {&sink},
+               [&](std::chrono::milliseconds) -> void {
+                 EXPECT_EQ(main_thread_id, std::this_thread::get_id());
+                 completed = true;
+                 main_dispatcher_->exit();
+               });
+  main_dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_TRUE(completed);
+  thread.stop();
+}
+
+// Stopping a thread that was never started is a no-op.
+TEST_F(StatsFlushThreadTest, StopWithoutStart) {
+  StatsFlushThread thread(tls_, *api_, *main_dispatcher_);
+  thread.stop();
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
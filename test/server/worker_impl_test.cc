@@ -130,6 +130,37 @@ TEST_F(WorkerImplTest, BasicFlow) {
     EXPECT_NE(current_thread_id, std::this_thread::get_id());
   });
 
+  // Now test removing filter chains of a listener and removing it once idle.
+  NiceMock<Network::MockListenerConfig> listener4;
+  ON_CALL(listener4, listenerTag()).WillByDefault(Return(4UL));
+  EXPECT_CALL(*handler_, addListener(_));
+  worker_.addListener(listener4, [&ci](bool success) -> void {
+    EXPECT_TRUE(success);
+    ci.setReady();
+  });
+  ci.waitReady();
+
+  const auto filter_chain = std::make_shared<NiceMock<Network::MockFilterChain>>();
+  EXPECT_CALL(*handler_, removeFilterChains(4, _))
+      .WillOnce(Invoke([current_thread_id, &filter_chain, &ci](
+                           uint64_t, const std::list<const Network::FilterChain*>& filter_chains)
+                           -> void {
+        EXPECT_NE(current_thread_id, std::this_thread::get_id());
+        EXPECT_EQ(std::list<const Network::FilterChain*>{filter_chain.get()}, filter_chains);
+        ci.setReady();
+      }));
+  worker_.removeFilterChains(listener4, {filter_chain.get()});
+  ci.waitReady();
+
+  EXPECT_CALL(*handler_, removeListenersWhenIdle(4, _))
+      .WillOnce(
+          Invoke([](uint64_t, std::function<void()> completion) -> void { completion(); }));
+  worker_.removeListenerWhenIdle(listener4, [current_thread_id, &ci]() -> void {
+    EXPECT_NE(current_thread_id, std::this_thread::get_id());
+    ci.setReady();
+  });
+  ci.waitReady();
+
   worker_.stop();
 }
 